@@ -0,0 +1,271 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "communication/shared_memory.h"
+
+namespace medical::imaging {
+    class ImagingService;
+
+    /**
+     * @brief Request on the control socket, followed by payloadSize bytes
+     */
+    struct ControlRequest {
+        char magic[4];        // "MVQ1"
+        uint16_t version;     // Message version (1)
+        uint16_t command;     // CONTROL_COMMAND_*
+        uint32_t payloadSize; // Bytes following this structure in the same message
+        uint32_t reserved;
+        char ringName[64];    // Ring the command applies to, NUL terminated (ATTACH, SUBSCRIBE, SAVE_CLIP)
+    };
+
+    static_assert(sizeof(ControlRequest) == 80, "ControlRequest is part of the control socket protocol");
+
+    /**
+     * @brief Reply on the control socket, followed by payloadSize bytes
+     *
+     * An ATTACH reply carries the region's descriptor through SCM_RIGHTS and
+     * a SharedMemory::Layout as its payload, a SUBSCRIBE reply an eventfd
+     * and no payload; the other replies carry text.
+     */
+    struct ControlReply {
+        char magic[4];        // "MVP1"
+        uint16_t version;     // Message version (1)
+        uint16_t status;      // CONTROL_STATUS_*
+        uint32_t payloadSize; // Bytes following this structure in the same message
+        uint32_t pid;         // Process serving the rings
+    };
+
+    static_assert(sizeof(ControlReply) == 16, "ControlReply is part of the control socket protocol");
+
+    // Commands
+    constexpr uint16_t CONTROL_COMMAND_ATTACH = 1;       // Pass the descriptor and layout of a ring
+    constexpr uint16_t CONTROL_COMMAND_LIST_RINGS = 2;   // Names of the published rings, one per line
+    constexpr uint16_t CONTROL_COMMAND_GET_SETTINGS = 3; // Live settings as JSON
+    constexpr uint16_t CONTROL_COMMAND_RECONFIGURE = 4;  // Change the live settings given as JSON, reply with the result
+    constexpr uint16_t CONTROL_COMMAND_SUBSCRIBE = 5;    // Pass an eventfd signalled with new frames for a reader slot
+    constexpr uint16_t CONTROL_COMMAND_SAVE_CLIP = 6;    // Write the last part of a ring to a recording file, JSON arguments
+
+    // Reply status codes
+    constexpr uint16_t CONTROL_STATUS_OK = 0;
+    constexpr uint16_t CONTROL_STATUS_UNKNOWN_RING = 1;    // No ring of that name is published
+    constexpr uint16_t CONTROL_STATUS_NOT_SUPPORTED = 2;   // The ring has no descriptor to pass (System V)
+    constexpr uint16_t CONTROL_STATUS_INVALID_REQUEST = 3; // Malformed message or unknown command
+    constexpr uint16_t CONTROL_STATUS_REJECTED = 4;        // The service refused the change, the payload says why
+    constexpr uint16_t CONTROL_STATUS_NOT_OWNER = 5;       // The reader slot does not belong to the requesting process
+
+    /**
+     * @class ControlServer
+     * @brief Local control socket: attach to rings by descriptor, change live settings
+     *
+     * A Unix SOCK_SEQPACKET socket, one message per request and per reply,
+     * and a connection may carry any number of requests. ATTACH passes the
+     * descriptor of a published ring through SCM_RIGHTS together with its
+     * binary layout, so a consumer maps the ring without opening a name
+     * under /dev/shm and without parsing the JSON metadata. The futex
+     * doorbells live inside the region, so the descriptor is all a consumer
+     * needs to wait for frames. Consumers that multiplex rings in an event
+     * loop SUBSCRIBE for an eventfd per reader slot instead, which the
+     * writer signals when frames arrive. RECONFIGURE and GET_SETTINGS give access to
+     * ImagingService::reconfigure() from other processes, SAVE_CLIP to
+     * ImagingService::saveClip().
+     *
+     * The access rights of the socket file decide who may attach. A clip
+     * path is relative to Config::clipDirectory and may not leave it, so a
+     * peer cannot have the daemon write anywhere else.
+     */
+    class ControlServer {
+    public:
+        /**
+         * @brief Status codes for server operations
+         */
+        enum class Status {
+            OK,              // Operation completed successfully
+            ALREADY_RUNNING, // Server already running
+            NOT_RUNNING,     // Server not running
+            BIND_FAILED,     // Could not open the listening socket
+            INVALID_ARGUMENT // Invalid argument provided
+        };
+
+        /**
+         * @brief Server configuration
+         */
+        struct Config {
+            std::string socketPath; // Path of the Unix socket
+            uint32_t socketMode;    // Permission bits of the socket file
+            size_t maxClients;      // Connections served at once; further ones wait in the backlog
+            std::string clipDirectory; // SAVE_CLIP paths are resolved under it, "" refuses every clip
+
+            // Constructor with default values
+            Config() : socketPath("/tmp/imaging_control.sock"),
+                       socketMode(0660),
+                       maxClients(32),
+                       clipDirectory("/tmp/imaging_clips") {
+            }
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Server configuration
+         */
+        explicit ControlServer(const Config &config = Config());
+
+        /**
+         * @brief Destructor, stops the server
+         */
+        ~ControlServer();
+
+        ControlServer(const ControlServer &) = delete;
+        ControlServer &operator=(const ControlServer &) = delete;
+
+        /**
+         * @brief Start listening
+         * @param service Service whose rings and settings are served; must outlive the server
+         * @return Status code indicating success or failure
+         */
+        Status start(ImagingService &service);
+
+        /**
+         * @brief Stop listening, close every connection and remove the socket
+         *
+         * Consumers keep the descriptors they received.
+         *
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the server is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the number of descriptors passed to consumers
+         * @return Number of successful ATTACH replies
+         */
+        uint64_t getAttachCount() const;
+
+    private:
+        void serverThread();
+        bool handleMessage(int clientFd);
+        std::string handleReconfigure(const std::string &request, uint16_t &status);
+        std::string handleSaveClip(const std::string &ringName, const std::string &request, uint16_t &status);
+
+        Config config_;
+        ImagingService *service_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+        std::atomic<uint64_t> attachCount_;
+        int listenFd_;
+    };
+
+    /**
+     * @class ControlClient
+     * @brief Consumer side of the control socket
+     */
+    class ControlClient {
+    public:
+        ControlClient();
+        ~ControlClient();
+
+        ControlClient(const ControlClient &) = delete;
+        ControlClient &operator=(const ControlClient &) = delete;
+
+        /**
+         * @brief Connect to a control socket
+         * @param socketPath Path of the service's control socket
+         * @return true if connected
+         */
+        bool connect(const std::string &socketPath);
+
+        /**
+         * @brief Close the connection; rings attached through it stay mapped
+         */
+        void disconnect();
+
+        /**
+         * @brief Check if the client is connected
+         * @return true after a successful connect()
+         */
+        bool isConnected() const;
+
+        /**
+         * @brief Map a ring from the descriptor the service passes
+         *
+         * Registers as a reader like SharedMemory::initialize() does, so
+         * readerMode and requestedFormat of the configuration apply.
+         *
+         * @param ringName Name of the ring, e.g. "ultrasound_frames"
+         * @param config Client configuration; name, create and the attach fields are overridden
+         * @return Initialized ring, nullptr if the service does not publish it or it could not be mapped
+         */
+        std::shared_ptr<SharedMemory> attach(const std::string &ringName,
+                                             SharedMemory::Config config = SharedMemory::Config());
+
+        /**
+         * @brief Get a pollable descriptor for a ring this process reads
+         *
+         * Asks the service for an eventfd it signals when frames arrive for
+         * the ring's reader slot and hands it to the ring, see
+         * SharedMemory::setNotificationDescriptor(). The ring may have been
+         * attached by name or through this client.
+         *
+         * @param ringName Name of the ring, as published by the service
+         * @param ring Registered reader of that ring
+         * @return true if the ring has a notification descriptor now
+         */
+        bool subscribe(const std::string &ringName, SharedMemory &ring);
+
+        /**
+         * @brief Get the names of the rings the service publishes
+         * @param names Output parameter receiving the names
+         * @return true if the service answered
+         */
+        bool listRings(std::vector<std::string> &names);
+
+        /**
+         * @brief Get the service's live settings
+         * @param settings Output parameter receiving the settings as JSON
+         * @return true if the service answered
+         */
+        bool getSettings(std::string &settings);
+
+        /**
+         * @brief Change the service's live settings
+         * @param changes JSON object with the settings to change, others keep their value
+         * @param reply Output parameter receiving the resulting settings, or the reason for refusing
+         * @return true if the change was applied
+         */
+        bool reconfigure(const std::string &changes, std::string &reply);
+
+        /**
+         * @brief Have the service write the last part of a ring to a recording file
+         *
+         * The service pins the frames instead of this process copying them
+         * out, and writes the file in the background; see
+         * ImagingService::saveClip(). The path is opened by the service.
+         *
+         * @param ringName Name of the ring, as published by the service
+         * @param duration Length of the clip, measured back from the newest frame
+         * @param filePath Recording file the service writes, relative to its clip directory
+         * @param reply Output parameter receiving the reason for refusing, empty on success
+         * @return true if the service started writing the clip
+         */
+        bool saveClip(const std::string &ringName, std::chrono::milliseconds duration, const std::string &filePath,
+                      std::string &reply);
+
+    private:
+        bool request(uint16_t command, const std::string &ringName, const std::string &payload,
+                     uint16_t &status, std::string &reply, int *descriptor);
+
+        int fd_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "frame/frame.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @class FrameDispatcher
+     * @brief Fans frames out to in-process subscribers without letting one of them stall the others
+     *
+     * Every subscriber gets its own bounded lock-free queue and is delivered
+     * to on its own thread, on an executor it supplies, or inline on the
+     * publishing thread. dispatch() only enqueues, so a slow recorder or
+     * quality monitor falls behind on its own queue while the publisher and
+     * the other subscribers keep going; what happens when the queue is full
+     * is up to the subscriber's drop policy.
+     *
+     * dispatch() may be called from several threads at once (one publisher
+     * per channel). Queued frames keep their capture buffers alive, so
+     * subscribers that need a frame for long should copy it.
+     */
+    class FrameDispatcher {
+    public:
+        /**
+         * @brief What dispatch() does when a subscriber's queue is full
+         */
+        enum class DropPolicy {
+            BLOCK,       // Wait for the subscriber, holding back the publisher (and eventually capture)
+            DROP_OLDEST, // Discard the oldest queued frame to make room
+            LATEST_ONLY  // Discard every queued frame, so the subscriber only ever sees the newest one
+        };
+
+        using FrameHandler = std::function<void(std::shared_ptr<Frame>)>;
+        using Executor = std::function<void(std::function<void()>)>;
+
+        /**
+         * @brief Subscription configuration
+         */
+        struct SubscriptionConfig {
+            std::string name;         // Label in statistics ("subscriber<id>" if empty)
+            size_t queueDepth;        // Frames queued before the drop policy applies
+            DropPolicy policy;        // Behaviour on a full queue
+            bool dedicatedThread;     // Deliver on a thread of its own
+            int cpuCore;              // CPU core for the dedicated thread (-1 for no affinity)
+            Executor executor;        // Runs deliveries when dedicatedThread is false (null to deliver inline)
+
+            // Constructor with default values
+            SubscriptionConfig() : queueDepth(4),
+                                   policy(DropPolicy::DROP_OLDEST),
+                                   dedicatedThread(true),
+                                   cpuCore(-1) {
+            }
+        };
+
+        /**
+         * @brief Per-subscriber delivery statistics
+         */
+        struct SubscriberStatistics {
+            int id;                                // Subscription ID
+            std::string name;                      // Subscription name
+            DropPolicy policy;                     // Drop policy
+            uint64_t framesDelivered;              // Frames handed to the handler
+            uint64_t framesDropped;                // Frames discarded by the drop policy
+            uint64_t lagFrames;                    // Frames queued but not yet delivered
+            uint64_t maxLagFrames;                 // Largest queue depth seen
+            LatencyHistogram::Snapshot queueWait;  // Time from dispatch() to the handler being called
+            LatencyHistogram::Snapshot handleTime; // Time spent in the handler
+        };
+
+        /**
+         * @brief Constructor
+         */
+        FrameDispatcher();
+
+        /**
+         * @brief Destructor, removes every subscriber
+         */
+        ~FrameDispatcher();
+
+        FrameDispatcher(const FrameDispatcher &) = delete;
+        FrameDispatcher &operator=(const FrameDispatcher &) = delete;
+
+        /**
+         * @brief Add a subscriber
+         * @param handler Function to call with each frame
+         * @param config Subscription configuration
+         * @return Subscription ID, -1 if the handler is empty
+         */
+        int subscribe(FrameHandler handler, const SubscriptionConfig &config = SubscriptionConfig());
+
+        /**
+         * @brief Remove a subscriber
+         *
+         * Frames still queued for it are discarded. Once this returns the
+         * handler is no longer running and will not be called again.
+         *
+         * @param id Subscription ID from subscribe()
+         * @return true if the subscriber existed
+         */
+        bool unsubscribe(int id);
+
+        /**
+         * @brief Hand a frame to every subscriber
+         * @param frame Frame to deliver
+         */
+        void dispatch(const std::shared_ptr<Frame> &frame);
+
+        /**
+         * @brief Get the number of subscribers
+         * @return Subscriber count
+         */
+        size_t getSubscriberCount() const;
+
+        /**
+         * @brief Get the delivery statistics of every subscriber
+         * @return One entry per subscriber, in subscription order
+         */
+        std::vector<SubscriberStatistics> getSubscriberStatistics() const;
+
+        /**
+         * @brief Get the delivery statistics as key-value pairs, prefixed with subscriber_<name>_
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+        /**
+         * @brief Get the name of a drop policy
+         * @param policy Drop policy
+         * @return Lower-case policy name
+         */
+        static const char *toString(DropPolicy policy);
+
+    private:
+        struct Subscriber;
+        using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+        static void enqueue(const std::shared_ptr<Subscriber> &subscriber, const std::shared_ptr<Frame> &frame);
+        static void deliver(Subscriber &subscriber);
+        static void subscriberThread(const std::shared_ptr<Subscriber> &subscriber);
+        static void schedule(const std::shared_ptr<Subscriber> &subscriber);
+        static void close(Subscriber &subscriber);
+
+        // Copy-on-write list read by dispatch() without taking the mutex
+        std::shared_ptr<const SubscriberList> subscribers_;
+        std::atomic<size_t> subscriberCount_;
+        mutable std::mutex mutex_; // Serializes subscribe() and unsubscribe()
+        int nextId_;
+    };
+} // namespace medical::imaging
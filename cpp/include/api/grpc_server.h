@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace medical::imaging {
+    class ImagingService;
+
+    /**
+     * @class GrpcServer
+     * @brief Serves the StreamFrames, GetFrame and GetStatistics RPCs of proto/imaging_service.proto
+     *
+     * A feed thread per ring reads frames as a lossy reader, so remote clients
+     * never hold back capture or local consumers. Each frame is copied out of
+     * the ring once, into a reference-counted buffer that every stream sends
+     * from; there is no per-client copy and no intermediate std::string. Each
+     * stream keeps at most maxQueuedFrames frames waiting behind the one being
+     * sent and drops the oldest when a newer frame arrives, so a slow client
+     * only ever gets the latest frames and costs bounded memory.
+     *
+     * FrameRequest.format selects the ring: "" or "raw" for the raw ring,
+     * "compressed" for the compressed ring when the service publishes one.
+     * Every other RPC answers UNIMPLEMENTED.
+     */
+    class GrpcServer {
+    public:
+        /**
+         * @brief Status codes for server operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Server already running
+            NOT_RUNNING,       // Server not running
+            BIND_FAILED,       // Could not listen on the configured address
+            CONNECTION_FAILED, // Could not attach to the service's rings
+            INVALID_ARGUMENT   // Invalid argument provided
+        };
+
+        /**
+         * @brief Server configuration
+         */
+        struct Config {
+            std::string bindAddress; // Address to listen on
+            uint16_t port;           // TCP port to listen on
+            size_t maxQueuedFrames;  // Frames a stream keeps behind the one being sent
+            int cpuCore;             // CPU core for the feed threads (-1 for no affinity)
+
+            // Constructor with default values
+            Config() : bindAddress("0.0.0.0"),
+                       port(50051),
+                       maxQueuedFrames(1),
+                       cpuCore(-1) {
+            }
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Server configuration
+         */
+        explicit GrpcServer(const Config &config = Config());
+
+        /**
+         * @brief Destructor, stops the server
+         */
+        ~GrpcServer();
+
+        GrpcServer(const GrpcServer &) = delete;
+        GrpcServer &operator=(const GrpcServer &) = delete;
+
+        /**
+         * @brief Attach to the rings of a running service and start serving
+         * @param service Service whose rings and statistics are served; must outlive the server
+         * @param channel Channel whose rings are served
+         * @return Status code indicating success or failure
+         */
+        Status start(ImagingService &service, size_t channel = 0);
+
+        /**
+         * @brief Finish every call, stop serving and detach from the rings
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the server is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get server statistics as key-value pairs
+         * @return Map of statistic name to value, keys prefixed with "grpc_"
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+    private:
+        class Impl;
+        Config config_;
+        std::unique_ptr<Impl> impl_;
+        std::atomic<bool> isRunning_;
+    };
+} // namespace medical::imaging
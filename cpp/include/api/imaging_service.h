@@ -8,12 +8,24 @@
 #include <mutex>
 #include <thread>
 #include <condition_variable>
-#include <deque>
 #include <future>
 
+#include "api/frame_dispatcher.h"
 #include "device/device_manager.h"
 #include "frame/frame.h"
+#include "frame/frame_converter.h"
+#include "frame/frame_fingerprint.h"
+#include "frame/frame_scaler.h"
+#include "compression/frame_compressor.h"
+#include "communication/dma_buf_exporter.h"
+#include "communication/format_cache.h"
+#include "gpu/gpu_uploader.h"
 #include "communication/shared_memory.h"
+#include "recording/frame_recorder.h"
+#include "utils/frame_pacing.h"
+#include "utils/latency_histogram.h"
+#include "utils/rcu_snapshot.h"
+#include "utils/spsc_queue.h"
 
 namespace medical::imaging {
     /**
@@ -22,6 +34,14 @@ namespace medical::imaging {
      *
      * This class focuses exclusively on device management and frame acquisition,
      * writing frames to shared memory as quickly as possible with minimal processing.
+     *
+     * One service can drive several devices at once (separate cards, or the
+     * sub-devices of a Quad or 8K card, which enumerate as devices of their
+     * own). Each device is a channel with its own ring; channel 0 publishes to
+     * Config::sharedMemoryName and channel n to "<sharedMemoryName>_<n>". All
+     * channels share the monitoring thread and the metrics surface, and stamp
+     * capture times on the same monotonic clock, so timestamps compare across
+     * devices.
      */
     class ImagingService {
     public:
@@ -41,53 +61,255 @@ namespace medical::imaging {
             TIMEOUT              // Operation timed out
         };
 
+        /**
+         * @brief Region of a captured frame to publish, in pixels
+         *
+         * Scanner video output frames the sector image with menus and
+         * borders; cropping before publishing means neither writeFrame() nor
+         * any consumer moves those pixels. A width or height of 0 publishes
+         * the full frame.
+         */
+        struct RegionOfInterest {
+            int x;      // Left edge
+            int y;      // Top edge
+            int width;  // Width (0 for the full frame)
+            int height; // Height (0 for the full frame)
+
+            RegionOfInterest() : x(0), y(0), width(0), height(0) {
+            }
+
+            RegionOfInterest(int left, int top, int w, int h) : x(left), y(top), width(w), height(h) {
+            }
+
+            bool isEnabled() const {
+                return width > 0 && height > 0;
+            }
+        };
+
         /**
          * @brief Service configuration
          */
         struct Config {
             // Device settings
             std::string deviceId;                   // ID of device to use, empty for auto-select
-            BlackmagicDevice::Config deviceConfig;  // Device-specific configuration
+            std::vector<std::string> deviceIds;     // Devices to capture concurrently, one channel each (empty for deviceId alone)
+            CaptureDevice::Config deviceConfig;     // Device-specific configuration
 
             // Performance settings
             bool enableDirectMemoryAccess; // Enable DMA if supported
+            std::string threadLayout;      // Placement of every thread (see ThreadLayout), empty for the options below
             bool useRealtimePriority;      // Use realtime thread priority
             int threadAffinity;            // Thread CPU affinity (-1 for auto)
             bool pinMemory;                // Pin memory to RAM (prevent swapping)
+            int numaNode;                  // NUMA node for rings, capture buffers and threads (-1 to follow the device)
 
             // Shared memory settings
             bool enableSharedMemory;       // Enable shared memory communication
             std::string sharedMemoryName;  // Name of shared memory region
-            size_t sharedMemorySize;       // Size of shared memory region
+            size_t sharedMemorySize;       // Size of shared memory region; the most an adaptive raw ring uses
             SharedMemoryType sharedMemoryType; // Type of shared memory implementation
+            size_t captureBufferCount;     // Shared memory slots the device captures into directly (0 to copy)
+            bool useHugePages;             // Back the rings with huge pages where the system allows
+            size_t hugePageSize;           // Huge page size to request (0 for the system default)
+            size_t payloadAlignment;       // Alignment of frame payloads in the rings (0 for the page size)
+            size_t rowAlignment;           // Row pitch multiple of frames copied into the rings (0 for tight rows)
+            bool persistentSharedMemory;   // Keep the rings across restarts so consumers stay attached
+            CopyMode copyMode;             // Kernel frames are copied into the raw ring with
+            size_t copyThreads;            // Threads sharing the copy of one large frame
+            size_t publishBandRows;        // Publish raw ring payloads in bands of this many rows as they are copied (0 for whole frames)
+            bool imageStatistics;          // Fill luminance statistics into the raw ring's metadata records
+
+            // Duplicate frame settings
+            DuplicatePolicy duplicatePolicy; // What frames that repeat the previous one (frozen image) become
+            double duplicateKeepAliveRate;   // Full frames per second still published while frozen under THROTTLE
+            size_t fingerprintSamples;       // Blocks sampled per frame fingerprint (0 hashes every byte)
+
+            // Conversion settings
+            std::string conversionFormat;          // Second published channel ("GRAY8", "RGB24", "YUV422P16", "RGB48"), empty to disable
+            std::string convertedSharedMemoryName; // Name of the shared memory region for converted frames
+
+            // Cropping settings
+            RegionOfInterest regionOfInterest;   // Crop applied to every channel before publishing
+
+            // Preview settings
+            int previewScale;                    // Divisor applied to width and height of the preview ring (0 to disable)
+            double previewFrameRate;             // Maximum preview frame rate (0 to follow the device)
+            std::string previewSharedMemoryName; // Name of the shared memory region for preview frames
+            size_t previewSharedMemorySize;      // Size of the preview shared memory region
+
+            // Compression settings
+            std::string compressionCodec;           // Codec of the compressed ring ("zero-run", "lz4"), empty to disable
+            bool compressionDelta;                  // Compress differences to the previous frame
+            uint32_t compressionKeyFrameInterval;   // Frames between key frames on the compressed ring
+            std::string compressedSharedMemoryName; // Name of the shared memory region for compressed frames
+            int compressionThreadAffinity;          // CPU core for the compressor threads (-1 for no affinity)
+
+            // GPU upload settings
+            bool enableGpuUpload;            // Upload every frame to a CUDA device and publish where it landed
+            int gpuDevice;                   // CUDA device to upload to
+            uint32_t gpuBufferCount;         // Device buffers in rotation per channel
+            bool gpuPinSharedMemory;         // Page-lock the raw ring with cudaHostRegister
+            std::string gpuSharedMemoryName; // Name of the shared memory region for GPU frame descriptors
+            int gpuThreadAffinity;           // CPU core for the uploader threads (-1 for no affinity)
+
+            // DMA-BUF export settings
+            bool enableDmaBufExport;            // Export every frame as a dma-buf slot for GPU and display consumers
+            uint32_t dmaBufSlotCount;           // Slots in rotation per channel
+            uint32_t dmaBufPitchAlignment;      // Row pitch alignment of the exported slots
+            std::string dmaBufSharedMemoryName; // Name of the shared memory region for dma-buf frame descriptors
+            std::string dmaBufSocketDirectory;  // Directory of the sockets the slots are passed through
+            int dmaBufThreadAffinity;           // CPU core for the exporter threads (-1 for no affinity)
+
+            // On-demand format settings
+            bool enableFormatCache;             // Convert once per format that consumers request when they register
+            unsigned int formatCacheIdleMs;     // How long a format ring outlives its last subscriber
+            int formatCacheThreadAffinity;      // CPU core for the format conversion threads (-1 for no affinity)
+
+            // Probe tracking settings
+            std::string poseRingName;           // Pose ring a tracker adapter publishes (see PoseWriter), empty for none
+
+            // Publishing settings
+            bool usePublishThread;       // Publish from a thread per channel instead of the device's callback thread
+            size_t publishQueueDepth;    // Frames that may wait for the publisher thread before new ones are dropped
+            int publishThreadAffinity;   // CPU core for the publisher threads (-1 to stay on the channel's NUMA node)
+
+            // Idle settings
+            bool idleWhenUnread;         // Publish only keep-alive frames while nothing consumes a channel
+            bool idleWithoutSignal;      // Publish only keep-alive frames while the device reports no input signal
+            double idleKeepAliveRate;    // Frames per second still published on an idle channel (0 for none)
 
             // Framebuffer settings
             int frameBufferSize;         // Number of frames to buffer
-            bool dropFramesWhenFull;     // Whether to drop frames when buffer is full
+            bool adaptiveRingSize;       // Size the raw ring's arena from the current mode and reader lag
+            int ringMinFrames;           // Fewest frames of the current mode an adaptive raw ring holds
+            double ringLagHeadroom;      // Frames an adaptive raw ring holds per frame of p99.9 reader lag
+            unsigned int ringShrinkDelayMs; // Time the lag must stay low before an adaptive raw ring gives memory back
+            WritePolicy writePolicy;     // What the raw ring does when lossless readers fall behind
+            unsigned int blockTimeoutMs; // Longest wait for lossless readers under WritePolicy::BLOCK
+            uint64_t demoteLagFrames;    // Make lossless readers this many frames behind lossy (0 never)
+            unsigned int demoteStaleMs;  // Make lossless readers that stop reading while the ring is full lossy after this long (0 never)
 
             // Diagnostics
             bool enablePerformanceMonitoring; // Track detailed performance metrics
             bool logPerformanceStats;       // Log performance stats periodically
             int performanceLogIntervalMs;   // Interval for logging performance
             size_t maxFrameSize;          // Maximum size of a single frame in bytes
+            bool enableTracing;           // Record per-frame trace points (see FrameTrace)
+            std::string traceFile;        // Where dumpTrace() writes by default
+            unsigned int traceWindowMs;   // How much recent history a trace dump covers
+            bool traceOnDrop;             // Dump a trace automatically when a frame is dropped
 
 
             // Constructor with default values
             Config() : deviceId(""),
                        enableDirectMemoryAccess(true),
+                       threadLayout(""),
                        useRealtimePriority(true),
                        threadAffinity(-1),
                        pinMemory(true),
+                       numaNode(-1),
                        enableSharedMemory(true),
                        sharedMemoryName("ultrasound_frames"),
                        sharedMemorySize(128 * 1024 * 1024), // 128 MB
                        sharedMemoryType(SharedMemoryType::MEMORY_MAPPED_FILE),
+                       captureBufferCount(4),
+                       useHugePages(false),
+                       hugePageSize(0),
+                       payloadAlignment(0),
+                       rowAlignment(0),
+                       persistentSharedMemory(false),
+                       copyMode(CopyMode::AUTO),
+                       copyThreads(1),
+                       publishBandRows(0),
+                       imageStatistics(false),
+                       duplicatePolicy(DuplicatePolicy::PUBLISH),
+                       duplicateKeepAliveRate(1.0),
+                       fingerprintSamples(FrameFingerprint::DEFAULT_SAMPLES),
+                       conversionFormat(""),
+                       convertedSharedMemoryName("ultrasound_frames_converted"),
+                       previewScale(0),
+                       previewFrameRate(30.0),
+                       previewSharedMemoryName("ultrasound_frames_preview"),
+                       previewSharedMemorySize(32 * 1024 * 1024), // 32 MB
+                       compressionCodec(""),
+                       compressionDelta(true),
+                       compressionKeyFrameInterval(60),
+                       compressedSharedMemoryName("ultrasound_frames_compressed"),
+                       compressionThreadAffinity(-1),
+                       enableGpuUpload(false),
+                       gpuDevice(0),
+                       gpuBufferCount(4),
+                       gpuPinSharedMemory(true),
+                       gpuSharedMemoryName("ultrasound_frames_gpu"),
+                       gpuThreadAffinity(-1),
+                       enableDmaBufExport(false),
+                       dmaBufSlotCount(4),
+                       dmaBufPitchAlignment(256),
+                       dmaBufSharedMemoryName("ultrasound_frames_dmabuf"),
+                       dmaBufSocketDirectory("/tmp"),
+                       dmaBufThreadAffinity(-1),
+                       enableFormatCache(true),
+                       formatCacheIdleMs(2000),
+                       formatCacheThreadAffinity(-1),
+                       poseRingName(""),
+                       usePublishThread(true),
+                       publishQueueDepth(4),
+                       publishThreadAffinity(-1),
+                       idleWhenUnread(true),
+                       idleWithoutSignal(true),
+                       idleKeepAliveRate(1.0),
                        frameBufferSize(120),
-                       dropFramesWhenFull(true),
+                       adaptiveRingSize(true),
+                       ringMinFrames(8),
+                       ringLagHeadroom(2.0),
+                       ringShrinkDelayMs(30000),
+                       writePolicy(WritePolicy::DROP_NEWEST),
+                       blockTimeoutMs(1000),
+                       demoteLagFrames(0),
+                       demoteStaleMs(2000),
                        enablePerformanceMonitoring(true),
                        logPerformanceStats(false),
                        performanceLogIntervalMs(5000),
-                       maxFrameSize(1024 * 1024 * 8){
+                       maxFrameSize(1024 * 1024 * 8),
+                       enableTracing(false),
+                       traceFile("/tmp/imaging_trace.json"),
+                       traceWindowMs(5000),
+                       traceOnDrop(false) {
+            }
+        };
+
+        /**
+         * @brief Settings that can change while capturing, see reconfigure()
+         *
+         * The publish path reads them through an RCU snapshot, so changing
+         * them never stalls capture. Everything else in Config sizes rings,
+         * threads or devices and needs stop(), setConfig() and start().
+         */
+        struct LiveSettings {
+            std::vector<RegionOfInterest> regionsOfInterest; // Crop of each channel, one entry per channel
+            double previewFrameRate;                         // Maximum preview frame rate (0 to follow the device)
+            DuplicatePolicy duplicatePolicy;                 // What frames that repeat the previous one become
+            double duplicateKeepAliveRate;                   // Full frames per second still published while frozen under THROTTLE
+            size_t fingerprintSamples;                       // Blocks sampled per frame fingerprint (0 hashes every byte)
+            std::string threadLayout;                        // Placement of every thread, applied to the running threads
+            bool logPerformanceStats;                        // Log performance stats periodically
+            int performanceLogIntervalMs;                    // Interval for logging performance
+            bool enableTracing;                              // Record per-frame trace points
+            std::string traceFile;                           // Where dumpTrace() writes by default
+            unsigned int traceWindowMs;                      // How much recent history a trace dump covers
+            bool traceOnDrop;                                // Dump a trace automatically when a frame is dropped
+
+            // Constructor with default values
+            LiveSettings() : previewFrameRate(30.0),
+                             duplicatePolicy(DuplicatePolicy::PUBLISH),
+                             duplicateKeepAliveRate(1.0),
+                             fingerprintSamples(FrameFingerprint::DEFAULT_SAMPLES),
+                             logPerformanceStats(false),
+                             performanceLogIntervalMs(5000),
+                             enableTracing(false),
+                             traceFile("/tmp/imaging_trace.json"),
+                             traceWindowMs(5000),
+                             traceOnDrop(false) {
             }
         };
 
@@ -99,13 +321,27 @@ namespace medical::imaging {
             uint64_t droppedFrames;    // Frames dropped
             double averageFps;         // Average frames per second
             double currentFps;         // Current frames per second
-            double averageLatencyMs;   // Average latency in milliseconds
-            double maxLatencyMs;       // Maximum latency in milliseconds
+            double averageLatencyMs;   // Average capture-to-publish latency in milliseconds
+            double p50LatencyMs;       // Median capture-to-publish latency in milliseconds
+            double p99LatencyMs;       // 99th percentile capture-to-publish latency in milliseconds
+            double p999LatencyMs;      // 99.9th percentile capture-to-publish latency in milliseconds
+            double maxLatencyMs;       // Maximum capture-to-publish latency in milliseconds
             double cpuUsagePercent;    // CPU usage percentage
-            double memoryUsageMb;      // Memory usage in MB
+            double memoryUsageMb;      // Resident memory in MB
+            double peakMemoryUsageMb;  // Largest resident memory in MB
+            double lockedMemoryMb;     // Memory locked into RAM in MB
             std::chrono::seconds uptime; // Service uptime
         };
 
+        /**
+         * @brief One step of bringing the service up, for the startup timeline
+         */
+        struct StartupStage {
+            std::string name;  // e.g. "device_discovery", "ring_prefault_0", "first_frame"
+            double startMs;    // Start, from the beginning of the first stage recorded
+            double durationMs; // Time the stage took
+        };
+
         /**
          * @brief Constructor
          */
@@ -149,18 +385,80 @@ namespace medical::imaging {
 
         /**
          * @brief Set the configuration (if not running)
+         *
+         * While running, use reconfigure() for the settings that can change live.
+         *
          * @param config New configuration
          * @return Status code indicating success or failure
          */
         Status setConfig(const Config &config);
 
+        /**
+         * @brief Get the settings the publish path currently runs with
+         * @return Current live settings
+         */
+        LiveSettings getLiveSettings() const;
+
+        /**
+         * @brief Change the live settings without stopping capture
+         *
+         * Frames already being published finish with the old settings, the
+         * next ones see the new settings; capture never waits for the change.
+         * A new thread layout is validated first and then applied to every
+         * running pipeline thread. getConfig() reflects the change.
+         *
+         * @param settings New settings, with one region of interest per channel
+         * @return Status code indicating success or failure
+         */
+        Status reconfigure(const LiveSettings &settings);
+
         /**
          * @brief Set a callback to be notified on new frames
+         *
+         * Called after the frame was published, on the channel's publisher
+         * thread (or the device's callback thread without one).
+         *
          * @param callback Function to call with each new frame
          * @return Status code indicating success or failure
          */
         Status setFrameCallback(const std::function<void(std::shared_ptr<Frame>)> &callback);
 
+        /**
+         * @brief Subscribe to published frames with a queue of their own
+         *
+         * Unlike setFrameCallback(), a slow subscriber only falls behind on
+         * its own queue; the policy in @p config decides what happens when
+         * it is full. Frames of every channel are delivered.
+         *
+         * @param handler Function to call with each frame
+         * @param config Queue depth, drop policy and where the handler runs
+         * @return Subscription ID, -1 if the handler is empty
+         */
+        int subscribeFrames(FrameDispatcher::FrameHandler handler,
+                            const FrameDispatcher::SubscriptionConfig &config = FrameDispatcher::SubscriptionConfig());
+
+        /**
+         * @brief Remove a frame subscription; its queued frames are discarded
+         * @param subscriptionId Subscription ID from subscribeFrames
+         * @return true if the subscription existed
+         */
+        bool unsubscribeFrames(int subscriptionId);
+
+        /**
+         * @brief Get one of the most recently published frames of a channel
+         *
+         * The service keeps the last frameBufferSize frames of every channel
+         * without holding on to device capture buffers: frames published to
+         * the raw ring are looked up there, the others are kept as copies.
+         * Frames dropped because the raw ring was full are not retained.
+         *
+         * @param age 0 for the latest frame, 1 for the one before, ...
+         * @param frame Output parameter receiving a copy of the frame, to be treated as read-only
+         * @param channel Index of the channel
+         * @return Status code; INVALID_ARGUMENT if the frame is no longer retained
+         */
+        Status getRetainedFrame(size_t age, std::shared_ptr<Frame> &frame, size_t channel = 0) const;
+
         /**
          * @brief Get performance metrics about the service operation
          * @return Performance metrics structure
@@ -178,6 +476,17 @@ namespace medical::imaging {
          */
         std::map<std::string, std::string> getStatistics() const;
 
+        /**
+         * @brief Render the service metrics in the Prometheus text exposition format
+         *
+         * Covers frame and drop counters, latency histograms, buffer pool
+         * exhaustion, ring occupancy and per-reader lag. Safe to call from
+         * any thread; only reads atomics and histogram snapshots.
+         *
+         * @return Metrics text (content type text/plain; version=0.0.4)
+         */
+        std::string exportMetrics() const;
+
         /**
          * @brief Get available devices
          * @return List of available device IDs
@@ -199,11 +508,145 @@ namespace medical::imaging {
          */
         static bool unregisterDeviceChangeCallback(int subscriptionId);
 
+        /**
+         * @brief Get the number of capture channels
+         * @return One per device the service drives
+         */
+        size_t getChannelCount() const;
+
+        /**
+         * @brief Get the device of a channel
+         * @param channel Channel index
+         * @return Shared pointer to the device, nullptr if the channel does not exist
+         */
+        std::shared_ptr<CaptureDevice> getDevice(size_t channel = 0) const;
+
         /**
          * @brief Get the shared memory interface
-         * @return Shared pointer to the shared memory interface
+         * @param channel Channel index
+         * @return Shared pointer to the shared memory interface, nullptr if the channel does not exist
+         */
+        std::shared_ptr<SharedMemory> getSharedMemory(size_t channel = 0) const;
+
+        /**
+         * @brief Get the shared memory interface carrying converted frames
+         * @param channel Channel index
+         * @return Shared pointer to the converted channel, nullptr if conversion is disabled
+         */
+        std::shared_ptr<SharedMemory> getConvertedSharedMemory(size_t channel = 0) const;
+
+        /**
+         * @brief Get the shared memory interface carrying decimated preview frames
+         * @param channel Channel index
+         * @return Shared pointer to the preview channel, nullptr if the preview is disabled
+         */
+        std::shared_ptr<SharedMemory> getPreviewSharedMemory(size_t channel = 0) const;
+
+        /**
+         * @brief Get the shared memory interface carrying compressed frames
+         * @param channel Channel index
+         * @return Shared pointer to the compressed channel, nullptr if compression is disabled
+         */
+        std::shared_ptr<SharedMemory> getCompressedSharedMemory(size_t channel = 0) const;
+
+        /**
+         * @brief Get the shared memory interface carrying GPU frame descriptors
+         * @param channel Channel index
+         * @return Shared pointer to the GPU channel, nullptr if the GPU upload is disabled
+         */
+        std::shared_ptr<SharedMemory> getGpuSharedMemory(size_t channel = 0) const;
+
+        /**
+         * @brief Get the shared memory interface carrying dma-buf frame descriptors
+         * @param channel Channel index
+         * @return Shared pointer to the dma-buf channel, nullptr if the export is disabled
+         */
+        std::shared_ptr<SharedMemory> getDmaBufSharedMemory(size_t channel = 0) const;
+
+        /**
+         * @brief Find a ring the service publishes by name
+         * @param name Ring name, as listed by getSharedMemoryNames()
+         * @return Shared pointer to the ring, nullptr if there is none of that name
+         */
+        std::shared_ptr<SharedMemory> findSharedMemory(const std::string &name) const;
+
+        /**
+         * @brief Save the last part of a ring to a recording file without copying it
+         *
+         * Pins the frames of the last @p duration in the ring (see
+         * SharedMemory::pinFrames()) and hands them to a FrameRecorder,
+         * which writes them in the background and releases each frame once
+         * it is on disk. Capture keeps publishing around the pinned payloads
+         * meanwhile. Returns once the frames are pinned; the file is complete
+         * when getStatistics() no longer counts it in "clips_saving".
+         *
+         * @param ringName Ring to save from, as listed by getSharedMemoryNames()
+         * @param duration Length of the clip, measured back from the newest frame
+         * @param filePath Recording file to write, truncated if it exists
+         * @return Status code, INVALID_ARGUMENT for an unknown ring, COMMUNICATION_ERROR if the ring holds no frame
+         */
+        Status saveClip(const std::string &ringName, std::chrono::milliseconds duration, const std::string &filePath);
+
+        /**
+         * @brief Get the names of every ring the service publishes right now
+         *
+         * Includes the format rings consumers asked for, which come and go.
+         *
+         * @return Ring names, channel by channel
+         */
+        std::vector<std::string> getSharedMemoryNames() const;
+
+        /**
+         * @brief Change the region of interest of a channel while running
+         *
+         * Takes effect from the next captured frame. The region is clamped to
+         * the frame and aligned to the pixel blocks of its format.
+         *
+         * @param roi New region, disabled to publish full frames
+         * @param channel Channel index
+         * @return Status code indicating success or failure
          */
-        std::shared_ptr<SharedMemory> getSharedMemory() const;
+        Status setRegionOfInterest(const RegionOfInterest &roi, size_t channel = 0);
+
+        /**
+         * @brief Get the region of interest of a channel
+         * @param channel Channel index
+         * @return Requested region, disabled if frames are published whole
+         */
+        RegionOfInterest getRegionOfInterest(size_t channel = 0) const;
+
+        /**
+         * @brief Get the name of the ring a channel publishes to
+         * @param baseName Config::sharedMemoryName or the name of one of the derived rings
+         * @param channel Channel index
+         * @return baseName for channel 0, "<baseName>_<channel>" otherwise
+         */
+        static std::string getChannelRingName(const std::string &baseName, size_t channel);
+
+        /**
+         * @brief Record a startup step timed outside the service, such as device discovery
+         *
+         * Recording a name again replaces the earlier stage.
+         *
+         * @param name Stage name
+         * @param begin When the step began
+         * @param end When it finished
+         */
+        void recordStartupStage(const std::string &name, std::chrono::steady_clock::time_point begin,
+                                std::chrono::steady_clock::time_point end);
+
+        /**
+         * @brief Get the time each startup step took
+         *
+         * initialize() creates the raw rings, then faults them in and builds
+         * the optional rings of every channel while the devices open and
+         * detect their modes, each channel on threads of its own.
+         * "first_frame" covers everything from the first stage to the first
+         * frame received after start().
+         *
+         * @return Stages in the order they began
+         */
+        std::vector<StartupStage> getStartupTimeline() const;
 
         /**
          * @brief Dump diagnostic information to a file
@@ -212,15 +655,181 @@ namespace medical::imaging {
          */
         bool dumpDiagnostics(const std::string &filePath) const;
 
+        /**
+         * @brief Write the recent per-frame trace points as a Chrome/Perfetto trace
+         * @param filePath Path to the output file (Config::traceFile if empty)
+         * @return true if successful, false if tracing is disabled or the file could not be written
+         */
+        bool dumpTrace(const std::string &filePath = "") const;
+
     private:
+        /**
+         * @brief A captured frame on its way from the device callback to the publisher thread
+         */
+        struct PendingFrame {
+            std::shared_ptr<Frame> frame;
+            std::chrono::steady_clock::time_point arrivalTime; // When the device callback handed it over
+        };
+
+        /**
+         * @brief Entry of a channel's retention buffer; never holds a capture buffer
+         */
+        struct RetainedFrame {
+            uint64_t frameId;            // Frame ID, looked up in the channel's raw ring
+            std::shared_ptr<Frame> copy; // Service-owned copy when the channel has no ring
+        };
+
+        /**
+         * @brief Fingerprint of the newest payload a ring holds, and the frame it was written for
+         */
+        struct PublishedFingerprint {
+            uint64_t fingerprint; // 0 when unknown
+            uint64_t frameId;
+
+            PublishedFingerprint() : fingerprint(0), frameId(0) {
+            }
+        };
+
+        /**
+         * @brief Frames a raw ring reader had lost to being lapped when the monitor last looked
+         */
+        struct ReaderSkips {
+            size_t slot;           // Registration slot of the reader
+            pid_t pid;             // Process owning it, so a reused slot starts from zero
+            uint64_t framesSkipped;
+        };
+
+        /**
+         * @brief Lag histogram of a raw ring reader when the monitor last looked
+         */
+        struct ReaderLag {
+            size_t slot;                    // Registration slot of the reader
+            pid_t pid;                      // Process owning it, so a reused slot starts from zero
+            LatencyHistogram::Snapshot lag; // Frames behind, as sampled by the writer
+            uint64_t published;             // Frames the writer had published when sampled
+            uint64_t consumed;              // Frames the reader had read or filtered out when sampled
+        };
+
+        // Why a channel publishes keep-alive frames only, see Channel::idleReason
+        static constexpr uint8_t IDLE_NONE = 0;      // Publishing every frame
+        static constexpr uint8_t IDLE_UNREAD = 1;    // Nothing consumes the channel
+        static constexpr uint8_t IDLE_NO_SIGNAL = 2; // The device reports no input signal
+
+        /**
+         * @brief One capture device and the rings it publishes to
+         */
+        struct Channel {
+            size_t index;                                        // Position in channels_
+            std::string sharedMemoryName;                        // Name of the raw ring
+            std::string convertedSharedMemoryName;               // Name of the converted ring
+            std::shared_ptr<CaptureDevice> device;
+            std::shared_ptr<SharedMemory> sharedMemory;
+            std::unique_ptr<FrameConverter> frameConverter;      // Optional conversion stage
+            std::shared_ptr<SharedMemory> convertedSharedMemory;
+            std::string previewSharedMemoryName;                 // Name of the preview ring
+            std::unique_ptr<FrameScaler> frameScaler;            // Optional preview stage
+            std::shared_ptr<SharedMemory> previewSharedMemory;
+            std::chrono::steady_clock::time_point nextPreviewTime; // Only touched by the device's callback thread
+            std::atomic<uint64_t> previewFramesSkipped;          // Frames left out of the preview by the rate limit
+            std::string compressedSharedMemoryName;              // Name of the compressed ring
+            std::unique_ptr<FrameCompressor> frameCompressor;    // Optional compression stage, reads the raw ring
+            std::shared_ptr<SharedMemory> compressedSharedMemory;
+            std::string gpuSharedMemoryName;                     // Name of the GPU descriptor ring
+            std::unique_ptr<GpuUploader> gpuUploader;            // Optional GPU upload stage, reads the raw ring
+            std::shared_ptr<SharedMemory> gpuSharedMemory;
+            std::string dmaBufSharedMemoryName;                  // Name of the dma-buf descriptor ring
+            std::unique_ptr<DmaBufExporter> dmaBufExporter;      // Optional dma-buf export stage, reads the raw ring
+            std::shared_ptr<SharedMemory> dmaBufSharedMemory;
+            std::unique_ptr<FormatCache> formatCache;            // Rings of the formats consumers asked for, reads the raw ring
+            std::atomic<uint64_t> framesCropped;                 // Frames published as a region of the capture
+            std::atomic<uint64_t> framesCroppedInPlace;          // Of those, frames compacted inside their capture buffer
+            uint64_t lastFingerprint;                            // Fingerprint of the previous frame, publisher only
+            PublishedFingerprint rawFingerprint;                 // Newest payload of each ring, publisher only
+            PublishedFingerprint convertedFingerprint;
+            PublishedFingerprint previewFingerprint;
+            std::chrono::steady_clock::time_point nextKeepAliveTime; // When a frozen image is published again under THROTTLE
+            std::atomic<uint64_t> framesDuplicate;               // Frames published as duplicates of the previous one
+            std::atomic<uint64_t> framesSuppressed;              // Duplicates left out under THROTTLE
+            std::atomic<uint8_t> idleReason;                     // Why the channel publishes keep-alive frames only
+            std::chrono::steady_clock::time_point nextIdleKeepAliveTime; // When an idle channel publishes again
+            std::atomic<uint64_t> framesIdle;                    // Frames left out while idle
+            int numaNode;                                        // Node the channel is placed on (-1 for none)
+            size_t maxFrameBytes;                                // Largest frame the device delivers, sizes its rings
+            std::atomic<uint64_t> frameCount;                    // Frames received from the device
+            std::chrono::steady_clock::time_point lastFrameTime; // Only touched by the device's callback thread
+            LatencyHistogram captureIntervalHistogram;
+            LatencyHistogram::Snapshot lastIntervalSnapshot;     // Monitor thread only, for the current FPS window
+            double currentFps;                                   // Guarded by metricsMutex_
+            std::unique_ptr<SpscQueue<PendingFrame>> publishQueue; // Device callback to publisher thread (null to publish inline)
+            std::thread publishThread;
+            std::atomic<bool> stopPublishing;
+            std::atomic<uint32_t> publishDoorbell;               // Futex word bumped after every queued frame
+            std::atomic<uint32_t> publishWaiters;                // Publisher threads sleeping on publishDoorbell
+            std::atomic<uint64_t> publishQueueDrops;             // Frames dropped because the publisher fell behind
+            FramePacing pacing;                                  // Frame interval jitter and drops by cause
+            std::vector<ReaderSkips> readerSkips;                // Monitor thread only, for reader overwrites
+            std::vector<ReaderLag> readerLag;                    // Monitor thread only, for the adaptive ring size
+            std::chrono::steady_clock::time_point ringQuietSince; // Monitor thread only, since when the ring could shrink
+            std::vector<RetainedFrame> retainedFrames;           // Last frameBufferSize frames, guarded by retainedMutex
+            size_t retainedNext;                                 // Slot the next frame is retained in
+            uint64_t retainedTotal;                              // Frames ever retained, guarded by retainedMutex
+            mutable std::mutex retainedMutex;
+
+            Channel() : index(0), previewFramesSkipped(0), framesCropped(0), framesCroppedInPlace(0), lastFingerprint(0),
+                        framesDuplicate(0), framesSuppressed(0), idleReason(IDLE_NONE), framesIdle(0), numaNode(-1),
+                        maxFrameBytes(0), frameCount(0), currentFps(0.0), stopPublishing(false), publishDoorbell(0), publishWaiters(0),
+                        publishQueueDrops(0), retainedNext(0), retainedTotal(0) {
+            }
+        };
+
         // Internal methods
         void captureThread();
-        void handleNewFrame(const std::shared_ptr<Frame> &frame);
+        void handleNewFrame(Channel &channel, const std::shared_ptr<Frame> &frame);
+        void publishFrame(Channel &channel, const std::shared_ptr<Frame> &capturedFrame);
+        void publisherThread(Channel &channel);
+        uint8_t checkIdle(const Channel &channel) const;
+        bool hasConsumers(const Channel &channel) const;
+        void retainFrame(Channel &channel, const std::shared_ptr<Frame> &frame, bool published);
+        std::shared_ptr<Frame> cropFrame(Channel &channel, const std::shared_ptr<Frame> &frame,
+                                         const LiveSettings &settings);
+        void publishConvertedFrame(Channel &channel, const std::shared_ptr<Frame> &frame, uint64_t fingerprint,
+                                   const LiveSettings &settings);
+        void publishPreviewFrame(Channel &channel, const std::shared_ptr<Frame> &frame, uint64_t fingerprint,
+                                 const LiveSettings &settings);
+        SharedMemory::Status writeDuplicate(SharedMemory &ring, const PublishedFingerprint &published,
+                                            const std::shared_ptr<Frame> &frame, uint64_t fingerprint,
+                                            const LiveSettings &settings) const;
         void performanceMonitorThread();
+        void updatePacing();
+        void resizeRings();
+        void stopPerformanceMonitor();
 
         // Utility methods
-        Status setupDevice();
-        Status setupSharedMemory();
+        Status setupThreadLayout(const std::string &text);
+        LiveSettings makeLiveSettings() const;
+        Status selectDevices();
+        Status setupChannels();
+        Status setupChannelRings(Channel &channel);
+        Status setupDevice(Channel &channel);
+        Status setupSharedMemory(Channel &channel);
+        Status populateSharedMemory(Channel &channel);
+        Status setupConversion(Channel &channel);
+        Status setupPreview(Channel &channel);
+        Status setupCompression(Channel &channel);
+        Status startCompressors();
+        void stopCompressors();
+        Status setupGpuUpload(Channel &channel);
+        Status startGpuUploaders();
+        void stopGpuUploaders();
+        Status setupDmaBufExport(Channel &channel);
+        Status startDmaBufExporters();
+        void stopDmaBufExporters();
+        Status startFormatCaches();
+        void stopFormatCaches();
+        void startPublishers();
+        void stopPublishers();
+        void stopChannels(size_t count);
+        std::vector<std::pair<std::string, std::shared_ptr<SharedMemory>>> getChannelRings(const Channel &channel) const;
         void updatePerformanceMetrics();
         bool setThreadPriority(std::thread &thread, bool isRealtime, int priority = 0);
         bool setThreadAffinity(std::thread &thread, int cpuCore);
@@ -231,33 +840,58 @@ namespace medical::imaging {
         std::atomic<bool> stopRequested_;
 
         Config config_;
+        mutable std::mutex configMutex_;        // Guards config_ against reconfigure() while running
+
+        // What the publish path reads per frame; replaced by reconfigure() and setRegionOfInterest()
+        RcuSnapshot<LiveSettings> liveSettings_;
+        std::mutex reconfigureMutex_;           // Serialises read-modify-update of liveSettings_
 
-        std::shared_ptr<BlackmagicDevice> device_;
-        std::shared_ptr<SharedMemory> sharedMemory_;
+        // Capture channels, channel 0 being the primary device
+        std::vector<std::unique_ptr<Channel>> channels_;
+        int numaNode_; // Node of the primary channel, where the service threads run (-1 for none)
 
         std::function<void(std::shared_ptr<Frame>)> frameCallback_;
+        FrameDispatcher frameDispatcher_; // Subscribers added through subscribeFrames
 
         // Threading
         std::thread captureThread_;
         std::thread performanceThread_;
+        std::mutex monitorMutex_;
+        std::condition_variable monitorCondition_; // Wakes the monitor thread for stop()
         std::mutex mutex_;
 
-        // Frame buffer for minimal buffering
-        std::vector<std::shared_ptr<Frame>> frameBuffer_;
-        size_t frameBufferHead_;
-        size_t frameBufferTail_;
-        std::mutex frameBufferMutex_;
-        std::condition_variable frameCondition_;
-
         // Performance monitoring
         std::atomic<uint64_t> frameCount_;
-        std::atomic<uint64_t> droppedFrames_;
+        std::atomic<uint64_t> droppedFrames_;  // Frames the publish queues dropped; per-cause counts are in Channel::pacing
+        std::atomic<bool> traceDumpRequested_; // A frame was dropped since the last automatic trace dump
         std::chrono::system_clock::time_point startTime_;
-        std::chrono::system_clock::time_point lastFrameTime_;
-        std::deque<double> fpsHistory_;
-        std::deque<double> latencyHistory_;
+        std::chrono::steady_clock::time_point lastFrameTime_; // When capture started, the reference for each channel's first interval
+
+        // Wait-free histograms recorded on the capture path (nanoseconds), merged when read
+        LatencyHistogram captureIntervalHistogram_;
+        LatencyHistogram shmWriteHistogram_;
+        LatencyHistogram publishQueueHistogram_;
+        LatencyHistogram latencyHistogram_;
+        LatencyHistogram conversionHistogram_;
+        LatencyHistogram previewHistogram_;
+        LatencyHistogram fingerprintHistogram_;
         mutable std::mutex metricsMutex_;
         PerformanceMetrics metrics_{};
+
+        // Startup timeline, written by the setup threads and the first frame
+        struct TimedStage {
+            std::string name;
+            std::chrono::steady_clock::time_point begin;
+            std::chrono::steady_clock::time_point end;
+        };
+        std::vector<TimedStage> startupStages_;
+        mutable std::mutex startupMutex_;
+        std::atomic<bool> firstFrameSeen_; // The first frame since start() has been timed
+
+        // Clips from saveClip() still being written, or written and not yet collected; destroyed
+        // before the channels, since their frames view the rings
+        std::vector<std::unique_ptr<FrameRecorder>> clipRecorders_;
+        mutable std::mutex clipMutex_;
     };
 
     // Helper to get a global instance
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace medical::imaging {
+    /**
+     * @class MetricsServer
+     * @brief Minimal HTTP server exposing a Prometheus/OpenMetrics scrape endpoint
+     *
+     * Serves GET /metrics from its own normal-priority thread; every scrape
+     * calls the render function, so nothing is computed between scrapes and
+     * the capture path is never touched by monitoring traffic.
+     */
+    class MetricsServer {
+    public:
+        /**
+         * @brief Status codes for server operations
+         */
+        enum class Status {
+            OK,              // Operation completed successfully
+            ALREADY_RUNNING, // Server already running
+            NOT_RUNNING,     // Server not running
+            BIND_FAILED,     // Could not open the listening socket
+            INVALID_ARGUMENT // Invalid argument provided
+        };
+
+        /**
+         * @brief Server configuration
+         */
+        struct Config {
+            std::string bindAddress; // IPv4 address to listen on
+            uint16_t port;           // TCP port to listen on
+
+            // Constructor with default values
+            Config() : bindAddress("0.0.0.0"),
+                       port(9464) {
+            }
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Server configuration
+         */
+        explicit MetricsServer(const Config &config = Config());
+
+        /**
+         * @brief Destructor, stops the server
+         */
+        ~MetricsServer();
+
+        MetricsServer(const MetricsServer &) = delete;
+        MetricsServer &operator=(const MetricsServer &) = delete;
+
+        /**
+         * @brief Start listening
+         * @param render Function producing the metrics in the Prometheus text format
+         * @return Status code indicating success or failure
+         */
+        Status start(std::function<std::string()> render);
+
+        /**
+         * @brief Stop listening and join the server thread
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the server is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the number of scrapes served
+         * @return Number of successful /metrics responses
+         */
+        uint64_t getScrapeCount() const;
+
+    private:
+        void serverThread();
+        void handleConnection(int clientFd);
+
+        Config config_;
+        std::function<std::string()> render_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+        std::atomic<uint64_t> scrapeCount_;
+        int listenFd_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,173 @@
+#pragma once
+
+/*
+ * Stable C ABI for frame ring consumers (Python ctypes/cffi, Rust FFI).
+ *
+ * Wraps the reader side of the shared memory protocol described in
+ * protocol.md, so every language gets the same doorbell wakeup, reader
+ * registration and seqlock validation. Frames are handed out as views that
+ * point straight into the mapping together with their geometry and row
+ * stride, which is enough to wrap them as a numpy array or ndarray view
+ * without a copy.
+ *
+ * Every structure passed in or out starts with struct_size, so fields can be
+ * appended in later ABI versions without breaking callers built against
+ * older headers: the library reads and writes only the fields the caller's
+ * struct_size covers.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define MIVI_API __attribute__((visibility("default")))
+#else
+#define MIVI_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Version of this ABI, bumped whenever a structure or function is added or
+ * changed. 2 added the format and filter configuration fields, the pollable
+ * descriptor, tracing and struct_size in mivi_frame_view.
+ */
+#define MIVI_ABI_VERSION 2
+
+/* Longest wait of mivi_reader_open() for the ring of a requested format */
+#define MIVI_FORMAT_WAIT_MS 2000
+
+/* Status codes returned by every function */
+typedef enum mivi_status {
+    MIVI_OK = 0,                     /* Operation completed successfully */
+    MIVI_ERROR_INVALID_ARGUMENT = 1, /* NULL pointer, bad size or unknown option */
+    MIVI_ERROR_CONNECTION_FAILED = 2,/* The ring does not exist or could not be mapped */
+    MIVI_ERROR_TOO_MANY_READERS = 3, /* Reader registration table is full */
+    MIVI_ERROR_EMPTY = 4,            /* No frame to read (non-blocking call) */
+    MIVI_ERROR_TIMEOUT = 5,          /* No frame arrived in time */
+    MIVI_ERROR_TORN = 6,             /* The writer reused the slot while it was being read */
+    MIVI_ERROR_READ_FAILED = 7,      /* Any other read failure */
+    MIVI_ERROR_VERSION_MISMATCH = 8  /* The ring was laid out by an incompatible protocol version */
+} mivi_status;
+
+/* Shared memory backends, same order as SharedMemoryType */
+typedef enum mivi_shm_type {
+    MIVI_SHM_POSIX = 0,
+    MIVI_SHM_SYSV = 1,
+    MIVI_SHM_MAPPED_FILE = 2,
+    MIVI_SHM_HUGE_PAGES = 3
+} mivi_shm_type;
+
+/* Reader configuration, fill with mivi_reader_config_init() first */
+typedef struct mivi_reader_config {
+    uint32_t struct_size;     /* sizeof(mivi_reader_config) */
+    const char *name;         /* Name of the ring, e.g. "ultrasound_frames" */
+    const char *file_path;    /* Backing file, NULL for /dev/shm/<name> */
+    uint32_t shm_type;        /* mivi_shm_type of the ring */
+    uint32_t lossy;           /* Nonzero to never hold back the writer and skip frames when lapped */
+    uint32_t parse_metadata;  /* Nonzero to expose the binary metadata record of every frame */
+    uint32_t format_code;     /* Format to read the ring's frames in (see protocol.md), 0 for as published */
+    uint32_t frame_stride;    /* Only every n-th sequence number, 0 or 1 for every frame */
+    float max_rate_hz;        /* At most this many frames per second of capture time, 0 for no limit */
+    uint32_t required_flags;  /* Frame flags a frame must have (see protocol.md) */
+    uint32_t excluded_flags;  /* Frame flags a frame must not have, e.g. 0x40 to skip duplicates */
+} mivi_reader_config;
+
+/*
+ * Zero-copy view of one frame; the data stays readable until the writer
+ * reuses the slot. Set struct_size before acquiring; a batch steps through
+ * the array by the struct_size of its first element.
+ */
+typedef struct mivi_frame_view {
+    uint32_t struct_size;         /* sizeof(mivi_frame_view) */
+    const void *data;             /* Payload inside the mapping */
+    uint64_t data_size;           /* Payload size in bytes */
+    uint32_t width;               /* Frame width in pixels */
+    uint32_t height;              /* Frame height in pixels */
+    uint32_t bytes_per_pixel;     /* Bytes per pixel */
+    uint32_t row_stride;          /* Bytes from one row to the next */
+    uint32_t format_code;         /* Format code (see protocol.md) */
+    uint32_t flags;               /* Frame flags (see protocol.md) */
+    uint64_t frame_id;            /* Unique frame identifier */
+    uint64_t sequence_number;     /* Ring sequence number of the slot */
+    uint64_t timestamp_ns;        /* Frame timestamp (nanoseconds since epoch) */
+    uint64_t capture_time_ns;     /* Capture time on CLOCK_MONOTONIC, 0 if unknown */
+    const void *metadata;         /* Frame metadata record (see protocol.md), NULL if absent */
+    const void *guard;            /* Private: slot generation counter */
+    uint64_t expected_generation; /* Private: generation the slot holds while the view is intact */
+} mivi_frame_view;
+
+/* Reader statistics */
+typedef struct mivi_reader_stats {
+    uint32_t struct_size;          /* sizeof(mivi_reader_stats) */
+    int32_t reader_slot;           /* Slot in the reader registration table, -1 if unregistered */
+    uint64_t frames_read;          /* Frames consumed through this reader */
+    uint64_t frames_skipped;       /* Frames lost because the writer lapped this reader */
+    uint64_t lag_frames;           /* Frames published but not yet consumed */
+    uint64_t total_frames_written; /* Frames the writer has published */
+    uint64_t dropped_frames;       /* Frames the writer dropped */
+} mivi_reader_stats;
+
+/* Opaque reader handle */
+typedef struct mivi_reader mivi_reader;
+
+/* Get the ABI version the library was built with (MIVI_ABI_VERSION) */
+MIVI_API uint32_t mivi_abi_version(void);
+
+/* Get a static description of a status code */
+MIVI_API const char *mivi_status_string(mivi_status status);
+
+/* Fill a configuration with defaults: "ultrasound_frames", memory-mapped file, lossy */
+MIVI_API void mivi_reader_config_init(mivi_reader_config *config);
+
+/*
+ * Attach to a ring and register as a reader. With a format_code, the
+ * reader asks the service for that format and reads the ring it converts
+ * into, waiting up to MIVI_FORMAT_WAIT_MS for the service to create it.
+ */
+MIVI_API mivi_status mivi_reader_open(const mivi_reader_config *config, mivi_reader **reader);
+
+/* Unregister and detach; views obtained from the reader become invalid */
+MIVI_API void mivi_reader_close(mivi_reader *reader);
+
+/* Wait until a frame can be acquired without consuming it; timeout 0 only checks */
+MIVI_API mivi_status mivi_reader_wait(mivi_reader *reader, uint32_t timeout_ms);
+
+/*
+ * Get a descriptor that becomes readable when frames arrive, for poll(),
+ * epoll or an async runtime. The first call asks the service for it on its
+ * control socket (NULL for /tmp/imaging_control.sock); the reader owns it.
+ * Call mivi_reader_arm() before every wait on the descriptor.
+ */
+MIVI_API mivi_status mivi_reader_get_fd(mivi_reader *reader, const char *control_socket, int *fd);
+
+/* Arm the descriptor: MIVI_OK if a frame can be acquired without waiting, MIVI_ERROR_EMPTY once armed */
+MIVI_API mivi_status mivi_reader_arm(mivi_reader *reader);
+
+/* Acquire the next frame, waiting up to timeout_ms (0 for non-blocking); set view->struct_size first */
+MIVI_API mivi_status mivi_reader_acquire_next(mivi_reader *reader, uint32_t timeout_ms, mivi_frame_view *view);
+
+/*
+ * Acquire up to max_count consecutive frames at once, waiting up to
+ * timeout_ms for the first; set views[0].struct_size first.
+ */
+MIVI_API mivi_status mivi_reader_acquire_batch(mivi_reader *reader, uint32_t timeout_ms,
+                                               mivi_frame_view *views, size_t max_count, size_t *count);
+
+/* Finish with a view; MIVI_ERROR_TORN means the data read through it must be discarded */
+MIVI_API mivi_status mivi_reader_release(mivi_reader *reader, const mivi_frame_view *view);
+
+/* Get reader statistics; set stats->struct_size first */
+MIVI_API mivi_status mivi_reader_get_stats(mivi_reader *reader, mivi_reader_stats *stats);
+
+/* Record acquire/release trace points in this process (off by default) */
+MIVI_API void mivi_trace_enable(uint32_t enabled);
+
+/* Write the last window_ms of trace points as a Chrome/Perfetto JSON trace */
+MIVI_API mivi_status mivi_trace_dump(const char *path, uint32_t window_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "communication/shared_memory.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @brief First message on a dma-buf export socket
+     *
+     * Sent with SCM_RIGHTS carrying the memfd backing every slot, followed by
+     * one dma-buf per slot when DMA_BUF_EXPORT_FLAG_DMA_BUF is set.
+     */
+    struct DmaBufExportInfo {
+        char magic[4];       // "MVX1"
+        uint16_t version;    // Message version (2)
+        uint16_t headerSize; // Size of this structure (32)
+        uint32_t slotCount;  // Slots in the memfd
+        uint32_t flags;      // DMA_BUF_EXPORT_FLAG_* bits
+        uint64_t slotSize;   // Bytes per slot with its stamp, a multiple of the page size; slot i at i * slotSize
+        uint64_t regionSize; // Size of the memfd
+    };
+
+    static_assert(sizeof(DmaBufExportInfo) == 32, "DmaBufExportInfo is part of the export protocol");
+
+    // Every slot is also exported as its own dma-buf (udmabuf was available)
+    constexpr uint32_t DMA_BUF_EXPORT_FLAG_DMA_BUF = 0x01;
+
+    /**
+     * @brief Stamp in the last 64 bytes of every slot
+     *
+     * Slots are reused round-robin, so a consumer still reading export n
+     * when export n + slotCount rewrites the slot would read a torn frame.
+     * Like the generation of a ring slot, the stamp holds
+     * 2 * exportSequence + 1 while the exporter copies a frame into the
+     * slot and 2 * exportSequence + 2 once the copy is complete; a
+     * consumer compares it with its descriptor before and after reading.
+     */
+    struct DmaBufSlotStamp {
+        std::atomic<uint64_t> generation; // Generation of the export occupying the slot, 0 before the first
+        uint64_t reserved[7];
+    };
+
+    static_assert(sizeof(DmaBufSlotStamp) == 64, "DmaBufSlotStamp is part of the export protocol");
+
+    /**
+     * @brief Payload of every frame on a dma-buf descriptor ring
+     *
+     * Tells which slot of the exported memfd holds the frame and how it is
+     * laid out. The ring's FrameHeader keeps the frame ID, timestamps,
+     * geometry and metadata of the raw frame.
+     */
+    struct DmaBufFrameDescriptor {
+        char magic[4];           // "MVD1"
+        uint16_t version;        // Descriptor version (1)
+        uint16_t headerSize;     // Size of this structure (72)
+        uint32_t slotIndex;      // Slot holding the frame
+        uint32_t slotCount;      // Slots in rotation
+        uint32_t ownerPid;       // Process exporting the slots
+        uint32_t fourcc;         // DRM fourcc of the payload, 0 if DRM has no code for the format
+        uint32_t width;          // Frame width in pixels
+        uint32_t height;         // Frame height in pixels
+        uint32_t pitch;          // Bytes from the start of one row to the next
+        uint32_t reserved;
+        uint64_t offset;         // Offset of the slot in the memfd
+        uint64_t dataSize;       // Bytes of the slot in use (pitch * height)
+        uint64_t exportSequence; // Export number; the slot's stamp reads 2 * exportSequence + 2 while intact
+        uint64_t frameId;        // Frame the slot holds
+    };
+
+    static_assert(sizeof(DmaBufFrameDescriptor) == 72, "DmaBufFrameDescriptor is part of the shared memory protocol");
+
+    /**
+     * @class DmaBufExporter
+     * @brief Exports the frames of one ring as dma-bufs for GPU and display consumers
+     *
+     * Attaches to the source ring as a lossy reader and copies every frame
+     * into the next of a rotating set of page-aligned slots in a sealed
+     * memfd, with rows padded to a pitch GPUs accept for imports. Each slot
+     * is turned into a dma-buf through /dev/udmabuf. Consumers connect to a
+     * Unix socket, receive the memfd and the slot dma-bufs once through
+     * SCM_RIGHTS, and import them into Vulkan, EGL or OpenCL; a
+     * DmaBufFrameDescriptor on the output ring then names the slot of each
+     * frame, so the display path needs no per-frame texture upload.
+     *
+     * The ring itself lives in a named tmpfs file, which udmabuf cannot
+     * export, hence the one copy into the memfd. Without /dev/udmabuf the
+     * memfd alone is passed, still mappable by CPU consumers.
+     */
+    class DmaBufExporter {
+    public:
+        /**
+         * @brief Status codes for exporter operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Exporter already running
+            NOT_RUNNING,       // Exporter not running
+            CONNECTION_FAILED, // Could not attach to the source ring
+            INVALID_ARGUMENT,  // Invalid argument provided
+            CREATION_FAILED    // Could not create the memfd or the socket
+        };
+
+        /**
+         * @brief Exporter configuration
+         */
+        struct Config {
+            uint32_t slotCount;      // Slots in rotation
+            size_t maxFrameSize;     // Largest frame a slot must hold, before pitch padding
+            uint32_t pitchAlignment; // Rows are padded to a multiple of this when the slot has room
+            std::string socketPath;  // Unix socket consumers fetch the descriptors from
+            int cpuCore;             // CPU core for the exporter thread (-1 for no affinity)
+            std::string threadRole;  // Role the thread is placed under by the ThreadLayout
+
+            // Constructor with default values
+            Config() : slotCount(4),
+                       maxFrameSize(1024 * 1024 * 8),
+                       pitchAlignment(256),
+                       cpuCore(-1),
+                       threadRole("dmabuf") {
+            }
+        };
+
+        /**
+         * @brief Exporter statistics
+         */
+        struct Statistics {
+            uint64_t framesExported; // Frames published to the output ring
+            uint64_t bytesExported;  // Bytes copied into slots for those frames
+            uint64_t framesTorn;     // Frames the writer overwrote while they were being copied
+            uint64_t framesDropped;  // Frames that did not fit a slot or that the output ring did not accept
+            uint64_t framesSkipped;  // Frames lost because the writer lapped the exporter
+            uint64_t lagFrames;      // Frames published but not yet picked up by the exporter
+            uint64_t clientsServed;  // Consumers the descriptors were passed to
+            bool dmaBufExported;     // Slots are exported as dma-bufs, not only as a memfd
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Exporter configuration
+         */
+        explicit DmaBufExporter(const Config &config);
+
+        /**
+         * @brief Destructor, stops exporting
+         */
+        ~DmaBufExporter();
+
+        DmaBufExporter(const DmaBufExporter &) = delete;
+        DmaBufExporter &operator=(const DmaBufExporter &) = delete;
+
+        /**
+         * @brief Create the slots and the socket, attach to a ring and start exporting
+         * @param sourceConfig Configuration of the ring to export; create and readerMode are overridden
+         * @param output Ring the descriptors are published to (server side)
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &sourceConfig, const std::shared_ptr<SharedMemory> &output);
+
+        /**
+         * @brief Stop exporting, remove the socket and close the slots
+         *
+         * Consumers keep the memfd and dma-bufs they received; the memory is
+         * freed when the last of them closes its descriptors.
+         *
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the exporter is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the exporter configuration
+         * @return Exporter configuration
+         */
+        const Config &getConfig() const;
+
+        /**
+         * @brief Get exporter statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get exporter statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+        /**
+         * @brief Get the histogram of time spent copying a frame into its slot
+         * @return Histogram of copy times in nanoseconds
+         */
+        const LatencyHistogram &getCopyTimeHistogram() const;
+
+        /**
+         * @brief Get the DRM fourcc of a pixel format
+         * @param format Pixel format
+         * @return fourcc code, 0 if DRM has none (v210, r210, R12B)
+         */
+        static uint32_t toDrmFourcc(PixelFormat format);
+
+    private:
+        void exporterThread();
+        void serveClients();
+        void closeSlots();
+
+        Config config_;
+        std::shared_ptr<SharedMemory> source_;
+        std::shared_ptr<SharedMemory> output_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+
+        // Slots, created by start() and closed by stop()
+        int memfd_;
+        uint8_t *mapping_;
+        size_t slotSize_;
+        std::vector<int> slotFds_;
+        int listenFd_;
+
+        // Updated by the exporter thread, read by anyone
+        std::atomic<uint64_t> framesExported_;
+        std::atomic<uint64_t> bytesExported_;
+        std::atomic<uint64_t> framesTorn_;
+        std::atomic<uint64_t> framesDropped_;
+        std::atomic<uint64_t> clientsServed_;
+        std::atomic<bool> dmaBufExported_;
+        LatencyHistogram copyTimeHistogram_;
+    };
+
+    /**
+     * @class DmaBufClient
+     * @brief Consumer side of a dma-buf export socket
+     *
+     * Fetches the memfd and slot dma-bufs once, maps the memfd read-only and
+     * turns descriptors read from the descriptor ring into DMA_BUFFER frames
+     * (or hands out the slot dma-buf for a GPU import).
+     */
+    class DmaBufClient {
+    public:
+        DmaBufClient();
+        ~DmaBufClient();
+
+        DmaBufClient(const DmaBufClient &) = delete;
+        DmaBufClient &operator=(const DmaBufClient &) = delete;
+
+        /**
+         * @brief Fetch the slots from an exporter
+         * @param socketPath Exporter socket
+         * @return true if the descriptors were received and the memfd mapped
+         */
+        bool connect(const std::string &socketPath);
+
+        /**
+         * @brief Unmap the slots and close every descriptor
+         */
+        void disconnect();
+
+        /**
+         * @brief Check if the slots are available
+         * @return true after a successful connect()
+         */
+        bool isConnected() const;
+
+        /**
+         * @brief Get the layout the exporter announced
+         * @return Export information
+         */
+        const DmaBufExportInfo &getInfo() const;
+
+        /**
+         * @brief Get the dma-buf of a slot, for importing it into a GPU API
+         * @param slot Slot index
+         * @return dma-buf file descriptor, -1 if the exporter passed none
+         */
+        int getSlotFd(uint32_t slot) const;
+
+        /**
+         * @brief Get the memfd backing every slot
+         * @return memfd file descriptor, -1 if not connected
+         */
+        int getMemfd() const;
+
+        /**
+         * @brief Wrap the slot a descriptor names in a frame (zero-copy)
+         *
+         * The frame keeps the ID, timestamps and metadata of the descriptor
+         * frame; attribute "pitch" gives its row pitch. It is only valid
+         * until the exporter reuses the slot, slotCount exports later:
+         * validate() on the frame checks the slot's stamp, so call it after
+         * reading and discard what was read if it returns false.
+         *
+         * @param descriptorFrame Frame read from the descriptor ring
+         * @return DMA_BUFFER frame, nullptr if the descriptor does not match the slots or the slot was reused
+         */
+        std::shared_ptr<Frame> wrapFrame(const Frame &descriptorFrame) const;
+
+    private:
+        DmaBufExportInfo info_;
+        int memfd_;
+        std::vector<int> slotFds_;
+        const uint8_t *mapping_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "communication/shared_memory.h"
+#include "frame/frame_converter.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @class FormatCache
+     * @brief Converts the frames of one ring once per format its consumers asked for
+     *
+     * Consumers declare the format they want when they register on the
+     * source ring (SharedMemory::Config::requestedFormat). The cache scans
+     * the reader table, and for every distinct requested format creates a
+     * ring named getRingName(source, format) with a worker thread that
+     * attaches to the source as a lossy reader and converts each frame
+     * once, however many consumers read the result. A format ring is torn
+     * down once neither the source ring nor the format ring has had a
+     * reader for it during the idle timeout, so no CPU goes into formats
+     * nobody reads.
+     */
+    class FormatCache {
+    public:
+        /**
+         * @brief Status codes for cache operations
+         */
+        enum class Status {
+            OK,               // Operation completed successfully
+            ALREADY_RUNNING,  // Cache already running
+            NOT_RUNNING,      // Cache not running
+            INVALID_ARGUMENT  // Invalid argument provided
+        };
+
+        /**
+         * @brief Cache configuration
+         */
+        struct Config {
+            SharedMemory::Config ringConfig; // Template of the format rings; name, filePath, create and maxFrameSize are set per format
+            unsigned int scanIntervalMs;     // Period of the reader table scan
+            unsigned int idleTimeoutMs;      // How long a format ring outlives its last subscriber
+            int cpuCore;                     // CPU core for the scan and worker threads (-1 for no affinity)
+            std::string threadRole;          // Role the threads are placed under by the ThreadLayout
+
+            // Constructor with default values
+            Config() : scanIntervalMs(100),
+                       idleTimeoutMs(2000),
+                       cpuCore(-1),
+                       threadRole("formats") {
+            }
+        };
+
+        /**
+         * @brief Statistics of one format ring
+         */
+        struct FormatStatistics {
+            PixelFormat format;       // Format the ring carries
+            std::string ringName;     // Name of the ring
+            uint32_t subscribers;     // Readers asking for the format on the source ring or reading the format ring
+            uint64_t framesConverted; // Frames published to the format ring
+            uint64_t framesTorn;      // Frames the writer overwrote while they were being converted
+            uint64_t framesDropped;   // Frames the format ring did not accept
+            uint64_t framesSkipped;   // Frames lost because the writer lapped the worker
+            uint64_t lagFrames;       // Frames published but not yet picked up by the worker
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Cache configuration
+         */
+        explicit FormatCache(const Config &config);
+
+        /**
+         * @brief Destructor, stops converting and removes the format rings
+         */
+        ~FormatCache();
+
+        FormatCache(const FormatCache &) = delete;
+        FormatCache &operator=(const FormatCache &) = delete;
+
+        /**
+         * @brief Start watching a ring for requested formats
+         * @param sourceConfig Configuration workers attach to the ring with; create and readerMode are overridden
+         * @param source The ring itself (server side), whose reader table is scanned
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &sourceConfig, const std::shared_ptr<SharedMemory> &source);
+
+        /**
+         * @brief Stop every worker and remove the format rings
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the cache is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the statistics of every live format ring
+         * @return One entry per format ring
+         */
+        std::vector<FormatStatistics> getStatistics() const;
+
+        /**
+         * @brief Get the number of live format rings
+         *
+         * Each has a worker registered as a reader of the source ring.
+         *
+         * @return Format rings published
+         */
+        size_t getFormatCount() const;
+
+        /**
+         * @brief Check whether any format ring has a reader attached
+         *
+         * Looks at the reader tables directly, so a consumer that just
+         * attached counts before the next scan.
+         *
+         * @return true if a format ring is read
+         */
+        bool hasSubscribers() const;
+
+        /**
+         * @brief Get cache statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+        /**
+         * @brief Get the histogram of time spent converting and publishing a frame, all formats together
+         * @return Histogram of conversion times in nanoseconds
+         */
+        const LatencyHistogram &getConversionTimeHistogram() const;
+
+        /**
+         * @brief Find a live format ring by name
+         * @param ringName Name given by getRingName()
+         * @return Shared pointer to the ring, nullptr if no worker publishes it
+         */
+        std::shared_ptr<SharedMemory> findRing(const std::string &ringName) const;
+
+        /**
+         * @brief Get the name of the ring carrying a ring's frames in another format
+         * @param sourceName Name of the source ring, e.g. "ultrasound_frames"
+         * @param format Requested format
+         * @return Ring name, e.g. "ultrasound_frames_gray8"
+         */
+        static std::string getRingName(const std::string &sourceName, PixelFormat format);
+
+    private:
+        struct Worker {
+            explicit Worker(PixelFormat format) : converter(format) {
+            }
+
+            FrameConverter converter;
+            std::string ringName;
+            std::shared_ptr<SharedMemory> source;
+            std::shared_ptr<SharedMemory> output;
+            std::thread thread;
+            std::atomic<bool> stopRequested{false};
+            std::atomic<uint32_t> subscribers{0};
+            std::chrono::steady_clock::time_point lastSubscribed;
+
+            // Updated by the worker thread, read by anyone
+            std::atomic<uint64_t> framesConverted{0};
+            std::atomic<uint64_t> framesTorn{0};
+            std::atomic<uint64_t> framesDropped{0};
+        };
+
+        void scanThread();
+        void scanReaders();
+        std::unique_ptr<Worker> startWorker(PixelFormat format);
+        void stopWorker(Worker &worker);
+        void workerThread(Worker &worker);
+        void placeCurrentThread() const;
+
+        Config config_;
+        SharedMemory::Config sourceConfig_;
+        std::shared_ptr<SharedMemory> source_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+        std::mutex scanMutex_;
+        std::condition_variable scanCondition_; // Wakes the scan thread for stop()
+
+        // Live workers, added and removed by the scan thread
+        mutable std::mutex workersMutex_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::set<uint32_t> rejectedFormats_;
+
+        LatencyHistogram conversionTimeHistogram_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "communication/shared_memory.h"
+#include "frame/frame.h"
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#define MIVI_FRAME_POLLER_COROUTINES 1
+#endif
+
+namespace medical::imaging {
+    /**
+     * @class FramePoller
+     * @brief One-thread event loop over frame rings and other descriptors
+     *
+     * Waits with epoll on the notification descriptors of any number of
+     * rings (see ControlClient::subscribe()) together with sockets, timers
+     * or anything else pollable, so a consumer needs no thread per ring.
+     * Ready rings are drained frame by frame until armNotification() finds
+     * nothing left, which also arms them for the next wait.
+     *
+     * The epoll descriptor itself is pollable, so the poller can be nested
+     * in another event loop or async runtime: wait for getDescriptor() to
+     * become readable there and call poll(0).
+     *
+     * Built as C++20, next() returns an awaitable so that a coroutine can
+     * write `auto frame = co_await poller.next(ring);`. The coroutine is
+     * resumed from poll() on the polling thread; the task type is the
+     * caller's. Not thread safe: use one poller per thread, and call
+     * stop() from other threads only.
+     */
+    class FramePoller {
+    public:
+        using FrameHandler = std::function<void(std::shared_ptr<Frame>)>;
+        using EventHandler = std::function<void(uint32_t events)>;
+
+        FramePoller();
+        ~FramePoller();
+
+        FramePoller(const FramePoller &) = delete;
+        FramePoller &operator=(const FramePoller &) = delete;
+
+        /**
+         * @brief Check whether the epoll instance could be created
+         * @return true if the poller is usable
+         */
+        bool isValid() const;
+
+        /**
+         * @brief Get the epoll descriptor, readable whenever poll(0) has work
+         * @return epoll descriptor, -1 if the poller is not valid
+         */
+        int getDescriptor() const;
+
+        /**
+         * @brief Watch a ring
+         * @param ring Registered reader with a notification descriptor
+         * @param handler Called with every frame read, may be empty when only next() is used
+         * @return false if the ring has no notification descriptor or is watched already
+         */
+        bool addRing(std::shared_ptr<SharedMemory> ring, FrameHandler handler = nullptr);
+
+        /**
+         * @brief Stop watching a ring; a coroutine waiting on it is resumed with no frame
+         * @param ring Ring passed to addRing()
+         * @return true if the ring was watched
+         */
+        bool removeRing(const SharedMemory &ring);
+
+        /**
+         * @brief Watch any other descriptor
+         * @param descriptor Descriptor to poll, owned by the caller
+         * @param events EPOLLIN, EPOLLOUT and so on
+         * @param handler Called with the returned events; level triggered
+         * @return false if the descriptor could not be added
+         */
+        bool addDescriptor(int descriptor, uint32_t events, EventHandler handler);
+
+        /**
+         * @brief Stop watching a descriptor added with addDescriptor()
+         * @param descriptor Descriptor to remove
+         * @return true if it was watched
+         */
+        bool removeDescriptor(int descriptor);
+
+        /**
+         * @brief Wait once and dispatch whatever is ready
+         * @param timeoutMs Longest wait, 0 to only dispatch, negative to wait for ever
+         * @return Number of frames and events dispatched, -1 on error
+         */
+        int poll(int timeoutMs);
+
+        /**
+         * @brief Dispatch until stop() is called
+         */
+        void run();
+
+        /**
+         * @brief Make run() return; safe from any thread
+         */
+        void stop();
+
+#ifdef MIVI_FRAME_POLLER_COROUTINES
+        /**
+         * @brief Awaitable for the next frame of a watched ring
+         */
+        class NextFrame {
+        public:
+            NextFrame(FramePoller &poller, SharedMemory &ring) : poller_(poller), ring_(ring) {
+            }
+
+            bool await_ready() {
+                return ring_.readNextFrame(frame_, 0) == SharedMemory::Status::OK;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                // Not watched: resume at once with no frame
+                return poller_.setWaiter(ring_, [this, handle](bool cancelled) {
+                    if (!cancelled && ring_.readNextFrame(frame_, 0) != SharedMemory::Status::OK) {
+                        return false;
+                    }
+                    handle.resume();
+                    return true;
+                });
+            }
+
+            std::shared_ptr<Frame> await_resume() {
+                return std::move(frame_);
+            }
+
+        private:
+            FramePoller &poller_;
+            SharedMemory &ring_;
+            std::shared_ptr<Frame> frame_;
+        };
+
+        /**
+         * @brief Wait for the next frame of a watched ring in a coroutine
+         * @param ring Ring passed to addRing()
+         * @return Awaitable yielding the frame, nullptr if the ring is not watched or was removed meanwhile
+         */
+        NextFrame next(SharedMemory &ring) {
+            return NextFrame(*this, ring);
+        }
+#endif
+
+    private:
+        struct Entry {
+            std::shared_ptr<SharedMemory> ring; // nullptr for plain descriptors
+            FrameHandler frameHandler;
+            EventHandler eventHandler;
+            // Suspended next(): reads one frame and resumes, false if none; cancelled resumes with no frame
+            std::function<bool(bool cancelled)> waiter;
+        };
+
+        // Park a coroutine on a watched ring; false if the ring is not watched
+        bool setWaiter(SharedMemory &ring, std::function<bool(bool cancelled)> waiter);
+
+        // Read frames of a ready ring until it is armed again
+        int drainRing(int descriptor);
+
+        int epollFd_;
+        int wakeFd_; // eventfd stop() signals
+        std::atomic<bool> stopRequested_;
+        std::map<int, Entry> entries_; // By descriptor
+    };
+} // namespace medical::imaging
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "communication/shared_memory.h"
+
+namespace medical::imaging {
+    /**
+     * @brief Datagram layout of the frame network bridge, see protocol.md
+     */
+    struct NetworkPacketHeader {
+        static constexpr uint32_t MAGIC = 0x504E564D; // "MVNP"
+        static constexpr uint16_t VERSION = 1;
+        static constexpr uint16_t TYPE_FRAME = 1;     // Fragment of a frame message
+        static constexpr uint16_t TYPE_CANCEL = 2;    // The frame was overwritten while sent; drop what arrived
+
+        uint32_t magic;          // MAGIC
+        uint16_t version;        // VERSION
+        uint16_t type;           // TYPE_*
+        uint32_t streamId;       // Chosen at random when the publisher starts, so receivers notice restarts
+        uint32_t packetCount;    // Datagrams of this frame
+        uint64_t packetSequence; // Datagrams sent on the stream before this one; gaps are losses
+        uint64_t frameSequence;  // Ring sequence number of the frame at the publisher
+        uint32_t packetIndex;    // Position of this datagram in the frame
+        uint32_t fragmentOffset; // Offset of the fragment in the frame message
+        uint32_t fragmentSize;   // Bytes following this header
+        uint32_t messageSize;    // Size of the whole frame message
+    };
+
+    /**
+     * @class NetworkPublisher
+     * @brief Sends the frames of a ring to other nodes over UDP multicast
+     *
+     * Attaches to the ring as a lossy reader, like FrameRecorder, so a slow
+     * network makes it skip frames rather than back-pressure capture.
+     * Every frame becomes one message, the ring's FrameHeader, metadata
+     * record and payload, cut into datagrams sent with sendmmsg() straight
+     * from the ring. Any number of NetworkReceivers in the multicast group
+     * get the same datagrams, so subscribers cost the sender nothing.
+     *
+     * Config::rateMbps paces the datagrams, spreading a large frame over
+     * its frame interval instead of bursting it into switch buffers and
+     * the receivers' socket queues, which is where multicast loses packets.
+     * A unicast address sends to a single receiver instead.
+     */
+    class NetworkPublisher {
+    public:
+        /**
+         * @brief Status codes for publisher operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Publisher already running
+            NOT_RUNNING,       // Publisher not running
+            CONNECTION_FAILED, // Could not attach to the ring
+            SOCKET_ERROR,      // Could not set up the socket
+            INVALID_ARGUMENT   // Invalid argument provided
+        };
+
+        /**
+         * @brief Publisher configuration
+         */
+        struct Config {
+            std::string address;          // Multicast group (or unicast host) to send to
+            uint16_t port;                // UDP port
+            std::string interfaceAddress; // Local address of the interface to send from, empty for the default route
+            int ttl;                      // Multicast hops; 1 keeps the frames on the local network
+            size_t datagramSize;          // UDP payload per datagram: 1472 for a 1500 MTU, 8972 for jumbo frames
+            double rateMbps;              // Pacing rate, 0 to send as fast as the socket takes the datagrams
+            size_t socketBufferBytes;     // Send buffer to ask the kernel for
+            int cpuCore;                  // CPU core for the sender thread (-1 for no affinity)
+
+            // Constructor with default values
+            Config() : address("239.192.0.1"),
+                       port(5004),
+                       interfaceAddress(""),
+                       ttl(1),
+                       datagramSize(1472),
+                       rateMbps(0.0),
+                       socketBufferBytes(4 * 1024 * 1024),
+                       cpuCore(-1) {
+            }
+        };
+
+        /**
+         * @brief Publisher statistics
+         */
+        struct Statistics {
+            uint64_t framesSent;     // Frames sent completely
+            uint64_t packetsSent;    // Datagrams sent
+            uint64_t bytesSent;      // UDP payload bytes sent, packet headers included
+            uint64_t framesTorn;     // Frames the writer overwrote while they were sent (cancelled)
+            uint64_t sendErrors;     // Frames abandoned because a send failed
+            uint64_t framesSkipped;  // Frames lost because the writer lapped the publisher
+            uint64_t lagFrames;      // Frames published but not yet picked up by the publisher
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Publisher configuration
+         */
+        explicit NetworkPublisher(const Config &config);
+
+        /**
+         * @brief Destructor, stops publishing
+         */
+        ~NetworkPublisher();
+
+        NetworkPublisher(const NetworkPublisher &) = delete;
+        NetworkPublisher &operator=(const NetworkPublisher &) = delete;
+
+        /**
+         * @brief Attach to a ring and start sending its frames
+         * @param ringConfig Configuration of the ring to send; create and readerMode are overridden
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &ringConfig);
+
+        /**
+         * @brief Stop sending and detach from the ring
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the publisher is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get publisher statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get publisher statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+    private:
+        struct Impl;
+
+        void senderThread();
+
+        Config config_;
+        std::unique_ptr<Impl> impl_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+
+        // Updated by the sender thread, read by anyone
+        std::atomic<uint64_t> framesSent_;
+        std::atomic<uint64_t> packetsSent_;
+        std::atomic<uint64_t> bytesSent_;
+        std::atomic<uint64_t> framesTorn_;
+        std::atomic<uint64_t> sendErrors_;
+    };
+
+    /**
+     * @class NetworkReceiver
+     * @brief Rebuilds a local ring from the frames a NetworkPublisher sends
+     *
+     * Joins the multicast group, reassembles the datagrams of every frame
+     * and writes complete frames into a SharedMemory ring it creates, with
+     * the frame IDs, timestamps and metadata the publisher sent. Consumers
+     * on the receiving node attach to that ring as if the capture card
+     * were local.
+     *
+     * Losses are detected from the packet sequence numbers. A frame with a
+     * missing datagram is dropped once a newer frame completes, since
+     * multicast does not retransmit, and counted in framesIncomplete.
+     * Times are those of the sending node, so captureTimeNs compares with
+     * other frames of the stream but not with the receiver's clock.
+     */
+    class NetworkReceiver {
+    public:
+        /**
+         * @brief Status codes for receiver operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Receiver already running
+            NOT_RUNNING,       // Receiver not running
+            CREATION_FAILED,   // Could not create the local ring
+            SOCKET_ERROR,      // Could not set up the socket or join the group
+            INVALID_ARGUMENT   // Invalid argument provided
+        };
+
+        /**
+         * @brief Receiver configuration
+         */
+        struct Config {
+            std::string address;          // Multicast group to join (or a unicast stream's local address, empty for any)
+            uint16_t port;                // UDP port
+            std::string interfaceAddress; // Local address of the interface to join on, empty for the default
+            size_t maxDatagramSize;       // Largest datagram accepted, at least the publisher's datagramSize
+            size_t reassemblySlots;       // Frames reassembled at once
+            size_t socketBufferBytes;     // Receive buffer to ask the kernel for; a full one drops datagrams
+            int cpuCore;                  // CPU core for the receiver thread (-1 for no affinity)
+
+            // Constructor with default values
+            Config() : address("239.192.0.1"),
+                       port(5004),
+                       interfaceAddress(""),
+                       maxDatagramSize(9000),
+                       reassemblySlots(4),
+                       socketBufferBytes(16 * 1024 * 1024),
+                       cpuCore(-1) {
+            }
+        };
+
+        /**
+         * @brief Receiver statistics
+         */
+        struct Statistics {
+            uint64_t framesReceived;   // Frames reassembled and written to the local ring
+            uint64_t packetsReceived;  // Valid datagrams received
+            uint64_t packetsLost;      // Datagrams missing from the packet sequence
+            uint64_t framesIncomplete; // Frames dropped with datagrams missing
+            uint64_t framesLost;       // Frames between the ones received that never completed, or were never sent
+            uint64_t framesTorn;       // Frames the publisher cancelled
+            uint64_t writeFailures;    // Complete frames the local ring refused
+            uint64_t invalidPackets;   // Datagrams that were not bridge packets or did not fit their frame
+            uint64_t streamRestarts;   // Times a new publisher stream was seen
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Receiver configuration
+         */
+        explicit NetworkReceiver(const Config &config);
+
+        /**
+         * @brief Destructor, stops receiving
+         */
+        ~NetworkReceiver();
+
+        NetworkReceiver(const NetworkReceiver &) = delete;
+        NetworkReceiver &operator=(const NetworkReceiver &) = delete;
+
+        /**
+         * @brief Create the local ring, join the group and start receiving
+         * @param ringConfig Configuration of the local ring; create is overridden
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &ringConfig);
+
+        /**
+         * @brief Stop receiving and remove the local ring
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the receiver is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the local ring the frames are written to
+         * @return Ring, nullptr if not running
+         */
+        std::shared_ptr<SharedMemory> getSharedMemory() const;
+
+        /**
+         * @brief Get receiver statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get receiver statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+    private:
+        struct Impl;
+
+        void receiverThread();
+
+        Config config_;
+        std::unique_ptr<Impl> impl_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace medical::imaging {
+    /**
+     * @struct ProbePose
+     * @brief One tracker sample of the probe pose
+     */
+    struct ProbePose {
+        uint64_t timestampNs = 0;                       // When the pose was measured, on CLOCK_MONOTONIC
+        float position[3] = {0.0f, 0.0f, 0.0f};         // Probe position [x,y,z] in the tracker's units
+        float orientation[4] = {0.0f, 0.0f, 0.0f, 1.0f}; // Unit quaternion [x,y,z,w]
+        uint32_t quality = 0;                           // Tracker-specific quality or status code
+    };
+
+    /**
+     * @brief Shared memory layout of a pose ring, see protocol.md
+     */
+    struct PoseRingLayout {
+        static constexpr uint32_t MAGIC = 0x5350564D; // "MVPS"
+        static constexpr uint32_t VERSION = 1;
+
+        struct Header {
+            uint32_t magic;                     // MAGIC once the ring is laid out
+            uint32_t version;                   // VERSION
+            uint32_t capacity;                  // Number of sample slots, a power of two
+            uint32_t sampleSize;                // sizeof(Sample)
+            uint8_t reserved0[48];              // Unused, zero
+            alignas(64) std::atomic<uint64_t> writeIndex; // Next sample number to publish
+            uint8_t reserved1[56];              // Unused, zero
+        };
+
+        struct Sample {
+            std::atomic<uint64_t> generation;   // Seqlock: 2*index+1 while written, 2*index+2 when complete
+            uint64_t timestampNs;               // CLOCK_MONOTONIC time of the measurement
+            float position[3];                  // [x,y,z]
+            float orientation[4];               // Quaternion [x,y,z,w]
+            uint32_t quality;                   // Tracker-specific quality or status code
+            uint8_t reserved[16];               // Unused, zero
+        };
+    };
+
+    /**
+     * @class PoseWriter
+     * @brief Publishes probe poses from a tracker into a small ring in shared memory
+     *
+     * EM and optical trackers sample at a few hundred Hz on their own clock,
+     * independently of the frames. The tracker adapter publishes every
+     * sample here and the frame writer, or any consumer, interpolates the
+     * pose at a frame's capture time with a PoseReader. Samples are 64-byte
+     * seqlocked slots, so neither side ever takes a lock, and the ring is
+     * only a few pages: 1024 samples hold four seconds at 240 Hz.
+     *
+     * Sample timestamps must increase and be on CLOCK_MONOTONIC, the frame
+     * capture clock. publishTrackerTime() maps tracker timestamps there
+     * with the smallest offset observed between arrival and measurement,
+     * the usual estimate when only one-way timing is known; the tracker's
+     * fixed latency can be added as Config::trackerLatencyNs.
+     */
+    class PoseWriter {
+    public:
+        /**
+         * @brief Writer configuration
+         */
+        struct Config {
+            std::string name;          // POSIX shared memory name of the ring
+            size_t capacity;           // Retained samples, rounded up to a power of two
+            uint64_t trackerLatencyNs; // Measurement to delivery latency the tracker adds, for publishTrackerTime()
+
+            // Constructor with default values
+            Config() : name("ultrasound_frames_pose"),
+                       capacity(1024),
+                       trackerLatencyNs(0) {
+            }
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Writer configuration
+         */
+        explicit PoseWriter(const Config &config = Config());
+
+        /**
+         * @brief Destructor, removes the ring
+         */
+        ~PoseWriter();
+
+        PoseWriter(const PoseWriter &) = delete;
+        PoseWriter &operator=(const PoseWriter &) = delete;
+
+        /**
+         * @brief Create the ring, replacing one a crashed writer left behind
+         * @return true on success
+         */
+        bool initialize();
+
+        /**
+         * @brief Publish a sample timestamped on CLOCK_MONOTONIC
+         * @param pose Sample; its timestamp must not be older than the previous one
+         * @return false if the ring is not initialized or the timestamp went back
+         */
+        bool publish(const ProbePose &pose);
+
+        /**
+         * @brief Publish a sample timestamped on the tracker's clock
+         * @param trackerTimeNs Measurement time on the tracker clock
+         * @param pose Sample; its timestamp is replaced by the mapped time, never older than the previous one
+         * @return false if the ring is not initialized
+         */
+        bool publishTrackerTime(uint64_t trackerTimeNs, ProbePose pose);
+
+        /**
+         * @brief Get the number of samples published
+         * @return Samples published since initialize()
+         */
+        uint64_t getSampleCount() const;
+
+    private:
+        void release();
+
+        Config config_;
+        int fd_;
+        void *mapping_;
+        size_t mappingSize_;
+        PoseRingLayout::Header *header_;
+        PoseRingLayout::Sample *samples_;
+        uint64_t lastTimestampNs_;
+
+        // Clock mapping: minimum of arrival minus measurement time over the current and previous windows
+        int64_t offsetWindowMin_;
+        int64_t offsetPreviousMin_;
+        uint64_t offsetWindowStartNs_;
+    };
+
+    /**
+     * @class PoseReader
+     * @brief Looks up the probe pose at any recent point in time
+     *
+     * Attaches to the ring read-only. interpolate() binary-searches the
+     * retained samples for the two around the requested time and blends
+     * them: linearly for the position, by spherical interpolation for the
+     * orientation. Samples the writer overwrites during a lookup fail their
+     * generation check and the lookup retries on newer ones.
+     */
+    class PoseReader {
+    public:
+        /**
+         * @brief Reader configuration
+         */
+        struct Config {
+            std::string name;          // POSIX shared memory name of the ring
+            uint64_t maxGapNs;         // Refuse to interpolate across samples further apart than this
+            uint64_t maxExtrapolationNs; // Hold the newest sample for requests up to this much after it
+
+            // Constructor with default values
+            Config() : name("ultrasound_frames_pose"),
+                       maxGapNs(50000000),          // 50 ms, a dozen lost samples at 240 Hz
+                       maxExtrapolationNs(10000000) { // 10 ms
+            }
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Reader configuration
+         */
+        explicit PoseReader(const Config &config = Config());
+
+        /**
+         * @brief Destructor, unmaps the ring
+         */
+        ~PoseReader();
+
+        PoseReader(const PoseReader &) = delete;
+        PoseReader &operator=(const PoseReader &) = delete;
+
+        /**
+         * @brief Map the ring
+         * @return true if a compatible ring exists
+         */
+        bool initialize();
+
+        /**
+         * @brief Check if the ring is mapped
+         * @return true after a successful initialize()
+         */
+        bool isAttached() const;
+
+        /**
+         * @brief Get the pose at a point in time
+         * @param timestampNs Time on CLOCK_MONOTONIC, e.g. a frame's capture time
+         * @param pose Output parameter receiving the interpolated pose, timestamped timestampNs
+         * @return false if no retained samples bracket the time closely enough
+         */
+        bool interpolate(uint64_t timestampNs, ProbePose &pose) const;
+
+        /**
+         * @brief Get the newest sample
+         * @param pose Output parameter receiving the sample
+         * @return false if nothing was published yet
+         */
+        bool latest(ProbePose &pose) const;
+
+    private:
+        // Copy sample index out of the ring; false if it is not (or no longer) that sample
+        bool readSample(uint64_t index, ProbePose &pose) const;
+
+        Config config_;
+        void *mapping_;
+        size_t mappingSize_;
+        const PoseRingLayout::Header *header_;
+        const PoseRingLayout::Sample *samples_;
+        uint64_t mask_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "communication/shared_memory.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @class ResultPublisher
+     * @brief Publishes per-frame analysis results (segmentation masks, contours) to a result ring
+     *
+     * A result ring is an ordinary ring created by the process that produces
+     * the results. Each result carries the frame ID, timestamps and capture
+     * time of the frame it was computed from, plus FRAME_FLAG_SEGMENTATION,
+     * so consumers find it again with SharedMemory::findFrame() or pair it
+     * with its frame through a FrameResultJoiner. The ring drops results
+     * when full: a slow consumer never holds back the segmentation service.
+     */
+    class ResultPublisher {
+    public:
+        /**
+         * @brief Status codes for publisher operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Publisher already initialized
+            NOT_RUNNING,       // Publisher not initialized
+            CREATION_FAILED,   // Could not create the result ring
+            WRITE_FAILED,      // The ring did not accept the result
+            INVALID_ARGUMENT   // Invalid argument provided
+        };
+
+        /**
+         * @brief Publisher configuration
+         */
+        struct Config {
+            std::string name;        // Name of the result ring
+            std::string sourceName;  // Name of the frame ring the results belong to
+            SharedMemoryType type;   // Type of shared memory to use
+            size_t size;             // Size of the result ring in bytes
+            size_t maxFrames;        // Results retained in the ring
+            size_t maxResultSize;    // Largest payload of a single result in bytes
+
+            // Constructor with default values
+            Config() : name("ultrasound_frames_results"),
+                       sourceName("ultrasound_frames"),
+                       type(SharedMemoryType::MEMORY_MAPPED_FILE),
+                       size(64 * 1024 * 1024), // 64 MB
+                       maxFrames(120),
+                       maxResultSize(16 * 1024 * 1024) { // Byte mask of a 4K frame, with headroom
+            }
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Publisher configuration
+         */
+        explicit ResultPublisher(const Config &config = Config());
+
+        /**
+         * @brief Create the result ring
+         * @return Status code indicating success or failure
+         */
+        Status initialize();
+
+        /**
+         * @brief Publish the result computed from a frame
+         *
+         * The identity of @p source (frame ID, timestamps, device) is copied
+         * onto @p result before it is written, so callers only fill in the
+         * payload, its geometry and pixel format (e.g. GRAY_8 for a mask).
+         *
+         * @param source Frame the result was computed from
+         * @param result Result payload; its frame ID, timestamps and metadata are overwritten
+         * @return Status code indicating success or failure
+         */
+        Status publish(const Frame &source, const std::shared_ptr<Frame> &result);
+
+        /**
+         * @brief Get the result ring
+         * @return Shared memory of the result ring, nullptr before initialize()
+         */
+        std::shared_ptr<SharedMemory> getSharedMemory() const;
+
+    private:
+        Config config_;
+        std::shared_ptr<SharedMemory> ring_;
+    };
+
+    /**
+     * @struct JoinedFrame
+     * @brief A frame together with the result computed from it, both mapped in place
+     */
+    struct JoinedFrame {
+        std::shared_ptr<Frame> frame;  // Frame from the frame ring
+        std::shared_ptr<Frame> result; // Result with the same frame ID, nullptr if none arrived in time
+
+        /**
+         * @brief Check that neither ring reused its slot since the pair was read
+         * @return true if everything read from the frame and result so far is consistent
+         */
+        bool validate() const {
+            return frame && frame->validate() && (!result || result->validate());
+        }
+    };
+
+    /**
+     * @class FrameResultJoiner
+     * @brief Reads a frame ring and hands out each frame paired with its result
+     *
+     * Consumes the frame ring with its own cursor, like any reader, and looks
+     * the matching result up by frame ID in the result ring, waiting up to
+     * Config::resultWaitMs for a result that has not been published yet.
+     * Neither the frame nor the result is copied. The result ring is attached
+     * as a lossy reader, so the joiner never blocks the result producer, and
+     * lazily, so the joiner can start before the segmentation service does.
+     */
+    class FrameResultJoiner {
+    public:
+        /**
+         * @brief Status codes for joiner operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Joiner already attached
+            NOT_RUNNING,       // Joiner not attached
+            CONNECTION_FAILED, // Could not attach to the frame ring
+            TIMEOUT,           // No frame was published in time
+            READ_FAILED        // The frame ring could not be read
+        };
+
+        /**
+         * @brief Joiner configuration
+         */
+        struct Config {
+            std::string frameRingName;  // Name of the frame ring
+            std::string resultRingName; // Name of the result ring
+            SharedMemoryType type;      // Type of shared memory of both rings
+            ReaderMode readerMode;      // Backpressure behavior on the frame ring
+            unsigned int resultWaitMs;  // How long a frame waits for its result (0 to only take published results)
+
+            // Constructor with default values
+            Config() : frameRingName("ultrasound_frames"),
+                       resultRingName("ultrasound_frames_results"),
+                       type(SharedMemoryType::MEMORY_MAPPED_FILE),
+                       readerMode(ReaderMode::LOSSY),
+                       resultWaitMs(20) {
+            }
+        };
+
+        /**
+         * @brief Joiner statistics
+         */
+        struct Statistics {
+            uint64_t framesRead;      // Frames taken from the frame ring
+            uint64_t framesJoined;    // Of those, frames handed out with a result
+            uint64_t framesUnmatched; // Frames handed out without a result
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Joiner configuration
+         */
+        explicit FrameResultJoiner(const Config &config = Config());
+
+        /**
+         * @brief Attach to the frame ring, and to the result ring if it exists
+         * @return Status code indicating success or failure
+         */
+        Status initialize();
+
+        /**
+         * @brief Read the next frame and its result
+         * @param joined Output parameter receiving the frame and, if one arrived in time, its result
+         * @param waitMilliseconds Maximum time to wait for the frame, 0 for non-blocking
+         * @return Status code indicating success or failure
+         */
+        Status readNext(JoinedFrame &joined, unsigned int waitMilliseconds = 0);
+
+        /**
+         * @brief Get joiner statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get joiner statistics as key-value pairs
+         * @return Map of statistic name to value, keys prefixed with "joiner_"
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+    private:
+        // Attach to the result ring if it was not found before; retried at most once per second
+        bool attachResults();
+
+        Config config_;
+        std::shared_ptr<SharedMemory> frames_;
+        std::shared_ptr<SharedMemory> results_;
+        std::chrono::steady_clock::time_point nextAttachAttempt_;
+        std::atomic<bool> resultsAttached_;
+        std::atomic<uint64_t> framesRead_;
+        std::atomic<uint64_t> framesJoined_;
+        std::atomic<uint64_t> framesUnmatched_;
+        LatencyHistogram resultWaitHistogram_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "communication/shared_memory.h"
+#include "frame/frame.h"
+
+namespace medical::imaging {
+    /**
+     * @brief Worker loop of a stage that reads frames from one ring and publishes what it derives from them
+     *
+     * Waits up to waitMs at a time for the next frame of source until
+     * stopRequested is set; idle() runs before every wait, for work that has
+     * to go on while no frames arrive. consume(frame, intact) reads the slot
+     * and calls intact() once it is done with it. False means the writer
+     * reused the slot meanwhile: the frame was counted in framesTorn and
+     * whatever was derived from it must be discarded.
+     */
+    template<typename Idle, typename Consume>
+    void runRingStage(SharedMemory &source, const std::atomic<bool> &stopRequested, unsigned int waitMs,
+                      std::atomic<uint64_t> &framesTorn, Idle idle, Consume consume) {
+        while (!stopRequested) {
+            idle();
+
+            std::shared_ptr<Frame> frame;
+            if (source.readNextFrame(frame, waitMs) != SharedMemory::Status::OK || !frame) {
+                continue;
+            }
+
+            auto intact = [&frame, &framesTorn] {
+                if (frame->validate()) {
+                    return true;
+                }
+                framesTorn.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            };
+            consume(*frame, intact);
+        }
+    }
+
+    /**
+     * @brief Worker loop of a stage with nothing to do between frames
+     */
+    template<typename Consume>
+    void runRingStage(SharedMemory &source, const std::atomic<bool> &stopRequested, unsigned int waitMs,
+                      std::atomic<uint64_t> &framesTorn, Consume consume) {
+        runRingStage(source, stopRequested, waitMs, framesTorn, [] {}, consume);
+    }
+
+    /**
+     * @brief Publish data derived from a frame under the frame's identity
+     *
+     * The frame written carries the ID, timestamps and metadata of source, so
+     * consumers of output pair it with the frame it was derived from.
+     *
+     * @param output Ring to publish into
+     * @param source Frame the data was derived from
+     * @param data Derived payload, copied by the ring
+     * @param size Size of the payload in bytes
+     * @return true if the ring accepted the frame
+     */
+    inline bool publishDerivedFrame(SharedMemory &output, const Frame &source, void *data, size_t size) {
+        auto derived = Frame::createWithExternalData(
+            data, size, source.getWidth(), source.getHeight(), source.getBytesPerPixel(), source.getPixelFormat(),
+            false, BufferType::EXTERNAL_MEMORY);
+        if (!derived) {
+            return false;
+        }
+        derived->setFrameId(source.getFrameId());
+        derived->setTimestamp(source.getTimestamp());
+        derived->setCaptureTime(source.getCaptureTime());
+        derived->getMetadataMutable() = source.getMetadata();
+        return output.writeFrame(derived) == SharedMemory::Status::OK;
+    }
+} // namespace medical::imaging
@@ -10,8 +10,13 @@
 #include <thread>
 #include <optional>
 #include <map>
+#include <vector>
+#include <sys/types.h>
 
 #include "frame/frame.h"
+#include "frame/frame_copy.h"
+#include "frame/frame_statistics.h"
+#include "utils/latency_histogram.h"
 
 namespace medical::imaging {
     /**
@@ -22,7 +27,62 @@ namespace medical::imaging {
         POSIX_SHM,         // POSIX shared memory (shm_open)
         SYSV_SHM,          // System V shared memory (shmget)
         MEMORY_MAPPED_FILE, // Memory-mapped file (best for cross-language)
-        HUGE_PAGES         // Huge pages for better performance
+        HUGE_PAGES,        // File on a hugetlbfs mount, falling back to POSIX shared memory
+        MEMFD              // Anonymous sealed memfd, reachable only through a passed descriptor
+    };
+
+    /**
+     * @enum ReaderMode
+     * @brief How a consumer participates in ring buffer backpressure
+     */
+    enum class ReaderMode {
+        LOSSLESS,          // Writer never overwrites frames this reader has not consumed
+        LOSSY              // Reader never blocks the writer and skips frames when lapped
+    };
+
+    /**
+     * @struct ReaderFilter
+     * @brief Frames a consumer wants; the writer only wakes it for those
+     *
+     * Every condition must hold. The stride counts ring sequence numbers, so
+     * a stride of 10 passes sequences 0, 10, 20 and so on. maxRateHz passes
+     * the first frame of every 1/maxRateHz interval of capture time, looking
+     * only at the frames the stride passes.
+     */
+    struct ReaderFilter {
+        uint32_t stride;               // Only every stride-th sequence number (0 or 1 for all)
+        double maxRateHz;              // At most this many frames per second of capture time (0 for no limit)
+        uint32_t requiredFlags;        // FRAME_FLAG_* bits a frame must have, e.g. FRAME_FLAG_SEGMENTATION
+        uint32_t excludedFlags;        // FRAME_FLAG_* bits a frame must not have, e.g. FRAME_FLAG_DUPLICATE
+
+        ReaderFilter() : stride(1), maxRateHz(0.0), requiredFlags(0), excludedFlags(0) {
+        }
+
+        // Whether the filter rejects any frame at all
+        bool isActive() const {
+            return stride > 1 || maxRateHz > 0.0 || requiredFlags != 0 || excludedFlags != 0;
+        }
+    };
+
+    /**
+     * @enum DemotionReason
+     * @brief Why the writer stopped letting a lossless reader hold the ring back
+     */
+    enum class DemotionReason {
+        NONE,              // Reader keeps the mode it registered with
+        LAG,               // Fell further behind than the lag limit, now lossy
+        STALE,             // Held unread frames without a heartbeat for too long, now lossy
+        DEAD               // Owning process no longer exists, slot freed
+    };
+
+    /**
+     * @enum WritePolicy
+     * @brief What the writer does when lossless readers still need the space a new frame takes
+     */
+    enum class WritePolicy {
+        DROP_NEWEST,       // Discard the new frame
+        OVERWRITE,         // Overwrite the oldest frames anyway; lossless readers get lapped like lossy ones
+        BLOCK              // Sleep on the space doorbell until the readers catch up or the block timeout passes
     };
 
     /**
@@ -50,9 +110,16 @@ namespace medical::imaging {
             PERMISSION_DENIED,  // Permission denied
             TIMEOUT,            // Operation timed out
             INTERNAL_ERROR,     // Unspecified internal error
-            NOT_SUPPORTED       // Operation not supported by this implementation
+            NOT_SUPPORTED,      // Operation not supported by this implementation
+            TOO_MANY_READERS,   // Reader registration table is full
+            VERSION_MISMATCH    // Region laid out by a different version of the protocol
         };
 
+        /**
+         * @brief Maximum number of consumers that can attach to one region
+         */
+        static constexpr size_t MAX_READERS = 16;
+
         /**
          * @brief Frame header structure stored in shared memory
          */
@@ -66,9 +133,107 @@ namespace medical::imaging {
             uint32_t formatCode;        // Format identifier code
             uint32_t flags;             // Additional flags
             uint64_t sequenceNumber;    // Sequence number for ordering
-            uint32_t metadataOffset;    // Offset to JSON metadata (if present)
-            uint32_t metadataSize;      // Size of metadata in bytes
-            uint64_t padding[4];        // Reserved for future use
+            uint32_t metadataOffset;    // Offset of the metadata record from the header (0 if absent)
+            uint32_t metadataSize;      // Size of the metadata record in bytes (0 if absent)
+            std::atomic<uint64_t> generation; // Seqlock counter: odd while being written, 2*seq+2 when complete
+            uint32_t payloadOffset;     // Payload position in the arena, in PAYLOAD_ALIGNMENT units (see protocol.md)
+            uint32_t duplicateDistance; // Sequences back to the frame whose payload this one repeats (FRAME_FLAG_DUPLICATE)
+            uint64_t captureTimeNs;     // Capture time on CLOCK_MONOTONIC (0 if unknown)
+            uint64_t publishTimeNs;     // CLOCK_MONOTONIC time the slot became readable
+            uint32_t rowPitch;          // Bytes from the start of one payload row to the next
+            std::atomic<uint32_t> rowsReady; // Payload rows copied so far, height once the payload is complete
+        };
+
+        /**
+         * @brief Smallest alignment of a payload in the arena, and the unit of FrameHeader::payloadOffset
+         *
+         * Producers align payloads to Config::payloadAlignment, a multiple of this.
+         */
+        static constexpr size_t PAYLOAD_ALIGNMENT = 64;
+
+        /**
+         * @brief Current version of the binary per-frame metadata record
+         */
+        static constexpr uint32_t FRAME_METADATA_VERSION = 3;
+
+        /**
+         * @brief Fixed-layout per-frame metadata stored right after each FrameHeader, see frame/frame_metadata.h
+         */
+        using FrameMetadataRecord = medical::imaging::FrameMetadataRecord;
+
+        /**
+         * @brief Frame flag bits shared by FrameHeader::flags and FrameMetadataRecord::flags
+         */
+        static constexpr uint32_t FRAME_FLAG_ZERO_COPY = 0x01;
+        static constexpr uint32_t FRAME_FLAG_SEGMENTATION = 0x02;
+        static constexpr uint32_t FRAME_FLAG_CALIBRATION = 0x04;
+        static constexpr uint32_t FRAME_FLAG_PROCESSED = 0x08;
+        static constexpr uint32_t FRAME_FLAG_GEOMETRY_CHANGED = 0x10; // First frame of a new geometry epoch
+        static constexpr uint32_t FRAME_FLAG_CROPPED = 0x20;          // Payload is a region of the captured frame
+        static constexpr uint32_t FRAME_FLAG_DUPLICATE = 0x40;        // Pixels repeat an earlier frame, payload shared with it
+        static constexpr uint32_t FRAME_FLAG_STATISTICS = 0x80;       // Metadata record holds image statistics of the payload
+        static constexpr uint32_t FRAME_FLAG_POSE = 0x100;            // Probe pose interpolated from the pose ring at the capture time
+
+        /**
+         * @brief Lightweight zero-copy view of one ring slot, filled by readFrameViews()
+         *
+         * Unlike a Frame it owns nothing and costs no allocation. The data and
+         * metadata pointers stay inside the mapping; call validate() after
+         * consuming them, a false result means the writer reused the slot.
+         */
+        struct FrameView {
+            const void *data;                     // Frame payload inside the ring
+            size_t dataSize;                      // Size of the payload in bytes
+            uint32_t width;                       // Frame width in pixels
+            uint32_t height;                      // Frame height in pixels
+            uint32_t bytesPerPixel;               // Bytes per pixel
+            PixelFormat format;                   // Pixel format of the payload
+            uint32_t flags;                       // FRAME_FLAG_* bits
+            uint64_t frameId;                     // Unique frame identifier
+            uint64_t sequenceNumber;              // Ring sequence number of the slot
+            uint64_t duplicateOfSequence;         // Slot whose payload this one repeats, sequenceNumber unless FRAME_FLAG_DUPLICATE
+            uint64_t timestampNs;                 // Frame timestamp (nanoseconds since epoch)
+            uint64_t captureTimeNs;               // Capture time on CLOCK_MONOTONIC (0 if unknown)
+            uint32_t rowPitch;                    // Bytes from the start of one row to the next
+            const FrameMetadataRecord *metadata;  // Binary metadata record, nullptr if absent
+            const std::atomic<uint64_t> *generation; // Seqlock counter of the slot
+            uint64_t expectedGeneration;          // Value the counter holds while the view is intact
+            const std::atomic<uint32_t> *rowsReady; // Rows copied so far, see readPartialFrameView()
+
+            /**
+             * @brief Check that the slot has not been overwritten since the view was taken
+             * @return true if everything read through the view so far is consistent
+             */
+            bool validate() const {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return generation && generation->load(std::memory_order_relaxed) == expectedGeneration;
+            }
+        };
+
+        /**
+         * @brief Binary description of a ring's layout, as the producer laid it out
+         *
+         * Carries what a consumer would otherwise parse from the JSON metadata
+         * area. The control socket sends it together with the region's
+         * descriptor (see protocol.md), so attaching needs no parsing.
+         */
+        struct Layout {
+            uint64_t regionSize;       // Size of the whole region
+            uint64_t dataOffset;       // Offset of the header table
+            uint64_t headerStride;     // Bytes per header table entry (frame header plus metadata record)
+            uint64_t slotMetadataSize; // Bytes of the metadata record after each frame header
+            uint64_t maxFrames;        // Entries in the header table
+            uint64_t arenaOffset;      // Offset of the payload arena
+            uint64_t arenaSize;        // Size of the payload arena
+            uint64_t maxFrameSize;     // Largest payload of a single frame
+            uint64_t pageSize;         // Size of the pages backing the region
+            uint64_t layoutHash;       // Hash of the layout, as in the control block
+            uint32_t type;             // SharedMemoryType of the producer's region
+            uint32_t pageBacking;      // 0 regular pages, 1 transparent huge pages, 2 hugetlbfs
+            int32_t numaNode;          // Node backing the region, -1 if unknown
+            uint32_t writerEpoch;      // Writer restarts that adopted the region
+            uint32_t payloadAlignment; // Alignment of every payload in the arena
+            uint32_t rowAlignment;     // Multiple the row pitch of copied payloads is rounded up to, 0 for tight rows
         };
 
         /**
@@ -79,28 +244,72 @@ namespace medical::imaging {
             size_t size;                  // Size of the shared memory region in bytes
             SharedMemoryType type;        // Type of shared memory to use
             bool create;                  // Whether to create the region (server) or connect (client)
-            size_t maxFrames;             // Maximum number of frames in the ring buffer
-            bool useHugePages;            // Use huge pages for better performance
+            size_t maxFrames;             // Maximum number of frames in the ring buffer (entries in the header table)
+            bool useHugePages;            // Back the region with huge pages where the system allows
+            size_t hugePageSize;          // Huge page size to request, e.g. 2 MB or 1 GB (0 for the system default)
+            bool prefault;                // Fault the whole region in during initialize()
+            int numaNode;                 // NUMA node to place the region on (server only, -1 for first touch)
             bool lockInMemory;            // Prevent the memory from being swapped
             bool enableMetadata;          // Enable storing JSON metadata with frames
             std::string filePath;         // Path for memory-mapped file (if using file-backed)
             bool enableRealTimeThreads;   // Use real-time priority for notification threads
-            bool dropFramesWhenFull;      // Whether to drop frames when buffer is full
-            size_t maxFrameSize;          // Maximum size of a single frame in bytes
+            WritePolicy writePolicy;      // Behavior when lossless readers have not freed enough space (server only)
+            unsigned int blockTimeoutMs;  // Longest wait of writeFrame() under WritePolicy::BLOCK
+            size_t maxFrameSize;          // Maximum size of a single frame in bytes (payloads take only their own size)
+            size_t payloadAlignment;      // Alignment of every payload, a power of two (0 for the page size; server only)
+            size_t rowAlignment;          // Round the row pitch of copied payloads up to a multiple of this (0 for tight rows; server only)
+            bool prefetchNextFrame;       // Prefetch the payload of the next expected frame after each read (clients only)
+            bool dropConsumedPages;       // Advise payloads every reader has consumed out of the page cache (server only, disk-backed files)
+            bool computeStatistics;       // Fill image statistics into each metadata record while copying the payload (server only)
+            uint64_t demoteLagFrames;     // Demote lossless readers this many frames behind to lossy (0 never; server only)
+            unsigned int demoteStaleMs;   // Demote lossless readers holding a full ring without a heartbeat this long (0 never; server only)
+            std::string poseRingName;     // Pose ring (see PoseWriter) to fill the probe pose of each frame from, empty for none (server only)
+            ReaderMode readerMode;        // Backpressure behavior of this consumer (clients only)
+            ReaderFilter readerFilter;    // Frames this consumer is woken for and reads (clients only)
+            PixelFormat requestedFormat;  // Format this consumer asks the service to convert to, UNKNOWN for none (clients only)
+            size_t captureBuffers;        // Arena buffers leased to capture hardware at once (server only)
+            CopyMode copyMode;            // Kernel writeFrame() copies payloads with (server only)
+            size_t copyThreads;           // Threads sharing the copy of one large payload (server only)
+            size_t publishBandRows;       // Publish copied payloads in bands of this many rows as they are copied (0 for whole frames; server only)
+            bool persistent;              // Keep the region on shutdown and adopt a compatible one on startup (server only)
+            int attachDescriptor;         // Descriptor of the region to map instead of opening it by name, -1 for none (clients only)
+            Layout attachLayout;          // Layout received with attachDescriptor; headerStride 0 to read the JSON metadata
 
             // Constructor with sensible defaults
             Config() : name("ultrasound_frames"),
-                       size(256 * 1024 * 1024), // 256 MB
+                       size(128 * 1024 * 1024), // 128 MB, as ImagingService::Config
                        type(SharedMemoryType::MEMORY_MAPPED_FILE), // Best for cross-language
                        create(false),
                        maxFrames(120),
                        useHugePages(false),
+                       hugePageSize(0),
+                       prefault(true),
+                       numaNode(-1),
                        lockInMemory(true),
                        enableMetadata(true),
                        filePath("/dev/shm/ultrasound_frames"),
                        enableRealTimeThreads(true),
-                       dropFramesWhenFull(true),
-                       maxFrameSize(17 * 1024 * 1024) { // 17MB - enough for 4K frames
+                       writePolicy(WritePolicy::DROP_NEWEST),
+                       blockTimeoutMs(1000),
+                       maxFrameSize(17 * 1024 * 1024), // 17MB - enough for 4K frames
+                       payloadAlignment(0),
+                       rowAlignment(0),
+                       prefetchNextFrame(true),
+                       dropConsumedPages(true),
+                       computeStatistics(false),
+                       demoteLagFrames(0),
+                       demoteStaleMs(2000),
+                       poseRingName(),
+                       readerMode(ReaderMode::LOSSLESS),
+                       readerFilter(),
+                       requestedFormat(PixelFormat::UNKNOWN),
+                       captureBuffers(0),
+                       copyMode(CopyMode::AUTO),
+                       copyThreads(1),
+                       publishBandRows(0),
+                       persistent(false),
+                       attachDescriptor(-1),
+                       attachLayout() {
             }
         };
 
@@ -118,6 +327,71 @@ namespace medical::imaging {
             uint64_t maxReadLatencyNs;     // Maximum read latency observed
             size_t peakMemoryUsage;        // Peak memory usage in bytes
             double averageFrameSize;       // Average frame size in bytes
+            uint64_t readersDemotedLag;    // Lossless readers this writer demoted for lagging
+            uint64_t readersDemotedStale;  // Lossless readers this writer demoted for a stale heartbeat
+            uint64_t readersReclaimed;     // Slots of dead processes this instance freed
+            uint64_t framesWithPose;       // Frames this writer filled a probe pose into from the pose ring
+            uint64_t pinnedFrames;         // Frames handed out by pinFrames() and not yet released
+            uint64_t pinnedBytes;          // Arena bytes their payloads hold back from the writer
+            uint64_t pinDetours;           // Payloads the writer placed past pinned space instead of over it
+        };
+
+        /**
+         * @brief Frame geometry the producer currently publishes
+         *
+         * The epoch changes whenever width, height or format change, so a
+         * consumer can compare one number per frame instead of every field.
+         */
+        struct Geometry {
+            uint32_t epoch;                // Number of geometry changes so far, 0 before the first frame
+            uint32_t width;                // Frame width in pixels
+            uint32_t height;               // Frame height in pixels
+            uint32_t bytesPerPixel;        // Bytes per pixel
+            PixelFormat format;            // Pixel format
+        };
+
+        /**
+         * @brief Snapshot of one registered consumer
+         */
+        struct ReaderInfo {
+            size_t slot;                   // Index in the reader registration table
+            pid_t pid;                     // Process owning the reader
+            ReaderMode mode;               // Backpressure behavior of the reader
+            PixelFormat requestedFormat;   // Format the reader asked the service to convert to, UNKNOWN for none
+            uint64_t cursor;               // Next sequence number the reader will consume
+            uint64_t lag;                  // Frames published but not yet consumed
+            uint64_t framesRead;           // Frames consumed by the reader
+            uint64_t framesSkipped;        // Frames lost because the writer lapped the reader
+            uint64_t framesFiltered;       // Frames passed over because the reader's filter rejected them
+            ReaderFilter filter;           // Frames the reader asked for
+            uint64_t lastReadTime;         // Timestamp of the last read (ns since epoch)
+            uint64_t lastSequence;         // Sequence number of the last frame consumed
+            uint64_t lastAcquireTimeNs;    // When it was acquired, on CLOCK_MONOTONIC (0 before the first read)
+            uint64_t heartbeatNs;          // Last read of the reader, on CLOCK_MONOTONIC (0 if never reported)
+            DemotionReason demotion;       // Why the writer demoted the reader, NONE if it was not
+        };
+
+        /**
+         * @brief A reader the writer demoted or detached so that capture keeps going
+         */
+        struct ReaderDemotion {
+            size_t slot;                   // Index in the reader registration table
+            pid_t pid;                     // Process owning the reader
+            DemotionReason reason;         // What the reader did wrong
+            uint64_t lag;                  // Frames published but not yet consumed at the time
+            uint64_t idleNs;               // Time since its last heartbeat or read, 0 if unknown
+        };
+
+        /**
+         * @brief Capture-to-consumer latency of one reader, sampled by the writer
+         */
+        struct ReaderLatency {
+            size_t slot;                            // Index in the reader registration table
+            pid_t pid;                              // Process owning the reader
+            ReaderMode mode;                        // Backpressure behavior of the reader
+            LatencyHistogram::Snapshot latency;     // Capture time to acquire time of consumed frames (ns)
+            LatencyHistogram::Snapshot holdTime;    // Acquire to release of frame views (ns)
+            LatencyHistogram::Snapshot lag;         // Frames published but not yet consumed, once per write
         };
 
         /**
@@ -160,6 +434,65 @@ namespace medical::imaging {
         Status writeFrameTimeout(const std::shared_ptr<Frame> &frame,
                                  unsigned int timeoutMs);
 
+        /**
+         * @brief Publish a frame whose pixels repeat the newest frame in the ring, without its payload
+         *
+         * The header takes the ID, timestamps and metadata of @p frame but
+         * points at the payload and geometry of the newest frame, and carries
+         * FRAME_FLAG_DUPLICATE with the distance to the frame that payload
+         * was written for. Nothing is copied and no arena space is used; the
+         * duplicate is invalidated together with that payload.
+         *
+         * @param frame Frame providing ID, timestamps and metadata; its pixels are not read
+         * @param originalFrameId ID of the frame the newest payload must have been written for
+         * @return Status code, BUFFER_EMPTY if the newest payload belongs to another frame
+         */
+        Status writeDuplicateFrame(const std::shared_ptr<Frame> &frame, uint64_t originalFrameId);
+
+        /**
+         * @brief Lease arena space that a capture device can write into directly
+         *
+         * A frame whose data pointer is a leased capture buffer is published by
+         * writeFrame() without copying: the ring takes over the leased bytes and
+         * the lease is rebound to fresh arena space the next time its address is
+         * asked for. Always resolve the current address through
+         * getCaptureBufferData() before writing.
+         *
+         * @param size Number of bytes the producer needs
+         * @return Lease handle, or -1 if none is free or the arena has no room
+         */
+        int acquireCaptureBuffer(size_t size);
+
+        /**
+         * @brief Get the memory currently bound to a capture buffer lease
+         * @param lease Handle returned by acquireCaptureBuffer()
+         * @return Pointer into the arena, nullptr for an invalid lease or when no space could be bound
+         */
+        void *getCaptureBufferData(int lease) const;
+
+        /**
+         * @brief Return a capture buffer lease
+         * @param lease Handle returned by acquireCaptureBuffer()
+         */
+        void releaseCaptureBuffer(int lease);
+
+        /**
+         * @brief Check whether a pointer is the start of a bound capture buffer lease
+         *
+         * A frame built on such a pointer is published by writeFrame() without
+         * a copy, so producers can rework its bytes in place beforehand.
+         *
+         * @param data Pointer to look up
+         * @return true if writeFrame() would publish @p data zero-copy
+         */
+        bool isCaptureBuffer(const void *data) const;
+
+        /**
+         * @brief Get the number of capture buffers that can be leased at once
+         * @return Capture buffer count, 0 if direct capture is not available
+         */
+        size_t getCaptureBufferCount() const;
+
         /**
          * @brief Read the latest frame from shared memory (zero-copy)
          * @param frame Output parameter to store the read frame
@@ -176,6 +509,165 @@ namespace medical::imaging {
         Status readNextFrame(std::shared_ptr<Frame> &frame,
                              unsigned int waitMilliseconds = 0);
 
+        /**
+         * @brief Wait until this reader has a frame to read, without consuming it
+         * @param waitMilliseconds Maximum time to wait in milliseconds, 0 to only check
+         * @return OK if a frame is available, BUFFER_EMPTY or TIMEOUT if not
+         */
+        Status waitForFrame(unsigned int waitMilliseconds);
+
+        /**
+         * @brief Read a batch of consecutive frames from shared memory (zero-copy)
+         *
+         * Waits like readNextFrame() for the first frame, then takes every frame
+         * already published after it, up to @p maxCount, and advances the cursor
+         * once for the whole batch. The batch stops early at a slot the writer is
+         * reusing, so the frames are always consecutive in ring order.
+         *
+         * @param frames Output vector, cleared and filled with the frames in order
+         * @param maxCount Maximum number of frames to read
+         * @param waitMilliseconds Maximum time to wait for the first frame, 0 for non-blocking
+         * @return Status code indicating success or failure
+         */
+        Status readFrames(std::vector<std::shared_ptr<Frame>> &frames, size_t maxCount,
+                          unsigned int waitMilliseconds = 0);
+
+        /**
+         * @brief Read a batch of consecutive frames as views, without allocating
+         *
+         * Same batching as readFrames(), but fills caller-owned FrameView entries
+         * instead of building a Frame per slot, and leaves the metadata record
+         * unparsed (see unpackMetadataRecord()).
+         *
+         * @param views Array of at least @p maxCount views to fill
+         * @param maxCount Maximum number of frames to read
+         * @param count Output parameter receiving the number of views filled
+         * @param waitMilliseconds Maximum time to wait for the first frame, 0 for non-blocking
+         * @return Status code indicating success or failure
+         */
+        Status readFrameViews(FrameView *views, size_t maxCount, size_t &count,
+                              unsigned int waitMilliseconds = 0);
+
+        /**
+         * @brief Finish with a view from readFrameViews()
+         *
+         * Validates the view like FrameView::validate() and publishes how long
+         * it was held in this reader's slot, where the writer picks it up for
+         * its per-consumer latency statistics.
+         *
+         * @param view View to release
+         * @return true if everything read through the view is consistent
+         */
+        bool releaseFrameView(const FrameView &view);
+
+        /**
+         * @brief Get a view of the next frame as soon as its first rows are in the ring
+         *
+         * A writer with Config::publishBandRows set copies a payload in bands
+         * of rows and publishes each band as it lands, so row-parallel work on
+         * a large frame can overlap the copy. The view is of the frame at
+         * this reader's cursor; its header fields, including the metadata
+         * record except the image statistics, are final, while the payload
+         * may only hold its first rows. Wait for more with waitForRows().
+         * A frame published whole returns complete.
+         *
+         * Nothing is consumed: once done, read the frame as usual (it is
+         * then published, and readFrameViews() returns it without a copy).
+         *
+         * @param view Output parameter receiving the view
+         * @param waitMilliseconds Maximum time to wait for the first band, 0 for non-blocking
+         * @return OK, BUFFER_EMPTY or TIMEOUT if the next frame has no rows yet, READ_FAILED if the slot was reused
+         */
+        Status readPartialFrameView(FrameView &view, unsigned int waitMilliseconds = 0);
+
+        /**
+         * @brief Wait until rows of a view from readPartialFrameView() are in the ring
+         * @param view View of a frame that may still be copied
+         * @param rows Rows from the top of the frame needed
+         * @param ready Output parameter receiving the rows present, at least @p rows on success and height once complete
+         * @param waitMilliseconds Maximum time to wait, 0 to only check
+         * @return OK, TIMEOUT, or READ_FAILED if the writer reused the slot (the rows read are not valid)
+         */
+        Status waitForRows(const FrameView &view, uint32_t rows, uint32_t &ready, unsigned int waitMilliseconds);
+
+        /**
+         * @brief Look up a retained frame by frame ID (zero-copy)
+         *
+         * Searches the frames still in the ring, newest first, without moving
+         * this reader's cursor. Result rings use it to find the mask that
+         * belongs to a frame of another ring.
+         *
+         * @param frameId Frame ID to look for
+         * @param frame Output parameter to store the frame
+         * @param waitMilliseconds Maximum time to wait for the frame to be published, 0 for non-blocking
+         * @return OK if found, BUFFER_EMPTY or TIMEOUT if not, or another status on failure
+         */
+        Status findFrame(uint64_t frameId, std::shared_ptr<Frame> &frame,
+                         unsigned int waitMilliseconds = 0);
+
+        /**
+         * @brief Read a retained frame by sequence number (zero-copy)
+         *
+         * Does not move this reader's cursor, so a consumer can look back
+         * at any of the last maxFrames frames while it keeps reading with
+         * readNextFrame().
+         *
+         * @param sequence Ring sequence number, as Frame::getSequenceNumber()
+         * @param frame Output parameter to store the frame
+         * @return OK, BUFFER_EMPTY if not published yet, READ_FAILED if no longer retained
+         */
+        Status readFrameAt(uint64_t sequence, std::shared_ptr<Frame> &frame);
+
+        /**
+         * @brief Read the retained frame captured closest to a point in time (zero-copy)
+         *
+         * Binary-searches the timestamp index in the region, ordered like
+         * the sequence numbers, and validates the frame it picks with its
+         * slot generation. Frames without a capture time are indexed by
+         * their publish time. Does not move this reader's cursor; compare
+         * the frame's capture time with @p timestampNs to see how close it is.
+         *
+         * @param timestampNs Time on CLOCK_MONOTONIC, like FrameHeader::captureTimeNs
+         * @param frame Output parameter to store the frame
+         * @return OK, BUFFER_EMPTY if the ring holds no frame, or another status on failure
+         */
+        Status readFrameNearest(uint64_t timestampNs, std::shared_ptr<Frame> &frame);
+
+        /**
+         * @brief Hold a range of published frames in the arena, e.g. to save a clip (server only, zero-copy)
+         *
+         * Each frame views its payload in the arena like readFrameAt(), with
+         * its header fields and metadata copied out, and the writer leaves
+         * that arena space alone until the frame is destroyed: new payloads
+         * go past pinned ones rather than over them, so capture never waits
+         * for whoever holds the frames. Header slots are reused as usual, so
+         * readers no longer see pinned frames once the ring moves on.
+         *
+         * Frames are pinned newest first, and at most half of the arena can be
+         * pinned at once; older frames of the range that the ring no longer
+         * holds or that do not fit are left out, so compare the first
+         * frame's sequence number with @p firstSequence. The frames must not
+         * outlive this instance.
+         *
+         * @param firstSequence Sequence number of the oldest frame wanted
+         * @param lastSequence Sequence number of the newest frame wanted, inclusive
+         * @param frames Output parameter receiving the pinned frames, oldest first
+         * @return OK if at least one frame was pinned, BUFFER_EMPTY if none could be, or another status on failure
+         */
+        Status pinFrames(uint64_t firstSequence, uint64_t lastSequence, std::vector<std::shared_ptr<Frame>> &frames);
+
+        /**
+         * @brief Pin the frames captured in the last part of the ring (server only, zero-copy)
+         *
+         * Like pinFrames() from the frame captured closest to @p duration
+         * before the newest one up to the newest one.
+         *
+         * @param duration Length of the clip, measured back from the newest frame's capture time
+         * @param frames Output parameter receiving the pinned frames, oldest first
+         * @return OK if at least one frame was pinned, BUFFER_EMPTY if none could be, or another status on failure
+         */
+        Status pinRecentFrames(std::chrono::nanoseconds duration, std::vector<std::shared_ptr<Frame>> &frames);
+
         /**
          * @brief Register a callback for new frames
          * @param callback Function to call when a new frame is available
@@ -189,6 +681,16 @@ namespace medical::imaging {
          */
         Status unregisterFrameCallback();
 
+        /**
+         * @brief Set the function told about readers the writer demotes or detaches
+         *
+         * Called on the writing thread, right after the reader table changed,
+         * so the callback must be quick. Pass an empty function to stop.
+         *
+         * @param callback Function receiving each demotion
+         */
+        void setReaderDemotionCallback(std::function<void(const ReaderDemotion &)> callback);
+
         /**
          * @brief Set the thread affinity for notification threads
          * @param cpuCore CPU core to pin the thread to (-1 for no affinity)
@@ -203,8 +705,24 @@ namespace medical::imaging {
          */
         Status setThreadPriority(int priority);
 
+        /**
+         * @brief Fault the region in now, for a ring initialized with Config::prefault off
+         *
+         * Leaves the contents alone, so other threads may already use the
+         * ring; the producer uses it to populate a large ring while the
+         * capture device is still being brought up. Only the part of the
+         * arena set with resizeArena() is faulted in.
+         *
+         * @return Status code indicating success or failure
+         */
+        Status prefault();
+
         /**
          * @brief Lock the shared memory in RAM (prevent swapping)
+         *
+         * Locks the part of the arena set with resizeArena(); the rest is
+         * locked as the arena grows.
+         *
          * @return Status code indicating success or failure
          */
         Status lockMemory();
@@ -244,16 +762,182 @@ namespace medical::imaging {
          */
         SharedMemoryType getType() const;
 
+        /**
+         * @brief Get the configuration the region was opened with
+         *
+         * In-process consumers attach with getAttachConfig() instead.
+         *
+         * @return Configuration passed to the constructor
+         */
+        const Config &getConfig() const;
+
+        /**
+         * @brief Get a configuration an in-process consumer attaches to this ring with
+         *
+         * The ring's own configuration with create cleared; a memfd ring,
+         * which has no name to open, also passes its descriptor and layout.
+         * Consumers pick their reader mode on the copy. The descriptor stays
+         * owned by this instance, so it must outlive the consumer's initialize().
+         *
+         * @return Client configuration for the same region
+         */
+        Config getAttachConfig() const;
+
+        /**
+         * @brief Get the size of the pages backing the region
+         * @return Page size in bytes; larger than the base page size when huge pages are in use
+         */
+        size_t getPageSize() const;
+
+        /**
+         * @brief Describe how the region is backed
+         * @return "hugetlbfs" (reserved huge pages), "transparent" (THP requested) or "regular"
+         */
+        std::string getPageBacking() const;
+
+        /**
+         * @brief Get the NUMA node backing the region, as placed by the producer
+         * @return NUMA node, -1 if unknown or on a machine without NUMA
+         */
+        int getNumaNode() const;
+
         /**
          * @brief Get the maximum number of frames that can fit in the buffer
+         *
+         * This is the size of the header table; how many frames the arena holds
+         * at once depends on their size.
+         *
          * @return Maximum frame count
          */
         size_t getMaxFrames() const;
 
+        /**
+         * @brief Get the writer epoch of the region
+         *
+         * The epoch goes up by one every time a restarted persistent writer
+         * adopts the region; a consumer that sees it change knows the jump in
+         * sequence numbers is a writer restart.
+         *
+         * @return Writer epoch, 0 for a region that was never adopted
+         */
+        uint32_t getWriterEpoch() const;
+
+        /**
+         * @brief Parse a write policy name
+         * @param name "drop", "overwrite" or "block"
+         * @param policy Output parameter receiving the policy
+         * @return true if the name is known
+         */
+        static bool parseWritePolicy(const std::string &name, WritePolicy &policy);
+
+        /**
+         * @brief Get the name of a write policy
+         * @param policy Write policy
+         * @return "drop", "overwrite" or "block"
+         */
+        static const char *toString(WritePolicy policy);
+
+        /**
+         * @brief Get the name of a shared memory type
+         * @param type Shared memory type
+         * @return "posix", "sysv", "mmf", "huge" or "memfd"
+         */
+        static const char *toString(SharedMemoryType type);
+
+        /**
+         * @brief Measured speed of one backend on this machine
+         */
+        struct BackendBenchmark {
+            SharedMemoryType type;   // Backend measured
+            bool available;          // A ring could be created and a reader attach to it
+            std::string pageBacking; // Pages the ring ended up on
+            uint64_t writeNs;        // Median writeFrame() time
+            uint64_t readNs;         // Median time to read a frame, touch every cache line and validate it
+        };
+
+        /**
+         * @brief Benchmark backends on this machine and pick the fastest
+         *
+         * Creates a small ring per candidate with the page, NUMA and prefault
+         * settings of @p config, publishes 1080p frames through it with an
+         * in-process reader and ranks the backends by median write plus read
+         * time. Whether huge pages are reserved, /dev/shm is a tmpfs with
+         * huge=, or the node is remote shows in what each backend gets. Takes
+         * a few tens of milliseconds; the probe rings are removed again.
+         *
+         * @param config Settings to benchmark with; name, type, size and create are overridden
+         * @param candidates Backends to try, in order of preference on a tie
+         * @param results Optional output receiving one entry per candidate
+         * @return Fastest available backend, the first candidate if none is
+         */
+        static SharedMemoryType selectFastestType(const Config &config,
+                                                  const std::vector<SharedMemoryType> &candidates,
+                                                  std::vector<BackendBenchmark> *results = nullptr);
+
+        /**
+         * @brief Check whether this writer took the region over from a previous one
+         * @return true if an existing region was adopted
+         */
+        bool wasAdopted() const;
+
+        /**
+         * @brief Get the size of the payload arena
+         * @return Arena size in bytes
+         */
+        size_t getArenaSize() const;
+
+        /**
+         * @brief Set how much of the payload arena the writer uses (server only)
+         *
+         * The region, its layout and the arena size readers see stay the
+         * same; the writer just wraps around early. Growing faults the new
+         * pages in and locks them if lockMemory() was called, before the
+         * writer may use them. Shrinking takes effect for the next payload,
+         * and the pages past the new end are given back (MADV_REMOVE, or
+         * MADV_DONTNEED where the backing has no hole punching) as soon as no
+         * payload, capture lease or pinned frame uses them; call again later
+         * to release what was still in use. The size is rounded up to whole
+         * pages and kept between one payload of the maximum frame size and
+         * the arena size.
+         *
+         * @param bytes Arena bytes to use
+         * @return NOT_SUPPORTED on a client
+         */
+        Status resizeArena(size_t bytes);
+
+        /**
+         * @brief Get how much of the payload arena the writer uses
+         * @return Arena bytes in use, the arena size unless resizeArena() was called
+         */
+        size_t getArenaLimit() const;
+
+        /**
+         * @brief Get how much of the payload arena may hold pages
+         *
+         * More than getArenaLimit() while pages of a shrunk arena wait to be released.
+         *
+         * @return Arena bytes not released
+         */
+        size_t getCommittedArenaBytes() const;
+
+        /**
+         * @brief Get the frame geometry the producer currently publishes
+         *
+         * Mode changes do not change the layout of the region, so readers keep
+         * their mapping and pick the new geometry up from here or from the
+         * header of the first frame flagged FRAME_FLAG_GEOMETRY_CHANGED.
+         *
+         * @return Current geometry, epoch 0 before the first frame
+         */
+        Geometry getGeometry() const;
+
         /**
          * @brief Update the maximum frame size to handle larger frame formats
+         *
+         * Only the per-frame limit changes; payloads already in the arena stay valid.
+         *
          * @param newMaxFrameSize New maximum frame size in bytes
-         * @return Status code indicating success or failure
+         * @return INVALID_SIZE if the frame would not fit the arena
          */
         Status updateMaxFrameSize(size_t newMaxFrameSize);
 
@@ -275,6 +959,168 @@ namespace medical::imaging {
          */
         bool isBufferEmpty() const;
 
+        /**
+         * @brief Get the registered consumers of this region
+         * @return One entry per active reader slot
+         */
+        std::vector<ReaderInfo> getReaders() const;
+
+        /**
+         * @brief Get the registration of this instance, e.g. for the lag of a stage reading the ring
+         * @param info Filled with the state of the reader slot this instance owns
+         * @return true if this instance is a registered reader
+         */
+        bool getOwnReader(ReaderInfo &info) const;
+
+        /**
+         * @brief Get the number of registered consumers without building their descriptions
+         *
+         * Cheap enough to call for every frame, e.g. to skip publishing
+         * while nobody reads the region.
+         *
+         * @return Active reader slots
+         */
+        size_t getReaderCount() const;
+
+        /**
+         * @brief Make the waits of this instance for a frame return at once
+         *
+         * Lets a thread blocked in readNextFrame() or a sibling with a long
+         * timeout notice a stop request without polling: the call in progress
+         * and every later one return TIMEOUT instead of sleeping until
+         * resumeWaits().
+         */
+        void interruptWaits();
+
+        /**
+         * @brief Let the waits of this instance sleep again after interruptWaits()
+         */
+        void resumeWaits();
+
+        /**
+         * @brief Get the latency statistics of the registered consumers (server only)
+         *
+         * The writer samples every reader slot after each frame it publishes:
+         * the capture-to-acquire latency of the frame a reader consumed last,
+         * how long its released views were held, and its lag.
+         *
+         * @return One entry per reader slot sampled since its consumer registered
+         */
+        std::vector<ReaderLatency> getReaderLatency() const;
+
+        /**
+         * @brief Get the start of this instance's mapping of the region
+         *
+         * For registering the whole region with other APIs such as
+         * cudaHostRegister(); the layout is described in protocol.md.
+         *
+         * @return Mapping address, nullptr if not initialized
+         */
+        void *getMappingAddress() const;
+
+        /**
+         * @brief Get the size of this instance's mapping of the region
+         * @return Mapping size in bytes, 0 if not initialized
+         */
+        size_t getMappingSize() const;
+
+        /**
+         * @brief Get the layout of the region, for consumers attaching by descriptor
+         * @return Layout, all zero if not initialized
+         */
+        Layout getLayout() const;
+
+        /**
+         * @brief Get the descriptor backing the region
+         *
+         * Passed to consumers over the control socket; the instance keeps
+         * ownership and closes it on cleanup.
+         *
+         * @return File descriptor, -1 if not initialized or System V memory
+         */
+        int getFileDescriptor() const;
+
+        /**
+         * @brief Get the reader table slot owned by this instance
+         * @return Slot index, or -1 if this instance is not a registered reader
+         */
+        int getReaderSlot() const;
+
+        /**
+         * @brief Change the frames this reader is woken for and reads (clients only)
+         *
+         * Takes effect with the next frame published. Frames the filter
+         * rejects are passed over without a wakeup; lossless readers do not
+         * hold the writer back over them.
+         *
+         * @param filter Frames to pass; a default filter passes every frame
+         * @return OK, or NOT_INITIALIZED if this instance is not a registered reader
+         */
+        Status setReaderFilter(const ReaderFilter &filter);
+
+        /**
+         * @brief Signal an eventfd for a reader whenever a frame is published while it is armed (server only)
+         *
+         * The futex doorbells cannot be polled, so consumers running an
+         * event loop get an eventfd from the control socket instead. The
+         * writer only writes to it after the reader armed it in its slot,
+         * one write per wait, and drops it once the slot changes owner.
+         *
+         * @param slot Reader slot to notify
+         * @param pid Process that must own the slot
+         * @param descriptor eventfd to signal; the instance takes ownership
+         * @return OK, INVALID_SIZE if the slot is not an active reader of pid, or NOT_INITIALIZED
+         */
+        Status addReaderNotification(size_t slot, pid_t pid, int descriptor);
+
+        /**
+         * @brief Wait for frames on a descriptor the writer signals instead of the futex doorbell (clients only)
+         *
+         * For poll(), epoll or an async runtime. Call armNotification()
+         * before every wait on the descriptor.
+         *
+         * @param descriptor eventfd received from the writer; the instance takes ownership
+         * @return OK, or NOT_INITIALIZED if this instance is not a registered reader
+         */
+        Status setNotificationDescriptor(int descriptor);
+
+        /**
+         * @brief Get the descriptor that becomes readable when frames arrive
+         * @return eventfd set with setNotificationDescriptor(), -1 if none
+         */
+        int getNotificationDescriptor() const;
+
+        /**
+         * @brief Clear the notification descriptor and ask the writer to signal it with the next frame
+         * @return true if a frame can be read already, so the caller should read instead of waiting
+         */
+        bool armNotification();
+
+        /**
+         * @brief Serialize frame metadata into its fixed binary record
+         * @param metadata Frame metadata
+         * @param record Record to fill
+         */
+        static void packMetadataRecord(const FrameMetadata &metadata, FrameMetadataRecord &record);
+
+        /**
+         * @brief Restore frame metadata from its fixed binary record
+         * @param record Record read from a slot or recording
+         * @param metadata Metadata to fill
+         */
+        static void unpackMetadataRecord(const FrameMetadataRecord &record, FrameMetadata &metadata);
+
+        /**
+         * @brief Store image statistics in a metadata record
+         *
+         * Sets FRAME_FLAG_STATISTICS and the statistics fields, and fills
+         * signalToNoiseRatio and signalStrength (the mean luminance).
+         *
+         * @param statistics Statistics of the frame's payload
+         * @param record Record to fill
+         */
+        static void packImageStatistics(const ImageStatistics &statistics, FrameMetadataRecord &record);
+
         /**
          * @brief Update the shared memory metadata
          * @param key Metadata key
@@ -291,21 +1137,101 @@ namespace medical::imaging {
         std::string getMetadata(const std::string& key) const;
 
     private:
-        // Control block structure - stored at the beginning of shared memory
-        struct alignas(64) ControlBlock {
-            std::atomic<uint64_t> writeIndex;      // Current write position
-            std::atomic<uint64_t> readIndex;       // Current read position
-            std::atomic<uint64_t> frameCount;      // Number of frames in the buffer
-            std::atomic<uint64_t> totalFramesWritten; // Total number of frames written
-            std::atomic<uint64_t> totalFramesRead; // Total number of frames read
-            std::atomic<uint64_t> droppedFrames;   // Frames dropped due to buffer full
-            std::atomic<bool> active;              // Whether the shared memory is active
-            std::atomic<uint64_t> lastWriteTime;   // Timestamp of last write (ns since epoch)
-            std::atomic<uint64_t> lastReadTime;    // Timestamp of last read (ns since epoch)
+        // Control block structure - stored at the beginning of shared memory. Version 2 puts the static
+        // layout, the fields the writer updates on every frame, the writer statistics, the fields readers
+        // signal the writer through and the reader statistics on a 128-byte line each (the adjacent-line
+        // prefetcher moves 64-byte lines in pairs), so no reader store invalidates a line the writer
+        // owns and the writer never dirties the line readers signal on.
+        struct alignas(128) ControlBlock {
+            // Static layout, written while the region is formatted or adopted
+            uint32_t magic;                        // CONTROL_BLOCK_MAGIC once laid out
+            uint32_t version;                      // Control block layout version, checked by readers first
             uint32_t metadataOffset;               // Offset to metadata area
             uint32_t metadataSize;                 // Size of metadata area
+            uint32_t readerTableOffset;            // Offset to the reader registration table
+            uint32_t readerTableSize;              // Number of slots in the reader registration table
+            std::atomic<uint32_t> active;          // Non-zero once the region is laid out
             std::atomic<uint32_t> flags;           // Additional flags
-            uint8_t padding[184];                  // Padding to ensure proper alignment (full cache line)
+            uint64_t layoutHash;                   // Hash of the layout, checked before a writer adopts the region
+            std::atomic<uint32_t> writerEpoch;     // Number of times a restarted writer adopted the region
+            std::atomic<uint32_t> geometryEpoch;   // Seqlock over the geometry fields: odd while changing, +2 per change
+            uint64_t legacyActive;                 // Where 1.x readers wait for the region to be ready; always 0
+            uint64_t timeIndexOffset;              // Offset of the timestamp index, 0 if the writer keeps none
+            std::atomic<uint64_t> committedEnd;    // End of the part of the region that may hold pages, 0 for all of it
+            uint32_t legacyMetadataOffset;         // metadataOffset where 1.x readers look for the JSON metadata
+            uint32_t legacyMetadataSize;           // metadataSize where 1.x readers look for it
+            uint32_t geometryWidth;                // Width of the frames of the current epoch
+            uint32_t geometryHeight;               // Height of the frames of the current epoch
+            uint32_t geometryBytesPerPixel;        // Bytes per pixel of the frames of the current epoch
+            uint32_t geometryFormat;               // Format code of the frames of the current epoch
+            uint8_t reserved0[32];                 // Unused, zero
+
+            // Written by the writer on every frame, polled by readers
+            alignas(128) std::atomic<uint64_t> writeIndex; // Next sequence number to publish
+            std::atomic<uint64_t> oldestIndex;     // Oldest sequence number whose payload is still in the arena
+            std::atomic<uint32_t> frameDoorbell;   // Futex word bumped after every published frame
+            std::atomic<uint32_t> spaceWaiters;    // Writers currently sleeping on spaceDoorbell
+            std::atomic<uint64_t> partialIndex;    // Sequence number + 1 of the last frame published in bands, 0 if none
+            std::atomic<uint32_t> bandDoorbell;    // Futex word bumped after every band and every published frame
+            uint8_t reserved1[92];                 // Unused, zero
+
+            // Writer statistics, updated after every frame and only read for reporting
+            alignas(128) std::atomic<uint64_t> totalFramesWritten; // Total number of frames written
+            std::atomic<uint64_t> droppedFrames;   // Frames dropped due to buffer full
+            std::atomic<uint64_t> lastWriteTime;   // Timestamp of last write (ns since epoch)
+            std::atomic<uint64_t> bufferFullCount; // Writes refused because the ring was full
+            std::atomic<uint64_t> writeLatencyNsTotal; // Sum of the write latencies of all written frames
+            std::atomic<uint64_t> maxWriteLatencyNs; // Largest write latency observed
+            std::atomic<uint64_t> bytesWritten;    // Payload bytes of all written frames
+            std::atomic<uint64_t> peakMemoryUsage; // Largest number of bytes held by queued frames
+            uint8_t reserved2[64];                 // Unused, zero
+
+            // Written by readers to signal the writer
+            alignas(128) std::atomic<uint32_t> frameWaiters; // Readers currently sleeping on frameDoorbell
+            std::atomic<uint32_t> spaceDoorbell;   // Futex word bumped whenever a reader frees a slot
+            std::atomic<uint32_t> bandWaiters;     // Readers currently sleeping on bandDoorbell
+            uint8_t reserved3[116];                // Unused, zero
+
+            // Reader statistics, never touched by the writer while frames flow
+            alignas(128) std::atomic<uint64_t> readIndex; // Oldest frame a lossless reader still needs (informational)
+            std::atomic<uint64_t> totalFramesRead; // Total number of frames read
+            std::atomic<uint64_t> lastReadTime;    // Timestamp of last read (ns since epoch)
+            uint8_t reserved4[104];                // Unused, zero
+        };
+
+        // Timestamp index entry, one per ring position after the header table: four per cache line, so
+        // a lookup by time binary-searches the ring without touching the headers
+        struct TimeIndexEntry {
+            std::atomic<uint64_t> sequence;        // Sequence number + 1 of the frame indexed, 0 while rewritten
+            uint64_t timeNs;                       // captureTimeNs of the frame, its publish time if unknown
+        };
+
+        // Reader registration slot - two cache lines per consumer so cursors never false-share,
+        // not even through the adjacent-line prefetcher
+        struct alignas(128) ReaderSlot {
+            std::atomic<uint32_t> state;           // FREE, CLAIMED or ACTIVE
+            std::atomic<uint32_t> pid;             // Process owning the slot
+            std::atomic<uint16_t> mode;            // ReaderMode of the consumer
+            std::atomic<uint16_t> requestedFormat; // Format code the consumer wants converted frames in, 0 for none
+            std::atomic<uint32_t> holdTimeUs;      // Acquire to release of the last released view (us), 0 once sampled
+            std::atomic<uint64_t> cursor;          // Next sequence number to consume
+            std::atomic<uint64_t> framesRead;      // Frames consumed through this slot
+            std::atomic<uint64_t> framesSkipped;   // Frames lost because the writer lapped a lossy reader
+            std::atomic<uint64_t> lastReadTime;    // Timestamp of last read (ns since epoch)
+            std::atomic<uint64_t> lastSequence;    // Sequence number of the last frame consumed
+            std::atomic<uint64_t> acquireTimeNs;   // When it was acquired, on CLOCK_MONOTONIC (0 before the first read)
+            std::atomic<uint64_t> heartbeatNs;     // Last read of the consumer, on CLOCK_MONOTONIC
+            std::atomic<uint32_t> demotion;        // DemotionReason the writer set when it demoted the consumer
+            std::atomic<uint32_t> notifyArmed;     // Nonzero while the consumer waits on its notification descriptor
+            std::atomic<uint32_t> filterStride;    // ReaderFilter::stride, 0 or 1 for every frame
+            std::atomic<uint32_t> filterIntervalUs; // Shortest capture time between frames passed (us), 0 for no limit
+            std::atomic<uint32_t> filterRequiredFlags; // FRAME_FLAG_* bits a frame must have
+            std::atomic<uint32_t> filterExcludedFlags; // FRAME_FLAG_* bits a frame must not have
+            std::atomic<uint32_t> doorbell;        // Rung by the writer for frames the filter passes
+            std::atomic<uint32_t> doorbellWaiters; // Consumers sleeping on doorbell
+            std::atomic<uint64_t> framesFiltered;  // Frames passed over because the filter rejected them
+            std::atomic<uint64_t> claimTimeNs;     // When the slot was claimed, on CLOCK_MONOTONIC (0 while free)
+            uint8_t reserved[8];                   // Unused, zero
         };
 
         // Private implementation to hide platform-specific details
@@ -315,6 +1241,9 @@ namespace medical::imaging {
         // Configuration
         Config config_;
 
+        // Payload copy kernel of the writer (server only)
+        std::unique_ptr<FrameCopier> copier_;
+
         // Initialization state
         std::atomic<bool> isInitialized_;
 
@@ -324,9 +1253,13 @@ namespace medical::imaging {
         std::atomic<bool> stopCallbackThread_;
         std::mutex callbackMutex_;
 
-        // Statistics
-        mutable std::mutex statsMutex_;
-        Statistics stats_{};
+        // Read statistics of this process; the writer's live in the control block
+        struct alignas(64) ReadCounters {
+            std::atomic<uint64_t> framesRead{0};      // Frames read through this instance
+            std::atomic<uint64_t> latencyNsTotal{0};  // Sum of the read latencies
+            std::atomic<uint64_t> maxLatencyNs{0};    // Largest read latency observed
+        };
+        ReadCounters readCounters_;
 
         // Thread management
         int threadAffinity_;
@@ -344,14 +1277,31 @@ namespace medical::imaging {
         // Helper method to read JSON metadata from the shared memory
         std::string readMetadataJson() const;
 
-        // Helper method to convert frame to format code
-        static uint32_t getFormatCode(const std::string& format);
-
-        // Helper method to convert format code to string
-        static std::string getFormatString(uint32_t formatCode);
-
         // Helper method to get current time in nanoseconds
         static uint64_t getCurrentTimeNanos();
+
+        // Helper method to get the CLOCK_MONOTONIC time in nanoseconds
+        static uint64_t getMonotonicTimeNanos();
+
+        // Helper method to count frames read and their latency
+        void recordRead(uint64_t count, uint64_t latencyNs);
+
+        // Helper method to build a zero-copy frame for a slot, validating its generation
+        Status mapSlotFrame(uint64_t index, std::shared_ptr<Frame> &frame);
+
+        // Helper method to fill a view of a slot, validating its generation; a partial view may be of a
+        // slot still being published in bands
+        Status mapSlotView(uint64_t index, FrameView &view, bool partial = false);
+
+        // Helper method to map up to maxCount consecutive slots and commit the cursor once
+        Status readBatch(size_t maxCount, unsigned int waitMilliseconds, size_t &count,
+                         const std::function<Status(uint64_t index, size_t position)> &mapSlot);
+
+        // Number of times a read is retried after losing a race with the writer
+        static constexpr int MAX_READ_ATTEMPTS = 3;
+
+        // Frames pinFrames() maps per hold of the writer's arena lock
+        static constexpr size_t PIN_BATCH = 32;
     };
 
     // Helper class to manage multiple shared memory regions
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @brief Magic bytes at the start of every compressed payload
+     */
+    constexpr char COMPRESSED_FRAME_MAGIC[4] = {'M', 'V', 'Z', '1'};
+
+    /**
+     * @brief Compressed payload is the difference to the frame named by referenceFrameId
+     */
+    constexpr uint8_t COMPRESSED_FLAG_DELTA = 0x01;
+
+    /**
+     * @brief Header in front of every payload published to a compressed ring
+     *
+     * The ring's FrameHeader keeps the width, height and format of the raw
+     * frame; its dataSize is the size of this header plus the body.
+     */
+    struct alignas(8) CompressedFrameHeader {
+        char magic[4];             // COMPRESSED_FRAME_MAGIC
+        uint8_t codec;             // FrameCodec::Codec the body is encoded with
+        uint8_t flags;             // COMPRESSED_FLAG_* bits
+        uint16_t headerSize;       // sizeof(CompressedFrameHeader), the body starts here
+        uint32_t rawSize;          // Size of the decoded payload in bytes
+        uint32_t bodySize;         // Size of the encoded body in bytes
+        uint64_t frameId;          // Frame this payload encodes
+        uint64_t referenceFrameId; // Frame a delta applies to (0 for key frames)
+    };
+
+    static_assert(sizeof(CompressedFrameHeader) == 32, "CompressedFrameHeader size is part of the wire protocol");
+
+    /**
+     * @class FrameCodec
+     * @brief Fast lossless frame compression with optional inter-frame deltas
+     *
+     * Ultrasound images change slowly and sit on a black background, so the
+     * byte-wise difference to the previous frame is mostly zeros. The
+     * built-in ZERO_RUN codec stores runs of zero bytes as lengths and copies
+     * everything else; LZ4 is available when the library was found at build
+     * time. Every keyFrameInterval-th frame, and the first frame after a size
+     * change or reset(), is a key frame that decodes on its own, so a consumer
+     * joining late or losing a frame resynchronizes within that interval.
+     *
+     * The same class decodes: a decoder keeps the last frame it produced as
+     * the reference for the next delta. One instance must not be used from
+     * several threads at once.
+     */
+    class FrameCodec {
+    public:
+        /**
+         * @brief Body encodings
+         */
+        enum class Codec : uint8_t {
+            STORED = 0,   // Body is the raw payload, used when nothing else makes it smaller
+            ZERO_RUN = 1, // Alternating zero-run and literal lengths (LEB128) followed by the literals
+            LZ4 = 2       // LZ4 block format
+        };
+
+        /**
+         * @brief Status codes for decoding
+         */
+        enum class Status {
+            OK,                // Payload decoded
+            INVALID_DATA,      // Not a compressed payload, or a corrupt body
+            OUTPUT_TOO_SMALL,  // Output buffer smaller than the decoded payload
+            MISSING_REFERENCE, // Delta against a frame this decoder has not decoded; wait for a key frame
+            NOT_SUPPORTED      // Codec not compiled into this build
+        };
+
+        /**
+         * @brief Constructor
+         * @param codec Codec new payloads are encoded with
+         * @param useDelta Encode the difference to the previous frame
+         * @param keyFrameInterval Frames between key frames (0 or 1 for key frames only)
+         */
+        FrameCodec(Codec codec = Codec::ZERO_RUN, bool useDelta = true, uint32_t keyFrameInterval = 60);
+
+        /**
+         * @brief Get the codec new payloads are encoded with
+         * @return Codec
+         */
+        Codec getCodec() const;
+
+        /**
+         * @brief Check whether a codec is compiled into this build
+         * @param codec Codec to check
+         * @return true if payloads can be encoded and decoded with @p codec
+         */
+        static bool isAvailable(Codec codec);
+
+        /**
+         * @brief Get the name of a codec
+         * @param codec Codec
+         * @return "stored", "zero-run" or "lz4"
+         */
+        static const char *toString(Codec codec);
+
+        /**
+         * @brief Parse a codec name
+         * @param name "zero-run" or "lz4"
+         * @param codec Output codec
+         * @return false if the name is not recognized
+         */
+        static bool fromString(std::string_view name, Codec &codec);
+
+        /**
+         * @brief Get the largest payload encode() can produce
+         * @param rawSize Size of the raw payload in bytes
+         * @return Header plus worst-case body size
+         */
+        static size_t maxEncodedSize(size_t rawSize);
+
+        /**
+         * @brief Compress a payload
+         * @param data Raw payload
+         * @param size Size of @p data in bytes
+         * @param frameId Frame ID recorded in the header, and the reference for the next delta
+         * @param output Destination buffer
+         * @param capacity Size of @p output; maxEncodedSize(size) always suffices
+         * @return Bytes written, 0 if @p output is too small
+         */
+        size_t encode(const void *data, size_t size, uint64_t frameId, void *output, size_t capacity);
+
+        /**
+         * @brief Decompress a payload
+         * @param input Compressed payload starting with a CompressedFrameHeader
+         * @param size Size of @p input in bytes
+         * @param output Destination buffer
+         * @param capacity Size of @p output in bytes
+         * @return Status code indicating success or failure
+         */
+        Status decode(const void *input, size_t size, void *output, size_t capacity);
+
+        /**
+         * @brief Drop the reference, so the next encoded payload is a key frame
+         */
+        void reset();
+
+        /**
+         * @brief Check whether a payload is a key frame
+         * @param input Compressed payload
+         * @param size Size of @p input in bytes
+         * @return true if the payload decodes without a reference
+         */
+        static bool isKeyFrame(const void *input, size_t size);
+
+        /**
+         * @brief Get the instruction set the delta kernels were dispatched to
+         * @return "avx2", "neon" or "scalar"
+         */
+        static const char *getKernelName();
+
+    private:
+        Codec codec_;
+        bool useDelta_;
+        uint32_t keyFrameInterval_;
+        uint32_t framesSinceKeyFrame_;
+        bool hasReference_;
+        uint64_t referenceFrameId_;
+        std::vector<uint8_t> reference_; // Last frame encoded or decoded
+        std::vector<uint8_t> scratch_;   // Delta being encoded or decoded
+    };
+} // namespace medical::imaging
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "communication/shared_memory.h"
+#include "compression/frame_codec.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @class FrameCompressor
+     * @brief Compresses the frames of one ring into another for network-bound consumers
+     *
+     * Attaches to the source ring as a lossy reader and compresses on its own
+     * thread, so capture never waits for it: when it falls behind it skips
+     * frames like any other lossy consumer. Every payload published to the
+     * output ring starts with a CompressedFrameHeader; the ring's FrameHeader
+     * keeps the frame ID, timestamps, geometry and metadata of the raw frame.
+     *
+     * A frame that the writer overwrites while it is being compressed, or
+     * that the output ring cannot accept, is left out and the next frame is
+     * encoded as a key frame, so consumers never see a delta against a
+     * frame they could not have decoded.
+     */
+    class FrameCompressor {
+    public:
+        /**
+         * @brief Status codes for compressor operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Compressor already running
+            NOT_RUNNING,       // Compressor not running
+            CONNECTION_FAILED, // Could not attach to the source ring
+            INVALID_ARGUMENT   // Invalid argument provided
+        };
+
+        /**
+         * @brief Compressor configuration
+         */
+        struct Config {
+            FrameCodec::Codec codec;   // Body encoding
+            bool useDelta;             // Encode differences to the previous frame
+            uint32_t keyFrameInterval; // Frames between key frames
+            int cpuCore;               // CPU core for the compressor thread (-1 for no affinity)
+            std::string threadRole;    // Role the thread is placed under by the ThreadLayout
+
+            // Constructor with default values
+            Config() : codec(FrameCodec::Codec::ZERO_RUN),
+                       useDelta(true),
+                       keyFrameInterval(60),
+                       cpuCore(-1),
+                       threadRole("compress") {
+            }
+        };
+
+        /**
+         * @brief Compressor statistics
+         */
+        struct Statistics {
+            uint64_t framesCompressed; // Frames published to the output ring
+            uint64_t keyFrames;        // Of those, frames that decode on their own
+            uint64_t bytesIn;          // Raw bytes of the published frames
+            uint64_t bytesOut;         // Compressed bytes published, headers included
+            uint64_t framesTorn;       // Frames the writer overwrote while they were being compressed
+            uint64_t framesDropped;    // Frames the output ring could not accept
+            uint64_t framesSkipped;    // Frames lost because the writer lapped the compressor
+            uint64_t lagFrames;        // Frames published but not yet picked up by the compressor
+            double compressionRatio;   // bytesIn / bytesOut, 0 before the first frame
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Compressor configuration
+         */
+        explicit FrameCompressor(const Config &config);
+
+        /**
+         * @brief Destructor, stops compressing
+         */
+        ~FrameCompressor();
+
+        FrameCompressor(const FrameCompressor &) = delete;
+        FrameCompressor &operator=(const FrameCompressor &) = delete;
+
+        /**
+         * @brief Attach to a ring and start compressing into another
+         * @param sourceConfig Configuration of the ring to compress; create and readerMode are overridden
+         * @param output Ring the compressed frames are published to (server side)
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &sourceConfig, const std::shared_ptr<SharedMemory> &output);
+
+        /**
+         * @brief Stop compressing and detach from the source ring
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the compressor is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the codec configuration
+         * @return Compressor configuration
+         */
+        const Config &getConfig() const;
+
+        /**
+         * @brief Get compressor statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get compressor statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+        /**
+         * @brief Get the histogram of time spent compressing and publishing a frame
+         * @return Histogram of compression times in nanoseconds
+         */
+        const LatencyHistogram &getCompressionTimeHistogram() const;
+
+    private:
+        void compressorThread();
+
+        Config config_;
+        std::shared_ptr<SharedMemory> source_;
+        std::shared_ptr<SharedMemory> output_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+
+        // Updated by the compressor thread, read by anyone
+        std::atomic<uint64_t> framesCompressed_;
+        std::atomic<uint64_t> keyFrames_;
+        std::atomic<uint64_t> bytesIn_;
+        std::atomic<uint64_t> bytesOut_;
+        std::atomic<uint64_t> framesTorn_;
+        std::atomic<uint64_t> framesDropped_;
+        LatencyHistogram compressionTimeHistogram_;
+    };
+} // namespace medical::imaging
@@ -6,12 +6,11 @@
 #include <functional>
 #include <atomic>
 #include <mutex>
-#include <deque>
 #include <chrono>
 #include <map>
 #include <unordered_map>
 
-#include "frame/frame.h"
+#include "device/capture_device.h"
 
 // Forward declarations for Blackmagic SDK classes
 class IDeckLink;
@@ -26,20 +25,7 @@ class IDeckLinkStatus;
 namespace medical {
 namespace imaging {
 
-/**
- * @enum DeviceFeature
- * @brief Features that may be supported by the Blackmagic device
- */
-enum class DeviceFeature {
-    DIRECT_MEMORY_ACCESS,     // Direct memory access (DMA)
-    GPU_DIRECT,               // Direct to GPU memory
-    HARDWARE_TIMESTAMP,       // Hardware-based timestamping
-    EXTERNAL_SYNC,            // External synchronization
-    FRAME_METADATA,           // Rich frame metadata
-    MULTIPLE_STREAMS,         // Multiple simultaneous streams
-    PROGRAMMABLE_ROI,         // Programmable region of interest
-    HARDWARE_COMPRESSION      // Hardware-based compression
-};
+class SharedMemory;
 
 /**
  * @class BlackmagicDevice
@@ -49,82 +35,8 @@ enum class DeviceFeature {
  * Blackmagic capture devices, with performance optimizations and
  * zero-copy support where possible.
  */
-class BlackmagicDevice {
+class BlackmagicDevice : public CaptureDevice {
 public:
-    /**
-     * @brief Status codes for device operations
-     */
-    enum class Status {
-        OK,                     // Operation completed successfully
-        DEVICE_NOT_FOUND,       // Device not found or not connected
-        INIT_FAILED,            // Failed to initialize device
-        ALREADY_STREAMING,      // Device is already streaming
-        NOT_STREAMING,          // Device is not currently streaming
-        CONFIGURATION_ERROR,    // Invalid configuration
-        FEATURE_NOT_SUPPORTED,  // Requested feature not supported
-        PERMISSION_DENIED,      // Permission denied (e.g., access to device)
-        TIMEOUT,                // Operation timed out
-        IO_ERROR,               // I/O error
-        INTERNAL_ERROR,         // Unspecified internal error
-        INVALID_ARGUMENT        // Invalid argument provided
-    };
-
-    /**
-     * @brief Configuration for device initialization with zero-copy options
-     */
-    struct Config {
-        int width;                      // Desired capture width
-        int height;                     // Desired capture height
-        double frameRate;               // Desired frame rate
-        std::string pixelFormat;        // Desired pixel format
-        bool enableAudio;               // Whether to capture audio as well
-        bool enableDirectMemoryAccess;  // Enable DMA if supported
-        bool enableGpuDirect;           // Enable direct GPU transfer if supported
-        BufferType preferredBufferType; // Preferred buffer type
-        std::string sharedMemoryName;   // Shared memory region for direct output
-        size_t bufferCount;             // Number of buffers to allocate
-        bool enableHardwareTimestamps;  // Use hardware timestamps if available
-
-        // External memory allocation callback
-        std::function<void*(size_t size)> externalAllocCallback;
-
-        // External memory free callback
-        std::function<void(void*)> externalFreeCallback;
-
-        // Constructor with default values
-        Config() :
-            width(1920),
-            height(1080),
-            frameRate(60.0),
-            pixelFormat("YUV"),
-            enableAudio(false),
-            enableDirectMemoryAccess(false),
-            enableGpuDirect(false),
-            preferredBufferType(BufferType::CPU_MEMORY),
-            sharedMemoryName(""),
-            bufferCount(3),
-            enableHardwareTimestamps(false),
-            externalAllocCallback(nullptr),
-            externalFreeCallback(nullptr) {}
-    };
-
-    /**
-     * @brief Device capabilities
-     */
-    struct Capabilities {
-        bool supportsDma;                   // Device supports DMA
-        bool supportsGpuDirect;             // Device supports direct-to-GPU transfer
-        bool supportsHardwareTimestamps;    // Device supports hardware timestamping
-        bool supportsExternalTrigger;       // Device supports external triggering
-        bool supportsMultipleStreams;       // Device supports multiple streams
-        bool supportsProgrammableRoi;       // Device supports programmable ROI
-        std::vector<std::string> supportedPixelFormats; // Supported pixel formats
-        std::vector<DeviceFeature> supportedFeatures;   // Other supported features
-
-        // Device-specific information
-        std::unordered_map<std::string, std::string> deviceInfo;
-    };
-
     /**
      * @brief Constructor
      * @param deckLink Pointer to the DeckLink device
@@ -134,76 +46,76 @@ public:
     /**
      * @brief Destructor
      */
-    ~BlackmagicDevice();
+    ~BlackmagicDevice() override;
 
     /**
      * @brief Get the device ID
      * @return Device ID string
      */
-    std::string getDeviceId() const;
+    std::string getDeviceId() const override;
 
     /**
      * @brief Get the device name
      * @return Human-readable device name
      */
-    std::string getDeviceName() const;
+    std::string getDeviceName() const override;
 
     /**
      * @brief Get the device model
      * @return Device model information
      */
-    std::string getDeviceModel() const;
+    std::string getDeviceModel() const override;
 
     /**
      * @brief Initialize the device with specific configuration
      * @param config Configuration parameters
      * @return Status code indicating success or failure
      */
-    Status initialize(const Config &config);
+    Status initialize(const Config &config) override;
 
     /**
      * @brief Start capturing frames
      * @param frameCallback Callback function that receives captured frames
      * @return Status code indicating success or failure
      */
-    Status startCapture(std::function<void(std::shared_ptr<Frame>)> frameCallback);
+    Status startCapture(std::function<void(std::shared_ptr<Frame>)> frameCallback) override;
 
     /**
      * @brief Stop capturing frames
      * @return Status code indicating success or failure
      */
-    Status stopCapture();
+    Status stopCapture() override;
 
     /**
      * @brief Check if the device is currently capturing
      * @return true if capturing, false otherwise
      */
-    bool isCapturing() const;
+    bool isCapturing() const override;
 
     /**
      * @brief Get supported configurations for this device
      * @return Vector of supported configurations
      */
-    std::vector<Config> getSupportedConfigurations() const;
+    std::vector<Config> getSupportedConfigurations() const override;
 
     /**
      * @brief Get the current configuration
      * @return Current active configuration
      */
-    Config getCurrentConfiguration() const;
+    Config getCurrentConfiguration() const override;
 
     /**
      * @brief Get device capabilities
      * @return Structure describing device capabilities
      */
-    Capabilities getCapabilities() const;
+    Capabilities getCapabilities() const override;
 
     /**
      * @brief Check if a specific feature is supported
      * @param feature Feature to check
      * @return true if the feature is supported
      */
-    bool supportsFeature(DeviceFeature feature) const;
+    bool supportsFeature(DeviceFeature feature) const override;
 
     /**
      * @brief Configure external memory for zero-copy operations
@@ -220,28 +132,93 @@ public:
      */
     Status setDirectOutputToSharedMemory(const std::string& sharedMemoryName);
 
+    /**
+     * @brief Capture straight into the payload arena of a shared memory ring
+     *
+     * Takes effect on the next initialize(): the SDK is given a buffer allocator
+     * backed by the region's capture buffers, so frames are DMA'd into shared
+     * memory and SharedMemory::writeFrame() publishes them without a copy.
+     * The region must have been created with SharedMemory::Config::captureBuffers > 0.
+     *
+     * @param sharedMemory Producer side of the ring, nullptr to capture into SDK memory
+     * @return Status code indicating success or failure
+     */
+    Status setDirectOutputToSharedMemory(std::shared_ptr<SharedMemory> sharedMemory) override;
+
     /**
      * @brief Get the current frame rate
      * @return Current frames per second
      */
-    double getCurrentFrameRate() const;
+    double getCurrentFrameRate() const override;
+
+    /**
+     * @brief Get the histogram of intervals between captured frames
+     * @return Histogram of frame arrival intervals in nanoseconds
+     */
+    const LatencyHistogram& getCaptureIntervalHistogram() const override;
+
+    /**
+     * @brief Get the histogram of time spent turning DeckLink frames into Frame objects
+     * @return Histogram of conversion times in nanoseconds
+     */
+    const LatencyHistogram& getConvertTimeHistogram() const override;
+
+    /**
+     * @brief Get the number of frames dropped by the device
+     * @return Frames the device could not deliver
+     */
+    uint64_t getDroppedFrameCount() const override;
+
+    /**
+     * @brief Get the number of zero-copy buffer acquisitions that found the pool empty
+     * @return Buffer pool exhaustion count
+     */
+    uint64_t getBufferPoolExhaustedCount() const override;
+
+    /**
+     * @brief Get the number of direct shared memory captures that fell back to heap memory
+     * @return Heap fallback count, 0 when capturing into SDK memory
+     */
+    uint64_t getDirectCaptureHeapFallbacks() const override;
+
+    /**
+     * @brief Get the number of SDK frame buffers still referenced by frames
+     * @return Outstanding SDK buffer count
+     */
+    uint64_t getOutstandingBufferCount() const override;
+
+    /**
+     * @brief Get the NUMA node of the card's PCIe root
+     * @return NUMA node, -1 if unknown or on a machine without NUMA
+     */
+    int getNumaNode() const override;
+
+    /**
+     * @brief Check whether the last frame arrived with an input source connected
+     * @return false while the card reports bmdFrameHasNoInputSource
+     */
+    bool hasInputSignal() const override;
 
     /**
      * @brief Get device-specific diagnostics
      * @return Map of diagnostic name to value
      */
-    std::map<std::string, std::string> getDiagnostics() const;
+    std::map<std::string, std::string> getDiagnostics() const override;
 
 private:
     // Inner callback class for DeckLink SDK
     class InputCallback;
     friend class InputCallback;
 
+    // Video buffer allocator provider handing the SDK shared memory capture buffers
+    class SharedMemoryAllocatorProvider;
+
     // Zero-copy buffer management
     struct Buffer {
         void* memory;
         size_t size;
-        bool inUse;
+        // Set by the capture thread, cleared by whichever consumer drops the frame
+        std::atomic<bool> inUse{false};
         std::chrono::steady_clock::time_point lastUsed;
 
         // For external memory tracking
@@ -252,6 +229,14 @@ private:
     // Convert between Blackmagic types and our types
     static uint32_t getBlackmagicPixelFormat(const std::string& format);
     static std::string getPixelFormatString(uint32_t blackmagicFormat);
+    static uint32_t toBlackmagicPixelFormat(PixelFormat format);
+    static PixelFormat fromBlackmagicPixelFormat(uint32_t blackmagicFormat);
+
+    // Estimated capture buffer size for a configured format, 4 bytes per pixel if unknown
+    static size_t estimateFrameBytes(const std::string& format, uint32_t width, uint32_t height);
+
+    // Capture buffer size of the largest mode the input supports, 0 if unknown
+    size_t getLargestFrameBytes() const;
 
     // Enhanced frame conversion with zero-copy support
     std::shared_ptr<Frame> convertFrame(IDeckLinkVideoInputFrame* videoFrame,
@@ -261,6 +246,9 @@ private:
     std::shared_ptr<Frame> convertFrameExternalMemory(IDeckLinkVideoInputFrame* videoFrame,
                                                      IDeckLinkAudioInputPacket* audioPacket);
 
+    // Enable video input, through the shared memory allocator when direct output is configured
+    int enableVideoInput(uint32_t displayMode, uint32_t pixelFormat, uint32_t flags);
+
     // Find a compatible display mode
     bool findMatchingDisplayMode(const Config& config, IDeckLinkDisplayMode** mode);
 
@@ -273,18 +261,36 @@ private:
     // Initialize buffer pool for zero-copy
     bool initializeBufferPool(size_t bufferCount, size_t bufferSize);
 
-    // Allocate a buffer from the pool
+    // Allocate a buffer from the pool (lock-free, safe on the SDK callback thread)
     Buffer* allocateBuffer(size_t size);
 
-    // Release a buffer back to the pool
+    // Release a buffer back to the pool (lock-free, safe from any thread)
     void releaseBuffer(Buffer* buffer);
 
+    // Push a pool index onto the free list
+    void pushFreeBuffer(uint32_t index);
+
+    // Rebuild the free list with every pool buffer; only while no buffer can be acquired
+    void resetBufferFreeList();
+
     // Query device capabilities
     void queryCapabilities();
 
+    // Find the NUMA node of the card from its PCI address
+    int discoverNumaNode();
+
+    // Keep the SDK callback thread on the placement node; called once per capture from the callback
+    void bindCallbackThread();
+
     // Monitor performance metrics
     void updatePerformanceMetrics(IDeckLinkVideoInputFrame* videoFrame);
 
+    // Input slot of a frame from its stream time, -1 if the SDK reports none
+    static int64_t streamSlotOf(IDeckLinkVideoInputFrame* videoFrame);
+
+    // Stamp a frame with its capture time from the hardware reference clock (callback time if unavailable)
+    void setCaptureTimestamps(IDeckLinkVideoInputFrame* videoFrame, Frame& frame);
+
     // Member variables
     IDeckLink* deckLink_;
     IDeckLinkInput* deckLinkInput_;
@@ -301,18 +307,39 @@ private:
     void* externalMemory_;
     size_t externalMemorySize_;
     std::string directSharedMemoryName_;
+    std::shared_ptr<SharedMemory> directSharedMemory_;
+    SharedMemoryAllocatorProvider* allocatorProvider_;
 
-    // Buffer pool for zero-copy operations
+    // Buffer pool for zero-copy operations. Acquire/release go through an index-based
+    // Treiber stack; bufferPoolMutex_ only serializes (re)building the pool itself.
+    static constexpr uint32_t BUFFER_LIST_END = UINT32_MAX;
     std::vector<Buffer> bufferPool_;
+    std::unique_ptr<std::atomic<uint32_t>[]> freeBufferNext_; // Next free index per buffer
+    std::atomic<uint64_t> freeBufferHead_;       // ABA tag in the high 32 bits, index in the low 32 bits
+    std::atomic<uint32_t> bufferPoolEpoch_;      // Bumped whenever the pool is rebuilt
+    std::atomic<size_t> bufferPoolFrameBytes_;   // Size of every buffer in the pool
+    std::atomic<uint64_t> bufferPoolExhausted_;  // Acquisitions that found no free buffer
+    std::atomic<uint64_t> hardwareTimestampFrames_; // Frames timed from the hardware reference clock
+    std::atomic<uint64_t> sdkBuffersOutstanding_;   // SDK buffers wrapped by frames not yet destroyed
+    std::atomic<uint64_t> sdkBuffersOutstandingPeak_;
     std::mutex bufferPoolMutex_;
 
+    // NUMA placement
+    int numaNode_;                          // Node of the card's PCIe root (-1 if unknown)
+    std::atomic<int> placementNode_;        // Node buffers and the callback thread are bound to (-1 for none)
+    std::atomic<int> bufferPoolNode_;       // Node backing the buffer pool (-1 if unknown)
+    std::atomic<bool> callbackThreadBound_; // Whether the callback thread was bound since startCapture()
+    std::atomic<bool> inputSignal_;         // Whether the last frame arrived with an input source
+
     // Performance monitoring
     std::atomic<uint64_t> frameCount_;
-    std::atomic<uint64_t> droppedFrames_;
+    std::atomic<uint64_t> droppedFrames_;   // Input frames the SDK skipped or the callback failed to convert
+    int64_t lastStreamSlot_;                // Input slot of the previous frame, -1 before the first (callback only)
     std::chrono::steady_clock::time_point startTime_;
-    std::chrono::steady_clock::time_point lastFrameTime_;
-    mutable std::mutex metricsMutex_;
-    std::deque<double> fpsHistory_;
+    std::chrono::steady_clock::time_point lastFrameTime_; // Only touched by the capture callback
+    std::atomic<uint64_t> frameIntervalAvgNs_;           // Moving average of the frame interval
+    LatencyHistogram captureIntervalHistogram_;
+    LatencyHistogram convertTimeHistogram_;
 
     // State variables
     std::atomic<bool> isCapturing_;
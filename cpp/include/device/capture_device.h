@@ -0,0 +1,277 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#include "frame/frame.h"
+#include "utils/latency_histogram.h"
+
+namespace medical {
+namespace imaging {
+
+class SharedMemory;
+
+/**
+ * @enum DeviceFeature
+ * @brief Features that may be supported by a capture device
+ */
+enum class DeviceFeature {
+    DIRECT_MEMORY_ACCESS,     // Direct memory access (DMA)
+    GPU_DIRECT,               // Direct to GPU memory
+    HARDWARE_TIMESTAMP,       // Hardware-based timestamping
+    EXTERNAL_SYNC,            // External synchronization
+    FRAME_METADATA,           // Rich frame metadata
+    MULTIPLE_STREAMS,         // Multiple simultaneous streams
+    PROGRAMMABLE_ROI,         // Programmable region of interest
+    HARDWARE_COMPRESSION      // Hardware-based compression
+};
+
+/**
+ * @class CaptureDevice
+ * @brief Interface of a frame source driven by the imaging service
+ *
+ * Implemented by BlackmagicDevice for real capture cards and by
+ * SyntheticDevice for generated or replayed frames, so the rest of the
+ * pipeline can be exercised and load-tested without hardware.
+ */
+class CaptureDevice {
+public:
+    /**
+     * @brief Status codes for device operations
+     */
+    enum class Status {
+        OK,                     // Operation completed successfully
+        DEVICE_NOT_FOUND,       // Device not found or not connected
+        INIT_FAILED,            // Failed to initialize device
+        ALREADY_STREAMING,      // Device is already streaming
+        NOT_STREAMING,          // Device is not currently streaming
+        CONFIGURATION_ERROR,    // Invalid configuration
+        FEATURE_NOT_SUPPORTED,  // Requested feature not supported
+        PERMISSION_DENIED,      // Permission denied (e.g., access to device)
+        TIMEOUT,                // Operation timed out
+        IO_ERROR,               // I/O error
+        INTERNAL_ERROR,         // Unspecified internal error
+        INVALID_ARGUMENT        // Invalid argument provided
+    };
+
+    /**
+     * @brief Configuration for device initialization with zero-copy options
+     */
+    struct Config {
+        int width;                      // Desired capture width
+        int height;                     // Desired capture height
+        double frameRate;               // Desired frame rate
+        std::string pixelFormat;        // Desired pixel format
+        bool enableAudio;               // Whether to capture audio as well
+        bool enableDirectMemoryAccess;  // Enable DMA if supported
+        bool enableGpuDirect;           // Enable direct GPU transfer if supported
+        BufferType preferredBufferType; // Preferred buffer type
+        std::string sharedMemoryName;   // Shared memory region for direct output
+        size_t bufferCount;             // Number of buffers to allocate
+        bool enableHardwareTimestamps;  // Use hardware timestamps if available
+        int numaNode;                   // NUMA node for capture buffers and the capture thread (-1 for the device's own node)
+
+        // External memory allocation callback
+        std::function<void*(size_t size)> externalAllocCallback;
+
+        // External memory free callback
+        std::function<void(void*)> externalFreeCallback;
+
+        // Constructor with default values
+        Config() :
+            width(1920),
+            height(1080),
+            frameRate(60.0),
+            pixelFormat("YUV"),
+            enableAudio(false),
+            enableDirectMemoryAccess(false),
+            enableGpuDirect(false),
+            preferredBufferType(BufferType::CPU_MEMORY),
+            sharedMemoryName(""),
+            bufferCount(3),
+            enableHardwareTimestamps(false),
+            numaNode(-1),
+            externalAllocCallback(nullptr),
+            externalFreeCallback(nullptr) {}
+    };
+
+    /**
+     * @brief Device capabilities
+     */
+    struct Capabilities {
+        bool supportsDma;                   // Device supports DMA
+        bool supportsGpuDirect;             // Device supports direct-to-GPU transfer
+        bool supportsHardwareTimestamps;    // Device supports hardware timestamping
+        bool supportsExternalTrigger;       // Device supports external triggering
+        bool supportsMultipleStreams;       // Device supports multiple streams
+        bool supportsProgrammableRoi;       // Device supports programmable ROI
+        std::vector<std::string> supportedPixelFormats; // Supported pixel formats
+        std::vector<DeviceFeature> supportedFeatures;   // Other supported features
+
+        // Device-specific information
+        std::unordered_map<std::string, std::string> deviceInfo;
+    };
+
+    virtual ~CaptureDevice() = default;
+
+    /**
+     * @brief Get the device ID
+     * @return Device ID string
+     */
+    virtual std::string getDeviceId() const = 0;
+
+    /**
+     * @brief Get the device name
+     * @return Human-readable device name
+     */
+    virtual std::string getDeviceName() const = 0;
+
+    /**
+     * @brief Get the device model
+     * @return Device model information
+     */
+    virtual std::string getDeviceModel() const = 0;
+
+    /**
+     * @brief Initialize the device with specific configuration
+     * @param config Configuration parameters
+     * @return Status code indicating success or failure
+     */
+    virtual Status initialize(const Config &config) = 0;
+
+    /**
+     * @brief Start capturing frames
+     * @param frameCallback Callback function that receives captured frames
+     * @return Status code indicating success or failure
+     */
+    virtual Status startCapture(std::function<void(std::shared_ptr<Frame>)> frameCallback) = 0;
+
+    /**
+     * @brief Stop capturing frames
+     * @return Status code indicating success or failure
+     */
+    virtual Status stopCapture() = 0;
+
+    /**
+     * @brief Check if the device is currently capturing
+     * @return true if capturing, false otherwise
+     */
+    virtual bool isCapturing() const = 0;
+
+    /**
+     * @brief Get supported configurations for this device
+     * @return Vector of supported configurations
+     */
+    virtual std::vector<Config> getSupportedConfigurations() const = 0;
+
+    /**
+     * @brief Get the current configuration
+     * @return Current active configuration
+     */
+    virtual Config getCurrentConfiguration() const = 0;
+
+    /**
+     * @brief Get device capabilities
+     * @return Structure describing device capabilities
+     */
+    virtual Capabilities getCapabilities() const = 0;
+
+    /**
+     * @brief Check if a specific feature is supported
+     * @param feature Feature to check
+     * @return true if the feature is supported
+     */
+    virtual bool supportsFeature(DeviceFeature feature) const = 0;
+
+    /**
+     * @brief Capture straight into the payload arena of a shared memory ring
+     *
+     * Takes effect on the next initialize(). The region must have been
+     * created with SharedMemory::Config::captureBuffers > 0.
+     *
+     * @param sharedMemory Producer side of the ring, nullptr to capture into device memory
+     * @return Status code indicating success or failure
+     */
+    virtual Status setDirectOutputToSharedMemory(std::shared_ptr<SharedMemory> sharedMemory) = 0;
+
+    /**
+     * @brief Get the current frame rate
+     * @return Current frames per second
+     */
+    virtual double getCurrentFrameRate() const = 0;
+
+    /**
+     * @brief Get the histogram of intervals between captured frames
+     * @return Histogram of frame arrival intervals in nanoseconds
+     */
+    virtual const LatencyHistogram& getCaptureIntervalHistogram() const = 0;
+
+    /**
+     * @brief Get the histogram of time spent turning device frames into Frame objects
+     * @return Histogram of conversion times in nanoseconds
+     */
+    virtual const LatencyHistogram& getConvertTimeHistogram() const = 0;
+
+    /**
+     * @brief Get the number of frames dropped by the device
+     *
+     * Input frames the driver skipped plus frames the device failed to wrap;
+     * losses after the callback are counted by the service per cause.
+     *
+     * @return Frames the device could not deliver
+     */
+    virtual uint64_t getDroppedFrameCount() const = 0;
+
+    /**
+     * @brief Get the number of zero-copy buffer acquisitions that found the pool empty
+     * @return Buffer pool exhaustion count
+     */
+    virtual uint64_t getBufferPoolExhaustedCount() const = 0;
+
+    /**
+     * @brief Get the number of direct shared memory captures that fell back to heap memory
+     * @return Heap fallback count, 0 when capturing into device memory
+     */
+    virtual uint64_t getDirectCaptureHeapFallbacks() const = 0;
+
+    /**
+     * @brief Get the number of device capture buffers still referenced by frames
+     *
+     * Buffers held here are unavailable to the device until the frames
+     * wrapping them are destroyed; a count near the device's pool size
+     * means consumers are starving capture.
+     *
+     * @return Outstanding buffer count
+     */
+    virtual uint64_t getOutstandingBufferCount() const = 0;
+
+    /**
+     * @brief Get the NUMA node the device is attached to
+     * @return NUMA node, -1 if unknown or not applicable
+     */
+    virtual int getNumaNode() const = 0;
+
+    /**
+     * @brief Check whether the device currently receives an input signal
+     *
+     * A device without a source connected may keep delivering frames, e.g.
+     * black ones at the configured rate; the service then publishes only a
+     * low-rate keep-alive.
+     *
+     * @return true if frames carry a live image
+     */
+    virtual bool hasInputSignal() const = 0;
+
+    /**
+     * @brief Get device-specific diagnostics
+     * @return Map of diagnostic name to value
+     */
+    virtual std::map<std::string, std::string> getDiagnostics() const = 0;
+};
+
+} // namespace imaging
+} // namespace medical
@@ -45,7 +45,7 @@ public:
      * @param deviceId The ID of the device to retrieve
      * @return Shared pointer to the device, or nullptr if not found
      */
-    std::shared_ptr<BlackmagicDevice> getDevice(const std::string& deviceId);
+    std::shared_ptr<CaptureDevice> getDevice(const std::string& deviceId);
 
     /**
      * @brief Register a callback for device hot-plug events
@@ -62,8 +62,11 @@ public:
      */
     bool unregisterDeviceChangeCallback(int subscriptionId);
 
-    // Test method to add a device manually
-    void addTestDevice(std::shared_ptr<BlackmagicDevice> device);
+    /**
+     * @brief Add a device that was not discovered, e.g. a SyntheticDevice
+     * @param device Device to register under its own device ID
+     */
+    void addTestDevice(std::shared_ptr<CaptureDevice> device);
 
     // Prevent copy and assignment
     DeviceManager(const DeviceManager&) = delete;
@@ -76,7 +79,7 @@ private:
     class DeviceNotificationCallback;  // Forward declaration for BMD callback
 
     // Private implementation details
-    std::map<std::string, std::shared_ptr<BlackmagicDevice>> devices_;
+    std::map<std::string, std::shared_ptr<CaptureDevice>> devices_;
     std::map<int, std::function<void(const std::string&, bool)>> callbacks_;
     int nextCallbackId_;
     mutable std::mutex mutex_;
@@ -88,7 +91,7 @@ private:
     void deviceRemoved(void* deckLinkDevice);
 
     // Thread-safe way to add a device
-    void addDeviceSafe(const std::string& deviceId, std::shared_ptr<BlackmagicDevice> device);
+    void addDeviceSafe(const std::string& deviceId, std::shared_ptr<CaptureDevice> device);
 
     // Thread-safe way to remove a device
     void removeDeviceSafe(const std::string& deviceId);
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <map>
+
+#include "device/capture_device.h"
+#include "frame/pixel_format.h"
+
+namespace medical {
+namespace imaging {
+
+class RecordingReader;
+
+/**
+ * @class SyntheticDevice
+ * @brief Capture device that generates or replays frames without hardware
+ *
+ * Delivers frames through the same startCapture() callback path as a real
+ * card, either from a generated test pattern or from a file of raw frames,
+ * at the configured frame rate or as fast as the pipeline accepts them.
+ * Used to load-test ImagingService and SharedMemory on machines without a
+ * capture card and to find their sustainable throughput independently of it.
+ */
+class SyntheticDevice : public CaptureDevice {
+public:
+    /**
+     * @brief Where frame contents come from
+     */
+    enum class Source {
+        PATTERN,    // Generated moving test pattern
+        REPLAY      // Raw frames read back-to-back from a file
+    };
+
+    /**
+     * @brief How frames are paced
+     */
+    enum class Pacing {
+        REALTIME,               // Follow the configured frame rate, dropping frames when late
+        AS_FAST_AS_POSSIBLE     // Deliver the next frame as soon as the callback returns
+    };
+
+    /**
+     * @brief Source and timing options
+     */
+    struct Options {
+        std::string deviceId;     // ID the device registers under
+        Source source;            // Frame source
+        std::string replayPath;   // Raw frame file or FrameRecorder recording for Source::REPLAY
+        bool loop;                // Restart the replay at the end of the file
+        Pacing pacing;            // Frame pacing
+        double jitterUs;          // Standard deviation of delivery jitter in microseconds
+        int burstSize;            // Frames delivered back-to-back per burst (1 for steady delivery)
+        uint32_t seed;            // Seed for the jitter generator
+
+        // Constructor with default values
+        Options() :
+            deviceId("synthetic-0"),
+            source(Source::PATTERN),
+            replayPath(""),
+            loop(true),
+            pacing(Pacing::REALTIME),
+            jitterUs(0.0),
+            burstSize(1),
+            seed(1) {}
+    };
+
+    /**
+     * @brief Constructor
+     * @param options Source and timing options
+     */
+    explicit SyntheticDevice(const Options& options = Options());
+
+    /**
+     * @brief Destructor
+     */
+    ~SyntheticDevice() override;
+
+    std::string getDeviceId() const override;
+    std::string getDeviceName() const override;
+    std::string getDeviceModel() const override;
+    Status initialize(const Config &config) override;
+    Status startCapture(std::function<void(std::shared_ptr<Frame>)> frameCallback) override;
+    Status stopCapture() override;
+    bool isCapturing() const override;
+    std::vector<Config> getSupportedConfigurations() const override;
+    Config getCurrentConfiguration() const override;
+    Capabilities getCapabilities() const override;
+    bool supportsFeature(DeviceFeature feature) const override;
+    Status setDirectOutputToSharedMemory(std::shared_ptr<SharedMemory> sharedMemory) override;
+    double getCurrentFrameRate() const override;
+    const LatencyHistogram& getCaptureIntervalHistogram() const override;
+    const LatencyHistogram& getConvertTimeHistogram() const override;
+    uint64_t getDroppedFrameCount() const override;
+    uint64_t getBufferPoolExhaustedCount() const override;
+    uint64_t getDirectCaptureHeapFallbacks() const override;
+    uint64_t getOutstandingBufferCount() const override;
+    int getNumaNode() const override;
+    bool hasInputSignal() const override;
+    std::map<std::string, std::string> getDiagnostics() const override;
+
+    /**
+     * @brief Get the options the device was created with
+     * @return Source and timing options
+     */
+    const Options& getOptions() const;
+
+private:
+    // Frame generation loop
+    void captureThread();
+
+    // Build one frame from source frame @p index
+    std::shared_ptr<Frame> makeFrame(size_t index, std::chrono::steady_clock::time_point captureTime);
+
+    // Render the test pattern frames
+    void renderPattern();
+
+    // Map the replay file
+    Status openReplay();
+    void closeReplay();
+
+    // Pointer to the contents of source frame @p index
+    const uint8_t* sourceFrame(size_t index) const;
+
+    // Number of source frames available
+    size_t sourceFrameCount() const;
+
+    Options options_;
+    Config currentConfig_;
+    PixelFormat pixelFormat_;
+    size_t frameBytes_;
+    size_t rowBytes_;
+
+    std::function<void(std::shared_ptr<Frame>)> frameCallback_;
+    std::shared_ptr<SharedMemory> directSharedMemory_;
+
+    // Frame contents
+    std::vector<uint8_t> patternFrames_;
+    void* replayMapping_;
+    size_t replaySize_;
+    std::unique_ptr<RecordingReader> replayRecording_; // Set when the replay file is an indexed recording
+
+    // Generation thread
+    std::thread captureThread_;
+    std::atomic<bool> isCapturing_;
+    std::atomic<bool> stopRequested_;
+    mutable std::mutex mutex_;
+
+    // Performance monitoring
+    std::atomic<uint64_t> frameCount_;
+    std::atomic<uint64_t> droppedFrames_;
+    std::atomic<uint64_t> heapFallbacks_;
+    std::atomic<uint64_t> leasesOutstanding_; // Ring leases wrapped by frames not yet destroyed
+    std::atomic<uint64_t> leasesOutstandingPeak_;
+    std::atomic<uint64_t> frameIntervalAvgNs_;
+    std::chrono::steady_clock::time_point lastFrameTime_; // Only touched by the generation thread
+    LatencyHistogram captureIntervalHistogram_;
+    LatencyHistogram convertTimeHistogram_;
+};
+
+} // namespace imaging
+} // namespace medical
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -9,6 +10,11 @@
 #include <optional>
 #include <variant>
 #include <atomic>
+#include <string_view>
+#include <unordered_map>
+
+#include "frame/frame_metadata.h"
+#include "frame/pixel_format.h"
 
 namespace medical::imaging {
     /**
@@ -22,41 +28,6 @@ namespace medical::imaging {
         EXTERNAL_MEMORY    // Memory managed externally
     };
 
-    /**
-     * @struct FrameMetadata
-     * @brief Enhanced metadata for medical imaging frames
-     */
-    struct FrameMetadata {
-        uint64_t frameId = 0;                      // Unique frame ID
-        uint64_t timestampNs = 0;                  // Capture timestamp in nanoseconds
-        uint32_t width = 0;                        // Frame width in pixels
-        uint32_t height = 0;                       // Frame height in pixels
-        uint32_t bytesPerPixel = 0;                // Number of bytes per pixel
-        std::string format;                        // Pixel format string
-
-        // Acquisition metadata
-        std::string deviceId;                      // ID of capturing device
-        float exposureTimeMs = 0.0f;               // Exposure time in milliseconds
-        uint32_t frameNumber = 0;                  // Sequential frame number
-
-        // Processing status flags
-        bool hasBeenProcessed = false;             // Whether frame has been processed
-        bool hasCalibrationData = false;           // Whether frame has calibration data
-        bool hasSegmentationData = false;          // Whether frame has segmentation data
-
-        // For tracking/calibration
-        std::vector<float> probePosition;          // 3D probe position [x,y,z]
-        std::vector<float> probeOrientation;       // Quaternion [x,y,z,w]
-
-        // Image quality and diagnostics
-        float signalToNoiseRatio = 0.0f;           // SNR in dB
-        float signalStrength = 0.0f;               // Signal strength (0.0-1.0)
-        float confidenceScore = 0.0f;              // AI confidence (0.0-1.0)
-
-        // Additional metadata as key-value pairs
-        std::unordered_map<std::string, std::string> attributes;
-    };
-
     /**
      * @class Frame
      * @brief Represents a captured ultrasound frame with enhanced zero-copy support
@@ -80,6 +51,19 @@ namespace medical::imaging {
             int width, int height, int bytesPerPixel, const std::string &format,
             BufferType bufferType = BufferType::CPU_MEMORY);
 
+        /**
+         * @brief Create a new frame with allocated buffer for a typed pixel format
+         * @param width Frame width in pixels
+         * @param height Frame height in pixels
+         * @param bytesPerPixel Number of bytes per pixel
+         * @param format Pixel format
+         * @param bufferType Type of buffer to create
+         * @return Shared pointer to the created frame
+         */
+        static std::shared_ptr<Frame> create(
+            int width, int height, int bytesPerPixel, PixelFormat format,
+            BufferType bufferType = BufferType::CPU_MEMORY);
+
         /**
          * @brief Create a frame that wraps existing data (zero-copy)
          * @param data Pointer to the raw frame data
@@ -97,6 +81,26 @@ namespace medical::imaging {
             const std::string &format, bool ownsData = false,
             BufferType bufferType = BufferType::CPU_MEMORY);
 
+        /**
+         * @brief Create a frame that wraps existing data of a typed pixel format (zero-copy)
+         *
+         * Preferred on the capture path: no format string has to be parsed.
+         *
+         * @param data Pointer to the raw frame data
+         * @param size Size of the data in bytes
+         * @param width Frame width in pixels
+         * @param height Frame height in pixels
+         * @param bytesPerPixel Number of bytes per pixel
+         * @param format Pixel format
+         * @param ownsData Whether this frame should take ownership of the data
+         * @param bufferType Type of buffer being provided
+         * @return Shared pointer to the created frame
+         */
+        static std::shared_ptr<Frame> createWithExternalData(
+            void *data, size_t size, int width, int height, int bytesPerPixel,
+            PixelFormat format, bool ownsData = false,
+            BufferType bufferType = BufferType::CPU_MEMORY);
+
         /**
          * @brief Create a frame that directly maps to shared memory
          * @param shmName Shared memory name
@@ -131,6 +135,28 @@ namespace medical::imaging {
          */
         void *getData() const;
 
+        /**
+         * @brief Get the device pointer of a frame in GPU memory
+         * @return CUDA device pointer, nullptr unless isGpuMemory()
+         */
+        void *getDevicePointer() const;
+
+        /**
+         * @brief Get the dma-buf a DMA_BUFFER frame's data maps
+         * @return dma-buf file descriptor, -1 if none
+         */
+        int getDmaBufFd() const;
+
+        /**
+         * @brief Name the dma-buf a DMA_BUFFER frame's data maps
+         *
+         * lock() and unlock() then bracket CPU access with DMA_BUF_IOCTL_SYNC.
+         * The frame does not take ownership of the descriptor.
+         *
+         * @param fd dma-buf file descriptor, -1 for none
+         */
+        void setDmaBufFd(int fd);
+
         /**
          * @brief Get the size of the frame data in bytes
          * @return Size in bytes
@@ -161,6 +187,12 @@ namespace medical::imaging {
          */
         std::string getFormat() const;
 
+        /**
+         * @brief Get the typed pixel format
+         * @return Pixel format, UNKNOWN if the frame was created with an unrecognized format string
+         */
+        PixelFormat getPixelFormat() const;
+
         /**
          * @brief Get the frame timestamp
          * @return Timestamp when the frame was captured
@@ -173,6 +205,22 @@ namespace medical::imaging {
          */
         void setTimestamp(std::chrono::system_clock::time_point timestamp);
 
+        /**
+         * @brief Get the capture time on the monotonic clock (CLOCK_MONOTONIC)
+         *
+         * Derived from the device's hardware reference clock when available, so
+         * it reflects when the frame was captured rather than when the callback ran.
+         *
+         * @return Capture time, the clock epoch if unknown
+         */
+        std::chrono::steady_clock::time_point getCaptureTime() const;
+
+        /**
+         * @brief Set the capture time on the monotonic clock
+         * @param captureTime Capture time
+         */
+        void setCaptureTime(std::chrono::steady_clock::time_point captureTime);
+
         /**
          * @brief Get the frame unique ID
          * @return Frame ID
@@ -185,6 +233,18 @@ namespace medical::imaging {
          */
         void setFrameId(uint64_t id);
 
+        /**
+         * @brief Get the ring sequence number the frame was read from
+         * @return Sequence number, 0 if the frame did not come from a shared memory ring
+         */
+        uint64_t getSequenceNumber() const;
+
+        /**
+         * @brief Set the ring sequence number
+         * @param sequenceNumber Sequence number of the slot the frame views
+         */
+        void setSequenceNumber(uint64_t sequenceNumber);
+
         /**
          * @brief Get the buffer type
          * @return Buffer type enum
@@ -221,15 +281,62 @@ namespace medical::imaging {
          */
         bool isMappedToSharedMemory() const;
 
+        /**
+         * @brief Attach a generation counter that tells whether the frame data is still intact
+         *
+         * Used for frames that view a buffer owned by a producer which may reuse it
+         * (e.g. a shared memory ring slot). The counter must keep @p expected for as
+         * long as the buffer belongs to this frame.
+         *
+         * @param generation Generation counter owned by the producer, nullptr to detach
+         * @param expected Value the counter holds while the data belongs to this frame
+         */
+        void setValidityGuard(const std::atomic<uint64_t> *generation, uint64_t expected);
+
+        /**
+         * @brief Check that the frame data has not been overwritten since the frame was obtained
+         *
+         * Call after consuming the data (e.g. after copying or processing it); a false
+         * result means the producer reused the buffer meanwhile and the result must be
+         * discarded. Frames without a validity guard are always valid.
+         *
+         * @return true if everything read from the frame so far is consistent
+         */
+        bool validate() const;
+
         /**
          * @brief Deep copy the frame to a new memory location
+         *
+         * A CPU copy is made into a buffer from the frame buffer pool, which
+         * recycles released buffers by size class instead of freeing them.
+         *
          * @param targetBufferType Type of buffer to create for the copy
          * @return New frame with copied data
          */
         std::shared_ptr<Frame> clone(BufferType targetBufferType = BufferType::CPU_MEMORY) const;
 
+        /**
+         * @brief Copy the frame on write: the copy shares the pixel buffer until either is locked for writing
+         *
+         * A frame whose data is a pooled buffer (from create(), clone() or
+         * cloneShared()) shares it, reference counted. Any other CPU-readable
+         * frame (capture buffers, ring views, dma-bufs) is copied into a pooled
+         * buffer once, and every later cloneShared() of the same frame shares
+         * that copy. lock(false) on any of the frames sharing a buffer first
+         * gives that frame its own copy, so frames must be locked for writing
+         * before their data is modified. Identity and metadata are copied.
+         *
+         * @return Frame sharing the data, nullptr on failure
+         */
+        std::shared_ptr<Frame> cloneShared() const;
+
         /**
          * @brief Set legacy metadata associated with this frame (for backward compatibility)
+         *
+         * The pair goes into FrameMetadata::attributes, which is published
+         * with the frame. A pair that does not fit in the table is kept with
+         * this frame and its clones only.
+         *
          * @param key Metadata key
          * @param value Metadata value
          */
@@ -244,6 +351,9 @@ namespace medical::imaging {
 
         /**
          * @brief Lock the frame data for CPU access
+         *
+         * Locking for writing unshares a buffer cloneShared() shares, copying it.
+         *
          * @param readOnly Whether access is read-only
          * @return true if lock was successful
          */
@@ -268,6 +378,26 @@ namespace medical::imaging {
         std::unique_ptr<Impl> impl_;
         std::function<void()> onDestroyCallback_;
 
+        // Pool of released frame objects reused by the factory methods
+        class Pool;
+
+        // shared_ptr deleter returning the frame to the pool instead of freeing it
+        struct Recycler {
+            void operator()(Frame *frame) const;
+        };
+
+        // Shared implementation of the factories, taking both the format name and its typed value
+        static std::shared_ptr<Frame> create(
+            int width, int height, int bytesPerPixel, std::string_view format, PixelFormat pixelFormat,
+            BufferType bufferType);
+
+        static std::shared_ptr<Frame> createWithExternalData(
+            void *data, size_t size, int width, int height, int bytesPerPixel,
+            std::string_view format, PixelFormat pixelFormat, bool ownsData, BufferType bufferType);
+
+        // Run the destroy callback and reset all state so the object can be handed out again
+        void releaseForReuse();
+
         // Private constructor, use factory methods instead
         Frame();
     };
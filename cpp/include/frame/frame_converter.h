@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "frame/frame.h"
+#include "frame/pixel_format.h"
+
+namespace medical::imaging {
+    /**
+     * @class FrameConverter
+     * @brief Converts captured frames to consumer-friendly pixel formats
+     *
+     * Runs once in the service so consumers do not each deinterleave the raw
+     * capture: UYVY to GRAY8 or RGB24, 10-bit v210 to planar 16-bit YUV and
+     * 10-bit r210 to 16-bit RGB. The kernels are selected at runtime from the best instruction
+     * set the CPU supports (AVX-512BW, AVX2, NEON, or a scalar fallback);
+     * every variant produces bit-identical output.
+     */
+    class FrameConverter {
+    public:
+        /**
+         * @brief Constructor
+         * @param outputFormat Format produced by convert()
+         */
+        explicit FrameConverter(PixelFormat outputFormat);
+
+        /**
+         * @brief Get the format produced by this converter
+         * @return Output pixel format
+         */
+        PixelFormat getOutputFormat() const;
+
+        /**
+         * @brief Check whether a conversion is implemented
+         * @param input Source pixel format
+         * @param output Destination pixel format
+         * @return true if convert() can produce @p output from @p input
+         */
+        static bool supports(PixelFormat input, PixelFormat output);
+
+        /**
+         * @brief Get the capture format a conversion output is produced from
+         * @param output Destination pixel format
+         * @return Source format, UNKNOWN if no conversion produces @p output
+         */
+        static PixelFormat getInputFormat(PixelFormat output);
+
+        /**
+         * @brief Get the number of bytes a converted frame needs
+         * @param width Frame width in pixels
+         * @param height Frame height in pixels
+         * @return Output size in bytes
+         */
+        size_t getOutputSize(int width, int height) const;
+
+        /**
+         * @brief Convert a frame
+         *
+         * Frame ID, timestamp and metadata are carried over to the result.
+         *
+         * @param input Source frame
+         * @param output Destination buffer, nullptr to allocate a pooled frame
+         * @param outputSize Size of @p output in bytes
+         * @return Converted frame (wrapping @p output if given), nullptr if unsupported or too small
+         */
+        std::shared_ptr<Frame> convert(const Frame &input, void *output = nullptr, size_t outputSize = 0) const;
+
+        /**
+         * @brief Extract the luminance plane of a UYVY image
+         * @param src Source UYVY rows
+         * @param srcStride Source row pitch in bytes
+         * @param dst Destination Y8 rows
+         * @param dstStride Destination row pitch in bytes
+         * @param width Image width in pixels
+         * @param height Image height in pixels
+         */
+        static void uyvyToGray8(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride,
+                                int width, int height);
+
+        /**
+         * @brief Convert a UYVY image to packed RGB24 (BT.709, limited range)
+         * @param src Source UYVY rows
+         * @param srcStride Source row pitch in bytes
+         * @param dst Destination RGB24 rows
+         * @param dstStride Destination row pitch in bytes
+         * @param width Image width in pixels
+         * @param height Image height in pixels
+         */
+        static void uyvyToRgb24(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride,
+                                int width, int height);
+
+        /**
+         * @brief Unpack a v210 image into 16-bit Y, U and V planes
+         *
+         * Samples keep their 10-bit values (0-1023) in the low bits. The
+         * chroma planes are (width + 1) / 2 samples wide.
+         *
+         * @param src Source v210 rows
+         * @param srcStride Source row pitch in bytes (a multiple of 128)
+         * @param y Destination Y plane, width samples per row
+         * @param u Destination U (Cb) plane
+         * @param v Destination V (Cr) plane
+         * @param width Image width in pixels
+         * @param height Image height in pixels
+         */
+        static void v210ToYuv422p16(const uint8_t *src, size_t srcStride, uint16_t *y, uint16_t *u, uint16_t *v,
+                                    int width, int height);
+
+        /**
+         * @brief Unpack an r210 image into packed 16-bit RGB (RGB48)
+         *
+         * Samples keep their 10-bit values (0-1023) in the low bits.
+         *
+         * @param src Source r210 rows
+         * @param srcStride Source row pitch in bytes
+         * @param dst Destination RGB48 rows
+         * @param dstStride Destination row pitch in samples
+         * @param width Image width in pixels
+         * @param height Image height in pixels
+         */
+        static void r210ToRgb48(const uint8_t *src, size_t srcStride, uint16_t *dst, size_t dstStride,
+                                int width, int height);
+
+        /**
+         * @brief Get the name of the instruction set the kernels run on
+         * @return "avx512bw", "avx2", "neon" or "scalar"
+         */
+        static const char *getKernelName();
+
+    private:
+        PixelFormat outputFormat_;
+    };
+} // namespace medical::imaging
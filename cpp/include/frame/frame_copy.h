@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @enum CopyMode
+     * @brief How frame payloads are copied into shared memory
+     */
+    enum class CopyMode {
+        AUTO,      // Streaming stores for large payloads, memcpy for small ones
+        MEMCPY,    // Always std::memcpy
+        STREAMING  // Always non-temporal stores that bypass the cache
+    };
+
+    /**
+     * @class FrameCopier
+     * @brief Copies frame payloads, optionally bypassing the cache and split across threads
+     *
+     * A writer never reads a published payload again, so copying an 8-17 MB
+     * frame through the cache only evicts the last-level cache that readers
+     * on the same socket work in. The streaming kernel uses non-temporal
+     * stores on the widest instruction set the CPU supports (AVX-512, AVX2,
+     * SSE2, or NEON store-pair hints) and ends with a store fence, so the
+     * payload is globally visible before the caller publishes the slot.
+     *
+     * With more than one thread, large copies are split into page-aligned
+     * chunks; the calling thread copies the first chunk and helper threads
+     * the others. copy() must not be called from several threads at once.
+     */
+    class FrameCopier {
+    public:
+        /**
+         * @brief Payload size from which AUTO uses streaming stores
+         */
+        static constexpr size_t STREAMING_THRESHOLD = 1024 * 1024;
+
+        /**
+         * @brief Smallest chunk worth handing to another thread
+         */
+        static constexpr size_t MIN_CHUNK_BYTES = 2 * 1024 * 1024;
+
+        /**
+         * @brief Constructor
+         * @param mode Copy kernel selection
+         * @param threads Threads sharing a large copy, the calling thread included (1 for none)
+         */
+        explicit FrameCopier(CopyMode mode = CopyMode::AUTO, size_t threads = 1);
+
+        /**
+         * @brief Destructor, stops the helper threads
+         */
+        ~FrameCopier();
+
+        FrameCopier(const FrameCopier &) = delete;
+        FrameCopier &operator=(const FrameCopier &) = delete;
+
+        /**
+         * @brief Copy a payload
+         * @param destination Destination buffer
+         * @param source Source buffer, must not overlap @p destination
+         * @param size Number of bytes to copy
+         */
+        void copy(void *destination, const void *source, size_t size);
+
+        /**
+         * @brief Get the copy kernel selection
+         * @return Copy mode
+         */
+        CopyMode getMode() const;
+
+        /**
+         * @brief Get the number of threads sharing a large copy
+         * @return Thread count, the calling thread included
+         */
+        size_t getThreadCount() const;
+
+        /**
+         * @brief Copy with non-temporal stores on the calling thread, followed by a store fence
+         * @param destination Destination buffer
+         * @param source Source buffer, must not overlap @p destination
+         * @param size Number of bytes to copy
+         */
+        static void copyStreaming(void *destination, const void *source, size_t size);
+
+        /**
+         * @brief Get the name of the instruction set the streaming kernel runs on
+         * @return "avx512", "avx2", "sse2", "neon" or "memcpy"
+         */
+        static const char *getKernelName();
+
+        /**
+         * @brief Parse a copy mode name
+         * @param name "auto", "memcpy" or "streaming"
+         * @param mode Output parameter receiving the mode
+         * @return true if the name is known
+         */
+        static bool parseMode(const std::string &name, CopyMode &mode);
+
+        /**
+         * @brief Get the name of a copy mode
+         * @param mode Copy mode
+         * @return "auto", "memcpy" or "streaming"
+         */
+        static const char *toString(CopyMode mode);
+
+    private:
+        void copyChunk(uint8_t *destination, const uint8_t *source, size_t size, bool streaming) const;
+        void helperThread(size_t index);
+
+        CopyMode mode_;
+        std::vector<std::thread> helpers_;
+
+        // Current split copy, published to the helpers through jobGeneration_
+        uint8_t *jobDestination_;
+        const uint8_t *jobSource_;
+        size_t jobSize_;
+        size_t jobChunk_;
+        bool jobStreaming_;
+        std::atomic<uint32_t> jobGeneration_; // Futex word bumped for every split copy
+        std::atomic<uint32_t> jobPending_;    // Helpers still copying; futex word the caller sleeps on
+        std::atomic<bool> stopHelpers_;
+    };
+} // namespace medical::imaging
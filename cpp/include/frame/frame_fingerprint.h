@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "frame/frame.h"
+
+namespace medical::imaging {
+    /**
+     * @enum DuplicatePolicy
+     * @brief What the service does with a frame whose pixels repeat the previous one
+     */
+    enum class DuplicatePolicy {
+        PUBLISH,  // Publish every frame as it is
+        MARK,     // Publish the header flagged as a duplicate, pointing at the payload already in the ring
+        THROTTLE  // Leave duplicates out, except one full frame per keep-alive interval
+    };
+
+    /**
+     * @class FrameFingerprint
+     * @brief Cheap hash of a frame's pixels, to recognise frozen images
+     *
+     * A frozen scanner keeps sending the same image at full rate. Live
+     * ultrasound is covered in speckle that changes everywhere from one
+     * frame to the next, so sampling a few evenly spread 64-byte blocks
+     * tells a frozen image from a live one while reading a fraction of a
+     * percent of a 1080p frame. Each block is folded into eight
+     * independent 64-bit lanes, which the compiler keeps in vector
+     * registers. Geometry and format are part of the fingerprint, so a
+     * mode change is never taken for a duplicate.
+     *
+     * Sampling misses changes that fall entirely between the blocks, such
+     * as a small on-screen counter; with 0 samples the whole frame is
+     * hashed.
+     */
+    class FrameFingerprint {
+    public:
+        /**
+         * @brief Default number of sampled blocks
+         */
+        static constexpr size_t DEFAULT_SAMPLES = 1024;
+
+        /**
+         * @brief Size of each sampled block in bytes
+         */
+        static constexpr size_t BLOCK_BYTES = 64;
+
+        /**
+         * @brief Fingerprint a buffer
+         * @param data Bytes to fingerprint
+         * @param size Number of bytes
+         * @param samples Blocks to sample, 0 to hash every byte
+         * @param seed Value mixed into the result
+         * @return 64-bit fingerprint
+         */
+        static uint64_t compute(const void *data, size_t size, size_t samples = DEFAULT_SAMPLES, uint64_t seed = 0);
+
+        /**
+         * @brief Fingerprint the pixels and geometry of a frame
+         * @param frame Frame to fingerprint, must be CPU accessible
+         * @param samples Blocks to sample, 0 to hash every byte
+         * @return 64-bit fingerprint, 0 if the frame has no CPU data
+         */
+        static uint64_t compute(const Frame &frame, size_t samples = DEFAULT_SAMPLES);
+
+        /**
+         * @brief Parse a duplicate policy name
+         * @param name "publish", "mark" or "throttle"
+         * @param policy Output parameter receiving the policy
+         * @return true if the name is known
+         */
+        static bool parsePolicy(const std::string &name, DuplicatePolicy &policy);
+
+        /**
+         * @brief Get the name of a duplicate policy
+         * @param policy Duplicate policy
+         * @return "publish", "mark" or "throttle"
+         */
+        static const char *toString(DuplicatePolicy policy);
+    };
+} // namespace medical::imaging
@@ -0,0 +1,412 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace medical::imaging {
+    /**
+     * @brief Fixed-layout per-frame metadata stored right after each FrameHeader
+     *
+     * The header's metadataOffset/metadataSize locate the record relative to the
+     * start of the header. Fields are only appended in later versions.
+     * SharedMemory::FrameMetadataRecord names the same type.
+     */
+    struct alignas(8) FrameMetadataRecord {
+        uint32_t version;               // FRAME_METADATA_VERSION the record was written with
+        uint32_t flags;                 // Processing flags (same bits as FrameHeader::flags)
+        uint32_t frameNumber;           // Sequential frame number from the device
+        float exposureTimeMs;           // Exposure time in milliseconds
+        float signalToNoiseRatio;       // SNR in dB
+        float signalStrength;           // Signal strength (0.0-1.0)
+        float confidenceScore;          // AI confidence (0.0-1.0)
+        uint32_t probePositionCount;    // Valid entries in probePosition
+        float probePosition[4];         // 3D probe position [x,y,z]
+        uint32_t probeOrientationCount; // Valid entries in probeOrientation
+        float probeOrientation[4];      // Quaternion [x,y,z,w]
+        char deviceId[64];              // NUL-terminated capturing device ID
+        uint32_t attributesSize;        // Bytes used in attributes
+        char attributes[1024];          // Packed "key\0value\0" pairs
+        uint32_t roiX;                  // Left edge of the crop in the captured frame (version 2)
+        uint32_t roiY;                  // Top edge of the crop in the captured frame (version 2)
+        uint32_t sourceWidth;           // Width of the captured frame, 0 if not cropped (version 2)
+        uint32_t sourceHeight;          // Height of the captured frame, 0 if not cropped (version 2)
+        uint32_t statisticsPixelCount;  // Luminance samples the image statistics cover (version 3, FRAME_FLAG_STATISTICS)
+        float meanLuminance;            // Mean luminance, 0.0-1.0 of full scale (version 3)
+        float luminanceVariance;        // Variance of the luminance on the same scale (version 3)
+        float saturatedFraction;        // Fraction of samples at the top code of the format (version 3)
+        uint32_t luminanceHistogram[16]; // Samples per sixteenth of the luminance range (version 3)
+        uint8_t reserved[24];           // Reserved for future use
+    };
+
+    /**
+     * @class InlineString
+     * @brief NUL-terminated string stored in place, truncated to N - 1 characters
+     */
+    template<size_t N>
+    class InlineString {
+    public:
+        InlineString() : data_{} {
+        }
+
+        InlineString(std::string_view text) : data_{} {
+            assign(text);
+        }
+
+        InlineString(const char *text) : data_{} {
+            assign(text ? std::string_view(text) : std::string_view());
+        }
+
+        InlineString(const std::string &text) : data_{} {
+            assign(text);
+        }
+
+        InlineString &operator=(std::string_view text) {
+            assign(text);
+            return *this;
+        }
+
+        InlineString &operator=(const char *text) {
+            assign(text ? std::string_view(text) : std::string_view());
+            return *this;
+        }
+
+        InlineString &operator=(const std::string &text) {
+            assign(text);
+            return *this;
+        }
+
+        void assign(std::string_view text) {
+            size_t length = std::min(text.size(), N - 1);
+            std::memcpy(data_, text.data(), length);
+            std::memset(data_ + length, 0, N - length);
+        }
+
+        void clear() {
+            std::memset(data_, 0, N);
+        }
+
+        bool empty() const {
+            return data_[0] == '\0';
+        }
+
+        size_t size() const {
+            return strnlen(data_, N);
+        }
+
+        const char *c_str() const {
+            return data_;
+        }
+
+        std::string_view view() const {
+            return std::string_view(data_, size());
+        }
+
+        std::string str() const {
+            return std::string(view());
+        }
+
+        operator std::string_view() const {
+            return view();
+        }
+
+        bool operator==(std::string_view text) const {
+            return view() == text;
+        }
+
+        bool operator!=(std::string_view text) const {
+            return view() != text;
+        }
+
+    private:
+        char data_[N];
+    };
+
+    /**
+     * @class InlineVector
+     * @brief Up to N values stored in place with their count; values beyond N are dropped
+     */
+    template<typename T, size_t N>
+    class InlineVector {
+    public:
+        InlineVector() : size_(0), values_{} {
+        }
+
+        size_t size() const {
+            return std::min<size_t>(size_, N);
+        }
+
+        static constexpr size_t capacity() {
+            return N;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        void clear() {
+            size_ = 0;
+        }
+
+        void push_back(T value) {
+            if (size_ < N) {
+                values_[size_++] = value;
+            }
+        }
+
+        template<typename Iterator>
+        void assign(Iterator first, Iterator last) {
+            size_ = 0;
+            for (; first != last && size_ < N; ++first) {
+                values_[size_++] = *first;
+            }
+        }
+
+        T &operator[](size_t index) {
+            return values_[index];
+        }
+
+        const T &operator[](size_t index) const {
+            return values_[index];
+        }
+
+        T *data() {
+            return values_;
+        }
+
+        const T *data() const {
+            return values_;
+        }
+
+        const T *begin() const {
+            return values_;
+        }
+
+        const T *end() const {
+            return values_ + size();
+        }
+
+    private:
+        uint32_t size_;
+        T values_[N];
+    };
+
+    /**
+     * @class AttributeTable
+     * @brief Key-value attributes packed in place as "key\0value\0" pairs
+     *
+     * The layout of FrameMetadataRecord's attributesSize and attributes, so
+     * the table is published as is. A pair that does not fit is refused;
+     * Frame::setMetadata() keeps those with the frame instead.
+     */
+    class AttributeTable {
+    public:
+        static constexpr size_t CAPACITY = 1024;
+
+        AttributeTable() : size_(0), data_{} {
+        }
+
+        /**
+         * @brief Set an attribute, replacing an earlier value of the key
+         * @param key Attribute name, not empty, without NUL characters
+         * @param value Attribute value, without NUL characters
+         * @return false if the pair does not fit; the table is unchanged then
+         */
+        bool set(std::string_view key, std::string_view value) {
+            if (key.empty()) {
+                return false;
+            }
+
+            size_t replaced = 0;
+            size_t pos = 0;
+            size_t valuePos = 0;
+            size_t next = 0;
+            if (locate(key, pos, valuePos, next)) {
+                replaced = next - pos;
+            }
+            if (usedBytes() - replaced + key.size() + value.size() + 2 > CAPACITY) {
+                return false;
+            }
+
+            if (replaced > 0) {
+                erase(key);
+            }
+            size_t used = usedBytes();
+            std::memcpy(data_ + used, key.data(), key.size());
+            data_[used + key.size()] = '\0';
+            std::memcpy(data_ + used + key.size() + 1, value.data(), value.size());
+            data_[used + key.size() + 1 + value.size()] = '\0';
+            size_ = static_cast<uint32_t>(used + key.size() + value.size() + 2);
+            return true;
+        }
+
+        /**
+         * @brief Look up an attribute
+         * @param key Attribute name
+         * @return Value, viewing the table, or nothing if the key is not set
+         */
+        std::optional<std::string_view> find(std::string_view key) const {
+            size_t pos = 0;
+            size_t valuePos = 0;
+            size_t next = 0;
+            if (!locate(key, pos, valuePos, next)) {
+                return std::nullopt;
+            }
+            return std::string_view(data_ + valuePos, next - valuePos - 1);
+        }
+
+        /**
+         * @brief Remove an attribute
+         * @param key Attribute name
+         * @return true if the key was set
+         */
+        bool erase(std::string_view key) {
+            size_t pos = 0;
+            size_t valuePos = 0;
+            size_t next = 0;
+            if (!locate(key, pos, valuePos, next)) {
+                return false;
+            }
+            size_t used = usedBytes();
+            std::memmove(data_ + pos, data_ + next, used - next);
+            size_ = static_cast<uint32_t>(used - (next - pos));
+            return true;
+        }
+
+        /**
+         * @brief Call visitor(key, value) for every attribute, in the order they were set
+         */
+        template<typename Visitor>
+        void forEach(Visitor &&visitor) const {
+            size_t used = usedBytes();
+            size_t pos = 0;
+            while (pos < used) {
+                size_t keyLength = strnlen(data_ + pos, used - pos);
+                size_t valuePos = pos + keyLength + 1;
+                if (valuePos >= used) {
+                    break;
+                }
+                size_t valueLength = strnlen(data_ + valuePos, used - valuePos);
+                visitor(std::string_view(data_ + pos, keyLength), std::string_view(data_ + valuePos, valueLength));
+                pos = valuePos + valueLength + 1;
+            }
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
+        void clear() {
+            size_ = 0;
+        }
+
+        // Bytes of packed pairs in use
+        size_t usedBytes() const {
+            return std::min<size_t>(size_, CAPACITY);
+        }
+
+    private:
+        // Find the pair of key: its start, the start of its value and the start of the next pair
+        bool locate(std::string_view key, size_t &pos, size_t &valuePos, size_t &next) const {
+            size_t used = usedBytes();
+            pos = 0;
+            while (pos < used) {
+                size_t keyLength = strnlen(data_ + pos, used - pos);
+                valuePos = pos + keyLength + 1;
+                if (valuePos >= used) {
+                    return false;
+                }
+                size_t valueLength = strnlen(data_ + valuePos, used - valuePos);
+                next = std::min(valuePos + valueLength + 1, used);
+                if (std::string_view(data_ + pos, keyLength) == key) {
+                    return true;
+                }
+                pos = next;
+            }
+            return false;
+        }
+
+        uint32_t size_;
+        char data_[CAPACITY];
+    };
+
+    /**
+     * @struct FrameMetadata
+     * @brief Enhanced metadata for medical imaging frames
+     *
+     * Trivially copyable and allocation-free: strings, pose vectors and the
+     * attribute table are stored in place with fixed capacities. The fields
+     * from frameNumber to luminanceHistogram have the layout of the same
+     * fields of FrameMetadataRecord, so publishing metadata to a ring is
+     * one memcpy plus the flag word (see SharedMemory::packMetadataRecord()).
+     */
+    struct FrameMetadata {
+        uint64_t frameId = 0;                      // Unique frame ID
+        uint64_t timestampNs = 0;                  // Capture timestamp in nanoseconds
+        uint32_t width = 0;                        // Frame width in pixels
+        uint32_t height = 0;                       // Frame height in pixels
+        uint32_t bytesPerPixel = 0;                // Number of bytes per pixel
+        InlineString<32> format;                   // Pixel format string
+
+        // Processing status flags, published as FRAME_FLAG_* bits
+        bool hasBeenProcessed = false;             // Whether frame has been processed
+        bool hasCalibrationData = false;           // Whether frame has calibration data
+        bool hasSegmentationData = false;          // Whether frame has segmentation data
+        bool hasImageStatistics = false;           // Whether the luminance statistics are filled
+
+        // Everything below mirrors FrameMetadataRecord from frameNumber to luminanceHistogram
+
+        // Acquisition metadata
+        uint32_t frameNumber = 0;                  // Sequential frame number
+        float exposureTimeMs = 0.0f;               // Exposure time in milliseconds
+
+        // Image quality and diagnostics
+        float signalToNoiseRatio = 0.0f;           // SNR in dB
+        float signalStrength = 0.0f;               // Signal strength (0.0-1.0)
+        float confidenceScore = 0.0f;              // AI confidence (0.0-1.0)
+
+        // For tracking/calibration
+        InlineVector<float, 4> probePosition;      // 3D probe position [x,y,z]
+        InlineVector<float, 4> probeOrientation;   // Quaternion [x,y,z,w]
+
+        InlineString<64> deviceId;                 // ID of capturing device
+
+        // Additional metadata as key-value pairs
+        AttributeTable attributes;
+
+        // Region of interest the frame was cropped to
+        uint32_t roiX = 0;                         // Left edge of the crop in the captured frame
+        uint32_t roiY = 0;                         // Top edge of the crop in the captured frame
+        uint32_t sourceWidth = 0;                  // Width of the captured frame (0 if not cropped)
+        uint32_t sourceHeight = 0;                 // Height of the captured frame (0 if not cropped)
+
+        // Luminance statistics the service computed while publishing the frame
+        uint32_t statisticsPixelCount = 0;         // Samples the statistics cover
+        float meanLuminance = 0.0f;                // Mean luminance (0.0-1.0 of full scale)
+        float luminanceVariance = 0.0f;            // Variance of the luminance on the same scale
+        float saturatedFraction = 0.0f;            // Fraction of samples at the top code (0.0-1.0)
+        std::array<uint32_t, 16> luminanceHistogram{}; // Samples per sixteenth of the luminance range
+    };
+
+    static_assert(std::is_trivially_copyable_v<FrameMetadata>, "frame metadata is copied as raw bytes");
+
+    // Bytes of FrameMetadata that are copied to and from the record as one block
+    constexpr size_t FRAME_METADATA_RECORD_BYTES =
+            offsetof(FrameMetadataRecord, reserved) - offsetof(FrameMetadataRecord, frameNumber);
+
+    static_assert(offsetof(FrameMetadata, luminanceHistogram) + sizeof(FrameMetadata::luminanceHistogram) -
+                  offsetof(FrameMetadata, frameNumber) == FRAME_METADATA_RECORD_BYTES,
+                  "FrameMetadata must mirror FrameMetadataRecord");
+    static_assert(offsetof(FrameMetadata, deviceId) - offsetof(FrameMetadata, frameNumber) ==
+                  offsetof(FrameMetadataRecord, deviceId) - offsetof(FrameMetadataRecord, frameNumber),
+                  "FrameMetadata must mirror FrameMetadataRecord");
+    static_assert(offsetof(FrameMetadata, roiX) - offsetof(FrameMetadata, frameNumber) ==
+                  offsetof(FrameMetadataRecord, roiX) - offsetof(FrameMetadataRecord, frameNumber),
+                  "FrameMetadata must mirror FrameMetadataRecord");
+} // namespace medical::imaging
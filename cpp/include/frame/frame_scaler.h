@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "frame/frame.h"
+#include "frame/pixel_format.h"
+
+namespace medical::imaging {
+    /**
+     * @class FrameScaler
+     * @brief Box-filters frames down by an integer factor for preview consumers
+     *
+     * Every output pixel is the rounded mean of a factor x factor block of
+     * input pixels; trailing rows and columns that do not fill a block are
+     * dropped. UYVY keeps its 4:2:2 layout, so each output chroma pair
+     * averages the 2 x factor input pixels it covers. The vertical pass touches
+     * every input byte and runs on the best instruction set the CPU supports
+     * (AVX2, NEON, or a scalar fallback); the horizontal pass only sees one
+     * row of sums per output row and stays scalar.
+     *
+     * Keeps a row of sums between calls, so one scaler must not be used
+     * from several threads at once.
+     */
+    class FrameScaler {
+    public:
+        /**
+         * @brief Largest supported factor; keeps a block sum inside 16 bits
+         */
+        static constexpr int MAX_FACTOR = 16;
+
+        /**
+         * @brief Constructor
+         * @param factor Divisor applied to width and height (1 to MAX_FACTOR)
+         */
+        explicit FrameScaler(int factor);
+
+        /**
+         * @brief Get the divisor applied to width and height
+         * @return Scale factor
+         */
+        int getFactor() const;
+
+        /**
+         * @brief Check whether a pixel format can be scaled
+         * @param format Source pixel format
+         * @return true for the 8-bit interleaved formats (YUV422_8, BGRA_8, GRAY_8, RGB_8)
+         */
+        static bool supports(PixelFormat format);
+
+        /**
+         * @brief Get the size of a scaled frame
+         * @param format Pixel format of the frame
+         * @param width Source width in pixels
+         * @param height Source height in pixels
+         * @param outputWidth Output width in pixels
+         * @param outputHeight Output height in pixels
+         * @return Output size in bytes, 0 if the frame is smaller than one block
+         */
+        size_t getOutputSize(PixelFormat format, int width, int height, int &outputWidth, int &outputHeight) const;
+
+        /**
+         * @brief Scale a frame
+         *
+         * Frame ID, timestamps and metadata are carried over, with the
+         * metadata dimensions updated to the output size.
+         *
+         * @param input Source frame
+         * @param output Destination buffer, nullptr to allocate a pooled frame
+         * @param outputSize Size of @p output in bytes
+         * @return Scaled frame (wrapping @p output if given), nullptr if unsupported or too small
+         */
+        std::shared_ptr<Frame> scale(const Frame &input, void *output = nullptr, size_t outputSize = 0);
+
+        /**
+         * @brief Get the name of the instruction set the vertical pass runs on
+         * @return "avx2", "neon" or "scalar"
+         */
+        static const char *getKernelName();
+
+    private:
+        int factor_;
+        std::vector<uint16_t> rowSums_; // Column sums of the block rows being reduced
+    };
+} // namespace medical::imaging
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "frame/pixel_format.h"
+
+namespace medical::imaging {
+    /**
+     * @struct ImageStatistics
+     * @brief Luminance statistics of one frame, as stored in the binary metadata record
+     */
+    struct ImageStatistics {
+        static constexpr size_t HISTOGRAM_BINS = 16;
+
+        uint32_t pixelCount = 0;                // Luminance samples the statistics cover
+        float meanLuminance = 0.0f;             // Mean luminance (0.0-1.0 of the format's full scale)
+        float luminanceVariance = 0.0f;         // Variance of the luminance, on the same scale
+        float saturatedFraction = 0.0f;         // Fraction of samples at the top code of the format (0.0-1.0)
+        float signalToNoiseRatio = 0.0f;        // 20 log10(mean / standard deviation) in dB, 0 for a flat frame
+        uint32_t histogram[HISTOGRAM_BINS] = {}; // Samples per sixteenth of the luminance range
+    };
+
+    /**
+     * @class FrameStatistics
+     * @brief Accumulates luminance statistics over a payload, optionally while copying it
+     *
+     * Quality monitoring and auto-gain only need a histogram and a few
+     * moments, and the writer already streams every byte of the payload
+     * into the ring. copy() walks the payload in chunks small enough to
+     * stay in L1: each chunk is read for the statistics and then copied
+     * out of the cache, so the frame comes from memory once.
+     *
+     * Every format is reduced to 8-bit luma first: Y for the YUV formats,
+     * BT.709 weights for RGB, the top bits for 10-bit samples. That loop
+     * has no dependencies between pixels and vectorizes; the histogram is
+     * spread over four interleaved sub-histograms so that runs of equal
+     * values do not serialize on one counter. Mean and variance come from
+     * the 256-bin histogram, exactly. The SNR is the speckle estimate
+     * mean over standard deviation, which suits B-mode images; it is 0
+     * for a flat frame.
+     *
+     * Packed v210, r210 and R12B captures are not supported. Chunks given
+     * to add() and copy() must hold whole pixel blocks, except the last.
+     */
+    class FrameStatistics {
+    public:
+        /**
+         * @brief Bytes accumulated and copied at a time, a multiple of every supported block size
+         */
+        static constexpr size_t CHUNK_BYTES = 48 * 1024;
+
+        /**
+         * @brief Constructor
+         * @param format Pixel format of the payload
+         * @param width Frame width in pixels
+         * @param height Frame height in pixels
+         */
+        FrameStatistics(PixelFormat format, uint32_t width, uint32_t height);
+
+        /**
+         * @brief Check whether statistics can be computed for the format
+         * @param format Pixel format
+         * @return true for YUV, GRAY8, BGRA, RGB24, YUV422P16 and RGB48
+         */
+        static bool isSupported(PixelFormat format);
+
+        /**
+         * @brief Check whether this accumulator computes anything
+         * @return true if the format is supported
+         */
+        bool isSupported() const;
+
+        /**
+         * @brief Accumulate the next bytes of the payload
+         * @param data Bytes following the ones added so far
+         * @param size Number of bytes
+         */
+        void add(const void *data, size_t size);
+
+        /**
+         * @brief Accumulate the next bytes of the payload while copying them
+         * @param destination Destination buffer, must not overlap @p source
+         * @param source Bytes following the ones added so far
+         * @param size Number of bytes
+         * @param streaming Copy with non-temporal stores (followed by a store fence) instead of memcpy
+         */
+        void copy(void *destination, const void *source, size_t size, bool streaming);
+
+        /**
+         * @brief Get the statistics of everything added so far
+         * @return Statistics, all zero if nothing was accumulated
+         */
+        ImageStatistics finish() const;
+
+        /**
+         * @brief Compute the statistics of a whole payload
+         * @param data Payload
+         * @param size Payload size in bytes
+         * @param format Pixel format of the payload
+         * @param width Frame width in pixels
+         * @param height Frame height in pixels
+         * @param statistics Output parameter receiving the statistics
+         * @return true if the format is supported
+         */
+        static bool compute(const void *data, size_t size, PixelFormat format, uint32_t width, uint32_t height,
+                            ImageStatistics &statistics);
+
+    private:
+        PixelFormat format_;
+        size_t lumaBytes_;     // Bytes of the payload that carry luminance (the Y plane of planar formats)
+        size_t consumed_;      // Bytes of the payload added so far
+        uint32_t saturated_;   // Lowest 8-bit luma counted as saturated
+        uint32_t counts_[4][256];
+    };
+} // namespace medical::imaging
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace medical::imaging {
+    /**
+     * @enum PixelFormat
+     * @brief Pixel formats understood by the imaging pipeline
+     *
+     * The underlying values are the wire format codes stored in
+     * SharedMemory::FrameHeader::formatCode (see protocol.md).
+     */
+    enum class PixelFormat : uint32_t {
+        YUV422_8 = 0x01,   // 8-bit 4:2:2 YUV, UYVY ("2vuy"), 2 bytes per pixel
+        BGRA_8 = 0x02,     // 8-bit BGRA, 4 bytes per pixel
+        YUV422_10 = 0x03,  // 10-bit 4:2:2 YUV, v210 packing (6 pixels per 16 bytes)
+        RGB_10 = 0x04,     // 10-bit RGB, r210 packing, 4 bytes per pixel
+        RGB_12 = 0x05,     // 12-bit RGB, R12B packing (8 pixels per 36 bytes)
+        GRAY_8 = 0x06,     // 8-bit luminance only, 1 byte per pixel
+        RGB_8 = 0x07,      // 8-bit packed RGB (RGB24), 3 bytes per pixel
+        YUV422P_16 = 0x08, // 4:2:2 planar YUV, 16-bit samples holding 10-bit values, Y then U then V plane
+        RGB_16 = 0x09,     // Packed RGB, 16-bit samples holding 10-bit values (RGB48), 6 bytes per pixel
+        UNKNOWN = 0xFF     // Unrecognized format
+    };
+
+    /**
+     * @brief Compile-time description of a pixel format
+     *
+     * Packed formats store groups of pixels in fixed-size blocks; rowBytes()
+     * rounds a row up to whole blocks the way the capture hardware does.
+     */
+    template<PixelFormat F>
+    struct PixelFormatTraits;
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::YUV422_8> {
+        static constexpr const char *name = "YUV";
+        static constexpr uint32_t bitDepth = 8;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = true;
+        static constexpr uint32_t pixelsPerBlock = 2;
+        static constexpr uint32_t bytesPerBlock = 4;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::BGRA_8> {
+        static constexpr const char *name = "BGRA";
+        static constexpr uint32_t bitDepth = 8;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = false;
+        static constexpr uint32_t pixelsPerBlock = 1;
+        static constexpr uint32_t bytesPerBlock = 4;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::YUV422_10> {
+        static constexpr const char *name = "YUV10";
+        static constexpr uint32_t bitDepth = 10;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = true;
+        static constexpr uint32_t pixelsPerBlock = 6;
+        static constexpr uint32_t bytesPerBlock = 16;
+        static constexpr uint32_t blocksPerRowAlignment = 8; // v210 rows are padded to 48 pixels
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::RGB_10> {
+        static constexpr const char *name = "RGB10";
+        static constexpr uint32_t bitDepth = 10;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = false;
+        static constexpr uint32_t pixelsPerBlock = 1;
+        static constexpr uint32_t bytesPerBlock = 4;
+        static constexpr uint32_t blocksPerRowAlignment = 64; // r210 rows are padded to 64 pixels
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::RGB_12> {
+        static constexpr const char *name = "RGB12";
+        static constexpr uint32_t bitDepth = 12;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = false;
+        static constexpr uint32_t pixelsPerBlock = 8;
+        static constexpr uint32_t bytesPerBlock = 36;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::GRAY_8> {
+        static constexpr const char *name = "GRAY8";
+        static constexpr uint32_t bitDepth = 8;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = false;
+        static constexpr uint32_t pixelsPerBlock = 1;
+        static constexpr uint32_t bytesPerBlock = 1;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::RGB_8> {
+        static constexpr const char *name = "RGB24";
+        static constexpr uint32_t bitDepth = 8;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = false;
+        static constexpr uint32_t pixelsPerBlock = 1;
+        static constexpr uint32_t bytesPerBlock = 3;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    // A block is two pixels across the three planes: two Y samples, one U and one V
+    template<>
+    struct PixelFormatTraits<PixelFormat::YUV422P_16> {
+        static constexpr const char *name = "YUV422P16";
+        static constexpr uint32_t bitDepth = 10;
+        static constexpr uint32_t planes = 3;
+        static constexpr bool isYuv = true;
+        static constexpr uint32_t pixelsPerBlock = 2;
+        static constexpr uint32_t bytesPerBlock = 8;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    template<>
+    struct PixelFormatTraits<PixelFormat::RGB_16> {
+        static constexpr const char *name = "RGB48";
+        static constexpr uint32_t bitDepth = 10;
+        static constexpr uint32_t planes = 1;
+        static constexpr bool isYuv = false;
+        static constexpr uint32_t pixelsPerBlock = 1;
+        static constexpr uint32_t bytesPerBlock = 6;
+        static constexpr uint32_t blocksPerRowAlignment = 1;
+    };
+
+    /**
+     * @brief Runtime view of PixelFormatTraits for code that is not specialized per format
+     */
+    struct PixelFormatInfo {
+        PixelFormat format;
+        const char *name;
+        uint32_t bitDepth;
+        uint32_t planes;
+        bool isYuv;
+        uint32_t pixelsPerBlock;
+        uint32_t bytesPerBlock;
+        uint32_t blocksPerRowAlignment;
+
+        /**
+         * @brief Bytes in one row of the given width, including block padding
+         * @param width Row width in pixels
+         * @return Row size in bytes, 0 for unknown formats
+         */
+        constexpr size_t rowBytes(size_t width) const {
+            if (pixelsPerBlock == 0) {
+                return 0;
+            }
+            size_t blocks = (width + pixelsPerBlock - 1) / pixelsPerBlock;
+            blocks = (blocks + blocksPerRowAlignment - 1) / blocksPerRowAlignment * blocksPerRowAlignment;
+            return blocks * bytesPerBlock;
+        }
+
+        /**
+         * @brief Bytes needed for a full frame
+         * @param width Frame width in pixels
+         * @param height Frame height in pixels
+         * @return Frame size in bytes, 0 for unknown formats
+         */
+        constexpr size_t frameBytes(size_t width, size_t height) const {
+            return rowBytes(width) * height;
+        }
+    };
+
+    template<PixelFormat F>
+    constexpr PixelFormatInfo makePixelFormatInfo() {
+        using Traits = PixelFormatTraits<F>;
+        return {F, Traits::name, Traits::bitDepth, Traits::planes, Traits::isYuv,
+                Traits::pixelsPerBlock, Traits::bytesPerBlock, Traits::blocksPerRowAlignment};
+    }
+
+    /**
+     * @brief Look up the description of a pixel format
+     * @param format Pixel format
+     * @return Format description; UNKNOWN yields zero sizes and the name "Unknown"
+     */
+    constexpr PixelFormatInfo getPixelFormatInfo(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::YUV422_8: return makePixelFormatInfo<PixelFormat::YUV422_8>();
+            case PixelFormat::BGRA_8: return makePixelFormatInfo<PixelFormat::BGRA_8>();
+            case PixelFormat::YUV422_10: return makePixelFormatInfo<PixelFormat::YUV422_10>();
+            case PixelFormat::RGB_10: return makePixelFormatInfo<PixelFormat::RGB_10>();
+            case PixelFormat::RGB_12: return makePixelFormatInfo<PixelFormat::RGB_12>();
+            case PixelFormat::GRAY_8: return makePixelFormatInfo<PixelFormat::GRAY_8>();
+            case PixelFormat::RGB_8: return makePixelFormatInfo<PixelFormat::RGB_8>();
+            case PixelFormat::YUV422P_16: return makePixelFormatInfo<PixelFormat::YUV422P_16>();
+            case PixelFormat::RGB_16: return makePixelFormatInfo<PixelFormat::RGB_16>();
+            case PixelFormat::UNKNOWN: break;
+        }
+        return {PixelFormat::UNKNOWN, "Unknown", 0, 0, false, 0, 0, 1};
+    }
+
+    /**
+     * @brief Canonical name of a pixel format (the strings used in configuration files)
+     * @param format Pixel format
+     * @return Format name
+     */
+    constexpr const char *toString(PixelFormat format) {
+        return getPixelFormatInfo(format).name;
+    }
+
+    /**
+     * @brief Parse a pixel format name, accepting the legacy aliases used across the service
+     * @param name Format name such as "YUV", "YUV422", "BGRA" or "RGB10"
+     * @return Matching format, UNKNOWN if the name is not recognized
+     */
+    constexpr PixelFormat pixelFormatFromString(std::string_view name) {
+        if (name == "YUV" || name == "YUV422") {
+            return PixelFormat::YUV422_8;
+        }
+        if (name == "BGRA" || name == "RGB" || name == "RGBA") {
+            return PixelFormat::BGRA_8;
+        }
+        if (name == "YUV10" || name == "YUV422_10") {
+            return PixelFormat::YUV422_10;
+        }
+        if (name == "RGB10") {
+            return PixelFormat::RGB_10;
+        }
+        if (name == "RGB12") {
+            return PixelFormat::RGB_12;
+        }
+        if (name == "GRAY8" || name == "Y8") {
+            return PixelFormat::GRAY_8;
+        }
+        if (name == "RGB24") {
+            return PixelFormat::RGB_8;
+        }
+        if (name == "YUV422P16" || name == "YUV16") {
+            return PixelFormat::YUV422P_16;
+        }
+        if (name == "RGB48" || name == "RGB16") {
+            return PixelFormat::RGB_16;
+        }
+        return PixelFormat::UNKNOWN;
+    }
+
+    /**
+     * @brief Convert a wire format code (FrameHeader::formatCode) to a pixel format
+     * @param code Format code read from shared memory
+     * @return Matching format, UNKNOWN for unrecognized codes
+     */
+    constexpr PixelFormat pixelFormatFromCode(uint32_t code) {
+        switch (static_cast<PixelFormat>(code)) {
+            case PixelFormat::YUV422_8:
+            case PixelFormat::BGRA_8:
+            case PixelFormat::YUV422_10:
+            case PixelFormat::RGB_10:
+            case PixelFormat::RGB_12:
+            case PixelFormat::GRAY_8:
+            case PixelFormat::RGB_8:
+            case PixelFormat::YUV422P_16:
+            case PixelFormat::RGB_16:
+                return static_cast<PixelFormat>(code);
+            case PixelFormat::UNKNOWN:
+                break;
+        }
+        return PixelFormat::UNKNOWN;
+    }
+
+    /**
+     * @brief Call a generic functor with the pixel format as a compile-time constant
+     *
+     * Lets per-format kernels be written once as a template over PixelFormatTraits
+     * and selected with a single switch per frame instead of branching per pixel:
+     *
+     *     dispatchPixelFormat(frame->getPixelFormat(), [&](auto format) {
+     *         using Traits = PixelFormatTraits<decltype(format)::value>;
+     *         ...
+     *     });
+     *
+     * @param format Runtime pixel format
+     * @param fn Functor taking a std::integral_constant<PixelFormat, F>
+     * @return true if the format was known and @p fn was called
+     */
+    template<typename Fn>
+    bool dispatchPixelFormat(PixelFormat format, Fn &&fn) {
+        switch (format) {
+            case PixelFormat::YUV422_8:
+                fn(std::integral_constant<PixelFormat, PixelFormat::YUV422_8>{});
+                return true;
+            case PixelFormat::BGRA_8:
+                fn(std::integral_constant<PixelFormat, PixelFormat::BGRA_8>{});
+                return true;
+            case PixelFormat::YUV422_10:
+                fn(std::integral_constant<PixelFormat, PixelFormat::YUV422_10>{});
+                return true;
+            case PixelFormat::RGB_10:
+                fn(std::integral_constant<PixelFormat, PixelFormat::RGB_10>{});
+                return true;
+            case PixelFormat::RGB_12:
+                fn(std::integral_constant<PixelFormat, PixelFormat::RGB_12>{});
+                return true;
+            case PixelFormat::GRAY_8:
+                fn(std::integral_constant<PixelFormat, PixelFormat::GRAY_8>{});
+                return true;
+            case PixelFormat::RGB_8:
+                fn(std::integral_constant<PixelFormat, PixelFormat::RGB_8>{});
+                return true;
+            case PixelFormat::YUV422P_16:
+                fn(std::integral_constant<PixelFormat, PixelFormat::YUV422P_16>{});
+                return true;
+            case PixelFormat::RGB_16:
+                fn(std::integral_constant<PixelFormat, PixelFormat::RGB_16>{});
+                return true;
+            case PixelFormat::UNKNOWN:
+                break;
+        }
+        return false;
+    }
+
+    static_assert(getPixelFormatInfo(PixelFormat::YUV422_8).frameBytes(3840, 2160) == 3840 * 2160 * 2,
+                  "UYVY is 2 bytes per pixel");
+    static_assert(getPixelFormatInfo(PixelFormat::YUV422_10).rowBytes(1920) == 5120,
+                  "v210 rows are padded to 48-pixel groups of 128 bytes");
+    static_assert(getPixelFormatInfo(PixelFormat::RGB_10).rowBytes(1920) == 7680, "r210 is 4 bytes per pixel");
+    static_assert(getPixelFormatInfo(PixelFormat::YUV422P_16).frameBytes(1920, 1080) == 1920 * 1080 * 4,
+                  "Planar 16-bit 4:2:2 is 2 bytes of Y and 2 of chroma per pixel");
+} // namespace medical::imaging
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace medical::imaging {
+    /**
+     * @brief Opaque CUDA IPC memory handle (cudaIpcMemHandle_t)
+     *
+     * Kept as raw bytes so headers and the shared memory protocol do not
+     * depend on the CUDA toolkit.
+     */
+    struct GpuIpcHandle {
+        uint8_t bytes[64];
+    };
+
+    /**
+     * @class GpuMemory
+     * @brief Thin wrapper over the CUDA runtime calls the service needs
+     *
+     * Builds without CUDA compile to stubs: isAvailable() returns false and
+     * every allocation, copy or registration fails, so callers only need to
+     * check the result. The calling thread's current device is used unless
+     * a device index is given.
+     */
+    class GpuMemory {
+    public:
+        /**
+         * @brief Check whether the build has CUDA support and a device is present
+         * @return true if GPU buffers can be allocated
+         */
+        static bool isAvailable();
+
+        /**
+         * @brief Get the number of CUDA devices
+         * @return Device count, 0 without CUDA
+         */
+        static int getDeviceCount();
+
+        /**
+         * @brief Get the name of a CUDA device
+         * @param device Device index
+         * @return Device name, empty if unavailable
+         */
+        static std::string getDeviceName(int device);
+
+        /**
+         * @brief Make a device current for the calling thread
+         * @param device Device index
+         * @return true on success
+         */
+        static bool setDevice(int device);
+
+        /**
+         * @brief Allocate device memory
+         * @param size Size in bytes
+         * @return Device pointer, nullptr on failure
+         */
+        static void *allocate(size_t size);
+
+        /**
+         * @brief Free memory from allocate()
+         * @param devicePointer Device pointer, nullptr is ignored
+         */
+        static void release(void *devicePointer);
+
+        /**
+         * @brief Copy host memory to the device and wait for it
+         * @param devicePointer Destination on the device
+         * @param hostPointer Source on the host
+         * @param size Bytes to copy
+         * @return true on success
+         */
+        static bool copyToDevice(void *devicePointer, const void *hostPointer, size_t size);
+
+        /**
+         * @brief Copy device memory to the host and wait for it
+         * @param hostPointer Destination on the host
+         * @param devicePointer Source on the device
+         * @param size Bytes to copy
+         * @return true on success
+         */
+        static bool copyToHost(void *hostPointer, const void *devicePointer, size_t size);
+
+        /**
+         * @brief Copy between two device buffers and wait for it
+         * @param destination Destination on the device
+         * @param source Source on the device
+         * @param size Bytes to copy
+         * @return true on success
+         */
+        static bool copyOnDevice(void *destination, const void *source, size_t size);
+
+        /**
+         * @brief Page-lock an existing host mapping so DMA reads it directly (cudaHostRegister)
+         *
+         * Pages are locked as a side effect, so the mapping counts against
+         * RLIMIT_MEMLOCK like mlock() does.
+         *
+         * @param hostPointer Start of the mapping
+         * @param size Size of the mapping
+         * @return true on success
+         */
+        static bool registerHost(void *hostPointer, size_t size);
+
+        /**
+         * @brief Undo registerHost()
+         * @param hostPointer Start of the mapping passed to registerHost()
+         */
+        static void unregisterHost(void *hostPointer);
+
+        /**
+         * @brief Export device memory to other processes
+         * @param devicePointer Pointer from allocate()
+         * @param handle Output parameter receiving the handle
+         * @return true on success
+         */
+        static bool getIpcHandle(void *devicePointer, GpuIpcHandle &handle);
+
+        /**
+         * @brief Get the error of the last failed call on this thread
+         * @return Error description, empty if none
+         */
+        static std::string getLastError();
+    };
+} // namespace medical::imaging
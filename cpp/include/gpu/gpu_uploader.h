@@ -0,0 +1,187 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "communication/shared_memory.h"
+#include "gpu/gpu_memory.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @brief Payload of every frame on a GPU upload ring
+     *
+     * Describes where the frame is on the device. Consumers open memHandle
+     * with cudaIpcOpenMemHandle() once per (ownerPid, allocationEpoch,
+     * bufferIndex) and keep the mapping; the ring's FrameHeader keeps the
+     * frame ID, timestamps, geometry and metadata of the raw frame.
+     */
+    struct GpuFrameDescriptor {
+        char magic[4];            // "MVG1"
+        uint16_t version;         // Descriptor version (1)
+        uint16_t headerSize;      // Size of this structure (128)
+        int32_t device;           // CUDA device index in the service process
+        uint32_t bufferIndex;     // Device buffer holding the frame
+        uint32_t bufferCount;     // Buffers in rotation
+        uint32_t ownerPid;        // Process the IPC handle belongs to
+        uint64_t allocationEpoch; // Incremented whenever the buffers are reallocated
+        uint64_t uploadSequence;  // Upload number; the buffer is reused by upload uploadSequence + bufferCount
+        uint64_t dataSize;        // Bytes of the frame in the buffer
+        uint64_t bufferSize;      // Capacity of the buffer
+        uint64_t frameId;         // Frame the buffer holds
+        GpuIpcHandle memHandle;   // cudaIpcMemHandle_t of the buffer
+    };
+
+    static_assert(sizeof(GpuFrameDescriptor) == 128, "GpuFrameDescriptor is part of the shared memory protocol");
+
+    /**
+     * @class GpuUploader
+     * @brief Uploads the frames of one ring to the GPU and publishes where they landed
+     *
+     * Attaches to the source ring as a lossy reader and page-locks its
+     * mapping with cudaHostRegister(), so frames are DMA'd straight from the
+     * ring instead of being staged through pageable memory. Each frame is
+     * copied with cudaMemcpyAsync() on the uploader's own stream into the
+     * next of a rotating set of device buffers; once the copy has completed
+     * and the slot is confirmed intact, a GpuFrameDescriptor is published to
+     * the output ring. Consumers get the frame already on the GPU.
+     *
+     * A frame that the writer overwrites while it is being uploaded, or that
+     * the output ring cannot accept, is left out. Without CUDA in the build,
+     * start() returns NOT_SUPPORTED.
+     */
+    class GpuUploader {
+    public:
+        /**
+         * @brief Status codes for uploader operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Uploader already running
+            NOT_RUNNING,       // Uploader not running
+            CONNECTION_FAILED, // Could not attach to the source ring
+            INVALID_ARGUMENT,  // Invalid argument provided
+            NOT_SUPPORTED,     // Built without CUDA or no device present
+            GPU_ERROR          // A CUDA call failed
+        };
+
+        /**
+         * @brief Uploader configuration
+         */
+        struct Config {
+            int device;             // CUDA device to upload to
+            uint32_t bufferCount;   // Device buffers in rotation
+            bool pinSource;         // Page-lock the source ring with cudaHostRegister
+            int cpuCore;            // CPU core for the uploader thread (-1 for no affinity)
+            std::string threadRole; // Role the thread is placed under by the ThreadLayout
+
+            // Constructor with default values
+            Config() : device(0),
+                       bufferCount(4),
+                       pinSource(true),
+                       cpuCore(-1),
+                       threadRole("gpu-upload") {
+            }
+        };
+
+        /**
+         * @brief Uploader statistics
+         */
+        struct Statistics {
+            uint64_t framesUploaded;  // Frames published to the output ring
+            uint64_t bytesUploaded;   // Bytes copied to the device for those frames
+            uint64_t framesTorn;      // Frames the writer overwrote while they were being uploaded
+            uint64_t framesDropped;   // Frames the GPU or the output ring could not accept
+            uint64_t framesSkipped;   // Frames lost because the writer lapped the uploader
+            uint64_t lagFrames;       // Frames published but not yet picked up by the uploader
+            uint64_t allocationEpoch; // Times the device buffers were (re)allocated
+            size_t bufferSize;        // Capacity of each device buffer
+            bool sourcePinned;        // The source ring is registered with CUDA
+        };
+
+        /**
+         * @brief Constructor
+         * @param config Uploader configuration
+         */
+        explicit GpuUploader(const Config &config);
+
+        /**
+         * @brief Destructor, stops uploading and frees the device buffers
+         */
+        ~GpuUploader();
+
+        GpuUploader(const GpuUploader &) = delete;
+        GpuUploader &operator=(const GpuUploader &) = delete;
+
+        /**
+         * @brief Attach to a ring and start uploading its frames
+         * @param sourceConfig Configuration of the ring to upload; create and readerMode are overridden
+         * @param output Ring the descriptors are published to (server side)
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &sourceConfig, const std::shared_ptr<SharedMemory> &output);
+
+        /**
+         * @brief Stop uploading, detach from the source ring and free the device buffers
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the uploader is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the uploader configuration
+         * @return Uploader configuration
+         */
+        const Config &getConfig() const;
+
+        /**
+         * @brief Get uploader statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get uploader statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+        /**
+         * @brief Get the histogram of host-to-device copy times
+         * @return Histogram of upload times in nanoseconds
+         */
+        const LatencyHistogram &getUploadTimeHistogram() const;
+
+    private:
+        struct Device;
+
+        void uploaderThread();
+
+        Config config_;
+        std::shared_ptr<SharedMemory> source_;
+        std::shared_ptr<SharedMemory> output_;
+        std::unique_ptr<Device> device_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+
+        // Updated by the uploader thread, read by anyone
+        std::atomic<uint64_t> framesUploaded_;
+        std::atomic<uint64_t> bytesUploaded_;
+        std::atomic<uint64_t> framesTorn_;
+        std::atomic<uint64_t> framesDropped_;
+        std::atomic<uint64_t> allocationEpoch_;
+        std::atomic<size_t> bufferSize_;
+        std::atomic<bool> sourcePinned_;
+        LatencyHistogram uploadTimeHistogram_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "communication/shared_memory.h"
+#include "recording/recording_format.h"
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @class FrameRecorder
+     * @brief Records frames from a shared memory ring to an indexed recording file
+     *
+     * Attaches to the ring as a lossy reader, so a slow disk makes the
+     * recorder skip frames instead of back-pressuring capture, and writes
+     * the frames with io_uring and O_DIRECT on its own thread, keeping at
+     * most Config::queueDepth writes in flight and the page cache untouched.
+     *
+     * The file uses the layout in recording_format.h: every frame is a
+     * FrameHeader and metadata block followed by the payload padded to
+     * IO_ALIGNMENT, and the frame index is appended when recording stops.
+     * Payloads that already satisfy the O_DIRECT alignment rules are written
+     * straight from the ring; others go through an aligned bounce buffer.
+     * RecordingReader reads the result back with random access.
+     *
+     * startClip() writes frames handed over by the caller instead, such as
+     * the last seconds of the ring pinned with SharedMemory::pinFrames().
+     */
+    class FrameRecorder {
+    public:
+        /**
+         * @brief Status codes for recorder operations
+         */
+        enum class Status {
+            OK,                // Operation completed successfully
+            ALREADY_RUNNING,   // Recorder already running
+            NOT_RUNNING,       // Recorder not running
+            CONNECTION_FAILED, // Could not attach to the ring
+            IO_ERROR,          // Could not open the output file
+            INVALID_ARGUMENT   // Invalid argument provided
+        };
+
+        /**
+         * @brief Recorder configuration
+         */
+        struct Config {
+            std::string outputPath; // File the frames are written to (truncated on start)
+            size_t queueDepth;      // Maximum number of writes in flight
+            bool useDirectIo;       // Open the file with O_DIRECT (falls back if unsupported)
+            int cpuCore;            // CPU core for the recorder thread (-1 for no affinity)
+
+            // Constructor with default values
+            Config() : outputPath(""),
+                       queueDepth(8),
+                       useDirectIo(true),
+                       cpuCore(-1) {
+            }
+        };
+
+        /**
+         * @brief Recorder statistics
+         */
+        struct Statistics {
+            uint64_t framesRecorded; // Frames whose write completed
+            uint64_t bytesWritten;   // Bytes written to the file, padding included
+            uint64_t framesCopied;   // Frames that went through a bounce buffer
+            uint64_t framesTorn;     // Frames the writer overwrote while they were being recorded (left out of the index)
+            uint64_t framesSkipped;  // Frames lost because the writer lapped the recorder
+            uint64_t writeErrors;    // Failed or short writes
+            uint64_t lagFrames;      // Frames published but not yet picked up by the recorder
+            uint64_t inFlight;       // Writes currently queued in the kernel
+            bool directIo;           // Whether the file is open with O_DIRECT
+            bool ioUring;            // Whether writes go through io_uring
+        };
+
+        /**
+         * @brief Alignment of buffers, lengths and offsets for O_DIRECT
+         */
+        static constexpr size_t IO_ALIGNMENT = RECORDING_ALIGNMENT;
+
+        /**
+         * @brief Constructor
+         * @param config Recorder configuration
+         */
+        explicit FrameRecorder(const Config &config);
+
+        /**
+         * @brief Destructor, stops recording
+         */
+        ~FrameRecorder();
+
+        FrameRecorder(const FrameRecorder &) = delete;
+        FrameRecorder &operator=(const FrameRecorder &) = delete;
+
+        /**
+         * @brief Attach to a ring and start recording
+         * @param ringConfig Configuration of the ring to record; create and readerMode are overridden
+         * @return Status code indicating success or failure
+         */
+        Status start(const SharedMemory::Config &ringConfig);
+
+        /**
+         * @brief Write a given set of frames, such as a clip from SharedMemory::pinFrames(), to the file
+         *
+         * The frames are written in order on the recorder thread like
+         * recorded ones, and each is dropped as soon as its write completes,
+         * which hands a pinned payload back to the ring's writer. The file is
+         * complete once isFinished() returns true; stop() waits for the rest
+         * of the clip instead of cutting it short.
+         *
+         * @param frames Frames to write, oldest first
+         * @param ringName Ring the frames came from, stored in the file header
+         * @return Status code indicating success or failure
+         */
+        Status startClip(std::vector<std::shared_ptr<Frame>> frames, const std::string &ringName);
+
+        /**
+         * @brief Stop recording, wait for in-flight writes, append the index and flush the file
+         * @return Status code indicating success or failure
+         */
+        Status stop();
+
+        /**
+         * @brief Check if the recorder is running
+         * @return true if running, false otherwise
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Check if a clip is completely written
+         * @return true once every frame given to startClip() is in the file and the index is written
+         */
+        bool isFinished() const;
+
+        /**
+         * @brief Get recorder statistics
+         * @return Statistics structure
+         */
+        Statistics getStatistics() const;
+
+        /**
+         * @brief Get recorder statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatisticsMap() const;
+
+        /**
+         * @brief Get the histogram of submit-to-completion write times
+         * @return Histogram of write latencies in nanoseconds
+         */
+        const LatencyHistogram &getWriteLatencyHistogram() const;
+
+        /**
+         * @brief Get the number of file bytes one frame occupies
+         * @param dataSize Frame payload size in bytes
+         * @return Record header block plus the payload rounded up to IO_ALIGNMENT
+         */
+        static constexpr size_t recordStride(size_t dataSize) {
+            return static_cast<size_t>(recordingRecordStride(dataSize));
+        }
+
+    private:
+        struct Impl;
+
+        Status openOutput(Impl &impl) const;
+        Status prepareOutput(Impl &impl, const std::string &ringName) const;
+        void launch(std::unique_ptr<Impl> impl);
+        void finishOutput();
+        void recorderThread();
+
+        Config config_;
+        std::unique_ptr<Impl> impl_;
+        std::thread thread_;
+        std::atomic<bool> isRunning_;
+        std::atomic<bool> stopRequested_;
+        std::atomic<bool> finished_;
+
+        // Updated by the recorder thread, read by anyone
+        std::atomic<uint64_t> framesRecorded_;
+        std::atomic<uint64_t> bytesWritten_;
+        std::atomic<uint64_t> framesCopied_;
+        std::atomic<uint64_t> framesTorn_;
+        std::atomic<uint64_t> writeErrors_;
+        std::atomic<uint64_t> inFlight_;
+        LatencyHistogram writeLatencyHistogram_;
+    };
+} // namespace medical::imaging
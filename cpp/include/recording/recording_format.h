@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "communication/shared_memory.h"
+
+namespace medical::imaging {
+    /**
+     * @brief Layout of an indexed recording file
+     *
+     * A recording is a RecordingFileHeader block, then one record per frame,
+     * then a packed array of RecordingIndexEntry. Every section starts on a
+     * RECORDING_ALIGNMENT boundary so the file can be written with O_DIRECT
+     * and mmap()ed with page-aligned payloads.
+     *
+     * A record is laid out like a ring slot: a SharedMemory::FrameHeader, the
+     * optional SharedMemory::FrameMetadataRecord at FrameHeader::metadataOffset,
+     * zero padding up to RECORDING_RECORD_HEADER_SIZE, then the payload padded
+     * to the alignment. The index is only written when the recording is closed;
+     * while it is missing (indexOffset == 0) readers rebuild it by walking the
+     * records. All integers are little-endian.
+     */
+
+    /**
+     * @brief Alignment of every section, record and payload in the file
+     */
+    constexpr size_t RECORDING_ALIGNMENT = 4096;
+
+    /**
+     * @brief Bytes reserved in front of each payload for its FrameHeader and metadata record
+     */
+    constexpr size_t RECORDING_RECORD_HEADER_SIZE = RECORDING_ALIGNMENT;
+
+    /**
+     * @brief Current version of the recording layout
+     */
+    constexpr uint32_t RECORDING_FORMAT_VERSION = 1;
+
+    /**
+     * @brief File magic, "MIVIREC" followed by a NUL
+     */
+    constexpr char RECORDING_MAGIC[8] = {'M', 'I', 'V', 'I', 'R', 'E', 'C', '\0'};
+
+    /**
+     * @brief Recording flag bits stored in RecordingFileHeader::flags
+     */
+    constexpr uint32_t RECORDING_FLAG_COMPLETE = 0x01; // The index and frame count are final
+
+    /**
+     * @brief Fixed header at offset 0, padded to RECORDING_ALIGNMENT in the file
+     */
+    struct alignas(8) RecordingFileHeader {
+        char magic[8];            // RECORDING_MAGIC
+        uint32_t version;         // RECORDING_FORMAT_VERSION the file was written with
+        uint32_t flags;           // RECORDING_FLAG_* bits
+        uint64_t frameCount;      // Frames in the index (0 until the recording is closed)
+        uint64_t dataOffset;      // Offset of the first record
+        uint64_t indexOffset;     // Offset of the index (0 until the recording is closed)
+        uint32_t indexEntrySize;  // sizeof(RecordingIndexEntry) of the writer
+        uint32_t recordHeaderSize; // RECORDING_RECORD_HEADER_SIZE of the writer
+        uint64_t createdTimeNs;   // Wall-clock time the recording started (ns since epoch)
+        char ringName[64];        // NUL-terminated name of the recorded shared memory ring
+        uint8_t reserved[136];    // Reserved for future use
+    };
+
+    /**
+     * @brief One entry of the packed frame index
+     */
+    struct alignas(8) RecordingIndexEntry {
+        uint64_t sequenceNumber;  // Ring sequence number of the frame
+        uint64_t frameId;         // Frame identifier
+        uint64_t timestamp;       // Frame timestamp (nanoseconds since epoch)
+        uint64_t captureTimeNs;   // Hardware capture time on CLOCK_MONOTONIC (0 if unknown)
+        uint64_t recordOffset;    // File offset of the record's FrameHeader
+        uint32_t dataSize;        // Payload size in bytes
+        uint32_t formatCode;      // Format identifier code
+        uint32_t width;           // Frame width in pixels
+        uint32_t height;          // Frame height in pixels
+        uint32_t bytesPerPixel;   // Bytes per pixel
+        uint32_t flags;           // Frame flags (same bits as FrameHeader::flags)
+    };
+
+    static_assert(sizeof(RecordingFileHeader) == 256, "RecordingFileHeader layout changed");
+    static_assert(sizeof(RecordingIndexEntry) == 64, "RecordingIndexEntry layout changed");
+    static_assert(sizeof(SharedMemory::FrameHeader) + sizeof(SharedMemory::FrameMetadataRecord) <=
+                  RECORDING_RECORD_HEADER_SIZE, "Frame header and metadata must fit in front of the payload");
+
+    /**
+     * @brief Round a size up to RECORDING_ALIGNMENT
+     * @param size Size in bytes
+     * @return Aligned size
+     */
+    constexpr uint64_t recordingAlign(uint64_t size) {
+        return (size + RECORDING_ALIGNMENT - 1) / RECORDING_ALIGNMENT * RECORDING_ALIGNMENT;
+    }
+
+    /**
+     * @brief Get the number of file bytes one record occupies
+     * @param dataSize Frame payload size in bytes
+     * @return Record header block plus the aligned payload
+     */
+    constexpr uint64_t recordingRecordStride(uint64_t dataSize) {
+        return RECORDING_RECORD_HEADER_SIZE + recordingAlign(dataSize);
+    }
+
+    /**
+     * @brief Check a file header for a recording this code can read
+     * @param header Header read from offset 0
+     * @return true if the magic, version and section sizes are understood
+     */
+    inline bool isValidRecordingHeader(const RecordingFileHeader &header) {
+        return std::memcmp(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) == 0 &&
+               header.version == RECORDING_FORMAT_VERSION &&
+               header.indexEntrySize == sizeof(RecordingIndexEntry) &&
+               header.recordHeaderSize == RECORDING_RECORD_HEADER_SIZE &&
+               header.dataOffset >= RECORDING_ALIGNMENT;
+    }
+} // namespace medical::imaging
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame/frame.h"
+#include "recording/recording_format.h"
+
+namespace medical::imaging {
+    /**
+     * @class RecordingReader
+     * @brief Random-access reader for recordings written by FrameRecorder
+     *
+     * Maps the whole file and hands out frames that view their payload inside
+     * the mapping, like SharedMemory hands out ring slots, so consumers written
+     * against the ring reader API can run over a recording unchanged. Seeking to
+     * a frame number is O(1) and seeking to a capture time is a binary search of
+     * the index; neither touches the payloads in between.
+     *
+     * Recordings that were not closed cleanly have no index; it is rebuilt on
+     * open by walking the record headers, and the frames found so far are
+     * readable.
+     */
+    class RecordingReader {
+    public:
+        /**
+         * @brief Status codes for reader operations
+         */
+        enum class Status {
+            OK,               // Operation completed successfully
+            NOT_INITIALIZED,  // Recording not open
+            OPEN_FAILED,      // Could not open or map the file
+            INVALID_FORMAT,   // Not a recording, or a layout this code cannot read
+            OUT_OF_RANGE,     // Frame number or timestamp outside the recording
+            END_OF_RECORDING  // No frame after the cursor
+        };
+
+        /**
+         * @brief Constructor
+         * @param path Recording file to read
+         */
+        explicit RecordingReader(const std::string &path);
+
+        /**
+         * @brief Destructor; frames handed out keep the mapping alive
+         */
+        ~RecordingReader();
+
+        RecordingReader(const RecordingReader &) = delete;
+        RecordingReader &operator=(const RecordingReader &) = delete;
+
+        /**
+         * @brief Map the file and load or rebuild its index
+         * @return Status code indicating success or failure
+         */
+        Status open();
+
+        /**
+         * @brief Release the file; frames still held stay readable
+         */
+        void close();
+
+        /**
+         * @brief Check if the recording is open
+         * @return true if open() succeeded
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Check whether a file starts with a recording header
+         * @param path File to check
+         * @return true if the file is a recording
+         */
+        static bool isRecording(const std::string &path);
+
+        /**
+         * @brief Get the number of frames in the recording
+         * @return Frame count
+         */
+        uint64_t getFrameCount() const;
+
+        /**
+         * @brief Check whether the index was rebuilt because the recording was not closed
+         * @return true if the index was rebuilt on open
+         */
+        bool wasRecovered() const;
+
+        /**
+         * @brief Get the file header
+         * @return Header of the open recording
+         */
+        const RecordingFileHeader &getHeader() const;
+
+        /**
+         * @brief Get the index entry of a frame
+         * @param frameNumber Zero-based frame number
+         * @return Entry, nullptr if out of range
+         */
+        const RecordingIndexEntry *getIndexEntry(uint64_t frameNumber) const;
+
+        /**
+         * @brief Get a pointer to a frame's payload inside the mapping
+         * @param frameNumber Zero-based frame number
+         * @return Payload, nullptr if out of range
+         */
+        const void *getFrameData(uint64_t frameNumber) const;
+
+        /**
+         * @brief Get a frame by number (zero-copy)
+         * @param frameNumber Zero-based frame number
+         * @param frame Output frame viewing the payload in the mapping
+         * @return Status code indicating success or failure
+         */
+        Status readFrame(uint64_t frameNumber, std::shared_ptr<Frame> &frame) const;
+
+        /**
+         * @brief Read the frame at the cursor and advance it
+         * @param frame Output frame
+         * @return END_OF_RECORDING once every frame has been read
+         */
+        Status readNextFrame(std::shared_ptr<Frame> &frame);
+
+        /**
+         * @brief Read the last frame of the recording without moving the cursor
+         * @param frame Output frame
+         * @return Status code indicating success or failure
+         */
+        Status readLatestFrame(std::shared_ptr<Frame> &frame) const;
+
+        /**
+         * @brief Find the first frame captured at or after a time
+         *
+         * Uses the hardware capture time, or the frame timestamp for frames
+         * recorded without one.
+         *
+         * @param timeNs Time in nanoseconds on the clock of the recorded frames
+         * @param frameNumber Output frame number
+         * @return OUT_OF_RANGE if every frame is older
+         */
+        Status findFrameByTime(uint64_t timeNs, uint64_t &frameNumber) const;
+
+        /**
+         * @brief Move the cursor to a frame number
+         * @param frameNumber Frame readNextFrame() returns next
+         * @return Status code indicating success or failure
+         */
+        Status seek(uint64_t frameNumber);
+
+        /**
+         * @brief Move the cursor to the first frame captured at or after a time
+         * @param timeNs Time in nanoseconds, see findFrameByTime()
+         * @return Status code indicating success or failure
+         */
+        Status seekToTime(uint64_t timeNs);
+
+        /**
+         * @brief Get the cursor position
+         * @return Frame readNextFrame() returns next
+         */
+        uint64_t tell() const;
+
+        /**
+         * @brief Get recording statistics as key-value pairs
+         * @return Map of statistic name to value
+         */
+        std::map<std::string, std::string> getStatistics() const;
+
+    private:
+        struct Mapping;
+
+        // Rebuild the index of a recording that was not closed
+        void rebuildIndex();
+
+        // Time a frame is searched by
+        static uint64_t entryTime(const RecordingIndexEntry &entry);
+
+        std::string path_;
+        std::shared_ptr<Mapping> mapping_;
+        const RecordingFileHeader *header_;
+        const RecordingIndexEntry *index_;
+        uint64_t frameCount_;
+        std::vector<RecordingIndexEntry> rebuiltIndex_;
+        uint64_t cursor_;
+    };
+} // namespace medical::imaging
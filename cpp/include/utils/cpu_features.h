@@ -0,0 +1,56 @@
+#pragma once
+
+namespace medical::imaging {
+    /**
+     * @brief Runtime instruction set dispatch of the SIMD kernels
+     *
+     * Kernel files build their x86 variants with target attributes, so the
+     * binary runs on any x86-64 CPU, and pick one set of kernels per process
+     * with selectKernels(): the widest instruction set the CPU supports,
+     * falling back to scalar code. NEON is part of the AArch64 baseline and
+     * is chosen at compile time.
+     */
+    namespace cpu {
+        /**
+         * @brief Instruction set extensions the kernels are built for
+         */
+        struct Features {
+            bool avx2 = false;      // 256-bit integer vectors
+            bool avx512f = false;   // 512-bit vectors of 32 and 64-bit lanes
+            bool avx512bw = false;  // 512-bit vectors of 8 and 16-bit lanes
+        };
+
+        /**
+         * @brief Get the extensions of this CPU, detected on the first call
+         * @return All false on other architectures
+         */
+        inline const Features &features() {
+            static const Features detected = [] {
+                Features result;
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_cpu_init();
+                result.avx2 = __builtin_cpu_supports("avx2") != 0;
+                result.avx512f = __builtin_cpu_supports("avx512f") != 0;
+                result.avx512bw = __builtin_cpu_supports("avx512bw") != 0;
+#endif
+                return result;
+            }();
+            return detected;
+        }
+
+        /**
+         * @brief Pick the kernels of one file once per process
+         *
+         * Every call site passes its own lambda, so every call site keeps its
+         * own choice.
+         *
+         * @param select Returns the kernel set to use given the CPU's features
+         * @return The set select() returned on the first call
+         */
+        template<typename Select>
+        const auto &selectKernels(Select select) {
+            static const auto kernels = select(features());
+            return kernels;
+        }
+    } // namespace cpu
+} // namespace medical::imaging
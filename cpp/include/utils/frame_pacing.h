@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "utils/latency_histogram.h"
+
+namespace medical::imaging {
+    /**
+     * @enum DropCause
+     * @brief Where in the pipeline a frame was lost
+     */
+    enum class DropCause : uint8_t {
+        DEVICE,              // The device never delivered the input frame
+        BUFFER_POOL,         // The device skipped the input frame while its capture buffers were used up
+        PUBLISHER_LATE,      // The publish queue was full, the publisher fell behind the capture thread
+        RING_FULL,           // The raw ring refused the frame
+        READER_OVERWRITTEN   // A reader was lapped and the writer overwrote the frame before it was read
+    };
+
+    /**
+     * @class FramePacing
+     * @brief Frame interval jitter and per-cause drop accounting of one channel
+     *
+     * The capture thread hands every delivered frame to recordArrival().
+     * The device numbers its frames by input slot, so a step of more than
+     * one in the frame number is input the device never delivered. The
+     * interval between capture timestamps is compared with the nominal
+     * period of the mode: the jitter recorded is the distance to the
+     * nearest whole number of periods, so a dropped frame shows up as a
+     * drop and not as a jitter spike.
+     *
+     * The other stages count their own losses with recordDrop(); it is a
+     * relaxed atomic add and may be called from any thread.
+     */
+    class FramePacing {
+    public:
+        static constexpr size_t CAUSE_COUNT = 5;
+
+        /**
+         * @brief Set the frame rate of the current mode
+         * @param frameRate Frames per second, 0 if unknown (no jitter is recorded)
+         */
+        void setNominalRate(double frameRate);
+
+        /**
+         * @brief Get the frame rate of the current mode
+         * @return Frames per second, 0 if unknown
+         */
+        double getNominalRate() const;
+
+        /**
+         * @brief Account for a frame delivered by the device
+         *
+         * Called from the capture thread only.
+         *
+         * @param frameNumber Input slot number the device gave the frame
+         * @param captureTimeNs Capture timestamp of the frame
+         * @param bufferShortages Device count of frames captured without a free buffer
+         * @param cause Output parameter receiving the cause of the gap, if any
+         * @return Number of frames missing before this one
+         */
+        uint64_t recordArrival(uint32_t frameNumber, uint64_t captureTimeNs, uint64_t bufferShortages,
+                               DropCause &cause);
+
+        /**
+         * @brief Count frames lost by a stage
+         * @param cause Where the frames were lost
+         * @param frames Number of frames
+         */
+        void recordDrop(DropCause cause, uint64_t frames = 1) {
+            drops_[static_cast<size_t>(cause)].fetch_add(frames, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the number of frames lost to a cause
+         * @param cause Drop cause
+         * @return Frames lost since the last reset
+         */
+        uint64_t getDropCount(DropCause cause) const {
+            return drops_[static_cast<size_t>(cause)].load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the number of frames lost to any cause
+         * @return Frames lost since the last reset
+         */
+        uint64_t getTotalDropCount() const;
+
+        /**
+         * @brief Get the distribution of frame interval jitter in nanoseconds
+         * @return Histogram of the distance of each interval to a whole number of periods
+         */
+        const LatencyHistogram &getJitterHistogram() const {
+            return jitter_;
+        }
+
+        /**
+         * @brief Clear the counters and the jitter histogram
+         *
+         * May be called from any thread. The previous arrival is kept; a
+         * restarted capture numbers its frames from 0 again, which reads as
+         * a restart and not as a gap.
+         */
+        void reset();
+
+        /**
+         * @brief Get the name of a drop cause
+         * @param cause Drop cause
+         * @return Label string, e.g. "ring_full"
+         */
+        static const char *toString(DropCause cause);
+
+    private:
+        std::atomic<uint64_t> periodNs_{0};
+        std::array<std::atomic<uint64_t>, CAUSE_COUNT> drops_{};
+        LatencyHistogram jitter_;
+
+        // Previous arrival, touched by recordArrival() only
+        bool havePrevious_ = false;
+        uint32_t lastFrameNumber_ = 0;
+        uint64_t lastCaptureTimeNs_ = 0;
+        uint64_t lastBufferShortages_ = 0;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace medical::imaging {
+    /**
+     * @enum TracePoint
+     * @brief Pipeline stage a trace event marks
+     */
+    enum class TracePoint : uint16_t {
+        FRAME_ARRIVAL,       // The device delivered a frame (instant)
+        CONVERT_BEGIN,       // The device starts wrapping the SDK frame into a Frame
+        CONVERT_END,         // The device is done wrapping the frame
+        PUBLISH_BEGIN,       // The publisher starts on a frame
+        PUBLISH_END,         // The publisher handed the frame to every ring and subscriber
+        SHM_WRITE_BEGIN,     // writeFrame() starts on the raw ring
+        SHM_WRITE_END,       // writeFrame() returned
+        DROP_PUBLISH_QUEUE,  // The publisher was a whole queue behind and the frame was discarded (instant)
+        DROP_RING_FULL,      // The raw ring refused the frame (instant)
+        DROP_DEVICE,         // The device skipped input frames before this one (instant)
+        DROP_BUFFER_POOL,    // The device skipped input frames while its capture buffers were used up (instant)
+        DROP_READER_OVERWRITTEN, // A raw ring reader was lapped, frame ID is the last sequence it read (instant)
+        CONSUMER_ACQUIRE,    // A consumer took a view of the frame (starts an async span)
+        CONSUMER_RELEASE     // The consumer released the view (ends the async span)
+    };
+
+    /**
+     * @class FrameTrace
+     * @brief Always-on per-frame trace points, exported as a Chrome/Perfetto trace
+     *
+     * Every thread that records an event gets a ring of the most recent
+     * events of its own, so recording is a timestamp read and four relaxed
+     * stores with no lock and no contention; a disabled trace costs one
+     * relaxed load. Timestamps are raw TSC ticks on x86 (CLOCK_MONOTONIC
+     * elsewhere) and are converted to CLOCK_MONOTONIC microseconds on
+     * export, so traces dumped by the daemon and by consumers line up in
+     * the same Perfetto timeline.
+     *
+     * Events live in memory only; writeChromeTrace() exports the last
+     * window of them in the JSON trace event format that ui.perfetto.dev
+     * and chrome://tracing open.
+     */
+    class FrameTrace {
+    public:
+        /**
+         * @brief Events each thread keeps, the oldest are overwritten first
+         */
+        static constexpr size_t EVENTS_PER_THREAD = 16384;
+
+        /**
+         * @brief Turn recording on or off for the whole process
+         * @param enabled true to record events
+         */
+        static void setEnabled(bool enabled);
+
+        /**
+         * @brief Check whether events are recorded
+         * @return true if enabled
+         */
+        static bool isEnabled() {
+            return enabled_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Record an event on the calling thread
+         * @param point Pipeline stage
+         * @param frameId ID of the frame the event belongs to
+         * @param channel Capture channel (or any small tag the caller chooses)
+         */
+        static void record(TracePoint point, uint64_t frameId, uint32_t channel = 0) {
+            if (enabled_.load(std::memory_order_relaxed)) {
+                recordEvent(point, frameId, channel);
+            }
+        }
+
+        /**
+         * @brief Write the recent events of every thread as a Chrome JSON trace
+         * @param filePath Output file
+         * @param window How far back to export, measured from now
+         * @return true if the file was written
+         */
+        static bool writeChromeTrace(const std::string &filePath, std::chrono::milliseconds window);
+
+        /**
+         * @brief Get the recent events of every thread as a Chrome JSON trace
+         * @param window How far back to export, measured from now
+         * @return JSON document
+         */
+        static std::string toChromeTrace(std::chrono::milliseconds window);
+
+        /**
+         * @brief Get the number of events recorded since the process started
+         * @return Event count over all threads, overwritten ones included
+         */
+        static uint64_t getEventCount();
+
+        /**
+         * @brief Get the name of a trace point
+         * @param point Trace point
+         * @return Event name used in the trace
+         */
+        static const char *toString(TracePoint point);
+
+    private:
+        static void recordEvent(TracePoint point, uint64_t frameId, uint32_t channel);
+
+        static std::atomic<bool> enabled_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace medical::imaging::futex {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "futex words must be plain 32-bit integers in shared memory");
+
+    /**
+     * @brief Block until the futex word no longer holds the expected value
+     *
+     * Uses the shared (non-private) futex operations so that waiters and wakers
+     * may live in different processes mapping the same region.
+     *
+     * @param word Futex word, usually located in shared memory
+     * @param expected Value observed by the caller before deciding to sleep
+     * @param timeout Maximum time to sleep, negative for no timeout
+     * @return true if woken or the value already changed, false on timeout
+     */
+    inline bool wait(std::atomic<uint32_t> *word, uint32_t expected,
+                     std::chrono::nanoseconds timeout) {
+        timespec ts{};
+        timespec *tsPtr = nullptr;
+        if (timeout.count() >= 0) {
+            ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000LL);
+            ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000LL);
+            tsPtr = &ts;
+        }
+
+        long result = syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAIT,
+                              expected, tsPtr, nullptr, 0);
+        return result == 0 || errno != ETIMEDOUT;
+    }
+
+    /**
+     * @brief Wake processes sleeping on a futex word
+     * @param word Futex word, usually located in shared memory
+     * @param count Maximum number of waiters to wake
+     * @return Number of waiters woken
+     */
+    inline int wake(std::atomic<uint32_t> *word, int count = INT_MAX) {
+        long result = syscall(SYS_futex, reinterpret_cast<uint32_t *>(word), FUTEX_WAKE,
+                              count, nullptr, nullptr, 0);
+        return result < 0 ? 0 : static_cast<int>(result);
+    }
+
+    /**
+     * @brief Ring a doorbell: bump the futex word and wake sleepers if any are registered
+     *
+     * Publishers must make the new state visible before calling this; sleepers
+     * register in @p waiters before calling wait() so the waker can skip the
+     * syscall when nobody is sleeping.
+     *
+     * @param word Doorbell futex word
+     * @param waiters Number of registered sleepers on the doorbell
+     */
+    inline void ring(std::atomic<uint32_t> &word, const std::atomic<uint32_t> &waiters) {
+        word.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_seq_cst) > 0) {
+            wake(&word);
+        }
+    }
+} // namespace medical::imaging::futex
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    /**
+     * @class IoUring
+     * @brief Minimal io_uring submission/completion ring built on the raw system calls
+     *
+     * Only what the recorders need: queue writes, submit them in one
+     * io_uring_enter() and reap completions without blocking. Not thread-safe;
+     * one thread owns the ring.
+     */
+    class IoUring {
+    public:
+        IoUring() = default;
+
+        IoUring(const IoUring &) = delete;
+        IoUring &operator=(const IoUring &) = delete;
+
+        ~IoUring() {
+            close();
+        }
+
+        /**
+         * @brief Create the ring
+         * @param entries Submission queue size (rounded up to a power of two by the kernel)
+         * @return true on success; false with errno set if io_uring is unavailable
+         */
+        bool initialize(unsigned entries) {
+            close();
+
+            io_uring_params params{};
+            ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (ringFd_ < 0) {
+                return false;
+            }
+
+            sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMmap) {
+                sqRingSize_ = cqRingSize_ = sqRingSize_ > cqRingSize_ ? sqRingSize_ : cqRingSize_;
+            }
+
+            sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ringFd_, IORING_OFF_SQ_RING);
+            cqRing_ = singleMmap
+                          ? sqRing_
+                          : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                 ringFd_, IORING_OFF_CQ_RING);
+            sqeSize_ = params.sq_entries * sizeof(io_uring_sqe);
+            void *sqes = mmap(nullptr, sqeSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              ringFd_, IORING_OFF_SQES);
+            if (sqRing_ == MAP_FAILED || cqRing_ == MAP_FAILED || sqes == MAP_FAILED) {
+                int error = errno;
+                if (sqes != MAP_FAILED) {
+                    munmap(sqes, sqeSize_);
+                }
+                sqes_ = nullptr;
+                close();
+                errno = error;
+                return false;
+            }
+            sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+            auto *sq = static_cast<uint8_t *>(sqRing_);
+            sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+            sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+            sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+            sqEntries_ = params.sq_entries;
+            sqArray_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+            auto *cq = static_cast<uint8_t *>(cqRing_);
+            cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+            cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+            cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+            pending_ = 0;
+            return true;
+        }
+
+        /**
+         * @brief Tear the ring down; in-flight requests still complete in the kernel
+         */
+        void close() {
+            if (sqes_) {
+                munmap(sqes_, sqeSize_);
+                sqes_ = nullptr;
+            }
+            if (cqRing_ && cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+                munmap(cqRing_, cqRingSize_);
+            }
+            if (sqRing_ && sqRing_ != MAP_FAILED) {
+                munmap(sqRing_, sqRingSize_);
+            }
+            sqRing_ = cqRing_ = nullptr;
+            if (ringFd_ >= 0) {
+                ::close(ringFd_);
+                ringFd_ = -1;
+            }
+        }
+
+        /**
+         * @brief Check if the ring was created
+         * @return true if initialize() succeeded
+         */
+        bool isInitialized() const {
+            return ringFd_ >= 0;
+        }
+
+        /**
+         * @brief Queue a write without submitting it
+         * @param fd File to write
+         * @param buffer Source memory, must stay valid until the completion is reaped
+         * @param length Number of bytes
+         * @param offset File offset
+         * @param userData Value returned with the completion
+         * @return false if the submission queue is full
+         */
+        bool prepareWrite(int fd, const void *buffer, uint32_t length, uint64_t offset, uint64_t userData) {
+            return prepare(IORING_OP_WRITE, fd, buffer, length, offset, userData);
+        }
+
+        /**
+         * @brief Queue a gathering write without submitting it
+         * @param fd File to write
+         * @param iov Buffers to write back to back; the array and buffers must stay valid until completion
+         * @param count Number of entries in @p iov
+         * @param offset File offset
+         * @param userData Value returned with the completion
+         * @return false if the submission queue is full
+         */
+        bool prepareWritev(int fd, const iovec *iov, uint32_t count, uint64_t offset, uint64_t userData) {
+            return prepare(IORING_OP_WRITEV, fd, iov, count, offset, userData);
+        }
+
+        /**
+         * @brief Submit all queued requests
+         * @param waitForOne Also block until at least one completion is available
+         * @return Number of requests submitted, -1 with errno set on failure
+         */
+        int submit(bool waitForOne = false) {
+            unsigned flags = waitForOne ? IORING_ENTER_GETEVENTS : 0;
+            int submitted;
+            do {
+                submitted = static_cast<int>(syscall(__NR_io_uring_enter, ringFd_, pending_,
+                                                     waitForOne ? 1u : 0u, flags, nullptr, 0));
+            } while (submitted < 0 && errno == EINTR);
+
+            if (submitted > 0) {
+                pending_ -= static_cast<unsigned>(submitted) < pending_ ? static_cast<unsigned>(submitted) : pending_;
+            }
+            return submitted;
+        }
+
+        /**
+         * @brief Pass every available completion to a handler
+         * @param handler Called as handler(userData, result) where result is bytes written or -errno
+         * @return Number of completions handled
+         */
+        template<typename Handler>
+        unsigned reap(Handler &&handler) {
+            unsigned head = *cqHead_;
+            unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            unsigned count = 0;
+            while (head != tail) {
+                const io_uring_cqe &cqe = cqes_[head & cqMask_];
+                handler(cqe.user_data, cqe.res);
+                ++head;
+                ++count;
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+            return count;
+        }
+
+    private:
+        // Fill the next submission queue entry
+        bool prepare(uint8_t opcode, int fd, const void *address, uint32_t length, uint64_t offset,
+                     uint64_t userData) {
+            unsigned tail = *sqTail_;
+            unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+            if (tail - head >= sqEntries_) {
+                return false;
+            }
+
+            unsigned index = tail & sqMask_;
+            io_uring_sqe *sqe = &sqes_[index];
+            std::memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = opcode;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(address);
+            sqe->len = length;
+            sqe->off = offset;
+            sqe->user_data = userData;
+
+            sqArray_[index] = index;
+            __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+            ++pending_;
+            return true;
+        }
+
+        int ringFd_ = -1;
+        unsigned pending_ = 0;
+
+        void *sqRing_ = nullptr;
+        void *cqRing_ = nullptr;
+        size_t sqRingSize_ = 0;
+        size_t cqRingSize_ = 0;
+        size_t sqeSize_ = 0;
+
+        unsigned *sqHead_ = nullptr;
+        unsigned *sqTail_ = nullptr;
+        unsigned *sqArray_ = nullptr;
+        unsigned sqMask_ = 0;
+        unsigned sqEntries_ = 0;
+        io_uring_sqe *sqes_ = nullptr;
+
+        unsigned *cqHead_ = nullptr;
+        unsigned *cqTail_ = nullptr;
+        unsigned cqMask_ = 0;
+        io_uring_cqe *cqes_ = nullptr;
+    };
+} // namespace medical::imaging
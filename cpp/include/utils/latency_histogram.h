@@ -0,0 +1,270 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @class LatencyHistogram
+     * @brief Wait-free log-linear histogram for latencies and intervals in nanoseconds
+     *
+     * Values are bucketed HDR-style: every power of two is split into
+     * SUB_BUCKETS linear sub-buckets, so any recorded value is reported
+     * within ~6% over the whole 64-bit range. record() is a handful of
+     * relaxed atomic adds on a per-thread shard and never blocks; shards are
+     * only merged when snapshot() is called by a reader.
+     */
+    class LatencyHistogram {
+    public:
+        static constexpr uint32_t SUB_BUCKET_BITS = 4;
+        static constexpr uint32_t SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+        static constexpr uint32_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+        static constexpr uint32_t SHARD_COUNT = 4;
+
+        /**
+         * @brief Merged, non-atomic copy of a histogram
+         */
+        struct Snapshot {
+            uint64_t count = 0; // Number of recorded values
+            uint64_t sum = 0;   // Sum of recorded values
+            uint64_t max = 0;   // Largest recorded value
+            std::array<uint64_t, BUCKET_COUNT> buckets{};
+
+            /**
+             * @brief Get the value below which a fraction of the recorded values fall
+             * @param quantile Fraction between 0 and 1 (0.99 for p99)
+             * @return Upper bound of the bucket holding the quantile, 0 if empty
+             */
+            uint64_t percentile(double quantile) const {
+                if (count == 0) {
+                    return 0;
+                }
+                auto rank = static_cast<uint64_t>(quantile * static_cast<double>(count) + 0.5);
+                rank = rank < 1 ? 1 : (rank > count ? count : rank);
+
+                uint64_t seen = 0;
+                for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+                    seen += buckets[i];
+                    if (seen >= rank) {
+                        uint64_t upper = bucketUpperBound(i);
+                        return upper < max ? upper : max;
+                    }
+                }
+                return max;
+            }
+
+            /**
+             * @brief Get the mean of the recorded values
+             * @return Mean value, 0 if empty
+             */
+            double mean() const {
+                return count > 0 ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+            }
+
+            /**
+             * @brief Turn a cumulative snapshot into the values recorded since an older one
+             *
+             * The maximum cannot be windowed and stays the cumulative maximum.
+             *
+             * @param older Snapshot taken earlier from the same histogram
+             * @return Reference to this snapshot
+             */
+            Snapshot &operator-=(const Snapshot &older) {
+                count = count >= older.count ? count - older.count : 0;
+                sum = sum >= older.sum ? sum - older.sum : 0;
+                for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+                    buckets[i] = buckets[i] >= older.buckets[i] ? buckets[i] - older.buckets[i] : 0;
+                }
+                return *this;
+            }
+        };
+
+        LatencyHistogram() {
+            reset();
+        }
+
+        LatencyHistogram(const LatencyHistogram &) = delete;
+        LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+        /**
+         * @brief Record one value
+         * @param value Value in nanoseconds
+         */
+        void record(uint64_t value) {
+            Shard &shard = shards_[shardIndex()];
+            shard.buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+            shard.sum.fetch_add(value, std::memory_order_relaxed);
+
+            uint64_t currentMax = shard.max.load(std::memory_order_relaxed);
+            while (value > currentMax &&
+                   !shard.max.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {
+            }
+        }
+
+        /**
+         * @brief Merge all shards into a snapshot
+         * @return Snapshot of every value recorded since construction or the last reset()
+         */
+        Snapshot snapshot() const {
+            Snapshot result;
+            for (const Shard &shard: shards_) {
+                for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+                    uint64_t n = shard.buckets[i].load(std::memory_order_relaxed);
+                    result.buckets[i] += n;
+                    result.count += n;
+                }
+                result.sum += shard.sum.load(std::memory_order_relaxed);
+                uint64_t shardMax = shard.max.load(std::memory_order_relaxed);
+                result.max = shardMax > result.max ? shardMax : result.max;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Clear all recorded values
+         *
+         * Values recorded concurrently with a reset may be partially kept.
+         */
+        void reset() {
+            for (Shard &shard: shards_) {
+                for (auto &bucket: shard.buckets) {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+                shard.sum.store(0, std::memory_order_relaxed);
+                shard.max.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Get the bucket a value falls into
+         * @param value Value in nanoseconds
+         * @return Bucket index below BUCKET_COUNT
+         */
+        static constexpr uint32_t bucketIndex(uint64_t value) {
+            if (value < SUB_BUCKETS) {
+                return static_cast<uint32_t>(value);
+            }
+            uint32_t exponent = 63 - static_cast<uint32_t>(__builtin_clzll(value));
+            uint32_t shift = exponent - SUB_BUCKET_BITS;
+            uint32_t mantissa = static_cast<uint32_t>(value >> shift) & (SUB_BUCKETS - 1);
+            return (shift + 1) * SUB_BUCKETS + mantissa;
+        }
+
+        /**
+         * @brief Get the largest value that falls into a bucket
+         * @param index Bucket index
+         * @return Inclusive upper bound of the bucket
+         */
+        static constexpr uint64_t bucketUpperBound(uint32_t index) {
+            if (index < SUB_BUCKETS) {
+                return index;
+            }
+            uint32_t shift = index / SUB_BUCKETS - 1;
+            uint64_t lower = (static_cast<uint64_t>(SUB_BUCKETS + index % SUB_BUCKETS)) << shift;
+            return lower + ((uint64_t{1} << shift) - 1);
+        }
+
+    private:
+        struct alignas(64) Shard {
+            std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets;
+            std::atomic<uint64_t> sum;
+            std::atomic<uint64_t> max;
+        };
+
+        // Threads stick to one shard so concurrent recorders rarely share cache lines
+        static uint32_t shardIndex() {
+            static thread_local const uint32_t index = static_cast<uint32_t>(
+                std::hash<std::thread::id>{}(std::this_thread::get_id()) % SHARD_COUNT);
+            return index;
+        }
+
+        std::array<Shard, SHARD_COUNT> shards_;
+    };
+
+    static_assert(LatencyHistogram::bucketIndex(UINT64_MAX) == LatencyHistogram::BUCKET_COUNT - 1,
+                  "the last bucket must hold the largest value");
+    static_assert(LatencyHistogram::bucketUpperBound(LatencyHistogram::bucketIndex(1000000)) >= 1000000,
+                  "a value must not exceed the upper bound of its bucket");
+
+    /**
+     * @brief Add count, mean, p50, p99, p99.9 and max of a histogram to a statistics map
+     * @param stats Map to add to, as returned by the getStatistics()/getDiagnostics() methods
+     * @param prefix Key prefix, e.g. "shm_write"
+     * @param snapshot Histogram snapshot holding nanosecond values
+     */
+    inline void appendHistogramStatistics(std::map<std::string, std::string> &stats, const std::string &prefix,
+                                          const LatencyHistogram::Snapshot &snapshot) {
+        stats[prefix + "_count"] = std::to_string(snapshot.count);
+        stats[prefix + "_mean_us"] = std::to_string(snapshot.mean() / 1000.0);
+        stats[prefix + "_p50_us"] = std::to_string(snapshot.percentile(0.50) / 1000.0);
+        stats[prefix + "_p99_us"] = std::to_string(snapshot.percentile(0.99) / 1000.0);
+        stats[prefix + "_p999_us"] = std::to_string(snapshot.percentile(0.999) / 1000.0);
+        stats[prefix + "_max_us"] = std::to_string(snapshot.max / 1000.0);
+    }
+
+    /**
+     * @brief Append a labelled family of histograms to a Prometheus text exposition as summaries in seconds
+     *
+     * Emits the p50, p99 and p99.9 quantiles plus _sum and _count of every
+     * series, and the maxima as a separate <name>_max gauge family.
+     *
+     * @param out Exposition text to append to
+     * @param name Metric name, e.g. "imaging_device_convert_seconds"
+     * @param help One-line description for the # HELP line
+     * @param series Label text (e.g. "channel=\"0\"", empty for none) and nanosecond snapshot of each series
+     */
+    inline void appendPrometheusSummary(std::string &out, const std::string &name, const std::string &help,
+                                        const std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> &series) {
+        auto seconds = [](double ns) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.9g", ns / 1e9);
+            return std::string(buffer);
+        };
+        auto labelled = [](const std::string &labels, const std::string &extra) {
+            std::string all = labels.empty() ? extra : (extra.empty() ? labels : labels + "," + extra);
+            return all.empty() ? std::string() : "{" + all + "}";
+        };
+
+        out += "# HELP " + name + " " + help + "\n";
+        out += "# TYPE " + name + " summary\n";
+        for (const auto &[labels, snapshot]: series) {
+            out += name + labelled(labels, "quantile=\"0.5\"") + " " +
+                    seconds(static_cast<double>(snapshot.percentile(0.50))) + "\n";
+            out += name + labelled(labels, "quantile=\"0.99\"") + " " +
+                    seconds(static_cast<double>(snapshot.percentile(0.99))) + "\n";
+            out += name + labelled(labels, "quantile=\"0.999\"") + " " +
+                    seconds(static_cast<double>(snapshot.percentile(0.999))) + "\n";
+            out += name + "_sum" + labelled(labels, "") + " " + seconds(static_cast<double>(snapshot.sum)) + "\n";
+            out += name + "_count" + labelled(labels, "") + " " + std::to_string(snapshot.count) + "\n";
+        }
+        out += "# HELP " + name + "_max Largest value of " + name + "\n";
+        out += "# TYPE " + name + "_max gauge\n";
+        for (const auto &[labels, snapshot]: series) {
+            out += name + "_max" + labelled(labels, "") + " " + seconds(static_cast<double>(snapshot.max)) + "\n";
+        }
+    }
+
+    /**
+     * @brief Append a histogram to a Prometheus text exposition as a summary in seconds
+     *
+     * Emits the p50, p99 and p99.9 quantiles plus _sum and _count, and the
+     * maximum as a separate <name>_max gauge.
+     *
+     * @param out Exposition text to append to
+     * @param name Metric name, e.g. "imaging_shm_write_seconds"
+     * @param help One-line description for the # HELP line
+     * @param snapshot Histogram snapshot holding nanosecond values
+     */
+    inline void appendPrometheusSummary(std::string &out, const std::string &name, const std::string &help,
+                                        const LatencyHistogram::Snapshot &snapshot) {
+        appendPrometheusSummary(out, name, help, {{std::string(), snapshot}});
+    }
+} // namespace medical::imaging
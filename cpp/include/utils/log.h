@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace medical::imaging {
+    /**
+     * @enum LogLevel
+     * @brief Severity of a log message
+     */
+    enum class LogLevel : uint8_t {
+        DEBUG,             // Detail for troubleshooting, off by default
+        INFO,              // Normal operation, written to stdout
+        WARNING,           // Something went wrong and was handled, written to stderr
+        ERROR              // Something failed, written to stderr
+    };
+
+    /**
+     * @class Log
+     * @brief Asynchronous, rate-limited logging for the library
+     *
+     * A message is queued as its format and its raw arguments in a
+     * fixed-size record of a lock-free ring, and a background thread formats
+     * and writes it. The calling thread never takes the stdio lock and never
+     * blocks: when the ring is full the record is dropped and counted.
+     *
+     * Every call site has its own rate limit, SITE_BURST messages per
+     * second; the rest are counted and the next message from the site that
+     * passes reports how many were suppressed. A burst of errors on the
+     * capture path therefore costs a few atomic operations per frame.
+     *
+     * Use the MIVI_LOG_* macros. The format takes "{}" for each argument,
+     * "{:.Nf}" for a floating point argument with N decimals, or "{:x}" for
+     * an integer in hexadecimal. Arguments are integers, floating point
+     * values, characters, pointers, booleans and strings; strings are
+     * copied and truncated to the space left in the record. INFO and DEBUG
+     * go to stdout, WARNING and ERROR to stderr, without a prefix, as the
+     * std::cout and std::cerr writes they replace did. After exit() has
+     * begun messages are written synchronously.
+     */
+    class Log {
+    public:
+        /**
+         * @brief Messages a call site may log per second before it is suppressed
+         */
+        static constexpr uint32_t SITE_BURST = 10;
+
+        /**
+         * @brief Static state of one call site, declared by the macros
+         */
+        struct Site {
+            LogLevel level;                       // Severity of the message
+            std::atomic<uint64_t> windowStartNs;  // Start of the current one-second rate window
+            std::atomic<uint32_t> windowCount;    // Messages in the current window
+            std::atomic<uint32_t> suppressed;     // Messages suppressed since the last one logged
+        };
+
+        /**
+         * @brief Set the lowest level logged
+         * @param level Messages below this level are discarded at the call site
+         */
+        static void setLevel(LogLevel level);
+
+        /**
+         * @brief Get the lowest level logged
+         * @return Current level, INFO by default
+         */
+        static LogLevel getLevel() {
+            return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * @brief Check whether messages of a level are logged
+         * @param level Message level
+         * @return true if enabled
+         */
+        static bool isEnabled(LogLevel level) {
+            return static_cast<uint8_t>(level) >= level_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Parse a level name
+         * @param name "debug", "info", "warning" or "error"
+         * @param level Output parameter receiving the level
+         * @return false if the name is unknown
+         */
+        static bool parseLevel(const std::string &name, LogLevel &level);
+
+        /**
+         * @brief Wait until every message queued so far is written
+         */
+        static void flush();
+
+        /**
+         * @brief Get the number of messages dropped because the ring was full
+         * @return Messages dropped since the process started
+         */
+        static uint64_t getDroppedCount();
+
+        /**
+         * @brief Get the number of messages the per-site rate limit suppressed
+         * @return Messages suppressed since the process started
+         */
+        static uint64_t getSuppressedCount();
+
+        /**
+         * @brief Queue a message; use the MIVI_LOG_* macros instead
+         * @param site Static state of the call site
+         * @param format String literal with a placeholder for each argument
+         * @param args Arguments for the placeholders
+         */
+        template<typename... Args>
+        static void write(Site &site, const char *format, const Args &... args) {
+            uint32_t suppressed = 0;
+            if (!admit(site, suppressed)) {
+                return;
+            }
+
+            Record record;
+            record.format = format;
+            record.level = site.level;
+            record.suppressed = suppressed;
+            record.size = 0;
+            (record.append(args), ...);
+            submit(record);
+        }
+
+        /**
+         * @brief Queued form of one message
+         */
+        struct Record {
+            static constexpr size_t ARGUMENT_BYTES = 232;
+
+            // Argument type tags
+            enum : uint8_t { SIGNED, UNSIGNED, FLOATING, CHARACTER, BOOLEAN, POINTER, STRING, TRUNCATED };
+
+            const char *format;                   // Format of the call site, a string literal
+            LogLevel level;                       // Severity of the message
+            uint32_t suppressed;                  // Messages of the site suppressed before this one
+            uint16_t size;                        // Bytes of arguments used
+            uint8_t arguments[ARGUMENT_BYTES];    // Tag and value of each argument
+
+            template<typename T>
+            void append(const T &value) {
+                using Type = std::decay_t<T>;
+                if constexpr (std::is_same_v<Type, bool>) {
+                    appendScalar(BOOLEAN, static_cast<uint8_t>(value));
+                } else if constexpr (std::is_same_v<Type, char>) {
+                    appendScalar(CHARACTER, value);
+                } else if constexpr (std::is_enum_v<Type>) {
+                    appendScalar(SIGNED, static_cast<int64_t>(value));
+                } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+                    appendScalar(SIGNED, static_cast<int64_t>(value));
+                } else if constexpr (std::is_integral_v<Type>) {
+                    appendScalar(UNSIGNED, static_cast<uint64_t>(value));
+                } else if constexpr (std::is_floating_point_v<Type>) {
+                    appendScalar(FLOATING, static_cast<double>(value));
+                } else if constexpr (std::is_same_v<Type, std::string>) {
+                    appendString(value.data(), value.size());
+                } else if constexpr (std::is_same_v<Type, const char *> || std::is_same_v<Type, char *>) {
+                    appendString(value ? value : "(null)", value ? std::strlen(value) : 6);
+                } else if constexpr (std::is_pointer_v<Type>) {
+                    appendScalar(POINTER, reinterpret_cast<uintptr_t>(value));
+                } else {
+                    // Anything with a string form, e.g. a std::string_view
+                    std::string text(value);
+                    appendString(text.data(), text.size());
+                }
+            }
+
+            template<typename T>
+            void appendScalar(uint8_t tag, T value) {
+                if (size + 1 + sizeof(T) > ARGUMENT_BYTES) {
+                    markTruncated();
+                    return;
+                }
+                arguments[size] = tag;
+                std::memcpy(arguments + size + 1, &value, sizeof(T));
+                size = static_cast<uint16_t>(size + 1 + sizeof(T));
+            }
+
+            void appendString(const char *text, size_t length) {
+                if (static_cast<size_t>(size) + 4 > ARGUMENT_BYTES) {
+                    markTruncated();
+                    return;
+                }
+                // A truncated string leaves a byte for the TRUNCATED tag
+                size_t room = ARGUMENT_BYTES - size - 3;
+                auto stored = static_cast<uint16_t>(length <= room ? length : room - 1);
+                arguments[size] = STRING;
+                std::memcpy(arguments + size + 1, &stored, sizeof(stored));
+                std::memcpy(arguments + size + 3, text, stored);
+                size = static_cast<uint16_t>(size + 3 + stored);
+                if (stored < length) {
+                    markTruncated();
+                }
+            }
+
+            void markTruncated() {
+                if (size < ARGUMENT_BYTES) {
+                    arguments[size++] = TRUNCATED;
+                }
+                size = ARGUMENT_BYTES;
+            }
+        };
+
+    private:
+        // Apply the level and the rate limit of a site; suppressed receives the count to report
+        static bool admit(Site &site, uint32_t &suppressed);
+
+        // Hand a record to the background thread, or write it at once after exit() began
+        static void submit(Record &record);
+
+        static std::atomic<uint8_t> level_;
+    };
+} // namespace medical::imaging
+
+// Log a message from a call site with its own rate limit, e.g. MIVI_LOG_ERROR("Failed to open {}", path).
+// The first argument is the format, a string literal.
+#define MIVI_LOG(level, ...)                                                                              \
+    do {                                                                                                  \
+        if (::medical::imaging::Log::isEnabled(level)) {                                                  \
+            static ::medical::imaging::Log::Site mivi_log_site_{level, {0}, {0}, {0}};                    \
+            ::medical::imaging::Log::write(mivi_log_site_, __VA_ARGS__);                                  \
+        }                                                                                                 \
+    } while (0)
+
+#define MIVI_LOG_DEBUG(...) MIVI_LOG(::medical::imaging::LogLevel::DEBUG, __VA_ARGS__)
+#define MIVI_LOG_INFO(...) MIVI_LOG(::medical::imaging::LogLevel::INFO, __VA_ARGS__)
+#define MIVI_LOG_WARNING(...) MIVI_LOG(::medical::imaging::LogLevel::WARNING, __VA_ARGS__)
+#define MIVI_LOG_ERROR(...) MIVI_LOG(::medical::imaging::LogLevel::ERROR, __VA_ARGS__)
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace medical::imaging {
+    /**
+     * @class MpmcQueue
+     * @brief Bounded lock-free queue for any number of producer and consumer threads
+     *
+     * Every cell carries a sequence number telling whether it is free for
+     * the producer of a given position or holds the element for the
+     * consumer of that position (D. Vyukov's bounded queue). A push or pop
+     * is one compare-and-swap on the shared index plus a release store on
+     * the cell, and never allocates. Unlike SpscQueue, a producer may also
+     * pop, which is what lets it discard the oldest element when full.
+     */
+    template<typename T>
+    class MpmcQueue {
+    public:
+        /**
+         * @brief Constructor
+         * @param capacity Minimum number of elements the queue holds, rounded up to a power of two (at least 2)
+         */
+        explicit MpmcQueue(size_t capacity)
+            : capacity_(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+              mask_(capacity_ - 1),
+              cells_(new Cell[capacity_]),
+              enqueuePos_(0),
+              dequeuePos_(0) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue &) = delete;
+        MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+        /**
+         * @brief Append an element
+         * @param value Element to move into the queue
+         * @return false if the queue is full; @p value is left untouched then
+         */
+        bool push(T &&value) {
+            size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+            while (true) {
+                Cell &cell = cells_[pos & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Take the oldest element
+         *
+         * The cell is left moved-from, so resources such as a shared_ptr are
+         * released by the thread that popped rather than when the cell is reused.
+         *
+         * @param value Output parameter receiving the element
+         * @return false if the queue is empty
+         */
+        bool pop(T &value) {
+            size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+            while (true) {
+                Cell &cell = cells_[pos & mask_];
+                size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = std::move(cell.value);
+                        cell.value = T();
+                        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeuePos_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Approximate number of queued elements
+         * @return Element count, possibly stale by the time it is used
+         */
+        size_t size() const {
+            size_t dequeued = dequeuePos_.load(std::memory_order_acquire);
+            size_t enqueued = enqueuePos_.load(std::memory_order_acquire);
+            return enqueued > dequeued ? enqueued - dequeued : 0;
+        }
+
+        /**
+         * @brief Check whether the queue looks empty
+         * @return true if empty
+         */
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Number of elements the queue holds when full
+         * @return Capacity
+         */
+        size_t capacity() const {
+            return capacity_;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        static size_t roundUpToPowerOfTwo(size_t value) {
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+
+        // Producers and consumers contend on different lines
+        alignas(64) std::atomic<size_t> enqueuePos_;
+        alignas(64) std::atomic<size_t> dequeuePos_;
+    };
+} // namespace medical::imaging
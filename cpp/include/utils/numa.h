@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <dirent.h>
+#include <fstream>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @brief NUMA topology lookups and placement built on sysfs and the raw system calls
+     *
+     * Only what the capture path needs: find the node a PCIe card hangs off,
+     * prefer that node for a memory range and keep a thread on its CPUs.
+     * Everything is a no-op on single-node machines, so callers need no
+     * special casing.
+     */
+    namespace numa {
+        // Memory policy modes and flags from <linux/mempolicy.h>
+        constexpr int MPOL_MODE_PREFERRED = 1;
+        constexpr unsigned MPOL_FLAG_MOVE = 1u << 1;
+        constexpr unsigned long MPOL_FLAG_NODE = 1ul << 0;
+        constexpr unsigned long MPOL_FLAG_ADDR = 1ul << 1;
+
+        /**
+         * @brief PCI vendor ID of Blackmagic Design cards
+         */
+        constexpr unsigned BLACKMAGIC_PCI_VENDOR = 0xbdbd;
+
+        /**
+         * @brief Parse a sysfs list such as "0-3,8-11"
+         * @param list List text
+         * @return Every number in the list
+         */
+        inline std::vector<int> parseList(const std::string &list) {
+            std::vector<int> values;
+            size_t pos = 0;
+            while (pos < list.size()) {
+                size_t end = list.find(',', pos);
+                if (end == std::string::npos) {
+                    end = list.size();
+                }
+                std::string range = list.substr(pos, end - pos);
+                size_t dash = range.find('-');
+                try {
+                    int first = std::stoi(range.substr(0, dash));
+                    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int value = first; value <= last; ++value) {
+                        values.push_back(value);
+                    }
+                } catch (const std::exception &) {
+                    // Trailing newline or an empty list
+                }
+                pos = end + 1;
+            }
+            return values;
+        }
+
+        /**
+         * @brief Get the number of online NUMA nodes
+         * @return Node count, 1 when the kernel has no NUMA support
+         */
+        inline int nodeCount() {
+            std::ifstream file("/sys/devices/system/node/online");
+            std::string list;
+            std::getline(file, list);
+            std::vector<int> nodes = parseList(list);
+            return nodes.empty() ? 1 : *std::max_element(nodes.begin(), nodes.end()) + 1;
+        }
+
+        /**
+         * @brief Get the CPUs of a node
+         * @param node NUMA node
+         * @return CPU numbers, empty if the node does not exist
+         */
+        inline std::vector<int> nodeCpus(int node) {
+            std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string list;
+            std::getline(file, list);
+            return parseList(list);
+        }
+
+        /**
+         * @brief Get the node a PCI device is attached to
+         * @param address PCI address such as "0000:65:00.0"
+         * @return NUMA node, -1 if unknown or on a machine without NUMA
+         */
+        inline int nodeOfPciDevice(const std::string &address) {
+            std::ifstream file("/sys/bus/pci/devices/" + address + "/numa_node");
+            int node = -1;
+            if (!(file >> node)) {
+                return -1;
+            }
+            return node;
+        }
+
+        /**
+         * @brief List PCI devices of a vendor in address order
+         * @param vendor PCI vendor ID
+         * @return PCI addresses
+         */
+        inline std::vector<std::string> pciDevicesOfVendor(unsigned vendor) {
+            std::vector<std::string> addresses;
+            DIR *dir = opendir("/sys/bus/pci/devices");
+            if (!dir) {
+                return addresses;
+            }
+            while (dirent *entry = readdir(dir)) {
+                if (entry->d_name[0] == '.') {
+                    continue;
+                }
+                std::ifstream file(std::string("/sys/bus/pci/devices/") + entry->d_name + "/vendor");
+                unsigned id = 0;
+                if (file >> std::hex >> id && id == vendor) {
+                    addresses.emplace_back(entry->d_name);
+                }
+            }
+            closedir(dir);
+            std::sort(addresses.begin(), addresses.end());
+            return addresses;
+        }
+
+        /**
+         * @brief Prefer a node for a memory range
+         *
+         * Pages not yet touched are allocated on the node; pages already
+         * faulted in are migrated where the kernel can. The range is shrunk
+         * to whole pages, so pointers from malloc() can be passed as they are.
+         *
+         * @param address Start of the range
+         * @param size Size of the range in bytes
+         * @param node NUMA node, ignored when negative
+         * @return true if the policy was applied or there was nothing to do
+         */
+        inline bool bindMemory(void *address, size_t size, int node) {
+            if (node < 0 || !address || size == 0 || nodeCount() <= 1) {
+                return true;
+            }
+            if (node >= static_cast<int>(8 * sizeof(unsigned long))) {
+                errno = EINVAL;
+                return false;
+            }
+
+            auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+            uintptr_t start = (reinterpret_cast<uintptr_t>(address) + pageSize - 1) & ~(pageSize - 1);
+            uintptr_t end = (reinterpret_cast<uintptr_t>(address) + size) & ~(pageSize - 1);
+            if (end <= start) {
+                return true;
+            }
+
+            unsigned long nodeMask = 1ul << node;
+            return syscall(SYS_mbind, start, end - start, MPOL_MODE_PREFERRED, &nodeMask,
+                           8 * sizeof(nodeMask), MPOL_FLAG_MOVE) == 0;
+        }
+
+        /**
+         * @brief Restrict the calling thread to the CPUs of a node
+         * @param node NUMA node, ignored when negative
+         * @return true if the affinity was set or there was nothing to do
+         */
+        inline bool bindCurrentThread(int node) {
+            if (node < 0 || nodeCount() <= 1) {
+                return true;
+            }
+            std::vector<int> cpus = nodeCpus(node);
+            if (cpus.empty()) {
+                errno = EINVAL;
+                return false;
+            }
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            for (int cpu: cpus) {
+                CPU_SET(cpu, &cpuset);
+            }
+            return sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0;
+        }
+
+        /**
+         * @brief Get the node currently backing an address
+         * @param address Address of a faulted-in page
+         * @return NUMA node, -1 if unknown
+         */
+        inline int nodeOfAddress(const void *address) {
+            int node = -1;
+            if (!address || syscall(SYS_get_mempolicy, &node, nullptr, 0, address,
+                                    MPOL_FLAG_NODE | MPOL_FLAG_ADDR) != 0) {
+                return -1;
+            }
+            return node;
+        }
+    } // namespace numa
+} // namespace medical::imaging
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace medical::imaging {
+    /**
+     * @class RcuSnapshot
+     * @brief Read-mostly value that readers see without locks while a writer replaces it
+     *
+     * Readers pin the current snapshot for as long as a Reader guard lives:
+     * one atomic increment and decrement of a grace-period counter and one
+     * pointer load, never a lock, so the publish path can take a snapshot
+     * per frame. update() swaps in a new copy and frees the old one only
+     * after every reader that might still see it has dropped its guard, as
+     * in RCU: it flips the counter new readers use twice and waits for each
+     * counter to drain. Readers never wait; the writer sleeps until they are
+     * done, so a guard held across a blocking call delays update() as long.
+     */
+    template<typename T>
+    class RcuSnapshot {
+    public:
+        /**
+         * @class Reader
+         * @brief Pins one snapshot for the lifetime of the guard
+         */
+        class Reader {
+        public:
+            explicit Reader(const RcuSnapshot &snapshot)
+                : snapshot_(snapshot),
+                  index_(snapshot.epoch_.load(std::memory_order_relaxed) & 1) {
+                snapshot_.readers_[index_].fetch_add(1, std::memory_order_seq_cst);
+                value_ = snapshot_.current_.load(std::memory_order_seq_cst);
+            }
+
+            ~Reader() {
+                snapshot_.readers_[index_].fetch_sub(1, std::memory_order_release);
+            }
+
+            Reader(const Reader &) = delete;
+            Reader &operator=(const Reader &) = delete;
+
+            const T &operator*() const {
+                return *value_;
+            }
+
+            const T *operator->() const {
+                return value_;
+            }
+
+        private:
+            const RcuSnapshot &snapshot_;
+            uint32_t index_;
+            const T *value_;
+        };
+
+        /**
+         * @brief Constructor
+         * @param initial First snapshot
+         */
+        explicit RcuSnapshot(T initial = T())
+            : current_(new T(std::move(initial))),
+              epoch_(0),
+              version_(0) {
+            readers_[0] = 0;
+            readers_[1] = 0;
+        }
+
+        ~RcuSnapshot() {
+            delete current_.load(std::memory_order_relaxed);
+        }
+
+        RcuSnapshot(const RcuSnapshot &) = delete;
+        RcuSnapshot &operator=(const RcuSnapshot &) = delete;
+
+        /**
+         * @brief Pin the current snapshot
+         * @return Guard giving access to the snapshot
+         */
+        Reader read() const {
+            return Reader(*this);
+        }
+
+        /**
+         * @brief Copy the current snapshot
+         * @return Copy of the value
+         */
+        T get() const {
+            Reader reader(*this);
+            return *reader;
+        }
+
+        /**
+         * @brief Replace the snapshot, waiting until no reader sees the old one
+         * @param value New snapshot
+         */
+        void update(T value) {
+            std::lock_guard<std::mutex> lock(writerMutex_);
+            const T *previous = current_.exchange(new T(std::move(value)), std::memory_order_seq_cst);
+            version_.fetch_add(1, std::memory_order_release);
+
+            // A reader may have read the epoch just before a flip, so drain the counters of both epochs
+            for (int flip = 0; flip < 2; ++flip) {
+                uint64_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+                while (readers_[epoch & 1].load(std::memory_order_acquire) != 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+            delete previous;
+        }
+
+        /**
+         * @brief Get the number of updates so far
+         * @return Version, 0 for the initial snapshot
+         */
+        uint64_t getVersion() const {
+            return version_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::atomic<const T *> current_;
+        mutable std::atomic<uint64_t> epoch_;
+        mutable std::atomic<uint32_t> readers_[2];
+        std::atomic<uint64_t> version_;
+        std::mutex writerMutex_;
+    };
+} // namespace medical::imaging
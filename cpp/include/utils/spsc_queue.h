@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @class SpscQueue
+     * @brief Bounded wait-free queue between exactly one producer and one consumer thread
+     *
+     * push() and pop() are a few loads and one release store each, never
+     * block and never allocate, so the producer can be a driver callback
+     * that must return quickly. Head and tail live on separate cache lines
+     * and each side caches the other's index, so the line only moves when
+     * the queue looks full or empty.
+     */
+    template<typename T>
+    class SpscQueue {
+    public:
+        /**
+         * @brief Constructor
+         * @param capacity Minimum number of elements the queue holds, rounded up to a power of two
+         */
+        explicit SpscQueue(size_t capacity)
+            : slots_(roundUpToPowerOfTwo(capacity < 1 ? 1 : capacity)),
+              mask_(slots_.size() - 1),
+              head_(0),
+              cachedTail_(0),
+              tail_(0),
+              cachedHead_(0) {
+        }
+
+        SpscQueue(const SpscQueue &) = delete;
+        SpscQueue &operator=(const SpscQueue &) = delete;
+
+        /**
+         * @brief Append an element (producer thread only)
+         * @param value Element to move into the queue
+         * @return false if the queue is full; @p value is left untouched then
+         */
+        bool push(T &&value) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - cachedHead_ > mask_) {
+                cachedHead_ = head_.load(std::memory_order_acquire);
+                if (tail - cachedHead_ > mask_) {
+                    return false;
+                }
+            }
+            slots_[tail & mask_] = std::move(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Take the oldest element (consumer thread only)
+         *
+         * The slot is left moved-from, so resources such as a shared_ptr are
+         * released on the consumer side rather than when the slot is reused.
+         *
+         * @param value Output parameter receiving the element
+         * @return false if the queue is empty
+         */
+        bool pop(T &value) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == cachedTail_) {
+                cachedTail_ = tail_.load(std::memory_order_acquire);
+                if (head == cachedTail_) {
+                    return false;
+                }
+            }
+            value = std::move(slots_[head & mask_]);
+            slots_[head & mask_] = T();
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Number of queued elements; exact only on the producer or consumer thread
+         *
+         * Other threads get a snapshot that may already be stale. The head is
+         * loaded first so the result never underflows.
+         *
+         * @return Element count
+         */
+        size_t size() const {
+            size_t head = head_.load(std::memory_order_acquire);
+            size_t tail = tail_.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        /**
+         * @brief Check whether the queue holds no element
+         * @return true if empty
+         */
+        bool empty() const {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Number of elements the queue holds when full
+         * @return Capacity
+         */
+        size_t capacity() const {
+            return slots_.size();
+        }
+
+    private:
+        static size_t roundUpToPowerOfTwo(size_t value) {
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        std::vector<T> slots_;
+        const size_t mask_;
+
+        // Consumer side
+        alignas(64) std::atomic<size_t> head_;
+        size_t cachedTail_;
+
+        // Producer side
+        alignas(64) std::atomic<size_t> tail_;
+        size_t cachedHead_;
+    };
+} // namespace medical::imaging
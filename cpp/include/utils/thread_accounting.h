@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @class ThreadAccounting
+     * @brief CPU, scheduling and memory accounting for the pipeline threads
+     *
+     * Pipeline threads register themselves under a role ("capture-0",
+     * "publish-0", "monitor", ...). update() then reads the scheduler's view
+     * of every registered thread from /proc/self/task/<tid>: CPU time and
+     * run-queue wait from schedstat, context switches from status, and the
+     * policy, priority and last CPU from stat. getrusage(RUSAGE_THREAD) only
+     * reports on its caller, so the monitor thread cannot use it for the
+     * others; it is used for the calling thread when schedstat is missing.
+     *
+     * Threads count their own deadline misses with recordDeadlineMiss(); it
+     * is a thread-local increment.
+     */
+    class ThreadAccounting {
+    public:
+        /**
+         * @brief Accounting of one registered thread
+         */
+        struct ThreadStatistics {
+            pid_t tid;                      // Kernel thread ID
+            std::string role;               // Name the thread registered with
+            int policy;                     // SCHED_OTHER, SCHED_FIFO, SCHED_RR, ...
+            int priority;                   // Real-time priority (0 for normal threads)
+            int nice;                       // Nice value
+            int lastCpu;                    // CPU the thread last ran on
+            double cpuSeconds;              // CPU time since the thread started
+            double cpuPercent;              // CPU time over the last update interval, percent of one core
+            double runQueueWaitSeconds;     // Time spent runnable but waiting for a CPU
+            double runQueueWaitPercent;     // Run-queue wait over the last update interval, percent of wall time
+            uint64_t voluntarySwitches;     // Context switches the thread asked for (blocking)
+            uint64_t involuntarySwitches;   // Context switches forced by preemption
+            uint64_t deadlineMisses;        // Cycles the thread reported as late
+        };
+
+        /**
+         * @brief Memory totals of the process
+         */
+        struct MemoryStatistics {
+            uint64_t residentBytes;     // Resident set size (VmRSS)
+            uint64_t peakResidentBytes; // Largest resident set size (VmHWM)
+            uint64_t lockedBytes;       // Memory locked with mlock (VmLck)
+            uint64_t pinnedBytes;       // Memory pinned by the kernel, e.g. for DMA (VmPin)
+        };
+
+        /**
+         * @brief Register the calling thread
+         *
+         * Also names the thread (first 15 characters) so top, perf and
+         * Perfetto show the role. Registering again replaces the role.
+         *
+         * @param role Role of the thread
+         */
+        static void registerCurrentThread(const std::string &role);
+
+        /**
+         * @brief Remove the calling thread, e.g. before a pooled thread takes another role
+         */
+        static void unregisterCurrentThread();
+
+        /**
+         * @brief Count a missed deadline on the calling thread (no-op if it is not registered)
+         */
+        static void recordDeadlineMiss();
+
+        /**
+         * @brief Re-read the accounting of every registered thread
+         *
+         * Rates are taken over the interval since the previous call, so call
+         * it from one place at a steady pace. Threads that exited are dropped.
+         */
+        static void update();
+
+        /**
+         * @brief Get the accounting of every registered thread as of the last update()
+         * @return One entry per live registered thread, in registration order
+         */
+        static std::vector<ThreadStatistics> getThreadStatistics();
+
+        /**
+         * @brief Read the memory totals of the process
+         * @return Memory statistics, zero where /proc does not report them
+         */
+        static MemoryStatistics getMemoryStatistics();
+
+        /**
+         * @brief Get the name of a scheduling policy
+         * @param policy SCHED_* constant
+         * @return "other", "fifo", "rr", "batch", "idle", "deadline" or "unknown"
+         */
+        static const char *policyName(int policy);
+    };
+} // namespace medical::imaging
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace medical::imaging {
+    /**
+     * @enum SchedulingClass
+     * @brief Linux scheduling class of a placed thread
+     */
+    enum class SchedulingClass {
+        INHERIT, // Keep whatever the thread was created with
+        OTHER,   // SCHED_OTHER, priority is the nice value
+        BATCH,   // SCHED_BATCH, priority is the nice value
+        IDLE,    // SCHED_IDLE
+        FIFO,    // SCHED_FIFO, priority 1-99
+        RR       // SCHED_RR, priority 1-99
+    };
+
+    /**
+     * @class ThreadLayout
+     * @brief Declarative placement of every service thread: cores, scheduling class and priority
+     *
+     * A layout maps thread roles to placements. Roles are the names threads
+     * register with ThreadAccounting: "capture-<channel>" (the device or SDK
+     * callback thread), "publish-<channel>", "copy-<n>", "compress-<channel>",
+     * "notify", "monitor", "metrics", "control", "grpc", "recorder" and
+     * "subscriber-<name>". A placement for a role without the suffix
+     * ("publish") covers every thread of that kind; an exact role wins.
+     *
+     * The text form is a list of entries separated by ';' or newlines:
+     *
+     *     role=cpus[:class[:priority]]
+     *
+     * where cpus is a list such as "2", "4-7" or "0,2" ("*" for any), class
+     * one of other, batch, idle, fifo, rr or inherit, and priority the
+     * real-time priority for fifo/rr or the nice value otherwise. '#' starts
+     * a comment. For example:
+     *
+     *     capture=2:fifo:80; publish=3:fifo:70; copy=4-5:fifo:60; monitor=0:other:5
+     *
+     * Threads place themselves when they start (applyCurrentThread()), so
+     * the SDK callback thread is covered even though the service never
+     * creates it. A role the layout does not mention keeps the per-component
+     * options (threadAffinity, publishThreadAffinity, ...).
+     */
+    class ThreadLayout {
+    public:
+        /**
+         * @brief Cores, scheduling class and priority of one role
+         */
+        struct Placement {
+            std::string role;               // Role or role prefix the placement applies to
+            std::vector<int> cpus;          // Allowed CPUs, empty for any
+            SchedulingClass schedulingClass;
+            int priority;                   // RT priority for FIFO/RR, nice value otherwise
+
+            Placement() : schedulingClass(SchedulingClass::INHERIT), priority(0) {
+            }
+
+            /**
+             * @brief Check whether the placement asks for a real-time class
+             * @return true for FIFO and RR
+             */
+            bool isRealtime() const {
+                return schedulingClass == SchedulingClass::FIFO || schedulingClass == SchedulingClass::RR;
+            }
+
+            /**
+             * @brief Describe the placement in the layout's text form
+             * @return e.g. "cpus=2-3 fifo:80"
+             */
+            std::string toString() const;
+        };
+
+        /**
+         * @brief What applyCurrentThread() did for one thread
+         */
+        struct AppliedThread {
+            std::string role;    // Role the thread started with
+            pid_t tid;           // Kernel thread ID
+            std::string placement; // Placement applied, empty if the layout did not cover the role
+            bool ok;             // Every part of the placement took effect
+            std::string error;   // What failed, empty if ok
+        };
+
+        /**
+         * @brief Outcome of validate()
+         */
+        struct Validation {
+            std::vector<std::string> errors;   // Placements that cannot work (offline CPU, bad priority)
+            std::vector<std::string> warnings; // Placements that work but defeat the isolation
+
+            bool ok() const {
+                return errors.empty();
+            }
+        };
+
+        /**
+         * @brief Parse a layout from its text form
+         * @param text Layout text, or the path of a file holding it
+         * @param layout Output parameter receiving the layout
+         * @param error Output parameter receiving the reason on failure
+         * @return true if the text parsed
+         */
+        static bool parse(const std::string &text, ThreadLayout &layout, std::string &error);
+
+        /**
+         * @brief Set or replace the placement of a role
+         * @param placement Placement, its role names the entry
+         */
+        void setPlacement(const Placement &placement);
+
+        /**
+         * @brief Find the placement that applies to a role
+         * @param role Thread role, e.g. "publish-0"
+         * @return Placement of the exact role, else of its prefix, nullptr if none
+         */
+        const Placement *findPlacement(const std::string &role) const;
+
+        /**
+         * @brief Get every placement
+         * @return Placements in the order they were declared
+         */
+        const std::vector<Placement> &getPlacements() const;
+
+        /**
+         * @brief Check the layout against the online, isolated (isolcpus) and nohz_full CPUs
+         * @return Errors and warnings, one sentence each
+         */
+        Validation validate() const;
+
+        /**
+         * @brief Describe the layout in its text form
+         * @return Layout text, entries separated by "; "
+         */
+        std::string toString() const;
+
+        /**
+         * @brief Make a layout the one threads of this process place themselves by
+         * @param layout Layout to install
+         */
+        static void setActive(const ThreadLayout &layout);
+
+        /**
+         * @brief Get the active layout
+         * @return Active layout, empty if none was installed
+         */
+        static std::shared_ptr<const ThreadLayout> getActive();
+
+        /**
+         * @brief Check whether the active layout places a role
+         * @param role Thread role
+         * @return true if applyCurrentThread(role) takes over the thread's placement
+         */
+        static bool isPlaced(const std::string &role);
+
+        /**
+         * @brief Place the calling thread by the active layout and register it with ThreadAccounting
+         * @param role Role of the thread
+         * @return true if the layout covers the role, so the caller must not apply its own options
+         */
+        static bool applyCurrentThread(const std::string &role);
+
+        /**
+         * @brief Place the threads that are already running by the active layout
+         *
+         * For a layout installed while capturing: every thread registered
+         * with ThreadAccounting whose role the layout covers is moved by its
+         * kernel thread ID. Threads whose role the layout no longer covers
+         * keep the placement they have.
+         *
+         * @return Number of threads placed
+         */
+        static size_t applyToRunningThreads();
+
+        /**
+         * @brief Get what applyCurrentThread() did, one entry per call
+         * @return Applied threads in the order they started
+         */
+        static std::vector<AppliedThread> getAppliedThreads();
+
+        /**
+         * @brief Parse a scheduling class name
+         * @param name "other", "batch", "idle", "fifo", "rr" or "inherit"
+         * @param schedulingClass Output parameter receiving the class
+         * @return true if the name is known
+         */
+        static bool parseSchedulingClass(const std::string &name, SchedulingClass &schedulingClass);
+
+        /**
+         * @brief Get the name of a scheduling class
+         * @param schedulingClass Scheduling class
+         * @return Lower-case class name
+         */
+        static const char *toString(SchedulingClass schedulingClass);
+
+    private:
+        std::vector<Placement> placements_;
+    };
+} // namespace medical::imaging
@@ -0,0 +1,650 @@
+#include "api/control_server.h"
+#include "api/imaging_service.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+
+namespace medical::imaging {
+    // Largest message either side sends; settings and ring lists are a few hundred bytes
+    constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024;
+
+    // How often the server thread checks for a stop request while idle
+    constexpr int POLL_INTERVAL_MS = 250;
+
+    using json = nlohmann::json;
+
+    namespace {
+        bool fillSocketAddress(const std::string &path, sockaddr_un &address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size());
+            return true;
+        }
+
+        // One message: the header, the payload and optionally a descriptor through SCM_RIGHTS
+        bool sendMessage(int fd, const void *header, size_t headerSize, const std::string &payload, int descriptor) {
+            iovec iov[2] = {{const_cast<void *>(header), headerSize},
+                            {const_cast<char *>(payload.data()), payload.size()}};
+            char control[CMSG_SPACE(sizeof(int))] = {};
+            msghdr message{};
+            message.msg_iov = iov;
+            message.msg_iovlen = payload.empty() ? 1 : 2;
+            if (descriptor >= 0) {
+                message.msg_control = control;
+                message.msg_controllen = sizeof(control);
+                cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_RIGHTS;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+                std::memcpy(CMSG_DATA(cmsg), &descriptor, sizeof(int));
+            }
+
+            ssize_t sent;
+            do {
+                sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+            } while (sent < 0 && errno == EINTR);
+            return sent == static_cast<ssize_t>(headerSize + payload.size());
+        }
+
+        // One message into buffer; a passed descriptor goes to *descriptor, or is closed if unwanted
+        ssize_t receiveMessage(int fd, std::vector<char> &buffer, int *descriptor) {
+            iovec iov{buffer.data(), buffer.size()};
+            char control[CMSG_SPACE(sizeof(int))] = {};
+            msghdr message{};
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+
+            ssize_t received;
+            do {
+                received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+            } while (received < 0 && errno == EINTR);
+
+            for (cmsghdr *cmsg = CMSG_FIRSTHDR(&message); cmsg; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                    int passed = -1;
+                    std::memcpy(&passed, CMSG_DATA(cmsg), sizeof(int));
+                    if (descriptor && *descriptor < 0) {
+                        *descriptor = passed;
+                    } else {
+                        close(passed);
+                    }
+                }
+            }
+            if (received > 0 && (message.msg_flags & MSG_TRUNC)) {
+                return -1;
+            }
+            return received;
+        }
+
+        json settingsToJson(const ImagingService::LiveSettings &settings) {
+            json regions = json::array();
+            for (const auto &roi: settings.regionsOfInterest) {
+                regions.push_back({roi.x, roi.y, roi.width, roi.height});
+            }
+            return {
+                {"regions_of_interest", regions},
+                {"preview_frame_rate", settings.previewFrameRate},
+                {"duplicate_policy", FrameFingerprint::toString(settings.duplicatePolicy)},
+                {"duplicate_keep_alive_rate", settings.duplicateKeepAliveRate},
+                {"fingerprint_samples", settings.fingerprintSamples},
+                {"thread_layout", settings.threadLayout},
+                {"log_performance_stats", settings.logPerformanceStats},
+                {"performance_log_interval_ms", settings.performanceLogIntervalMs},
+                {"enable_tracing", settings.enableTracing},
+                {"trace_file", settings.traceFile},
+                {"trace_window_ms", settings.traceWindowMs},
+                {"trace_on_drop", settings.traceOnDrop}
+            };
+        }
+
+        // Join a path a peer sent to the directory it must stay in. Absolute paths and ".." components
+        // are refused, as is everything when no directory is configured.
+        bool resolveUnder(const std::string &directory, const std::string &path, std::string &resolved) {
+            if (directory.empty() || path.empty() || path.front() == '/') {
+                return false;
+            }
+            size_t start = 0;
+            while (start <= path.size()) {
+                size_t end = path.find('/', start);
+                if (end == std::string::npos) {
+                    end = path.size();
+                }
+                if (path.compare(start, end - start, "..") == 0) {
+                    return false;
+                }
+                start = end + 1;
+            }
+            resolved = directory.back() == '/' ? directory + path : directory + "/" + path;
+            return true;
+        }
+
+        // Apply the keys present in changes; the others keep their current value
+        bool applySettingsJson(const json &changes, ImagingService::LiveSettings &settings, std::string &error) {
+            if (!changes.is_object()) {
+                error = "expected a JSON object";
+                return false;
+            }
+
+            for (const auto &[key, value]: changes.items()) {
+                if (key == "regions_of_interest") {
+                    if (!value.is_array() || value.size() != settings.regionsOfInterest.size()) {
+                        error = "regions_of_interest needs one [x, y, width, height] per channel";
+                        return false;
+                    }
+                    for (size_t i = 0; i < value.size(); ++i) {
+                        const json &roi = value[i];
+                        if (!roi.is_array() || roi.size() != 4) {
+                            error = "regions_of_interest needs one [x, y, width, height] per channel";
+                            return false;
+                        }
+                        settings.regionsOfInterest[i] = ImagingService::RegionOfInterest(
+                            roi[0].get<int>(), roi[1].get<int>(), roi[2].get<int>(), roi[3].get<int>());
+                    }
+                } else if (key == "preview_frame_rate") {
+                    settings.previewFrameRate = value.get<double>();
+                } else if (key == "duplicate_policy") {
+                    if (!FrameFingerprint::parsePolicy(value.get<std::string>(), settings.duplicatePolicy)) {
+                        error = "unknown duplicate_policy " + value.dump();
+                        return false;
+                    }
+                } else if (key == "duplicate_keep_alive_rate") {
+                    settings.duplicateKeepAliveRate = value.get<double>();
+                } else if (key == "fingerprint_samples") {
+                    settings.fingerprintSamples = value.get<size_t>();
+                } else if (key == "thread_layout") {
+                    settings.threadLayout = value.get<std::string>();
+                } else if (key == "log_performance_stats") {
+                    settings.logPerformanceStats = value.get<bool>();
+                } else if (key == "performance_log_interval_ms") {
+                    settings.performanceLogIntervalMs = value.get<int>();
+                } else if (key == "enable_tracing") {
+                    settings.enableTracing = value.get<bool>();
+                } else if (key == "trace_file") {
+                    // A peer must not pick a file for the daemon to write; set on the command line only.
+                    // Echoing the current value back, as a round trip of GET_SETTINGS does, is fine.
+                    if (value.get<std::string>() != settings.traceFile) {
+                        error = "trace_file cannot be changed through the control socket";
+                        return false;
+                    }
+                } else if (key == "trace_window_ms") {
+                    settings.traceWindowMs = value.get<unsigned int>();
+                } else if (key == "trace_on_drop") {
+                    settings.traceOnDrop = value.get<bool>();
+                } else {
+                    error = "unknown setting " + key;
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace
+
+    ControlServer::ControlServer(const Config &config)
+        : config_(config),
+          service_(nullptr),
+          isRunning_(false),
+          stopRequested_(false),
+          attachCount_(0),
+          listenFd_(-1) {
+    }
+
+    ControlServer::~ControlServer() {
+        stop();
+    }
+
+    ControlServer::Status ControlServer::start(ImagingService &service) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+
+        sockaddr_un address{};
+        if (!fillSocketAddress(config_.socketPath, address) || config_.maxClients == 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        // A socket left by a daemon that crashed would refuse the bind
+        listenFd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        unlink(config_.socketPath.c_str());
+        if (listenFd_ < 0 ||
+            bind(listenFd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listenFd_, 16) != 0) {
+            MIVI_LOG_ERROR("Failed to listen on {}: {}", config_.socketPath, strerror(errno));
+            if (listenFd_ >= 0) {
+                close(listenFd_);
+                listenFd_ = -1;
+            }
+            return Status::BIND_FAILED;
+        }
+        if (chmod(config_.socketPath.c_str(), config_.socketMode) != 0) {
+            MIVI_LOG_ERROR("Failed to set the mode of {}: {}", config_.socketPath, strerror(errno));
+        }
+        if (!config_.clipDirectory.empty() && mkdir(config_.clipDirectory.c_str(), 0750) != 0 && errno != EEXIST) {
+            MIVI_LOG_ERROR("Failed to create the clip directory {}: {}", config_.clipDirectory, strerror(errno));
+        }
+
+        service_ = &service;
+        attachCount_ = 0;
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&ControlServer::serverThread, this);
+        return Status::OK;
+    }
+
+    ControlServer::Status ControlServer::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        close(listenFd_);
+        listenFd_ = -1;
+        unlink(config_.socketPath.c_str());
+        service_ = nullptr;
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool ControlServer::isRunning() const {
+        return isRunning_;
+    }
+
+    uint64_t ControlServer::getAttachCount() const {
+        return attachCount_.load(std::memory_order_relaxed);
+    }
+
+    void ControlServer::serverThread() {
+        // Never compete with the capture threads, even if started from a realtime thread
+        if (!ThreadLayout::applyCurrentThread("control")) {
+            sched_param param{};
+            param.sched_priority = 0;
+            pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+        }
+
+        std::vector<int> clients;
+        std::vector<pollfd> fds;
+        while (!stopRequested_) {
+            // Connections beyond maxClients wait in the backlog until one closes
+            fds.clear();
+            fds.push_back({clients.size() < config_.maxClients ? listenFd_ : -1, POLLIN, 0});
+            for (int client: clients) {
+                fds.push_back({client, POLLIN, 0});
+            }
+
+            int ready = poll(fds.data(), fds.size(), POLL_INTERVAL_MS);
+            if (ready <= 0) {
+                continue;
+            }
+
+            for (size_t i = fds.size() - 1; i > 0; --i) {
+                if (fds[i].revents && !handleMessage(fds[i].fd)) {
+                    close(fds[i].fd);
+                    clients.erase(clients.begin() + static_cast<std::ptrdiff_t>(i - 1));
+                }
+            }
+
+            if (fds[0].revents & POLLIN) {
+                int client = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+                if (client >= 0) {
+                    clients.push_back(client);
+                }
+            }
+        }
+
+        for (int client: clients) {
+            close(client);
+        }
+    }
+
+    bool ControlServer::handleMessage(int clientFd) {
+        std::vector<char> buffer(MAX_MESSAGE_SIZE);
+        ssize_t received = receiveMessage(clientFd, buffer, nullptr);
+        if (received <= 0) {
+            return false;
+        }
+
+        ControlReply reply{};
+        std::memcpy(reply.magic, "MVP1", sizeof(reply.magic));
+        reply.version = 1;
+        reply.status = CONTROL_STATUS_OK;
+        reply.pid = static_cast<uint32_t>(getpid());
+
+        ControlRequest request{};
+        if (static_cast<size_t>(received) < sizeof(request)) {
+            reply.status = CONTROL_STATUS_INVALID_REQUEST;
+            return sendMessage(clientFd, &reply, sizeof(reply), "", -1);
+        }
+        std::memcpy(&request, buffer.data(), sizeof(request));
+        if (std::memcmp(request.magic, "MVQ1", sizeof(request.magic)) != 0 || request.version != 1 ||
+            request.payloadSize != static_cast<size_t>(received) - sizeof(request)) {
+            reply.status = CONTROL_STATUS_INVALID_REQUEST;
+            return sendMessage(clientFd, &reply, sizeof(reply), "", -1);
+        }
+        std::string payload(buffer.data() + sizeof(request), request.payloadSize);
+        std::string ringName(request.ringName, strnlen(request.ringName, sizeof(request.ringName)));
+
+        std::string body;
+        int descriptor = -1;
+        int ownedDescriptor = -1; // Closed once sent, unlike the ring's own descriptor
+        std::shared_ptr<SharedMemory> ring; // Keeps the region open until the descriptor is sent
+        switch (request.command) {
+            case CONTROL_COMMAND_ATTACH: {
+                ring = service_->findSharedMemory(ringName);
+                if (!ring) {
+                    reply.status = CONTROL_STATUS_UNKNOWN_RING;
+                    break;
+                }
+                descriptor = ring->getFileDescriptor();
+                if (descriptor < 0) {
+                    reply.status = CONTROL_STATUS_NOT_SUPPORTED;
+                    break;
+                }
+                SharedMemory::Layout layout = ring->getLayout();
+                body.assign(reinterpret_cast<const char *>(&layout), sizeof(layout));
+                break;
+            }
+            case CONTROL_COMMAND_SUBSCRIBE: {
+                uint32_t slot = 0;
+                ucred peer{};
+                socklen_t peerSize = sizeof(peer);
+                ring = service_->findSharedMemory(ringName);
+                if (!ring) {
+                    reply.status = CONTROL_STATUS_UNKNOWN_RING;
+                    break;
+                }
+                if (payload.size() != sizeof(slot) ||
+                    getsockopt(clientFd, SOL_SOCKET, SO_PEERCRED, &peer, &peerSize) != 0) {
+                    reply.status = CONTROL_STATUS_INVALID_REQUEST;
+                    break;
+                }
+                std::memcpy(&slot, payload.data(), sizeof(slot));
+
+                // The ring keeps one end and signals it, the consumer polls the other
+                int eventDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+                if (eventDescriptor < 0) {
+                    reply.status = CONTROL_STATUS_NOT_SUPPORTED;
+                    break;
+                }
+                ownedDescriptor = dup(eventDescriptor);
+                if (ownedDescriptor < 0) {
+                    close(eventDescriptor);
+                    reply.status = CONTROL_STATUS_NOT_SUPPORTED;
+                    break;
+                }
+                if (ring->addReaderNotification(slot, peer.pid, eventDescriptor) != SharedMemory::Status::OK) {
+                    close(eventDescriptor);
+                    reply.status = CONTROL_STATUS_NOT_OWNER;
+                    break;
+                }
+                descriptor = ownedDescriptor;
+                break;
+            }
+            case CONTROL_COMMAND_LIST_RINGS:
+                for (const auto &name: service_->getSharedMemoryNames()) {
+                    body += name + "\n";
+                }
+                break;
+            case CONTROL_COMMAND_GET_SETTINGS:
+                body = settingsToJson(service_->getLiveSettings()).dump();
+                break;
+            case CONTROL_COMMAND_RECONFIGURE:
+                body = handleReconfigure(payload, reply.status);
+                break;
+            case CONTROL_COMMAND_SAVE_CLIP:
+                body = handleSaveClip(ringName, payload, reply.status);
+                break;
+            default:
+                reply.status = CONTROL_STATUS_INVALID_REQUEST;
+                break;
+        }
+
+        reply.payloadSize = static_cast<uint32_t>(body.size());
+        bool sent = sendMessage(clientFd, &reply, sizeof(reply), body, descriptor);
+        if (sent && descriptor >= 0 && request.command == CONTROL_COMMAND_ATTACH) {
+            attachCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (ownedDescriptor >= 0) {
+            close(ownedDescriptor);
+        }
+        return sent;
+    }
+
+    std::string ControlServer::handleReconfigure(const std::string &request, uint16_t &status) {
+        ImagingService::LiveSettings settings = service_->getLiveSettings();
+        std::string error;
+        try {
+            if (!applySettingsJson(json::parse(request), settings, error)) {
+                status = CONTROL_STATUS_INVALID_REQUEST;
+                return json{{"error", error}}.dump();
+            }
+        } catch (const std::exception &e) {
+            status = CONTROL_STATUS_INVALID_REQUEST;
+            return json{{"error", e.what()}}.dump();
+        }
+
+        ImagingService::Status result = service_->reconfigure(settings);
+        if (result != ImagingService::Status::OK) {
+            status = CONTROL_STATUS_REJECTED;
+            return json{{"error", "reconfigure failed with status " + std::to_string(static_cast<int>(result))}}.dump();
+        }
+        MIVI_LOG_INFO("Live settings changed through the control socket");
+        return settingsToJson(service_->getLiveSettings()).dump();
+    }
+
+    std::string ControlServer::handleSaveClip(const std::string &ringName, const std::string &request,
+                                              uint16_t &status) {
+        if (!service_->findSharedMemory(ringName)) {
+            status = CONTROL_STATUS_UNKNOWN_RING;
+            return "";
+        }
+
+        int64_t durationMs = 0;
+        std::string path;
+        try {
+            json arguments = json::parse(request);
+            durationMs = arguments.at("duration_ms").get<int64_t>();
+            path = arguments.at("path").get<std::string>();
+        } catch (const std::exception &e) {
+            status = CONTROL_STATUS_INVALID_REQUEST;
+            return json{{"error", e.what()}}.dump();
+        }
+        if (durationMs <= 0 || path.empty()) {
+            status = CONTROL_STATUS_INVALID_REQUEST;
+            return json{{"error", "duration_ms must be positive and path not empty"}}.dump();
+        }
+
+        std::string filePath;
+        if (!resolveUnder(config_.clipDirectory, path, filePath)) {
+            MIVI_LOG_WARNING("Refused clip path '{}' outside the clip directory", path);
+            status = CONTROL_STATUS_REJECTED;
+            return json{{"error", "path must be relative to the clip directory and not contain .."}}.dump();
+        }
+
+        ImagingService::Status result = service_->saveClip(ringName, std::chrono::milliseconds(durationMs), filePath);
+        if (result != ImagingService::Status::OK) {
+            status = CONTROL_STATUS_REJECTED;
+            return json{{"error", "saveClip failed with status " + std::to_string(static_cast<int>(result))}}.dump();
+        }
+        return "";
+    }
+
+    ControlClient::ControlClient()
+        : fd_(-1) {
+    }
+
+    ControlClient::~ControlClient() {
+        disconnect();
+    }
+
+    bool ControlClient::connect(const std::string &socketPath) {
+        disconnect();
+
+        sockaddr_un address{};
+        if (!fillSocketAddress(socketPath, address)) {
+            return false;
+        }
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return false;
+        }
+        if (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            MIVI_LOG_ERROR("Failed to connect to {}: {}", socketPath, strerror(errno));
+            close(fd);
+            return false;
+        }
+        fd_ = fd;
+        return true;
+    }
+
+    void ControlClient::disconnect() {
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    bool ControlClient::isConnected() const {
+        return fd_ >= 0;
+    }
+
+    std::shared_ptr<SharedMemory> ControlClient::attach(const std::string &ringName, SharedMemory::Config config) {
+        uint16_t status = CONTROL_STATUS_OK;
+        std::string reply;
+        int descriptor = -1;
+        bool answered = request(CONTROL_COMMAND_ATTACH, ringName, "", status, reply, &descriptor);
+        if (!answered || status != CONTROL_STATUS_OK || descriptor < 0 ||
+            reply.size() != sizeof(SharedMemory::Layout)) {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+            return nullptr;
+        }
+
+        config.name = ringName;
+        config.create = false;
+        config.attachDescriptor = descriptor;
+        std::memcpy(&config.attachLayout, reply.data(), sizeof(config.attachLayout));
+
+        // The ring maps its own duplicate of the descriptor
+        auto ring = std::make_shared<SharedMemory>(config);
+        SharedMemory::Status initStatus = ring->initialize();
+        close(descriptor);
+        return initStatus == SharedMemory::Status::OK ? ring : nullptr;
+    }
+
+    bool ControlClient::subscribe(const std::string &ringName, SharedMemory &ring) {
+        int slot = ring.getReaderSlot();
+        if (slot < 0) {
+            return false;
+        }
+
+        auto slotIndex = static_cast<uint32_t>(slot);
+        uint16_t status = CONTROL_STATUS_OK;
+        std::string reply;
+        int descriptor = -1;
+        bool answered = request(CONTROL_COMMAND_SUBSCRIBE, ringName,
+                                std::string(reinterpret_cast<const char *>(&slotIndex), sizeof(slotIndex)), status,
+                                reply, &descriptor);
+        if (!answered || status != CONTROL_STATUS_OK || descriptor < 0) {
+            if (descriptor >= 0) {
+                close(descriptor);
+            }
+            return false;
+        }
+        if (ring.setNotificationDescriptor(descriptor) != SharedMemory::Status::OK) {
+            close(descriptor);
+            return false;
+        }
+        return true;
+    }
+
+    bool ControlClient::listRings(std::vector<std::string> &names) {
+        uint16_t status = CONTROL_STATUS_OK;
+        std::string reply;
+        if (!request(CONTROL_COMMAND_LIST_RINGS, "", "", status, reply, nullptr) || status != CONTROL_STATUS_OK) {
+            return false;
+        }
+
+        names.clear();
+        size_t start = 0;
+        for (size_t end = reply.find('\n'); end != std::string::npos; end = reply.find('\n', start)) {
+            names.push_back(reply.substr(start, end - start));
+            start = end + 1;
+        }
+        return true;
+    }
+
+    bool ControlClient::getSettings(std::string &settings) {
+        uint16_t status = CONTROL_STATUS_OK;
+        return request(CONTROL_COMMAND_GET_SETTINGS, "", "", status, settings, nullptr) &&
+               status == CONTROL_STATUS_OK;
+    }
+
+    bool ControlClient::reconfigure(const std::string &changes, std::string &reply) {
+        uint16_t status = CONTROL_STATUS_OK;
+        return request(CONTROL_COMMAND_RECONFIGURE, "", changes, status, reply, nullptr) &&
+               status == CONTROL_STATUS_OK;
+    }
+
+    bool ControlClient::saveClip(const std::string &ringName, std::chrono::milliseconds duration,
+                                 const std::string &filePath, std::string &reply) {
+        uint16_t status = CONTROL_STATUS_OK;
+        std::string arguments = json{{"duration_ms", duration.count()}, {"path", filePath}}.dump();
+        return request(CONTROL_COMMAND_SAVE_CLIP, ringName, arguments, status, reply, nullptr) &&
+               status == CONTROL_STATUS_OK;
+    }
+
+    bool ControlClient::request(uint16_t command, const std::string &ringName, const std::string &payload,
+                                uint16_t &status, std::string &reply, int *descriptor) {
+        if (fd_ < 0 || ringName.size() >= sizeof(ControlRequest::ringName) ||
+            payload.size() > MAX_MESSAGE_SIZE - sizeof(ControlRequest)) {
+            return false;
+        }
+
+        ControlRequest request{};
+        std::memcpy(request.magic, "MVQ1", sizeof(request.magic));
+        request.version = 1;
+        request.command = command;
+        request.payloadSize = static_cast<uint32_t>(payload.size());
+        std::memcpy(request.ringName, ringName.c_str(), ringName.size());
+        if (!sendMessage(fd_, &request, sizeof(request), payload, -1)) {
+            return false;
+        }
+
+        std::vector<char> buffer(MAX_MESSAGE_SIZE);
+        ssize_t received = receiveMessage(fd_, buffer, descriptor);
+        ControlReply header{};
+        if (received < static_cast<ssize_t>(sizeof(header))) {
+            return false;
+        }
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        if (std::memcmp(header.magic, "MVP1", sizeof(header.magic)) != 0 || header.version != 1 ||
+            header.payloadSize != static_cast<size_t>(received) - sizeof(header)) {
+            return false;
+        }
+
+        status = header.status;
+        reply.assign(buffer.data() + sizeof(header), header.payloadSize);
+        return true;
+    }
+} // namespace medical::imaging
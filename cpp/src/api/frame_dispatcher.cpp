@@ -0,0 +1,323 @@
+#include "api/frame_dispatcher.h"
+
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+#include "utils/futex.h"
+#include "utils/mpmc_queue.h"
+#include "utils/thread_layout.h"
+
+namespace medical::imaging {
+    // How long idle delivery threads and blocked publishers sleep before re-checking for unsubscribe
+    constexpr auto CLOSE_CHECK_INTERVAL = std::chrono::milliseconds(100);
+
+    struct FrameDispatcher::Subscriber {
+        /**
+         * @brief A frame waiting in a subscriber's queue
+         */
+        struct Delivery {
+            std::shared_ptr<Frame> frame;
+            std::chrono::steady_clock::time_point queuedAt; // When dispatch() enqueued it
+        };
+
+        int id;
+        SubscriptionConfig config;
+        FrameHandler handler;
+        std::unique_ptr<MpmcQueue<Delivery>> queue; // Null for inline delivery
+        std::thread thread;
+        std::atomic<bool> closed;
+        std::atomic<bool> scheduled;       // An executor drain task is pending or running
+        std::atomic<uint32_t> activeHandlers; // Handler calls in progress
+        std::atomic<uint32_t> frameDoorbell;  // Futex word bumped after every queued frame
+        std::atomic<uint32_t> frameWaiters;
+        std::atomic<uint32_t> spaceDoorbell;  // Futex word bumped after every delivered frame (BLOCK policy)
+        std::atomic<uint32_t> spaceWaiters;
+        std::atomic<uint64_t> framesDelivered;
+        std::atomic<uint64_t> framesDropped;
+        std::atomic<uint64_t> maxLagFrames;
+        LatencyHistogram queueWaitHistogram;
+        LatencyHistogram handleTimeHistogram;
+
+        Subscriber() : id(0), closed(false), scheduled(false), activeHandlers(0), frameDoorbell(0), frameWaiters(0),
+                       spaceDoorbell(0), spaceWaiters(0), framesDelivered(0), framesDropped(0), maxLagFrames(0) {
+        }
+
+        void handle(const Delivery &delivery) {
+            // Counted before checking closed, so close() can wait for calls that got past the check
+            activeHandlers.fetch_add(1, std::memory_order_seq_cst);
+            if (!closed.load(std::memory_order_seq_cst)) {
+                auto start = std::chrono::steady_clock::now();
+                queueWaitHistogram.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(start - delivery.queuedAt).count()));
+                handler(delivery.frame);
+                handleTimeHistogram.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count()));
+                framesDelivered.fetch_add(1, std::memory_order_relaxed);
+            }
+            activeHandlers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    };
+
+    FrameDispatcher::FrameDispatcher()
+        : subscribers_(std::make_shared<const SubscriberList>()),
+          subscriberCount_(0),
+          nextId_(1) {
+    }
+
+    FrameDispatcher::~FrameDispatcher() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto subscribers = std::atomic_load(&subscribers_);
+        std::atomic_store(&subscribers_, std::make_shared<const SubscriberList>());
+        subscriberCount_ = 0;
+        for (const auto &subscriber: *subscribers) {
+            close(*subscriber);
+        }
+    }
+
+    int FrameDispatcher::subscribe(FrameHandler handler, const SubscriptionConfig &config) {
+        if (!handler) {
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto subscriber = std::make_shared<Subscriber>();
+        subscriber->id = nextId_++;
+        subscriber->config = config;
+        if (subscriber->config.name.empty()) {
+            subscriber->config.name = "subscriber" + std::to_string(subscriber->id);
+        }
+        subscriber->handler = std::move(handler);
+
+        // Inline subscribers run on the publishing thread and need no queue
+        if (config.dedicatedThread || config.executor) {
+            size_t depth = config.policy == DropPolicy::LATEST_ONLY ? 1 : std::max<size_t>(1, config.queueDepth);
+            subscriber->queue = std::make_unique<MpmcQueue<Subscriber::Delivery>>(depth);
+        }
+        if (config.dedicatedThread) {
+            subscriber->thread = std::thread(&FrameDispatcher::subscriberThread, subscriber);
+        }
+
+        auto subscribers = std::make_shared<SubscriberList>(*std::atomic_load(&subscribers_));
+        subscribers->push_back(subscriber);
+        std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(subscribers)));
+        subscriberCount_.fetch_add(1, std::memory_order_release);
+        return subscriber->id;
+    }
+
+    bool FrameDispatcher::unsubscribe(int id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto current = std::atomic_load(&subscribers_);
+        auto it = std::find_if(current->begin(), current->end(),
+                               [id](const std::shared_ptr<Subscriber> &subscriber) { return subscriber->id == id; });
+        if (it == current->end()) {
+            return false;
+        }
+
+        std::shared_ptr<Subscriber> subscriber = *it;
+        auto subscribers = std::make_shared<SubscriberList>();
+        for (const auto &other: *current) {
+            if (other != subscriber) {
+                subscribers->push_back(other);
+            }
+        }
+        std::atomic_store(&subscribers_, std::shared_ptr<const SubscriberList>(std::move(subscribers)));
+        subscriberCount_.fetch_sub(1, std::memory_order_release);
+
+        close(*subscriber);
+        return true;
+    }
+
+    void FrameDispatcher::dispatch(const std::shared_ptr<Frame> &frame) {
+        // Nobody subscribed: skip the list load on the publishing path
+        if (!frame || subscriberCount_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+
+        auto subscribers = std::atomic_load(&subscribers_);
+        for (const auto &subscriber: *subscribers) {
+            enqueue(subscriber, frame);
+        }
+    }
+
+    void FrameDispatcher::enqueue(const std::shared_ptr<Subscriber> &subscriber, const std::shared_ptr<Frame> &frame) {
+        Subscriber::Delivery delivery{frame, std::chrono::steady_clock::now()};
+        if (!subscriber->queue) {
+            subscriber->handle(delivery);
+            return;
+        }
+
+        auto &queue = *subscriber->queue;
+        Subscriber::Delivery stale;
+        switch (subscriber->config.policy) {
+            case DropPolicy::LATEST_ONLY:
+                // Whatever is still queued is older than this frame
+                while (queue.pop(stale)) {
+                    subscriber->framesDropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                [[fallthrough]];
+            case DropPolicy::DROP_OLDEST:
+                while (!queue.push(std::move(delivery))) {
+                    if (queue.pop(stale)) {
+                        subscriber->framesDropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                break;
+            case DropPolicy::BLOCK:
+                while (!queue.push(std::move(delivery))) {
+                    if (subscriber->closed.load(std::memory_order_acquire)) {
+                        subscriber->framesDropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    uint32_t doorbell = subscriber->spaceDoorbell.load(std::memory_order_acquire);
+                    subscriber->spaceWaiters.fetch_add(1, std::memory_order_seq_cst);
+                    if (queue.size() >= queue.capacity() && !subscriber->closed.load(std::memory_order_acquire)) {
+                        futex::wait(&subscriber->spaceDoorbell, doorbell, CLOSE_CHECK_INTERVAL);
+                    }
+                    subscriber->spaceWaiters.fetch_sub(1, std::memory_order_seq_cst);
+                }
+                break;
+        }
+        stale.frame.reset();
+
+        // Track the deepest the queue got, the subscriber's worst lag
+        uint64_t lag = queue.size();
+        uint64_t maxLag = subscriber->maxLagFrames.load(std::memory_order_relaxed);
+        while (lag > maxLag && !subscriber->maxLagFrames.compare_exchange_weak(maxLag, lag,
+                                                                               std::memory_order_relaxed)) {
+        }
+
+        if (subscriber->config.dedicatedThread) {
+            futex::ring(subscriber->frameDoorbell, subscriber->frameWaiters);
+        } else {
+            schedule(subscriber);
+        }
+    }
+
+    void FrameDispatcher::deliver(Subscriber &subscriber) {
+        Subscriber::Delivery delivery;
+        while (!subscriber.closed.load(std::memory_order_acquire) && subscriber.queue->pop(delivery)) {
+            subscriber.handle(delivery);
+
+            // Release the frame here rather than when the cell is reused
+            delivery.frame.reset();
+            futex::ring(subscriber.spaceDoorbell, subscriber.spaceWaiters);
+        }
+    }
+
+    void FrameDispatcher::subscriberThread(const std::shared_ptr<Subscriber> &subscriber) {
+        if (!ThreadLayout::applyCurrentThread("subscriber-" + subscriber->config.name) &&
+            subscriber->config.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(subscriber->config.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        while (!subscriber->closed.load(std::memory_order_acquire)) {
+            // Read the doorbell before looking at the queue, so a frame queued after the check wakes us
+            uint32_t doorbell = subscriber->frameDoorbell.load(std::memory_order_acquire);
+            deliver(*subscriber);
+
+            subscriber->frameWaiters.fetch_add(1, std::memory_order_seq_cst);
+            if (subscriber->queue->empty() && !subscriber->closed.load(std::memory_order_acquire)) {
+                futex::wait(&subscriber->frameDoorbell, doorbell, CLOSE_CHECK_INTERVAL);
+            }
+            subscriber->frameWaiters.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void FrameDispatcher::schedule(const std::shared_ptr<Subscriber> &subscriber) {
+        // One drain task at a time keeps deliveries in order and the handler single-threaded
+        if (subscriber->scheduled.exchange(true, std::memory_order_seq_cst)) {
+            return;
+        }
+
+        subscriber->config.executor([subscriber]() {
+            while (true) {
+                deliver(*subscriber);
+                subscriber->scheduled.store(false, std::memory_order_seq_cst);
+
+                // A frame queued while we were finishing saw scheduled set and left it to us
+                if (subscriber->closed.load(std::memory_order_acquire) || subscriber->queue->empty() ||
+                    subscriber->scheduled.exchange(true, std::memory_order_seq_cst)) {
+                    return;
+                }
+            }
+        });
+    }
+
+    void FrameDispatcher::close(Subscriber &subscriber) {
+        subscriber.closed.store(true, std::memory_order_seq_cst);
+        futex::ring(subscriber.frameDoorbell, subscriber.frameWaiters);
+        futex::ring(subscriber.spaceDoorbell, subscriber.spaceWaiters);
+        if (subscriber.thread.joinable()) {
+            subscriber.thread.join();
+        }
+
+        // Inline and executor deliveries may still be inside the handler
+        while (subscriber.activeHandlers.load(std::memory_order_seq_cst) > 0) {
+            std::this_thread::yield();
+        }
+
+        // Give the queued capture buffers back now instead of when the last reference goes
+        if (subscriber.queue) {
+            Subscriber::Delivery delivery;
+            while (subscriber.queue->pop(delivery)) {
+                subscriber.framesDropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t FrameDispatcher::getSubscriberCount() const {
+        return subscriberCount_.load(std::memory_order_acquire);
+    }
+
+    std::vector<FrameDispatcher::SubscriberStatistics> FrameDispatcher::getSubscriberStatistics() const {
+        std::vector<SubscriberStatistics> result;
+        auto subscribers = std::atomic_load(&subscribers_);
+        result.reserve(subscribers->size());
+        for (const auto &subscriber: *subscribers) {
+            SubscriberStatistics stats;
+            stats.id = subscriber->id;
+            stats.name = subscriber->config.name;
+            stats.policy = subscriber->config.policy;
+            stats.framesDelivered = subscriber->framesDelivered.load(std::memory_order_relaxed);
+            stats.framesDropped = subscriber->framesDropped.load(std::memory_order_relaxed);
+            stats.lagFrames = subscriber->queue ? subscriber->queue->size() : 0;
+            stats.maxLagFrames = subscriber->maxLagFrames.load(std::memory_order_relaxed);
+            stats.queueWait = subscriber->queueWaitHistogram.snapshot();
+            stats.handleTime = subscriber->handleTimeHistogram.snapshot();
+            result.push_back(std::move(stats));
+        }
+        return result;
+    }
+
+    std::map<std::string, std::string> FrameDispatcher::getStatisticsMap() const {
+        std::map<std::string, std::string> map;
+        auto subscribers = getSubscriberStatistics();
+        map["subscriber_count"] = std::to_string(subscribers.size());
+        for (const auto &stats: subscribers) {
+            std::string prefix = "subscriber_" + stats.name + "_";
+            map[prefix + "policy"] = toString(stats.policy);
+            map[prefix + "frames_delivered"] = std::to_string(stats.framesDelivered);
+            map[prefix + "frames_dropped"] = std::to_string(stats.framesDropped);
+            map[prefix + "lag_frames"] = std::to_string(stats.lagFrames);
+            map[prefix + "max_lag_frames"] = std::to_string(stats.maxLagFrames);
+            appendHistogramStatistics(map, prefix + "queue_wait", stats.queueWait);
+            appendHistogramStatistics(map, prefix + "handle_time", stats.handleTime);
+        }
+        return map;
+    }
+
+    const char *FrameDispatcher::toString(DropPolicy policy) {
+        switch (policy) {
+            case DropPolicy::BLOCK: return "block";
+            case DropPolicy::DROP_OLDEST: return "drop_oldest";
+            case DropPolicy::LATEST_ONLY: return "latest_only";
+        }
+        return "unknown";
+    }
+} // namespace medical::imaging
@@ -0,0 +1,804 @@
+#include "api/grpc_server.h"
+#include "api/imaging_service.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace medical::imaging {
+    namespace {
+        // How long a feed sleeps waiting for the next frame before re-checking for stop
+        constexpr unsigned int FRAME_WAIT_MS = 10;
+        // Payload buffers kept for reuse, so large frames do not fault in fresh pages every time
+        constexpr size_t MAX_POOLED_BUFFERS = 8;
+
+        // Method paths of proto/imaging_service.proto
+        constexpr std::string_view STREAM_FRAMES_METHOD = "/medical.imaging.ImagingService/StreamFrames";
+        constexpr std::string_view GET_FRAME_METHOD = "/medical.imaging.ImagingService/GetFrame";
+        constexpr std::string_view GET_STATISTICS_METHOD = "/medical.imaging.ImagingService/GetStatistics";
+
+        // The protobuf wire format is written by hand: the generated FrameMetadata and ImagingService
+        // classes would collide with ours in medical::imaging, and the payload goes out as its own slice
+        enum WireType : uint32_t {
+            VARINT = 0,
+            FIXED64 = 1,
+            LENGTH_DELIMITED = 2,
+            FIXED32 = 5
+        };
+
+        void putVarint(std::string &out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        void putTag(std::string &out, uint32_t field, WireType type) {
+            putVarint(out, (static_cast<uint64_t>(field) << 3) | type);
+        }
+
+        // proto3 leaves fields holding their default value out
+        void putUint(std::string &out, uint32_t field, uint64_t value) {
+            if (value != 0) {
+                putTag(out, field, VARINT);
+                putVarint(out, value);
+            }
+        }
+
+        void putBytes(std::string &out, uint32_t field, std::string_view value) {
+            putTag(out, field, LENGTH_DELIMITED);
+            putVarint(out, value.size());
+            out.append(value.data(), value.size());
+        }
+
+        void putString(std::string &out, uint32_t field, std::string_view value) {
+            if (!value.empty()) {
+                putBytes(out, field, value);
+            }
+        }
+
+        void putMapEntry(std::string &out, uint32_t field, std::string_view key, std::string_view value) {
+            std::string entry;
+            putString(entry, 1, key);
+            putString(entry, 2, value);
+            putBytes(out, field, entry);
+        }
+
+        bool getVarint(const uint8_t *&in, const uint8_t *end, uint64_t &value) {
+            value = 0;
+            for (unsigned shift = 0; shift < 64 && in < end; shift += 7) {
+                uint8_t byte = *in++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Calls visit(field, varint) or visit(field, bytes) for the fields of a message, skipping fixed-size ones
+        template<typename VarintVisitor, typename BytesVisitor>
+        bool parseMessage(std::string_view data, VarintVisitor visitVarint, BytesVisitor visitBytes) {
+            const auto *in = reinterpret_cast<const uint8_t *>(data.data());
+            const uint8_t *end = in + data.size();
+            while (in < end) {
+                uint64_t key = 0;
+                uint64_t value = 0;
+                if (!getVarint(in, end, key)) {
+                    return false;
+                }
+                auto field = static_cast<uint32_t>(key >> 3);
+                switch (key & 7) {
+                    case VARINT:
+                        if (!getVarint(in, end, value)) {
+                            return false;
+                        }
+                        visitVarint(field, value);
+                        break;
+                    case FIXED64:
+                        if (end - in < 8) {
+                            return false;
+                        }
+                        in += 8;
+                        break;
+                    case LENGTH_DELIMITED:
+                        if (!getVarint(in, end, value) || value > static_cast<uint64_t>(end - in)) {
+                            return false;
+                        }
+                        visitBytes(field, std::string_view(reinterpret_cast<const char *>(in), value));
+                        in += value;
+                        break;
+                    case FIXED32:
+                        if (end - in < 4) {
+                            return false;
+                        }
+                        in += 4;
+                        break;
+                    default:
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        std::string flatten(const grpc::ByteBuffer &buffer) {
+            std::vector<grpc::Slice> slices;
+            std::string out;
+            if (buffer.Dump(&slices).ok()) {
+                for (const auto &slice: slices) {
+                    out.append(reinterpret_cast<const char *>(slice.begin()), slice.size());
+                }
+            }
+            return out;
+        }
+
+        int64_t nanosecondsSinceEpoch(std::chrono::system_clock::time_point time) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+        }
+
+        /**
+         * @brief Recycles the buffers frame payloads are copied into while gRPC still references them
+         */
+        class PayloadPool : public std::enable_shared_from_this<PayloadPool> {
+        public:
+            struct Buffer {
+                std::shared_ptr<PayloadPool> pool; // Set while gRPC holds the buffer
+                std::vector<uint8_t> data;
+            };
+
+            ~PayloadPool() {
+                for (Buffer *buffer: free_) {
+                    delete buffer;
+                }
+            }
+
+            Buffer *acquire(size_t size) {
+                Buffer *buffer = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!free_.empty()) {
+                        buffer = free_.back();
+                        free_.pop_back();
+                    }
+                }
+                if (!buffer) {
+                    buffer = new Buffer();
+                }
+                buffer->pool = shared_from_this();
+                buffer->data.resize(size);
+                return buffer;
+            }
+
+            // Slice destructor: gRPC is done with the payload
+            static void release(void *userData) {
+                auto *buffer = static_cast<Buffer *>(userData);
+                std::shared_ptr<PayloadPool> pool = std::move(buffer->pool);
+                std::lock_guard<std::mutex> lock(pool->mutex_);
+                if (pool->free_.size() < MAX_POOLED_BUFFERS) {
+                    pool->free_.push_back(buffer);
+                } else {
+                    delete buffer;
+                }
+            }
+
+        private:
+            std::mutex mutex_;
+            std::vector<Buffer *> free_;
+        };
+
+        /**
+         * @brief One frame encoded as a FrameResponse, shared by every call that sends it
+         *
+         * The message is the metadata fields, then the image_data key and
+         * length, then the payload; calls that did not ask for image data
+         * send the first slice only.
+         */
+        struct EncodedFrame {
+            grpc::Slice fields;    // frame_id, timestamp and metadata
+            grpc::Slice imageKey;  // image_data key and length, empty without a payload
+            grpc::Slice payload;   // Copy of the ring payload, empty without a payload
+            bool hasPayload = false;
+        };
+    } // namespace
+
+    class GrpcServer::Impl : public grpc::CallbackGenericService {
+    public:
+        class Call;
+
+        /**
+         * @brief Reads one ring and hands every frame to the calls subscribed to it
+         */
+        class Feed {
+        public:
+            Feed(Impl &server, std::string encoding) : server_(server), encoding_(std::move(encoding)) {
+            }
+
+            bool attach(const SharedMemory::Config &ringConfig) {
+                SharedMemory::Config readerConfig = ringConfig;
+                readerConfig.create = false;
+                readerConfig.readerMode = ReaderMode::LOSSY;
+                readerConfig.lockInMemory = false;
+                reader_ = std::make_unique<SharedMemory>(readerConfig);
+                if (reader_->initialize() != SharedMemory::Status::OK) {
+                    MIVI_LOG_ERROR("gRPC server failed to attach to shared memory {}", ringConfig.name);
+                    reader_.reset();
+                    return false;
+                }
+                return true;
+            }
+
+            void start() {
+                stopRequested_ = false;
+                thread_ = std::thread(&Feed::feedThread, this);
+            }
+
+            void stop() {
+                stopRequested_ = true;
+                if (thread_.joinable()) {
+                    thread_.join();
+                }
+            }
+
+            const std::string &getEncoding() const {
+                return encoding_;
+            }
+
+            bool subscribe(Call *call) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (closed_) {
+                    return false;
+                }
+                calls_.push_back(call);
+                return true;
+            }
+
+            void unsubscribe(Call *call) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                calls_.erase(std::remove(calls_.begin(), calls_.end(), call), calls_.end());
+            }
+
+            // Finish every subscribed call; new ones are refused from here on
+            void close();
+
+        private:
+            void feedThread();
+            std::shared_ptr<const EncodedFrame> encode(const Frame &frame, bool includePayload);
+
+            Impl &server_;
+            std::string encoding_; // Reported in additional_metadata["encoding"]
+            std::unique_ptr<SharedMemory> reader_;
+            std::thread thread_;
+            std::atomic<bool> stopRequested_{false};
+            std::mutex mutex_; // Guards calls_ and closed_, held while frames are handed out
+            std::vector<Call *> calls_;
+            bool closed_ = false;
+        };
+
+        /**
+         * @brief One RPC; owned by gRPC until OnDone()
+         */
+        class Call : public grpc::ServerGenericBidiReactor {
+        public:
+            Call(Impl &server, std::string method) : server_(server), method_(std::move(method)) {
+                server_.callStarted();
+                StartRead(&request_);
+            }
+
+            void OnReadDone(bool ok) override;
+            void OnWriteDone(bool ok) override;
+            void OnCancel() override;
+            void OnDone() override;
+
+            bool wantsPayload() const {
+                return includeImageData_;
+            }
+
+            // Called by the feed thread with the feed's mutex held
+            void offer(const std::shared_ptr<const EncodedFrame> &frame);
+
+            // Feed closed: the service is going away
+            void close();
+
+            // Finish the call unless it is already finishing; waits for the write in flight
+            void finish(const grpc::Status &status);
+
+        private:
+            void startFrameCall(bool stream);
+            void sendStatistics();
+            void write(const std::shared_ptr<const EncodedFrame> &frame, bool last);
+            // Under mutex_: stop writing, returns true if the caller must call Finish() after unlocking
+            bool requestFinish(const grpc::Status &status);
+
+            Impl &server_;
+            std::string method_;
+            grpc::ByteBuffer request_;
+            grpc::ByteBuffer response_; // Only touched by the one write in flight
+            Feed *feed_ = nullptr;
+            bool stream_ = false;
+            bool includeImageData_ = false;
+
+            std::mutex mutex_;
+            std::deque<std::shared_ptr<const EncodedFrame>> queue_; // Frames waiting behind the one in flight
+            bool writing_ = false;
+            bool finishing_ = false;
+            grpc::Status finishStatus_;
+        };
+
+        Impl(const Config &config, ImagingService &service)
+            : config_(config),
+              service_(service),
+              pool_(std::make_shared<PayloadPool>()) {
+        }
+
+        std::map<std::string, std::string> getStatisticsMap() const {
+            std::map<std::string, std::string> map;
+            map["grpc_port"] = std::to_string(config_.port);
+            map["grpc_active_streams"] = std::to_string(activeStreams_.load(std::memory_order_relaxed));
+            map["grpc_calls_served"] = std::to_string(callsServed_.load(std::memory_order_relaxed));
+            map["grpc_frames_sent"] = std::to_string(framesSent_.load(std::memory_order_relaxed));
+            map["grpc_bytes_sent"] = std::to_string(bytesSent_.load(std::memory_order_relaxed));
+            map["grpc_frames_dropped"] = std::to_string(framesDropped_.load(std::memory_order_relaxed));
+            map["grpc_frames_torn"] = std::to_string(framesTorn_.load(std::memory_order_relaxed));
+            return map;
+        }
+
+        grpc::ServerGenericBidiReactor *CreateReactor(grpc::GenericCallbackServerContext *context) override {
+            return new Call(*this, context->method());
+        }
+
+        Feed *findFeed(std::string_view format) {
+            std::string_view encoding = format.empty() ? "raw" : format;
+            for (auto &feed: feeds_) {
+                if (feed->getEncoding() == encoding) {
+                    return feed.get();
+                }
+            }
+            return nullptr;
+        }
+
+        void callStarted() {
+            std::lock_guard<std::mutex> lock(callMutex_);
+            ++activeCalls_;
+        }
+
+        void callEnded() {
+            std::lock_guard<std::mutex> lock(callMutex_);
+            --activeCalls_;
+            callCondition_.notify_all();
+        }
+
+        void waitForCalls() {
+            std::unique_lock<std::mutex> lock(callMutex_);
+            callCondition_.wait(lock, [this]() { return activeCalls_ == 0; });
+        }
+
+        const Config config_;
+        ImagingService &service_;
+        std::shared_ptr<PayloadPool> pool_;
+        std::vector<std::unique_ptr<Feed>> feeds_;
+        std::unique_ptr<grpc::Server> server_;
+
+        std::mutex callMutex_;
+        std::condition_variable callCondition_;
+        size_t activeCalls_ = 0;
+
+        // Updated from feed and gRPC threads, read by anyone
+        std::atomic<uint64_t> activeStreams_{0};
+        std::atomic<uint64_t> callsServed_{0};
+        std::atomic<uint64_t> framesSent_{0};
+        std::atomic<uint64_t> bytesSent_{0};
+        std::atomic<uint64_t> framesDropped_{0};
+        std::atomic<uint64_t> framesTorn_{0};
+    };
+
+    void GrpcServer::Impl::Feed::close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        for (Call *call: calls_) {
+            call->close();
+        }
+    }
+
+    void GrpcServer::Impl::Feed::feedThread() {
+        if (!ThreadLayout::applyCurrentThread("grpc") && server_.config_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(server_.config_.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        while (!stopRequested_) {
+            std::shared_ptr<Frame> frame;
+            if (reader_->readNextFrame(frame, FRAME_WAIT_MS) != SharedMemory::Status::OK || !frame) {
+                continue;
+            }
+
+            // Nothing is copied while nobody listens
+            bool includePayload = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (calls_.empty()) {
+                    continue;
+                }
+                for (const Call *call: calls_) {
+                    includePayload = includePayload || call->wantsPayload();
+                }
+            }
+
+            auto encoded = encode(*frame, includePayload);
+            if (!encoded) {
+                server_.framesTorn_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Call *call: calls_) {
+                call->offer(encoded);
+            }
+        }
+    }
+
+    std::shared_ptr<const EncodedFrame> GrpcServer::Impl::Feed::encode(const Frame &frame, bool includePayload) {
+        const FrameMetadata &source = frame.getMetadata();
+
+        std::string metadata;
+        putUint(metadata, 1, static_cast<uint64_t>(frame.getWidth()));
+        putUint(metadata, 2, static_cast<uint64_t>(frame.getHeight()));
+        putString(metadata, 3, toString(frame.getPixelFormat()));
+        putUint(metadata, 4, static_cast<uint64_t>(frame.getBytesPerPixel()));
+        putUint(metadata, 5, frame.getSequenceNumber());
+        putMapEntry(metadata, 6, "encoding", encoding_);
+        putMapEntry(metadata, 6, "capture_time_ns", std::to_string(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            frame.getCaptureTime().time_since_epoch()).count()));
+        if (!source.deviceId.empty()) {
+            putMapEntry(metadata, 6, "device_id", source.deviceId);
+        }
+        if (source.sourceWidth != 0) {
+            putMapEntry(metadata, 6, "roi", std::to_string(source.roiX) + "," + std::to_string(source.roiY));
+            putMapEntry(metadata, 6, "source_size",
+                        std::to_string(source.sourceWidth) + "x" + std::to_string(source.sourceHeight));
+        }
+        source.attributes.forEach([&](std::string_view key, std::string_view value) {
+            putMapEntry(metadata, 6, key, value);
+        });
+
+        std::string fields;
+        putUint(fields, 1, frame.getFrameId());
+        putUint(fields, 2, static_cast<uint64_t>(nanosecondsSinceEpoch(frame.getTimestamp())));
+        putBytes(fields, 3, metadata);
+
+        auto encoded = std::make_shared<EncodedFrame>();
+        encoded->fields = grpc::Slice(fields);
+        if (includePayload && frame.getData() && frame.getDataSize() > 0) {
+            // The one copy out of the ring; every call then sends from this buffer
+            size_t size = frame.getDataSize();
+            PayloadPool::Buffer *buffer = server_.pool_->acquire(size);
+            std::memcpy(buffer->data.data(), frame.getData(), size);
+            encoded->payload = grpc::Slice(buffer->data.data(), size, &PayloadPool::release, buffer);
+
+            std::string key;
+            putTag(key, 4, LENGTH_DELIMITED);
+            putVarint(key, size);
+            encoded->imageKey = grpc::Slice(key);
+            encoded->hasPayload = true;
+        }
+
+        // The writer may have lapped us while we were copying
+        if (!frame.validate()) {
+            return nullptr;
+        }
+        return encoded;
+    }
+
+    void GrpcServer::Impl::Call::OnReadDone(bool ok) {
+        if (!ok) {
+            finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Missing request"));
+            return;
+        }
+        if (method_ == STREAM_FRAMES_METHOD) {
+            startFrameCall(true);
+        } else if (method_ == GET_FRAME_METHOD) {
+            startFrameCall(false);
+        } else if (method_ == GET_STATISTICS_METHOD) {
+            sendStatistics();
+        } else {
+            finish(grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "Not served by this service"));
+        }
+    }
+
+    void GrpcServer::Impl::Call::startFrameCall(bool stream) {
+        // FrameRequest: include_image_data = 1, format = 4; quality and audio do not apply to raw frames
+        std::string format;
+        bool valid = parseMessage(
+            flatten(request_),
+            [this](uint32_t field, uint64_t value) {
+                if (field == 1) {
+                    includeImageData_ = value != 0;
+                }
+            },
+            [&format](uint32_t field, std::string_view value) {
+                if (field == 4) {
+                    format = value;
+                }
+            });
+        if (!valid) {
+            finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Malformed FrameRequest"));
+            return;
+        }
+
+        stream_ = stream;
+        feed_ = server_.findFeed(format);
+        if (!feed_) {
+            finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "Unknown or disabled format: " + format));
+            return;
+        }
+        if (!feed_->subscribe(this)) {
+            feed_ = nullptr;
+            finish(grpc::Status(grpc::StatusCode::UNAVAILABLE, "Service is stopping"));
+            return;
+        }
+        if (stream_) {
+            server_.activeStreams_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void GrpcServer::Impl::Call::sendStatistics() {
+        // StatisticsRequest: requested_stats = 1, empty for all
+        std::vector<std::string> requested;
+        parseMessage(
+            flatten(request_),
+            [](uint32_t, uint64_t) {
+            },
+            [&requested](uint32_t field, std::string_view value) {
+                if (field == 1) {
+                    requested.emplace_back(value);
+                }
+            });
+
+        auto statistics = server_.service_.getStatistics();
+        for (auto &[key, value]: server_.getStatisticsMap()) {
+            statistics[key] = value;
+        }
+
+        std::string message;
+        for (const auto &[key, value]: statistics) {
+            if (requested.empty() || std::find(requested.begin(), requested.end(), key) != requested.end()) {
+                putMapEntry(message, 1, key, value);
+            }
+        }
+        putUint(message, 2, static_cast<uint64_t>(nanosecondsSinceEpoch(std::chrono::system_clock::now())));
+
+        grpc::Slice slice(message);
+        response_ = grpc::ByteBuffer(&slice, 1);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finishing_) {
+                // Cancelled meanwhile and already finished
+                return;
+            }
+            finishing_ = true;
+        }
+        server_.callsServed_.fetch_add(1, std::memory_order_relaxed);
+        StartWriteAndFinish(&response_, grpc::WriteOptions(), grpc::Status::OK);
+    }
+
+    void GrpcServer::Impl::Call::offer(const std::shared_ptr<const EncodedFrame> &frame) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (finishing_) {
+                return;
+            }
+            if (!stream_) {
+                // GetFrame answers with the next frame published
+                finishing_ = true;
+                writing_ = true;
+            } else if (writing_) {
+                // Latest wins: a slow client loses its oldest waiting frame
+                if (queue_.size() >= server_.config_.maxQueuedFrames) {
+                    if (!queue_.empty()) {
+                        queue_.pop_front();
+                        queue_.push_back(frame);
+                    }
+                    server_.framesDropped_.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    queue_.push_back(frame);
+                }
+                return;
+            } else {
+                writing_ = true;
+            }
+        }
+        write(frame, !stream_);
+    }
+
+    void GrpcServer::Impl::Call::write(const std::shared_ptr<const EncodedFrame> &frame, bool last) {
+        // The slices are references; building the buffer copies no payload bytes
+        size_t size = frame->fields.size();
+        if (includeImageData_ && frame->hasPayload) {
+            const grpc::Slice slices[] = {frame->fields, frame->imageKey, frame->payload};
+            response_ = grpc::ByteBuffer(slices, 3);
+            size += frame->imageKey.size() + frame->payload.size();
+        } else {
+            response_ = grpc::ByteBuffer(&frame->fields, 1);
+        }
+
+        server_.framesSent_.fetch_add(1, std::memory_order_relaxed);
+        server_.bytesSent_.fetch_add(size, std::memory_order_relaxed);
+        if (last) {
+            server_.callsServed_.fetch_add(1, std::memory_order_relaxed);
+            StartWriteAndFinish(&response_, grpc::WriteOptions(), grpc::Status::OK);
+        } else {
+            StartWrite(&response_);
+        }
+    }
+
+    bool GrpcServer::Impl::Call::requestFinish(const grpc::Status &status) {
+        if (finishing_) {
+            return false;
+        }
+        finishing_ = true;
+        finishStatus_ = status;
+        queue_.clear();
+        return !writing_;
+    }
+
+    void GrpcServer::Impl::Call::OnWriteDone(bool ok) {
+        std::shared_ptr<const EncodedFrame> next;
+        bool finish = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!ok) {
+                // The client went away
+                requestFinish(grpc::Status(grpc::StatusCode::CANCELLED, "Stream closed"));
+            }
+            if (finishing_) {
+                writing_ = false;
+                finish = true;
+            } else if (!queue_.empty()) {
+                next = std::move(queue_.front());
+                queue_.pop_front();
+            } else {
+                writing_ = false;
+            }
+        }
+        if (finish) {
+            Finish(finishStatus_);
+        } else if (next) {
+            write(next, false);
+        }
+    }
+
+    void GrpcServer::Impl::Call::finish(const grpc::Status &status) {
+        bool finishNow;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finishNow = requestFinish(status);
+        }
+        if (finishNow) {
+            Finish(status);
+        }
+    }
+
+    void GrpcServer::Impl::Call::OnCancel() {
+        finish(grpc::Status::CANCELLED);
+    }
+
+    void GrpcServer::Impl::Call::close() {
+        finish(grpc::Status(grpc::StatusCode::UNAVAILABLE, "Service is stopping"));
+    }
+
+    void GrpcServer::Impl::Call::OnDone() {
+        if (feed_) {
+            feed_->unsubscribe(this);
+        }
+        if (stream_ && feed_) {
+            server_.activeStreams_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        Impl &server = server_;
+        delete this;
+        server.callEnded();
+    }
+
+    GrpcServer::GrpcServer(const Config &config)
+        : config_(config),
+          isRunning_(false) {
+    }
+
+    GrpcServer::~GrpcServer() {
+        stop();
+    }
+
+    GrpcServer::Status GrpcServer::start(ImagingService &service, size_t channel) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        auto rawRing = service.getSharedMemory(channel);
+        if (!rawRing || config_.port == 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        auto impl = std::make_unique<Impl>(config_, service);
+        auto addFeed = [&impl](const std::string &encoding, const std::shared_ptr<SharedMemory> &ring) {
+            auto feed = std::make_unique<Impl::Feed>(*impl, encoding);
+            if (!feed->attach(ring->getAttachConfig())) {
+                return false;
+            }
+            impl->feeds_.push_back(std::move(feed));
+            return true;
+        };
+        if (!addFeed("raw", rawRing)) {
+            return Status::CONNECTION_FAILED;
+        }
+        if (auto compressedRing = service.getCompressedSharedMemory(channel)) {
+            if (!addFeed("compressed", compressedRing)) {
+                return Status::CONNECTION_FAILED;
+            }
+        }
+
+        int selectedPort = 0;
+        grpc::ServerBuilder builder;
+        builder.AddListeningPort(config_.bindAddress + ":" + std::to_string(config_.port),
+                                 grpc::InsecureServerCredentials(), &selectedPort);
+        builder.RegisterCallbackGenericService(impl.get());
+        impl->server_ = builder.BuildAndStart();
+        if (!impl->server_ || selectedPort == 0) {
+            MIVI_LOG_ERROR("gRPC server failed to listen on {}:{}", config_.bindAddress, config_.port);
+            return Status::BIND_FAILED;
+        }
+
+        for (auto &feed: impl->feeds_) {
+            feed->start();
+        }
+        impl_ = std::move(impl);
+        isRunning_ = true;
+        return Status::OK;
+    }
+
+    GrpcServer::Status GrpcServer::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        // No new frames, then end every call still waiting for one
+        for (auto &feed: impl_->feeds_) {
+            feed->stop();
+        }
+        for (auto &feed: impl_->feeds_) {
+            feed->close();
+        }
+
+        // Whatever is still in flight gets a second to drain before it is cancelled
+        impl_->server_->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        impl_->waitForCalls();
+        impl_->server_.reset();
+
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool GrpcServer::isRunning() const {
+        return isRunning_;
+    }
+
+    std::map<std::string, std::string> GrpcServer::getStatisticsMap() const {
+        if (!impl_) {
+            return {};
+        }
+        return impl_->getStatisticsMap();
+    }
+} // namespace medical::imaging
@@ -1,31 +1,89 @@
 #include "api/imaging_service.h"
+#include "utils/frame_trace.h"
+#include "utils/futex.h"
+#include "utils/log.h"
+#include "utils/thread_accounting.h"
+#include "utils/thread_layout.h"
+#include "utils/numa.h"
 #include <chrono>
 #include <thread>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
-#include <numeric>
+#include <system_error>
 #include <sys/resource.h>
 #include <pthread.h>
 
 namespace medical::imaging {
-    // Performance monitoring constants
-    constexpr size_t FPS_HISTORY_SIZE = 60; // 1 minute of history at 1Hz sampling
-    constexpr size_t LATENCY_HISTORY_SIZE = 300; // 5 minutes of history
+    namespace {
+        // Bytes of a frame in a configured mode, 0 if the format is unknown
+        size_t modeFrameBytes(const CaptureDevice::Config &config) {
+            if (config.width <= 0 || config.height <= 0) {
+                return 0;
+            }
+            return getPixelFormatInfo(pixelFormatFromString(config.pixelFormat))
+                    .frameBytes(static_cast<size_t>(config.width), static_cast<size_t>(config.height));
+        }
+
+        // Largest frame a device can deliver in any of its modes. 4K UHD (3840x2160) with 2 bytes per
+        // pixel (YUV) = 16,588,800 bytes is the floor for devices that cannot list their modes
+        size_t maxDeviceFrameBytes(const CaptureDevice &device, const CaptureDevice::Config &config) {
+            size_t maxFrameSize = std::max<size_t>(17 * 1024 * 1024, modeFrameBytes(config));
+            for (const auto &mode: device.getSupportedConfigurations()) {
+                maxFrameSize = std::max(maxFrameSize, modeFrameBytes(mode));
+            }
+            return maxFrameSize;
+        }
+
+        // Arena bytes a number of frames of the ring's current geometry take, the given frame size before
+        // the first frame
+        size_t ringFrameBytes(const SharedMemory &ring, size_t frames, size_t fallbackFrameBytes) {
+            SharedMemory::Geometry geometry = ring.getGeometry();
+            size_t frameBytes = fallbackFrameBytes;
+            if (geometry.epoch > 0) {
+                frameBytes = geometry.format != PixelFormat::UNKNOWN
+                                 ? getPixelFormatInfo(geometry.format).frameBytes(geometry.width, geometry.height)
+                                 : static_cast<size_t>(geometry.width) * geometry.height * geometry.bytesPerPixel;
+            }
+            size_t alignment = std::max<size_t>(ring.getLayout().payloadAlignment, 1);
+            return frames * ((frameBytes + alignment - 1) / alignment * alignment);
+        }
+
+        // Copy the identity and metadata of a frame, everything but its pixels
+        void copyFrameAttributes(const Frame &source, Frame &target) {
+            target.setFrameId(source.getFrameId());
+            target.setSequenceNumber(source.getSequenceNumber());
+            target.setTimestamp(source.getTimestamp());
+            target.setCaptureTime(source.getCaptureTime());
+            target.getMetadataMutable() = source.getMetadata();
+        }
+
+        // Copy into a pooled buffer; unlike Frame::clone() this works for any buffer the CPU can
+        // read, including capture buffers and ring slots, and a second copy of the same frame is free
+        std::shared_ptr<Frame> copyFrame(const Frame &source) {
+            return source.cloneShared();
+        }
+    }
 
     ImagingService::ImagingService()
         : isInitialized_(false),
           isRunning_(false),
           stopRequested_(false),
-          frameBufferHead_(0),
-          frameBufferTail_(0),
+          numaNode_(-1),
           frameCount_(0),
-          droppedFrames_(0) {
+          droppedFrames_(0),
+          traceDumpRequested_(false),
+          firstFrameSeen_(false) {
         // Initialize metrics
         metrics_ = {};
         startTime_ = std::chrono::system_clock::now();
-        lastFrameTime_ = startTime_;
+        lastFrameTime_ = std::chrono::steady_clock::now();
     }
 
     ImagingService::~ImagingService() {
@@ -33,6 +91,10 @@ namespace medical::imaging {
         if (isRunning_) {
             stop();
         }
+
+        // Clips are written to the end while their rings are still mapped
+        std::lock_guard<std::mutex> lock(clipMutex_);
+        clipRecorders_.clear();
     }
 
     ImagingService::Status ImagingService::initialize(const Config &config) {
@@ -42,69 +104,286 @@ namespace medical::imaging {
         }
 
         config_ = config;
+        channels_.clear();
+        FrameTrace::setEnabled(config_.enableTracing);
+
+        // Threads place themselves by the layout as they start, so it has to be in place first
+        Status layoutStatus = setupThreadLayout(config_.threadLayout);
+        if (layoutStatus != Status::OK) {
+            return layoutStatus;
+        }
 
-        // Setup device
-        Status deviceStatus = setupDevice();
-        if (deviceStatus != Status::OK) {
-            return deviceStatus;
+        // Pick the devices first; their NUMA nodes and modes decide where the rings go and how large they are
+        auto selectBegin = std::chrono::steady_clock::now();
+        Status selectStatus = selectDevices();
+        if (selectStatus != Status::OK) {
+            channels_.clear();
+            return selectStatus;
+        }
+        for (auto &channel: channels_) {
+            channel->numaNode = config.numaNode >= 0 ? config.numaNode : channel->device->getNumaNode();
+            if (channel->numaNode >= 0 && numa::nodeCount() > 1) {
+                MIVI_LOG_INFO("Placing capture buffers, rings and threads of {} on NUMA node {}",
+                        channel->device->getDeviceId(), channel->numaNode);
+            }
+            channel->maxFrameBytes = maxDeviceFrameBytes(*channel->device, config.deviceConfig);
         }
+        recordStartupStage("device_selection", selectBegin, std::chrono::steady_clock::now());
+        numaNode_ = channels_.front()->numaNode;
+        liveSettings_.update(makeLiveSettings());
 
-        // Setup shared memory if enabled
+        // Create the raw rings first, unpopulated, so the devices can capture straight into their slots
         if (config.enableSharedMemory) {
-            Status shmStatus = setupSharedMemory();
-            if (shmStatus != Status::OK) {
-                return shmStatus;
+            for (auto &channel: channels_) {
+                auto ringBegin = std::chrono::steady_clock::now();
+                Status shmStatus = setupSharedMemory(*channel);
+                if (shmStatus != Status::OK) {
+                    channels_.clear();
+                    return shmStatus;
+                }
+                recordStartupStage("ring_create_" + std::to_string(channel->index), ringBegin,
+                                   std::chrono::steady_clock::now());
             }
         }
 
-        // Initialize frame buffer
-        frameBuffer_.resize(config.frameBufferSize);
-        frameBufferHead_ = 0;
-        frameBufferTail_ = 0;
+        // Bring up the devices while their rings are faulted in
+        Status channelStatus = setupChannels();
+        if (channelStatus != Status::OK) {
+            channels_.clear();
+            return channelStatus;
+        }
+
+        if (channels_.size() > 1) {
+            MIVI_LOG_INFO("Capturing from {} devices", channels_.size());
+        }
+
+        // Initialize the retention buffers
+        for (auto &channel: channels_) {
+            channel->retainedFrames.assign(static_cast<size_t>(std::max(config.frameBufferSize, 0)), RetainedFrame{});
+            channel->retainedNext = 0;
+            channel->retainedTotal = 0;
+        }
 
         // Initialize performance metrics
-        fpsHistory_.clear();
-        latencyHistory_.clear();
         resetPerformanceMetrics();
 
         isInitialized_ = true;
         return Status::OK;
     }
 
-    ImagingService::Status ImagingService::setupDevice() {
-        // Get the device
+    ImagingService::Status ImagingService::setupChannels() {
+        // Two threads per channel: one faults in the raw ring and builds the optional rings, the other
+        // opens the device, detects its mode and allocates its buffers. Neither depends on the other,
+        // since the device only needs the raw ring to exist, not to be resident.
+        std::vector<Status> ringStatus(channels_.size(), Status::OK);
+        std::vector<Status> deviceStatus(channels_.size(), Status::OK);
+        std::vector<std::thread> workers;
+        Status status = Status::OK;
+        try {
+            for (auto &channel: channels_) {
+                Channel &target = *channel;
+                workers.emplace_back([this, &target, &ringStatus] {
+                    ringStatus[target.index] = setupChannelRings(target);
+                });
+                workers.emplace_back([this, &target, &deviceStatus] {
+                    auto begin = std::chrono::steady_clock::now();
+                    deviceStatus[target.index] = setupDevice(target);
+                    recordStartupStage("device_init_" + std::to_string(target.index), begin,
+                                       std::chrono::steady_clock::now());
+                });
+            }
+        } catch (const std::system_error &e) {
+            MIVI_LOG_ERROR("Failed to start a setup thread: {}", e.what());
+            status = Status::INTERNAL_ERROR;
+        }
+        for (auto &worker: workers) {
+            worker.join();
+        }
+        if (status != Status::OK) {
+            return status;
+        }
+
+        // Report the first failure in the order the steps used to run one after the other
+        for (size_t i = 0; i < channels_.size(); ++i) {
+            if (ringStatus[i] != Status::OK) {
+                return ringStatus[i];
+            }
+            if (deviceStatus[i] != Status::OK) {
+                return deviceStatus[i];
+            }
+        }
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::setupChannelRings(Channel &channel) {
+        if (!config_.enableSharedMemory) {
+            return Status::OK;
+        }
+        const std::string suffix = std::to_string(channel.index);
+
+        auto prefaultBegin = std::chrono::steady_clock::now();
+        Status status = populateSharedMemory(channel);
+        if (status != Status::OK) {
+            return status;
+        }
+        recordStartupStage("ring_prefault_" + suffix, prefaultBegin, std::chrono::steady_clock::now());
+
+        auto optionalBegin = std::chrono::steady_clock::now();
+        bool anyOptional = false;
+
+        // Setup the optional conversion channel next to the raw ring
+        if (!config_.conversionFormat.empty()) {
+            anyOptional = true;
+            status = setupConversion(channel);
+            if (status != Status::OK) {
+                return status;
+            }
+        }
+
+        // Setup the optional preview channel for lightweight viewers
+        if (config_.previewScale > 0) {
+            anyOptional = true;
+            status = setupPreview(channel);
+            if (status != Status::OK) {
+                return status;
+            }
+        }
+
+        // Setup the optional compressed channel for network publishers
+        if (!config_.compressionCodec.empty()) {
+            anyOptional = true;
+            status = setupCompression(channel);
+            if (status != Status::OK) {
+                return status;
+            }
+        }
+
+        // Setup the optional GPU descriptor channel for CUDA consumers
+        if (config_.enableGpuUpload) {
+            anyOptional = true;
+            status = setupGpuUpload(channel);
+            if (status != Status::OK) {
+                return status;
+            }
+        }
+
+        // Setup the optional dma-buf descriptor channel for display and integrated-GPU consumers
+        if (config_.enableDmaBufExport) {
+            anyOptional = true;
+            status = setupDmaBufExport(channel);
+            if (status != Status::OK) {
+                return status;
+            }
+        }
+
+        if (anyOptional) {
+            recordStartupStage("optional_rings_" + suffix, optionalBegin, std::chrono::steady_clock::now());
+        }
+        return Status::OK;
+    }
+
+    std::string ImagingService::getChannelRingName(const std::string &baseName, size_t channel) {
+        return channel == 0 ? baseName : baseName + "_" + std::to_string(channel);
+    }
+
+    ImagingService::Status ImagingService::setupThreadLayout(const std::string &text) {
+        ThreadLayout layout;
+        if (!text.empty()) {
+            std::string error;
+            if (!ThreadLayout::parse(text, layout, error)) {
+                MIVI_LOG_ERROR("Invalid thread layout: {}", error);
+                return Status::INVALID_ARGUMENT;
+            }
+
+            // A layout that names an offline CPU or an impossible priority is refused; the rest only warns
+            ThreadLayout::Validation validation = layout.validate();
+            for (const auto &warning: validation.warnings) {
+                MIVI_LOG_WARNING("Thread layout warning: {}", warning);
+            }
+            for (const auto &problem: validation.errors) {
+                MIVI_LOG_ERROR("Thread layout error: {}", problem);
+            }
+            if (!validation.ok()) {
+                return Status::INVALID_ARGUMENT;
+            }
+            MIVI_LOG_INFO("Thread layout: {}", layout.toString());
+        }
+
+        ThreadLayout::setActive(layout);
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::selectDevices() {
+        // Get the devices
         auto &deviceManager = DeviceManager::getInstance();
 
-        if (config_.deviceId.empty()) {
-            // Auto-select the first available device
-            auto deviceIds = deviceManager.getAvailableDeviceIds();
-            if (deviceIds.empty()) {
+        std::vector<std::string> deviceIds = config_.deviceIds;
+        if (deviceIds.empty()) {
+            if (config_.deviceId.empty()) {
+                // Auto-select the first available device
+                auto availableIds = deviceManager.getAvailableDeviceIds();
+                if (availableIds.empty()) {
+                    return Status::DEVICE_ERROR;
+                }
+                deviceIds.push_back(availableIds[0]);
+            } else {
+                // Use the specified device
+                deviceIds.push_back(config_.deviceId);
+            }
+        }
+
+        for (size_t i = 0; i < deviceIds.size(); ++i) {
+            // A device delivers to one callback, so it can only feed one channel
+            if (std::find(deviceIds.begin(), deviceIds.begin() + static_cast<std::ptrdiff_t>(i), deviceIds[i]) !=
+                deviceIds.begin() + static_cast<std::ptrdiff_t>(i)) {
+                MIVI_LOG_WARNING("Device {} is listed more than once", deviceIds[i]);
+                return Status::INVALID_ARGUMENT;
+            }
+
+            auto device = deviceManager.getDevice(deviceIds[i]);
+            if (!device) {
+                MIVI_LOG_WARNING("Device not found: {}", deviceIds[i]);
                 return Status::DEVICE_ERROR;
             }
 
-            device_ = deviceManager.getDevice(deviceIds[0]);
-        } else {
-            // Use the specified device
-            device_ = deviceManager.getDevice(config_.deviceId);
+            auto channel = std::make_unique<Channel>();
+            channel->index = i;
+            channel->device = device;
+            channel->sharedMemoryName = getChannelRingName(config_.sharedMemoryName, i);
+            channel->convertedSharedMemoryName = getChannelRingName(config_.convertedSharedMemoryName, i);
+            channel->previewSharedMemoryName = getChannelRingName(config_.previewSharedMemoryName, i);
+            channel->compressedSharedMemoryName = getChannelRingName(config_.compressedSharedMemoryName, i);
+            channel->gpuSharedMemoryName = getChannelRingName(config_.gpuSharedMemoryName, i);
+            channel->dmaBufSharedMemoryName = getChannelRingName(config_.dmaBufSharedMemoryName, i);
+            channels_.push_back(std::move(channel));
         }
 
-        if (!device_) {
-            return Status::DEVICE_ERROR;
-        }
+        return Status::OK;
+    }
 
+    ImagingService::Status ImagingService::setupDevice(Channel &channel) {
         // Set up device configuration
-        BlackmagicDevice::Config deviceConfig = config_.deviceConfig;
+        CaptureDevice::Config deviceConfig = config_.deviceConfig;
+        if (deviceConfig.numaNode < 0) {
+            deviceConfig.numaNode = channel.numaNode;
+        }
 
         // Apply additional configuration options
         deviceConfig.enableDirectMemoryAccess = config_.enableDirectMemoryAccess;
 
         // If using shared memory, configure direct output if possible
-        if (config_.enableSharedMemory && device_->supportsFeature(DeviceFeature::DIRECT_MEMORY_ACCESS)) {
-            deviceConfig.sharedMemoryName = config_.sharedMemoryName;
+        if (config_.enableSharedMemory && channel.device->supportsFeature(DeviceFeature::DIRECT_MEMORY_ACCESS)) {
+            deviceConfig.sharedMemoryName = channel.sharedMemoryName;
+        }
+
+        // Let the card DMA frames into leased arena space instead of copying them in writeFrame()
+        if (channel.sharedMemory && channel.sharedMemory->getCaptureBufferCount() > 0) {
+            channel.device->setDirectOutputToSharedMemory(channel.sharedMemory);
         }
 
         // Initialize the device
-        if (device_->initialize(deviceConfig) != BlackmagicDevice::Status::OK) {
+        if (channel.device->initialize(deviceConfig) != CaptureDevice::Status::OK) {
+            MIVI_LOG_ERROR("Failed to initialize device {}", channel.device->getDeviceId());
             return Status::DEVICE_ERROR;
         }
 
@@ -128,52 +407,499 @@ namespace medical::imaging {
         return deviceManager.unregisterDeviceChangeCallback(subscriptionId);
     }
 
-    ImagingService::Status ImagingService::setupSharedMemory() {
+    ImagingService::Status ImagingService::setupSharedMemory(Channel &channel) {
         try {
             // Create shared memory configuration
             SharedMemory::Config shmConfig;
-            shmConfig.name = config_.sharedMemoryName;
+            shmConfig.name = channel.sharedMemoryName;
+            if (channel.index > 0) {
+                // Further channels need a file of their own when memory-mapped
+                shmConfig.filePath = "/dev/shm/" + channel.sharedMemoryName;
+            }
             shmConfig.size = config_.sharedMemorySize;
             shmConfig.type = config_.sharedMemoryType;
             shmConfig.create = true; // We are the producer
             shmConfig.maxFrames = config_.frameBufferSize;
-            shmConfig.useHugePages = false; // Can be made configurable
+            shmConfig.useHugePages = config_.useHugePages;
+            shmConfig.hugePageSize = config_.hugePageSize;
+            shmConfig.payloadAlignment = config_.payloadAlignment;
+            shmConfig.rowAlignment = config_.rowAlignment;
+            shmConfig.persistent = config_.persistentSharedMemory;
+            shmConfig.numaNode = channel.numaNode;
             shmConfig.lockInMemory = config_.pinMemory;
-
-            // CRITICAL: Calculate max frame size to ensure it can handle 4K frames
-            // 4K UHD (3840x2160) with 2 bytes per pixel (YUV) = 16,588,800 bytes
-            // Add a safety buffer
-            shmConfig.maxFrameSize = 17 * 1024 * 1024; // 17MB per frame
+            shmConfig.captureBuffers = config_.enableDirectMemoryAccess ? config_.captureBufferCount : 0;
+            shmConfig.copyMode = config_.copyMode;
+            shmConfig.copyThreads = config_.copyThreads;
+            shmConfig.publishBandRows = config_.publishBandRows;
+            shmConfig.computeStatistics = config_.imageStatistics;
+            shmConfig.writePolicy = config_.writePolicy;
+            shmConfig.blockTimeoutMs = config_.blockTimeoutMs;
+            shmConfig.demoteLagFrames = config_.demoteLagFrames;
+            shmConfig.demoteStaleMs = config_.demoteStaleMs;
+            shmConfig.poseRingName = config_.poseRingName;
+
+            // Faulted in by populateSharedMemory() while the device comes up
+            shmConfig.prefault = false;
+
+            // CRITICAL: Accept the largest mode the device supports, so that switching presets never
+            // touches the ring
+            shmConfig.maxFrameSize = channel.maxFrameBytes;
 
             // Create the shared memory object
-            sharedMemory_ = std::make_shared<SharedMemory>(shmConfig);
+            auto sharedMemory = std::make_shared<SharedMemory>(shmConfig);
 
             // Initialize it
-            auto status = sharedMemory_->initialize();
+            auto status = sharedMemory->initialize();
             if (status != SharedMemory::Status::OK) {
-                std::cerr << "Failed to initialize shared memory: " << static_cast<int>(status) << std::endl;
+                MIVI_LOG_ERROR("Failed to initialize shared memory '{}': {}",
+                        channel.sharedMemoryName, static_cast<int>(status));
                 return Status::COMMUNICATION_ERROR;
             }
 
             // Set thread affinity and priority if configured
             if (config_.threadAffinity >= 0) {
-                sharedMemory_->setThreadAffinity(config_.threadAffinity);
+                sharedMemory->setThreadAffinity(config_.threadAffinity);
             }
 
             if (config_.useRealtimePriority) {
-                sharedMemory_->setThreadPriority(10); // Medium-high priority
+                sharedMemory->setThreadPriority(10); // Medium-high priority
             }
 
-            // Lock memory if requested
-            if (config_.pinMemory) {
-                sharedMemory_->lockMemory();
+            // Start out holding the configured number of frames of the mode actually captured, not of the
+            // largest one; the monitor adapts the size to the readers from then on
+            if (config_.adaptiveRingSize) {
+                sharedMemory->resizeArena(ringFrameBytes(*sharedMemory, static_cast<size_t>(std::max(config_.frameBufferSize, 1)),
+                                                         modeFrameBytes(config_.deviceConfig)));
             }
 
+            channel.sharedMemory = std::move(sharedMemory);
             return Status::OK;
         } catch (const std::exception &e) {
-            std::cerr << "Exception in setupSharedMemory: " << e.what() << std::endl;
+            MIVI_LOG_ERROR("Exception in setupSharedMemory: {}", e.what());
+            return Status::COMMUNICATION_ERROR;
+        }
+    }
+
+    ImagingService::Status ImagingService::populateSharedMemory(Channel &channel) {
+        // Take the page faults of the whole ring now rather than in the first pass of writeFrame()
+        if (channel.sharedMemory->prefault() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to prefault shared memory '{}'", channel.sharedMemoryName);
+            return Status::COMMUNICATION_ERROR;
+        }
+
+        // Lock memory if requested
+        if (config_.pinMemory) {
+            channel.sharedMemory->lockMemory();
+        }
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::setupConversion(Channel &channel) {
+        PixelFormat outputFormat = pixelFormatFromString(config_.conversionFormat);
+        if (FrameConverter::getInputFormat(outputFormat) == PixelFormat::UNKNOWN) {
+            MIVI_LOG_WARNING("Unsupported conversion format: {}", config_.conversionFormat);
+            return Status::INVALID_ARGUMENT;
+        }
+
+        SharedMemory::Config shmConfig;
+        shmConfig.name = channel.convertedSharedMemoryName;
+        shmConfig.filePath = "/dev/shm/" + channel.convertedSharedMemoryName;
+        shmConfig.size = config_.sharedMemorySize;
+        shmConfig.type = config_.sharedMemoryType;
+        shmConfig.create = true;
+        shmConfig.maxFrames = config_.frameBufferSize;
+        shmConfig.useHugePages = config_.useHugePages;
+        shmConfig.hugePageSize = config_.hugePageSize;
+        shmConfig.payloadAlignment = config_.payloadAlignment;
+        shmConfig.rowAlignment = config_.rowAlignment;
+        shmConfig.persistent = config_.persistentSharedMemory;
+        shmConfig.numaNode = channel.numaNode;
+        shmConfig.lockInMemory = config_.pinMemory;
+        // One lease lets the kernels write straight into the ring, plus one for safety
+        shmConfig.captureBuffers = 2;
+        shmConfig.demoteLagFrames = config_.demoteLagFrames;
+        shmConfig.demoteStaleMs = config_.demoteStaleMs;
+        shmConfig.poseRingName = config_.poseRingName;
+
+        // Accept up to a 4K UHD frame in the converted format
+        shmConfig.maxFrameSize = getPixelFormatInfo(outputFormat).frameBytes(3840, 2160);
+
+        channel.convertedSharedMemory = std::make_shared<SharedMemory>(shmConfig);
+        auto status = channel.convertedSharedMemory->initialize();
+        if (status != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to initialize converted shared memory: {}", static_cast<int>(status));
+            channel.convertedSharedMemory.reset();
+            return Status::COMMUNICATION_ERROR;
+        }
+
+        if (config_.pinMemory) {
+            channel.convertedSharedMemory->lockMemory();
+        }
+
+        channel.frameConverter = std::make_unique<FrameConverter>(outputFormat);
+        MIVI_LOG_INFO("Publishing {} frames as {} to '{}' using {} kernels",
+                toString(FrameConverter::getInputFormat(outputFormat)), toString(outputFormat),
+                channel.convertedSharedMemoryName, FrameConverter::getKernelName());
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::setupPreview(Channel &channel) {
+        if (config_.previewScale > FrameScaler::MAX_FACTOR) {
+            MIVI_LOG_WARNING("Preview scale must be between 1 and {}", FrameScaler::MAX_FACTOR);
+            return Status::INVALID_ARGUMENT;
+        }
+
+        SharedMemory::Config shmConfig;
+        shmConfig.name = channel.previewSharedMemoryName;
+        shmConfig.filePath = "/dev/shm/" + channel.previewSharedMemoryName;
+        shmConfig.size = config_.previewSharedMemorySize;
+        shmConfig.type = config_.sharedMemoryType;
+        shmConfig.create = true;
+        shmConfig.maxFrames = config_.frameBufferSize;
+        shmConfig.useHugePages = config_.useHugePages;
+        shmConfig.hugePageSize = config_.hugePageSize;
+        shmConfig.payloadAlignment = config_.payloadAlignment;
+        shmConfig.rowAlignment = config_.rowAlignment;
+        shmConfig.persistent = config_.persistentSharedMemory;
+        shmConfig.numaNode = channel.numaNode;
+        shmConfig.lockInMemory = config_.pinMemory;
+        shmConfig.captureBuffers = 2;
+        // A full preview ring loses preview frames; it never holds back capture
+        shmConfig.writePolicy = WritePolicy::DROP_NEWEST;
+        shmConfig.demoteLagFrames = config_.demoteLagFrames;
+        shmConfig.demoteStaleMs = config_.demoteStaleMs;
+        shmConfig.poseRingName = config_.poseRingName;
+
+        // Accept a scaled 4K UHD frame in the widest supported format
+        shmConfig.maxFrameSize = getPixelFormatInfo(PixelFormat::BGRA_8).frameBytes(
+            3840 / config_.previewScale, 2160 / config_.previewScale);
+
+        channel.previewSharedMemory = std::make_shared<SharedMemory>(shmConfig);
+        auto status = channel.previewSharedMemory->initialize();
+        if (status != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to initialize preview shared memory: {}", static_cast<int>(status));
+            channel.previewSharedMemory.reset();
+            return Status::COMMUNICATION_ERROR;
+        }
+
+        if (config_.pinMemory) {
+            channel.previewSharedMemory->lockMemory();
+        }
+
+        channel.frameScaler = std::make_unique<FrameScaler>(config_.previewScale);
+        channel.nextPreviewTime = {};
+        channel.previewFramesSkipped = 0;
+        if (config_.previewFrameRate > 0.0) {
+            MIVI_LOG_INFO("Publishing 1/{} scale preview frames at up to {} fps to '{}' using {} kernels",
+                    config_.previewScale, config_.previewFrameRate, channel.previewSharedMemoryName,
+                    FrameScaler::getKernelName());
+        } else {
+            MIVI_LOG_INFO("Publishing 1/{} scale preview frames to '{}' using {} kernels",
+                    config_.previewScale, channel.previewSharedMemoryName, FrameScaler::getKernelName());
+        }
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::setupCompression(Channel &channel) {
+        FrameCompressor::Config compressorConfig;
+        if (!FrameCodec::fromString(config_.compressionCodec, compressorConfig.codec)) {
+            MIVI_LOG_WARNING("Unsupported compression codec: {}", config_.compressionCodec);
+            return Status::INVALID_ARGUMENT;
+        }
+        if (!FrameCodec::isAvailable(compressorConfig.codec)) {
+            MIVI_LOG_WARNING("Compression codec {} is not available in this build", config_.compressionCodec);
+            return Status::INVALID_ARGUMENT;
+        }
+        compressorConfig.useDelta = config_.compressionDelta;
+        compressorConfig.keyFrameInterval = config_.compressionKeyFrameInterval;
+        compressorConfig.cpuCore = config_.compressionThreadAffinity;
+        compressorConfig.threadRole = "compress-" + std::to_string(channel.index);
+
+        SharedMemory::Config shmConfig;
+        shmConfig.name = channel.compressedSharedMemoryName;
+        shmConfig.filePath = "/dev/shm/" + channel.compressedSharedMemoryName;
+        shmConfig.size = config_.sharedMemorySize;
+        shmConfig.type = config_.sharedMemoryType;
+        shmConfig.create = true;
+        shmConfig.maxFrames = config_.frameBufferSize;
+        shmConfig.useHugePages = config_.useHugePages;
+        shmConfig.hugePageSize = config_.hugePageSize;
+        shmConfig.payloadAlignment = config_.payloadAlignment;
+        shmConfig.rowAlignment = config_.rowAlignment;
+        shmConfig.persistent = config_.persistentSharedMemory;
+        shmConfig.numaNode = channel.numaNode;
+        shmConfig.lockInMemory = config_.pinMemory;
+        shmConfig.captureBuffers = 0;
+        // A slow network publisher loses compressed frames; the compressor never waits for it
+        shmConfig.writePolicy = WritePolicy::DROP_NEWEST;
+        shmConfig.demoteLagFrames = config_.demoteLagFrames;
+        shmConfig.demoteStaleMs = config_.demoteStaleMs;
+        shmConfig.poseRingName = config_.poseRingName;
+
+        // Incompressible frames are stored as they are, behind their header
+        shmConfig.maxFrameSize = FrameCodec::maxEncodedSize(channel.maxFrameBytes);
+
+        channel.compressedSharedMemory = std::make_shared<SharedMemory>(shmConfig);
+        auto status = channel.compressedSharedMemory->initialize();
+        if (status != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to initialize compressed shared memory: {}", static_cast<int>(status));
+            channel.compressedSharedMemory.reset();
+            return Status::COMMUNICATION_ERROR;
+        }
+
+        if (config_.pinMemory) {
+            channel.compressedSharedMemory->lockMemory();
+        }
+
+        // Consumers look here before decoding payloads
+        channel.compressedSharedMemory->updateMetadata("compression", FrameCodec::toString(compressorConfig.codec));
+        channel.compressedSharedMemory->updateMetadata("compression_delta", compressorConfig.useDelta ? "true" : "false");
+        channel.compressedSharedMemory->updateMetadata("compression_key_frame_interval",
+                                                       std::to_string(compressorConfig.keyFrameInterval));
+
+        channel.frameCompressor = std::make_unique<FrameCompressor>(compressorConfig);
+        MIVI_LOG_INFO("Publishing {}{} compressed frames to '{}'",
+                FrameCodec::toString(compressorConfig.codec), (compressorConfig.useDelta ? " delta" : ""),
+                channel.compressedSharedMemoryName);
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::startCompressors() {
+        for (auto &channel: channels_) {
+            if (!channel->frameCompressor) {
+                continue;
+            }
+
+            // The compressor reads the raw ring like any other consumer
+            SharedMemory::Config sourceConfig = channel->sharedMemory->getAttachConfig();
+            auto status = channel->frameCompressor->start(sourceConfig, channel->compressedSharedMemory);
+            if (status != FrameCompressor::Status::OK) {
+                MIVI_LOG_ERROR("Failed to start the compressor of '{}': {}",
+                        channel->sharedMemoryName, static_cast<int>(status));
+                stopCompressors();
+                return Status::COMMUNICATION_ERROR;
+            }
+        }
+        return Status::OK;
+    }
+
+    void ImagingService::stopCompressors() {
+        for (auto &channel: channels_) {
+            if (channel->frameCompressor) {
+                channel->frameCompressor->stop();
+            }
+        }
+    }
+
+    ImagingService::Status ImagingService::setupGpuUpload(Channel &channel) {
+        if (!GpuMemory::isAvailable()) {
+            MIVI_LOG_WARNING("GPU upload requested but unavailable: {}", GpuMemory::getLastError());
+            return Status::INVALID_ARGUMENT;
+        }
+        if (config_.gpuDevice < 0 || config_.gpuDevice >= GpuMemory::getDeviceCount() || config_.gpuBufferCount < 2) {
+            MIVI_LOG_ERROR("Invalid GPU upload settings: device {}, {} buffers",
+                    config_.gpuDevice, config_.gpuBufferCount);
+            return Status::INVALID_ARGUMENT;
+        }
+
+        GpuUploader::Config uploaderConfig;
+        uploaderConfig.device = config_.gpuDevice;
+        uploaderConfig.bufferCount = config_.gpuBufferCount;
+        uploaderConfig.pinSource = config_.gpuPinSharedMemory;
+        uploaderConfig.cpuCore = config_.gpuThreadAffinity;
+        uploaderConfig.threadRole = "gpu-upload-" + std::to_string(channel.index);
+
+        // Descriptors are tiny, so the ring only needs room for the header table
+        SharedMemory::Config shmConfig;
+        shmConfig.name = channel.gpuSharedMemoryName;
+        shmConfig.filePath = "/dev/shm/" + channel.gpuSharedMemoryName;
+        shmConfig.size = 4 * 1024 * 1024;
+        shmConfig.type = config_.sharedMemoryType;
+        shmConfig.create = true;
+        shmConfig.maxFrames = config_.frameBufferSize;
+        shmConfig.persistent = config_.persistentSharedMemory;
+        shmConfig.numaNode = channel.numaNode;
+        shmConfig.lockInMemory = config_.pinMemory;
+        shmConfig.captureBuffers = 0;
+        shmConfig.maxFrameSize = sizeof(GpuFrameDescriptor);
+        // A consumer that falls behind loses descriptors; the uploader never waits for it
+        shmConfig.writePolicy = WritePolicy::DROP_NEWEST;
+        shmConfig.demoteLagFrames = config_.demoteLagFrames;
+        shmConfig.demoteStaleMs = config_.demoteStaleMs;
+        shmConfig.poseRingName = config_.poseRingName;
+
+        channel.gpuSharedMemory = std::make_shared<SharedMemory>(shmConfig);
+        auto status = channel.gpuSharedMemory->initialize();
+        if (status != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to initialize GPU shared memory: {}", static_cast<int>(status));
+            channel.gpuSharedMemory.reset();
+            return Status::COMMUNICATION_ERROR;
+        }
+
+        // Consumers look here before opening the IPC handles
+        channel.gpuSharedMemory->updateMetadata("gpu_source", channel.sharedMemoryName);
+        channel.gpuSharedMemory->updateMetadata("gpu_device", std::to_string(uploaderConfig.device));
+        channel.gpuSharedMemory->updateMetadata("gpu_device_name", GpuMemory::getDeviceName(uploaderConfig.device));
+        channel.gpuSharedMemory->updateMetadata("gpu_buffer_count", std::to_string(uploaderConfig.bufferCount));
+
+        channel.gpuUploader = std::make_unique<GpuUploader>(uploaderConfig);
+        MIVI_LOG_INFO("Uploading frames to CUDA device {} ({}), descriptors on '{}'",
+                uploaderConfig.device, GpuMemory::getDeviceName(uploaderConfig.device), channel.gpuSharedMemoryName);
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::startGpuUploaders() {
+        for (auto &channel: channels_) {
+            if (!channel->gpuUploader) {
+                continue;
+            }
+
+            // The uploader reads the raw ring like any other consumer
+            SharedMemory::Config sourceConfig = channel->sharedMemory->getAttachConfig();
+            auto status = channel->gpuUploader->start(sourceConfig, channel->gpuSharedMemory);
+            if (status != GpuUploader::Status::OK) {
+                MIVI_LOG_ERROR("Failed to start the GPU uploader of '{}': {}",
+                        channel->sharedMemoryName, static_cast<int>(status));
+                stopGpuUploaders();
+                return Status::COMMUNICATION_ERROR;
+            }
+        }
+        return Status::OK;
+    }
+
+    void ImagingService::stopGpuUploaders() {
+        for (auto &channel: channels_) {
+            if (channel->gpuUploader) {
+                channel->gpuUploader->stop();
+            }
+        }
+    }
+
+    ImagingService::Status ImagingService::setupDmaBufExport(Channel &channel) {
+        if (config_.dmaBufSlotCount < 2) {
+            MIVI_LOG_ERROR("Invalid dma-buf export settings: {} slots", config_.dmaBufSlotCount);
+            return Status::INVALID_ARGUMENT;
+        }
+
+        DmaBufExporter::Config exporterConfig;
+        exporterConfig.slotCount = config_.dmaBufSlotCount;
+        exporterConfig.maxFrameSize = channel.maxFrameBytes;
+        exporterConfig.pitchAlignment = config_.dmaBufPitchAlignment;
+        exporterConfig.socketPath = config_.dmaBufSocketDirectory + "/" + channel.dmaBufSharedMemoryName + ".sock";
+        exporterConfig.cpuCore = config_.dmaBufThreadAffinity;
+        exporterConfig.threadRole = "dmabuf-" + std::to_string(channel.index);
+
+        // Descriptors are tiny, so the ring only needs room for the header table
+        SharedMemory::Config shmConfig;
+        shmConfig.name = channel.dmaBufSharedMemoryName;
+        shmConfig.filePath = "/dev/shm/" + channel.dmaBufSharedMemoryName;
+        shmConfig.size = 4 * 1024 * 1024;
+        shmConfig.type = config_.sharedMemoryType;
+        shmConfig.create = true;
+        shmConfig.maxFrames = config_.frameBufferSize;
+        shmConfig.persistent = config_.persistentSharedMemory;
+        shmConfig.numaNode = channel.numaNode;
+        shmConfig.lockInMemory = config_.pinMemory;
+        shmConfig.captureBuffers = 0;
+        shmConfig.maxFrameSize = sizeof(DmaBufFrameDescriptor);
+        // A consumer that falls behind loses descriptors; the exporter never waits for it
+        shmConfig.writePolicy = WritePolicy::DROP_NEWEST;
+        shmConfig.demoteLagFrames = config_.demoteLagFrames;
+        shmConfig.demoteStaleMs = config_.demoteStaleMs;
+        shmConfig.poseRingName = config_.poseRingName;
+
+        channel.dmaBufSharedMemory = std::make_shared<SharedMemory>(shmConfig);
+        auto status = channel.dmaBufSharedMemory->initialize();
+        if (status != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to initialize dma-buf shared memory: {}", static_cast<int>(status));
+            channel.dmaBufSharedMemory.reset();
             return Status::COMMUNICATION_ERROR;
         }
+
+        // Consumers connect here once for the slots, then follow the descriptors
+        channel.dmaBufSharedMemory->updateMetadata("dmabuf_source", channel.sharedMemoryName);
+        channel.dmaBufSharedMemory->updateMetadata("dmabuf_socket", exporterConfig.socketPath);
+        channel.dmaBufSharedMemory->updateMetadata("dmabuf_slot_count", std::to_string(exporterConfig.slotCount));
+
+        channel.dmaBufExporter = std::make_unique<DmaBufExporter>(exporterConfig);
+        MIVI_LOG_INFO("Exporting dma-buf frames through '{}', descriptors on '{}'",
+                exporterConfig.socketPath, channel.dmaBufSharedMemoryName);
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::startDmaBufExporters() {
+        for (auto &channel: channels_) {
+            if (!channel->dmaBufExporter) {
+                continue;
+            }
+
+            // The exporter reads the raw ring like any other consumer
+            SharedMemory::Config sourceConfig = channel->sharedMemory->getAttachConfig();
+            auto status = channel->dmaBufExporter->start(sourceConfig, channel->dmaBufSharedMemory);
+            if (status != DmaBufExporter::Status::OK) {
+                MIVI_LOG_ERROR("Failed to start the dma-buf exporter of '{}': {}",
+                        channel->sharedMemoryName, static_cast<int>(status));
+                stopDmaBufExporters();
+                return Status::COMMUNICATION_ERROR;
+            }
+        }
+        return Status::OK;
+    }
+
+    void ImagingService::stopDmaBufExporters() {
+        for (auto &channel: channels_) {
+            if (channel->dmaBufExporter) {
+                channel->dmaBufExporter->stop();
+            }
+        }
+    }
+
+    ImagingService::Status ImagingService::startFormatCaches() {
+        if (!config_.enableSharedMemory || !config_.enableFormatCache) {
+            return Status::OK;
+        }
+
+        for (auto &channel: channels_) {
+            if (!channel->sharedMemory) {
+                continue;
+            }
+
+            // Format rings are laid out like the converted ring, created only once somebody asks
+            FormatCache::Config cacheConfig;
+            cacheConfig.ringConfig.size = config_.sharedMemorySize;
+            cacheConfig.ringConfig.type = config_.sharedMemoryType;
+            cacheConfig.ringConfig.maxFrames = config_.frameBufferSize;
+            cacheConfig.ringConfig.useHugePages = config_.useHugePages;
+            cacheConfig.ringConfig.hugePageSize = config_.hugePageSize;
+            cacheConfig.ringConfig.payloadAlignment = config_.payloadAlignment;
+            cacheConfig.ringConfig.rowAlignment = config_.rowAlignment;
+            cacheConfig.ringConfig.numaNode = channel->numaNode;
+            cacheConfig.ringConfig.lockInMemory = config_.pinMemory;
+            cacheConfig.idleTimeoutMs = config_.formatCacheIdleMs;
+            cacheConfig.cpuCore = config_.formatCacheThreadAffinity;
+            cacheConfig.threadRole = "formats-" + std::to_string(channel->index);
+
+            // Workers read the raw ring like any other consumer
+            SharedMemory::Config sourceConfig = channel->sharedMemory->getAttachConfig();
+
+            channel->formatCache = std::make_unique<FormatCache>(cacheConfig);
+            auto status = channel->formatCache->start(sourceConfig, channel->sharedMemory);
+            if (status != FormatCache::Status::OK) {
+                MIVI_LOG_ERROR("Failed to start the format cache of '{}': {}",
+                        channel->sharedMemoryName, static_cast<int>(status));
+                stopFormatCaches();
+                return Status::COMMUNICATION_ERROR;
+            }
+        }
+        return Status::OK;
+    }
+
+    void ImagingService::stopFormatCaches() {
+        for (auto &channel: channels_) {
+            if (channel->formatCache) {
+                channel->formatCache->stop();
+            }
+        }
     }
 
     ImagingService::Status ImagingService::start() {
@@ -189,68 +915,181 @@ namespace medical::imaging {
         frameCount_ = 0;
         droppedFrames_ = 0;
         startTime_ = std::chrono::system_clock::now();
-        lastFrameTime_ = startTime_;
+        lastFrameTime_ = std::chrono::steady_clock::now();
+        firstFrameSeen_.store(false, std::memory_order_relaxed);
 
         // Start performance monitoring if enabled
         if (config_.enablePerformanceMonitoring) {
             stopRequested_ = false;
             performanceThread_ = std::thread(&ImagingService::performanceMonitorThread, this);
 
-            // Set thread priority and affinity if configured
-            if (config_.useRealtimePriority) {
+            // Set thread priority and affinity if configured, unless the thread layout places it
+            if (config_.useRealtimePriority && !ThreadLayout::isPlaced("monitor")) {
                 setThreadPriority(performanceThread_, false, 5); // Lower priority than capture
             }
 
-            if (config_.threadAffinity >= 0) {
+            if (config_.threadAffinity >= 0 && !ThreadLayout::isPlaced("monitor")) {
                 setThreadAffinity(performanceThread_, config_.threadAffinity);
             }
         }
 
-        // Set up the frame callback on the device
-        const auto status = device_->startCapture(
-            [this](const std::shared_ptr<Frame> &frame) {
-                handleNewFrame(frame);
-            });
+        // Compressors attach before the first frame, so the compressed ring starts with a key frame
+        Status compressorStatus = startCompressors();
+        if (compressorStatus == Status::OK) {
+            compressorStatus = startGpuUploaders();
+            if (compressorStatus != Status::OK) {
+                stopCompressors();
+            }
+        }
+        if (compressorStatus == Status::OK) {
+            compressorStatus = startDmaBufExporters();
+            if (compressorStatus != Status::OK) {
+                stopGpuUploaders();
+                stopCompressors();
+            }
+        }
+        if (compressorStatus == Status::OK) {
+            compressorStatus = startFormatCaches();
+            if (compressorStatus != Status::OK) {
+                stopDmaBufExporters();
+                stopGpuUploaders();
+                stopCompressors();
+            }
+        }
+        if (compressorStatus != Status::OK) {
+            stopPerformanceMonitor();
+            return compressorStatus;
+        }
 
-        if (status != BlackmagicDevice::Status::OK) {
-            // Clean up performance thread if it was started
-            if (config_.enablePerformanceMonitoring) {
-                stopRequested_ = true;
-                if (performanceThread_.joinable()) {
-                    performanceThread_.join();
-                }
+        // Publisher threads wait for frames before the devices deliver any
+        startPublishers();
+
+        // Set up the frame callback on every device; each delivers on its own thread
+        for (size_t i = 0; i < channels_.size(); ++i) {
+            Channel *channel = channels_[i].get();
+            channel->frameCount = 0;
+            channel->lastFrameTime = lastFrameTime_;
+            channel->pacing.reset();
+            channel->pacing.setNominalRate(channel->device->getCurrentConfiguration().frameRate);
+
+            const auto status = channel->device->startCapture(
+                [this, channel](const std::shared_ptr<Frame> &frame) {
+                    handleNewFrame(*channel, frame);
+                });
+            if (status == CaptureDevice::Status::OK) {
+                continue;
             }
 
+            MIVI_LOG_ERROR("Failed to start capture on {}", channel->device->getDeviceId());
+            stopChannels(i);
+            stopPublishers();
+            stopCompressors();
+            stopGpuUploaders();
+            stopDmaBufExporters();
+            stopFormatCaches();
+
+            // Clean up performance thread if it was started
+            stopPerformanceMonitor();
+
             return Status::DEVICE_ERROR;
         }
 
+        recordStartupStage("service_start", lastFrameTime_, std::chrono::steady_clock::now());
         isRunning_ = true;
         return Status::OK;
     }
 
+    void ImagingService::startPublishers() {
+        // Without a publisher thread the device callbacks publish inline
+        if (!config_.usePublishThread) {
+            for (auto &channel: channels_) {
+                channel->publishQueue.reset();
+            }
+            return;
+        }
+
+        for (auto &channel: channels_) {
+            channel->publishQueue = std::make_unique<SpscQueue<PendingFrame>>(
+                std::max<size_t>(1, config_.publishQueueDepth));
+            channel->stopPublishing = false;
+            channel->publishQueueDrops = 0;
+            channel->publishThread = std::thread(&ImagingService::publisherThread, this, std::ref(*channel));
+
+            // Publishing is on the capture path: same priority class as the device callback
+            if (ThreadLayout::isPlaced("publish-" + std::to_string(channel->index))) {
+                continue;
+            }
+            if (config_.useRealtimePriority) {
+                setThreadPriority(channel->publishThread, true, 10);
+            }
+            if (config_.publishThreadAffinity >= 0) {
+                setThreadAffinity(channel->publishThread, config_.publishThreadAffinity);
+            }
+        }
+    }
+
+    void ImagingService::stopPublishers() {
+        for (auto &channel: channels_) {
+            if (!channel->publishThread.joinable()) {
+                continue;
+            }
+
+            channel->stopPublishing.store(true, std::memory_order_release);
+            futex::ring(channel->publishDoorbell, channel->publishWaiters);
+            channel->publishThread.join();
+        }
+    }
+
+    void ImagingService::stopPerformanceMonitor() {
+        if (!config_.enablePerformanceMonitoring) {
+            return;
+        }
+
+        // The monitor sleeps on the condition variable, so stopping does not wait out its interval
+        {
+            std::lock_guard<std::mutex> lock(monitorMutex_);
+            stopRequested_ = true;
+        }
+        monitorCondition_.notify_all();
+        if (performanceThread_.joinable()) {
+            performanceThread_.join();
+        }
+    }
+
+    void ImagingService::stopChannels(size_t count) {
+        for (size_t i = 0; i < count && i < channels_.size(); ++i) {
+            channels_[i]->device->stopCapture();
+        }
+    }
+
     ImagingService::Status ImagingService::stop() {
         if (!isRunning_) {
             return Status::NOT_RUNNING;
         }
 
-        // Stop the device
-        auto status = device_->stopCapture();
-        if (status != BlackmagicDevice::Status::OK) {
-            return Status::DEVICE_ERROR;
+        // Stop every device, even if one of them fails to stop
+        bool deviceError = false;
+        for (auto &channel: channels_) {
+            if (channel->device->stopCapture() != CaptureDevice::Status::OK) {
+                MIVI_LOG_ERROR("Failed to stop capture on {}", channel->device->getDeviceId());
+                deviceError = true;
+            }
         }
 
+        // Publish what is still queued, then stop the side stages once no more frames arrive for them
+        stopPublishers();
+        stopCompressors();
+        stopGpuUploaders();
+        stopDmaBufExporters();
+        stopFormatCaches();
+
         // Stop performance monitoring thread
-        if (config_.enablePerformanceMonitoring) {
-            stopRequested_ = true;
-            if (performanceThread_.joinable()) {
-                performanceThread_.join();
-            }
-        }
+        stopPerformanceMonitor();
 
         // Set flag
         isRunning_ = false;
 
-        return Status::OK;
+        return deviceError ? Status::DEVICE_ERROR : Status::OK;
     }
 
     bool ImagingService::isRunning() const {
@@ -258,9 +1097,78 @@ namespace medical::imaging {
     }
 
     ImagingService::Config ImagingService::getConfig() const {
+        std::lock_guard<std::mutex> lock(configMutex_);
         return config_;
     }
 
+    ImagingService::LiveSettings ImagingService::makeLiveSettings() const {
+        LiveSettings settings;
+        settings.regionsOfInterest.assign(std::max<size_t>(channels_.size(), 1), config_.regionOfInterest);
+        settings.previewFrameRate = config_.previewFrameRate;
+        settings.duplicatePolicy = config_.duplicatePolicy;
+        settings.duplicateKeepAliveRate = config_.duplicateKeepAliveRate;
+        settings.fingerprintSamples = config_.fingerprintSamples;
+        settings.threadLayout = config_.threadLayout;
+        settings.logPerformanceStats = config_.logPerformanceStats;
+        settings.performanceLogIntervalMs = config_.performanceLogIntervalMs;
+        settings.enableTracing = config_.enableTracing;
+        settings.traceFile = config_.traceFile;
+        settings.traceWindowMs = config_.traceWindowMs;
+        settings.traceOnDrop = config_.traceOnDrop;
+        return settings;
+    }
+
+    ImagingService::LiveSettings ImagingService::getLiveSettings() const {
+        return liveSettings_.get();
+    }
+
+    ImagingService::Status ImagingService::reconfigure(const LiveSettings &settings) {
+        if (!isInitialized_) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (settings.regionsOfInterest.size() != channels_.size() || settings.previewFrameRate < 0.0 ||
+            settings.duplicateKeepAliveRate < 0.0 || settings.performanceLogIntervalMs <= 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+        for (const auto &roi: settings.regionsOfInterest) {
+            if (roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0) {
+                return Status::INVALID_ARGUMENT;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(reconfigureMutex_);
+        LiveSettings previous = liveSettings_.get();
+
+        // Threads only read the layout when they start, so the running ones are moved explicitly
+        if (settings.threadLayout != previous.threadLayout) {
+            Status layoutStatus = setupThreadLayout(settings.threadLayout);
+            if (layoutStatus != Status::OK) {
+                return layoutStatus;
+            }
+            size_t placed = ThreadLayout::applyToRunningThreads();
+            MIVI_LOG_INFO("Thread layout applied to {} running threads", placed);
+        }
+
+        FrameTrace::setEnabled(settings.enableTracing);
+        liveSettings_.update(settings);
+
+        // Keep getConfig() truthful, so a later stop and start keeps the change
+        std::lock_guard<std::mutex> configLock(configMutex_);
+        config_.regionOfInterest = settings.regionsOfInterest.front();
+        config_.previewFrameRate = settings.previewFrameRate;
+        config_.duplicatePolicy = settings.duplicatePolicy;
+        config_.duplicateKeepAliveRate = settings.duplicateKeepAliveRate;
+        config_.fingerprintSamples = settings.fingerprintSamples;
+        config_.threadLayout = settings.threadLayout;
+        config_.logPerformanceStats = settings.logPerformanceStats;
+        config_.performanceLogIntervalMs = settings.performanceLogIntervalMs;
+        config_.enableTracing = settings.enableTracing;
+        config_.traceFile = settings.traceFile;
+        config_.traceWindowMs = settings.traceWindowMs;
+        config_.traceOnDrop = settings.traceOnDrop;
+        return Status::OK;
+    }
+
     ImagingService::Status ImagingService::setConfig(const Config &config) {
         // Can only change config when not running
         if (isRunning_) {
@@ -275,76 +1183,946 @@ namespace medical::imaging {
             return initialize(config);
         }
 
-        return Status::OK;
+        return Status::OK;
+    }
+
+    ImagingService::Status ImagingService::setFrameCallback(
+        const std::function<void(std::shared_ptr<Frame>)> &callback) {
+        frameCallback_ = callback;
+        return Status::OK;
+    }
+
+    int ImagingService::subscribeFrames(FrameDispatcher::FrameHandler handler,
+                                        const FrameDispatcher::SubscriptionConfig &config) {
+        return frameDispatcher_.subscribe(std::move(handler), config);
+    }
+
+    bool ImagingService::unsubscribeFrames(int subscriptionId) {
+        return frameDispatcher_.unsubscribe(subscriptionId);
+    }
+
+    ImagingService::PerformanceMetrics ImagingService::getPerformanceMetrics() const {
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+        return metrics_;
+    }
+
+    void ImagingService::resetPerformanceMetrics() {
+        std::lock_guard<std::mutex> lock(metricsMutex_);
+
+        metrics_ = {};
+        startTime_ = std::chrono::system_clock::now();
+        captureIntervalHistogram_.reset();
+        shmWriteHistogram_.reset();
+        publishQueueHistogram_.reset();
+        latencyHistogram_.reset();
+        conversionHistogram_.reset();
+        previewHistogram_.reset();
+        fingerprintHistogram_.reset();
+        for (auto &channel: channels_) {
+            channel->captureIntervalHistogram.reset();
+            channel->lastIntervalSnapshot = {};
+            channel->currentFps = 0.0;
+            channel->frameCount = 0;
+            channel->pacing.reset();
+        }
+
+        // Reset counters
+        frameCount_ = 0;
+        droppedFrames_ = 0;
+    }
+
+    std::map<std::string, std::string> ImagingService::getStatistics() const {
+        std::map<std::string, std::string> stats;
+
+        // Get basic stats
+        stats["frame_count"] = std::to_string(frameCount_);
+        stats["dropped_frames"] = std::to_string(droppedFrames_);
+        stats["trace_events"] = std::to_string(FrameTrace::getEventCount());
+        stats["numa_node"] = std::to_string(numaNode_);
+
+        // Get performance metrics
+        PerformanceMetrics metrics = getPerformanceMetrics();
+        stats["average_fps"] = std::to_string(metrics.averageFps);
+        stats["current_fps"] = std::to_string(metrics.currentFps);
+        stats["average_latency_ms"] = std::to_string(metrics.averageLatencyMs);
+        stats["p50_latency_ms"] = std::to_string(metrics.p50LatencyMs);
+        stats["p99_latency_ms"] = std::to_string(metrics.p99LatencyMs);
+        stats["p999_latency_ms"] = std::to_string(metrics.p999LatencyMs);
+        stats["max_latency_ms"] = std::to_string(metrics.maxLatencyMs);
+        stats["cpu_usage_percent"] = std::to_string(metrics.cpuUsagePercent);
+        stats["memory_usage_mb"] = std::to_string(metrics.memoryUsageMb);
+        stats["memory_peak_mb"] = std::to_string(metrics.peakMemoryUsageMb);
+        stats["memory_locked_mb"] = std::to_string(metrics.lockedMemoryMb);
+        for (const auto &thread: ThreadAccounting::getThreadStatistics()) {
+            const std::string prefix = "thread_" + thread.role + "_";
+            stats[prefix + "tid"] = std::to_string(thread.tid);
+            stats[prefix + "policy"] = ThreadAccounting::policyName(thread.policy);
+            stats[prefix + "priority"] = std::to_string(thread.priority);
+            stats[prefix + "cpu"] = std::to_string(thread.lastCpu);
+            stats[prefix + "cpu_percent"] = std::to_string(thread.cpuPercent);
+            stats[prefix + "run_queue_wait_percent"] = std::to_string(thread.runQueueWaitPercent);
+            stats[prefix + "voluntary_switches"] = std::to_string(thread.voluntarySwitches);
+            stats[prefix + "involuntary_switches"] = std::to_string(thread.involuntarySwitches);
+            stats[prefix + "deadline_misses"] = std::to_string(thread.deadlineMisses);
+        }
+        for (const auto &applied: ThreadLayout::getAppliedThreads()) {
+            const std::string prefix = "thread_" + applied.role + "_";
+            stats[prefix + "placement"] = applied.placement.empty() ? "unplaced" : applied.placement;
+            if (!applied.ok) {
+                stats[prefix + "placement_error"] = applied.error;
+            }
+        }
+        stats["uptime_seconds"] = std::to_string(metrics.uptime.count());
+        for (const auto &stage: getStartupTimeline()) {
+            stats["startup_" + stage.name + "_start_ms"] = std::to_string(stage.startMs);
+            stats["startup_" + stage.name + "_ms"] = std::to_string(stage.durationMs);
+        }
+        {
+            std::lock_guard<std::mutex> lock(clipMutex_);
+            stats["clips_saving"] = std::to_string(std::count_if(
+                clipRecorders_.begin(), clipRecorders_.end(),
+                [](const std::unique_ptr<FrameRecorder> &clip) { return !clip->isFinished(); }));
+        }
+        stats["shm_copy_mode"] = FrameCopier::toString(config_.copyMode);
+        stats["shm_write_policy"] = SharedMemory::toString(config_.writePolicy);
+        stats["shm_copy_kernel"] = FrameCopier::getKernelName();
+        const DuplicatePolicy duplicatePolicy = liveSettings_.read()->duplicatePolicy;
+        stats["duplicate_policy"] = FrameFingerprint::toString(duplicatePolicy);
+
+        // Ring and device stats of a channel, under a key prefix
+        auto appendChannel = [this, &stats, duplicatePolicy](const std::string &prefix, const Channel &channel) {
+            if (channel.sharedMemory) {
+                auto shmStats = channel.sharedMemory->getStatistics();
+                stats[prefix + "shm_frames_written"] = std::to_string(shmStats.totalFramesWritten);
+                stats[prefix + "shm_buffer_full_count"] = std::to_string(shmStats.bufferFullCount);
+                stats[prefix + "shm_writer_epoch"] = std::to_string(channel.sharedMemory->getWriterEpoch());
+                stats[prefix + "shm_frames_read"] = std::to_string(shmStats.totalFramesRead);
+                stats[prefix + "shm_dropped_frames"] = std::to_string(shmStats.droppedFrames);
+                stats[prefix + "shm_avg_write_latency_ns"] = std::to_string(shmStats.writeLatencyNsAvg);
+                stats[prefix + "shm_avg_read_latency_ns"] = std::to_string(shmStats.readLatencyNsAvg);
+                stats[prefix + "shm_peak_memory_usage"] = std::to_string(shmStats.peakMemoryUsage);
+                stats[prefix + "shm_current_frame_count"] = std::to_string(channel.sharedMemory->getCurrentFrameCount());
+                stats[prefix + "shm_is_buffer_full"] = channel.sharedMemory->isBufferFull() ? "true" : "false";
+                stats[prefix + "shm_page_backing"] = channel.sharedMemory->getPageBacking();
+                stats[prefix + "shm_page_size"] = std::to_string(channel.sharedMemory->getPageSize());
+                stats[prefix + "shm_numa_node"] = std::to_string(channel.sharedMemory->getNumaNode());
+                stats[prefix + "shm_arena_bytes"] = std::to_string(channel.sharedMemory->getArenaSize());
+                stats[prefix + "shm_arena_limit_bytes"] = std::to_string(channel.sharedMemory->getArenaLimit());
+                stats[prefix + "shm_arena_committed_bytes"] = std::to_string(channel.sharedMemory->getCommittedArenaBytes());
+                stats[prefix + "shm_pinned_frames"] = std::to_string(shmStats.pinnedFrames);
+                stats[prefix + "shm_pinned_bytes"] = std::to_string(shmStats.pinnedBytes);
+                stats[prefix + "shm_geometry_epoch"] = std::to_string(channel.sharedMemory->getGeometry().epoch);
+            }
+
+            uint8_t idleReason = channel.idleReason.load(std::memory_order_relaxed);
+            stats[prefix + "idle"] = idleReason == IDLE_NO_SIGNAL ? "no_signal" : idleReason == IDLE_UNREAD ? "unread" : "false";
+            stats[prefix + "frames_idle"] = std::to_string(channel.framesIdle.load(std::memory_order_relaxed));
+            stats[prefix + "input_signal"] = channel.device->hasInputSignal() ? "true" : "false";
+
+            stats[prefix + "nominal_fps"] = std::to_string(channel.pacing.getNominalRate());
+            LatencyHistogram::Snapshot jitter = channel.pacing.getJitterHistogram().snapshot();
+            stats[prefix + "jitter_p99_ms"] = std::to_string(static_cast<double>(jitter.percentile(0.99)) / 1e6);
+            stats[prefix + "jitter_max_ms"] = std::to_string(static_cast<double>(jitter.max) / 1e6);
+            stats[prefix + "drops_total"] = std::to_string(channel.pacing.getTotalDropCount());
+            for (size_t cause = 0; cause < FramePacing::CAUSE_COUNT; ++cause) {
+                auto dropCause = static_cast<DropCause>(cause);
+                stats[prefix + "drops_" + FramePacing::toString(dropCause)] =
+                    std::to_string(channel.pacing.getDropCount(dropCause));
+            }
+
+            if (channel.publishQueue) {
+                stats[prefix + "publish_queue_depth"] = std::to_string(channel.publishQueue->size());
+                stats[prefix + "publish_queue_capacity"] = std::to_string(channel.publishQueue->capacity());
+                stats[prefix + "publish_queue_drops"] = std::to_string(
+                    channel.publishQueueDrops.load(std::memory_order_relaxed));
+            }
+
+            if (channel.frameConverter) {
+                stats[prefix + "conversion_format"] = toString(channel.frameConverter->getOutputFormat());
+            }
+
+            RegionOfInterest roi = getRegionOfInterest(channel.index);
+            if (roi.isEnabled()) {
+                stats[prefix + "roi"] = std::to_string(roi.x) + "," + std::to_string(roi.y) + "," +
+                                        std::to_string(roi.width) + "x" + std::to_string(roi.height);
+                stats[prefix + "roi_frames_cropped"] = std::to_string(
+                    channel.framesCropped.load(std::memory_order_relaxed));
+                stats[prefix + "roi_frames_cropped_in_place"] = std::to_string(
+                    channel.framesCroppedInPlace.load(std::memory_order_relaxed));
+            }
+
+            if (duplicatePolicy != DuplicatePolicy::PUBLISH) {
+                stats[prefix + "frames_duplicate"] = std::to_string(
+                    channel.framesDuplicate.load(std::memory_order_relaxed));
+                stats[prefix + "frames_suppressed"] = std::to_string(
+                    channel.framesSuppressed.load(std::memory_order_relaxed));
+            }
+
+            if (channel.frameScaler && channel.previewSharedMemory) {
+                auto previewStats = channel.previewSharedMemory->getStatistics();
+                stats[prefix + "preview_scale"] = std::to_string(channel.frameScaler->getFactor());
+                stats[prefix + "preview_frames_written"] = std::to_string(previewStats.totalFramesWritten);
+                stats[prefix + "preview_dropped_frames"] = std::to_string(previewStats.droppedFrames);
+                stats[prefix + "preview_frames_skipped"] = std::to_string(
+                    channel.previewFramesSkipped.load(std::memory_order_relaxed));
+            }
+
+            if (channel.frameCompressor && channel.compressedSharedMemory) {
+                auto compressedStats = channel.compressedSharedMemory->getStatistics();
+                stats[prefix + "compressed_frames_written"] = std::to_string(compressedStats.totalFramesWritten);
+                stats[prefix + "compressed_dropped_frames"] = std::to_string(compressedStats.droppedFrames);
+                for (const auto &[key, value]: channel.frameCompressor->getStatisticsMap()) {
+                    stats[prefix + key] = value;
+                }
+            }
+
+            if (channel.gpuUploader) {
+                for (const auto &[key, value]: channel.gpuUploader->getStatisticsMap()) {
+                    stats[prefix + key] = value;
+                }
+            }
+
+            if (channel.dmaBufExporter) {
+                for (const auto &[key, value]: channel.dmaBufExporter->getStatisticsMap()) {
+                    stats[prefix + key] = value;
+                }
+            }
+
+            if (channel.formatCache && channel.formatCache->isRunning()) {
+                for (const auto &[key, value]: channel.formatCache->getStatisticsMap()) {
+                    stats[prefix + key] = value;
+                }
+            }
+
+            stats[prefix + "device_outstanding_buffers"] = std::to_string(channel.device->getOutstandingBufferCount());
+            {
+                std::lock_guard<std::mutex> lock(channel.retainedMutex);
+                stats[prefix + "retained_frames"] = std::to_string(
+                    std::min<uint64_t>(channel.retainedTotal, channel.retainedFrames.size()));
+            }
+
+            for (const auto &[key, value]: channel.device->getDiagnostics()) {
+                stats[prefix + "device_" + key] = value;
+            }
+        };
+
+        // Add shared memory stats of the primary channel if enabled
+        if (!channels_.empty()) {
+            appendChannel("", *channels_.front());
+        }
+
+        // Add latency distributions
+        appendHistogramStatistics(stats, "capture_interval", captureIntervalHistogram_.snapshot());
+        appendHistogramStatistics(stats, "shm_write", shmWriteHistogram_.snapshot());
+        if (config_.usePublishThread) {
+            appendHistogramStatistics(stats, "publish_queue_wait", publishQueueHistogram_.snapshot());
+        }
+        appendHistogramStatistics(stats, "end_to_end_latency", latencyHistogram_.snapshot());
+        if (liveSettings_.read()->duplicatePolicy != DuplicatePolicy::PUBLISH) {
+            appendHistogramStatistics(stats, "fingerprint", fingerprintHistogram_.snapshot());
+        }
+
+        // Add conversion stats if enabled
+        if (!config_.conversionFormat.empty() && !channels_.empty() && channels_.front()->frameConverter) {
+            stats["conversion_kernel"] = FrameConverter::getKernelName();
+            appendHistogramStatistics(stats, "conversion", conversionHistogram_.snapshot());
+        }
+
+        // Add preview stats if enabled
+        if (!channels_.empty() && channels_.front()->frameScaler) {
+            stats["preview_kernel"] = FrameScaler::getKernelName();
+            appendHistogramStatistics(stats, "preview", previewHistogram_.snapshot());
+        }
+
+        // Add subscriber delivery stats
+        if (frameDispatcher_.getSubscriberCount() > 0) {
+            for (const auto &[key, value]: frameDispatcher_.getStatisticsMap()) {
+                stats[key] = value;
+            }
+        }
+
+        // Every channel under its own prefix once there is more than one
+        stats["channel_count"] = std::to_string(channels_.size());
+        if (channels_.size() > 1) {
+            std::lock_guard<std::mutex> lock(metricsMutex_);
+            for (const auto &channel: channels_) {
+                std::string prefix = "channel" + std::to_string(channel->index) + "_";
+                stats[prefix + "device_id"] = channel->device->getDeviceId();
+                stats[prefix + "shm_name"] = channel->sharedMemoryName;
+                stats[prefix + "frame_count"] = std::to_string(channel->frameCount.load(std::memory_order_relaxed));
+                stats[prefix + "current_fps"] = std::to_string(channel->currentFps);
+                stats[prefix + "numa_node"] = std::to_string(channel->numaNode);
+                appendHistogramStatistics(stats, prefix + "capture_interval",
+                                          channel->captureIntervalHistogram.snapshot());
+                appendChannel(prefix, *channel);
+            }
+        }
+
+        return stats;
+    }
+
+    std::string ImagingService::exportMetrics() const {
+        std::string out;
+        auto family = [&out](const std::string &name, const char *type, const std::string &help) {
+            out += "# HELP " + name + " " + help + "\n";
+            out += "# TYPE " + name + " " + type + "\n";
+        };
+        auto sample = [&out](const std::string &name, const std::string &labels, double value) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+            out += name + (labels.empty() ? "" : "{" + labels + "}") + " " + buffer + "\n";
+        };
+
+        // Service counters and gauges
+        PerformanceMetrics metrics = getPerformanceMetrics();
+        family("imaging_frames_total", "counter", "Frames received from the device");
+        sample("imaging_frames_total", "", static_cast<double>(frameCount_.load(std::memory_order_relaxed)));
+        family("imaging_dropped_frames_total", "counter", "Frames dropped by the service");
+        sample("imaging_dropped_frames_total", "", static_cast<double>(droppedFrames_.load(std::memory_order_relaxed)));
+        family("imaging_fps", "gauge", "Frame rate over the last monitoring interval");
+        sample("imaging_fps", "", metrics.currentFps);
+        family("imaging_uptime_seconds", "gauge", "Time since the service was created");
+        sample("imaging_uptime_seconds", "", static_cast<double>(metrics.uptime.count()));
+
+        // How long each step of bringing the service up took
+        std::vector<StartupStage> timeline = getStartupTimeline();
+        if (!timeline.empty()) {
+            family("imaging_startup_stage_seconds", "gauge", "Duration of a startup step");
+            for (const auto &stage: timeline) {
+                sample("imaging_startup_stage_seconds", "stage=\"" + stage.name + "\"", stage.durationMs / 1000.0);
+            }
+            family("imaging_startup_stage_start_seconds", "gauge", "Start of a startup step after the first one began");
+            for (const auto &stage: timeline) {
+                sample("imaging_startup_stage_start_seconds", "stage=\"" + stage.name + "\"", stage.startMs / 1000.0);
+            }
+        }
+
+        // Process memory and per-thread scheduling, as of the last monitoring interval
+        ThreadAccounting::MemoryStatistics memory = ThreadAccounting::getMemoryStatistics();
+        family("imaging_process_resident_bytes", "gauge", "Resident set size of the service");
+        sample("imaging_process_resident_bytes", "", static_cast<double>(memory.residentBytes));
+        family("imaging_process_peak_resident_bytes", "gauge", "Largest resident set size of the service");
+        sample("imaging_process_peak_resident_bytes", "", static_cast<double>(memory.peakResidentBytes));
+        family("imaging_process_locked_bytes", "gauge", "Memory locked into RAM by the service");
+        sample("imaging_process_locked_bytes", "", static_cast<double>(memory.lockedBytes));
+
+        // Log messages that never reached the console
+        family("imaging_log_dropped_total", "counter", "Log messages dropped because the log ring was full");
+        sample("imaging_log_dropped_total", "", static_cast<double>(Log::getDroppedCount()));
+        family("imaging_log_suppressed_total", "counter", "Log messages suppressed by the per-call-site rate limit");
+        sample("imaging_log_suppressed_total", "", static_cast<double>(Log::getSuppressedCount()));
+
+        std::vector<ThreadAccounting::ThreadStatistics> threads = ThreadAccounting::getThreadStatistics();
+        auto threadLabels = [](const ThreadAccounting::ThreadStatistics &thread) {
+            return "thread=\"" + thread.role + "\",tid=\"" + std::to_string(thread.tid) + "\",policy=\"" +
+                   ThreadAccounting::policyName(thread.policy) + "\"";
+        };
+        auto perThread = [&](const std::string &name, const char *type, const std::string &help, auto value) {
+            family(name, type, help);
+            for (const auto &thread: threads) {
+                sample(name, threadLabels(thread), static_cast<double>(value(thread)));
+            }
+        };
+        using ThreadStatistics = ThreadAccounting::ThreadStatistics;
+        perThread("imaging_thread_cpu_seconds_total", "counter", "CPU time of the thread",
+                  [](const ThreadStatistics &thread) { return thread.cpuSeconds; });
+        perThread("imaging_thread_cpu_percent", "gauge", "CPU time of the thread over the last interval, percent of one core",
+                  [](const ThreadStatistics &thread) { return thread.cpuPercent; });
+        perThread("imaging_thread_run_queue_wait_seconds_total", "counter", "Time the thread was runnable but not running",
+                  [](const ThreadStatistics &thread) { return thread.runQueueWaitSeconds; });
+        perThread("imaging_thread_voluntary_switches_total", "counter", "Context switches the thread blocked for",
+                  [](const ThreadStatistics &thread) { return thread.voluntarySwitches; });
+        perThread("imaging_thread_involuntary_switches_total", "counter", "Context switches forced by preemption",
+                  [](const ThreadStatistics &thread) { return thread.involuntarySwitches; });
+        perThread("imaging_thread_deadline_misses_total", "counter", "Frames the thread needed more than a frame interval for",
+                  [](const ThreadStatistics &thread) { return thread.deadlineMisses; });
+        perThread("imaging_thread_last_cpu", "gauge", "CPU the thread last ran on",
+                  [](const ThreadStatistics &thread) { return thread.lastCpu; });
+
+        // Latency distributions
+        appendPrometheusSummary(out, "imaging_capture_interval_seconds",
+                                "Interval between frames reaching the service", captureIntervalHistogram_.snapshot());
+        appendPrometheusSummary(out, "imaging_shm_write_seconds",
+                                "Time spent publishing a frame to shared memory", shmWriteHistogram_.snapshot());
+        if (config_.usePublishThread) {
+            appendPrometheusSummary(out, "imaging_publish_queue_wait_seconds",
+                                    "Time a frame waits for the publisher thread", publishQueueHistogram_.snapshot());
+        }
+        appendPrometheusSummary(out, "imaging_end_to_end_latency_seconds",
+                                "Capture-to-publish latency", latencyHistogram_.snapshot());
+        if (!channels_.empty() && channels_.front()->frameConverter) {
+            appendPrometheusSummary(out, "imaging_conversion_seconds",
+                                    "Time spent converting and publishing a frame", conversionHistogram_.snapshot());
+        }
+        if (!channels_.empty() && channels_.front()->frameScaler) {
+            appendPrometheusSummary(out, "imaging_preview_seconds",
+                                    "Time spent scaling and publishing a preview frame", previewHistogram_.snapshot());
+        }
+
+        // Subscriber delivery, one series per subscriber
+        auto subscribers = frameDispatcher_.getSubscriberStatistics();
+        if (!subscribers.empty()) {
+            std::vector<std::string> subscriberLabels;
+            std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> queueWaits;
+            for (const auto &subscriber: subscribers) {
+                subscriberLabels.push_back("subscriber=\"" + subscriber.name + "\",policy=\"" +
+                                           FrameDispatcher::toString(subscriber.policy) + "\"");
+                queueWaits.emplace_back(subscriberLabels.back(), subscriber.queueWait);
+            }
+            family("imaging_subscriber_frames_total", "counter", "Frames delivered to the subscriber");
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                sample("imaging_subscriber_frames_total", subscriberLabels[i],
+                       static_cast<double>(subscribers[i].framesDelivered));
+            }
+            family("imaging_subscriber_dropped_frames_total", "counter",
+                   "Frames discarded by the subscriber's drop policy");
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                sample("imaging_subscriber_dropped_frames_total", subscriberLabels[i],
+                       static_cast<double>(subscribers[i].framesDropped));
+            }
+            family("imaging_subscriber_lag_frames", "gauge", "Frames queued for the subscriber");
+            for (size_t i = 0; i < subscribers.size(); ++i) {
+                sample("imaging_subscriber_lag_frames", subscriberLabels[i],
+                       static_cast<double>(subscribers[i].lagFrames));
+            }
+            appendPrometheusSummary(out, "imaging_subscriber_queue_wait_seconds",
+                                    "Time a frame waits in the subscriber's queue", queueWaits);
+        }
+
+        // Device counters, one series per channel
+        if (channels_.empty()) {
+            return out;
+        }
+
+        // Compression, one series per compressed channel
+        std::vector<std::pair<std::string, FrameCompressor::Statistics>> compressorStats;
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> compressionTimes;
+        for (const auto &channel: channels_) {
+            if (channel->frameCompressor) {
+                std::string labels = "channel=\"" + std::to_string(channel->index) + "\"";
+                compressorStats.emplace_back(labels, channel->frameCompressor->getStatistics());
+                compressionTimes.emplace_back(labels,
+                                              channel->frameCompressor->getCompressionTimeHistogram().snapshot());
+            }
+        }
+        if (!compressorStats.empty()) {
+            family("imaging_compression_ratio", "gauge", "Raw bytes per compressed byte published");
+            for (const auto &[labels, stats]: compressorStats) {
+                sample("imaging_compression_ratio", labels, stats.compressionRatio);
+            }
+            family("imaging_compressed_frames_total", "counter", "Frames published to the compressed ring");
+            for (const auto &[labels, stats]: compressorStats) {
+                sample("imaging_compressed_frames_total", labels, static_cast<double>(stats.framesCompressed));
+            }
+            family("imaging_compression_key_frames_total", "counter", "Compressed frames that decode on their own");
+            for (const auto &[labels, stats]: compressorStats) {
+                sample("imaging_compression_key_frames_total", labels, static_cast<double>(stats.keyFrames));
+            }
+            appendPrometheusSummary(out, "imaging_compression_seconds",
+                                    "Time spent compressing and publishing a frame", compressionTimes);
+        }
+
+        // GPU upload, one series per uploading channel
+        std::vector<std::pair<std::string, GpuUploader::Statistics>> uploaderStats;
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> uploadTimes;
+        for (const auto &channel: channels_) {
+            if (channel->gpuUploader) {
+                std::string labels = "channel=\"" + std::to_string(channel->index) + "\"";
+                uploaderStats.emplace_back(labels, channel->gpuUploader->getStatistics());
+                uploadTimes.emplace_back(labels, channel->gpuUploader->getUploadTimeHistogram().snapshot());
+            }
+        }
+        if (!uploaderStats.empty()) {
+            family("imaging_gpu_frames_uploaded_total", "counter", "Frames uploaded to the GPU and published");
+            for (const auto &[labels, stats]: uploaderStats) {
+                sample("imaging_gpu_frames_uploaded_total", labels, static_cast<double>(stats.framesUploaded));
+            }
+            family("imaging_gpu_bytes_uploaded_total", "counter", "Bytes copied to the GPU for published frames");
+            for (const auto &[labels, stats]: uploaderStats) {
+                sample("imaging_gpu_bytes_uploaded_total", labels, static_cast<double>(stats.bytesUploaded));
+            }
+            family("imaging_gpu_frames_dropped_total", "counter", "Frames the GPU upload lost, torn or not accepted");
+            for (const auto &[labels, stats]: uploaderStats) {
+                sample("imaging_gpu_frames_dropped_total", labels,
+                       static_cast<double>(stats.framesDropped + stats.framesTorn + stats.framesSkipped));
+            }
+            appendPrometheusSummary(out, "imaging_gpu_upload_seconds", "Time spent copying a frame to the GPU",
+                                    uploadTimes);
+        }
+
+        // DMA-BUF export, one series per exporting channel
+        std::vector<std::pair<std::string, DmaBufExporter::Statistics>> exporterStats;
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> exportTimes;
+        for (const auto &channel: channels_) {
+            if (channel->dmaBufExporter) {
+                std::string labels = "channel=\"" + std::to_string(channel->index) + "\"";
+                exporterStats.emplace_back(labels, channel->dmaBufExporter->getStatistics());
+                exportTimes.emplace_back(labels, channel->dmaBufExporter->getCopyTimeHistogram().snapshot());
+            }
+        }
+        if (!exporterStats.empty()) {
+            family("imaging_dmabuf_frames_exported_total", "counter", "Frames copied into dma-buf slots and published");
+            for (const auto &[labels, stats]: exporterStats) {
+                sample("imaging_dmabuf_frames_exported_total", labels, static_cast<double>(stats.framesExported));
+            }
+            family("imaging_dmabuf_frames_dropped_total", "counter", "Frames the dma-buf export lost, torn or not accepted");
+            for (const auto &[labels, stats]: exporterStats) {
+                sample("imaging_dmabuf_frames_dropped_total", labels,
+                       static_cast<double>(stats.framesDropped + stats.framesTorn + stats.framesSkipped));
+            }
+            family("imaging_dmabuf_clients_total", "counter", "Consumers the dma-buf slots were passed to");
+            for (const auto &[labels, stats]: exporterStats) {
+                sample("imaging_dmabuf_clients_total", labels, static_cast<double>(stats.clientsServed));
+            }
+            appendPrometheusSummary(out, "imaging_dmabuf_copy_seconds", "Time spent copying a frame into its dma-buf slot",
+                                    exportTimes);
+        }
+
+        // On-demand formats, one series per live format ring
+        std::vector<std::pair<std::string, FormatCache::FormatStatistics>> formatStats;
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> formatTimes;
+        for (const auto &channel: channels_) {
+            if (channel->formatCache && channel->formatCache->isRunning()) {
+                std::string channelLabel = "channel=\"" + std::to_string(channel->index) + "\"";
+                for (const auto &stats: channel->formatCache->getStatistics()) {
+                    formatStats.emplace_back(channelLabel + ",format=\"" + toString(stats.format) + "\"", stats);
+                }
+                formatTimes.emplace_back(channelLabel,
+                                         channel->formatCache->getConversionTimeHistogram().snapshot());
+            }
+        }
+        if (!formatStats.empty()) {
+            family("imaging_format_subscribers", "gauge", "Consumers of an on-demand format ring");
+            for (const auto &[labels, stats]: formatStats) {
+                sample("imaging_format_subscribers", labels, static_cast<double>(stats.subscribers));
+            }
+            family("imaging_format_frames_total", "counter", "Frames converted into an on-demand format ring");
+            for (const auto &[labels, stats]: formatStats) {
+                sample("imaging_format_frames_total", labels, static_cast<double>(stats.framesConverted));
+            }
+            family("imaging_format_frames_dropped_total", "counter",
+                   "Frames an on-demand format ring lost, torn or not accepted");
+            for (const auto &[labels, stats]: formatStats) {
+                sample("imaging_format_frames_dropped_total", labels,
+                       static_cast<double>(stats.framesDropped + stats.framesTorn + stats.framesSkipped));
+            }
+            appendPrometheusSummary(out, "imaging_format_conversion_seconds",
+                                    "Time spent converting and publishing a frame on request", formatTimes);
+        }
+        std::vector<std::string> channelLabels;
+        for (const auto &channel: channels_) {
+            channelLabels.push_back("channel=\"" + std::to_string(channel->index) + "\",device=\"" +
+                                    channel->device->getDeviceId() + "\"");
+        }
+        auto perChannel = [&](const std::string &name, const char *type, const std::string &help, auto value) {
+            family(name, type, help);
+            for (size_t i = 0; i < channels_.size(); ++i) {
+                sample(name, channelLabels[i], static_cast<double>(value(*channels_[i])));
+            }
+        };
+        auto channelSummary = [&](const std::string &name, const std::string &help, auto histogram) {
+            std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> series;
+            for (size_t i = 0; i < channels_.size(); ++i) {
+                series.emplace_back(channelLabels[i], histogram(*channels_[i]).snapshot());
+            }
+            appendPrometheusSummary(out, name, help, series);
+        };
+
+        perChannel("imaging_channel_frames_total", "counter", "Frames received from the channel's device",
+                   [](const Channel &channel) { return channel.frameCount.load(std::memory_order_relaxed); });
+        channelSummary("imaging_channel_capture_interval_seconds", "Interval between frames of the channel",
+                       [](const Channel &channel) -> const LatencyHistogram & {
+                           return channel.captureIntervalHistogram;
+                       });
+        channelSummary("imaging_device_capture_interval_seconds", "Interval between frames arriving from the driver",
+                       [](const Channel &channel) -> const LatencyHistogram & {
+                           return channel.device->getCaptureIntervalHistogram();
+                       });
+        channelSummary("imaging_device_convert_seconds", "Time spent wrapping driver frames",
+                       [](const Channel &channel) -> const LatencyHistogram & {
+                           return channel.device->getConvertTimeHistogram();
+                       });
+        if (liveSettings_.read()->duplicatePolicy != DuplicatePolicy::PUBLISH) {
+            perChannel("imaging_channel_duplicate_frames_total", "counter",
+                       "Frames published as duplicates of the previous one, without a payload",
+                       [](const Channel &channel) { return channel.framesDuplicate.load(std::memory_order_relaxed); });
+            perChannel("imaging_channel_suppressed_frames_total", "counter",
+                       "Duplicate frames left out between keep-alive frames",
+                       [](const Channel &channel) { return channel.framesSuppressed.load(std::memory_order_relaxed); });
+            appendPrometheusSummary(out, "imaging_fingerprint_seconds", "Time spent fingerprinting a frame",
+                                    fingerprintHistogram_.snapshot());
+        }
+        perChannel("imaging_channel_idle", "gauge", "Whether the channel publishes keep-alive frames only",
+                   [](const Channel &channel) {
+                       return static_cast<uint64_t>(channel.idleReason.load(std::memory_order_relaxed) != IDLE_NONE);
+                   });
+        perChannel("imaging_channel_idle_frames_total", "counter",
+                   "Frames left out while nothing consumed the channel or the device had no input signal",
+                   [](const Channel &channel) { return channel.framesIdle.load(std::memory_order_relaxed); });
+        channelSummary("imaging_channel_frame_jitter_seconds",
+                       "Distance of each frame interval from a whole number of nominal frame periods",
+                       [](const Channel &channel) -> const LatencyHistogram & {
+                           return channel.pacing.getJitterHistogram();
+                       });
+        family("imaging_channel_dropped_frames_total", "counter", "Frames the pipeline lost, by where they were lost");
+        for (size_t i = 0; i < channels_.size(); ++i) {
+            for (size_t cause = 0; cause < FramePacing::CAUSE_COUNT; ++cause) {
+                auto dropCause = static_cast<DropCause>(cause);
+                sample("imaging_channel_dropped_frames_total",
+                       channelLabels[i] + ",cause=\"" + FramePacing::toString(dropCause) + "\"",
+                       static_cast<double>(channels_[i]->pacing.getDropCount(dropCause)));
+            }
+        }
+        perChannel("imaging_device_dropped_frames_total", "counter", "Frames the device could not deliver",
+                   [](const Channel &channel) { return channel.device->getDroppedFrameCount(); });
+        perChannel("imaging_device_buffer_pool_exhausted_total", "counter",
+                   "Zero-copy buffer acquisitions that found the pool empty",
+                   [](const Channel &channel) { return channel.device->getBufferPoolExhaustedCount(); });
+        perChannel("imaging_device_heap_fallbacks_total", "counter",
+                   "Direct shared memory captures that fell back to heap memory",
+                   [](const Channel &channel) { return channel.device->getDirectCaptureHeapFallbacks(); });
+        perChannel("imaging_device_outstanding_buffers", "gauge",
+                   "Device capture buffers still referenced by frames",
+                   [](const Channel &channel) { return channel.device->getOutstandingBufferCount(); });
+
+        // Rings, labelled so the raw and derived rings of every channel share metric names
+        std::vector<std::pair<std::string, std::shared_ptr<SharedMemory>>> rings;
+        for (const auto &channel: channels_) {
+            std::string channelLabel = ",channel=\"" + std::to_string(channel->index) + "\"";
+            if (channel->sharedMemory) {
+                rings.emplace_back("ring=\"raw\"" + channelLabel, channel->sharedMemory);
+            }
+            if (channel->convertedSharedMemory) {
+                rings.emplace_back("ring=\"converted\"" + channelLabel, channel->convertedSharedMemory);
+            }
+            if (channel->previewSharedMemory) {
+                rings.emplace_back("ring=\"preview\"" + channelLabel, channel->previewSharedMemory);
+            }
+            if (channel->compressedSharedMemory) {
+                rings.emplace_back("ring=\"compressed\"" + channelLabel, channel->compressedSharedMemory);
+            }
+        }
+        if (rings.empty()) {
+            return out;
+        }
+
+        std::vector<SharedMemory::Statistics> ringStats;
+        std::vector<std::vector<SharedMemory::ReaderInfo>> ringReaders;
+        for (const auto &ring: rings) {
+            ringStats.push_back(ring.second->getStatistics());
+            ringReaders.push_back(ring.second->getReaders());
+        }
+
+        family("imaging_shm_frames_written_total", "counter", "Frames published to the ring");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_frames_written_total", rings[i].first,
+                   static_cast<double>(ringStats[i].totalFramesWritten));
+        }
+        family("imaging_shm_dropped_frames_total", "counter", "Frames the ring could not accept");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_dropped_frames_total", rings[i].first, static_cast<double>(ringStats[i].droppedFrames));
+        }
+        family("imaging_shm_buffer_full_total", "counter", "Writes that found the ring full");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_buffer_full_total", rings[i].first, static_cast<double>(ringStats[i].bufferFullCount));
+        }
+        family("imaging_shm_reader_demotions_total", "counter",
+               "Lossless readers the writer made lossy, or detached because their process died");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_reader_demotions_total", rings[i].first + ",reason=\"lag\"",
+                   static_cast<double>(ringStats[i].readersDemotedLag));
+            sample("imaging_shm_reader_demotions_total", rings[i].first + ",reason=\"stale\"",
+                   static_cast<double>(ringStats[i].readersDemotedStale));
+            sample("imaging_shm_reader_demotions_total", rings[i].first + ",reason=\"dead\"",
+                   static_cast<double>(ringStats[i].readersReclaimed));
+        }
+        family("imaging_shm_frames_with_pose_total", "counter", "Frames given a probe pose from the pose ring");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_frames_with_pose_total", rings[i].first, static_cast<double>(ringStats[i].framesWithPose));
+        }
+        family("imaging_shm_occupancy_frames", "gauge", "Frames currently held in the ring");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_occupancy_frames", rings[i].first,
+                   static_cast<double>(rings[i].second->getCurrentFrameCount()));
+        }
+        family("imaging_shm_capacity_frames", "gauge", "Number of frame headers in the ring");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_capacity_frames", rings[i].first, static_cast<double>(rings[i].second->getMaxFrames()));
+        }
+        family("imaging_shm_arena_bytes", "gauge", "Size of the payload arena of the ring");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_arena_bytes", rings[i].first, static_cast<double>(rings[i].second->getArenaSize()));
+        }
+        family("imaging_shm_arena_committed_bytes", "gauge",
+               "Arena bytes of the ring that hold memory, less than the arena when sized adaptively");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_arena_committed_bytes", rings[i].first,
+                   static_cast<double>(rings[i].second->getCommittedArenaBytes()));
+        }
+        family("imaging_shm_pinned_bytes", "gauge", "Arena bytes held for pinned frames, such as a clip being saved");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_pinned_bytes", rings[i].first, static_cast<double>(ringStats[i].pinnedBytes));
+        }
+        family("imaging_shm_pin_detours_total", "counter", "Payloads the writer placed past pinned frames");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            sample("imaging_shm_pin_detours_total", rings[i].first, static_cast<double>(ringStats[i].pinDetours));
+        }
+
+        // Per-reader progress
+        auto readerLabels = [&rings](size_t ring, size_t slot, pid_t pid, ReaderMode mode) {
+            return rings[ring].first + ",slot=\"" + std::to_string(slot) + "\",pid=\"" + std::to_string(pid) +
+                   "\",mode=\"" + (mode == ReaderMode::LOSSLESS ? "lossless" : "lossy") + "\"";
+        };
+        family("imaging_shm_reader_lag_frames", "gauge", "Frames published but not yet consumed by the reader");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            for (const auto &reader: ringReaders[i]) {
+                sample("imaging_shm_reader_lag_frames", readerLabels(i, reader.slot, reader.pid, reader.mode), static_cast<double>(reader.lag));
+            }
+        }
+        family("imaging_shm_reader_frames_read_total", "counter", "Frames consumed by the reader");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            for (const auto &reader: ringReaders[i]) {
+                sample("imaging_shm_reader_frames_read_total", readerLabels(i, reader.slot, reader.pid, reader.mode),
+                       static_cast<double>(reader.framesRead));
+            }
+        }
+        family("imaging_shm_reader_frames_skipped_total", "counter", "Frames lost because the writer lapped the reader");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            for (const auto &reader: ringReaders[i]) {
+                sample("imaging_shm_reader_frames_skipped_total", readerLabels(i, reader.slot, reader.pid, reader.mode),
+                       static_cast<double>(reader.framesSkipped));
+            }
+        }
+        family("imaging_shm_reader_frames_filtered_total", "counter",
+               "Frames passed over because the reader's filter rejected them");
+        for (size_t i = 0; i < rings.size(); ++i) {
+            for (const auto &reader: ringReaders[i]) {
+                sample("imaging_shm_reader_frames_filtered_total", readerLabels(i, reader.slot, reader.pid, reader.mode),
+                       static_cast<double>(reader.framesFiltered));
+            }
+        }
+
+        // Per-consumer latency, sampled by the writer from what each reader reports in its slot
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> consumerLatency;
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> consumerHoldTime;
+        std::vector<std::pair<std::string, LatencyHistogram::Snapshot>> consumerLag;
+        for (size_t i = 0; i < rings.size(); ++i) {
+            for (const auto &latency: rings[i].second->getReaderLatency()) {
+                std::string labels = readerLabels(i, latency.slot, latency.pid, latency.mode);
+                consumerLatency.emplace_back(labels, latency.latency);
+                consumerHoldTime.emplace_back(labels, latency.holdTime);
+                consumerLag.emplace_back(labels, latency.lag);
+            }
+        }
+        if (!consumerLatency.empty()) {
+            appendPrometheusSummary(out, "imaging_shm_reader_latency_seconds",
+                                    "Capture-to-acquire latency of the frames the reader consumed", consumerLatency);
+            appendPrometheusSummary(out, "imaging_shm_reader_hold_seconds",
+                                    "Time the reader held frame views before releasing them", consumerHoldTime);
+
+            // Lag is a frame count, not a duration, so it goes out as plain quantile gauges
+            family("imaging_shm_reader_lag_distribution_frames", "gauge",
+                   "Reader lag sampled after every write, by quantile");
+            for (const auto &[labels, lag]: consumerLag) {
+                sample("imaging_shm_reader_lag_distribution_frames", labels + ",quantile=\"0.5\"",
+                       static_cast<double>(lag.percentile(0.50)));
+                sample("imaging_shm_reader_lag_distribution_frames", labels + ",quantile=\"0.99\"",
+                       static_cast<double>(lag.percentile(0.99)));
+                sample("imaging_shm_reader_lag_distribution_frames", labels + ",quantile=\"1\"",
+                       static_cast<double>(lag.max));
+            }
+        }
+
+        return out;
+    }
+
+    size_t ImagingService::getChannelCount() const {
+        return channels_.size();
+    }
+
+    std::shared_ptr<CaptureDevice> ImagingService::getDevice(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->device : nullptr;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::getSharedMemory(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->sharedMemory : nullptr;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::getConvertedSharedMemory(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->convertedSharedMemory : nullptr;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::getPreviewSharedMemory(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->previewSharedMemory : nullptr;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::getCompressedSharedMemory(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->compressedSharedMemory : nullptr;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::getGpuSharedMemory(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->gpuSharedMemory : nullptr;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::getDmaBufSharedMemory(size_t channel) const {
+        return channel < channels_.size() ? channels_[channel]->dmaBufSharedMemory : nullptr;
+    }
+
+    std::vector<std::pair<std::string, std::shared_ptr<SharedMemory>>> ImagingService::getChannelRings(
+        const Channel &channel) const {
+        std::vector<std::pair<std::string, std::shared_ptr<SharedMemory>>> rings = {
+            {channel.sharedMemoryName, channel.sharedMemory},
+            {channel.convertedSharedMemoryName, channel.convertedSharedMemory},
+            {channel.previewSharedMemoryName, channel.previewSharedMemory},
+            {channel.compressedSharedMemoryName, channel.compressedSharedMemory},
+            {channel.gpuSharedMemoryName, channel.gpuSharedMemory},
+            {channel.dmaBufSharedMemoryName, channel.dmaBufSharedMemory},
+        };
+        if (channel.formatCache) {
+            for (const auto &format: channel.formatCache->getStatistics()) {
+                rings.emplace_back(format.ringName, channel.formatCache->findRing(format.ringName));
+            }
+        }
+
+        // Stages that are disabled have a name but no ring
+        rings.erase(std::remove_if(rings.begin(), rings.end(),
+                                   [](const auto &ring) { return !ring.second || !ring.second->isInitialized(); }),
+                    rings.end());
+        return rings;
+    }
+
+    std::shared_ptr<SharedMemory> ImagingService::findSharedMemory(const std::string &name) const {
+        for (const auto &channel: channels_) {
+            // Format rings are looked up directly, they may have appeared a moment ago
+            if (channel->formatCache) {
+                if (auto ring = channel->formatCache->findRing(name)) {
+                    return ring;
+                }
+            }
+            for (const auto &[ringName, ring]: getChannelRings(*channel)) {
+                if (ringName == name) {
+                    return ring;
+                }
+            }
+        }
+        return nullptr;
     }
 
-    ImagingService::Status ImagingService::setFrameCallback(
-        const std::function<void(std::shared_ptr<Frame>)> &callback) {
-        frameCallback_ = callback;
+    ImagingService::Status ImagingService::saveClip(const std::string &ringName, std::chrono::milliseconds duration,
+                                                    const std::string &filePath) {
+        if (!isInitialized_) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (filePath.empty() || duration.count() <= 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+        auto ring = findSharedMemory(ringName);
+        if (!ring) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        std::vector<std::shared_ptr<Frame>> frames;
+        if (ring->pinRecentFrames(duration, frames) != SharedMemory::Status::OK) {
+            return Status::COMMUNICATION_ERROR;
+        }
+        size_t frameCount = frames.size();
+
+        FrameRecorder::Config recorderConfig;
+        recorderConfig.outputPath = filePath;
+        auto recorder = std::make_unique<FrameRecorder>(recorderConfig);
+        if (recorder->startClip(std::move(frames), ringName) != FrameRecorder::Status::OK) {
+            MIVI_LOG_ERROR("Failed to save a clip of {} to {}", ringName, filePath);
+            return Status::INTERNAL_ERROR;
+        }
+        MIVI_LOG_INFO("Saving {} frames of {} to {}", frameCount, ringName, filePath);
+
+        // Collect the clips that are done while we are here
+        std::lock_guard<std::mutex> lock(clipMutex_);
+        clipRecorders_.erase(std::remove_if(clipRecorders_.begin(), clipRecorders_.end(),
+                                            [](const std::unique_ptr<FrameRecorder> &clip) {
+                                                return clip->isFinished();
+                                            }),
+                             clipRecorders_.end());
+        clipRecorders_.push_back(std::move(recorder));
         return Status::OK;
     }
 
-    ImagingService::PerformanceMetrics ImagingService::getPerformanceMetrics() const {
-        std::lock_guard<std::mutex> lock(metricsMutex_);
-        return metrics_;
+    std::vector<std::string> ImagingService::getSharedMemoryNames() const {
+        std::vector<std::string> names;
+        for (const auto &channel: channels_) {
+            for (const auto &ring: getChannelRings(*channel)) {
+                names.push_back(ring.first);
+            }
+        }
+        return names;
     }
 
-    void ImagingService::resetPerformanceMetrics() {
-        std::lock_guard<std::mutex> lock(metricsMutex_);
-
-        metrics_ = {};
-        startTime_ = std::chrono::system_clock::now();
-        fpsHistory_.clear();
-        latencyHistory_.clear();
+    ImagingService::Status ImagingService::setRegionOfInterest(const RegionOfInterest &roi, size_t channel) {
+        if (roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+        if (channel >= channels_.size()) {
+            return channels_.empty() ? Status::NOT_INITIALIZED : Status::INVALID_ARGUMENT;
+        }
 
-        // Reset counters
-        frameCount_ = 0;
-        droppedFrames_ = 0;
+        // Copy, modify, publish: frames being cropped keep the region they started with
+        std::lock_guard<std::mutex> lock(reconfigureMutex_);
+        LiveSettings settings = liveSettings_.get();
+        settings.regionsOfInterest[channel] = roi;
+        liveSettings_.update(std::move(settings));
+        if (channel == 0) {
+            std::lock_guard<std::mutex> configLock(configMutex_);
+            config_.regionOfInterest = roi;
+        }
+        return Status::OK;
     }
 
-    std::map<std::string, std::string> ImagingService::getStatistics() const {
-        std::map<std::string, std::string> stats;
-
-        // Get basic stats
-        stats["frame_count"] = std::to_string(frameCount_);
-        stats["dropped_frames"] = std::to_string(droppedFrames_);
+    ImagingService::RegionOfInterest ImagingService::getRegionOfInterest(size_t channel) const {
+        if (channel >= channels_.size()) {
+            return {};
+        }
 
-        // Get performance metrics
-        PerformanceMetrics metrics = getPerformanceMetrics();
-        stats["average_fps"] = std::to_string(metrics.averageFps);
-        stats["current_fps"] = std::to_string(metrics.currentFps);
-        stats["average_latency_ms"] = std::to_string(metrics.averageLatencyMs);
-        stats["max_latency_ms"] = std::to_string(metrics.maxLatencyMs);
-        stats["cpu_usage_percent"] = std::to_string(metrics.cpuUsagePercent);
-        stats["memory_usage_mb"] = std::to_string(metrics.memoryUsageMb);
-        stats["uptime_seconds"] = std::to_string(metrics.uptime.count());
+        auto settings = liveSettings_.read();
+        return channel < settings->regionsOfInterest.size() ? settings->regionsOfInterest[channel] : RegionOfInterest();
+    }
 
-        // Add shared memory stats if enabled
-        if (sharedMemory_) {
-            auto shmStats = sharedMemory_->getStatistics();
-            stats["shm_frames_written"] = std::to_string(shmStats.totalFramesWritten);
-            stats["shm_frames_read"] = std::to_string(shmStats.totalFramesRead);
-            stats["shm_dropped_frames"] = std::to_string(shmStats.droppedFrames);
-            stats["shm_avg_write_latency_ns"] = std::to_string(shmStats.writeLatencyNsAvg);
-            stats["shm_avg_read_latency_ns"] = std::to_string(shmStats.readLatencyNsAvg);
-            stats["shm_peak_memory_usage"] = std::to_string(shmStats.peakMemoryUsage);
-            stats["shm_current_frame_count"] = std::to_string(sharedMemory_->getCurrentFrameCount());
-            stats["shm_is_buffer_full"] = sharedMemory_->isBufferFull() ? "true" : "false";
-        }
+    void ImagingService::recordStartupStage(const std::string &name, std::chrono::steady_clock::time_point begin,
+                                            std::chrono::steady_clock::time_point end) {
+        std::lock_guard<std::mutex> lock(startupMutex_);
 
-        // Add device diagnostics
-        if (device_) {
-            auto deviceDiagnostics = device_->getDiagnostics();
-            for (const auto &[key, value]: deviceDiagnostics) {
-                stats["device_" + key] = value;
+        // A stage without a beginning, such as the first frame, starts with the first stage
+        if (begin == std::chrono::steady_clock::time_point{}) {
+            begin = end;
+            for (const auto &stage: startupStages_) {
+                begin = std::min(begin, stage.begin);
             }
         }
 
-        return stats;
+        auto it = std::find_if(startupStages_.begin(), startupStages_.end(),
+                               [&name](const TimedStage &stage) { return stage.name == name; });
+        if (it != startupStages_.end()) {
+            startupStages_.erase(it);
+        }
+        startupStages_.push_back({name, begin, end});
     }
 
-    std::shared_ptr<SharedMemory> ImagingService::getSharedMemory() const {
-        return sharedMemory_;
+    std::vector<ImagingService::StartupStage> ImagingService::getStartupTimeline() const {
+        std::vector<TimedStage> stages;
+        {
+            std::lock_guard<std::mutex> lock(startupMutex_);
+            stages = startupStages_;
+        }
+        std::stable_sort(stages.begin(), stages.end(),
+                         [](const TimedStage &a, const TimedStage &b) { return a.begin < b.begin; });
+
+        auto toMs = [](std::chrono::steady_clock::duration duration) {
+            return std::chrono::duration<double, std::milli>(duration).count();
+        };
+        std::vector<StartupStage> timeline;
+        for (const auto &stage: stages) {
+            timeline.push_back({stage.name, toMs(stage.begin - stages.front().begin), toMs(stage.end - stage.begin)});
+        }
+        return timeline;
     }
 
     bool ImagingService::dumpDiagnostics(const std::string &filePath) const {
@@ -367,6 +2145,7 @@ namespace medical::imaging {
             // Write configuration
             outFile << std::endl << "=== Configuration ===" << std::endl;
             outFile << "Device ID: " << config_.deviceId << std::endl;
+            outFile << "Channels: " << channels_.size() << std::endl;
             outFile << "Shared Memory: " << (config_.enableSharedMemory ? "Enabled" : "Disabled") << std::endl;
             if (config_.enableSharedMemory) {
                 outFile << "Shared Memory Name: " << config_.sharedMemoryName << std::endl;
@@ -375,6 +2154,15 @@ namespace medical::imaging {
             outFile << "Frame Buffer Size: " << config_.frameBufferSize << std::endl;
             outFile << "Realtime Priority: " << (config_.useRealtimePriority ? "Enabled" : "Disabled") << std::endl;
             outFile << "Thread Affinity: " << config_.threadAffinity << std::endl;
+            outFile << "NUMA Node: " << numaNode_ << std::endl;
+
+            // Write the startup timeline
+            outFile << std::endl << "=== Startup Timeline ===" << std::endl;
+            for (const auto &stage: getStartupTimeline()) {
+                outFile << stage.name << ": +" << std::fixed << std::setprecision(1) << stage.startMs
+                        << " ms, took " << stage.durationMs << " ms" << std::endl;
+            }
+            outFile.unsetf(std::ios::floatfield);
 
             // Write statistics
             outFile << std::endl << "=== Statistics ===" << std::endl;
@@ -384,13 +2172,19 @@ namespace medical::imaging {
             }
 
             // Write device info
-            if (device_) {
-                outFile << std::endl << "=== Device Information ===" << std::endl;
-                outFile << "Device ID: " << device_->getDeviceId() << std::endl;
-                outFile << "Device Name: " << device_->getDeviceName() << std::endl;
-                outFile << "Device Model: " << device_->getDeviceModel() << std::endl;
+            for (const auto &channel: channels_) {
+                const auto &device = channel->device;
+                outFile << std::endl << "=== Device Information";
+                if (channels_.size() > 1) {
+                    outFile << " (channel " << channel->index << ")";
+                }
+                outFile << " ===" << std::endl;
+                outFile << "Device ID: " << device->getDeviceId() << std::endl;
+                outFile << "Device Name: " << device->getDeviceName() << std::endl;
+                outFile << "Device Model: " << device->getDeviceModel() << std::endl;
+                outFile << "Shared Memory Name: " << channel->sharedMemoryName << std::endl;
 
-                auto capabilities = device_->getCapabilities();
+                auto capabilities = device->getCapabilities();
                 outFile << "DMA Support: " << (capabilities.supportsDma ? "Yes" : "No") << std::endl;
                 outFile << "GPU Direct Support: " << (capabilities.supportsGpuDirect ? "Yes" : "No") << std::endl;
                 outFile << "Hardware Timestamps: " << (capabilities.supportsHardwareTimestamps ? "Yes" : "No") <<
@@ -402,97 +2196,612 @@ namespace medical::imaging {
                 }
                 outFile << std::endl;
 
-                outFile << "Current Frame Rate: " << device_->getCurrentFrameRate() << " fps" << std::endl;
+                outFile << "Current Frame Rate: " << device->getCurrentFrameRate() << " fps" << std::endl;
             }
 
             outFile.close();
             return true;
         } catch (const std::exception &e) {
-            std::cerr << "Exception in dumpDiagnostics: " << e.what() << std::endl;
+            MIVI_LOG_ERROR("Exception in dumpDiagnostics: {}", e.what());
+            return false;
+        }
+    }
+
+    bool ImagingService::dumpTrace(const std::string &filePath) const {
+        if (!FrameTrace::isEnabled()) {
+            return false;
+        }
+
+        std::string path = filePath;
+        unsigned int windowMs = 0;
+        {
+            auto settings = liveSettings_.read();
+            if (path.empty()) {
+                path = settings->traceFile;
+            }
+            windowMs = settings->traceWindowMs;
+        }
+        if (!FrameTrace::writeChromeTrace(path, std::chrono::milliseconds(windowMs))) {
+            MIVI_LOG_ERROR("Failed to write trace to {}", path);
             return false;
         }
+        return true;
     }
 
-    void ImagingService::handleNewFrame(const std::shared_ptr<Frame> &frame) {
-        if (!frame) {
+    void ImagingService::handleNewFrame(Channel &channel, const std::shared_ptr<Frame> &capturedFrame) {
+        if (!capturedFrame) {
             return;
         }
+        FrameTrace::record(TracePoint::FRAME_ARRIVAL, capturedFrame->getFrameId(), static_cast<uint32_t>(channel.index));
+
+        // A gap in the device's frame numbers is input it never delivered
+        DropCause cause = DropCause::DEVICE;
+        uint64_t bufferShortages = channel.device->getBufferPoolExhaustedCount() +
+                                   channel.device->getDirectCaptureHeapFallbacks();
+        auto captureTimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            capturedFrame->getCaptureTime().time_since_epoch()).count());
+        if (channel.pacing.recordArrival(capturedFrame->getMetadata().frameNumber, captureTimeNs, bufferShortages,
+                                         cause) > 0) {
+            FrameTrace::record(cause == DropCause::BUFFER_POOL ? TracePoint::DROP_BUFFER_POOL : TracePoint::DROP_DEVICE,
+                               capturedFrame->getFrameId(), static_cast<uint32_t>(channel.index));
+            traceDumpRequested_.store(true, std::memory_order_relaxed);
+        }
 
-        // Record frame arrival time for latency calculation
-        auto now = std::chrono::high_resolution_clock::now();
+        // The device's callback thread is not ours to configure at creation; place it on its first frame
+        static thread_local bool captureThreadRegistered = false;
+        if (!captureThreadRegistered) {
+            ThreadLayout::applyCurrentThread("capture-" + std::to_string(channel.index));
+            captureThreadRegistered = true;
+        }
 
-        // Increment the frame count
-        ++frameCount_;
+        // Increment the frame count; the first interval only measures how long capture took to start
+        frameCount_.fetch_add(1, std::memory_order_relaxed);
+        bool firstFrame = channel.frameCount.fetch_add(1, std::memory_order_relaxed) == 0;
 
-        // Calculate inter-frame time for FPS
-        auto frameTime = std::chrono::system_clock::now();
-        auto timeSinceLastFrame = std::chrono::duration_cast<std::chrono::microseconds>(
-            frameTime - lastFrameTime_).count();
-        lastFrameTime_ = frameTime;
+        // Calculate inter-frame time for FPS, per device since channels run at their own rates
+        auto frameTime = std::chrono::steady_clock::now();
+        if (firstFrame && !firstFrameSeen_.exchange(true, std::memory_order_relaxed)) {
+            recordStartupStage("first_frame", std::chrono::steady_clock::time_point{}, frameTime);
+        }
+        auto intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            frameTime - channel.lastFrameTime).count();
+        channel.lastFrameTime = frameTime;
+        if (!firstFrame && intervalNs > 0) {
+            channel.captureIntervalHistogram.record(static_cast<uint64_t>(intervalNs));
+            captureIntervalHistogram_.record(static_cast<uint64_t>(intervalNs));
+        }
 
-        // Update performance metrics
-        {
-            std::lock_guard<std::mutex> lock(metricsMutex_);
+        // Hand the frame to the publisher thread, so the device callback returns in microseconds
+        if (channel.publishQueue) {
+            if (channel.publishQueue->push(PendingFrame{capturedFrame, frameTime})) {
+                futex::ring(channel.publishDoorbell, channel.publishWaiters);
+            } else {
+                // The publisher fell a whole queue behind; dropping here keeps the device's buffers moving
+                channel.publishQueueDrops.fetch_add(1, std::memory_order_relaxed);
+                channel.pacing.recordDrop(DropCause::PUBLISHER_LATE);
+                ++droppedFrames_;
+                FrameTrace::record(TracePoint::DROP_PUBLISH_QUEUE, capturedFrame->getFrameId(),
+                                   static_cast<uint32_t>(channel.index));
+                traceDumpRequested_.store(true, std::memory_order_relaxed);
+            }
+            return;
+        }
 
-            // Update FPS calculation
-            if (timeSinceLastFrame > 0) {
-                double instantFps = 1000000.0 / timeSinceLastFrame;
-                fpsHistory_.push_back(instantFps);
-                if (fpsHistory_.size() > FPS_HISTORY_SIZE) {
-                    fpsHistory_.pop_front();
-                }
+        publishFrame(channel, capturedFrame);
+    }
+
+    void ImagingService::publisherThread(Channel &channel) {
+        bool placed = ThreadLayout::applyCurrentThread("publish-" + std::to_string(channel.index));
+
+        // Stay next to the channel's buffers unless pinned to a core explicitly
+        if (!placed && config_.publishThreadAffinity < 0) {
+            numa::bindCurrentThread(channel.numaNode);
+        }
+
+        PendingFrame pending;
+        while (true) {
+            // Read the doorbell before looking at the queue, so a frame queued after the check wakes us
+            uint32_t doorbell = channel.publishDoorbell.load(std::memory_order_acquire);
+            if (channel.publishQueue->pop(pending)) {
+                publishQueueHistogram_.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - pending.arrivalTime).count()));
+                publishFrame(channel, pending.frame);
+
+                // Returning the capture buffer to the device is part of the publisher's work too
+                pending.frame.reset();
+                continue;
+            }
+
+            // Only stop once every queued frame went out
+            if (channel.stopPublishing.load(std::memory_order_acquire)) {
+                break;
             }
 
-            // Calculate latency
-            auto frameTimestamp = frame->getTimestamp();
-            auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(
-                frameTime - frameTimestamp).count();
+            // Every queued frame and stopPublishers() ring the doorbell; the timeout is only a backstop
+            channel.publishWaiters.fetch_add(1, std::memory_order_seq_cst);
+            if (channel.publishQueue->empty() && !channel.stopPublishing.load(std::memory_order_acquire)) {
+                futex::wait(&channel.publishDoorbell, doorbell, std::chrono::seconds(1));
+            }
+            channel.publishWaiters.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    bool ImagingService::hasConsumers(const Channel &channel) const {
+        if (frameCallback_ || frameDispatcher_.getSubscriberCount() > 0) {
+            return true;
+        }
+
+        // The side stages register on the raw ring themselves; only readers beyond them consume it
+        if (channel.sharedMemory && channel.sharedMemory->isInitialized()) {
+            size_t stages = channel.formatCache ? channel.formatCache->getFormatCount() : 0;
+            stages += channel.frameCompressor && channel.frameCompressor->isRunning() ? 1 : 0;
+            stages += channel.gpuUploader && channel.gpuUploader->isRunning() ? 1 : 0;
+            stages += channel.dmaBufExporter && channel.dmaBufExporter->isRunning() ? 1 : 0;
+            if (channel.sharedMemory->getReaderCount() > stages) {
+                return true;
+            }
+        }
 
-            latencyHistory_.push_back(latencyUs / 1000.0); // Convert to ms
-            if (latencyHistory_.size() > LATENCY_HISTORY_SIZE) {
-                latencyHistory_.pop_front();
+        for (const auto *ring: {&channel.convertedSharedMemory, &channel.previewSharedMemory,
+                                &channel.compressedSharedMemory, &channel.gpuSharedMemory,
+                                &channel.dmaBufSharedMemory}) {
+            if (*ring && (*ring)->getReaderCount() > 0) {
+                return true;
             }
         }
+        return channel.formatCache && channel.formatCache->hasSubscribers();
+    }
+
+    uint8_t ImagingService::checkIdle(const Channel &channel) const {
+        if (config_.idleWithoutSignal && !channel.device->hasInputSignal()) {
+            return IDLE_NO_SIGNAL;
+        }
+        if (config_.idleWhenUnread && !hasConsumers(channel)) {
+            return IDLE_UNREAD;
+        }
+        return IDLE_NONE;
+    }
 
-        // Write to shared memory if enabled
-        if (sharedMemory_ && sharedMemory_->isInitialized()) {
-            auto status = sharedMemory_->writeFrame(frame);
-            if (status != SharedMemory::Status::OK && status != SharedMemory::Status::BUFFER_FULL) {
-                // Log error but continue - don't disrupt the capture flow
-                std::cerr << "Failed to write frame to shared memory: " << static_cast<int>(status) << std::endl;
+    void ImagingService::publishFrame(Channel &channel, const std::shared_ptr<Frame> &capturedFrame) {
+        auto publishStart = std::chrono::steady_clock::now();
+        const auto traceChannel = static_cast<uint32_t>(channel.index);
+        FrameTrace::record(TracePoint::PUBLISH_BEGIN, capturedFrame->getFrameId(), traceChannel);
+
+        // Between exams nothing may read the channel, or nothing is plugged in: skip the copies and the
+        // consumers but for a keep-alive frame now and then. A reader that registers gets the next frame.
+        uint8_t idleReason = checkIdle(channel);
+        if (channel.idleReason.exchange(idleReason, std::memory_order_relaxed) != idleReason) {
+            if (idleReason == IDLE_NONE) {
+                MIVI_LOG_INFO("Channel {} publishing every frame again", channel.index);
+            } else {
+                MIVI_LOG_INFO("Channel {} idle ({}), publishing {:.1f} keep-alive frames per second",
+                              channel.index, idleReason == IDLE_NO_SIGNAL ? "no input signal" : "no consumers",
+                              config_.idleKeepAliveRate);
+            }
+        }
+        if (idleReason != IDLE_NONE) {
+            if (config_.idleKeepAliveRate <= 0.0 || publishStart < channel.nextIdleKeepAliveTime) {
+                channel.framesIdle.fetch_add(1, std::memory_order_relaxed);
+                FrameTrace::record(TracePoint::PUBLISH_END, capturedFrame->getFrameId(), traceChannel);
+                return;
             }
+            channel.nextIdleKeepAliveTime = publishStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / config_.idleKeepAliveRate));
         }
 
-        // Update frame buffer if needed (minimal buffering)
-        bool frameBufferFull = false; {
-            std::lock_guard<std::mutex> lock(frameBufferMutex_);
+        // One snapshot of the live settings for the whole frame, released before any user code runs
+        std::shared_ptr<Frame> frame;
+        {
+            auto settings = liveSettings_.read();
+
+            // Everything downstream only sees the region of interest
+            frame = cropFrame(channel, capturedFrame, *settings);
+
+            // A frozen image keeps arriving at full rate; recognise repeats before paying for copies and consumers
+            uint64_t fingerprint = 0;
+            if (settings->duplicatePolicy != DuplicatePolicy::PUBLISH) {
+                auto fingerprintStart = std::chrono::steady_clock::now();
+                fingerprint = FrameFingerprint::compute(*frame, settings->fingerprintSamples);
+                fingerprintHistogram_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - fingerprintStart).count()));
+                bool repeated = fingerprint != 0 && fingerprint == channel.lastFingerprint;
+                channel.lastFingerprint = fingerprint;
+
+                // Under THROTTLE a repeat is left out entirely, except for a full frame per keep-alive interval
+                if (settings->duplicatePolicy == DuplicatePolicy::THROTTLE) {
+                    if (repeated && (settings->duplicateKeepAliveRate <= 0.0 || publishStart < channel.nextKeepAliveTime)) {
+                        channel.framesSuppressed.fetch_add(1, std::memory_order_relaxed);
+                        FrameTrace::record(TracePoint::PUBLISH_END, frame->getFrameId(), traceChannel);
+                        return;
+                    }
+                    if (settings->duplicateKeepAliveRate > 0.0) {
+                        channel.nextKeepAliveTime = publishStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(1.0 / settings->duplicateKeepAliveRate));
+                    }
+                }
+            }
 
-            // Store the frame in the buffer
-            frameBuffer_[frameBufferTail_] = frame;
+            // Write to shared memory if enabled
+            const auto &sharedMemory = channel.sharedMemory;
+            bool published = false;
+            bool ringFull = false;
+            if (sharedMemory && sharedMemory->isInitialized()) {
+                FrameTrace::record(TracePoint::SHM_WRITE_BEGIN, frame->getFrameId(), traceChannel);
+                auto status = writeDuplicate(*sharedMemory, channel.rawFingerprint, frame, fingerprint, *settings);
+                if (status == SharedMemory::Status::OK) {
+                    channel.framesDuplicate.fetch_add(1, std::memory_order_relaxed);
+                } else if (status == SharedMemory::Status::BUFFER_EMPTY) {
+                    status = sharedMemory->writeFrame(frame);
+                    if (status == SharedMemory::Status::OK) {
+                        channel.rawFingerprint.fingerprint = fingerprint;
+                        channel.rawFingerprint.frameId = frame->getFrameId();
+                    }
+                }
+                FrameTrace::record(TracePoint::SHM_WRITE_END, frame->getFrameId(), traceChannel);
+                published = status == SharedMemory::Status::OK;
+                if (status == SharedMemory::Status::BUFFER_FULL) {
+                    ringFull = true;
+                    channel.pacing.recordDrop(DropCause::RING_FULL);
+                    FrameTrace::record(TracePoint::DROP_RING_FULL, frame->getFrameId(), traceChannel);
+                    traceDumpRequested_.store(true, std::memory_order_relaxed);
+                } else if (status != SharedMemory::Status::OK) {
+                    // Log error but continue - don't disrupt the capture flow
+                    MIVI_LOG_ERROR("Failed to write frame to shared memory: {}", static_cast<int>(status));
+                }
+            }
+            auto publishTime = std::chrono::steady_clock::now();
+            if (sharedMemory) {
+                shmWriteHistogram_.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(publishTime - publishStart).count()));
+            }
 
-            // Check if we need to overwrite frames
-            bool frameOverwritten = (frameBufferTail_ + 1) % frameBuffer_.size() == frameBufferHead_;
+            // Capture-to-publish latency, measured on the monotonic clock the device stamped the frame with
+            if (frame->getCaptureTime().time_since_epoch().count() != 0 && publishTime > frame->getCaptureTime()) {
+                latencyHistogram_.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(publishTime - frame->getCaptureTime()).count()));
+            }
 
-            // Advance the tail
-            frameBufferTail_ = (frameBufferTail_ + 1) % frameBuffer_.size();
+            // Publish the converted channel after the raw frame so raw consumers see no extra latency
+            if (channel.frameConverter && channel.convertedSharedMemory) {
+                publishConvertedFrame(channel, frame, fingerprint, *settings);
+            }
 
-            // If the buffer was full, advance the head and count the drop
-            if (frameOverwritten) {
-                frameBufferHead_ = (frameBufferHead_ + 1) % frameBuffer_.size();
-                ++droppedFrames_;
-                frameBufferFull = true;
+            // The preview goes last; it is the stage viewers tolerate the most latency on
+            if (channel.frameScaler && channel.previewSharedMemory) {
+                publishPreviewFrame(channel, frame, fingerprint, *settings);
             }
-        }
 
-        // Log buffer full condition if it occurred and logging is enabled
-        if (frameBufferFull && config_.logPerformanceStats) {
-            std::cerr << "Warning: Frame buffer full, oldest frame dropped" << std::endl;
+            // Keep the frame around for getRetainedFrame() without pinning the device's buffer. A frame the
+            // full ring dropped is not copied: the publisher is already behind when that happens.
+            if (!ringFull) {
+                retainFrame(channel, frame, published);
+            }
+            FrameTrace::record(TracePoint::PUBLISH_END, frame->getFrameId(), traceChannel);
         }
 
         // Call the user callback if set
         if (frameCallback_) {
             frameCallback_(frame);
         }
+
+        // Subscribers only get the frame queued; they run on their own threads
+        frameDispatcher_.dispatch(frame);
+
+        // Publishing has one frame interval before the next frame is due; anything longer is a miss
+        double frameRate = channel.device->getCurrentFrameRate();
+        if (frameRate > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - publishStart).count() >
+                               1.0 / frameRate) {
+            ThreadAccounting::recordDeadlineMiss();
+        }
+    }
+
+    void ImagingService::retainFrame(Channel &channel, const std::shared_ptr<Frame> &frame, bool published) {
+        if (channel.retainedFrames.empty()) {
+            return;
+        }
+
+        // A published frame is retained by the ring itself; remember where to find it
+        if (published) {
+            std::lock_guard<std::mutex> lock(channel.retainedMutex);
+            RetainedFrame &slot = channel.retainedFrames[channel.retainedNext];
+            slot.frameId = frame->getFrameId();
+            slot.copy.reset();
+            channel.retainedNext = (channel.retainedNext + 1) % channel.retainedFrames.size();
+            ++channel.retainedTotal;
+            return;
+        }
+
+        // Otherwise copy, reusing the evicted copy's memory unless a caller still holds it
+        std::shared_ptr<Frame> copy;
+        {
+            std::lock_guard<std::mutex> lock(channel.retainedMutex);
+            copy = std::move(channel.retainedFrames[channel.retainedNext].copy);
+        }
+        if (copy && copy.use_count() == 1 && copy->getDataSize() == frame->getDataSize() &&
+            copy->getWidth() == frame->getWidth() && copy->getHeight() == frame->getHeight() &&
+            copy->getPixelFormat() == frame->getPixelFormat() && copy->lock(false)) {
+            // Locking for writing leaves a buffer the copy shared with another frame to that frame
+            std::memcpy(copy->getData(), frame->getData(), frame->getDataSize());
+            copy->unlock();
+            copyFrameAttributes(*frame, *copy);
+        } else {
+            copy = copyFrame(*frame);
+        }
+        if (!copy) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(channel.retainedMutex);
+        RetainedFrame &slot = channel.retainedFrames[channel.retainedNext];
+        slot.frameId = copy->getFrameId();
+        slot.copy = std::move(copy);
+        channel.retainedNext = (channel.retainedNext + 1) % channel.retainedFrames.size();
+        ++channel.retainedTotal;
+    }
+
+    ImagingService::Status ImagingService::getRetainedFrame(size_t age, std::shared_ptr<Frame> &frame,
+                                                            size_t channelIndex) const {
+        if (!isInitialized_) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (channelIndex >= channels_.size()) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        const Channel &channel = *channels_[channelIndex];
+        RetainedFrame entry;
+        {
+            std::lock_guard<std::mutex> lock(channel.retainedMutex);
+            size_t capacity = channel.retainedFrames.size();
+            if (age >= capacity || age >= channel.retainedTotal) {
+                return Status::INVALID_ARGUMENT;
+            }
+            entry = channel.retainedFrames[(channel.retainedNext + capacity - 1 - age) % capacity];
+        }
+
+        if (entry.copy) {
+            frame = std::move(entry.copy);
+            return Status::OK;
+        }
+
+        // Copy out of the ring, then make sure the writer did not reuse the slot meanwhile
+        std::shared_ptr<Frame> view;
+        if (!channel.sharedMemory || channel.sharedMemory->findFrame(entry.frameId, view) != SharedMemory::Status::OK) {
+            return Status::INVALID_ARGUMENT;
+        }
+        std::shared_ptr<Frame> copy = copyFrame(*view);
+        if (!copy || !view->validate()) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        frame = std::move(copy);
+        return Status::OK;
+    }
+
+    std::shared_ptr<Frame> ImagingService::cropFrame(Channel &channel, const std::shared_ptr<Frame> &frame,
+                                                     const LiveSettings &settings) {
+        const RegionOfInterest &roi = settings.regionsOfInterest[channel.index];
+        if (!roi.isEnabled()) {
+            return frame;
+        }
+
+        // Clamp to the frame; x must start a pixel block and the width must fill whole padded rows
+        const PixelFormatInfo info = getPixelFormatInfo(frame->getPixelFormat());
+        int width = frame->getWidth();
+        int height = frame->getHeight();
+        if (info.pixelsPerBlock == 0 || height <= 0 || !frame->getData()) {
+            return frame;
+        }
+        int blockPixels = static_cast<int>(info.pixelsPerBlock);
+        int rowPixels = blockPixels * static_cast<int>(info.blocksPerRowAlignment);
+        int x = std::min(roi.x, width) / blockPixels * blockPixels;
+        int y = std::min(roi.y, height);
+        int cropWidth = std::min(roi.width, width - x) / rowPixels * rowPixels;
+        int cropHeight = std::min(roi.height, height - y);
+        if (cropWidth <= 0 || cropHeight <= 0 || (cropWidth == width && cropHeight == height)) {
+            return frame;
+        }
+
+        size_t srcStride = frame->getDataSize() / height;
+        size_t xOffset = static_cast<size_t>(x / blockPixels) * info.bytesPerBlock;
+        size_t rowBytes = info.rowBytes(cropWidth);
+        if (xOffset + rowBytes > srcStride) {
+            return frame;
+        }
+        size_t cropSize = rowBytes * cropHeight;
+        const auto *src = static_cast<const uint8_t *>(frame->getData()) + y * srcStride + xOffset;
+
+        // A frame in a capture buffer of the ring is compacted where it lies: every row moves to a lower
+        // address, so the region ends up at the start of the buffer and is still published zero-copy
+        std::shared_ptr<Frame> cropped;
+        const auto &sharedMemory = channel.sharedMemory;
+        if (sharedMemory && sharedMemory->isCaptureBuffer(frame->getData())) {
+            auto *dst = static_cast<uint8_t *>(frame->getData());
+            for (int row = 0; row < cropHeight; ++row) {
+                std::memmove(dst + row * rowBytes, src + row * srcStride, rowBytes);
+            }
+            cropped = Frame::createWithExternalData(dst, cropSize, cropWidth, cropHeight, frame->getBytesPerPixel(),
+                                                    frame->getPixelFormat(), false, BufferType::EXTERNAL_MEMORY);
+            if (cropped) {
+                // The capture buffer lease is returned when the captured frame goes away
+                cropped->setOnDestroy([frame]() {});
+                channel.framesCroppedInPlace.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else {
+            // Anything else is copied once, region only, into a capture buffer so writeFrame() does not copy again
+            int lease = sharedMemory ? sharedMemory->acquireCaptureBuffer(cropSize) : -1;
+            void *data = lease >= 0 ? sharedMemory->getCaptureBufferData(lease) : nullptr;
+            bool ownsData = false;
+            if (!data) {
+                if (lease >= 0) {
+                    sharedMemory->releaseCaptureBuffer(lease);
+                    lease = -1;
+                }
+                data = std::malloc(cropSize);
+                ownsData = true;
+            }
+            if (!data) {
+                return frame;
+            }
+            auto *dst = static_cast<uint8_t *>(data);
+            for (int row = 0; row < cropHeight; ++row) {
+                std::memcpy(dst + row * rowBytes, src + row * srcStride, rowBytes);
+            }
+            cropped = Frame::createWithExternalData(data, cropSize, cropWidth, cropHeight, frame->getBytesPerPixel(),
+                                                    frame->getPixelFormat(), ownsData, BufferType::EXTERNAL_MEMORY);
+            if (!cropped) {
+                if (ownsData) {
+                    std::free(data);
+                } else {
+                    sharedMemory->releaseCaptureBuffer(lease);
+                }
+                return frame;
+            }
+            if (lease >= 0) {
+                std::shared_ptr<SharedMemory> ring = sharedMemory;
+                cropped->setOnDestroy([ring, lease]() {
+                    ring->releaseCaptureBuffer(lease);
+                });
+            }
+        }
+        if (!cropped) {
+            return frame;
+        }
+
+        cropped->setFrameId(frame->getFrameId());
+        cropped->setSequenceNumber(frame->getSequenceNumber());
+        cropped->setTimestamp(frame->getTimestamp());
+        cropped->setCaptureTime(frame->getCaptureTime());
+        FrameMetadata &metadata = cropped->getMetadataMutable();
+        metadata = frame->getMetadata();
+        if (metadata.width != 0) {
+            metadata.width = static_cast<uint32_t>(cropWidth);
+        }
+        if (metadata.height != 0) {
+            metadata.height = static_cast<uint32_t>(cropHeight);
+        }
+        metadata.roiX = static_cast<uint32_t>(x);
+        metadata.roiY = static_cast<uint32_t>(y);
+        metadata.sourceWidth = static_cast<uint32_t>(width);
+        metadata.sourceHeight = static_cast<uint32_t>(height);
+        channel.framesCropped.fetch_add(1, std::memory_order_relaxed);
+        return cropped;
+    }
+
+    SharedMemory::Status ImagingService::writeDuplicate(SharedMemory &ring, const PublishedFingerprint &published,
+                                                        const std::shared_ptr<Frame> &frame, uint64_t fingerprint,
+                                                        const LiveSettings &settings) const {
+        // BUFFER_EMPTY tells the caller to publish the frame in full
+        if (settings.duplicatePolicy != DuplicatePolicy::MARK || fingerprint == 0 ||
+            fingerprint != published.fingerprint) {
+            return SharedMemory::Status::BUFFER_EMPTY;
+        }
+        return ring.writeDuplicateFrame(frame, published.frameId);
+    }
+
+    void ImagingService::publishConvertedFrame(Channel &channel, const std::shared_ptr<Frame> &frame,
+                                               uint64_t fingerprint, const LiveSettings &settings) {
+        FrameConverter &frameConverter = *channel.frameConverter;
+        SharedMemory &convertedSharedMemory = *channel.convertedSharedMemory;
+        if (!FrameConverter::supports(frame->getPixelFormat(), frameConverter.getOutputFormat())) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        // The converted ring already holds this image, so there is nothing to convert
+        if (writeDuplicate(convertedSharedMemory, channel.convertedFingerprint, frame, fingerprint, settings) !=
+            SharedMemory::Status::BUFFER_EMPTY) {
+            return;
+        }
+
+        // Convert straight into leased arena space so writeFrame() publishes it without a copy
+        size_t outputSize = frameConverter.getOutputSize(frame->getWidth(), frame->getHeight());
+        int lease = convertedSharedMemory.acquireCaptureBuffer(outputSize);
+        void *output = lease >= 0 ? convertedSharedMemory.getCaptureBufferData(lease) : nullptr;
+
+        auto converted = frameConverter.convert(*frame, output, outputSize);
+        if (converted) {
+            auto status = convertedSharedMemory.writeFrame(converted);
+            if (status == SharedMemory::Status::OK) {
+                channel.convertedFingerprint.fingerprint = fingerprint;
+                channel.convertedFingerprint.frameId = frame->getFrameId();
+            } else if (status != SharedMemory::Status::BUFFER_FULL) {
+                MIVI_LOG_ERROR("Failed to write converted frame to shared memory: {}", static_cast<int>(status));
+            }
+        }
+        converted.reset();
+
+        if (lease >= 0) {
+            convertedSharedMemory.releaseCaptureBuffer(lease);
+        }
+
+        conversionHistogram_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+
+    void ImagingService::publishPreviewFrame(Channel &channel, const std::shared_ptr<Frame> &frame,
+                                             uint64_t fingerprint, const LiveSettings &settings) {
+        FrameScaler &frameScaler = *channel.frameScaler;
+        SharedMemory &previewSharedMemory = *channel.previewSharedMemory;
+        if (!FrameScaler::supports(frame->getPixelFormat())) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        // Temporal decimation on the capture clock, so delivery jitter does not change the preview rate.
+        // A quarter interval of slack keeps a 60 fps source at 30 fps instead of every third frame.
+        if (settings.previewFrameRate > 0.0) {
+            auto frameTime = frame->getCaptureTime().time_since_epoch().count() != 0 ? frame->getCaptureTime() : start;
+            auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / settings.previewFrameRate));
+            if (frameTime + interval / 4 < channel.nextPreviewTime) {
+                channel.previewFramesSkipped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            // Keep to the schedule, but restart it rather than bursting after a gap
+            channel.nextPreviewTime = channel.nextPreviewTime + interval > frameTime
+                                          ? channel.nextPreviewTime + interval
+                                          : frameTime + interval;
+        }
+
+        // The preview ring already holds this image, so there is nothing to scale
+        if (writeDuplicate(previewSharedMemory, channel.previewFingerprint, frame, fingerprint, settings) !=
+            SharedMemory::Status::BUFFER_EMPTY) {
+            return;
+        }
+
+        // Scale straight into leased arena space so writeFrame() publishes it without a copy
+        int outputWidth = 0;
+        int outputHeight = 0;
+        size_t outputSize = frameScaler.getOutputSize(frame->getPixelFormat(), frame->getWidth(), frame->getHeight(),
+                                                      outputWidth, outputHeight);
+        if (outputSize == 0) {
+            return;
+        }
+        int lease = previewSharedMemory.acquireCaptureBuffer(outputSize);
+        void *output = lease >= 0 ? previewSharedMemory.getCaptureBufferData(lease) : nullptr;
+
+        auto scaled = frameScaler.scale(*frame, output, outputSize);
+        if (scaled) {
+            auto status = previewSharedMemory.writeFrame(scaled);
+            if (status == SharedMemory::Status::OK) {
+                channel.previewFingerprint.fingerprint = fingerprint;
+                channel.previewFingerprint.frameId = frame->getFrameId();
+            } else if (status != SharedMemory::Status::BUFFER_FULL) {
+                MIVI_LOG_ERROR("Failed to write preview frame to shared memory: {}", static_cast<int>(status));
+            }
+        }
+        scaled.reset();
+
+        if (lease >= 0) {
+            previewSharedMemory.releaseCaptureBuffer(lease);
+        }
+
+        previewHistogram_.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
     }
 
     void ImagingService::performanceMonitorThread() {
@@ -506,26 +2815,67 @@ namespace medical::imaging {
                            (lastUsage.ru_utime.tv_usec + lastUsage.ru_stime.tv_usec) / 1000000.0;
         auto lastTimestamp = std::chrono::steady_clock::now();
 
+        // Stay off the other socket unless pinned to a core explicitly
+        bool placed = ThreadLayout::applyCurrentThread("monitor");
+        if (!placed && config_.threadAffinity < 0) {
+            numa::bindCurrentThread(numaNode_);
+        }
+
         while (!stopRequested_) {
-            // Sleep for a short interval
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            // Update every second, or every few seconds while no channel publishes every frame; stop() wakes us
+            bool idle = std::all_of(channels_.begin(), channels_.end(), [](const std::unique_ptr<Channel> &channel) {
+                return channel->idleReason.load(std::memory_order_relaxed) != IDLE_NONE;
+            });
+            {
+                std::unique_lock<std::mutex> lock(monitorMutex_);
+                monitorCondition_.wait_for(lock, idle ? std::chrono::seconds(5) : std::chrono::seconds(1),
+                                           [this] { return stopRequested_.load(); });
+            }
 
             // Skip if we're stopping
             if (stopRequested_) {
                 break;
             }
 
-            // Update performance metrics
+            // Update performance metrics, starting from the scheduler's view of the pipeline threads
+            ThreadAccounting::update();
             updatePerformanceMetrics();
+            updatePacing();
+            resizeRings();
+
+            bool traceOnDrop = false;
+            std::string traceFile;
+            bool logPerformanceStats = false;
+            int performanceLogIntervalMs = 0;
+            {
+                auto settings = liveSettings_.read();
+                traceOnDrop = settings->traceOnDrop;
+                traceFile = settings->traceFile;
+                logPerformanceStats = settings->logPerformanceStats;
+                performanceLogIntervalMs = settings->performanceLogIntervalMs;
+            }
+
+            // Save the moments leading up to a drop, at most every 10 seconds so a stall does not flood the disk
+            if (traceOnDrop && traceDumpRequested_.exchange(false, std::memory_order_relaxed)) {
+                static auto lastTraceDump = std::chrono::steady_clock::time_point{};
+                auto now = std::chrono::steady_clock::now();
+                if (lastTraceDump == std::chrono::steady_clock::time_point{} ||
+                    now - lastTraceDump >= std::chrono::seconds(10)) {
+                    if (dumpTrace(traceFile)) {
+                        MIVI_LOG_INFO("Frame dropped, trace written to {}", traceFile);
+                    }
+                    lastTraceDump = now;
+                }
+            }
 
             // Log performance statistics if enabled
-            if (config_.logPerformanceStats) {
+            if (logPerformanceStats) {
                 // Only log every performanceLogIntervalMs ms
                 static auto lastLogTime = std::chrono::steady_clock::now();
                 auto now = std::chrono::steady_clock::now();
 
                 if (std::chrono::duration_cast<std::chrono::milliseconds>(
-                        now - lastLogTime).count() >= config_.performanceLogIntervalMs) {
+                        now - lastLogTime).count() >= performanceLogIntervalMs) {
                     // Get current metrics
                     PerformanceMetrics metrics; {
                         std::lock_guard<std::mutex> lock(metricsMutex_);
@@ -533,14 +2883,10 @@ namespace medical::imaging {
                     }
 
                     // Log to console
-                    std::cout << "Performance: "
-                            << "FPS=" << std::fixed << std::setprecision(1) << metrics.currentFps
-                            << " Latency=" << std::fixed << std::setprecision(2) << metrics.averageLatencyMs << "ms"
-                            << " CPU=" << std::fixed << std::setprecision(1) << metrics.cpuUsagePercent << "%"
-                            << " Mem=" << std::fixed << std::setprecision(1) << metrics.memoryUsageMb << "MB"
-                            << " Frames=" << frameCount_
-                            << " Dropped=" << droppedFrames_
-                            << std::endl;
+                    MIVI_LOG_INFO("Performance: FPS={:.1f} Latency={:.2f}ms p99={:.2f}ms CPU={:.1f}% Mem={:.1f}MB "
+                                  "Frames={} Dropped={}",
+                            metrics.currentFps, metrics.averageLatencyMs, metrics.p99LatencyMs,
+                            metrics.cpuUsagePercent, metrics.memoryUsageMb, frameCount_.load(), droppedFrames_.load());
 
                     lastLogTime = now;
                 }
@@ -548,6 +2894,117 @@ namespace medical::imaging {
         }
     }
 
+    void ImagingService::updatePacing() {
+        for (auto &channel: channels_) {
+            // The mode may change under a running capture
+            channel->pacing.setNominalRate(channel->device->getCurrentConfiguration().frameRate);
+            if (!channel->sharedMemory) {
+                continue;
+            }
+
+            // Readers count the frames they were lapped over themselves; attribute the growth since the last look
+            std::vector<ReaderSkips> current;
+            for (const auto &reader: channel->sharedMemory->getReaders()) {
+                current.push_back(ReaderSkips{reader.slot, reader.pid, reader.framesSkipped});
+                auto previous = std::find_if(channel->readerSkips.begin(), channel->readerSkips.end(),
+                                             [&reader](const ReaderSkips &skips) {
+                                                 return skips.slot == reader.slot && skips.pid == reader.pid;
+                                             });
+                uint64_t before = previous != channel->readerSkips.end() ? previous->framesSkipped : 0;
+                if (reader.framesSkipped > before) {
+                    channel->pacing.recordDrop(DropCause::READER_OVERWRITTEN, reader.framesSkipped - before);
+                    FrameTrace::record(TracePoint::DROP_READER_OVERWRITTEN, reader.lastSequence,
+                                       static_cast<uint32_t>(channel->index));
+                    traceDumpRequested_.store(true, std::memory_order_relaxed);
+                }
+            }
+            channel->readerSkips = std::move(current);
+        }
+    }
+
+    void ImagingService::resizeRings() {
+        if (!config_.adaptiveRingSize) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        for (auto &channel: channels_) {
+            if (!channel->sharedMemory) {
+                continue;
+            }
+            SharedMemory &ring = *channel->sharedMemory;
+
+            // p99.9 lag of the furthest behind reader since the last look. A reader that consumed less
+            // than 90% of what was published in that time and never caught up is too slow or stalled:
+            // any ring fills up behind it, so it is left to the reader mode and does not grow the ring.
+            uint64_t lag = 0;
+            std::vector<ReaderLag> current;
+            std::vector<SharedMemory::ReaderInfo> readers = ring.getReaders();
+            for (auto &reader: ring.getReaderLatency()) {
+                auto info = std::find_if(readers.begin(), readers.end(), [&reader](const SharedMemory::ReaderInfo &entry) {
+                    return entry.slot == reader.slot && entry.pid == reader.pid;
+                });
+                if (info == readers.end()) {
+                    continue;
+                }
+                ReaderLag sample{reader.slot, reader.pid, std::move(reader.lag), info->cursor + info->lag,
+                                 info->framesRead + info->framesFiltered};
+
+                auto previous = std::find_if(channel->readerLag.begin(), channel->readerLag.end(),
+                                             [&sample](const ReaderLag &entry) {
+                                                 return entry.slot == sample.slot && entry.pid == sample.pid;
+                                             });
+                LatencyHistogram::Snapshot window = sample.lag;
+                bool keepingUp = true;
+                if (previous != channel->readerLag.end()) {
+                    window -= previous->lag;
+                    uint64_t published = sample.published - std::min(sample.published, previous->published);
+                    uint64_t consumed = sample.consumed - std::min(sample.consumed, previous->consumed);
+                    keepingUp = consumed * 10 >= published * 9 || window.percentile(0.1) <= 1;
+                }
+                if (keepingUp) {
+                    lag = std::max(lag, window.percentile(0.999));
+                }
+                current.push_back(std::move(sample));
+            }
+            channel->readerLag = std::move(current);
+
+            // Room for the lag with headroom, within the header table
+            auto frames = static_cast<size_t>(std::ceil(static_cast<double>(lag) * config_.ringLagHeadroom));
+            frames = std::max(frames, static_cast<size_t>(std::max(config_.ringMinFrames, 1)));
+            frames = std::min(frames, ring.getMaxFrames());
+            size_t target = ringFrameBytes(ring, frames, modeFrameBytes(channel->device->getCurrentConfiguration()));
+            size_t limit = ring.getArenaLimit();
+
+            if (target > limit && limit < ring.getArenaSize()) {
+                // Readers are getting close to being lapped, or the mode got larger
+                ring.resizeArena(target);
+                channel->ringQuietSince = {};
+                MIVI_LOG_INFO("Ring '{}' grown to {} MB for a reader lag of {} frames", channel->sharedMemoryName,
+                              ring.getArenaLimit() >> 20, lag);
+            } else if (target < limit / 2) {
+                // Give memory back only once the lag has stayed low for a while
+                if (channel->ringQuietSince == std::chrono::steady_clock::time_point{}) {
+                    channel->ringQuietSince = now;
+                } else if (now - channel->ringQuietSince >= std::chrono::milliseconds(config_.ringShrinkDelayMs)) {
+                    ring.resizeArena(target);
+                    channel->ringQuietSince = {};
+                    if (ring.getArenaLimit() < limit) {
+                        MIVI_LOG_INFO("Ring '{}' shrunk to {} MB", channel->sharedMemoryName,
+                                      ring.getArenaLimit() >> 20);
+                    }
+                }
+            } else {
+                channel->ringQuietSince = {};
+            }
+
+            // Pages that were still in use when the ring shrank
+            if (ring.getCommittedArenaBytes() > ring.getArenaLimit()) {
+                ring.resizeArena(ring.getArenaLimit());
+            }
+        }
+    }
+
     void ImagingService::updatePerformanceMetrics() {
         std::lock_guard<std::mutex> lock(metricsMutex_);
 
@@ -566,22 +3023,24 @@ namespace medical::imaging {
             metrics_.averageFps = 0.0;
         }
 
-        // Calculate current FPS from recent history
-        if (!fpsHistory_.empty()) {
-            metrics_.currentFps = std::accumulate(fpsHistory_.begin(), fpsHistory_.end(), 0.0) / fpsHistory_.size();
-        } else {
-            metrics_.currentFps = 0.0;
+        // Calculate current FPS from the intervals each device recorded since the previous update
+        metrics_.currentFps = 0.0;
+        for (auto &channel: channels_) {
+            LatencyHistogram::Snapshot intervals = channel->captureIntervalHistogram.snapshot();
+            LatencyHistogram::Snapshot window = intervals;
+            window -= channel->lastIntervalSnapshot;
+            channel->lastIntervalSnapshot = intervals;
+            channel->currentFps = window.count > 0 ? 1e9 / window.mean() : 0.0;
+            metrics_.currentFps += channel->currentFps;
         }
 
         // Calculate latency statistics
-        if (!latencyHistory_.empty()) {
-            metrics_.averageLatencyMs = std::accumulate(latencyHistory_.begin(), latencyHistory_.end(), 0.0) /
-                                        latencyHistory_.size();
-            metrics_.maxLatencyMs = *std::max_element(latencyHistory_.begin(), latencyHistory_.end());
-        } else {
-            metrics_.averageLatencyMs = 0.0;
-            metrics_.maxLatencyMs = 0.0;
-        }
+        LatencyHistogram::Snapshot latency = latencyHistogram_.snapshot();
+        metrics_.averageLatencyMs = latency.mean() / 1e6;
+        metrics_.p50LatencyMs = latency.percentile(0.50) / 1e6;
+        metrics_.p99LatencyMs = latency.percentile(0.99) / 1e6;
+        metrics_.p999LatencyMs = latency.percentile(0.999) / 1e6;
+        metrics_.maxLatencyMs = latency.max / 1e6;
 
         // Get CPU usage
         struct rusage currentUsage;
@@ -590,26 +3049,27 @@ namespace medical::imaging {
         double currentCpuTime = currentUsage.ru_utime.tv_sec + currentUsage.ru_stime.tv_sec +
                                 (currentUsage.ru_utime.tv_usec + currentUsage.ru_stime.tv_usec) / 1000000.0;
 
-        static double lastCpuTime = 0.0;
+        // The first call only takes the reference point; CPU time since process start is not a rate
+        static double lastCpuTime = -1.0;
         static auto lastCpuCheckTime = std::chrono::steady_clock::now();
 
         auto currentTime = std::chrono::steady_clock::now();
         double elapsedSeconds = std::chrono::duration_cast<std::chrono::microseconds>(
                                     currentTime - lastCpuCheckTime).count() / 1000000.0;
 
-        if (elapsedSeconds > 0) {
+        if (lastCpuTime >= 0.0 && elapsedSeconds > 0) {
+            // Percent of one core; several busy threads take it past 100
             double cpuSeconds = currentCpuTime - lastCpuTime;
-            metrics_.cpuUsagePercent = (cpuSeconds / elapsedSeconds) * 100.0;
-
-            // Clamp to valid range
-            metrics_.cpuUsagePercent = std::max(0.0, std::min(100.0, metrics_.cpuUsagePercent));
-
-            lastCpuTime = currentCpuTime;
-            lastCpuCheckTime = currentTime;
+            metrics_.cpuUsagePercent = std::max(0.0, (cpuSeconds / elapsedSeconds) * 100.0);
         }
-
-        // Get memory usage
-        metrics_.memoryUsageMb = currentUsage.ru_maxrss / 1024.0; // Convert to MB
+        lastCpuTime = currentCpuTime;
+        lastCpuCheckTime = currentTime;
+
+        // Get memory usage: what is resident now, not the high-water mark ru_maxrss reports
+        ThreadAccounting::MemoryStatistics memory = ThreadAccounting::getMemoryStatistics();
+        metrics_.memoryUsageMb = memory.residentBytes / (1024.0 * 1024.0);
+        metrics_.peakMemoryUsageMb = memory.peakResidentBytes / (1024.0 * 1024.0);
+        metrics_.lockedMemoryMb = memory.lockedBytes / (1024.0 * 1024.0);
     }
 
     bool ImagingService::setThreadPriority(std::thread &thread, bool isRealtime, int priority) {
@@ -632,7 +3092,7 @@ namespace medical::imaging {
         int result = pthread_setschedparam(nativeHandle, policy, &param);
 
         if (result != 0) {
-            std::cerr << "Failed to set thread priority: " << result << std::endl;
+            MIVI_LOG_ERROR("Failed to set thread priority: {}", result);
             return false;
         }
 
@@ -643,7 +3103,7 @@ namespace medical::imaging {
 
             // Set nice value
             if (setpriority(PRIO_PROCESS, 0, niceValue) != 0) {
-                std::cerr << "Failed to set nice value: " << errno << std::endl;
+                MIVI_LOG_ERROR("Failed to set nice value: {}", errno);
                 return false;
             }
         }
@@ -664,7 +3124,7 @@ namespace medical::imaging {
         int result = pthread_setaffinity_np(nativeHandle, sizeof(cpu_set_t), &cpuset);
 
         if (result != 0) {
-            std::cerr << "Failed to set thread affinity: " << result << std::endl;
+            MIVI_LOG_ERROR("Failed to set thread affinity: {}", result);
             return false;
         }
 
@@ -683,7 +3143,7 @@ namespace medical::imaging {
         // Check if service with this name already exists
         auto it = services_.find(serviceName);
         if (it != services_.end()) {
-            std::cerr << "Service with name '" << serviceName << "' already exists" << std::endl;
+            MIVI_LOG_WARNING("Service with name '{}' already exists", serviceName);
             return it->second;
         }
 
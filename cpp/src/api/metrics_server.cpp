@@ -0,0 +1,205 @@
+#include "api/metrics_server.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    // Longest request we are willing to read; a scrape is a few hundred bytes
+    constexpr size_t MAX_REQUEST_SIZE = 8192;
+
+    // How often the server thread checks for a stop request while idle
+    constexpr int POLL_INTERVAL_MS = 250;
+
+    namespace {
+        bool sendAll(int fd, const std::string &data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    return false;
+                }
+                sent += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        std::string makeResponse(const char *status, const char *contentType, const std::string &body) {
+            std::string response = "HTTP/1.1 ";
+            response += status;
+            response += "\r\nContent-Type: ";
+            response += contentType;
+            response += "\r\nContent-Length: " + std::to_string(body.size());
+            response += "\r\nConnection: close\r\n\r\n";
+            response += body;
+            return response;
+        }
+    } // namespace
+
+    MetricsServer::MetricsServer(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false),
+          scrapeCount_(0),
+          listenFd_(-1) {
+    }
+
+    MetricsServer::~MetricsServer() {
+        stop();
+    }
+
+    MetricsServer::Status MetricsServer::start(std::function<std::string()> render) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (!render) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(config_.port);
+        if (inet_pton(AF_INET, config_.bindAddress.c_str(), &address.sin_addr) != 1) {
+            MIVI_LOG_ERROR("Invalid metrics bind address: {}", config_.bindAddress);
+            return Status::INVALID_ARGUMENT;
+        }
+
+        listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) {
+            MIVI_LOG_ERROR("Failed to create metrics socket: {}", strerror(errno));
+            return Status::BIND_FAILED;
+        }
+
+        int reuse = 1;
+        setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        if (bind(listenFd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listenFd_, 8) != 0) {
+            MIVI_LOG_ERROR("Failed to listen on {}:{} for metrics: {}",
+                    config_.bindAddress, config_.port, strerror(errno));
+            close(listenFd_);
+            listenFd_ = -1;
+            return Status::BIND_FAILED;
+        }
+
+        render_ = std::move(render);
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&MetricsServer::serverThread, this);
+        return Status::OK;
+    }
+
+    MetricsServer::Status MetricsServer::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        close(listenFd_);
+        listenFd_ = -1;
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool MetricsServer::isRunning() const {
+        return isRunning_;
+    }
+
+    uint64_t MetricsServer::getScrapeCount() const {
+        return scrapeCount_.load(std::memory_order_relaxed);
+    }
+
+    void MetricsServer::serverThread() {
+        // Never compete with the capture threads, even if started from a realtime thread
+        if (!ThreadLayout::applyCurrentThread("metrics")) {
+            sched_param param{};
+            param.sched_priority = 0;
+            pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+        }
+
+        while (!stopRequested_) {
+            pollfd pfd{};
+            pfd.fd = listenFd_;
+            pfd.events = POLLIN;
+
+            int ready = poll(&pfd, 1, POLL_INTERVAL_MS);
+            if (ready <= 0 || !(pfd.revents & POLLIN)) {
+                continue;
+            }
+
+            int clientFd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (clientFd < 0) {
+                continue;
+            }
+
+            handleConnection(clientFd);
+            close(clientFd);
+        }
+    }
+
+    void MetricsServer::handleConnection(int clientFd) {
+        // Do not let a stalled client block the next scrape for long
+        timeval timeout{};
+        timeout.tv_sec = 1;
+        setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(clientFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        char buffer[1024];
+        while (request.size() < MAX_REQUEST_SIZE && request.find("\r\n\r\n") == std::string::npos) {
+            ssize_t n = recv(clientFd, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            request.append(buffer, static_cast<size_t>(n));
+        }
+
+        // Request line: METHOD SP PATH SP VERSION
+        size_t methodEnd = request.find(' ');
+        size_t pathEnd = methodEnd == std::string::npos ? std::string::npos : request.find(' ', methodEnd + 1);
+        if (pathEnd == std::string::npos) {
+            sendAll(clientFd, makeResponse("400 Bad Request", "text/plain", "Bad request\n"));
+            return;
+        }
+
+        std::string method = request.substr(0, methodEnd);
+        std::string path = request.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+        path = path.substr(0, path.find('?'));
+
+        if (method != "GET" && method != "HEAD") {
+            sendAll(clientFd, makeResponse("405 Method Not Allowed", "text/plain", "Method not allowed\n"));
+            return;
+        }
+        if (path != "/metrics") {
+            sendAll(clientFd, makeResponse("404 Not Found", "text/plain", "Try /metrics\n"));
+            return;
+        }
+
+        std::string body = render_();
+        std::string response = makeResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8", body);
+        if (method == "HEAD") {
+            response.resize(response.size() - body.size());
+        }
+        if (sendAll(clientFd, response)) {
+            scrapeCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+} // namespace medical::imaging
@@ -0,0 +1,321 @@
+#include "api/mivi_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "api/control_server.h"
+#include "communication/format_cache.h"
+#include "communication/shared_memory.h"
+#include "utils/frame_trace.h"
+
+using medical::imaging::ControlClient;
+using medical::imaging::ControlServer;
+using medical::imaging::FormatCache;
+using medical::imaging::FrameTrace;
+using medical::imaging::PixelFormat;
+using medical::imaging::ReaderMode;
+using medical::imaging::SharedMemory;
+using medical::imaging::SharedMemoryType;
+using medical::imaging::TracePoint;
+using medical::imaging::getPixelFormatInfo;
+using medical::imaging::pixelFormatFromCode;
+
+struct mivi_reader {
+    std::unique_ptr<SharedMemory> subscription; // Registration declaring the requested format on the source ring
+    std::unique_ptr<SharedMemory> shm;
+    std::vector<SharedMemory::FrameView> views; // Scratch space for batches, grown on demand
+};
+
+namespace {
+    mivi_status toStatus(SharedMemory::Status status) {
+        switch (status) {
+            case SharedMemory::Status::OK: return MIVI_OK;
+            case SharedMemory::Status::BUFFER_EMPTY: return MIVI_ERROR_EMPTY;
+            case SharedMemory::Status::TIMEOUT: return MIVI_ERROR_TIMEOUT;
+            case SharedMemory::Status::TOO_MANY_READERS: return MIVI_ERROR_TOO_MANY_READERS;
+            case SharedMemory::Status::INVALID_SIZE: return MIVI_ERROR_INVALID_ARGUMENT;
+            case SharedMemory::Status::NOT_INITIALIZED: return MIVI_ERROR_CONNECTION_FAILED;
+            default: return MIVI_ERROR_READ_FAILED;
+        }
+    }
+
+    // Failing to attach is a connection failure unless the ring says why
+    mivi_status toOpenStatus(SharedMemory::Status status) {
+        switch (status) {
+            case SharedMemory::Status::TOO_MANY_READERS: return MIVI_ERROR_TOO_MANY_READERS;
+            case SharedMemory::Status::VERSION_MISMATCH: return MIVI_ERROR_VERSION_MISMATCH;
+            default: return MIVI_ERROR_CONNECTION_FAILED;
+        }
+    }
+
+    void toView(const SharedMemory::FrameView &source, mivi_frame_view &view) {
+        view.struct_size = sizeof(view);
+        view.data = source.data;
+        view.data_size = source.dataSize;
+        view.width = source.width;
+        view.height = source.height;
+        view.bytes_per_pixel = source.bytesPerPixel;
+
+        // The producer records the pitch; packed formats round rows up to whole blocks, fall back to
+        // tight rows for unknown ones
+        size_t rowBytes = source.rowPitch > 0 ? source.rowPitch
+                                              : getPixelFormatInfo(source.format).rowBytes(source.width);
+        view.row_stride = static_cast<uint32_t>(rowBytes > 0 ? rowBytes
+                                                             : static_cast<size_t>(source.width) * source.bytesPerPixel);
+        view.format_code = static_cast<uint32_t>(source.format);
+        view.flags = source.flags;
+        view.frame_id = source.frameId;
+        view.sequence_number = source.sequenceNumber;
+        view.timestamp_ns = source.timestampNs;
+        view.capture_time_ns = source.captureTimeNs;
+        view.metadata = source.metadata;
+        view.guard = source.generation;
+        view.expected_generation = source.expectedGeneration;
+    }
+} // namespace
+
+extern "C" {
+    uint32_t mivi_abi_version(void) {
+        return MIVI_ABI_VERSION;
+    }
+
+    const char *mivi_status_string(mivi_status status) {
+        switch (status) {
+            case MIVI_OK: return "ok";
+            case MIVI_ERROR_INVALID_ARGUMENT: return "invalid argument";
+            case MIVI_ERROR_CONNECTION_FAILED: return "connection failed";
+            case MIVI_ERROR_TOO_MANY_READERS: return "too many readers";
+            case MIVI_ERROR_EMPTY: return "no frame available";
+            case MIVI_ERROR_TIMEOUT: return "timed out";
+            case MIVI_ERROR_TORN: return "frame overwritten while reading";
+            case MIVI_ERROR_READ_FAILED: return "read failed";
+            case MIVI_ERROR_VERSION_MISMATCH: return "ring created by an incompatible protocol version";
+        }
+        return "unknown status";
+    }
+
+    void mivi_reader_config_init(mivi_reader_config *config) {
+        if (!config) {
+            return;
+        }
+        std::memset(config, 0, sizeof(*config));
+        config->struct_size = sizeof(*config);
+        config->name = "ultrasound_frames";
+        config->file_path = nullptr;
+        config->shm_type = MIVI_SHM_MAPPED_FILE;
+        config->lossy = 1;
+        config->parse_metadata = 1;
+    }
+
+    mivi_status mivi_reader_open(const mivi_reader_config *config, mivi_reader **reader) {
+        // Callers built against an older header pass a shorter structure
+        if (!config || !reader || config->struct_size < offsetof(mivi_reader_config, format_code) || !config->name ||
+            config->shm_type > MIVI_SHM_HUGE_PAGES) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+        *reader = nullptr;
+
+        uint32_t formatCode = config->struct_size >= offsetof(mivi_reader_config, frame_stride) ? config->format_code : 0;
+        PixelFormat format = formatCode ? pixelFormatFromCode(formatCode) : PixelFormat::UNKNOWN;
+        if (formatCode && format == PixelFormat::UNKNOWN) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+
+        SharedMemory::Config shmConfig;
+        shmConfig.name = config->name;
+        shmConfig.filePath = config->file_path ? std::string(config->file_path) : "/dev/shm/" + shmConfig.name;
+        shmConfig.type = static_cast<SharedMemoryType>(config->shm_type);
+        shmConfig.create = false;
+        shmConfig.readerMode = config->lossy ? ReaderMode::LOSSY : ReaderMode::LOSSLESS;
+        if (config->struct_size >= sizeof(mivi_reader_config)) {
+            // The writer wakes us only for the frames the filter passes
+            shmConfig.readerFilter.stride = config->frame_stride;
+            shmConfig.readerFilter.maxRateHz = config->max_rate_hz;
+            shmConfig.readerFilter.requiredFlags = config->required_flags;
+            shmConfig.readerFilter.excludedFlags = config->excluded_flags;
+        }
+        shmConfig.enableMetadata = config->parse_metadata != 0;
+        shmConfig.lockInMemory = false;
+
+        auto *handle = new(std::nothrow) mivi_reader();
+        if (!handle) {
+            return MIVI_ERROR_READ_FAILED;
+        }
+
+        SharedMemory::Status status = SharedMemory::Status::OK;
+        if (format != PixelFormat::UNKNOWN) {
+            // A lossy registration that never reads: it only tells the service which format we want
+            SharedMemory::Config subscriptionConfig = shmConfig;
+            subscriptionConfig.readerMode = ReaderMode::LOSSY;
+            subscriptionConfig.requestedFormat = format;
+            handle->subscription = std::make_unique<SharedMemory>(subscriptionConfig);
+            status = handle->subscription->initialize();
+            if (status != SharedMemory::Status::OK) {
+                delete handle;
+                return toOpenStatus(status);
+            }
+
+            shmConfig.name = FormatCache::getRingName(shmConfig.name, format);
+            shmConfig.filePath = "/dev/shm/" + shmConfig.name;
+        }
+
+        // The ring of a requested format appears once the service has seen the registration
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(MIVI_FORMAT_WAIT_MS);
+        do {
+            // Checking for the file first keeps the failed attempts quiet
+            bool mappable = shmConfig.type != SharedMemoryType::MEMORY_MAPPED_FILE ||
+                            access(shmConfig.filePath.c_str(), F_OK) == 0;
+            if (handle->subscription && !mappable) {
+                status = SharedMemory::Status::NOT_INITIALIZED;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+            handle->shm = std::make_unique<SharedMemory>(shmConfig);
+            status = handle->shm->initialize();
+            if (status == SharedMemory::Status::OK || !handle->subscription) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } while (std::chrono::steady_clock::now() < deadline);
+        if (status != SharedMemory::Status::OK) {
+            delete handle;
+            return toOpenStatus(status);
+        }
+
+        *reader = handle;
+        return MIVI_OK;
+    }
+
+    void mivi_reader_close(mivi_reader *reader) {
+        delete reader;
+    }
+
+    mivi_status mivi_reader_wait(mivi_reader *reader, uint32_t timeout_ms) {
+        if (!reader) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+        return toStatus(reader->shm->waitForFrame(timeout_ms));
+    }
+
+    mivi_status mivi_reader_get_fd(mivi_reader *reader, const char *control_socket, int *fd) {
+        if (!reader || !fd) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+
+        if (reader->shm->getNotificationDescriptor() < 0) {
+            // The connection is only needed to receive the descriptor
+            ControlClient client;
+            if (!client.connect(control_socket ? control_socket : ControlServer::Config().socketPath) ||
+                !client.subscribe(reader->shm->getName(), *reader->shm)) {
+                return MIVI_ERROR_CONNECTION_FAILED;
+            }
+        }
+        *fd = reader->shm->getNotificationDescriptor();
+        return MIVI_OK;
+    }
+
+    mivi_status mivi_reader_arm(mivi_reader *reader) {
+        if (!reader) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+        return reader->shm->armNotification() ? MIVI_OK : MIVI_ERROR_EMPTY;
+    }
+
+    mivi_status mivi_reader_acquire_next(mivi_reader *reader, uint32_t timeout_ms, mivi_frame_view *view) {
+        size_t count = 0;
+        return mivi_reader_acquire_batch(reader, timeout_ms, view, 1, &count);
+    }
+
+    mivi_status mivi_reader_acquire_batch(mivi_reader *reader, uint32_t timeout_ms,
+                                          mivi_frame_view *views, size_t max_count, size_t *count) {
+        if (!reader || !views || !count || max_count == 0 || views->struct_size < sizeof(mivi_frame_view)) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+        *count = 0;
+
+        // Callers built against a later header pass larger views; step by their size, not ours
+        const size_t viewStride = views->struct_size;
+
+        // No ring holds more frames than its header table, so the scratch space stops growing early
+        if (reader->views.size() < max_count) {
+            reader->views.resize(std::min(max_count, reader->shm->getMaxFrames()));
+        }
+
+        size_t mapped = 0;
+        SharedMemory::Status status = reader->shm->readFrameViews(
+            reader->views.data(), std::min(max_count, reader->views.size()), mapped, timeout_ms);
+        if (status != SharedMemory::Status::OK) {
+            return toStatus(status);
+        }
+
+        const auto traceSlot = static_cast<uint32_t>(reader->shm->getReaderSlot());
+        for (size_t i = 0; i < mapped; ++i) {
+            auto &view = *reinterpret_cast<mivi_frame_view *>(reinterpret_cast<char *>(views) + i * viewStride);
+            toView(reader->views[i], view);
+            FrameTrace::record(TracePoint::CONSUMER_ACQUIRE, view.frame_id, traceSlot);
+        }
+        *count = mapped;
+        return MIVI_OK;
+    }
+
+    mivi_status mivi_reader_release(mivi_reader *reader, const mivi_frame_view *view) {
+        if (!reader || !view || view->struct_size < sizeof(mivi_frame_view) || !view->guard) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+
+        FrameTrace::record(TracePoint::CONSUMER_RELEASE, view->frame_id,
+                           static_cast<uint32_t>(reader->shm->getReaderSlot()));
+
+        // The slot must still hold this frame; the hold time goes to the writer's latency statistics
+        SharedMemory::FrameView released{};
+        released.generation = static_cast<const std::atomic<uint64_t> *>(view->guard);
+        released.expectedGeneration = view->expected_generation;
+        return reader->shm->releaseFrameView(released) ? MIVI_OK : MIVI_ERROR_TORN;
+    }
+
+    mivi_status mivi_reader_get_stats(mivi_reader *reader, mivi_reader_stats *stats) {
+        if (!reader || !stats || stats->struct_size < sizeof(mivi_reader_stats)) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+
+        mivi_reader_stats result{};
+        result.struct_size = sizeof(result);
+        result.reader_slot = reader->shm->getReaderSlot();
+
+        // Our own registration slot holds the per-reader counters
+        SharedMemory::ReaderInfo info{};
+        if (reader->shm->getOwnReader(info)) {
+            result.frames_read = info.framesRead;
+            result.frames_skipped = info.framesSkipped;
+            result.lag_frames = info.lag;
+        }
+
+        SharedMemory::Statistics shmStats = reader->shm->getStatistics();
+        result.total_frames_written = shmStats.totalFramesWritten;
+        result.dropped_frames = shmStats.droppedFrames;
+
+        std::memcpy(stats, &result, sizeof(result));
+        return MIVI_OK;
+    }
+
+    void mivi_trace_enable(uint32_t enabled) {
+        FrameTrace::setEnabled(enabled != 0);
+    }
+
+    mivi_status mivi_trace_dump(const char *path, uint32_t window_ms) {
+        if (!path || !FrameTrace::isEnabled()) {
+            return MIVI_ERROR_INVALID_ARGUMENT;
+        }
+        return FrameTrace::writeChromeTrace(path, std::chrono::milliseconds(window_ms)) ? MIVI_OK
+                                                                                         : MIVI_ERROR_READ_FAILED;
+    }
+}
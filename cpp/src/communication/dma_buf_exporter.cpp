@@ -0,0 +1,547 @@
+#include "communication/dma_buf_exporter.h"
+#include "communication/ring_stage.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/dma-buf.h>
+#include <linux/udmabuf.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    namespace {
+        // How long the exporter sleeps waiting for the next frame before serving new clients;
+        // stop() interrupts the wait
+        constexpr unsigned int FRAME_WAIT_MS = 100;
+
+        // Most descriptors one SCM_RIGHTS message may carry (SCM_MAX_FD)
+        constexpr size_t MAX_PASSED_FDS = 253;
+
+        constexpr uint32_t fourccCode(char a, char b, char c, char d) {
+            return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 |
+                   static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+        }
+
+        size_t alignUp(size_t value, size_t alignment) {
+            return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+        }
+
+        bool syncDmaBuf(int fd, uint64_t flags) {
+            if (fd < 0) {
+                return true;
+            }
+            dma_buf_sync sync{};
+            sync.flags = flags;
+            while (ioctl(fd, DMA_BUF_IOCTL_SYNC, &sync) != 0) {
+                if (errno != EINTR && errno != EAGAIN) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool fillSocketAddress(const std::string &path, sockaddr_un &address) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size());
+            return true;
+        }
+    } // namespace
+
+    DmaBufExporter::DmaBufExporter(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false),
+          memfd_(-1),
+          mapping_(nullptr),
+          slotSize_(0),
+          listenFd_(-1),
+          framesExported_(0),
+          bytesExported_(0),
+          framesTorn_(0),
+          framesDropped_(0),
+          clientsServed_(0),
+          dmaBufExported_(false) {
+    }
+
+    DmaBufExporter::~DmaBufExporter() {
+        stop();
+    }
+
+    uint32_t DmaBufExporter::toDrmFourcc(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::YUV422_8: return fourccCode('U', 'Y', 'V', 'Y'); // DRM_FORMAT_UYVY
+            case PixelFormat::BGRA_8: return fourccCode('A', 'R', '2', '4');   // DRM_FORMAT_ARGB8888, B G R A in memory
+            case PixelFormat::GRAY_8: return fourccCode('R', '8', ' ', ' ');   // DRM_FORMAT_R8
+            case PixelFormat::RGB_8: return fourccCode('B', 'G', '2', '4');    // DRM_FORMAT_BGR888, R G B in memory
+            default: return 0;
+        }
+    }
+
+    DmaBufExporter::Status DmaBufExporter::start(const SharedMemory::Config &sourceConfig,
+                                                 const std::shared_ptr<SharedMemory> &output) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        sockaddr_un address{};
+        if (!output || !output->isInitialized() || config_.slotCount < 2 || config_.maxFrameSize == 0 ||
+            config_.slotCount + 1 > MAX_PASSED_FDS || !fillSocketAddress(config_.socketPath, address)) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        // Page-aligned slots, the granularity udmabuf exports and GPUs import at
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        slotSize_ = alignUp(config_.maxFrameSize + sizeof(DmaBufSlotStamp), pageSize);
+        size_t regionSize = slotSize_ * config_.slotCount;
+
+        memfd_ = memfd_create("mivi-dmabuf", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (memfd_ < 0 || ftruncate(memfd_, static_cast<off_t>(regionSize)) != 0) {
+            MIVI_LOG_ERROR("Failed to create the dma-buf memfd: {}", strerror(errno));
+            closeSlots();
+            return Status::CREATION_FAILED;
+        }
+
+        // udmabuf requires the size to be sealed; consumers can then map it without fearing SIGBUS
+        if (fcntl(memfd_, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+            MIVI_LOG_ERROR("Failed to seal the dma-buf memfd: {}", strerror(errno));
+            closeSlots();
+            return Status::CREATION_FAILED;
+        }
+
+        void *mapping = mmap(nullptr, regionSize, PROT_READ | PROT_WRITE, MAP_SHARED, memfd_, 0);
+        if (mapping == MAP_FAILED) {
+            MIVI_LOG_ERROR("Failed to map the dma-buf memfd: {}", strerror(errno));
+            closeSlots();
+            return Status::CREATION_FAILED;
+        }
+        mapping_ = static_cast<uint8_t *>(mapping);
+
+        // One dma-buf per slot; without udmabuf CPU consumers still get the memfd
+        int udmabuf = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+        if (udmabuf >= 0) {
+            for (uint32_t i = 0; i < config_.slotCount; ++i) {
+                udmabuf_create create{};
+                create.memfd = static_cast<uint32_t>(memfd_);
+                create.flags = UDMABUF_FLAGS_CLOEXEC;
+                create.offset = static_cast<uint64_t>(i) * slotSize_;
+                create.size = slotSize_;
+                int fd = ioctl(udmabuf, UDMABUF_CREATE, &create);
+                if (fd < 0) {
+                    MIVI_LOG_ERROR("Failed to export dma-buf slot {}: {}", i, strerror(errno));
+                    for (int slotFd: slotFds_) {
+                        close(slotFd);
+                    }
+                    slotFds_.clear();
+                    break;
+                }
+                slotFds_.push_back(fd);
+            }
+            close(udmabuf);
+        } else {
+            MIVI_LOG_WARNING("/dev/udmabuf unavailable ({}), exporting frames as a memfd only", strerror(errno));
+        }
+        dmaBufExported_ = !slotFds_.empty();
+
+        // Non-blocking, so the exporter thread can poll it between frames
+        listenFd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        unlink(config_.socketPath.c_str());
+        if (listenFd_ < 0 ||
+            bind(listenFd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 ||
+            listen(listenFd_, 16) != 0) {
+            MIVI_LOG_ERROR("Failed to listen on {}: {}", config_.socketPath, strerror(errno));
+            closeSlots();
+            return Status::CREATION_FAILED;
+        }
+
+        // Attach as a lossy reader: the export must never hold back capture
+        SharedMemory::Config readerConfig = sourceConfig;
+        readerConfig.create = false;
+        readerConfig.readerMode = ReaderMode::LOSSY;
+        readerConfig.lockInMemory = false;
+        auto source = std::make_shared<SharedMemory>(readerConfig);
+        if (source->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Dma-buf exporter failed to attach to shared memory {}", sourceConfig.name);
+            closeSlots();
+            return Status::CONNECTION_FAILED;
+        }
+
+        source_ = std::move(source);
+        output_ = output;
+        framesExported_ = 0;
+        bytesExported_ = 0;
+        framesTorn_ = 0;
+        framesDropped_ = 0;
+        clientsServed_ = 0;
+        copyTimeHistogram_.reset();
+
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&DmaBufExporter::exporterThread, this);
+        return Status::OK;
+    }
+
+    DmaBufExporter::Status DmaBufExporter::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        source_->interruptWaits();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        closeSlots();
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    void DmaBufExporter::closeSlots() {
+        if (listenFd_ >= 0) {
+            close(listenFd_);
+            listenFd_ = -1;
+            unlink(config_.socketPath.c_str());
+        }
+        for (int fd: slotFds_) {
+            close(fd);
+        }
+        slotFds_.clear();
+        if (mapping_) {
+            munmap(mapping_, slotSize_ * config_.slotCount);
+            mapping_ = nullptr;
+        }
+        if (memfd_ >= 0) {
+            close(memfd_);
+            memfd_ = -1;
+        }
+        dmaBufExported_ = false;
+    }
+
+    bool DmaBufExporter::isRunning() const {
+        return isRunning_;
+    }
+
+    const DmaBufExporter::Config &DmaBufExporter::getConfig() const {
+        return config_;
+    }
+
+    DmaBufExporter::Statistics DmaBufExporter::getStatistics() const {
+        Statistics stats{};
+        stats.framesExported = framesExported_.load(std::memory_order_relaxed);
+        stats.bytesExported = bytesExported_.load(std::memory_order_relaxed);
+        stats.framesTorn = framesTorn_.load(std::memory_order_relaxed);
+        stats.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+        stats.clientsServed = clientsServed_.load(std::memory_order_relaxed);
+        stats.dmaBufExported = dmaBufExported_.load(std::memory_order_relaxed);
+
+        // Our own reader slot tells how far behind the writer we are
+        SharedMemory::ReaderInfo reader{};
+        if (source_ && source_->getOwnReader(reader)) {
+            stats.lagFrames = reader.lag;
+            stats.framesSkipped = reader.framesSkipped;
+        }
+        return stats;
+    }
+
+    std::map<std::string, std::string> DmaBufExporter::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["dmabuf_socket"] = config_.socketPath;
+        map["dmabuf_slot_count"] = std::to_string(config_.slotCount);
+        map["dmabuf_exported"] = stats.dmaBufExported ? "true" : "false";
+        map["dmabuf_frames_exported"] = std::to_string(stats.framesExported);
+        map["dmabuf_bytes_exported"] = std::to_string(stats.bytesExported);
+        map["dmabuf_frames_torn"] = std::to_string(stats.framesTorn);
+        map["dmabuf_frames_dropped"] = std::to_string(stats.framesDropped);
+        map["dmabuf_frames_skipped"] = std::to_string(stats.framesSkipped);
+        map["dmabuf_lag_frames"] = std::to_string(stats.lagFrames);
+        map["dmabuf_clients_served"] = std::to_string(stats.clientsServed);
+        appendHistogramStatistics(map, "dmabuf_copy_time", copyTimeHistogram_.snapshot());
+        return map;
+    }
+
+    const LatencyHistogram &DmaBufExporter::getCopyTimeHistogram() const {
+        return copyTimeHistogram_;
+    }
+
+    void DmaBufExporter::serveClients() {
+        DmaBufExportInfo info{};
+        std::memcpy(info.magic, "MVX1", sizeof(info.magic));
+        info.version = 2;
+        info.headerSize = sizeof(DmaBufExportInfo);
+        info.slotCount = config_.slotCount;
+        info.flags = slotFds_.empty() ? 0 : DMA_BUF_EXPORT_FLAG_DMA_BUF;
+        info.slotSize = slotSize_;
+        info.regionSize = slotSize_ * config_.slotCount;
+
+        std::vector<int> fds;
+        fds.push_back(memfd_);
+        fds.insert(fds.end(), slotFds_.begin(), slotFds_.end());
+
+        // Every consumer gets the same descriptors in one message, then the connection is closed
+        while (true) {
+            int client = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) {
+                return;
+            }
+
+            iovec iov{&info, sizeof(info)};
+            std::vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+            msghdr message{};
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            message.msg_control = control.data();
+            message.msg_controllen = control.size();
+            cmsghdr *header = CMSG_FIRSTHDR(&message);
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+            std::memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+
+            if (sendmsg(client, &message, MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(info))) {
+                clientsServed_.fetch_add(1, std::memory_order_relaxed);
+            }
+            close(client);
+        }
+    }
+
+    void DmaBufExporter::exporterThread() {
+        if (!ThreadLayout::applyCurrentThread(config_.threadRole) && config_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        DmaBufFrameDescriptor descriptor{};
+        std::memcpy(descriptor.magic, "MVD1", sizeof(descriptor.magic));
+        descriptor.version = 1;
+        descriptor.headerSize = sizeof(DmaBufFrameDescriptor);
+        descriptor.slotCount = config_.slotCount;
+        descriptor.ownerPid = static_cast<uint32_t>(getpid());
+        uint64_t exportSequence = 0;
+        const size_t capacity = slotSize_ - sizeof(DmaBufSlotStamp);
+
+        // Consumers are served between frames too, so they can connect while the source is idle
+        auto serve = [this] { serveClients(); };
+        runRingStage(*source_, stopRequested_, FRAME_WAIT_MS, framesTorn_, serve,
+                     [&](const Frame &frame, auto &intact) {
+            // Rows are padded to the pitch alignment when the slot has room for it
+            size_t size = frame.getDataSize();
+            size_t rows = frame.getHeight() > 0 && size % static_cast<size_t>(frame.getHeight()) == 0
+                              ? static_cast<size_t>(frame.getHeight())
+                              : 1;
+            size_t rowBytes = size / rows;
+            size_t pitch = alignUp(rowBytes, config_.pitchAlignment);
+            if (pitch * rows > capacity) {
+                pitch = rowBytes;
+            }
+            if (pitch * rows > capacity) {
+                framesDropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            uint32_t slot = static_cast<uint32_t>(exportSequence % config_.slotCount);
+            uint8_t *destination = mapping_ + static_cast<size_t>(slot) * slotSize_;
+            int slotFd = slotFds_.empty() ? -1 : slotFds_[slot];
+            auto *stamp = reinterpret_cast<DmaBufSlotStamp *>(destination + capacity);
+            syncDmaBuf(slotFd, DMA_BUF_SYNC_START | DMA_BUF_SYNC_WRITE);
+
+            // Whoever still reads the export that held the slot sees it change from here on
+            stamp->generation.store(2 * exportSequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            const auto *source = static_cast<const uint8_t *>(frame.getData());
+            if (pitch == rowBytes) {
+                std::memcpy(destination, source, size);
+            } else {
+                for (size_t row = 0; row < rows; ++row) {
+                    std::memcpy(destination + row * pitch, source + row * rowBytes, rowBytes);
+                }
+            }
+            stamp->generation.store(2 * exportSequence + 2, std::memory_order_release);
+            syncDmaBuf(slotFd, DMA_BUF_SYNC_END | DMA_BUF_SYNC_WRITE);
+            copyTimeHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+
+            // The writer may have lapped us while we were reading the slot
+            if (!intact()) {
+                return;
+            }
+
+            descriptor.slotIndex = slot;
+            descriptor.fourcc = toDrmFourcc(frame.getPixelFormat());
+            descriptor.width = static_cast<uint32_t>(frame.getWidth());
+            descriptor.height = static_cast<uint32_t>(frame.getHeight());
+            descriptor.pitch = static_cast<uint32_t>(pitch);
+            descriptor.offset = static_cast<uint64_t>(slot) * slotSize_;
+            descriptor.dataSize = pitch * rows;
+            descriptor.exportSequence = exportSequence;
+            descriptor.frameId = frame.getFrameId();
+
+            if (publishDerivedFrame(*output_, frame, &descriptor, sizeof(descriptor))) {
+                // Only published exports take a slot out of rotation
+                ++exportSequence;
+                framesExported_.fetch_add(1, std::memory_order_relaxed);
+                bytesExported_.fetch_add(size, std::memory_order_relaxed);
+            } else {
+                framesDropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    DmaBufClient::DmaBufClient()
+        : info_{},
+          memfd_(-1),
+          mapping_(nullptr) {
+    }
+
+    DmaBufClient::~DmaBufClient() {
+        disconnect();
+    }
+
+    bool DmaBufClient::connect(const std::string &socketPath) {
+        disconnect();
+
+        sockaddr_un address{};
+        if (!fillSocketAddress(socketPath, address)) {
+            return false;
+        }
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return false;
+        }
+        if (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            MIVI_LOG_ERROR("Failed to connect to {}: {}", socketPath, strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        DmaBufExportInfo info{};
+        iovec iov{&info, sizeof(info)};
+        std::vector<char> control(CMSG_SPACE(sizeof(int) * MAX_PASSED_FDS));
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control.data();
+        message.msg_controllen = control.size();
+        ssize_t received;
+        do {
+            received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+        } while (received < 0 && errno == EINTR);
+        close(fd);
+
+        std::vector<int> fds;
+        for (cmsghdr *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                size_t first = fds.size();
+                fds.resize(first + count);
+                std::memcpy(fds.data() + first, CMSG_DATA(header), sizeof(int) * count);
+            }
+        }
+
+        bool valid = received == static_cast<ssize_t>(sizeof(info)) &&
+                     std::memcmp(info.magic, "MVX1", sizeof(info.magic)) == 0 && info.version == 2 &&
+                     !fds.empty() && info.slotSize > sizeof(DmaBufSlotStamp) &&
+                     info.regionSize == info.slotSize * info.slotCount &&
+                     (!(info.flags & DMA_BUF_EXPORT_FLAG_DMA_BUF) || fds.size() == info.slotCount + 1);
+        void *mapping = valid ? mmap(nullptr, info.regionSize, PROT_READ, MAP_SHARED, fds[0], 0) : MAP_FAILED;
+        if (mapping == MAP_FAILED) {
+            MIVI_LOG_ERROR("Invalid dma-buf export from {}", socketPath);
+            for (int passed: fds) {
+                close(passed);
+            }
+            return false;
+        }
+
+        info_ = info;
+        memfd_ = fds[0];
+        slotFds_.assign(fds.begin() + 1, fds.end());
+        mapping_ = static_cast<const uint8_t *>(mapping);
+        return true;
+    }
+
+    void DmaBufClient::disconnect() {
+        if (mapping_) {
+            munmap(const_cast<uint8_t *>(mapping_), info_.regionSize);
+            mapping_ = nullptr;
+        }
+        for (int fd: slotFds_) {
+            close(fd);
+        }
+        slotFds_.clear();
+        if (memfd_ >= 0) {
+            close(memfd_);
+            memfd_ = -1;
+        }
+        info_ = {};
+    }
+
+    bool DmaBufClient::isConnected() const {
+        return mapping_ != nullptr;
+    }
+
+    const DmaBufExportInfo &DmaBufClient::getInfo() const {
+        return info_;
+    }
+
+    int DmaBufClient::getSlotFd(uint32_t slot) const {
+        return slot < slotFds_.size() ? slotFds_[slot] : -1;
+    }
+
+    int DmaBufClient::getMemfd() const {
+        return memfd_;
+    }
+
+    std::shared_ptr<Frame> DmaBufClient::wrapFrame(const Frame &descriptorFrame) const {
+        if (!mapping_ || descriptorFrame.getDataSize() < sizeof(DmaBufFrameDescriptor)) {
+            return nullptr;
+        }
+        DmaBufFrameDescriptor descriptor{};
+        std::memcpy(&descriptor, descriptorFrame.getData(), sizeof(descriptor));
+        if (std::memcmp(descriptor.magic, "MVD1", sizeof(descriptor.magic)) != 0 ||
+            descriptor.slotIndex >= info_.slotCount || descriptor.dataSize == 0 ||
+            descriptor.offset != static_cast<uint64_t>(descriptor.slotIndex) * info_.slotSize ||
+            descriptor.dataSize > info_.slotSize - sizeof(DmaBufSlotStamp)) {
+            return nullptr;
+        }
+
+        // The slot must still hold this export; frame->validate() re-checks it after the caller read it
+        const auto *stamp = reinterpret_cast<const DmaBufSlotStamp *>(
+            mapping_ + descriptor.offset + info_.slotSize - sizeof(DmaBufSlotStamp));
+        uint64_t expected = 2 * descriptor.exportSequence + 2;
+        if (stamp->generation.load(std::memory_order_acquire) != expected) {
+            return nullptr;
+        }
+
+        auto frame = Frame::createWithExternalData(
+            const_cast<uint8_t *>(mapping_ + descriptor.offset), descriptor.dataSize, descriptorFrame.getWidth(),
+            descriptorFrame.getHeight(), descriptorFrame.getBytesPerPixel(), descriptorFrame.getPixelFormat(), false,
+            BufferType::DMA_BUFFER);
+        if (!frame) {
+            return nullptr;
+        }
+        frame->setDmaBufFd(getSlotFd(descriptor.slotIndex));
+        frame->setValidityGuard(&stamp->generation, expected);
+        frame->setFrameId(descriptorFrame.getFrameId());
+        frame->setTimestamp(descriptorFrame.getTimestamp());
+        frame->setCaptureTime(descriptorFrame.getCaptureTime());
+        frame->getMetadataMutable() = descriptorFrame.getMetadata();
+        frame->setMetadata("pitch", std::to_string(descriptor.pitch));
+        return frame;
+    }
+} // namespace medical::imaging
@@ -0,0 +1,329 @@
+#include "communication/format_cache.h"
+#include "communication/ring_stage.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <algorithm>
+#include <cctype>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    // How long a worker sleeps waiting for the next frame; stopping it interrupts the wait
+    constexpr unsigned int FRAME_WAIT_MS = 1000;
+
+    FormatCache::FormatCache(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false) {
+    }
+
+    FormatCache::~FormatCache() {
+        stop();
+    }
+
+    FormatCache::Status FormatCache::start(const SharedMemory::Config &sourceConfig,
+                                           const std::shared_ptr<SharedMemory> &source) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (!source || !source->isInitialized() || config_.scanIntervalMs == 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        // Workers attach as lossy readers: a format nobody keeps up with must never hold back capture
+        sourceConfig_ = sourceConfig;
+        sourceConfig_.create = false;
+        sourceConfig_.readerMode = ReaderMode::LOSSY;
+        sourceConfig_.requestedFormat = PixelFormat::UNKNOWN;
+        sourceConfig_.lockInMemory = false;
+        source_ = source;
+        rejectedFormats_.clear();
+        conversionTimeHistogram_.reset();
+
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&FormatCache::scanThread, this);
+        return Status::OK;
+    }
+
+    FormatCache::Status FormatCache::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(scanMutex_);
+            stopRequested_ = true;
+        }
+        scanCondition_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        {
+            std::lock_guard<std::mutex> lock(workersMutex_);
+            workers.swap(workers_);
+        }
+        for (auto &worker: workers) {
+            stopWorker(*worker);
+        }
+
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool FormatCache::isRunning() const {
+        return isRunning_;
+    }
+
+    size_t FormatCache::getFormatCount() const {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        return workers_.size();
+    }
+
+    bool FormatCache::hasSubscribers() const {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        return std::any_of(workers_.begin(), workers_.end(), [](const std::unique_ptr<Worker> &worker) {
+            return worker->output->getReaderCount() > 0;
+        });
+    }
+
+    std::vector<FormatCache::FormatStatistics> FormatCache::getStatistics() const {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        std::vector<FormatStatistics> statistics;
+        for (const auto &worker: workers_) {
+            FormatStatistics stats{};
+            stats.format = worker->converter.getOutputFormat();
+            stats.ringName = worker->ringName;
+            stats.subscribers = worker->subscribers.load(std::memory_order_relaxed);
+            stats.framesConverted = worker->framesConverted.load(std::memory_order_relaxed);
+            stats.framesTorn = worker->framesTorn.load(std::memory_order_relaxed);
+            stats.framesDropped = worker->framesDropped.load(std::memory_order_relaxed);
+
+            // The worker's own reader slot tells how far behind the writer it is
+            SharedMemory::ReaderInfo reader{};
+            if (worker->source->getOwnReader(reader)) {
+                stats.lagFrames = reader.lag;
+                stats.framesSkipped = reader.framesSkipped;
+            }
+            statistics.push_back(std::move(stats));
+        }
+        return statistics;
+    }
+
+    std::map<std::string, std::string> FormatCache::getStatisticsMap() const {
+        std::map<std::string, std::string> map;
+        std::string formats;
+        for (const auto &stats: getStatistics()) {
+            std::string prefix = "format_" + stats.ringName.substr(stats.ringName.rfind('_') + 1) + "_";
+            map[prefix + "ring"] = stats.ringName;
+            map[prefix + "subscribers"] = std::to_string(stats.subscribers);
+            map[prefix + "frames_converted"] = std::to_string(stats.framesConverted);
+            map[prefix + "frames_torn"] = std::to_string(stats.framesTorn);
+            map[prefix + "frames_dropped"] = std::to_string(stats.framesDropped);
+            map[prefix + "frames_skipped"] = std::to_string(stats.framesSkipped);
+            map[prefix + "lag_frames"] = std::to_string(stats.lagFrames);
+            formats += (formats.empty() ? "" : ",") + std::string(toString(stats.format));
+        }
+        map["format_cache_formats"] = formats;
+        appendHistogramStatistics(map, "format_cache_time", conversionTimeHistogram_.snapshot());
+        return map;
+    }
+
+    const LatencyHistogram &FormatCache::getConversionTimeHistogram() const {
+        return conversionTimeHistogram_;
+    }
+
+    std::shared_ptr<SharedMemory> FormatCache::findRing(const std::string &ringName) const {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        for (const auto &worker: workers_) {
+            if (worker->ringName == ringName) {
+                return worker->output;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string FormatCache::getRingName(const std::string &sourceName, PixelFormat format) {
+        std::string suffix = toString(format);
+        std::transform(suffix.begin(), suffix.end(), suffix.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return sourceName + "_" + suffix;
+    }
+
+    void FormatCache::placeCurrentThread() const {
+        if (!ThreadLayout::applyCurrentThread(config_.threadRole) && config_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+    }
+
+    void FormatCache::scanThread() {
+        placeCurrentThread();
+
+        while (!stopRequested_) {
+            scanReaders();
+
+            // stop() wakes the thread, so it sleeps a whole scan interval at a time
+            std::unique_lock<std::mutex> lock(scanMutex_);
+            scanCondition_.wait_for(lock, std::chrono::milliseconds(config_.scanIntervalMs),
+                                    [this] { return stopRequested_.load(); });
+        }
+    }
+
+    void FormatCache::scanReaders() {
+        // Count the consumers asking for each format
+        std::map<uint32_t, uint32_t> requests;
+        for (const auto &reader: source_->getReaders()) {
+            if (reader.requestedFormat != PixelFormat::UNKNOWN) {
+                ++requests[static_cast<uint32_t>(reader.requestedFormat)];
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<Worker>> retired;
+        std::lock_guard<std::mutex> lock(workersMutex_);
+
+        // Readers of a format ring keep it alive too, once they no longer need their source registration
+        for (auto it = workers_.begin(); it != workers_.end();) {
+            Worker &worker = **it;
+            auto format = static_cast<uint32_t>(worker.converter.getOutputFormat());
+            uint32_t subscribers = requests[format] + static_cast<uint32_t>(worker.output->getReaders().size());
+            requests.erase(format);
+
+            worker.subscribers.store(subscribers, std::memory_order_relaxed);
+            if (subscribers > 0) {
+                worker.lastSubscribed = now;
+            } else if (now - worker.lastSubscribed >= std::chrono::milliseconds(config_.idleTimeoutMs)) {
+                retired.push_back(std::move(*it));
+                it = workers_.erase(it);
+                continue;
+            }
+            ++it;
+        }
+
+        // Formats requested for the first time
+        for (const auto &[format, count]: requests) {
+            PixelFormat outputFormat = static_cast<PixelFormat>(format);
+            if (FrameConverter::getInputFormat(outputFormat) == PixelFormat::UNKNOWN) {
+                if (rejectedFormats_.insert(format).second) {
+                    MIVI_LOG_WARNING("Ignoring request for unsupported format {} on '{}'",
+                            toString(outputFormat), sourceConfig_.name);
+                }
+                continue;
+            }
+
+            auto worker = startWorker(outputFormat);
+            if (!worker) {
+                rejectedFormats_.insert(format);
+                continue;
+            }
+            worker->subscribers.store(count, std::memory_order_relaxed);
+            worker->lastSubscribed = now;
+            workers_.push_back(std::move(worker));
+        }
+
+        for (auto &worker: retired) {
+            MIVI_LOG_INFO("No more subscribers for {}, removing '{}'",
+                    toString(worker->converter.getOutputFormat()), worker->ringName);
+            stopWorker(*worker);
+        }
+    }
+
+    std::unique_ptr<FormatCache::Worker> FormatCache::startWorker(PixelFormat format) {
+        auto worker = std::make_unique<Worker>(format);
+        worker->ringName = getRingName(sourceConfig_.name, format);
+
+        SharedMemory::Config ringConfig = config_.ringConfig;
+        ringConfig.name = worker->ringName;
+        ringConfig.filePath = "/dev/shm/" + worker->ringName;
+        ringConfig.create = true;
+        // One lease lets the kernels write straight into the ring, plus one for safety
+        ringConfig.captureBuffers = 2;
+        // Accept up to a 4K UHD frame in the requested format
+        ringConfig.maxFrameSize = getPixelFormatInfo(format).frameBytes(3840, 2160);
+
+        worker->output = std::make_shared<SharedMemory>(ringConfig);
+        if (worker->output->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to create format ring '{}'", worker->ringName);
+            return nullptr;
+        }
+        if (ringConfig.lockInMemory) {
+            worker->output->lockMemory();
+        }
+
+        worker->source = std::make_shared<SharedMemory>(sourceConfig_);
+        if (worker->source->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Format cache failed to attach to shared memory {}", sourceConfig_.name);
+            return nullptr;
+        }
+
+        worker->thread = std::thread(&FormatCache::workerThread, this, std::ref(*worker));
+        MIVI_LOG_INFO("Publishing {} frames as {} to '{}' on request",
+                toString(FrameConverter::getInputFormat(format)), toString(format), worker->ringName);
+        return worker;
+    }
+
+    void FormatCache::stopWorker(Worker &worker) {
+        worker.stopRequested = true;
+        worker.source->interruptWaits();
+        if (worker.thread.joinable()) {
+            worker.thread.join();
+        }
+
+        // Mapped consumers keep their mapping until they detach; the memory goes with the last of them
+        worker.source.reset();
+        worker.output.reset();
+        if (config_.ringConfig.type == SharedMemoryType::MEMORY_MAPPED_FILE) {
+            // Memory-mapped rings normally outlive the writer, an on-demand one must not
+            unlink(("/dev/shm/" + worker.ringName).c_str());
+        }
+    }
+
+    void FormatCache::workerThread(Worker &worker) {
+        placeCurrentThread();
+
+        const FrameConverter &converter = worker.converter;
+        SharedMemory &output = *worker.output;
+
+        runRingStage(*worker.source, worker.stopRequested, FRAME_WAIT_MS, worker.framesTorn,
+                     [&](const Frame &frame, auto &intact) {
+            if (!FrameConverter::supports(frame.getPixelFormat(), converter.getOutputFormat())) {
+                return;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+
+            // Convert straight into leased arena space so writeFrame() publishes it without a copy
+            size_t outputSize = converter.getOutputSize(frame.getWidth(), frame.getHeight());
+            int lease = output.acquireCaptureBuffer(outputSize);
+            void *data = lease >= 0 ? output.getCaptureBufferData(lease) : nullptr;
+
+            auto converted = converter.convert(frame, data, outputSize);
+
+            // The writer may have lapped us while we were reading the slot
+            if (!converted) {
+                worker.framesDropped.fetch_add(1, std::memory_order_relaxed);
+            } else if (intact()) {
+                if (output.writeFrame(converted) == SharedMemory::Status::OK) {
+                    worker.framesConverted.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    worker.framesDropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            converted.reset();
+
+            if (lease >= 0) {
+                output.releaseCaptureBuffer(lease);
+            }
+
+            conversionTimeHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        });
+    }
+} // namespace medical::imaging
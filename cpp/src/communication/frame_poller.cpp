@@ -0,0 +1,213 @@
+#include "communication/frame_poller.h"
+
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    namespace {
+        // Ready descriptors taken from the kernel per wait
+        constexpr int MAX_EVENTS = 32;
+    }
+
+    FramePoller::FramePoller()
+        : epollFd_(epoll_create1(EPOLL_CLOEXEC)),
+          wakeFd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+          stopRequested_(false) {
+        if (epollFd_ >= 0 && wakeFd_ >= 0) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = wakeFd_;
+            epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &event);
+        }
+    }
+
+    FramePoller::~FramePoller() {
+        if (wakeFd_ >= 0) {
+            close(wakeFd_);
+        }
+        if (epollFd_ >= 0) {
+            close(epollFd_);
+        }
+    }
+
+    bool FramePoller::isValid() const {
+        return epollFd_ >= 0 && wakeFd_ >= 0;
+    }
+
+    int FramePoller::getDescriptor() const {
+        return isValid() ? epollFd_ : -1;
+    }
+
+    bool FramePoller::addRing(std::shared_ptr<SharedMemory> ring, FrameHandler handler) {
+        int descriptor = ring ? ring->getNotificationDescriptor() : -1;
+        if (!isValid() || descriptor < 0 || entries_.count(descriptor)) {
+            return false;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = descriptor;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+            return false;
+        }
+
+        // Frames published before the ring was added signal nothing; the first poll picks them up
+        if (ring->armNotification()) {
+            uint64_t one = 1;
+            ssize_t written = write(descriptor, &one, sizeof(one));
+            (void) written;
+        }
+        entries_[descriptor] = Entry{std::move(ring), std::move(handler), nullptr, nullptr};
+        return true;
+    }
+
+    bool FramePoller::removeRing(const SharedMemory &ring) {
+        int descriptor = ring.getNotificationDescriptor();
+        auto it = entries_.find(descriptor);
+        if (it == entries_.end() || it->second.ring.get() != &ring) {
+            return false;
+        }
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, descriptor, nullptr);
+
+        // A coroutine waiting on the ring would otherwise never finish; it resumes with no frame once the
+        // entry is gone, and the ring stays alive until it suspends again or returns
+        std::shared_ptr<SharedMemory> removed = std::move(it->second.ring);
+        std::function<bool(bool)> waiter = std::move(it->second.waiter);
+        entries_.erase(it);
+        if (waiter) {
+            waiter(true);
+        }
+        return true;
+    }
+
+    bool FramePoller::addDescriptor(int descriptor, uint32_t events, EventHandler handler) {
+        if (!isValid() || descriptor < 0 || descriptor == wakeFd_ || entries_.count(descriptor) || !handler) {
+            return false;
+        }
+
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = descriptor;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, descriptor, &event) != 0) {
+            return false;
+        }
+        entries_[descriptor] = Entry{nullptr, nullptr, std::move(handler), nullptr};
+        return true;
+    }
+
+    bool FramePoller::removeDescriptor(int descriptor) {
+        auto it = entries_.find(descriptor);
+        if (it == entries_.end() || it->second.ring) {
+            return false;
+        }
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, descriptor, nullptr);
+        entries_.erase(it);
+        return true;
+    }
+
+    int FramePoller::poll(int timeoutMs) {
+        if (!isValid()) {
+            return -1;
+        }
+
+        epoll_event events[MAX_EVENTS];
+        int ready = epoll_wait(epollFd_, events, MAX_EVENTS, timeoutMs);
+        if (ready < 0) {
+            return errno == EINTR ? 0 : -1;
+        }
+
+        int dispatched = 0;
+        for (int i = 0; i < ready; ++i) {
+            int descriptor = events[i].data.fd;
+            if (descriptor == wakeFd_) {
+                uint64_t count = 0;
+                ssize_t drained = read(wakeFd_, &count, sizeof(count));
+                (void) drained;
+                continue;
+            }
+
+            // Handlers may remove entries, including ones still in this batch
+            auto it = entries_.find(descriptor);
+            if (it == entries_.end()) {
+                continue;
+            }
+            if (it->second.ring) {
+                dispatched += drainRing(descriptor);
+            } else {
+                EventHandler handler = it->second.eventHandler;
+                handler(events[i].events);
+                dispatched++;
+            }
+        }
+        return dispatched;
+    }
+
+    int FramePoller::drainRing(int descriptor) {
+        int dispatched = 0;
+        while (true) {
+            auto it = entries_.find(descriptor);
+            if (it == entries_.end()) {
+                return dispatched;
+            }
+            Entry &entry = it->second;
+            std::shared_ptr<SharedMemory> ring = entry.ring;
+
+            // A waiting coroutine gets the frame; it may wait again before resume() returns
+            if (entry.waiter) {
+                std::function<bool(bool)> waiter = std::move(entry.waiter);
+                entry.waiter = nullptr;
+                if (waiter(false)) {
+                    dispatched++;
+                    continue;
+                }
+                it = entries_.find(descriptor);
+                if (it != entries_.end() && !it->second.waiter) {
+                    it->second.waiter = std::move(waiter);
+                }
+            } else if (entry.frameHandler) {
+                std::shared_ptr<Frame> frame;
+                if (ring->readNextFrame(frame, 0) == SharedMemory::Status::OK) {
+                    FrameHandler handler = entry.frameHandler;
+                    handler(std::move(frame));
+                    dispatched++;
+                    continue;
+                }
+            }
+
+            // Nothing read: arm for the next frame, unless one arrived meanwhile. A ring with neither
+            // a handler nor a waiter keeps its frames until next() is awaited.
+            it = entries_.find(descriptor);
+            if (it == entries_.end() || !ring->armNotification() ||
+                (!it->second.waiter && !it->second.frameHandler)) {
+                return dispatched;
+            }
+        }
+    }
+
+    void FramePoller::run() {
+        stopRequested_ = false;
+        while (!stopRequested_) {
+            if (poll(-1) < 0) {
+                break;
+            }
+        }
+    }
+
+    void FramePoller::stop() {
+        stopRequested_ = true;
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd_, &one, sizeof(one));
+        (void) written;
+    }
+
+    bool FramePoller::setWaiter(SharedMemory &ring, std::function<bool(bool cancelled)> waiter) {
+        auto it = entries_.find(ring.getNotificationDescriptor());
+        if (it == entries_.end() || it->second.ring.get() != &ring) {
+            return false;
+        }
+        it->second.waiter = std::move(waiter);
+        return true;
+    }
+} // namespace medical::imaging
@@ -0,0 +1,741 @@
+#include "communication/network_bridge.h"
+#include "frame/pixel_format.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <random>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace medical::imaging {
+    static_assert(sizeof(NetworkPacketHeader) == 48, "NetworkPacketHeader layout is part of the wire protocol");
+
+    namespace {
+        // How long the bridge threads wait for frames or datagrams before re-checking for stop
+        constexpr unsigned int FRAME_WAIT_MS = 10;
+
+        // Datagrams handed to the kernel per sendmmsg() or taken per recvmmsg()
+        constexpr size_t BATCH_PACKETS = 32;
+
+        // FrameHeader plus metadata record, the start of every frame message
+        constexpr size_t MESSAGE_PREFIX_BYTES = sizeof(SharedMemory::FrameHeader) +
+                                                sizeof(SharedMemory::FrameMetadataRecord);
+
+        // Smallest datagram worth sending; the message prefix may span several
+        constexpr size_t MIN_DATAGRAM_BYTES = sizeof(NetworkPacketHeader) + 512;
+
+        uint64_t monotonicNow() {
+            timespec ts{};
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        void pinCurrentThread(const char *role, int cpuCore) {
+            if (!ThreadLayout::applyCurrentThread(role) && cpuCore >= 0) {
+                cpu_set_t cpuset;
+                CPU_ZERO(&cpuset);
+                CPU_SET(cpuCore, &cpuset);
+                pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+            }
+        }
+
+        bool parseAddress(const std::string &text, in_addr &address) {
+            if (text.empty()) {
+                address.s_addr = htonl(INADDR_ANY);
+                return true;
+            }
+            return inet_pton(AF_INET, text.c_str(), &address) == 1;
+        }
+    } // namespace
+
+    struct NetworkPublisher::Impl {
+        std::shared_ptr<SharedMemory> reader;
+        int socket = -1;
+        uint32_t streamId = 0;
+        uint64_t packetSequence = 0;
+        uint64_t nextSendNs = 0; // Pacing: when the next batch may leave
+
+        // Per-batch scratch, reused for every frame
+        std::vector<NetworkPacketHeader> headers;
+        std::vector<iovec> iovecs;
+        std::vector<mmsghdr> messages;
+        alignas(8) uint8_t prefix[MESSAGE_PREFIX_BYTES];
+
+        ~Impl() {
+            if (socket >= 0) {
+                close(socket);
+            }
+        }
+    };
+
+    NetworkPublisher::NetworkPublisher(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false),
+          framesSent_(0),
+          packetsSent_(0),
+          bytesSent_(0),
+          framesTorn_(0),
+          sendErrors_(0) {
+    }
+
+    NetworkPublisher::~NetworkPublisher() {
+        stop();
+    }
+
+    NetworkPublisher::Status NetworkPublisher::start(const SharedMemory::Config &ringConfig) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+
+        in_addr group{};
+        in_addr interfaceAddress{};
+        if (config_.port == 0 || !parseAddress(config_.address, group) || config_.address.empty() ||
+            !parseAddress(config_.interfaceAddress, interfaceAddress) ||
+            config_.datagramSize < MIN_DATAGRAM_BYTES ||
+            config_.datagramSize > 65507) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        auto impl = std::make_unique<Impl>();
+        impl->socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (impl->socket < 0) {
+            MIVI_LOG_ERROR("Failed to create network publisher socket: {}", strerror(errno));
+            return Status::SOCKET_ERROR;
+        }
+        int bufferBytes = static_cast<int>(config_.socketBufferBytes);
+        setsockopt(impl->socket, SOL_SOCKET, SO_SNDBUF, &bufferBytes, sizeof(bufferBytes));
+        if (IN_MULTICAST(ntohl(group.s_addr))) {
+            auto ttl = static_cast<unsigned char>(std::clamp(config_.ttl, 0, 255));
+            unsigned char loop = 1; // Receivers on this host too
+            if (setsockopt(impl->socket, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0 ||
+                setsockopt(impl->socket, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0 ||
+                (!config_.interfaceAddress.empty() &&
+                 setsockopt(impl->socket, IPPROTO_IP, IP_MULTICAST_IF, &interfaceAddress,
+                            sizeof(interfaceAddress)) < 0)) {
+                MIVI_LOG_ERROR("Failed to set up multicast on {}: {}", config_.address, strerror(errno));
+                return Status::SOCKET_ERROR;
+            }
+        }
+        sockaddr_in destination{};
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(config_.port);
+        destination.sin_addr = group;
+        if (connect(impl->socket, reinterpret_cast<sockaddr *>(&destination), sizeof(destination)) < 0) {
+            MIVI_LOG_ERROR("Failed to address {}:{}: {}", config_.address, config_.port, strerror(errno));
+            return Status::SOCKET_ERROR;
+        }
+
+        // Attach as a lossy reader: the network must never hold back capture
+        SharedMemory::Config readerConfig = ringConfig;
+        readerConfig.create = false;
+        readerConfig.readerMode = ReaderMode::LOSSY;
+        readerConfig.lockInMemory = false;
+        impl->reader = std::make_shared<SharedMemory>(readerConfig);
+        if (impl->reader->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Network publisher failed to attach to shared memory {}", ringConfig.name);
+            return Status::CONNECTION_FAILED;
+        }
+
+        impl->streamId = std::random_device()();
+        impl->headers.resize(BATCH_PACKETS);
+        impl->iovecs.resize(BATCH_PACKETS * 3);
+        impl->messages.resize(BATCH_PACKETS);
+
+        impl_ = std::move(impl);
+        framesSent_ = 0;
+        packetsSent_ = 0;
+        bytesSent_ = 0;
+        framesTorn_ = 0;
+        sendErrors_ = 0;
+
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&NetworkPublisher::senderThread, this);
+        return Status::OK;
+    }
+
+    NetworkPublisher::Status NetworkPublisher::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        impl_.reset();
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool NetworkPublisher::isRunning() const {
+        return isRunning_;
+    }
+
+    NetworkPublisher::Statistics NetworkPublisher::getStatistics() const {
+        Statistics stats{};
+        stats.framesSent = framesSent_.load(std::memory_order_relaxed);
+        stats.packetsSent = packetsSent_.load(std::memory_order_relaxed);
+        stats.bytesSent = bytesSent_.load(std::memory_order_relaxed);
+        stats.framesTorn = framesTorn_.load(std::memory_order_relaxed);
+        stats.sendErrors = sendErrors_.load(std::memory_order_relaxed);
+
+        // Our own reader slot tells how far behind the writer we are
+        SharedMemory::ReaderInfo reader{};
+        if (impl_ && impl_->reader->getOwnReader(reader)) {
+            stats.lagFrames = reader.lag;
+            stats.framesSkipped = reader.framesSkipped;
+        }
+        return stats;
+    }
+
+    std::map<std::string, std::string> NetworkPublisher::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["net_publisher_frames_sent"] = std::to_string(stats.framesSent);
+        map["net_publisher_packets_sent"] = std::to_string(stats.packetsSent);
+        map["net_publisher_bytes_sent"] = std::to_string(stats.bytesSent);
+        map["net_publisher_frames_torn"] = std::to_string(stats.framesTorn);
+        map["net_publisher_send_errors"] = std::to_string(stats.sendErrors);
+        map["net_publisher_frames_skipped"] = std::to_string(stats.framesSkipped);
+        map["net_publisher_lag_frames"] = std::to_string(stats.lagFrames);
+        return map;
+    }
+
+    void NetworkPublisher::senderThread() {
+        Impl &impl = *impl_;
+        pinCurrentThread("net_publisher", config_.cpuCore);
+
+        const size_t room = config_.datagramSize - sizeof(NetworkPacketHeader);
+
+        // Hand a batch to the kernel once the pacing allows it; false if the socket failed
+        auto flush = [this, &impl](size_t count, size_t bytes) {
+            if (config_.rateMbps > 0.0) {
+                uint64_t now = monotonicNow();
+                if (impl.nextSendNs > now) {
+                    uint64_t wait = impl.nextSendNs - now;
+                    timespec delay{static_cast<time_t>(wait / 1000000000ULL), static_cast<long>(wait % 1000000000ULL)};
+                    nanosleep(&delay, nullptr);
+                } else if (now - impl.nextSendNs > 1000000) {
+                    // Idle time earns no burst credit beyond a millisecond
+                    impl.nextSendNs = now - 1000000;
+                }
+                impl.nextSendNs += static_cast<uint64_t>(static_cast<double>(bytes) * 8000.0 / config_.rateMbps);
+            }
+
+            size_t sent = 0;
+            while (sent < count) {
+                int result = sendmmsg(impl.socket, impl.messages.data() + sent, static_cast<unsigned>(count - sent), 0);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    if (sendErrors_.fetch_add(1, std::memory_order_relaxed) == 0) {
+                        MIVI_LOG_ERROR("Network publisher send failed: {}", strerror(errno));
+                    }
+                    return false;
+                }
+                sent += static_cast<size_t>(result);
+            }
+            packetsSent_.fetch_add(count, std::memory_order_relaxed);
+            bytesSent_.fetch_add(bytes, std::memory_order_relaxed);
+            return true;
+        };
+
+        auto sendCancel = [&impl](const SharedMemory::FrameView &view) {
+            NetworkPacketHeader header{};
+            header.magic = NetworkPacketHeader::MAGIC;
+            header.version = NetworkPacketHeader::VERSION;
+            header.type = NetworkPacketHeader::TYPE_CANCEL;
+            header.streamId = impl.streamId;
+            header.packetSequence = impl.packetSequence++;
+            header.frameSequence = view.sequenceNumber;
+            send(impl.socket, &header, sizeof(header), 0);
+        };
+
+        while (!stopRequested_) {
+            SharedMemory::FrameView view{};
+            size_t count = 0;
+            if (impl.reader->readFrameViews(&view, 1, count, FRAME_WAIT_MS) != SharedMemory::Status::OK ||
+                count == 0) {
+                continue;
+            }
+
+            // The message starts like the ring slot the frame came from
+            std::memset(impl.prefix, 0, sizeof(impl.prefix));
+            auto *frameHeader = reinterpret_cast<SharedMemory::FrameHeader *>(impl.prefix);
+            frameHeader->frameId = view.frameId;
+            frameHeader->timestamp = view.timestampNs;
+            frameHeader->width = view.width;
+            frameHeader->height = view.height;
+            frameHeader->bytesPerPixel = view.bytesPerPixel;
+            frameHeader->dataSize = static_cast<uint32_t>(view.dataSize);
+            frameHeader->rowPitch = view.rowPitch;
+            frameHeader->formatCode = static_cast<uint32_t>(view.format);
+            // The receiver writes a copied, self-contained payload
+            frameHeader->flags = view.flags &
+                                 ~(SharedMemory::FRAME_FLAG_ZERO_COPY | SharedMemory::FRAME_FLAG_DUPLICATE);
+            frameHeader->sequenceNumber = view.sequenceNumber;
+            frameHeader->captureTimeNs = view.captureTimeNs;
+            size_t prefixBytes = sizeof(SharedMemory::FrameHeader);
+            if (view.metadata) {
+                std::memcpy(impl.prefix + prefixBytes, view.metadata, sizeof(SharedMemory::FrameMetadataRecord));
+                frameHeader->metadataOffset = static_cast<uint32_t>(prefixBytes);
+                frameHeader->metadataSize = static_cast<uint32_t>(sizeof(SharedMemory::FrameMetadataRecord));
+                prefixBytes += sizeof(SharedMemory::FrameMetadataRecord);
+            }
+
+            // Fragments come straight from the ring; only the prefix and packet headers are ours
+            const size_t messageSize = prefixBytes + view.dataSize;
+            const auto packetCount = static_cast<uint32_t>((messageSize + room - 1) / room);
+            const auto *payload = static_cast<const uint8_t *>(view.data);
+            bool ok = true;
+            size_t batch = 0;
+            size_t batchBytes = 0;
+            for (uint32_t packet = 0; packet < packetCount && ok; ++packet) {
+                size_t offset = static_cast<size_t>(packet) * room;
+                size_t fragment = std::min(room, messageSize - offset);
+
+                NetworkPacketHeader &header = impl.headers[batch];
+                header.magic = NetworkPacketHeader::MAGIC;
+                header.version = NetworkPacketHeader::VERSION;
+                header.type = NetworkPacketHeader::TYPE_FRAME;
+                header.streamId = impl.streamId;
+                header.packetCount = packetCount;
+                header.packetSequence = impl.packetSequence++;
+                header.frameSequence = view.sequenceNumber;
+                header.packetIndex = packet;
+                header.fragmentOffset = static_cast<uint32_t>(offset);
+                header.fragmentSize = static_cast<uint32_t>(fragment);
+                header.messageSize = static_cast<uint32_t>(messageSize);
+
+                iovec *iov = &impl.iovecs[batch * 3];
+                size_t parts = 0;
+                iov[parts++] = {&header, sizeof(header)};
+                if (offset < prefixBytes) {
+                    size_t prefixPart = std::min(fragment, prefixBytes - offset);
+                    iov[parts++] = {impl.prefix + offset, prefixPart};
+                    if (fragment > prefixPart) {
+                        iov[parts++] = {const_cast<uint8_t *>(payload), fragment - prefixPart};
+                    }
+                } else {
+                    iov[parts++] = {const_cast<uint8_t *>(payload + offset - prefixBytes), fragment};
+                }
+
+                mmsghdr &message = impl.messages[batch];
+                std::memset(&message, 0, sizeof(message));
+                message.msg_hdr.msg_iov = iov;
+                message.msg_hdr.msg_iovlen = parts;
+
+                ++batch;
+                batchBytes += sizeof(header) + fragment;
+                if (batch == BATCH_PACKETS || packet + 1 == packetCount) {
+                    ok = flush(batch, batchBytes);
+                    batch = 0;
+                    batchBytes = 0;
+                }
+            }
+
+            // The kernel copied the fragments during sendmmsg(); a slot reused meanwhile was sent torn
+            bool intact = impl.reader->releaseFrameView(view);
+            if (!ok || !intact) {
+                sendCancel(view);
+                if (ok) {
+                    framesTorn_.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+            framesSent_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    struct NetworkReceiver::Impl {
+        // A frame being put back together from its datagrams
+        struct Slot {
+            bool active = false;
+            uint64_t frameSequence = 0;
+            uint32_t packetCount = 0;
+            uint32_t packetsReceived = 0;
+            uint32_t messageSize = 0;
+            std::vector<uint8_t> message;  // Reused across frames
+            std::vector<uint8_t> received; // Per datagram, so duplicates count once
+        };
+
+        std::shared_ptr<SharedMemory> ring;
+        int socket = -1;
+        std::vector<Slot> slots;
+        std::vector<uint8_t> datagrams; // BATCH_PACKETS receive buffers
+        std::vector<iovec> iovecs;
+        std::vector<mmsghdr> messages;
+
+        // Stream state
+        bool haveStream = false;
+        uint32_t streamId = 0;
+        uint64_t nextPacketSequence = 0;
+        bool havePublished = false;
+        uint64_t lastPublishedSequence = 0;
+
+        std::atomic<uint64_t> framesReceived{0};
+        std::atomic<uint64_t> packetsReceived{0};
+        std::atomic<uint64_t> packetsLost{0};
+        std::atomic<uint64_t> framesIncomplete{0};
+        std::atomic<uint64_t> framesLost{0};
+        std::atomic<uint64_t> framesTorn{0};
+        std::atomic<uint64_t> writeFailures{0};
+        std::atomic<uint64_t> invalidPackets{0};
+        std::atomic<uint64_t> streamRestarts{0};
+
+        ~Impl() {
+            if (socket >= 0) {
+                close(socket);
+            }
+        }
+
+        void resetStream(const NetworkPacketHeader &header) {
+            if (haveStream) {
+                streamRestarts.fetch_add(1, std::memory_order_relaxed);
+                MIVI_LOG_WARNING("Network receiver: new stream {} replaces {}", header.streamId, streamId);
+            }
+            haveStream = true;
+            streamId = header.streamId;
+            nextPacketSequence = header.packetSequence;
+            havePublished = false;
+            for (Slot &slot: slots) {
+                slot.active = false;
+            }
+        }
+
+        Slot *findSlot(uint64_t frameSequence) {
+            for (Slot &slot: slots) {
+                if (slot.active && slot.frameSequence == frameSequence) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+        // Take a slot for a new frame, giving up the oldest partial frame if all are busy
+        Slot &claimSlot(const NetworkPacketHeader &header) {
+            Slot *chosen = nullptr;
+            for (Slot &slot: slots) {
+                if (!slot.active) {
+                    chosen = &slot;
+                    break;
+                }
+                if (!chosen || slot.frameSequence < chosen->frameSequence) {
+                    chosen = &slot;
+                }
+            }
+            if (chosen->active) {
+                framesIncomplete.fetch_add(1, std::memory_order_relaxed);
+            }
+            chosen->active = true;
+            chosen->frameSequence = header.frameSequence;
+            chosen->packetCount = header.packetCount;
+            chosen->packetsReceived = 0;
+            chosen->messageSize = header.messageSize;
+            chosen->message.resize(header.messageSize);
+            chosen->received.assign(header.packetCount, 0);
+            return *chosen;
+        }
+
+        // Write a complete frame message into the local ring
+        void publish(Slot &slot) {
+            slot.active = false;
+
+            // Datagrams arrive in order, so older partial frames cannot complete any more
+            for (Slot &other: slots) {
+                if (other.active && other.frameSequence < slot.frameSequence) {
+                    other.active = false;
+                    framesIncomplete.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            if (havePublished && slot.frameSequence > lastPublishedSequence + 1) {
+                framesLost.fetch_add(slot.frameSequence - lastPublishedSequence - 1, std::memory_order_relaxed);
+            }
+            havePublished = true;
+            lastPublishedSequence = slot.frameSequence;
+
+            uint8_t *message = slot.message.data();
+            const auto *header = reinterpret_cast<const SharedMemory::FrameHeader *>(message);
+            size_t prefixBytes = sizeof(SharedMemory::FrameHeader) + header->metadataSize;
+            if (slot.messageSize < sizeof(SharedMemory::FrameHeader) ||
+                (header->metadataSize != 0 && header->metadataSize != sizeof(SharedMemory::FrameMetadataRecord)) ||
+                prefixBytes + header->dataSize != slot.messageSize || header->height == 0) {
+                invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // Frames carry no row pitch of their own: pack padded rows in place, each moves towards the front
+            PixelFormat format = pixelFormatFromCode(header->formatCode);
+            uint8_t *payload = message + prefixBytes;
+            size_t dataSize = header->dataSize;
+            size_t packedRowBytes = getPixelFormatInfo(format).rowBytes(header->width);
+            if (packedRowBytes == 0) {
+                packedRowBytes = static_cast<size_t>(header->width) * header->bytesPerPixel;
+            }
+            if (header->rowPitch > packedRowBytes &&
+                static_cast<size_t>(header->rowPitch) * header->height == dataSize) {
+                for (uint32_t row = 1; row < header->height; ++row) {
+                    std::memmove(payload + row * packedRowBytes, payload + row * header->rowPitch, packedRowBytes);
+                }
+                dataSize = packedRowBytes * header->height;
+            }
+
+            auto frame = Frame::createWithExternalData(payload, dataSize, header->width, header->height,
+                                                       header->bytesPerPixel, format, false,
+                                                       BufferType::EXTERNAL_MEMORY);
+            if (!frame) {
+                writeFailures.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            frame->setFrameId(header->frameId);
+            frame->setTimestamp(std::chrono::system_clock::time_point(std::chrono::nanoseconds(header->timestamp)));
+            frame->setCaptureTime(std::chrono::steady_clock::time_point(
+                std::chrono::nanoseconds(header->captureTimeNs)));
+            if (header->metadataSize != 0) {
+                const auto *record = reinterpret_cast<const SharedMemory::FrameMetadataRecord *>(
+                    message + sizeof(SharedMemory::FrameHeader));
+                SharedMemory::unpackMetadataRecord(*record, frame->getMetadataMutable());
+            }
+
+            if (ring->writeFrame(frame) == SharedMemory::Status::OK) {
+                framesReceived.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                writeFailures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        void handlePacket(const uint8_t *data, size_t length) {
+            NetworkPacketHeader header;
+            if (length < sizeof(header)) {
+                invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::memcpy(&header, data, sizeof(header));
+            if (header.magic != NetworkPacketHeader::MAGIC || header.version != NetworkPacketHeader::VERSION) {
+                invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            packetsReceived.fetch_add(1, std::memory_order_relaxed);
+
+            if (!haveStream || header.streamId != streamId) {
+                resetStream(header);
+            }
+
+            // Datagrams of one stream are numbered; late ones make up for what was counted lost
+            if (header.packetSequence >= nextPacketSequence) {
+                packetsLost.fetch_add(header.packetSequence - nextPacketSequence, std::memory_order_relaxed);
+                nextPacketSequence = header.packetSequence + 1;
+            } else if (packetsLost.load(std::memory_order_relaxed) > 0) {
+                packetsLost.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            if (header.type == NetworkPacketHeader::TYPE_CANCEL) {
+                if (Slot *slot = findSlot(header.frameSequence)) {
+                    slot->active = false;
+                }
+                framesTorn.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (header.type != NetworkPacketHeader::TYPE_FRAME ||
+                sizeof(header) + header.fragmentSize > length || header.packetIndex >= header.packetCount ||
+                static_cast<uint64_t>(header.fragmentOffset) + header.fragmentSize > header.messageSize) {
+                invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (havePublished && header.frameSequence <= lastPublishedSequence) {
+                return;
+            }
+
+            Slot *slot = findSlot(header.frameSequence);
+            if (!slot) {
+                slot = &claimSlot(header);
+            }
+            if (slot->packetCount != header.packetCount || slot->messageSize != header.messageSize) {
+                invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (slot->received[header.packetIndex]) {
+                return;
+            }
+            slot->received[header.packetIndex] = 1;
+            std::memcpy(slot->message.data() + header.fragmentOffset, data + sizeof(header), header.fragmentSize);
+            if (++slot->packetsReceived == slot->packetCount) {
+                publish(*slot);
+            }
+        }
+    };
+
+    NetworkReceiver::NetworkReceiver(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false) {
+    }
+
+    NetworkReceiver::~NetworkReceiver() {
+        stop();
+    }
+
+    NetworkReceiver::Status NetworkReceiver::start(const SharedMemory::Config &ringConfig) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+
+        in_addr group{};
+        in_addr interfaceAddress{};
+        if (config_.port == 0 || !parseAddress(config_.address, group) ||
+            !parseAddress(config_.interfaceAddress, interfaceAddress) || config_.reassemblySlots == 0 ||
+            config_.maxDatagramSize < MIN_DATAGRAM_BYTES) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        auto impl = std::make_unique<Impl>();
+        impl->socket = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (impl->socket < 0) {
+            MIVI_LOG_ERROR("Failed to create network receiver socket: {}", strerror(errno));
+            return Status::SOCKET_ERROR;
+        }
+        int reuse = 1;
+        int bufferBytes = static_cast<int>(config_.socketBufferBytes);
+        setsockopt(impl->socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        setsockopt(impl->socket, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+
+        // Bound to the group itself, the socket sees no other traffic to the port
+        bool multicast = IN_MULTICAST(ntohl(group.s_addr));
+        sockaddr_in local{};
+        local.sin_family = AF_INET;
+        local.sin_port = htons(config_.port);
+        local.sin_addr = group;
+        if (bind(impl->socket, reinterpret_cast<sockaddr *>(&local), sizeof(local)) < 0) {
+            MIVI_LOG_ERROR("Failed to bind network receiver to {}:{}: {}",
+                    config_.address, config_.port, strerror(errno));
+            return Status::SOCKET_ERROR;
+        }
+        if (multicast) {
+            ip_mreq membership{};
+            membership.imr_multiaddr = group;
+            membership.imr_interface = interfaceAddress;
+            if (setsockopt(impl->socket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+                MIVI_LOG_ERROR("Failed to join multicast group {}: {}", config_.address, strerror(errno));
+                return Status::SOCKET_ERROR;
+            }
+        }
+
+        // The local ring looks to its consumers like the one on the capture node
+        SharedMemory::Config localConfig = ringConfig;
+        localConfig.create = true;
+        impl->ring = std::make_shared<SharedMemory>(localConfig);
+        if (impl->ring->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Network receiver failed to create shared memory {}", ringConfig.name);
+            return Status::CREATION_FAILED;
+        }
+
+        impl->slots.resize(config_.reassemblySlots);
+        impl->datagrams.resize(BATCH_PACKETS * config_.maxDatagramSize);
+        impl->iovecs.resize(BATCH_PACKETS);
+        impl->messages.resize(BATCH_PACKETS);
+        for (size_t i = 0; i < BATCH_PACKETS; ++i) {
+            impl->iovecs[i] = {impl->datagrams.data() + i * config_.maxDatagramSize, config_.maxDatagramSize};
+        }
+
+        impl_ = std::move(impl);
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&NetworkReceiver::receiverThread, this);
+        return Status::OK;
+    }
+
+    NetworkReceiver::Status NetworkReceiver::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        impl_.reset();
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool NetworkReceiver::isRunning() const {
+        return isRunning_;
+    }
+
+    std::shared_ptr<SharedMemory> NetworkReceiver::getSharedMemory() const {
+        return impl_ ? impl_->ring : nullptr;
+    }
+
+    NetworkReceiver::Statistics NetworkReceiver::getStatistics() const {
+        Statistics stats{};
+        if (impl_) {
+            stats.framesReceived = impl_->framesReceived.load(std::memory_order_relaxed);
+            stats.packetsReceived = impl_->packetsReceived.load(std::memory_order_relaxed);
+            stats.packetsLost = impl_->packetsLost.load(std::memory_order_relaxed);
+            stats.framesIncomplete = impl_->framesIncomplete.load(std::memory_order_relaxed);
+            stats.framesLost = impl_->framesLost.load(std::memory_order_relaxed);
+            stats.framesTorn = impl_->framesTorn.load(std::memory_order_relaxed);
+            stats.writeFailures = impl_->writeFailures.load(std::memory_order_relaxed);
+            stats.invalidPackets = impl_->invalidPackets.load(std::memory_order_relaxed);
+            stats.streamRestarts = impl_->streamRestarts.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    std::map<std::string, std::string> NetworkReceiver::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["net_receiver_frames_received"] = std::to_string(stats.framesReceived);
+        map["net_receiver_packets_received"] = std::to_string(stats.packetsReceived);
+        map["net_receiver_packets_lost"] = std::to_string(stats.packetsLost);
+        map["net_receiver_frames_incomplete"] = std::to_string(stats.framesIncomplete);
+        map["net_receiver_frames_lost"] = std::to_string(stats.framesLost);
+        map["net_receiver_frames_torn"] = std::to_string(stats.framesTorn);
+        map["net_receiver_write_failures"] = std::to_string(stats.writeFailures);
+        map["net_receiver_invalid_packets"] = std::to_string(stats.invalidPackets);
+        map["net_receiver_stream_restarts"] = std::to_string(stats.streamRestarts);
+        return map;
+    }
+
+    void NetworkReceiver::receiverThread() {
+        Impl &impl = *impl_;
+        pinCurrentThread("net_receiver", config_.cpuCore);
+
+        while (!stopRequested_) {
+            pollfd descriptor{impl.socket, POLLIN, 0};
+            if (::poll(&descriptor, 1, FRAME_WAIT_MS) <= 0) {
+                continue;
+            }
+
+            for (size_t i = 0; i < BATCH_PACKETS; ++i) {
+                std::memset(&impl.messages[i], 0, sizeof(mmsghdr));
+                impl.messages[i].msg_hdr.msg_iov = &impl.iovecs[i];
+                impl.messages[i].msg_hdr.msg_iovlen = 1;
+            }
+            int count = recvmmsg(impl.socket, impl.messages.data(), BATCH_PACKETS, MSG_DONTWAIT, nullptr);
+            for (int i = 0; i < count; ++i) {
+                // A datagram larger than our buffer was cut off and cannot be used
+                if (impl.messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                    impl.invalidPackets.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                impl.handlePacket(static_cast<const uint8_t *>(impl.iovecs[i].iov_base), impl.messages[i].msg_len);
+            }
+        }
+    }
+} // namespace medical::imaging
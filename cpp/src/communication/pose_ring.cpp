@@ -0,0 +1,369 @@
+#include "communication/pose_ring.h"
+
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    static_assert(sizeof(PoseRingLayout::Header) == 128, "pose ring header layout changed");
+    static_assert(sizeof(PoseRingLayout::Sample) == 64, "pose sample layout changed");
+
+    namespace {
+        // Length of one window of the tracker clock offset estimate
+        constexpr uint64_t OFFSET_WINDOW_NS = 2000000000;
+
+        // Attempts at a lookup that keeps losing its samples to the writer
+        constexpr int LOOKUP_ATTEMPTS = 4;
+
+        size_t roundUpToPowerOfTwo(size_t value) {
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        uint64_t monotonicNow() {
+            timespec ts{};
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        // Spherical interpolation on the shorter arc; nearly parallel quaternions are blended linearly
+        void slerp(const float (&from)[4], const float (&to)[4], double fraction, float (&result)[4]) {
+            double dot = 0.0;
+            for (int i = 0; i < 4; ++i) {
+                dot += static_cast<double>(from[i]) * to[i];
+            }
+            double sign = dot < 0.0 ? -1.0 : 1.0;
+            dot *= sign;
+
+            double weightFrom = 1.0 - fraction;
+            double weightTo = fraction;
+            if (dot < 0.9995) {
+                double theta = std::acos(std::min(dot, 1.0));
+                double sinTheta = std::sin(theta);
+                weightFrom = std::sin((1.0 - fraction) * theta) / sinTheta;
+                weightTo = std::sin(fraction * theta) / sinTheta;
+            }
+
+            double blended[4];
+            double norm = 0.0;
+            for (int i = 0; i < 4; ++i) {
+                blended[i] = weightFrom * from[i] + weightTo * sign * to[i];
+                norm += blended[i] * blended[i];
+            }
+            norm = norm > 0.0 ? std::sqrt(norm) : 1.0;
+            for (int i = 0; i < 4; ++i) {
+                result[i] = static_cast<float>(blended[i] / norm);
+            }
+        }
+    } // namespace
+
+    PoseWriter::PoseWriter(const Config &config)
+        : config_(config),
+          fd_(-1),
+          mapping_(nullptr),
+          mappingSize_(0),
+          header_(nullptr),
+          samples_(nullptr),
+          lastTimestampNs_(0),
+          offsetWindowMin_(INT64_MAX),
+          offsetPreviousMin_(INT64_MAX),
+          offsetWindowStartNs_(0) {
+    }
+
+    PoseWriter::~PoseWriter() {
+        release();
+    }
+
+    bool PoseWriter::initialize() {
+        if (mapping_) {
+            return true;
+        }
+        if (config_.name.empty() || config_.capacity == 0) {
+            return false;
+        }
+
+        const std::string name = "/" + config_.name;
+        const size_t capacity = roundUpToPowerOfTwo(config_.capacity);
+        mappingSize_ = sizeof(PoseRingLayout::Header) + capacity * sizeof(PoseRingLayout::Sample);
+
+        // A ring left by a writer that crashed is replaced; readers still mapping it see it go quiet
+        shm_unlink(name.c_str());
+        fd_ = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd_ < 0) {
+            MIVI_LOG_ERROR("Failed to create pose ring {}: {}", config_.name, strerror(errno));
+            return false;
+        }
+        if (ftruncate(fd_, static_cast<off_t>(mappingSize_)) < 0) {
+            MIVI_LOG_ERROR("Failed to set pose ring size: {}", strerror(errno));
+            release();
+            return false;
+        }
+        void *address = mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (address == MAP_FAILED) {
+            MIVI_LOG_ERROR("Failed to map pose ring: {}", strerror(errno));
+            release();
+            return false;
+        }
+        mapping_ = address;
+
+        // The region is zero filled; the magic goes in last so that readers never see a partial header
+        header_ = static_cast<PoseRingLayout::Header *>(mapping_);
+        samples_ = reinterpret_cast<PoseRingLayout::Sample *>(static_cast<uint8_t *>(mapping_) +
+                                                              sizeof(PoseRingLayout::Header));
+        header_->version = PoseRingLayout::VERSION;
+        header_->capacity = static_cast<uint32_t>(capacity);
+        header_->sampleSize = sizeof(PoseRingLayout::Sample);
+        header_->writeIndex.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = PoseRingLayout::MAGIC;
+
+        lastTimestampNs_ = 0;
+        offsetWindowMin_ = INT64_MAX;
+        offsetPreviousMin_ = INT64_MAX;
+        offsetWindowStartNs_ = 0;
+        return true;
+    }
+
+    void PoseWriter::release() {
+        if (mapping_) {
+            munmap(mapping_, mappingSize_);
+            mapping_ = nullptr;
+        }
+        header_ = nullptr;
+        samples_ = nullptr;
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+            shm_unlink(("/" + config_.name).c_str());
+        }
+    }
+
+    bool PoseWriter::publish(const ProbePose &pose) {
+        if (!header_ || pose.timestampNs < lastTimestampNs_) {
+            return false;
+        }
+
+        // Seqlock: readers that copy the slot while it is odd, or across the change, discard the copy
+        uint64_t index = header_->writeIndex.load(std::memory_order_relaxed);
+        PoseRingLayout::Sample &sample = samples_[index & (header_->capacity - 1)];
+        sample.generation.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        sample.timestampNs = pose.timestampNs;
+        std::memcpy(sample.position, pose.position, sizeof(sample.position));
+        std::memcpy(sample.orientation, pose.orientation, sizeof(sample.orientation));
+        sample.quality = pose.quality;
+        sample.generation.store(2 * index + 2, std::memory_order_release);
+        header_->writeIndex.store(index + 1, std::memory_order_release);
+
+        lastTimestampNs_ = pose.timestampNs;
+        return true;
+    }
+
+    bool PoseWriter::publishTrackerTime(uint64_t trackerTimeNs, ProbePose pose) {
+        if (!header_) {
+            return false;
+        }
+
+        // Arrival minus measurement is the clock offset plus the delivery delay; its minimum has the least delay
+        uint64_t arrivalNs = monotonicNow();
+        int64_t offset = static_cast<int64_t>(arrivalNs - trackerTimeNs);
+        if (offsetWindowStartNs_ == 0 || arrivalNs - offsetWindowStartNs_ >= OFFSET_WINDOW_NS) {
+            // Two windows are kept so the estimate follows clock drift without jumping at every rollover
+            offsetPreviousMin_ = offsetWindowMin_;
+            offsetWindowMin_ = INT64_MAX;
+            offsetWindowStartNs_ = arrivalNs;
+        }
+        offsetWindowMin_ = std::min(offsetWindowMin_, offset);
+        int64_t estimate = std::min(offsetWindowMin_, offsetPreviousMin_);
+
+        // A falling estimate must not make the samples go back in time
+        uint64_t mapped = trackerTimeNs + static_cast<uint64_t>(estimate) - config_.trackerLatencyNs;
+        pose.timestampNs = std::max(mapped, lastTimestampNs_);
+        return publish(pose);
+    }
+
+    uint64_t PoseWriter::getSampleCount() const {
+        return header_ ? header_->writeIndex.load(std::memory_order_relaxed) : 0;
+    }
+
+    PoseReader::PoseReader(const Config &config)
+        : config_(config),
+          mapping_(nullptr),
+          mappingSize_(0),
+          header_(nullptr),
+          samples_(nullptr),
+          mask_(0) {
+    }
+
+    PoseReader::~PoseReader() {
+        if (mapping_) {
+            munmap(mapping_, mappingSize_);
+        }
+    }
+
+    bool PoseReader::initialize() {
+        if (mapping_) {
+            return true;
+        }
+
+        int fd = shm_open(("/" + config_.name).c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat sb{};
+        if (fstat(fd, &sb) < 0 || static_cast<size_t>(sb.st_size) < sizeof(PoseRingLayout::Header)) {
+            close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(sb.st_size);
+        void *address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED) {
+            return false;
+        }
+
+        const auto *header = static_cast<const PoseRingLayout::Header *>(address);
+        uint32_t capacity = header->capacity;
+        bool compatible = header->magic == PoseRingLayout::MAGIC && header->version == PoseRingLayout::VERSION &&
+                          header->sampleSize == sizeof(PoseRingLayout::Sample) && capacity != 0 &&
+                          (capacity & (capacity - 1)) == 0 &&
+                          size >= sizeof(PoseRingLayout::Header) + capacity * sizeof(PoseRingLayout::Sample);
+        if (!compatible) {
+            MIVI_LOG_WARNING("Pose ring {} has an unknown layout", config_.name);
+            munmap(address, size);
+            return false;
+        }
+
+        mapping_ = address;
+        mappingSize_ = size;
+        header_ = header;
+        samples_ = reinterpret_cast<const PoseRingLayout::Sample *>(static_cast<const uint8_t *>(address) +
+                                                                    sizeof(PoseRingLayout::Header));
+        mask_ = capacity - 1;
+        return true;
+    }
+
+    bool PoseReader::isAttached() const {
+        return mapping_ != nullptr;
+    }
+
+    bool PoseReader::readSample(uint64_t index, ProbePose &pose) const {
+        const PoseRingLayout::Sample &sample = samples_[index & mask_];
+        uint64_t generation = sample.generation.load(std::memory_order_acquire);
+        if (generation != 2 * index + 2) {
+            return false;
+        }
+        pose.timestampNs = sample.timestampNs;
+        std::memcpy(pose.position, sample.position, sizeof(pose.position));
+        std::memcpy(pose.orientation, sample.orientation, sizeof(pose.orientation));
+        pose.quality = sample.quality;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sample.generation.load(std::memory_order_relaxed) == generation;
+    }
+
+    bool PoseReader::latest(ProbePose &pose) const {
+        if (!header_) {
+            return false;
+        }
+        for (int attempt = 0; attempt < LOOKUP_ATTEMPTS; ++attempt) {
+            uint64_t end = header_->writeIndex.load(std::memory_order_acquire);
+            if (end == 0) {
+                return false;
+            }
+            if (readSample(end - 1, pose)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool PoseReader::interpolate(uint64_t timestampNs, ProbePose &pose) const {
+        if (!header_) {
+            return false;
+        }
+
+        for (int attempt = 0; attempt < LOOKUP_ATTEMPTS; ++attempt) {
+            uint64_t end = header_->writeIndex.load(std::memory_order_acquire);
+            if (end == 0) {
+                return false;
+            }
+
+            // Newest sample first: frames are usually looked up right after capture
+            ProbePose after;
+            if (!readSample(end - 1, after)) {
+                continue;
+            }
+            if (timestampNs >= after.timestampNs) {
+                if (timestampNs - after.timestampNs > config_.maxExtrapolationNs) {
+                    return false;
+                }
+                pose = after;
+                pose.timestampNs = timestampNs;
+                return true;
+            }
+
+            // The oldest slot is the next one the writer reuses, so the search starts one later
+            uint64_t capacity = mask_ + 1;
+            uint64_t low = end > capacity ? end - capacity + 1 : 0;
+            uint64_t high = end - 1;
+            ProbePose before;
+            if (low == high) {
+                return false;
+            }
+            if (!readSample(low, before)) {
+                continue;
+            }
+            if (timestampNs < before.timestampNs) {
+                return false;
+            }
+
+            // Invariant: before.timestampNs <= timestampNs < after.timestampNs
+            bool lapped = false;
+            while (high - low > 1) {
+                uint64_t middle = low + (high - low) / 2;
+                ProbePose probe;
+                if (!readSample(middle, probe)) {
+                    lapped = true;
+                    break;
+                }
+                if (probe.timestampNs <= timestampNs) {
+                    low = middle;
+                    before = probe;
+                } else {
+                    high = middle;
+                    after = probe;
+                }
+            }
+            if (lapped) {
+                continue;
+            }
+
+            uint64_t gap = after.timestampNs - before.timestampNs;
+            if (gap > config_.maxGapNs) {
+                return false;
+            }
+            double fraction = static_cast<double>(timestampNs - before.timestampNs) / static_cast<double>(gap);
+            for (int i = 0; i < 3; ++i) {
+                pose.position[i] = static_cast<float>(before.position[i] +
+                                                      fraction * (after.position[i] - before.position[i]));
+            }
+            slerp(before.orientation, after.orientation, fraction, pose.orientation);
+            pose.quality = fraction < 0.5 ? before.quality : after.quality;
+            pose.timestampNs = timestampNs;
+            return true;
+        }
+        return false;
+    }
+} // namespace medical::imaging
@@ -0,0 +1,193 @@
+#include "communication/result_ring.h"
+
+#include "utils/log.h"
+
+#include <unistd.h>
+
+namespace medical::imaging {
+    // How long a missing result ring is left alone before the joiner looks for it again
+    constexpr auto RESULT_ATTACH_INTERVAL = std::chrono::seconds(1);
+
+    ResultPublisher::ResultPublisher(const Config &config)
+        : config_(config) {
+    }
+
+    ResultPublisher::Status ResultPublisher::initialize() {
+        if (ring_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (config_.name.empty() || config_.maxFrames == 0 || config_.maxResultSize == 0) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        SharedMemory::Config shmConfig;
+        shmConfig.name = config_.name;
+        shmConfig.filePath = "/dev/shm/" + config_.name;
+        shmConfig.size = config_.size;
+        shmConfig.type = config_.type;
+        shmConfig.create = true;
+        shmConfig.maxFrames = config_.maxFrames;
+        shmConfig.maxFrameSize = config_.maxResultSize;
+        shmConfig.lockInMemory = false;
+        shmConfig.captureBuffers = 0;
+        // Results nobody picked up are worth less than the next one; never wait for consumers
+        shmConfig.writePolicy = WritePolicy::DROP_NEWEST;
+
+        auto ring = std::make_shared<SharedMemory>(shmConfig);
+        if (ring->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Failed to create result ring {}", config_.name);
+            return Status::CREATION_FAILED;
+        }
+
+        // Consumers find the frame ring the results belong to here
+        ring->updateMetadata("result_source", config_.sourceName);
+        ring_ = std::move(ring);
+        return Status::OK;
+    }
+
+    ResultPublisher::Status ResultPublisher::publish(const Frame &source, const std::shared_ptr<Frame> &result) {
+        if (!ring_) {
+            return Status::NOT_RUNNING;
+        }
+        if (!result) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        // The result takes over the identity of its frame, which is what consumers look it up by
+        result->setFrameId(source.getFrameId());
+        result->setTimestamp(source.getTimestamp());
+        result->setCaptureTime(source.getCaptureTime());
+        result->getMetadataMutable() = source.getMetadata();
+        result->getMetadataMutable().hasSegmentationData = true;
+
+        return ring_->writeFrame(result) == SharedMemory::Status::OK ? Status::OK : Status::WRITE_FAILED;
+    }
+
+    std::shared_ptr<SharedMemory> ResultPublisher::getSharedMemory() const {
+        return ring_;
+    }
+
+    FrameResultJoiner::FrameResultJoiner(const Config &config)
+        : config_(config),
+          resultsAttached_(false),
+          framesRead_(0),
+          framesJoined_(0),
+          framesUnmatched_(0) {
+    }
+
+    FrameResultJoiner::Status FrameResultJoiner::initialize() {
+        if (frames_) {
+            return Status::ALREADY_RUNNING;
+        }
+
+        SharedMemory::Config frameConfig;
+        frameConfig.name = config_.frameRingName;
+        frameConfig.filePath = "/dev/shm/" + config_.frameRingName;
+        frameConfig.type = config_.type;
+        frameConfig.create = false;
+        frameConfig.readerMode = config_.readerMode;
+        frameConfig.lockInMemory = false;
+        auto frames = std::make_shared<SharedMemory>(frameConfig);
+        if (frames->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Joiner failed to attach to frame ring {}", config_.frameRingName);
+            return Status::CONNECTION_FAILED;
+        }
+        frames_ = std::move(frames);
+
+        // The result producer may not be up yet; readNext() keeps looking for its ring
+        nextAttachAttempt_ = std::chrono::steady_clock::time_point();
+        attachResults();
+        return Status::OK;
+    }
+
+    bool FrameResultJoiner::attachResults() {
+        if (results_) {
+            return true;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextAttachAttempt_) {
+            return false;
+        }
+        nextAttachAttempt_ = now + RESULT_ATTACH_INTERVAL;
+
+        SharedMemory::Config resultConfig;
+        resultConfig.name = config_.resultRingName;
+        resultConfig.filePath = "/dev/shm/" + config_.resultRingName;
+        resultConfig.type = config_.type;
+        resultConfig.create = false;
+        // Results are looked up, not consumed in order: never hold back the producer
+        resultConfig.readerMode = ReaderMode::LOSSY;
+        resultConfig.lockInMemory = false;
+
+        // Don't let every retry log an open failure while the producer is not up
+        bool backedByPath = config_.type == SharedMemoryType::MEMORY_MAPPED_FILE ||
+                            config_.type == SharedMemoryType::POSIX_SHM;
+        if (backedByPath && access(resultConfig.filePath.c_str(), F_OK) != 0) {
+            return false;
+        }
+
+        auto results = std::make_shared<SharedMemory>(resultConfig);
+        if (results->initialize() != SharedMemory::Status::OK) {
+            return false;
+        }
+
+        results_ = std::move(results);
+        resultsAttached_ = true;
+        return true;
+    }
+
+    FrameResultJoiner::Status FrameResultJoiner::readNext(JoinedFrame &joined, unsigned int waitMilliseconds) {
+        joined.frame.reset();
+        joined.result.reset();
+        if (!frames_) {
+            return Status::NOT_RUNNING;
+        }
+
+        auto status = frames_->readNextFrame(joined.frame, waitMilliseconds);
+        if (status == SharedMemory::Status::BUFFER_EMPTY || status == SharedMemory::Status::TIMEOUT) {
+            return Status::TIMEOUT;
+        }
+        if (status != SharedMemory::Status::OK || !joined.frame) {
+            return Status::READ_FAILED;
+        }
+        framesRead_.fetch_add(1, std::memory_order_relaxed);
+
+        if (attachResults()) {
+            // Inference usually trails capture by a few frames, so the result may still be on its way
+            auto start = std::chrono::steady_clock::now();
+            if (results_->findFrame(joined.frame->getFrameId(), joined.result, config_.resultWaitMs) !=
+                SharedMemory::Status::OK) {
+                joined.result.reset();
+            }
+            resultWaitHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        }
+
+        if (joined.result) {
+            framesJoined_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            framesUnmatched_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return Status::OK;
+    }
+
+    FrameResultJoiner::Statistics FrameResultJoiner::getStatistics() const {
+        Statistics stats{};
+        stats.framesRead = framesRead_.load(std::memory_order_relaxed);
+        stats.framesJoined = framesJoined_.load(std::memory_order_relaxed);
+        stats.framesUnmatched = framesUnmatched_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    std::map<std::string, std::string> FrameResultJoiner::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["joiner_frames_read"] = std::to_string(stats.framesRead);
+        map["joiner_frames_joined"] = std::to_string(stats.framesJoined);
+        map["joiner_frames_unmatched"] = std::to_string(stats.framesUnmatched);
+        map["joiner_result_ring_attached"] = resultsAttached_ ? "true" : "false";
+        appendHistogramStatistics(map, "joiner_result_wait", resultWaitHistogram_.snapshot());
+        return map;
+    }
+} // namespace medical::imaging
@@ -1,24 +1,137 @@
 #include "communication/shared_memory.h"
+#include "communication/pose_ring.h"
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/shm.h>
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#include <linux/memfd.h>
 #include <fcntl.h>
+#include <signal.h>
 #include <unistd.h>
 #include <cstring>
-#include <iostream>
+#include <cstddef>
 #include <thread>
 #include <chrono>
 #include <utility>
+#include <algorithm>
+#include <iterator>
+#include <deque>
 #include <pthread.h>
 #include <fstream>
 #include <sstream>
 #include <nlohmann/json.hpp>  // For JSON metadata
 
+#include "utils/futex.h"
+#include "utils/latency_histogram.h"
+#include "utils/log.h"
+#include "utils/numa.h"
+#include "utils/thread_layout.h"
+
 using json = nlohmann::json;
 
+// Prefault requests, available since Linux 5.14; older kernels reject them with EINVAL
+#ifndef MADV_POPULATE_READ
+#define MADV_POPULATE_READ 22
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+// Deactivation hint for pages not needed soon, available since Linux 5.4; older kernels reject it
+#ifndef MADV_COLD
+#define MADV_COLD 20
+#endif
+
+// Bit position of log2(page size) in shmget() flags, as HUGETLB_FLAG_ENCODE_SHIFT
+#ifndef SHM_HUGE_SHIFT
+#define SHM_HUGE_SHIFT 26
+#endif
+
 namespace medical::imaging {
+    namespace {
+        // Raise a counter to at least the given value
+        void storeMax(std::atomic<uint64_t> &counter, uint64_t value) {
+            uint64_t current = counter.load(std::memory_order_relaxed);
+            while (value > current && !counter.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+
+        // How long a missing or silent pose ring is left alone before the writer looks for it again
+        constexpr auto POSE_ATTACH_INTERVAL = std::chrono::seconds(1);
+    } // namespace
+
     // Platform-specific implementation for shared memory
     struct SharedMemory::Impl {
+        // The control block is read directly by Python/Rust clients (see protocol.md)
+        static_assert(sizeof(ControlBlock) == 640, "ControlBlock size is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, version) == 4, "version offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, readerTableOffset) == 16, "readerTableOffset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, layoutHash) == 32, "layoutHash offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, writerEpoch) == 40, "writerEpoch offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, geometryEpoch) == 44, "geometryEpoch offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, legacyActive) == 48, "1.x readers wait for active at offset 48");
+        static_assert(offsetof(ControlBlock, timeIndexOffset) == 56, "timeIndexOffset offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, legacyMetadataOffset) == 72, "1.x readers find metadataOffset at offset 72");
+        static_assert(offsetof(ControlBlock, geometryWidth) == 80, "geometryWidth offset is part of the wire protocol");
+        static_assert(sizeof(TimeIndexEntry) == 16, "TimeIndexEntry size is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, writeIndex) == 128, "writeIndex offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, frameDoorbell) == 144, "frameDoorbell offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, partialIndex) == 152, "partialIndex offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, bandDoorbell) == 160, "bandDoorbell offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, totalFramesWritten) == 256, "writer statistics offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, bufferFullCount) == 280, "bufferFullCount offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, frameWaiters) == 384, "frameWaiters offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, spaceDoorbell) == 388, "spaceDoorbell offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, bandWaiters) == 392, "bandWaiters offset is part of the wire protocol");
+        static_assert(offsetof(ControlBlock, readIndex) == 512, "readIndex offset is part of the wire protocol");
+        static_assert(sizeof(ReaderSlot) == 128, "ReaderSlot must occupy exactly one pair of cache lines");
+        static_assert(offsetof(ReaderSlot, doorbell) == 96, "ReaderSlot doorbell offset is part of the wire protocol");
+        static_assert(offsetof(ReaderSlot, framesFiltered) == 104, "ReaderSlot framesFiltered offset is part of the wire protocol");
+        static_assert(offsetof(ReaderSlot, claimTimeNs) == 112, "ReaderSlot claimTimeNs offset is part of the wire protocol");
+        static_assert(sizeof(Layout) == 104, "Layout size is part of the control socket protocol");
+        static_assert(offsetof(FrameHeader, generation) == 56, "FrameHeader generation offset is part of the wire protocol");
+        static_assert(offsetof(FrameHeader, payloadOffset) == 64, "FrameHeader payloadOffset offset is part of the wire protocol");
+        static_assert(offsetof(FrameHeader, captureTimeNs) == 72, "FrameHeader captureTimeNs offset is part of the wire protocol");
+        static_assert(offsetof(FrameHeader, rowPitch) == 88, "FrameHeader rowPitch offset is part of the wire protocol");
+        static_assert(offsetof(FrameHeader, rowsReady) == 92, "FrameHeader rowsReady offset is part of the wire protocol");
+        static_assert(sizeof(FrameHeader) == 96, "FrameHeader size is part of the wire protocol");
+        static_assert(sizeof(FrameMetadataRecord) == 1280, "FrameMetadataRecord size is part of the wire protocol");
+        static_assert(offsetof(FrameMetadataRecord, roiX) == 1160, "FrameMetadataRecord roiX offset is part of the wire protocol");
+        static_assert(offsetof(FrameMetadataRecord, statisticsPixelCount) == 1176,
+                      "FrameMetadataRecord statistics offset is part of the wire protocol");
+
+        // Slot generation while the writer is filling the slot for a sequence number (always odd)
+        static uint64_t writingGeneration(uint64_t sequence) {
+            return 2 * sequence + 1;
+        }
+
+        // Slot generation once the slot holds a complete frame for a sequence number (always even, never 0)
+        static uint64_t stableGeneration(uint64_t sequence) {
+            return 2 * sequence + 2;
+        }
+
+        // Part of the layout hash; bump when the meaning of the region changes without its sizes changing
+        static constexpr uint64_t LAYOUT_VERSION = 3;
+
+        // Marks a laid out control block ("MVCB") and the version of its layout, checked before anything else
+        static constexpr uint32_t CONTROL_BLOCK_MAGIC = 0x4243564D;
+        static constexpr uint32_t CONTROL_BLOCK_VERSION = 2;
+
+        // Control block flags
+        static constexpr uint32_t CONTROL_FLAG_OVERWRITE = 0x01; // The writer laps lossless readers too
+
+        // Reader slot states
+        static constexpr uint32_t READER_FREE = 0;
+        static constexpr uint32_t READER_CLAIMED = 1;
+        static constexpr uint32_t READER_ACTIVE = 2;
+
+        // A slot claimed for longer than this belongs to a registrant that will never activate it
+        static constexpr uint64_t CLAIM_TIMEOUT_NS = 5'000'000'000ULL;
+
+        // Bytes at the start of the next payload a reader pulls into its cache ahead of time
+        static constexpr size_t PREFETCH_BYTES = 16 * 1024;
+
         // Common members
         SharedMemoryType type;
         std::string name;
@@ -30,9 +143,77 @@ namespace medical::imaging {
         ControlBlock *controlBlock; // Pointer to control block in shared memory
         size_t controlBlockSize; // Size of the control block
         size_t metadataAreaSize; // Size of the metadata area
-        size_t dataOffset; // Offset to the start of the data region
-        size_t maxFrames; // Maximum number of frames in the ring buffer
-        size_t frameSlotSize; // Size allocated for each frame slot
+        size_t dataOffset; // Offset to the start of the data region (the header table)
+        size_t maxFrames; // Maximum number of frames in the ring buffer (entries in the header table)
+        size_t headerStride; // Bytes per header table entry (frame header plus metadata record)
+        size_t readerTableBytes; // Size of the reader registration table
+        size_t slotMetadataSize; // Size of the binary metadata record after each frame header
+        size_t timeIndexOffset; // Offset to the timestamp index, 0 if the region has none
+        size_t arenaOffset; // Offset to the payload arena
+        size_t arenaSize; // Size of the payload arena
+        size_t maxFrameSize; // Largest payload a single frame may have
+        size_t captureLeaseCount; // Capture buffers that can be leased at once
+        size_t payloadAlignment; // Alignment of every payload in the arena
+        size_t requestedPayloadAlignment; // Payload alignment asked for in the configuration, 0 for the page size
+        size_t rowAlignment; // Multiple the row pitch of copied payloads is rounded up to, 0 for tight rows
+
+        // Reader registration
+        ReaderSlot *readerSlots; // Reader table in shared memory
+        size_t readerSlotCount; // Number of slots in the reader table
+        int ownReaderSlot; // Slot registered by this instance, -1 if none
+        uint64_t localCursor; // Cursor used when not registered (server side)
+
+        // Payload arena bookkeeping (server side). Positions are byte counts since the region was
+        // created; a position lives at arenaOffset + position % arenaSize. Payloads never wrap,
+        // a payload that would is placed at the start of the arena instead.
+        struct PayloadExtent {
+            uint64_t sequence; // Frame owning the payload
+            uint64_t start; // Arena position of the payload
+            uint64_t origin; // Sequence the payload was written for; earlier than sequence for duplicates
+            uint64_t frameId; // Frame ID the payload was written for
+        };
+
+        struct CaptureLease {
+            bool inUse; // Handed out to a producer
+            bool bound; // Holds arena space the producer can write into
+            size_t size; // Bytes the producer asked for
+            uint64_t start; // Arena position of the bound space
+        };
+
+        std::mutex captureMutex; // Guards the arena bookkeeping and the leases
+        uint64_t arenaHead; // Position of the next reservation
+        std::deque<PayloadExtent> livePayloads; // Published payloads still in the arena, oldest first
+        std::vector<CaptureLease> captureLeases;
+
+        // Payloads of frames handed out by pinFrames() (server side). New payloads are placed around
+        // them; the table is shared with the frames' release callbacks, which may run after the Impl
+        // is gone. Lock order: captureMutex, then the table's mutex.
+        struct PinnedPayload {
+            uint64_t length; // Arena bytes of the payload
+            uint32_t frames; // Pinned frames viewing it; duplicates share the payload of their original
+        };
+
+        struct PinTable {
+            std::mutex mutex;
+            std::map<uint64_t, PinnedPayload> payloads; // By arena offset; pinned payloads never overlap
+            uint64_t frames = 0; // Pinned frames
+            uint64_t bytes = 0; // Arena bytes of the pinned payloads
+            std::atomic<uint32_t> *spaceDoorbell = nullptr; // Rung when a payload is released, null once unmapped
+            std::atomic<uint32_t> *spaceWaiters = nullptr;
+        };
+
+        std::shared_ptr<PinTable> pins = std::make_shared<PinTable>();
+        std::atomic<uint64_t> pinDetours{0}; // Payloads placed past pinned space
+
+        std::atomic<bool> waitsInterrupted{false}; // Set by interruptWaits() until resumeWaits()
+
+        // Adaptive arena (server side). The writer places payloads below arenaLimit only; the arena
+        // past it stays mapped, so the layout readers see never changes, but holds no pages once
+        // released. Lock order: resizeMutex, then captureMutex.
+        std::atomic<size_t> arenaLimit{0}; // Bytes at the start of the arena the writer uses
+        size_t arenaCommitted = 0; // Bytes at the start of the arena that may hold pages, guarded by resizeMutex
+        size_t lockedBytes = 0; // Bytes at the start of the mapping lockMemory() locked, guarded by resizeMutex
+        std::mutex resizeMutex; // Serializes resizeArena(), prefault() and lockMemory()
 
         // POSIX shared memory specific
         int fd;
@@ -43,6 +224,69 @@ namespace medical::imaging {
         // Memory-mapped file specific
         std::string filePath;
 
+        // Page backing requested before mapping and reported afterwards
+        bool wantHugePages; // Try huge pages for the region
+        size_t requestedHugePageSize; // Huge page size to ask for, 0 for the default
+        bool prefault; // Populate the whole mapping during initialization
+        size_t pageSize; // Size of the pages backing the mapping
+        std::string pageBacking; // "hugetlbfs", "transparent" or "regular"
+
+        // NUMA placement requested before mapping and reported afterwards
+        int numaNode; // Node the producer places the region on, -1 for first touch
+        int residentNode; // Node backing the start of the region, -1 if unknown
+
+        // Per-consumer latency sampled by the writer after each write (server side). There is one
+        // entry per reader slot, allocated when the writer creates the region so the write path never
+        // allocates; an entry is reset when another process takes the slot and only freed with the
+        // Impl, so statistics readers never race a deletion.
+        struct ReaderLatencyTracker {
+            uint32_t pid = 0; // Process the histograms belong to, 0 before the slot's first reader
+            ReaderMode mode = ReaderMode::LOSSLESS;
+            uint64_t lastAcquireTimeNs = 0; // Acquisition already recorded
+            LatencyHistogram latency;
+            LatencyHistogram holdTime;
+            LatencyHistogram lag;
+        };
+        std::unique_ptr<ReaderLatencyTracker[]> readerLatency;
+
+        // Restart behaviour (server side)
+        bool persistent; // Keep the region on shutdown and adopt a compatible one on startup
+        WritePolicy writePolicy; // Published in the control block flags
+        bool adopted; // The region was taken over from a previous writer
+
+        // Page cache hints
+        bool prefetchNext; // Prefetch the payload of the next expected frame after each read (client side)
+        uint64_t prefetchedSequence; // Sequence number the last prefetch was for
+        bool adviseWillNeed; // Ask the kernel to read the next payload in too: only a disk-backed file loses its pages
+        bool dropConsumedPages; // Advise payloads every reader is done with out of memory (server side)
+        uint64_t advisedSequence; // Frames before this one were advised already
+
+        // Slow consumer isolation (server side)
+        uint64_t demoteLagFrames; // Demote lossless readers this many frames behind, 0 never
+        uint64_t demoteStaleNs; // Demote lossless readers idle this long while the ring is full, 0 never
+        std::atomic<uint64_t> readersDemotedLag{0};
+        std::atomic<uint64_t> readersDemotedStale{0};
+        std::atomic<uint64_t> readersReclaimed{0};
+        std::mutex demotionMutex;
+        std::function<void(const ReaderDemotion &)> demotionCallback;
+
+        // Probe pose side channel (server side)
+        std::string poseRingName; // Empty when frames carry only the pose their metadata brings
+        std::unique_ptr<PoseReader> poseReader;
+        std::chrono::steady_clock::time_point nextPoseAttach;
+        std::atomic<uint64_t> framesWithPose{0};
+
+        // Pollable notification (server side: the eventfd of every subscribed reader; client side: our own)
+        struct ReaderNotification {
+            size_t slot; // Reader slot the descriptor belongs to
+            uint32_t pid; // Process owning the slot when it subscribed
+            int descriptor; // eventfd
+        };
+        std::mutex notificationMutex; // Guards notifications
+        std::vector<ReaderNotification> notifications;
+        std::atomic<size_t> notificationCount{0}; // Lets the write path skip the lock when nobody subscribed
+        int notificationDescriptor; // Client side
+
         // Constructor
         Impl() : type(SharedMemoryType::POSIX_SHM),
                  fd(-1),
@@ -53,7 +297,40 @@ namespace medical::imaging {
                  metadataAreaSize(0),
                  dataOffset(0),
                  maxFrames(0),
-                 frameSlotSize(0) {
+                 headerStride(0),
+                 readerTableBytes(0),
+                 slotMetadataSize(0),
+                 timeIndexOffset(0),
+                 arenaOffset(0),
+                 arenaSize(0),
+                 maxFrameSize(0),
+                 captureLeaseCount(0),
+                 payloadAlignment(PAYLOAD_ALIGNMENT),
+                 requestedPayloadAlignment(0),
+                 rowAlignment(0),
+                 readerSlots(nullptr),
+                 readerSlotCount(0),
+                 ownReaderSlot(-1),
+                 localCursor(0),
+                 arenaHead(0),
+                 wantHugePages(false),
+                 requestedHugePageSize(0),
+                 prefault(false),
+                 pageSize(static_cast<size_t>(sysconf(_SC_PAGESIZE))),
+                 pageBacking("regular"),
+                 numaNode(-1),
+                 residentNode(-1),
+                 persistent(false),
+                 writePolicy(WritePolicy::DROP_NEWEST),
+                 adopted(false),
+                 prefetchNext(false),
+                 prefetchedSequence(UINT64_MAX),
+                 adviseWillNeed(false),
+                 dropConsumedPages(false),
+                 advisedSequence(0),
+                 demoteLagFrames(0),
+                 demoteStaleNs(0),
+                 notificationDescriptor(-1) {
         }
 
         // Destructor
@@ -61,744 +338,2244 @@ namespace medical::imaging {
             cleanup();
         }
 
-        // Cleanup resources
-        void cleanup() {
-            // Unmap memory if mapped
-            if (mapping) {
-                munmap(mapping, size);
-                mapping = nullptr;
+        // Pose at a capture time from the pose ring; attaches lazily since the tracker adapter may start later
+        bool lookupPose(uint64_t captureTimeNs, ProbePose &pose) {
+            if (poseRingName.empty() || captureTimeNs == 0) {
+                return false;
             }
-
-            // Close file descriptor if open (POSIX)
-            if (fd >= 0) {
-                close(fd);
-                fd = -1;
+            if (poseReader && poseReader->interpolate(captureTimeNs, pose)) {
+                return true;
             }
 
-            // Detach from System V if attached
-            if (shmid >= 0) {
-                shmdt(mapping); // Already unmapped, but for clarity
-                shmid = -1;
+            // No ring yet, or it went quiet: a restarted adapter replaces it under the same name
+            auto now = std::chrono::steady_clock::now();
+            if (now < nextPoseAttach) {
+                return false;
+            }
+            nextPoseAttach = now + POSE_ATTACH_INTERVAL;
+            PoseReader::Config poseConfig;
+            poseConfig.name = poseRingName;
+            auto reader = std::make_unique<PoseReader>(poseConfig);
+            if (!reader->initialize()) {
+                return false;
             }
+            poseReader = std::move(reader);
+            return poseReader->interpolate(captureTimeNs, pose);
+        }
 
-            // Unlink if server
-            if (isServer) {
-                switch (type) {
-                    case SharedMemoryType::POSIX_SHM:
-                        shm_unlink(name.c_str());
-                        break;
-                    case SharedMemoryType::SYSV_SHM:
-                        if (shmid >= 0) {
-                            shmctl(shmid, IPC_RMID, nullptr);
-                        }
-                        break;
-                    case SharedMemoryType::MEMORY_MAPPED_FILE:
-                        // File remains on disk - don't unlink by default
-                        break;
-                    case SharedMemoryType::HUGE_PAGES:
-                        shm_unlink(name.c_str());
-                        break;
-                }
+        // Fill the pose into a record whose frame did not bring one
+        void applyPose(uint64_t captureTimeNs, FrameMetadataRecord &record) {
+            ProbePose pose;
+            if (record.probePositionCount != 0 || record.probeOrientationCount != 0 ||
+                !lookupPose(captureTimeNs, pose)) {
+                return;
             }
+            record.probePositionCount = 3;
+            std::memcpy(record.probePosition, pose.position, sizeof(pose.position));
+            record.probePosition[3] = 0.0f;
+            record.probeOrientationCount = 4;
+            std::memcpy(record.probeOrientation, pose.orientation, sizeof(pose.orientation));
+            record.flags |= FRAME_FLAG_POSE;
+            framesWithPose.fetch_add(1, std::memory_order_relaxed);
         }
 
+        // Cleanup resources
+        void cleanup() {
+            // Give back our reader slot before the mapping goes away
+            unregisterReader();
+            closeNotifications();
+            {
+                std::lock_guard<std::mutex> lock(pins->mutex);
+                pins->spaceDoorbell = nullptr;
+                pins->spaceWaiters = nullptr;
+            }
 
+            // Unmap and close, and remove the region if server, unless the next writer is to take it over
+            withBackend(type, [this](auto backend) {
+                using Backend = decltype(backend);
+                if (mapping) {
+                    Backend::unmap(*this);
+                    mapping = nullptr;
+                }
+                Backend::release(*this, isServer && !persistent);
+            });
+        }
 
-        // Initialize POSIX shared memory
-        SharedMemory::Status initializePosixShm(const std::string &shmName, size_t shmSize, bool create, size_t maxFrameSize) {
-            name = "/" + shmName; // POSIX shared memory names must start with '/'
-            size = shmSize;
-            isServer = create;
-            type = SharedMemoryType::POSIX_SHM;
+        // Round a size up to a multiple of a page size
+        static size_t roundUpToPage(size_t value, size_t page) {
+            return (value + page - 1) / page * page;
+        }
 
-            // Calculate control block size and metadata area size
-            controlBlockSize = sizeof(ControlBlock);
-            metadataAreaSize = 4096; // 4KB for metadata area
+        // Default huge page size from /proc/meminfo, 0 if the system has none
+        static size_t defaultHugePageSize() {
+            std::ifstream memInfo("/proc/meminfo");
+            std::string line;
+            while (std::getline(memInfo, line)) {
+                if (line.find("Hugepagesize:") != std::string::npos) {
+                    std::istringstream iss(line);
+                    std::string label;
+                    size_t sizeKb = 0;
+                    iss >> label >> sizeKb;
+                    return sizeKb * 1024;
+                }
+            }
+            return 0;
+        }
 
-            // Calculate data offset
-            dataOffset = controlBlockSize + metadataAreaSize;
+        // Find a hugetlbfs mount whose pages have the given size, empty if there is none
+        static std::string findHugetlbfsMount(size_t hugePageSize) {
+            std::ifstream mounts("/proc/mounts");
+            std::string line;
+            while (std::getline(mounts, line)) {
+                std::istringstream iss(line);
+                std::string device, mountPoint, fsType, options;
+                if (!(iss >> device >> mountPoint >> fsType >> options) || fsType != "hugetlbfs") {
+                    continue;
+                }
 
-            // Size must be large enough for the control block, metadata, and at least one frame
-            if (size <= dataOffset + sizeof(FrameHeader)) {
-                return SharedMemory::Status::INVALID_SIZE;
+                // Mounts without a pagesize option use the default huge page size
+                size_t mountPageSize = defaultHugePageSize();
+                size_t pos = options.find("pagesize=");
+                if (pos != std::string::npos) {
+                    std::string value = options.substr(pos + 9, options.find(',', pos) - pos - 9);
+                    mountPageSize = std::strtoull(value.c_str(), nullptr, 10);
+                    switch (value.empty() ? '\0' : value.back()) {
+                        case 'G': mountPageSize <<= 30; break;
+                        case 'M': mountPageSize <<= 20; break;
+                        case 'K': mountPageSize <<= 10; break;
+                        default: break;
+                    }
+                }
+                if (mountPageSize == hugePageSize) {
+                    return mountPoint;
+                }
             }
+            return "";
+        }
 
-            if (create) {
-                // Create the shared memory as the server
-                fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
-                if (fd < 0) {
-                    std::cerr << "Failed to create shared memory: " << strerror(errno) << std::endl;
-                    return SharedMemory::Status::CREATION_FAILED;
-                }
+        // Page size of a file on hugetlbfs, 0 for any other file system
+        static size_t hugetlbfsPageSize(int fileDescriptor) {
+            struct statfs fs{};
+            if (fstatfs(fileDescriptor, &fs) == 0 && fs.f_type == HUGETLBFS_MAGIC) {
+                return static_cast<size_t>(fs.f_bsize);
+            }
+            return 0;
+        }
 
-                // Set the size
-                if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
-                    std::cerr << "Failed to set shared memory size: " << strerror(errno) << std::endl;
-                    close(fd);
-                    fd = -1;
-                    shm_unlink(name.c_str());
-                    return SharedMemory::Status::CREATION_FAILED;
+        // Whether madvise() can put this region on transparent huge pages
+        bool transparentHugePagesAllowed() const {
+            // SysV segments and memfds live on the kernel's internal shmem mount, governed by shmem_enabled
+            std::string path = type == SharedMemoryType::SYSV_SHM || type == SharedMemoryType::MEMFD ? "" :
+                               type == SharedMemoryType::MEMORY_MAPPED_FILE ? filePath : "/dev/shm" + name;
+            std::string mode;
+            if (path.empty()) {
+                std::ifstream setting("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+                std::string line;
+                std::getline(setting, line);
+                size_t open = line.find('[');
+                size_t close = line.find(']', open);
+                if (open != std::string::npos && close != std::string::npos) {
+                    mode = line.substr(open + 1, close - open - 1);
                 }
             } else {
-                // Open existing shared memory as a client
-                fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
-                if (fd < 0) {
-                    std::cerr << "Failed to open shared memory: " << strerror(errno) << std::endl;
-                    return SharedMemory::Status::CREATION_FAILED;
+                // Files need a tmpfs mounted with huge=; take the longest mount point containing the path
+                std::ifstream mounts("/proc/mounts");
+                std::string line;
+                size_t matched = 0;
+                while (std::getline(mounts, line)) {
+                    std::istringstream iss(line);
+                    std::string device, mountPoint, fsType, options;
+                    if (!(iss >> device >> mountPoint >> fsType >> options) ||
+                        path.compare(0, mountPoint.size(), mountPoint) != 0 || mountPoint.size() < matched) {
+                        continue;
+                    }
+                    matched = mountPoint.size();
+                    mode.clear();
+                    size_t pos = options.find("huge=");
+                    if (fsType == "tmpfs" && pos != std::string::npos) {
+                        mode = options.substr(pos + 5, options.find(',', pos) - pos - 5);
+                    }
                 }
+            }
+            return !mode.empty() && mode != "never" && mode != "deny";
+        }
 
-                // Get the actual size
-                struct stat sb{};
-                if (fstat(fd, &sb) < 0) {
-                    std::cerr << "Failed to stat shared memory: " << strerror(errno) << std::endl;
-                    close(fd);
-                    fd = -1;
-                    return SharedMemory::Status::CREATION_FAILED;
+        // Apply the huge page and prefault policy to a fresh mapping, before anything touches it
+        void prepareMapping() {
+            if (wantHugePages && pageBacking != "hugetlbfs") {
+                if (transparentHugePagesAllowed() && madvise(mapping, size, MADV_HUGEPAGE) == 0) {
+                    pageBacking = "transparent";
+                    std::ifstream pmdSize("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+                    pmdSize >> pageSize;
+                } else if (isServer) {
+                    MIVI_LOG_WARNING("Huge pages unavailable for shared memory '{}', using regular pages", name);
                 }
+            }
 
-                size = static_cast<size_t>(sb.st_size);
+            // The producer owns placement; the policy sticks to the segment for every process
+            if (isServer && numaNode >= 0 && !numa::bindMemory(mapping, size, numaNode)) {
+                MIVI_LOG_ERROR("Failed to bind shared memory '{}' to NUMA node {}: {}",
+                        name, numaNode, strerror(errno));
             }
 
-            // Map the shared memory into our address space
-            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-            if (mapping == MAP_FAILED) {
-                std::cerr << "Failed to map shared memory: " << strerror(errno) << std::endl;
-                mapping = nullptr;
-                close(fd);
-                fd = -1;
-                if (create) {
-                    shm_unlink(name.c_str());
-                }
-                return SharedMemory::Status::NOT_INITIALIZED;
+            // A client learns which part of the arena the writer uses from the control block
+            if (prefault && isServer) {
+                prefaultMapping();
             }
 
-            // Set up the control block
-            controlBlock = static_cast<ControlBlock *>(mapping);
+            if (isServer) {
+                residentNode = numa::nodeOfAddress(mapping);
+            }
+        }
 
-            if (create) {
-                // Initialize the control block as server
-                new(controlBlock) ControlBlock();
-                controlBlock->writeIndex.store(0, std::memory_order_relaxed);
-                controlBlock->readIndex.store(0, std::memory_order_relaxed);
-                controlBlock->frameCount.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesWritten.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesRead.store(0, std::memory_order_relaxed);
-                controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
-                controlBlock->active.store(true, std::memory_order_relaxed);
-                controlBlock->lastWriteTime.store(0, std::memory_order_relaxed);
-                controlBlock->lastReadTime.store(0, std::memory_order_relaxed);
-                controlBlock->metadataOffset = static_cast<uint32_t>(controlBlockSize);
-                controlBlock->metadataSize = static_cast<uint32_t>(metadataAreaSize);
-                controlBlock->flags.store(0, std::memory_order_relaxed);
-
-                frameSlotSize = maxFrameSize + sizeof(FrameHeader);
-
-                // Calculate the maximum number of frames that can fit
-                maxFrames = (size - dataOffset) / frameSlotSize;
-                if (maxFrames < 1) {
-                    maxFrames = 1;
-                }
-
-                // Initialize metadata area with JSON
-                json metadata = {
-                    {"format_version", "1.0"},
-                    {"created_at", std::chrono::system_clock::now().time_since_epoch().count()},
-                    {"type", "medical_imaging_frames"},
-                    {"frame_format", ""},
-                    {"max_frames", maxFrames},
-                    {"buffer_size", size},
-                    {"data_offset", dataOffset},
-                       {"frame_slot_size", frameSlotSize},
-                    {"frame_slot_size", frameSlotSize}
-                };
-
-                // Write metadata to shared memory
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                std::string metadataStr = metadata.dump();
-                std::strncpy(metadataPtr, metadataStr.c_str(), metadataAreaSize - 1);
-                metadataPtr[metadataAreaSize - 1] = '\0';
-            } else {
-                // Client just uses the existing control block
-                // Wait for it to be initialized
-                int attempts = 0;
-                while (!controlBlock->active.load(std::memory_order_acquire) && attempts < 100) {
-                    usleep(10000); // 10ms
-                    attempts++;
-                }
+        // Take every page fault now instead of inside the first pass of writeFrame()
+        void prefaultMapping() {
+            populateRange(0, committedRegionBytes());
+        }
 
-                if (!controlBlock->active.load(std::memory_order_acquire)) {
-                    std::cerr << "Timeout waiting for shared memory to be initialized" << std::endl;
-                    munmap(mapping, size);
-                    mapping = nullptr;
-                    close(fd);
-                    fd = -1;
-                    return SharedMemory::Status::INTERNAL_ERROR;
-                }
+        // Fault in the pages of a byte range of the mapping
+        void populateRange(size_t from, size_t to) {
+            auto basePage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            from &= ~(basePage - 1);
+            if (to <= from) {
+                return;
+            }
+            if (madvise(static_cast<uint8_t *>(mapping) + from, to - from, MADV_POPULATE_WRITE) == 0) {
+                return;
+            }
+
+            // Older kernels: read every page; shared memory pages come back mapped writable
+            const volatile uint8_t *bytes = static_cast<const volatile uint8_t *>(mapping);
+            size_t stride = pageBacking == "hugetlbfs" ? pageSize : basePage;
+            for (size_t offset = from; offset < to; offset += stride) {
+                (void) bytes[offset];
+            }
+        }
+
+        // Bytes at the start of the mapping that may hold pages: all of it until the arena is laid out.
+        // Touching the rest would put back pages the writer released.
+        size_t committedRegionBytes() const {
+            if (arenaSize == 0) {
+                return size;
+            }
+            if (isServer) {
+                return std::min(size, arenaOffset + arenaCommitted);
+            }
+            uint64_t end = controlBlock ? controlBlock->committedEnd.load(std::memory_order_acquire) : 0;
+            return end > 0 ? std::min<size_t>(size, end) : size;
+        }
 
-                // Get the metadata size
-                metadataAreaSize = controlBlock->metadataSize;
+        // Tell clients how much of the region may hold pages (server side)
+        void publishCommitted() {
+            if (isServer && controlBlock) {
+                controlBlock->committedEnd.store(arenaOffset + arenaCommitted, std::memory_order_release);
+            }
+        }
 
-                // Get the data offset
-                dataOffset = controlBlockSize + metadataAreaSize;
+        // Whether the region is a file on a real file system, whose pages the page cache writes back
+        // and reads in again, rather than on tmpfs or hugetlbfs
+        bool isDiskBackedFile() const {
+            struct statfs fs{};
+            return type == SharedMemoryType::MEMORY_MAPPED_FILE && fd >= 0 && fstatfs(fd, &fs) == 0 &&
+                   fs.f_type != TMPFS_MAGIC && fs.f_type != HUGETLBFS_MAGIC;
+        }
 
-                // Read metadata to get frame slot size and max frames
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                try {
-                    json metadata = json::parse(metadataPtr);
-                    frameSlotSize = metadata.value("frame_slot_size", 0);
-                    maxFrames = metadata.value("max_frames", 0);
-                } catch (const std::exception &e) {
-                    std::cerr << "Failed to parse metadata: " << e.what() << std::endl;
-                    // Fallback to estimation
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
+        // Start bringing in the payload the next read will return while the caller works on the
+        // current one (client side). A published frame's header says where its payload is; otherwise
+        // the writer will put it right after the current one, as it places payloads back to back.
+        // Both hints are advisory: a wrong guess costs a few cache lines and nothing else.
+        void prefetchNextPayload(uint64_t sequence, const FrameHeader &current) {
+            if (!prefetchNext || sequence == prefetchedSequence || arenaSize == 0) {
+                return;
+            }
+            prefetchedSequence = sequence;
+
+            size_t offset = static_cast<size_t>(current.payloadOffset) * PAYLOAD_ALIGNMENT;
+            size_t bytes = current.dataSize;
+            const FrameHeader *next = getFrameHeader(sequence);
+            if (next && next->generation.load(std::memory_order_acquire) == stableGeneration(sequence)) {
+                offset = static_cast<size_t>(next->payloadOffset) * PAYLOAD_ALIGNMENT;
+                bytes = next->dataSize;
+            } else {
+                offset = alignArena(offset + bytes);
+                if (offset + bytes > arenaSize) {
+                    offset = 0;
+                }
+            }
+            if (bytes == 0 || offset >= arenaSize) {
+                return;
+            }
+            bytes = std::min(bytes, arenaSize - offset);
+            const uint8_t *payload = static_cast<const uint8_t *>(mapping) + arenaOffset + offset;
+
+            // Pages reclaimed since the writer touched them are read back in the background
+            if (adviseWillNeed) {
+                static const auto basePage = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+                uintptr_t first = reinterpret_cast<uintptr_t>(payload) & ~(basePage - 1);
+                uintptr_t last = (reinterpret_cast<uintptr_t>(payload) + bytes + basePage - 1) & ~(basePage - 1);
+                madvise(reinterpret_cast<void *>(first), last - first, MADV_WILLNEED);
+            }
+
+            // The first rows go into the cache right away
+            size_t warm = std::min(bytes, PREFETCH_BYTES);
+            for (size_t i = 0; i < warm; i += 64) {
+                __builtin_prefetch(payload + i, 0, 3);
+            }
+        }
+
+        // Tell the kernel that payloads every registered reader has moved past are not needed until the
+        // writer laps them, so under memory pressure they go before anything hot and a ring larger than
+        // the working set does not crowd the page cache (server side, disk-backed files only)
+        void adviseConsumedPayloads() {
+            uint64_t consumed = controlBlock->writeIndex.load(std::memory_order_acquire);
+            for (size_t i = 0; i < readerSlotCount; ++i) {
+                const ReaderSlot &slot = readerSlots[i];
+                if (slot.state.load(std::memory_order_acquire) == READER_ACTIVE) {
+                    consumed = std::min(consumed, slot.cursor.load(std::memory_order_acquire));
                 }
+            }
+            if (consumed <= advisedSequence) {
+                return;
+            }
 
-                if (maxFrames < 1 || frameSlotSize == 0) {
-                    std::cerr << "Invalid metadata, using fallback values" << std::endl;
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
+            std::vector<std::pair<size_t, size_t>> ranges;
+            {
+                std::lock_guard<std::mutex> lock(captureMutex);
+                for (const PayloadExtent &extent: livePayloads) {
+                    // Duplicates share an earlier payload, which was advised with its own frame
+                    if (extent.sequence < advisedSequence || extent.sequence >= consumed ||
+                        extent.origin != extent.sequence) {
+                        continue;
+                    }
+                    if (const FrameHeader *header = getFrameHeader(extent.sequence)) {
+                        ranges.emplace_back(extent.start % arenaSize, header->dataSize);
+                    }
                 }
             }
+            advisedSequence = consumed;
+
+            for (const auto &[offset, bytes]: ranges) {
+                size_t length = std::min(alignArena(bytes), arenaSize - offset);
+                static const auto basePage = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+                auto start = reinterpret_cast<uintptr_t>(mapping) + arenaOffset + offset;
+                uintptr_t first = start & ~(basePage - 1);
+                madvise(reinterpret_cast<void *>(first), start + length - first, MADV_COLD);
+                posix_fadvise(fd, static_cast<off_t>(arenaOffset + offset), static_cast<off_t>(length),
+                              POSIX_FADV_DONTNEED);
+            }
+        }
+
+        // Backend policies: how one kind of region is obtained, mapped and given back. Backends differ
+        // only there; the layout and every frame path after initialize() are the same for all of them,
+        // so initializeBackend<Backend>() is the single setup path and the fast paths never look at
+        // the type. A policy provides:
+        //   type       SharedMemoryType it implements
+        //   label      Name of the backend in messages
+        //   acquire()  Create (server) or open (client) the region, setting the descriptor and size
+        //   map()      Map or attach the region, nullptr on failure
+        //   unmap()    Undo map()
+        //   seal()     Last step on the server once the control block is laid out
+        //   release()  Close what acquire() got, removing the region too if asked to
+
+        // Close the region's descriptor if open
+        void closeDescriptor() {
+            if (fd >= 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
 
+        // Take the size of an opened region from its descriptor (client side)
+        SharedMemory::Status statDescriptor(const char *label) {
+            struct stat sb{};
+            if (fstat(fd, &sb) < 0) {
+                MIVI_LOG_ERROR("Failed to stat {}: {}", label, strerror(errno));
+                closeDescriptor();
+                return SharedMemory::Status::CREATION_FAILED;
+            }
+            size = static_cast<size_t>(sb.st_size);
             return SharedMemory::Status::OK;
         }
 
-        // Initialize System V shared memory
-        SharedMemory::Status initializeSysVShm(const std::string &shmName, size_t shmSize, bool create, size_t maxFrameSize) {
-            name = shmName;
-            size = shmSize;
-            isServer = create;
-            type = SharedMemoryType::SYSV_SHM;
+        // Map the whole descriptor shared, nullptr on failure
+        void *mapDescriptor() const {
+            void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            return address == MAP_FAILED ? nullptr : address;
+        }
 
-            // Calculate control block size and metadata area size
-            controlBlockSize = sizeof(ControlBlock);
-            metadataAreaSize = 4096; // 4KB for metadata area
+        // POSIX shared memory (shm_open)
+        struct PosixShmBackend {
+            static constexpr SharedMemoryType type = SharedMemoryType::POSIX_SHM;
+            static constexpr const char *label = "shared memory";
+
+            static SharedMemory::Status acquire(Impl &impl, bool create) {
+                if (!create) {
+                    // Open existing shared memory as a client and take its actual size
+                    impl.fd = shm_open(impl.name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
+                    if (impl.fd < 0) {
+                        MIVI_LOG_ERROR("Failed to open shared memory: {}", strerror(errno));
+                        return SharedMemory::Status::CREATION_FAILED;
+                    }
+                    return impl.statDescriptor(label);
+                }
 
-            // Calculate data offset
-            dataOffset = controlBlockSize + metadataAreaSize;
+                // Create the shared memory as the server
+                impl.fd = shm_open(impl.name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+                if (impl.fd < 0) {
+                    MIVI_LOG_ERROR("Failed to create shared memory: {}", strerror(errno));
+                    return SharedMemory::Status::CREATION_FAILED;
+                }
+                if (ftruncate(impl.fd, static_cast<off_t>(impl.size)) < 0) {
+                    MIVI_LOG_ERROR("Failed to set shared memory size: {}", strerror(errno));
+                    release(impl, true);
+                    return SharedMemory::Status::CREATION_FAILED;
+                }
+                return SharedMemory::Status::OK;
+            }
 
-            // Size must be large enough for the control block and at least one frame
-            if (size <= dataOffset + sizeof(FrameHeader)) {
-                return SharedMemory::Status::INVALID_SIZE;
+            static void *map(Impl &impl) {
+                return impl.mapDescriptor();
             }
 
-            // Generate a key from the name using ftok
-            key_t key = ftok(name.c_str(), 1);
-            if (key == -1) {
-                // If the file doesn't exist, create a temporary one
-                if (errno == ENOENT && create) {
-                    std::ofstream tempFile(name);
-                    tempFile.close();
-                    key = ftok(name.c_str(), 1);
+            static void unmap(Impl &impl) {
+                munmap(impl.mapping, impl.size);
+            }
+
+            static SharedMemory::Status seal(Impl &) {
+                return SharedMemory::Status::OK;
+            }
+
+            static void release(Impl &impl, bool removeRegion) {
+                impl.closeDescriptor();
+                if (removeRegion) {
+                    shm_unlink(impl.name.c_str());
+                }
+            }
+        };
+
+        // System V shared memory (shmget), keyed by ftok() on the name
+        struct SysVShmBackend {
+            static constexpr SharedMemoryType type = SharedMemoryType::SYSV_SHM;
+            static constexpr const char *label = "SysV shared memory";
+
+            static SharedMemory::Status acquire(Impl &impl, bool create) {
+                // Generate a key from the name using ftok
+                key_t key = ftok(impl.name.c_str(), 1);
+                if (key == -1) {
+                    // If the file doesn't exist, create a temporary one
+                    if (errno == ENOENT && create) {
+                        std::ofstream tempFile(impl.name);
+                        tempFile.close();
+                        key = ftok(impl.name.c_str(), 1);
+                    }
                     if (key == -1) {
-                        std::cerr << "Failed to create key for SysV shared memory: " << strerror(errno) << std::endl;
+                        MIVI_LOG_ERROR("Failed to create key for SysV shared memory: {}", strerror(errno));
                         return SharedMemory::Status::CREATION_FAILED;
                     }
-                } else {
-                    std::cerr << "Failed to create key for SysV shared memory: " << strerror(errno) << std::endl;
-                    return SharedMemory::Status::CREATION_FAILED;
                 }
-            }
 
-            if (create) {
+                if (!create) {
+                    // Open existing shared memory segment
+                    impl.shmid = shmget(key, 0, 0666);
+                    if (impl.shmid == -1) {
+                        MIVI_LOG_ERROR("Failed to open SysV shared memory: {}", strerror(errno));
+                        return SharedMemory::Status::CREATION_FAILED;
+                    }
+
+                    // Get the actual size
+                    struct shmid_ds shmInfo;
+                    if (shmctl(impl.shmid, IPC_STAT, &shmInfo) == -1) {
+                        MIVI_LOG_ERROR("Failed to get SysV shared memory info: {}", strerror(errno));
+                        impl.shmid = -1;
+                        return SharedMemory::Status::INTERNAL_ERROR;
+                    }
+                    impl.size = shmInfo.shm_segsz;
+                    return SharedMemory::Status::OK;
+                }
+
+                // Ask for a segment on reserved huge pages first
+                size_t hugePageSize = impl.requestedHugePageSize ? impl.requestedHugePageSize : defaultHugePageSize();
+                if (impl.wantHugePages && hugePageSize > 0) {
+                    int hugeFlags = SHM_HUGETLB | (__builtin_ctzll(hugePageSize) << SHM_HUGE_SHIFT);
+                    size_t hugeSize = roundUpToPage(impl.size, hugePageSize);
+                    impl.shmid = shmget(key, hugeSize, IPC_CREAT | IPC_EXCL | 0666 | hugeFlags);
+                    if (impl.shmid != -1) {
+                        impl.size = hugeSize;
+                        impl.pageSize = hugePageSize;
+                        impl.pageBacking = "hugetlbfs";
+                    } else if (errno != EEXIST) {
+                        MIVI_LOG_WARNING("Huge pages unavailable for SysV shared memory ({}), using regular pages",
+                                strerror(errno));
+                    }
+                }
+
                 // Create the shared memory segment
-                shmid = shmget(key, size, IPC_CREAT | IPC_EXCL | 0666);
-                if (shmid == -1) {
+                if (impl.shmid == -1) {
+                    impl.shmid = shmget(key, impl.size, IPC_CREAT | IPC_EXCL | 0666);
+                }
+                if (impl.shmid == -1) {
                     // If already exists, try to get it
                     if (errno == EEXIST) {
-                        shmid = shmget(key, size, 0666);
+                        impl.shmid = shmget(key, impl.size, 0666);
                     }
 
-                    if (shmid == -1) {
-                        std::cerr << "Failed to create SysV shared memory: " << strerror(errno) << std::endl;
+                    if (impl.shmid == -1) {
+                        MIVI_LOG_ERROR("Failed to create SysV shared memory: {}", strerror(errno));
                         return SharedMemory::Status::CREATION_FAILED;
                     }
                 }
-            } else {
-                // Open existing shared memory segment
-                shmid = shmget(key, 0, 0666);
-                if (shmid == -1) {
-                    std::cerr << "Failed to open SysV shared memory: " << strerror(errno) << std::endl;
+                return SharedMemory::Status::OK;
+            }
+
+            static void *map(Impl &impl) {
+                void *address = shmat(impl.shmid, nullptr, 0);
+                return address == reinterpret_cast<void *>(-1) ? nullptr : address;
+            }
+
+            static void unmap(Impl &impl) {
+                shmdt(impl.mapping);
+            }
+
+            static SharedMemory::Status seal(Impl &) {
+                return SharedMemory::Status::OK;
+            }
+
+            static void release(Impl &impl, bool removeRegion) {
+                // Marked for removal, the segment goes away once every process detached
+                if (impl.shmid >= 0 && removeRegion) {
+                    shmctl(impl.shmid, IPC_RMID, nullptr);
+                }
+                impl.shmid = -1;
+                impl.closeDescriptor();
+            }
+        };
+
+        // Memory-mapped file; on hugetlbfs it is backed by reserved huge pages and sized in whole pages
+        struct MappedFileBackend {
+            static constexpr SharedMemoryType type = SharedMemoryType::MEMORY_MAPPED_FILE;
+            static constexpr const char *label = "memory-mapped file";
+
+            static SharedMemory::Status acquire(Impl &impl, bool create) {
+                impl.filePath = impl.name; // The name is the file path
+
+                impl.fd = ::open(impl.filePath.c_str(), create ? O_RDWR | O_CREAT : O_RDWR, S_IRUSR | S_IWUSR);
+                if (impl.fd < 0) {
+                    MIVI_LOG_ERROR("Failed to open memory-mapped file: {}", strerror(errno));
                     return SharedMemory::Status::CREATION_FAILED;
                 }
 
-                // Get the actual size
-                struct shmid_ds shmInfo;
-                if (shmctl(shmid, IPC_STAT, &shmInfo) == -1) {
-                    std::cerr << "Failed to get SysV shared memory info: " << strerror(errno) << std::endl;
-                    return SharedMemory::Status::INTERNAL_ERROR;
+                size_t hugePageSize = hugetlbfsPageSize(impl.fd);
+                if (hugePageSize > 0) {
+                    impl.pageSize = hugePageSize;
+                    impl.pageBacking = "hugetlbfs";
+                    impl.size = roundUpToPage(impl.size, hugePageSize);
                 }
 
-                size = shmInfo.shm_segsz;
+                if (!create) {
+                    return impl.statDescriptor(label);
+                }
+                if (ftruncate(impl.fd, static_cast<off_t>(impl.size)) < 0) {
+                    MIVI_LOG_ERROR("Failed to set memory-mapped file size: {}", strerror(errno));
+                    impl.closeDescriptor();
+                    return SharedMemory::Status::CREATION_FAILED;
+                }
+                return SharedMemory::Status::OK;
             }
 
-            // Attach to the shared memory segment
-            mapping = shmat(shmid, nullptr, 0);
-            if (mapping == reinterpret_cast<void *>(-1)) {
-                std::cerr << "Failed to attach to SysV shared memory: " << strerror(errno) << std::endl;
-                mapping = nullptr;
-                if (create) {
-                    shmctl(shmid, IPC_RMID, nullptr);
-                }
-                shmid = -1;
-                return SharedMemory::Status::NOT_INITIALIZED;
+            static void *map(Impl &impl) {
+                // On hugetlbfs this fails if not enough huge pages are free
+                return impl.mapDescriptor();
             }
 
-            // Set up the control block
-            controlBlock = static_cast<ControlBlock *>(mapping);
+            static void unmap(Impl &impl) {
+                munmap(impl.mapping, impl.size);
+            }
 
-            if (create) {
-                // Initialize the control block as server
-                new(controlBlock) ControlBlock();
-                controlBlock->writeIndex.store(0, std::memory_order_relaxed);
-                controlBlock->readIndex.store(0, std::memory_order_relaxed);
-                controlBlock->frameCount.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesWritten.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesRead.store(0, std::memory_order_relaxed);
-                controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
-                controlBlock->active.store(true, std::memory_order_relaxed);
-                controlBlock->lastWriteTime.store(0, std::memory_order_relaxed);
-                controlBlock->lastReadTime.store(0, std::memory_order_relaxed);
-                controlBlock->metadataOffset = static_cast<uint32_t>(controlBlockSize);
-                controlBlock->metadataSize = static_cast<uint32_t>(metadataAreaSize);
-                controlBlock->flags.store(0, std::memory_order_relaxed);
-
-                frameSlotSize = maxFrameSize + sizeof(FrameHeader);
-
-                // Calculate the maximum number of frames that can fit
-                maxFrames = (size - dataOffset) / frameSlotSize;
-                if (maxFrames < 1) {
-                    maxFrames = 1;
-                }
-
-                // Initialize metadata area with JSON
-                json metadata = {
-                    {"format_version", "1.0"},
-                    {"created_at", std::chrono::system_clock::now().time_since_epoch().count()},
-                    {"type", "medical_imaging_frames"},
-                    {"frame_format", ""},
-                    {"max_frames", maxFrames},
-                    {"buffer_size", size},
-                    {"data_offset", dataOffset},
-                    {"frame_slot_size", frameSlotSize}
-                };
-
-                // Write metadata to shared memory
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                std::string metadataStr = metadata.dump();
-                std::strncpy(metadataPtr, metadataStr.c_str(), metadataAreaSize - 1);
-                metadataPtr[metadataAreaSize - 1] = '\0';
-            } else {
-                // Client just uses the existing control block
-                // Wait for it to be initialized
-                int attempts = 0;
-                while (!controlBlock->active.load(std::memory_order_acquire) && attempts < 100) {
-                    usleep(10000); // 10ms
-                    attempts++;
+            static SharedMemory::Status seal(Impl &) {
+                return SharedMemory::Status::OK;
+            }
+
+            static void release(Impl &impl, bool) {
+                // The file remains on disk - don't unlink by default
+                impl.closeDescriptor();
+            }
+        };
+
+        // File on a hugetlbfs mount; unlike a plain mapped file it does not outlive the producer
+        struct HugePageFileBackend : MappedFileBackend {
+            static constexpr SharedMemoryType type = SharedMemoryType::HUGE_PAGES;
+            static constexpr const char *label = "huge page file";
+
+            static void release(Impl &impl, bool removeRegion) {
+                impl.closeDescriptor();
+                if (removeRegion) {
+                    // Huge page files pin reserved memory
+                    unlink(impl.filePath.c_str());
                 }
+            }
+        };
 
-                if (!controlBlock->active.load(std::memory_order_acquire)) {
-                    std::cerr << "Timeout waiting for SysV shared memory to be initialized" << std::endl;
-                    shmdt(mapping);
-                    mapping = nullptr;
-                    shmid = -1;
-                    return SharedMemory::Status::INTERNAL_ERROR;
+        // Anonymous memfd, sealed at its size once laid out; it has no name and is attached by descriptor
+        struct MemfdBackend {
+            static constexpr SharedMemoryType type = SharedMemoryType::MEMFD;
+            static constexpr const char *label = "memfd shared memory";
+
+            static SharedMemory::Status acquire(Impl &impl, bool create) {
+                if (!create) {
+                    return SharedMemory::Status::NOT_SUPPORTED;
                 }
 
-                // Get the metadata size
-                metadataAreaSize = controlBlock->metadataSize;
+                // Ask for reserved huge pages first; the kernel hands them to anonymous memory without a mount
+                size_t hugePageSize = impl.requestedHugePageSize ? impl.requestedHugePageSize : defaultHugePageSize();
+                if (impl.wantHugePages && hugePageSize > 0) {
+                    size_t hugeSize = roundUpToPage(impl.size, hugePageSize);
+                    impl.fd = memfd_create(impl.name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING | MFD_HUGETLB |
+                                                              (__builtin_ctzll(hugePageSize) << MFD_HUGE_SHIFT));
+                    if (impl.fd >= 0 && ftruncate(impl.fd, static_cast<off_t>(hugeSize)) == 0) {
+                        impl.size = hugeSize;
+                        impl.pageSize = hugePageSize;
+                        impl.pageBacking = "hugetlbfs";
+                        return SharedMemory::Status::OK;
+                    }
+                    MIVI_LOG_WARNING("Huge pages unavailable for memfd shared memory ({}), using regular pages",
+                            strerror(errno));
+                    impl.closeDescriptor();
+                }
+                return createRegular(impl);
+            }
 
-                // Get the data offset
-                dataOffset = controlBlockSize + metadataAreaSize;
+            static SharedMemory::Status createRegular(Impl &impl) {
+                impl.fd = memfd_create(impl.name.c_str(), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+                if (impl.fd < 0 || ftruncate(impl.fd, static_cast<off_t>(impl.size)) < 0) {
+                    MIVI_LOG_ERROR("Failed to create memfd shared memory: {}", strerror(errno));
+                    impl.closeDescriptor();
+                    return SharedMemory::Status::CREATION_FAILED;
+                }
+                return SharedMemory::Status::OK;
+            }
 
-                // Read metadata to get frame slot size and max frames
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                try {
-                    json metadata = json::parse(metadataPtr);
-                    frameSlotSize = metadata.value("frame_slot_size", 0);
-                    maxFrames = metadata.value("max_frames", 0);
-                } catch (const std::exception &e) {
-                    std::cerr << "Failed to parse metadata: " << e.what() << std::endl;
-                    // Fallback to estimation
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
+            static void *map(Impl &impl) {
+                void *address = impl.mapDescriptor();
+
+                // Huge pages are reserved at mmap(), so only now does a huge page memfd learn whether enough are free
+                if (!address && impl.pageBacking == "hugetlbfs") {
+                    MIVI_LOG_WARNING("Huge pages unavailable for memfd shared memory ({}), using regular pages",
+                            strerror(errno));
+                    impl.closeDescriptor();
+                    impl.pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                    impl.pageBacking = "regular";
+                    if (createRegular(impl) == SharedMemory::Status::OK) {
+                        address = impl.mapDescriptor();
+                    }
                 }
+                return address;
+            }
+
+            static void unmap(Impl &impl) {
+                munmap(impl.mapping, impl.size);
+            }
 
-                if (maxFrames < 1 || frameSlotSize == 0) {
-                    std::cerr << "Invalid metadata, using fallback values" << std::endl;
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
+            static SharedMemory::Status seal(Impl &impl) {
+                // Fix the size for good, so no consumer's mapping can ever run past the end of the memory
+                if (fcntl(impl.fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+                    MIVI_LOG_ERROR("Failed to seal memfd shared memory: {}", strerror(errno));
+                    return SharedMemory::Status::CREATION_FAILED;
                 }
+                return SharedMemory::Status::OK;
             }
 
-            return SharedMemory::Status::OK;
+            static void release(Impl &impl, bool) {
+                // Nothing to remove, the memory goes with the last descriptor and mapping
+                impl.closeDescriptor();
+            }
+        };
+
+        // Run fn with the policy of a backend, for the few places that only know the type at runtime
+        template<typename Fn>
+        static void withBackend(SharedMemoryType backendType, Fn &&fn) {
+            switch (backendType) {
+                case SharedMemoryType::POSIX_SHM:
+                    fn(PosixShmBackend());
+                    break;
+                case SharedMemoryType::SYSV_SHM:
+                    fn(SysVShmBackend());
+                    break;
+                case SharedMemoryType::MEMORY_MAPPED_FILE:
+                    fn(MappedFileBackend());
+                    break;
+                case SharedMemoryType::HUGE_PAGES:
+                    fn(HugePageFileBackend());
+                    break;
+                case SharedMemoryType::MEMFD:
+                    fn(MemfdBackend());
+                    break;
+            }
         }
 
-        // Initialize memory-mapped file
-        SharedMemory::Status initializeMemoryMappedFile(const std::string &filePath, size_t shmSize, bool create, size_t maxFrameSize) {
-            this->filePath = filePath;
-            name = filePath; // Use file path as name
+        // Create (server) or open (client) a region with one backend and lay it out or learn its layout
+        template<typename Backend>
+        SharedMemory::Status initializeBackend(const std::string &regionName, size_t shmSize, bool create,
+                                               size_t maxFrameSize) {
+            name = regionName;
             size = shmSize;
             isServer = create;
-            type = SharedMemoryType::MEMORY_MAPPED_FILE;
+            type = Backend::type;
 
-            // Calculate control block size and metadata area size
+            // Calculate control block, reader table and metadata area sizes
             controlBlockSize = sizeof(ControlBlock);
+            readerTableBytes = MAX_READERS * sizeof(ReaderSlot);
             metadataAreaSize = 4096; // 4KB for metadata area
 
             // Calculate data offset
-            dataOffset = controlBlockSize + metadataAreaSize;
+            dataOffset = controlBlockSize + readerTableBytes + metadataAreaSize;
 
-            // Size must be large enough for the control block and at least one frame
+            // Size must be large enough for the control block, metadata, and at least one frame
             if (size <= dataOffset + sizeof(FrameHeader)) {
                 return SharedMemory::Status::INVALID_SIZE;
             }
 
-            // Open or create the file
-            int flags = O_RDWR;
-            if (create) {
-                flags |= O_CREAT;
+            SharedMemory::Status status = Backend::acquire(*this, create);
+            if (status != SharedMemory::Status::OK) {
+                return status;
             }
 
-            fd = open(filePath.c_str(), flags, S_IRUSR | S_IWUSR);
-            if (fd < 0) {
-                std::cerr << "Failed to open memory-mapped file: " << strerror(errno) << std::endl;
-                return SharedMemory::Status::CREATION_FAILED;
+            // Map the region into our address space
+            mapping = Backend::map(*this);
+            if (!mapping) {
+                MIVI_LOG_ERROR("Failed to map {}: {}", Backend::label, strerror(errno));
+                Backend::release(*this, create);
+                return SharedMemory::Status::NOT_INITIALIZED;
             }
+            prepareMapping();
+
+            // Set up the control block
+            controlBlock = static_cast<ControlBlock *>(mapping);
 
             if (create) {
-                // Set the file size
-                if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
-                    std::cerr << "Failed to set memory-mapped file size: " << strerror(errno) << std::endl;
-                    close(fd);
-                    fd = -1;
-                    return SharedMemory::Status::CREATION_FAILED;
+                if (!readerLatency) {
+                    readerLatency = std::make_unique<ReaderLatencyTracker[]>(MAX_READERS);
                 }
-            } else {
-                // Get the actual file size
-                struct stat sb{};
-                if (fstat(fd, &sb) < 0) {
-                    std::cerr << "Failed to stat memory-mapped file: " << strerror(errno) << std::endl;
+
+                // Take over the region of a previous writer, or lay it out afresh
+                setupControlBlock(maxFrameSize);
+                status = Backend::seal(*this);
+                if (status != SharedMemory::Status::OK) {
+                    Backend::unmap(*this);
+                    mapping = nullptr;
+                    controlBlock = nullptr;
+                    Backend::release(*this, true);
+                }
+                return status;
+            }
+
+            // Client just uses the existing control block once the server marked it active
+            status = waitForControlBlock(Backend::label);
+            if (status != SharedMemory::Status::OK) {
+                Backend::unmap(*this);
+                mapping = nullptr;
+                Backend::release(*this, false);
+                return status;
+            }
+
+            loadLayoutFromControlBlock();
+            if (prefault) {
+                prefaultMapping();
+            }
+            return SharedMemory::Status::OK;
+        }
+
+        // Map a region received as a descriptor, such as one passed over the control socket (client side)
+        SharedMemory::Status initializeFromDescriptor(int descriptor, const Layout &layout, const std::string &ringName) {
+            name = ringName;
+            isServer = false;
+            type = static_cast<SharedMemoryType>(layout.type);
+            if (type == SharedMemoryType::SYSV_SHM) {
+                return SharedMemory::Status::NOT_SUPPORTED;
+            }
+
+            controlBlockSize = sizeof(ControlBlock);
+            readerTableBytes = MAX_READERS * sizeof(ReaderSlot);
+            metadataAreaSize = 4096;
+            dataOffset = controlBlockSize + readerTableBytes + metadataAreaSize;
+
+            // Our own copy, so the caller may close theirs and cleanup() closes this one
+            fd = fcntl(descriptor, F_DUPFD_CLOEXEC, 0);
+            struct stat sb{};
+            if (fd < 0 || fstat(fd, &sb) < 0) {
+                MIVI_LOG_ERROR("Failed to use shared memory descriptor: {}", strerror(errno));
+                if (fd >= 0) {
                     close(fd);
                     fd = -1;
-                    return SharedMemory::Status::CREATION_FAILED;
                 }
+                return SharedMemory::Status::CREATION_FAILED;
+            }
+            size = static_cast<size_t>(sb.st_size);
+            if (size <= dataOffset + sizeof(FrameHeader)) {
+                close(fd);
+                fd = -1;
+                return SharedMemory::Status::INVALID_SIZE;
+            }
 
-                size = static_cast<size_t>(sb.st_size);
+            // A memfd is only safe to map at its current size once the producer sealed that size
+            int requiredSeals = F_SEAL_SHRINK | F_SEAL_GROW;
+            if (type == SharedMemoryType::MEMFD && (fcntl(fd, F_GET_SEALS) & requiredSeals) != requiredSeals) {
+                MIVI_LOG_WARNING("Shared memory descriptor for '{}' is not sealed", name);
+                close(fd);
+                fd = -1;
+                return SharedMemory::Status::INVALID_SIZE;
             }
 
-            // Map the file into memory
             mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
             if (mapping == MAP_FAILED) {
-                std::cerr << "Failed to map file: " << strerror(errno) << std::endl;
+                MIVI_LOG_ERROR("Failed to map shared memory descriptor: {}", strerror(errno));
                 mapping = nullptr;
                 close(fd);
                 fd = -1;
                 return SharedMemory::Status::NOT_INITIALIZED;
             }
+            prepareMapping();
 
-            // Set up the control block
             controlBlock = static_cast<ControlBlock *>(mapping);
+            SharedMemory::Status status = waitForControlBlock("shared memory");
+            if (status != SharedMemory::Status::OK) {
+                munmap(mapping, size);
+                mapping = nullptr;
+                close(fd);
+                fd = -1;
+                return status;
+            }
+
+            // A layout for a region of another size is stale; the metadata is still authoritative
+            loadLayoutFromControlBlock(layout.headerStride != 0 && layout.regionSize == size ? &layout : nullptr);
+            if (prefault) {
+                prefaultMapping();
+            }
+            return SharedMemory::Status::OK;
+        }
+
+        // Initialize huge pages shared memory: a file on hugetlbfs, else POSIX shared memory on THP
+        SharedMemory::Status initializeHugePages(const std::string &shmName, size_t shmSize, bool create, size_t maxFrameSize) {
+            size_t hugePageSize = requestedHugePageSize ? requestedHugePageSize : defaultHugePageSize();
+            std::string mountPoint = hugePageSize > 0 ? findHugetlbfsMount(hugePageSize) : "";
+
+            if (!mountPoint.empty()) {
+                std::string path = mountPoint + "/" + shmName;
+
+                // Clients follow whatever the producer ended up with
+                if (create || access(path.c_str(), F_OK) == 0) {
+                    SharedMemory::Status status = initializeBackend<HugePageFileBackend>(path, shmSize, create,
+                                                                                         maxFrameSize);
+                    if (status == SharedMemory::Status::OK) {
+                        return status;
+                    }
+                    if (create) {
+                        unlink(path.c_str());
+                    }
+                    pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                    pageBacking = "regular";
+                }
+            } else if (create) {
+                MIVI_LOG_WARNING("No hugetlbfs mount with {} kB pages", hugePageSize / 1024);
+            }
 
             if (create) {
-                // Initialize the control block as server
-                new(controlBlock) ControlBlock();
-                controlBlock->writeIndex.store(0, std::memory_order_relaxed);
-                controlBlock->readIndex.store(0, std::memory_order_relaxed);
-                controlBlock->frameCount.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesWritten.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesRead.store(0, std::memory_order_relaxed);
-                controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
-                controlBlock->active.store(true, std::memory_order_relaxed);
-                controlBlock->lastWriteTime.store(0, std::memory_order_relaxed);
-                controlBlock->lastReadTime.store(0, std::memory_order_relaxed);
-                controlBlock->metadataOffset = static_cast<uint32_t>(controlBlockSize);
-                controlBlock->metadataSize = static_cast<uint32_t>(metadataAreaSize);
-                controlBlock->flags.store(0, std::memory_order_relaxed);
-
-                // Estimate the frame slot size - assume 1080p YUV (1920x1080x2 bytes + header)
-                frameSlotSize = maxFrameSize + sizeof(FrameHeader);
-
-                // Calculate the maximum number of frames that can fit
-                maxFrames = (size - dataOffset) / frameSlotSize;
-                if (maxFrames < 1) {
-                    maxFrames = 1;
-                }
-
-                // Initialize metadata area with JSON
-                json metadata = {
-                    {"format_version", "1.0"},
-                    {"created_at", std::chrono::system_clock::now().time_since_epoch().count()},
-                    {"type", "medical_imaging_frames"},
-                    {"frame_format", ""},
-                    {"max_frames", maxFrames},
-                    {"buffer_size", size},
-                    {"data_offset", dataOffset},
-                    {"frame_slot_size", frameSlotSize}
-                };
-
-                // Write metadata to shared memory
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                std::string metadataStr = metadata.dump();
-                std::strncpy(metadataPtr, metadataStr.c_str(), metadataAreaSize - 1);
-                metadataPtr[metadataAreaSize - 1] = '\0';
-            } else {
-                // Client just uses the existing control block
-                // Wait for it to be initialized
-                int attempts = 0;
-                while (!controlBlock->active.load(std::memory_order_acquire) && attempts < 100) {
-                    usleep(10000); // 10ms
-                    attempts++;
+                MIVI_LOG_WARNING("Falling back to POSIX shared memory with transparent huge pages");
+            }
+            wantHugePages = true;
+            return initializeBackend<PosixShmBackend>("/" + shmName, shmSize, create, maxFrameSize);
+        }
+
+        // Adopt a compatible region left by a previous writer if persistent, else format it (server side)
+        void setupControlBlock(size_t maxFrameSize) {
+            adopted = persistent && adoptControlBlock(maxFrameSize);
+            if (!adopted) {
+                formatControlBlock(maxFrameSize, json::object());
+            }
+        }
+
+        // Plan the header table and arena for this region (server side)
+        void planLayout(size_t maxFrameSize) {
+            slotMetadataSize = sizeof(FrameMetadataRecord);
+            headerStride = alignPayload(slotHeaderSize());
+            this->maxFrameSize = maxFrameSize;
+            payloadAlignment = choosePayloadAlignment();
+            computeLayout();
+        }
+
+        // Payload alignment of a region laid out with the configured settings. By default payloads
+        // start on a page of their own: huge pages when the region is on hugetlbfs and a frame fills
+        // at least one, base pages otherwise, so consumers can use aligned vector loads, O_DIRECT
+        // and per-payload mappings.
+        size_t choosePayloadAlignment() const {
+            size_t alignment = requestedPayloadAlignment;
+            if (alignment == 0) {
+                auto basePage = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                alignment = pageBacking == "hugetlbfs" && maxFrameSize >= pageSize ? pageSize : basePage;
+            }
+            if (alignment < PAYLOAD_ALIGNMENT || (alignment & (alignment - 1)) != 0) {
+                MIVI_LOG_WARNING("Payload alignment {} is not a power of two of at least {}, using {}",
+                        alignment, PAYLOAD_ALIGNMENT, PAYLOAD_ALIGNMENT);
+                alignment = PAYLOAD_ALIGNMENT;
+            }
+            return alignment;
+        }
+
+        // Hash of everything a reader's view of the region depends on; a writer only adopts an
+        // existing region whose hash matches the layout it would create
+        uint64_t computeLayoutHash() const {
+            const uint64_t fields[] = {
+                LAYOUT_VERSION, sizeof(ControlBlock), sizeof(ReaderSlot), sizeof(FrameHeader),
+                sizeof(FrameMetadataRecord), FRAME_METADATA_VERSION, PAYLOAD_ALIGNMENT, payloadAlignment,
+                rowAlignment, size,
+                controlBlockSize, readerTableBytes, metadataAreaSize, dataOffset, maxFrames, headerStride,
+                timeIndexOffset, arenaOffset, arenaSize, maxFrameSize, captureLeaseCount, MAX_READERS
+            };
+
+            // FNV-1a over the fields
+            uint64_t hash = 14695981039346656037ULL;
+            for (uint64_t field: fields) {
+                for (int byte = 0; byte < 8; ++byte) {
+                    hash ^= (field >> (byte * 8)) & 0xff;
+                    hash *= 1099511628211ULL;
                 }
+            }
+            return hash;
+        }
 
-                if (!controlBlock->active.load(std::memory_order_acquire)) {
-                    std::cerr << "Timeout waiting for memory-mapped file to be initialized" << std::endl;
-                    munmap(mapping, size);
-                    mapping = nullptr;
-                    close(fd);
-                    fd = -1;
-                    return SharedMemory::Status::INTERNAL_ERROR;
+        // Take over a region formatted by a previous writer with the same layout (server side).
+        // Readers keep their mapping and reader slot; every frame of the previous writer is retired,
+        // so they see a jump in sequence numbers and carry on with the new writer's frames.
+        bool adoptControlBlock(size_t maxFrameSize) {
+            if (!controlBlock->active.load(std::memory_order_acquire) ||
+                controlBlock->magic != CONTROL_BLOCK_MAGIC ||
+                controlBlock->version != CONTROL_BLOCK_VERSION ||
+                controlBlock->metadataOffset != controlBlockSize + readerTableBytes ||
+                controlBlock->metadataSize != metadataAreaSize ||
+                controlBlock->readerTableOffset != controlBlockSize ||
+                controlBlock->readerTableSize != MAX_READERS) {
+                return false;
+            }
+
+            planLayout(maxFrameSize);
+            if (controlBlock->layoutHash != computeLayoutHash()) {
+                MIVI_LOG_WARNING("Existing shared memory '{}' has a different layout, recreating it", name);
+                return false;
+            }
+
+            readerSlots = reinterpret_cast<ReaderSlot *>(static_cast<uint8_t *>(mapping) + controlBlockSize);
+            readerSlotCount = MAX_READERS;
+            reclaimDeadReaders();
+
+            // Payloads of the previous writer are unknown to this one: retire all of its frames,
+            // so views taken before the restart fail their generation check. A header outside the
+            // mapping means the control block does not match the region, which is laid out afresh.
+            uint64_t writeIndex = controlBlock->writeIndex.load(std::memory_order_acquire);
+            for (uint64_t sequence = writeIndex > maxFrames ? writeIndex - maxFrames : 0;
+                 sequence < writeIndex; ++sequence) {
+                FrameHeader *header = getFrameHeader(sequence);
+                if (!header) {
+                    MIVI_LOG_WARNING("Existing shared memory '{}' has a corrupt header table, recreating it", name);
+                    return false;
+                }
+                header->generation.store(writingGeneration(sequence), std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            controlBlock->oldestIndex.store(writeIndex, std::memory_order_release);
+
+            // Lossless readers would otherwise hold the new writer back over frames that are gone
+            for (size_t i = 0; i < readerSlotCount; ++i) {
+                ReaderSlot &slot = readerSlots[i];
+                if (slot.state.load(std::memory_order_acquire) != READER_ACTIVE) {
+                    continue;
+                }
+                uint64_t cursor = slot.cursor.load(std::memory_order_acquire);
+                while (cursor < writeIndex &&
+                       !slot.cursor.compare_exchange_weak(cursor, writeIndex, std::memory_order_acq_rel)) {
+                }
+                if (cursor < writeIndex) {
+                    slot.framesSkipped.fetch_add(writeIndex - cursor, std::memory_order_relaxed);
                 }
+                futex::ring(slot.doorbell, slot.doorbellWaiters);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(captureMutex);
+                arenaHead = 0;
+                livePayloads.clear();
+                captureLeases.assign(captureLeaseCount, CaptureLease{false, false, 0, 0});
+            }
+
+            controlBlock->flags.store(writePolicyFlags(), std::memory_order_release);
+            uint32_t epoch = controlBlock->writerEpoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+            writeLayoutMetadata(json{{"writer_epoch", epoch}});
+            publishTail();
+
+            // Readers sleeping on the doorbells re-check against the new writer
+            futex::ring(controlBlock->frameDoorbell, controlBlock->frameWaiters);
+            futex::ring(controlBlock->spaceDoorbell, controlBlock->spaceWaiters);
+            MIVI_LOG_WARNING("Adopted shared memory '{}' at frame {}, writer epoch {}", name, writeIndex, epoch);
+            return true;
+        }
+
+        // Initialize the control block and the JSON layout description (server side)
+        void formatControlBlock(size_t maxFrameSize, const json &extraMetadata) {
+            new(controlBlock) ControlBlock();
+            controlBlock->active.store(0, std::memory_order_relaxed);
+            controlBlock->magic = CONTROL_BLOCK_MAGIC;
+            controlBlock->version = CONTROL_BLOCK_VERSION;
+            controlBlock->writeIndex.store(0, std::memory_order_relaxed);
+            controlBlock->readIndex.store(0, std::memory_order_relaxed);
+            controlBlock->totalFramesWritten.store(0, std::memory_order_relaxed);
+            controlBlock->totalFramesRead.store(0, std::memory_order_relaxed);
+            controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
+            controlBlock->lastWriteTime.store(0, std::memory_order_relaxed);
+            controlBlock->lastReadTime.store(0, std::memory_order_relaxed);
+            controlBlock->metadataOffset = static_cast<uint32_t>(controlBlockSize + readerTableBytes);
+            controlBlock->metadataSize = static_cast<uint32_t>(metadataAreaSize);
+            // A 1.x reader never sees the region become ready; one that reads the metadata anyway finds
+            // format_version 2.0 where it expects it
+            controlBlock->legacyActive = 0;
+            controlBlock->legacyMetadataOffset = controlBlock->metadataOffset;
+            controlBlock->legacyMetadataSize = controlBlock->metadataSize;
+            controlBlock->flags.store(writePolicyFlags(), std::memory_order_relaxed);
+            controlBlock->frameDoorbell.store(0, std::memory_order_relaxed);
+            controlBlock->frameWaiters.store(0, std::memory_order_relaxed);
+            controlBlock->spaceDoorbell.store(0, std::memory_order_relaxed);
+            controlBlock->spaceWaiters.store(0, std::memory_order_relaxed);
+            controlBlock->readerTableOffset = static_cast<uint32_t>(controlBlockSize);
+            controlBlock->readerTableSize = static_cast<uint32_t>(MAX_READERS);
+            controlBlock->oldestIndex.store(0, std::memory_order_relaxed);
+            controlBlock->geometryEpoch.store(0, std::memory_order_relaxed);
+            controlBlock->geometryWidth = 0;
+            controlBlock->geometryHeight = 0;
+            controlBlock->geometryBytesPerPixel = 0;
+            controlBlock->geometryFormat = 0;
+            controlBlock->bufferFullCount.store(0, std::memory_order_relaxed);
+            controlBlock->writeLatencyNsTotal.store(0, std::memory_order_relaxed);
+            controlBlock->maxWriteLatencyNs.store(0, std::memory_order_relaxed);
+            controlBlock->bytesWritten.store(0, std::memory_order_relaxed);
+            controlBlock->peakMemoryUsage.store(0, std::memory_order_relaxed);
+            controlBlock->writerEpoch.store(0, std::memory_order_relaxed);
+
+            // Every reader slot starts out free
+            readerSlots = reinterpret_cast<ReaderSlot *>(static_cast<uint8_t *>(mapping) + controlBlockSize);
+            readerSlotCount = MAX_READERS;
+            for (size_t i = 0; i < readerSlotCount; ++i) {
+                new(&readerSlots[i]) ReaderSlot();
+                readerSlots[i].state.store(READER_FREE, std::memory_order_relaxed);
+            }
+
+            // The header table holds header and binary metadata record of every ring position,
+            // the arena after it holds the payloads at their actual size
+            planLayout(maxFrameSize);
+            resetPayloadBindings();
+            controlBlock->timeIndexOffset = timeIndexOffset;
+            std::memset(static_cast<uint8_t *>(mapping) + timeIndexOffset, 0, maxFrames * sizeof(TimeIndexEntry));
+            controlBlock->layoutHash = computeLayoutHash();
+            writeLayoutMetadata(extraMetadata);
+
+            // Publish the region last so clients never see a half-initialized layout
+            controlBlock->active.store(1, std::memory_order_release);
+        }
+
+        // Write the JSON layout description into the metadata area (server side)
+        void writeLayoutMetadata(const json &extraMetadata) {
+            json metadata = {
+                {"format_version", "2.0"},
+                {"control_block_version", CONTROL_BLOCK_VERSION},
+                {"control_block_size", controlBlockSize},
+                {"created_at", std::chrono::system_clock::now().time_since_epoch().count()},
+                {"type", "medical_imaging_frames"},
+                {"frame_format", ""},
+                {"max_frames", maxFrames},
+                {"buffer_size", size},
+                {"data_offset", dataOffset},
+                {"header_stride", headerStride},
+                {"frame_header_size", sizeof(FrameHeader)},
+                {"frame_metadata_size", slotMetadataSize},
+                {"frame_metadata_version", FRAME_METADATA_VERSION},
+                {"time_index_offset", timeIndexOffset},
+                {"arena_offset", arenaOffset},
+                {"arena_size", arenaSize},
+                {"payload_alignment", payloadAlignment},
+                {"payload_offset_unit", PAYLOAD_ALIGNMENT},
+                {"row_alignment", rowAlignment},
+                {"max_frame_size", this->maxFrameSize},
+                {"capture_buffers", captureLeaseCount},
+                {"reader_table_offset", controlBlockSize},
+                {"max_readers", readerSlotCount},
+                {"page_backing", pageBacking},
+                {"page_size", pageSize},
+                {"numa_node", residentNode},
+                {"writer_epoch", controlBlock->writerEpoch.load(std::memory_order_relaxed)}
+            };
+            if (extraMetadata.is_object()) {
+                metadata.update(extraMetadata);
+            }
+
+            // Write metadata to shared memory
+            char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
+            std::string metadataStr = metadata.dump();
+            std::strncpy(metadataPtr, metadataStr.c_str(), metadataAreaSize - 1);
+            metadataPtr[metadataAreaSize - 1] = '\0';
+        }
 
-                // Get the metadata size
-                metadataAreaSize = controlBlock->metadataSize;
+        // Wait up to one second for the server to mark the control block active, then make sure
+        // it was laid out by this version of the protocol (client side)
+        SharedMemory::Status waitForControlBlock(const char *label) const {
+            int attempts = 0;
+            while (!controlBlock->active.load(std::memory_order_acquire) && attempts < 100) {
+                usleep(10000); // 10ms
+                attempts++;
+            }
 
-                // Get the data offset
-                dataOffset = controlBlockSize + metadataAreaSize;
+            if (!controlBlock->active.load(std::memory_order_acquire)) {
+                MIVI_LOG_WARNING("Timeout waiting for {} to be initialized", label);
+                return SharedMemory::Status::INTERNAL_ERROR;
+            }
+            if (controlBlock->magic != CONTROL_BLOCK_MAGIC || controlBlock->version != CONTROL_BLOCK_VERSION) {
+                MIVI_LOG_WARNING("Shared memory '{}' was created by an incompatible protocol version ({}, expected {})",
+                        name, (controlBlock->magic == CONTROL_BLOCK_MAGIC ? controlBlock->version : 1),
+                        CONTROL_BLOCK_VERSION);
+                return SharedMemory::Status::VERSION_MISMATCH;
+            }
+            return SharedMemory::Status::OK;
+        }
 
-                // Read metadata to get frame slot size and max frames
+        // Derive the ring layout from an existing control block and its JSON metadata, or from a
+        // binary layout received with the region (client side)
+        void loadLayoutFromControlBlock(const Layout *layout = nullptr) {
+            // Get the metadata size
+            metadataAreaSize = controlBlock->metadataSize;
+
+            // The data region starts right after the metadata area
+            dataOffset = controlBlock->metadataOffset + metadataAreaSize;
+
+            // Locate the reader registration table
+            readerSlotCount = controlBlock->readerTableSize;
+            readerSlots = readerSlotCount > 0
+                              ? reinterpret_cast<ReaderSlot *>(static_cast<uint8_t *>(mapping) +
+                                                               controlBlock->readerTableOffset)
+                              : nullptr;
+
+            // Header table and arena layout, from the binary layout or else the metadata
+            if (layout) {
+                maxFrames = layout->maxFrames;
+                slotMetadataSize = layout->slotMetadataSize;
+                headerStride = layout->headerStride;
+                dataOffset = layout->dataOffset;
+                arenaOffset = layout->arenaOffset;
+                arenaSize = layout->arenaSize;
+                maxFrameSize = layout->maxFrameSize;
+                payloadAlignment = layout->payloadAlignment;
+                rowAlignment = layout->rowAlignment;
+                if (pageBacking == "regular" && layout->pageBacking != 0) {
+                    pageBacking = layout->pageBacking == 2 ? "hugetlbfs" : "transparent";
+                    pageSize = layout->pageSize;
+                }
+                residentNode = layout->numaNode;
+            } else {
                 char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
                 try {
                     json metadata = json::parse(metadataPtr);
-                    frameSlotSize = metadata.value("frame_slot_size", 0);
                     maxFrames = metadata.value("max_frames", 0);
+                    slotMetadataSize = metadata.value("frame_metadata_size", 0);
+                    headerStride = metadata.value("header_stride", 0);
+                    dataOffset = metadata.value("data_offset", dataOffset);
+                    arenaOffset = metadata.value("arena_offset", 0);
+                    arenaSize = metadata.value("arena_size", 0);
+                    maxFrameSize = metadata.value("max_frame_size", 0);
+                    payloadAlignment = metadata.value("payload_alignment", PAYLOAD_ALIGNMENT);
+                    rowAlignment = metadata.value("row_alignment", 0);
+
+                    // Segments the producer put on huge pages are huge pages for every process
+                    std::string backing = metadata.value("page_backing", pageBacking);
+                    if (pageBacking == "regular" && backing != "regular") {
+                        pageBacking = backing;
+                        pageSize = metadata.value("page_size", pageSize);
+                    }
+                    residentNode = metadata.value("numa_node", -1);
                 } catch (const std::exception &e) {
-                    std::cerr << "Failed to parse metadata: " << e.what() << std::endl;
-                    // Fallback to estimation
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
+                    MIVI_LOG_ERROR("Failed to parse metadata: {}", e.what());
+                    maxFrames = 0;
                 }
+            }
 
-                if (maxFrames < 1 || frameSlotSize == 0) {
-                    std::cerr << "Invalid metadata, using fallback values" << std::endl;
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
-                }
+            if (maxFrames < 1 || headerStride < slotHeaderSize() || arenaSize == 0 ||
+                arenaOffset < dataOffset + maxFrames * headerStride || arenaOffset + arenaSize > size) {
+                // Fallback to the layout a producer with default settings would have chosen
+                MIVI_LOG_ERROR("Invalid metadata, using fallback values");
+                slotMetadataSize = sizeof(FrameMetadataRecord);
+                headerStride = alignPayload(slotHeaderSize());
+                maxFrames = Config().maxFrames;
+                maxFrameSize = 1920 * 1080 * 2;
+                payloadAlignment = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+                rowAlignment = 0;
+                computeLayout();
             }
 
-            return SharedMemory::Status::OK;
+            // Writers before the timestamp index left the field zero; lookups by time then read the headers
+            timeIndexOffset = controlBlock->timeIndexOffset;
+            if (timeIndexOffset < dataOffset + maxFrames * headerStride ||
+                timeIndexOffset + maxFrames * sizeof(TimeIndexEntry) > arenaOffset) {
+                timeIndexOffset = 0;
+            }
         }
 
-        // Initialize huge pages shared memory
-        SharedMemory::Status initializeHugePages(const std::string &shmName, size_t shmSize, bool create, size_t maxFrameSize) {
-            // Check if huge pages are available on the system
-            std::ifstream hugePageInfo("/proc/meminfo");
-            bool hugePageAvailable = false;
-            std::string line;
-            size_t hugePageSize = 0;
+        // Claim a free reader slot for this process; returns the slot index or -1 when the table is full
+        int registerReader(ReaderMode mode, PixelFormat requestedFormat, const ReaderFilter &filter) {
+            for (int attempt = 0; attempt < 2; ++attempt) {
+                for (size_t i = 0; i < readerSlotCount; ++i) {
+                    ReaderSlot &slot = readerSlots[i];
+                    uint32_t expected = READER_FREE;
+                    if (!slot.state.compare_exchange_strong(expected, READER_CLAIMED,
+                                                            std::memory_order_acq_rel)) {
+                        continue;
+                    }
 
-            while (std::getline(hugePageInfo, line)) {
-                if (line.find("Hugepagesize:") != std::string::npos) {
-                    // Parse the huge page size
-                    std::istringstream iss(line);
-                    std::string dummy;
-                    iss >> dummy >> hugePageSize;
-                    hugePageAvailable = (hugePageSize > 0);
-                    hugePageSize *= 1024; // Convert KB to bytes
+                    // Owner first, so a reaper finding the claim abandoned knows whose it was
+                    slot.pid.store(static_cast<uint32_t>(getpid()), std::memory_order_relaxed);
+                    slot.claimTimeNs.store(getMonotonicTimeNanos(), std::memory_order_release);
+
+                    // New readers start at the live edge of the ring
+                    slot.mode.store(static_cast<uint16_t>(mode), std::memory_order_relaxed);
+                    slot.requestedFormat.store(requestedFormat == PixelFormat::UNKNOWN
+                                                   ? 0
+                                                   : static_cast<uint16_t>(requestedFormat),
+                                               std::memory_order_relaxed);
+                    slot.cursor.store(controlBlock->writeIndex.load(std::memory_order_acquire),
+                                      std::memory_order_relaxed);
+                    slot.framesRead.store(0, std::memory_order_relaxed);
+                    slot.framesSkipped.store(0, std::memory_order_relaxed);
+                    slot.lastReadTime.store(0, std::memory_order_relaxed);
+                    slot.lastSequence.store(0, std::memory_order_relaxed);
+                    slot.acquireTimeNs.store(0, std::memory_order_relaxed);
+                    slot.holdTimeUs.store(0, std::memory_order_relaxed);
+                    slot.heartbeatNs.store(getMonotonicTimeNanos(), std::memory_order_relaxed);
+                    slot.demotion.store(static_cast<uint32_t>(DemotionReason::NONE), std::memory_order_relaxed);
+                    slot.notifyArmed.store(0, std::memory_order_relaxed);
+                    slot.framesFiltered.store(0, std::memory_order_relaxed);
+                    storeFilter(slot, filter);
+
+                    // A reaper that took the claim back as abandoned may have handed it out again
+                    expected = READER_CLAIMED;
+                    if (!slot.state.compare_exchange_strong(expected, READER_ACTIVE, std::memory_order_acq_rel)) {
+                        continue;
+                    }
+
+                    ownReaderSlot = static_cast<int>(i);
+                    return ownReaderSlot;
+                }
+
+                // Table full - slots of crashed consumers may be holding it up
+                if (reclaimDeadReaders() == 0) {
                     break;
                 }
             }
 
-            if (!hugePageAvailable) {
-                std::cerr << "Huge pages not available on this system" << std::endl;
-                return SharedMemory::Status::NOT_SUPPORTED;
+            return -1;
+        }
+
+        // Write a consumer's filter into its slot; the writer applies it from the next frame on
+        static void storeFilter(ReaderSlot &slot, const ReaderFilter &filter) {
+            uint32_t intervalUs = 0;
+            if (filter.maxRateHz > 0.0) {
+                intervalUs = static_cast<uint32_t>(std::clamp(1e6 / filter.maxRateHz, 1.0, 4294967295.0));
             }
+            slot.filterStride.store(filter.stride > 1 ? filter.stride : 0, std::memory_order_relaxed);
+            slot.filterIntervalUs.store(intervalUs, std::memory_order_relaxed);
+            slot.filterRequiredFlags.store(filter.requiredFlags, std::memory_order_relaxed);
+            slot.filterExcludedFlags.store(filter.excludedFlags, std::memory_order_relaxed);
+        }
+
+        static bool hasFilter(const ReaderSlot &slot) {
+            return slot.filterStride.load(std::memory_order_relaxed) > 1 ||
+                   slot.filterIntervalUs.load(std::memory_order_relaxed) != 0 ||
+                   slot.filterRequiredFlags.load(std::memory_order_relaxed) != 0 ||
+                   slot.filterExcludedFlags.load(std::memory_order_relaxed) != 0;
+        }
 
-            // Round up size to a multiple of huge page size
-            size_t roundedSize = ((shmSize + hugePageSize - 1) / hugePageSize) * hugePageSize;
-            if (roundedSize != shmSize) {
-                std::cout << "Rounding shared memory size to " << roundedSize
-                        << " bytes (multiple of huge page size " << hugePageSize << ")" << std::endl;
-                shmSize = roundedSize;
+        // Whether the filter of a slot passes the published frame at index. Writer and reader both
+        // decide with this, so it looks only at the ring: a frame no longer retained passes and
+        // the read finds out it is lost.
+        bool frameWanted(const ReaderSlot &slot, uint64_t index) const {
+            uint32_t stride = slot.filterStride.load(std::memory_order_relaxed);
+            if (stride > 1 && index % stride != 0) {
+                return false;
             }
 
-            // Now use POSIX shared memory with MAP_HUGETLB flag
-            name = "/" + shmName; // POSIX shared memory names must start with '/'
-            size = shmSize;
-            isServer = create;
-            type = SharedMemoryType::HUGE_PAGES;
+            uint32_t required = slot.filterRequiredFlags.load(std::memory_order_relaxed);
+            uint32_t excluded = slot.filterExcludedFlags.load(std::memory_order_relaxed);
+            if (required != 0 || excluded != 0) {
+                const FrameHeader *header = getFrameHeader(index);
+                if (!header || header->generation.load(std::memory_order_acquire) != stableGeneration(index)) {
+                    return true;
+                }
+                uint32_t flags = header->flags;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (header->generation.load(std::memory_order_relaxed) == stableGeneration(index) &&
+                    ((flags & required) != required || (flags & excluded) != 0)) {
+                    return false;
+                }
+            }
 
-            // Calculate control block size and metadata area size
-            controlBlockSize = sizeof(ControlBlock);
-            metadataAreaSize = 4096; // 4KB for metadata area
+            // Rate limit: the first frame of every interval, compared with the previous frame the stride passes
+            uint64_t intervalNs = static_cast<uint64_t>(slot.filterIntervalUs.load(std::memory_order_relaxed)) * 1000;
+            uint64_t step = stride > 1 ? stride : 1;
+            uint64_t timeNs = 0;
+            uint64_t previousNs = 0;
+            if (intervalNs != 0 && index >= step && indexedTime(index, timeNs) &&
+                indexedTime(index - step, previousNs) && timeNs / intervalNs == previousNs / intervalNs) {
+                return false;
+            }
+            return true;
+        }
 
-            // Calculate data offset
-            dataOffset = controlBlockSize + metadataAreaSize;
+        // Writer side, after publishing index: ring the own doorbell of every filtered reader that wants
+        // the frame, and move the cursor of one that is caught up over a frame it does not want
+        void filterReaders(uint64_t index) {
+            for (size_t i = 0; i < readerSlotCount; ++i) {
+                ReaderSlot &slot = readerSlots[i];
+                if (slot.state.load(std::memory_order_acquire) != READER_ACTIVE || !hasFilter(slot)) {
+                    continue;
+                }
+                if (frameWanted(slot, index)) {
+                    futex::ring(slot.doorbell, slot.doorbellWaiters);
+                    continue;
+                }
+                uint64_t expected = index;
+                if (slot.cursor.compare_exchange_strong(expected, index + 1, std::memory_order_acq_rel)) {
+                    slot.framesFiltered.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
 
-            // Size must be large enough for the control block and at least one frame
-            if (size <= dataOffset + sizeof(FrameHeader)) {
-                return SharedMemory::Status::INVALID_SIZE;
+        // Reader side: move this instance's cursor over published frames its filter rejects and return
+        // where it stops. A lapped lossy reader starts at the oldest retained frame, as a read would.
+        uint64_t skipFiltered(uint64_t writeIndex) {
+            ReaderSlot *slot = ownSlot();
+            uint64_t cursor = currentCursor();
+            if (!slot || !hasFilter(*slot)) {
+                return cursor;
             }
 
-            if (create) {
-                // Create the shared memory as the server
-                fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
-                if (fd < 0) {
-                    std::cerr << "Failed to create shared memory: " << strerror(errno) << std::endl;
-                    return SharedMemory::Status::CREATION_FAILED;
+            for (;;) {
+                uint64_t start = cursor;
+                if (canBeLapped()) {
+                    start = std::max(start, oldestReadable(writeIndex));
+                }
+                uint64_t next = start;
+                while (next < writeIndex && !frameWanted(*slot, next)) {
+                    ++next;
+                }
+                if (next == cursor) {
+                    return cursor;
                 }
 
-                // Set the size
-                if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
-                    std::cerr << "Failed to set shared memory size: " << strerror(errno) << std::endl;
-                    close(fd);
-                    fd = -1;
-                    shm_unlink(name.c_str());
-                    return SharedMemory::Status::CREATION_FAILED;
+                // The writer moves a caught-up cursor over rejected frames as well
+                if (slot->cursor.compare_exchange_strong(cursor, next, std::memory_order_acq_rel)) {
+                    slot->framesFiltered.fetch_add(next - start, std::memory_order_relaxed);
+                    if (start > cursor) {
+                        slot->framesSkipped.fetch_add(start - cursor, std::memory_order_relaxed);
+                    }
+                    if (!isLossyReader()) {
+                        publishTail();
+                        futex::ring(controlBlock->spaceDoorbell, controlBlock->spaceWaiters);
+                    }
+                    return next;
                 }
+            }
+        }
+
+        // First frame at or after index the filter of this instance passes, counting the others in filtered
+        uint64_t nextWanted(uint64_t index, uint64_t writeIndex, uint64_t &filtered) const {
+            const ReaderSlot *slot = ownSlot();
+            if (!slot || !hasFilter(*slot)) {
+                return index;
+            }
+            while (index < writeIndex && !frameWanted(*slot, index)) {
+                ++index;
+                ++filtered;
+            }
+            return index;
+        }
+
+        // Release the slot registered by this instance
+        void unregisterReader() {
+            if (ownReaderSlot < 0 || !readerSlots) {
+                return;
+            }
+
+            readerSlots[ownReaderSlot].pid.store(0, std::memory_order_relaxed);
+            readerSlots[ownReaderSlot].claimTimeNs.store(0, std::memory_order_relaxed);
+            readerSlots[ownReaderSlot].state.store(READER_FREE, std::memory_order_release);
+            ownReaderSlot = -1;
+
+            // A writer blocked on this reader can make progress now
+            futex::ring(controlBlock->spaceDoorbell, controlBlock->spaceWaiters);
+        }
+
+        // Free slots whose owning process no longer exists, and claims never activated; returns the number
+        // reclaimed
+        size_t reclaimDeadReaders() {
+            size_t reclaimed = 0;
+            for (size_t i = 0; i < readerSlotCount; ++i) {
+                ReaderSlot &slot = readerSlots[i];
+                uint32_t state = slot.state.load(std::memory_order_acquire);
+                if (state == READER_CLAIMED) {
+                    reclaimed += reclaimAbandonedClaim(i) ? 1 : 0;
+                    continue;
+                }
+                if (state != READER_ACTIVE) {
+                    continue;
+                }
+
+                auto pid = static_cast<pid_t>(slot.pid.load(std::memory_order_relaxed));
+                if (pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH) {
+                    continue;
+                }
+
+                uint64_t cursor = slot.cursor.load(std::memory_order_acquire);
+                uint32_t expected = READER_ACTIVE;
+                slot.claimTimeNs.store(0, std::memory_order_relaxed);
+                if (slot.state.compare_exchange_strong(expected, READER_FREE, std::memory_order_acq_rel)) {
+                    MIVI_LOG_WARNING("Reclaimed reader slot {} of dead process {}", i, pid);
+                    reclaimed++;
+                    readersReclaimed.fetch_add(1, std::memory_order_relaxed);
+                    uint64_t writeIndex = controlBlock->writeIndex.load(std::memory_order_acquire);
+                    reportDemotion(i, pid, DemotionReason::DEAD, writeIndex > cursor ? writeIndex - cursor : 0, 0);
+                }
+            }
+
+            return reclaimed;
+        }
+
+        // Free a slot left CLAIMED by a registrant that died or stalled before activating it. A claim not
+        // yet stamped is stamped here, so a registrant that died right after the compare-and-swap ages
+        // out too. Returns true if the slot was freed.
+        bool reclaimAbandonedClaim(size_t index) {
+            ReaderSlot &slot = readerSlots[index];
+            uint64_t claimTime = slot.claimTimeNs.load(std::memory_order_acquire);
+            uint64_t now = getMonotonicTimeNanos();
+            if (claimTime == 0) {
+                slot.claimTimeNs.compare_exchange_strong(claimTime, now, std::memory_order_acq_rel);
+                return false;
+            }
+
+            auto pid = static_cast<pid_t>(slot.pid.load(std::memory_order_relaxed));
+            bool dead = pid > 0 && kill(pid, 0) != 0 && errno == ESRCH;
+            if (!dead && now - claimTime < CLAIM_TIMEOUT_NS) {
+                return false;
+            }
+
+            uint32_t expected = READER_CLAIMED;
+            slot.pid.store(0, std::memory_order_relaxed);
+            slot.claimTimeNs.store(0, std::memory_order_relaxed);
+            if (!slot.state.compare_exchange_strong(expected, READER_FREE, std::memory_order_acq_rel)) {
+                return false;
+            }
+            MIVI_LOG_WARNING("Reclaimed reader slot {} left claimed by {} process {}", index,
+                    dead ? "dead" : "stalled", pid);
+            readersReclaimed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // Close the notification descriptors of both sides
+        void closeNotifications() {
+            std::lock_guard<std::mutex> lock(notificationMutex);
+            for (const ReaderNotification &notification: notifications) {
+                close(notification.descriptor);
+            }
+            notifications.clear();
+            notificationCount.store(0, std::memory_order_relaxed);
+            if (notificationDescriptor >= 0) {
+                close(notificationDescriptor);
+                notificationDescriptor = -1;
+            }
+        }
+
+        // Signal the eventfd of every subscribed reader that armed it since the last frame (server side).
+        // Follows the doorbell ring, whose seq_cst increment orders the new writeIndex before the
+        // exchange, so a reader that arms and then finds no frame is always signalled.
+        void notifyReaders(uint64_t index) {
+            if (notificationCount.load(std::memory_order_relaxed) == 0) {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(notificationMutex);
+            for (auto it = notifications.begin(); it != notifications.end();) {
+                ReaderSlot &slot = readerSlots[it->slot];
+                if (slot.state.load(std::memory_order_acquire) != READER_ACTIVE ||
+                    slot.pid.load(std::memory_order_relaxed) != it->pid) {
+                    // The consumer went away, or its slot belongs to someone else now
+                    close(it->descriptor);
+                    it = notifications.erase(it);
+                    continue;
+                }
+                // A filtered reader stays armed through the frames it does not want
+                if (slot.notifyArmed.load(std::memory_order_relaxed) != 0 &&
+                    (!hasFilter(slot) || frameWanted(slot, index)) &&
+                    slot.notifyArmed.exchange(0, std::memory_order_seq_cst) != 0) {
+                    uint64_t one = 1;
+                    ssize_t written = write(it->descriptor, &one, sizeof(one));
+                    (void) written; // EAGAIN only means it is signalled already
+                }
+                ++it;
+            }
+            notificationCount.store(notifications.size(), std::memory_order_relaxed);
+        }
+
+        // Hand a demoted or detached reader to the demotion callback
+        void reportDemotion(size_t index, pid_t pid, DemotionReason reason, uint64_t lag, uint64_t idleNs) {
+            std::lock_guard<std::mutex> lock(demotionMutex);
+            if (demotionCallback) {
+                demotionCallback(ReaderDemotion{index, pid, reason, lag, idleNs});
+            }
+        }
+
+        // Let the writer lap a lossless reader from now on; false if the reader changed mode meanwhile
+        bool demoteReader(size_t index, DemotionReason reason, uint64_t lag, uint64_t idleNs) {
+            ReaderSlot &slot = readerSlots[index];
+            auto expected = static_cast<uint16_t>(ReaderMode::LOSSLESS);
+            if (!slot.mode.compare_exchange_strong(expected, static_cast<uint16_t>(ReaderMode::LOSSY),
+                                                   std::memory_order_acq_rel)) {
+                return false;
+            }
+            slot.demotion.store(static_cast<uint32_t>(reason), std::memory_order_release);
+            (reason == DemotionReason::LAG ? readersDemotedLag : readersDemotedStale)
+                .fetch_add(1, std::memory_order_relaxed);
+
+            auto pid = static_cast<pid_t>(slot.pid.load(std::memory_order_relaxed));
+            if (reason == DemotionReason::LAG) {
+                MIVI_LOG_WARNING("Demoted reader slot {} of process {} to lossy: {} frames behind",
+                        index, pid, lag);
             } else {
-                // Open existing shared memory as a client
-                fd = shm_open(name.c_str(), O_RDWR, S_IRUSR | S_IWUSR);
-                if (fd < 0) {
-                    std::cerr << "Failed to open shared memory: " << strerror(errno) << std::endl;
-                    return SharedMemory::Status::CREATION_FAILED;
+                MIVI_LOG_WARNING("Demoted reader slot {} of process {} to lossy: no heartbeat for {} ms "
+                                 "with {} frames unread", index, pid, idleNs / 1000000, lag);
+            }
+            reportDemotion(index, pid, reason, lag, idleNs);
+            return true;
+        }
+
+        // Demote lossless readers that hold unread frames without having shown signs of life for the
+        // stale limit; called only when they keep the ring full. Returns the number demoted.
+        size_t demoteStaleReaders(uint64_t writeIndex) {
+            if (demoteStaleNs == 0 || overwritesReaders()) {
+                return 0;
+            }
+
+            uint64_t now = getMonotonicTimeNanos();
+            size_t demoted = 0;
+            for (size_t i = 0; i < readerSlotCount; ++i) {
+                const ReaderSlot &slot = readerSlots[i];
+                if (slot.state.load(std::memory_order_acquire) != READER_ACTIVE ||
+                    slot.mode.load(std::memory_order_relaxed) != static_cast<uint16_t>(ReaderMode::LOSSLESS)) {
+                    continue;
                 }
 
-                // Get the actual size
-                struct stat sb{};
-                if (fstat(fd, &sb) < 0) {
-                    std::cerr << "Failed to stat shared memory: " << strerror(errno) << std::endl;
-                    close(fd);
-                    fd = -1;
-                    return SharedMemory::Status::CREATION_FAILED;
+                uint64_t cursor = slot.cursor.load(std::memory_order_acquire);
+                // Consumers that report no heartbeat are judged by their last read; ones that report
+                // neither cannot be judged
+                uint64_t seen = std::max(slot.heartbeatNs.load(std::memory_order_relaxed),
+                                         slot.acquireTimeNs.load(std::memory_order_relaxed));
+                if (cursor >= writeIndex || seen == 0 || now < seen || now - seen < demoteStaleNs) {
+                    continue;
                 }
+                if (demoteReader(i, DemotionReason::STALE, writeIndex - cursor, now - seen)) {
+                    demoted++;
+                }
+            }
 
-                size = static_cast<size_t>(sb.st_size);
+            return demoted;
+        }
+
+        // Control block flags describing the write policy (server side)
+        uint32_t writePolicyFlags() const {
+            return writePolicy == WritePolicy::OVERWRITE ? CONTROL_FLAG_OVERWRITE : 0;
+        }
+
+        // Whether the writer overwrites frames lossless readers have not consumed yet
+        bool overwritesReaders() const {
+            return (controlBlock->flags.load(std::memory_order_acquire) & CONTROL_FLAG_OVERWRITE) != 0;
+        }
+
+        // Oldest sequence number still needed by a lossless reader, or writeIndex if there is none
+        // (or if the writer overwrites them anyway)
+        uint64_t computeTail(uint64_t writeIndex, bool *hasLosslessReader = nullptr) const {
+            uint64_t tail = writeIndex;
+            bool found = false;
+            for (size_t i = 0; i < readerSlotCount && !overwritesReaders(); ++i) {
+                const ReaderSlot &slot = readerSlots[i];
+                if (slot.state.load(std::memory_order_acquire) != READER_ACTIVE ||
+                    slot.mode.load(std::memory_order_relaxed) != static_cast<uint16_t>(ReaderMode::LOSSLESS)) {
+                    continue;
+                }
+
+                tail = std::min(tail, slot.cursor.load(std::memory_order_acquire));
+                found = true;
             }
 
-            // Map the shared memory into our address space with huge pages
-            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_HUGETLB, fd, 0);
-            if (mapping == MAP_FAILED) {
-                std::cerr << "Failed to map shared memory with huge pages: " << strerror(errno) << std::endl;
+            if (hasLosslessReader) {
+                *hasLosslessReader = found;
+            }
+            return tail;
+        }
 
-                // Fall back to regular pages
-                std::cerr << "Falling back to regular pages" << std::endl;
-                mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-                if (mapping == MAP_FAILED) {
-                    std::cerr << "Failed to map shared memory: " << strerror(errno) << std::endl;
-                    mapping = nullptr;
-                    close(fd);
-                    fd = -1;
-                    if (create) {
-                        shm_unlink(name.c_str());
+        // Oldest sequence number still queued for a reader at a given write index
+        uint64_t readableTail(uint64_t writeIndex) const {
+            bool hasLosslessReader = false;
+            uint64_t tail = computeTail(writeIndex, &hasLosslessReader);
+            if (!hasLosslessReader) {
+                // Without lossless readers everything still in the ring is readable
+                tail = std::max<uint64_t>(writeIndex > maxFrames ? writeIndex - maxFrames : 0,
+                                          controlBlock->oldestIndex.load(std::memory_order_acquire));
+            }
+            return tail;
+        }
+
+        // Publish the informational readIndex field derived from the reader table. Only lossless
+        // readers and a writer adopting the region call this, so the per-frame write path never
+        // stores to the reader statistics line.
+        void publishTail() {
+            uint64_t tail = readableTail(controlBlock->writeIndex.load(std::memory_order_acquire));
+
+            // readIndex only moves forward, even when several readers publish
+            uint64_t current = controlBlock->readIndex.load(std::memory_order_relaxed);
+            while (current < tail &&
+                   !controlBlock->readIndex.compare_exchange_weak(current, tail, std::memory_order_release,
+                                                                  std::memory_order_relaxed)) {
+            }
+        }
+
+        // Reader slot owned by this instance, nullptr when reading with the local cursor
+        ReaderSlot *ownSlot() const {
+            return ownReaderSlot >= 0 ? &readerSlots[ownReaderSlot] : nullptr;
+        }
+
+        // Describe reader slot index, with its lag measured against writeIndex
+        ReaderInfo describeReader(size_t index, uint64_t writeIndex) const {
+            const ReaderSlot &slot = readerSlots[index];
+            ReaderInfo info{};
+            info.slot = index;
+            info.pid = static_cast<pid_t>(slot.pid.load(std::memory_order_relaxed));
+            info.mode = static_cast<ReaderMode>(slot.mode.load(std::memory_order_relaxed));
+            uint16_t requestedFormat = slot.requestedFormat.load(std::memory_order_relaxed);
+            info.requestedFormat = requestedFormat == 0 ? PixelFormat::UNKNOWN
+                                                        : pixelFormatFromCode(requestedFormat);
+            info.cursor = slot.cursor.load(std::memory_order_acquire);
+            info.lag = writeIndex > info.cursor ? writeIndex - info.cursor : 0;
+            info.framesRead = slot.framesRead.load(std::memory_order_relaxed);
+            info.framesSkipped = slot.framesSkipped.load(std::memory_order_relaxed);
+            info.framesFiltered = slot.framesFiltered.load(std::memory_order_relaxed);
+            info.filter.stride = std::max<uint32_t>(slot.filterStride.load(std::memory_order_relaxed), 1);
+            uint32_t intervalUs = slot.filterIntervalUs.load(std::memory_order_relaxed);
+            info.filter.maxRateHz = intervalUs != 0 ? 1e6 / intervalUs : 0.0;
+            info.filter.requiredFlags = slot.filterRequiredFlags.load(std::memory_order_relaxed);
+            info.filter.excludedFlags = slot.filterExcludedFlags.load(std::memory_order_relaxed);
+            info.lastReadTime = slot.lastReadTime.load(std::memory_order_relaxed);
+            info.lastSequence = slot.lastSequence.load(std::memory_order_relaxed);
+            info.lastAcquireTimeNs = slot.acquireTimeNs.load(std::memory_order_acquire);
+            info.heartbeatNs = slot.heartbeatNs.load(std::memory_order_relaxed);
+            uint32_t demotion = slot.demotion.load(std::memory_order_acquire);
+            info.demotion = demotion <= static_cast<uint32_t>(DemotionReason::DEAD) ? static_cast<DemotionReason>(demotion)
+                                                                                     : DemotionReason::NONE;
+            return info;
+        }
+
+        // Next sequence number this instance will consume
+        uint64_t currentCursor() const {
+            const ReaderSlot *slot = ownSlot();
+            return slot ? slot->cursor.load(std::memory_order_relaxed) : localCursor;
+        }
+
+        // Whether this instance is allowed to be lapped by the writer
+        bool isLossyReader() const {
+            const ReaderSlot *slot = ownSlot();
+            return !slot || slot->mode.load(std::memory_order_relaxed) == static_cast<uint16_t>(ReaderMode::LOSSY);
+        }
+
+        // Whether the writer may lap this instance, either because it is lossy or because the writer overwrites
+        bool canBeLapped() const {
+            return isLossyReader() || overwritesReaders();
+        }
+
+        // Move this instance's cursor forward over consumed frames and let a blocked writer re-check for space
+        void advanceCursor(uint64_t next, uint64_t skipped, uint64_t consumed = 1, uint64_t filtered = 0) {
+            ReaderSlot *slot = ownSlot();
+            if (!slot) {
+                localCursor = next;
+                return;
+            }
+
+            slot->cursor.store(next, std::memory_order_release);
+            slot->framesRead.fetch_add(consumed, std::memory_order_relaxed);
+            if (skipped > 0) {
+                slot->framesSkipped.fetch_add(skipped, std::memory_order_relaxed);
+            }
+            if (filtered > 0) {
+                slot->framesFiltered.fetch_add(filtered, std::memory_order_relaxed);
+            }
+            slot->lastReadTime.store(std::chrono::system_clock::now().time_since_epoch().count(),
+                                     std::memory_order_relaxed);
+            uint64_t now = getMonotonicTimeNanos();
+            slot->heartbeatNs.store(now, std::memory_order_relaxed);
+            if (consumed > 0) {
+                // The acquire time is stored last; the writer keys its latency samples on it
+                slot->lastSequence.store(next - 1, std::memory_order_relaxed);
+                slot->acquireTimeNs.store(now, std::memory_order_release);
+            }
+
+            if (!isLossyReader()) {
+                publishTail();
+                futex::ring(controlBlock->spaceDoorbell, controlBlock->spaceWaiters);
+            }
+        }
+
+        // Writer side: record what every registered reader reported in its slot since the last write
+        void sampleReaderLatency(uint64_t writeIndex) {
+            if (!readerLatency) {
+                return;
+            }
+
+            for (size_t i = 0; i < readerSlotCount && i < MAX_READERS; ++i) {
+                ReaderSlot &slot = readerSlots[i];
+                if (slot.state.load(std::memory_order_acquire) != READER_ACTIVE) {
+                    continue;
+                }
+
+                uint32_t pid = slot.pid.load(std::memory_order_relaxed);
+                ReaderLatencyTracker *tracker = &readerLatency[i];
+                if (tracker->pid != pid) {
+                    // Another consumer took the slot: its numbers start from scratch
+                    tracker->latency.reset();
+                    tracker->holdTime.reset();
+                    tracker->lag.reset();
+                    tracker->pid = pid;
+                    tracker->lastAcquireTimeNs = 0;
+                }
+                tracker->mode = static_cast<ReaderMode>(slot.mode.load(std::memory_order_relaxed));
+
+                uint64_t cursor = slot.cursor.load(std::memory_order_acquire);
+                uint64_t lag = writeIndex > cursor ? writeIndex - cursor : 0;
+                tracker->lag.record(lag);
+
+                // A lossless reader this far behind would soon stall capture; it skips frames from now on
+                if (demoteLagFrames > 0 && lag >= demoteLagFrames && tracker->mode == ReaderMode::LOSSLESS &&
+                    !overwritesReaders()) {
+                    uint64_t seen = std::max(slot.heartbeatNs.load(std::memory_order_relaxed),
+                                             slot.acquireTimeNs.load(std::memory_order_relaxed));
+                    uint64_t now = getMonotonicTimeNanos();
+                    if (demoteReader(i, DemotionReason::LAG, lag, seen > 0 && now > seen ? now - seen : 0)) {
+                        tracker->mode = ReaderMode::LOSSY;
                     }
-                    return SharedMemory::Status::NOT_INITIALIZED;
+                }
+
+                uint32_t holdUs = slot.holdTimeUs.exchange(0, std::memory_order_relaxed);
+                if (holdUs > 0) {
+                    tracker->holdTime.record(static_cast<uint64_t>(holdUs) * 1000);
+                }
+
+                uint64_t acquireTimeNs = slot.acquireTimeNs.load(std::memory_order_acquire);
+                if (acquireTimeNs == 0 || acquireTimeNs == tracker->lastAcquireTimeNs) {
+                    continue;
+                }
+                tracker->lastAcquireTimeNs = acquireTimeNs;
+
+                // The capture time only counts if the header still holds the frame the reader consumed
+                uint64_t sequence = slot.lastSequence.load(std::memory_order_relaxed);
+                const FrameHeader *header = getFrameHeader(sequence);
+                if (!header || header->generation.load(std::memory_order_acquire) != stableGeneration(sequence)) {
+                    continue;
+                }
+                uint64_t captureTimeNs = header->captureTimeNs;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (header->generation.load(std::memory_order_relaxed) == stableGeneration(sequence) &&
+                    captureTimeNs != 0 && acquireTimeNs > captureTimeNs) {
+                    tracker->latency.record(acquireTimeNs - captureTimeNs);
                 }
             }
+        }
 
-            // Set up the control block
-            controlBlock = static_cast<ControlBlock *>(mapping);
+        // Block on a control block doorbell until it rings, the predicate holds or the deadline passes.
+        // The waiter registers itself before re-checking the predicate, so a writer that publishes
+        // between the check and the futex wait either sees the registration or changes the word.
+        // interruptWaits() rings the doorbell after setting its flag, which works the same way.
+        template<typename Predicate>
+        bool waitOnDoorbell(std::atomic<uint32_t> &doorbell, std::atomic<uint32_t> &waiters,
+                            std::chrono::steady_clock::time_point deadline, Predicate ready) {
+            while (!ready()) {
+                auto now = std::chrono::steady_clock::now();
+                if (now >= deadline || waitsInterrupted.load(std::memory_order_seq_cst)) {
+                    return false;
+                }
 
-            if (create) {
-                // Initialize the control block as server
-                new(controlBlock) ControlBlock();
-                controlBlock->writeIndex.store(0, std::memory_order_relaxed);
-                controlBlock->readIndex.store(0, std::memory_order_relaxed);
-                controlBlock->frameCount.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesWritten.store(0, std::memory_order_relaxed);
-                controlBlock->totalFramesRead.store(0, std::memory_order_relaxed);
-                controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
-                controlBlock->active.store(true, std::memory_order_relaxed);
-                controlBlock->lastWriteTime.store(0, std::memory_order_relaxed);
-                controlBlock->lastReadTime.store(0, std::memory_order_relaxed);
-                controlBlock->metadataOffset = static_cast<uint32_t>(controlBlockSize);
-                controlBlock->metadataSize = static_cast<uint32_t>(metadataAreaSize);
-                controlBlock->flags.store(0, std::memory_order_relaxed);
-
-                frameSlotSize = maxFrameSize + sizeof(FrameHeader);
-
-                // Calculate the maximum number of frames that can fit
-                maxFrames = (size - dataOffset) / frameSlotSize;
-                if (maxFrames < 1) {
-                    maxFrames = 1;
-                }
-
-                // Initialize metadata area with JSON
-                json metadata = {
-                    {"format_version", "1.0"},
-                    {"created_at", std::chrono::system_clock::now().time_since_epoch().count()},
-                    {"type", "medical_imaging_frames"},
-                    {"frame_format", ""},
-                    {"max_frames", maxFrames},
-                    {"buffer_size", size},
-                    {"data_offset", dataOffset},
-                    {"frame_slot_size", frameSlotSize},
-                    {"using_huge_pages", true},
-                    {"huge_page_size", hugePageSize}
-                };
-
-                // Write metadata to shared memory
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                std::string metadataStr = metadata.dump();
-                std::strncpy(metadataPtr, metadataStr.c_str(), metadataAreaSize - 1);
-                metadataPtr[metadataAreaSize - 1] = '\0';
-            } else {
-                // Client just uses the existing control block
-                // Wait for it to be initialized
-                int attempts = 0;
-                while (!controlBlock->active.load(std::memory_order_acquire) && attempts < 100) {
-                    usleep(10000); // 10ms
-                    attempts++;
+                uint32_t seen = doorbell.load(std::memory_order_seq_cst);
+                waiters.fetch_add(1, std::memory_order_seq_cst);
+                if (!ready() && !waitsInterrupted.load(std::memory_order_seq_cst)) {
+                    futex::wait(&doorbell, seen, deadline - now);
+                }
+                waiters.fetch_sub(1, std::memory_order_seq_cst);
+            }
+
+            return true;
+        }
+
+        // Wait until the writer has published the frame at the given index
+        bool waitForFrame(uint64_t index, std::chrono::steady_clock::time_point deadline) {
+            return waitOnDoorbell(controlBlock->frameDoorbell, controlBlock->frameWaiters, deadline, [&] {
+                return controlBlock->writeIndex.load(std::memory_order_acquire) > index;
+            });
+        }
+
+        // Whether the frame at the given index is being published in bands and has rows in the ring
+        bool hasPartialRows(uint64_t index) const {
+            if (controlBlock->partialIndex.load(std::memory_order_acquire) != index + 1) {
+                return false;
+            }
+            const FrameHeader *header = getFrameHeader(index);
+            return header && header->rowsReady.load(std::memory_order_acquire) > 0 &&
+                   header->generation.load(std::memory_order_acquire) == writingGeneration(index);
+        }
+
+        // Wait until a frame this instance reads is published at or after readIndex, which moves to it.
+        // A filtered reader sleeps on the doorbell of its own slot, rung only for frames it wants.
+        bool waitForReadable(uint64_t &readIndex, std::chrono::steady_clock::time_point deadline) {
+            ReaderSlot *slot = ownSlot();
+            if (!slot || !hasFilter(*slot)) {
+                return waitForFrame(readIndex, deadline);
+            }
+            return waitOnDoorbell(slot->doorbell, slot->doorbellWaiters, deadline, [&] {
+                uint64_t writeIndex = controlBlock->writeIndex.load(std::memory_order_acquire);
+                readIndex = skipFiltered(writeIndex);
+                return readIndex < writeIndex;
+            });
+        }
+
+        // Count a write refused because the ring was full
+        void recordBufferFull() {
+            controlBlock->bufferFullCount.fetch_add(1, std::memory_order_relaxed);
+            controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Wait until the slowest lossless reader has freed a header and enough arena space for the given write
+        bool waitForSpace(uint64_t writeIndex, size_t bytes, std::chrono::steady_clock::time_point deadline) {
+            return waitOnDoorbell(controlBlock->spaceDoorbell, controlBlock->spaceWaiters, deadline, [&] {
+                return writeIndex - computeTail(writeIndex) < maxFrames && hasPayloadRoom(bytes);
+            });
+        }
+
+        // Bytes of every header table entry in use (frame header plus metadata record)
+        size_t slotHeaderSize() const {
+            return sizeof(FrameHeader) + slotMetadataSize;
+        }
+
+        // Round a size up to the payload offset unit
+        static size_t alignPayload(size_t bytes) {
+            return (bytes + PAYLOAD_ALIGNMENT - 1) & ~(PAYLOAD_ALIGNMENT - 1);
+        }
+
+        // Round a size or position up to the payload alignment of this region
+        size_t alignArena(size_t bytes) const {
+            return (bytes + payloadAlignment - 1) & ~(payloadAlignment - 1);
+        }
+
+        // Row pitch a copied payload is stored with: its row size rounded up to the row alignment.
+        // Planar payloads, and those the padding would push past maxFrameSize, keep tight rows. 0 for
+        // payloads that are not rows of the frame's geometry, such as descriptors or encoded frames.
+        size_t rowPitchFor(const Frame &frame) const {
+            const PixelFormatInfo &info = getPixelFormatInfo(frame.getPixelFormat());
+            size_t rowBytes = info.rowBytes(frame.getWidth());
+            if (rowBytes == 0) {
+                rowBytes = static_cast<size_t>(frame.getWidth()) * frame.getBytesPerPixel();
+            }
+            if (info.planes == 1 && rowBytes * frame.getHeight() != frame.getDataSize()) {
+                return 0;
+            }
+            if (rowAlignment == 0 || info.planes != 1) {
+                return rowBytes;
+            }
+
+            size_t pitch = (rowBytes + rowAlignment - 1) / rowAlignment * rowAlignment;
+            return pitch * frame.getHeight() <= maxFrameSize ? pitch : rowBytes;
+        }
+
+        // Split the data region into the header table and the payload arena. The header table
+        // never takes more than half of the region so the arena keeps room for frames.
+        void computeLayout() {
+            size_t dataBytes = size > dataOffset ? size - dataOffset : 0;
+            maxFrames = std::min(maxFrames, dataBytes / 2 / headerStride);
+            if (maxFrames < 1) {
+                maxFrames = 1;
+            }
+
+            // The timestamp index sits between the header table and the arena, on its own cache lines
+            timeIndexOffset = (dataOffset + maxFrames * headerStride + 63) & ~static_cast<size_t>(63);
+            arenaOffset = alignArena(timeIndexOffset + maxFrames * sizeof(TimeIndexEntry));
+            arenaSize = size > arenaOffset ? (size - arenaOffset) & ~(payloadAlignment - 1) : 0;
+            maxFrameSize = std::min(maxFrameSize, arenaSize);
+            arenaLimit.store(arenaSize, std::memory_order_relaxed);
+            arenaCommitted = arenaSize;
+            publishCommitted();
+        }
+
+        // Get a pointer to the arena bytes at a reservation position
+        void *getArenaData(uint64_t position) const {
+            return static_cast<uint8_t *>(mapping) + arenaOffset + position % arenaSize;
+        }
+
+        // Get a pointer to a payload from its header fields, nullptr if they point outside the arena
+        void *getPayload(uint32_t payloadOffset, size_t bytes) const {
+            size_t offset = static_cast<size_t>(payloadOffset) * PAYLOAD_ALIGNMENT;
+            if (offset > arenaSize || bytes > arenaSize - offset) {
+                return nullptr;
+            }
+
+            return static_cast<uint8_t *>(mapping) + arenaOffset + offset;
+        }
+
+        // Reset the header table, the arena and the leases (server side)
+        void resetPayloadBindings() {
+            for (size_t i = 0; i < maxFrames; ++i) {
+                FrameHeader *header = getFrameHeader(i);
+                if (!header) {
+                    break;
+                }
+                header->generation.store(0, std::memory_order_relaxed);
+                header->payloadOffset = 0;
+            }
+
+            std::lock_guard<std::mutex> lock(captureMutex);
+            arenaHead = 0;
+            livePayloads.clear();
+            captureLeases.assign(captureLeaseCount, CaptureLease{false, false, 0, 0});
+        }
+
+        // Work out where a payload of the given size goes and how many of the oldest live payloads it
+        // overwrites; requires captureMutex. Fails if the space is still needed by a lossless reader or
+        // a bound capture lease.
+        bool planReservation(size_t bytes, uint64_t &position, size_t &retired) const {
+            const uint64_t limit = arenaLimit.load(std::memory_order_relaxed);
+            uint64_t length = alignArena(bytes);
+            if (length == 0 || length > limit) {
+                return false;
+            }
+
+            // A payload that would straddle the end of the arena, or of the part in use, starts over at
+            // its beginning; the rest of the lap is skipped, so "one lap ago" below stays arenaSize bytes
+            position = arenaHead;
+            uint64_t offset = position % arenaSize;
+            if (offset + length > limit) {
+                position += arenaSize - offset;
+            }
+            if (!skipPinned(length, position)) {
+                return false;
+            }
+
+            // Everything placed before this position one lap ago is overwritten
+            uint64_t reuseLimit = position + length > arenaSize ? position + length - arenaSize : 0;
+            for (const CaptureLease &lease: captureLeases) {
+                if (lease.inUse && lease.bound && lease.start < reuseLimit) {
+                    return false;
                 }
+            }
+
+            // Frames are retired oldest first, up to the newest one whose payload is in the way
+            retired = 0;
+            for (size_t i = 0; i < livePayloads.size(); ++i) {
+                if (livePayloads[i].start < reuseLimit) {
+                    retired = i + 1;
+                }
+            }
+
+            if (retired > 0) {
+                uint64_t writeIndex = controlBlock->writeIndex.load(std::memory_order_acquire);
+                if (livePayloads[retired - 1].sequence >= computeTail(writeIndex)) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Move a reservation past the pinned payloads it would overlap, starting over at the beginning of
+        // the arena where it would straddle the end; requires captureMutex. Fails if no gap within one lap
+        // is large enough.
+        bool skipPinned(uint64_t length, uint64_t &position) const {
+            std::lock_guard<std::mutex> lock(pins->mutex);
+            if (pins->payloads.empty()) {
+                return true;
+            }
+
+            const uint64_t used = arenaLimit.load(std::memory_order_relaxed);
+            const uint64_t limit = position + arenaSize;
+            while (position < limit) {
+                uint64_t offset = position % arenaSize;
+                if (offset + length > used) {
+                    position += arenaSize - offset;
+                    continue;
+                }
+
+                // The first pinned payload that ends after the offset
+                auto pinned = pins->payloads.upper_bound(offset);
+                if (pinned != pins->payloads.begin()) {
+                    auto previous = std::prev(pinned);
+                    if (previous->first + previous->second.length > offset) {
+                        pinned = previous;
+                    }
+                }
+                if (pinned == pins->payloads.end() || pinned->first >= offset + length) {
+                    return true;
+                }
+                position += pinned->first + pinned->second.length - offset;
+            }
+            return false;
+        }
+
+        // Reserve arena space for a payload, invalidating the frames it overwrites; requires captureMutex
+        bool reservePayload(size_t bytes, uint64_t &position) {
+            size_t retired = 0;
+            if (!planReservation(bytes, position, retired)) {
+                return false;
+            }
+
+            // Every retired frame needs a header to invalidate; check them all before retiring any
+            for (size_t i = 0; i < retired; ++i) {
+                if (!getFrameHeader(livePayloads[i].sequence)) {
+                    return false;
+                }
+            }
+
+            uint64_t unpinned = arenaHead;
+            if (unpinned % arenaSize + alignArena(bytes) > arenaLimit.load(std::memory_order_relaxed)) {
+                unpinned += arenaSize - unpinned % arenaSize;
+            }
+            if (position != unpinned) {
+                pinDetours.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (retired > 0) {
+                // Readers jump past the retired frames, and stale views fail their generation check
+                controlBlock->oldestIndex.store(livePayloads[retired - 1].sequence + 1, std::memory_order_release);
+                for (size_t i = 0; i < retired; ++i) {
+                    uint64_t sequence = livePayloads[i].sequence;
+                    if (FrameHeader *header = getFrameHeader(sequence)) {
+                        header->generation.store(writingGeneration(sequence), std::memory_order_relaxed);
+                    }
+                }
+                std::atomic_thread_fence(std::memory_order_release);
+                livePayloads.erase(livePayloads.begin(), livePayloads.begin() + static_cast<std::ptrdiff_t>(retired));
+            }
+
+            arenaHead = position + alignArena(bytes);
+            return true;
+        }
+
+        // End of the arena bytes still referenced by a live payload, a bound lease or a pin, as an
+        // offset into the arena; requires captureMutex
+        size_t arenaInUseEnd() const {
+            size_t end = 0;
+            for (const PayloadExtent &extent: livePayloads) {
+                // Without a header the extent's size is unknown, so nothing past it is given back
+                const FrameHeader *header = getFrameHeader(extent.sequence);
+                if (!header) {
+                    return arenaSize;
+                }
+                end = std::max(end, static_cast<size_t>(extent.start % arenaSize) + alignArena(header->dataSize));
+            }
+            for (const CaptureLease &lease: captureLeases) {
+                if (lease.inUse && lease.bound) {
+                    end = std::max(end, static_cast<size_t>(lease.start % arenaSize) + alignArena(lease.size));
+                }
+            }
+            std::lock_guard<std::mutex> lock(pins->mutex);
+            if (!pins->payloads.empty()) {
+                auto last = std::prev(pins->payloads.end());
+                end = std::max(end, static_cast<size_t>(last->first + last->second.length));
+            }
+            return end;
+        }
+
+        // Move the end of the part of the arena the writer uses (server side)
+        Status resizeArena(size_t bytes) {
+            std::lock_guard<std::mutex> resizeLock(resizeMutex);
+            if (arenaSize == 0) {
+                return Status::NOT_INITIALIZED;
+            }
+
+            // Whole pages, and room for at least the largest payload
+            size_t limit = std::max(bytes, alignArena(maxFrameSize));
+            limit = std::min((limit + pageSize - 1) & ~(pageSize - 1), arenaSize);
+
+            // Pages are faulted in and locked before the writer may use them
+            if (limit > arenaCommitted) {
+                size_t from = arenaOffset + arenaCommitted;
+                size_t to = std::min(size, arenaOffset + limit);
+                populateRange(from, to);
+                if (lockedBytes > 0) {
+                    size_t first = from & ~(static_cast<size_t>(sysconf(_SC_PAGESIZE)) - 1);
+                    if (mlock(static_cast<uint8_t *>(mapping) + first, to - first) != 0) {
+                        MIVI_LOG_WARNING("Failed to lock grown arena of shared memory '{}': {}", name, strerror(errno));
+                    } else {
+                        lockedBytes = to;
+                    }
+                }
+                arenaCommitted = limit;
+                publishCommitted();
+            }
+
+            if (limit != arenaLimit.load(std::memory_order_relaxed)) {
+                std::lock_guard<std::mutex> lock(captureMutex);
+                arenaLimit.store(limit, std::memory_order_relaxed);
+            }
+
+            if (arenaCommitted > limit) {
+                releaseArena(limit);
+            }
+            return Status::OK;
+        }
+
+        // Give the pages past the limit back once nothing references them any more; requires
+        // resizeMutex. The writer never places a payload past the limit, so what is not in use now
+        // stays unused. Payloads placed before the limit came down are released on a later call.
+        void releaseArena(size_t limit) {
+            size_t inUse = 0;
+            {
+                std::lock_guard<std::mutex> lock(captureMutex);
+                inUse = arenaInUseEnd();
+            }
+
+            // Whole pages of the backing, so a huge page is either kept or released
+            size_t from = (arenaOffset + std::max(limit, inUse) + pageSize - 1) & ~(pageSize - 1);
+            size_t to = std::min(size, arenaOffset + arenaCommitted);
+            if (from >= to) {
+                return;
+            }
+
+            // Clients stop prefaulting the range before its pages go
+            arenaCommitted = from - arenaOffset;
+            publishCommitted();
+
+            void *start = static_cast<uint8_t *>(mapping) + from;
+            if (lockedBytes > from) {
+                munlock(start, std::min(lockedBytes, to) - from);
+                lockedBytes = from;
+            }
+
+            // Shared pages stay in the file after MADV_DONTNEED; MADV_REMOVE frees them
+            if (madvise(start, to - from, MADV_REMOVE) != 0 && madvise(start, to - from, MADV_DONTNEED) != 0) {
+                MIVI_LOG_WARNING("Failed to release arena pages of shared memory '{}': {}", name, strerror(errno));
+                arenaCommitted = to - arenaOffset;
+                publishCommitted();
+            }
+        }
+
+        // Whether the arena can take a payload of the given size without waiting for a lossless reader
+        bool hasPayloadRoom(size_t bytes) {
+            if (bytes == 0) {
+                return true;
+            }
+
+            std::lock_guard<std::mutex> lock(captureMutex);
+            uint64_t position = 0;
+            size_t retired = 0;
+            return planReservation(bytes, position, retired);
+        }
+
+        // Undo the start of a write whose copy failed, so the retry at the same index starts clean: the
+        // header reads as retired rather than being written, and its extent is dropped again
+        void abandonWrite(uint64_t writeIndex, FrameHeader &header) {
+            std::lock_guard<std::mutex> lock(captureMutex);
+            if (!livePayloads.empty() && livePayloads.back().sequence == writeIndex) {
+                livePayloads.pop_back();
+            }
+            header.generation.store(writeIndex >= maxFrames ? writingGeneration(writeIndex - maxFrames) : 0,
+                                    std::memory_order_release);
+        }
 
-                if (!controlBlock->active.load(std::memory_order_acquire)) {
-                    std::cerr << "Timeout waiting for shared memory to be initialized" << std::endl;
-                    munmap(mapping, size);
-                    mapping = nullptr;
-                    close(fd);
-                    fd = -1;
-                    return SharedMemory::Status::INTERNAL_ERROR;
-                }
+        // Forget the payload of the frame whose header is about to be reused; requires captureMutex
+        void releaseHeaderPayload(uint64_t writeIndex) {
+            while (!livePayloads.empty() && livePayloads.front().sequence + maxFrames <= writeIndex) {
+                livePayloads.pop_front();
+            }
+        }
 
-                // Get the metadata size
-                metadataAreaSize = controlBlock->metadataSize;
+        // Oldest frame a reader can still get at the given write index
+        uint64_t oldestReadable(uint64_t writeIndex) const {
+            uint64_t oldest = writeIndex >= maxFrames ? writeIndex - maxFrames + 1 : 0;
+            return std::max(oldest, controlBlock->oldestIndex.load(std::memory_order_acquire));
+        }
 
-                // Get the data offset
-                dataOffset = controlBlockSize + metadataAreaSize;
+        // Publish the geometry of a frame about to be written (server side); true if it starts a new epoch
+        bool updateGeometry(const FrameHeader &header) {
+            uint32_t epoch = controlBlock->geometryEpoch.load(std::memory_order_relaxed);
+            if (epoch != 0 && controlBlock->geometryWidth == header.width &&
+                controlBlock->geometryHeight == header.height &&
+                controlBlock->geometryBytesPerPixel == header.bytesPerPixel &&
+                controlBlock->geometryFormat == header.formatCode) {
+                return false;
+            }
 
-                // Read metadata to get frame slot size and max frames
-                char *metadataPtr = static_cast<char *>(mapping) + controlBlock->metadataOffset;
-                try {
-                    json metadata = json::parse(metadataPtr);
-                    frameSlotSize = metadata.value("frame_slot_size", 0);
-                    maxFrames = metadata.value("max_frames", 0);
-                } catch (const std::exception &e) {
-                    std::cerr << "Failed to parse metadata: " << e.what() << std::endl;
-                    // Fallback to estimation
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
-                }
+            controlBlock->geometryEpoch.store(epoch + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            controlBlock->geometryWidth = header.width;
+            controlBlock->geometryHeight = header.height;
+            controlBlock->geometryBytesPerPixel = header.bytesPerPixel;
+            controlBlock->geometryFormat = header.formatCode;
+            controlBlock->geometryEpoch.store(epoch + 2, std::memory_order_release);
+            return true;
+        }
 
-                if (maxFrames < 1 || frameSlotSize == 0) {
-                    std::cerr << "Invalid metadata, using fallback values" << std::endl;
-                    frameSlotSize = 1920 * 1080 * 2 + sizeof(FrameHeader);
-                    maxFrames = (size - dataOffset) / frameSlotSize;
+        // Find the bound lease whose arena space starts at the given address; requires captureMutex
+        int findCaptureLease(const void *data) const {
+            for (size_t i = 0; i < captureLeases.size(); ++i) {
+                if (captureLeases[i].inUse && captureLeases[i].bound && getArenaData(captureLeases[i].start) == data) {
+                    return static_cast<int>(i);
                 }
             }
-
-            return SharedMemory::Status::OK;
+            return -1;
         }
 
+        // Calculate the offset of a frame's header table entry in the shared memory
+        size_t calculateFrameOffset(uint64_t index) const {
+            return dataOffset + (index % maxFrames) * headerStride;
+        }
 
+        // Point the timestamp index entry of a ring position at a frame just published (server side)
+        void indexFrame(uint64_t index, const FrameHeader &header) {
+            if (timeIndexOffset == 0) {
+                return;
+            }
+            auto *entry = reinterpret_cast<TimeIndexEntry *>(static_cast<uint8_t *>(mapping) + timeIndexOffset) +
+                          index % maxFrames;
+            entry->sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            entry->timeNs = header.captureTimeNs != 0 ? header.captureTimeNs : header.publishTimeNs;
+            entry->sequence.store(index + 1, std::memory_order_release);
+        }
 
+        // Index time of a retained frame; false if its entry or header moved on to a newer frame
+        bool indexedTime(uint64_t index, uint64_t &timeNs) const {
+            if (timeIndexOffset != 0) {
+                const auto *entry = reinterpret_cast<const TimeIndexEntry *>(
+                                        static_cast<const uint8_t *>(mapping) + timeIndexOffset) + index % maxFrames;
+                if (entry->sequence.load(std::memory_order_acquire) != index + 1) {
+                    return false;
+                }
+                timeNs = entry->timeNs;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return entry->sequence.load(std::memory_order_relaxed) == index + 1;
+            }
 
-        // Calculate frame offset in the shared memory
-        size_t calculateFrameOffset(uint64_t index) const {
-            return dataOffset + (index % maxFrames) * frameSlotSize;
+            const FrameHeader *header = getFrameHeader(index);
+            if (!header || header->generation.load(std::memory_order_acquire) != stableGeneration(index)) {
+                return false;
+            }
+            timeNs = header->captureTimeNs != 0 ? header->captureTimeNs : header->publishTimeNs;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return header->generation.load(std::memory_order_relaxed) == stableGeneration(index);
         }
 
-        // Get a pointer to a frame header
+        // Get a pointer to a frame header, nullptr if the entry would run past the mapping
         FrameHeader *getFrameHeader(uint64_t index) const {
             size_t offset = calculateFrameOffset(index);
             if (offset + sizeof(FrameHeader) > size) {
@@ -808,14 +2585,28 @@ namespace medical::imaging {
             return reinterpret_cast<FrameHeader *>(static_cast<uint8_t *>(mapping) + offset);
         }
 
-        // Get a pointer to frame data
-        void *getFrameData(uint64_t index) const {
+        // Get a pointer to the binary metadata record of a frame, nullptr for regions without records
+        FrameMetadataRecord *getFrameMetadataRecord(uint64_t index) const {
+            if (slotMetadataSize < sizeof(FrameMetadataRecord)) {
+                return nullptr;
+            }
+
             size_t offset = calculateFrameOffset(index) + sizeof(FrameHeader);
-            if (offset >= size) {
+            if (offset + sizeof(FrameMetadataRecord) > size) {
                 return nullptr;
             }
 
-            return static_cast<uint8_t *>(mapping) + offset;
+            return reinterpret_cast<FrameMetadataRecord *>(static_cast<uint8_t *>(mapping) + offset);
+        }
+
+        // Get a pointer to frame data, following the header into the arena
+        void *getFrameData(uint64_t index) const {
+            const FrameHeader *header = getFrameHeader(index);
+            if (!header) {
+                return nullptr;
+            }
+
+            return getPayload(header->payloadOffset, header->dataSize);
         }
 
         // Update metadata in the shared memory
@@ -832,7 +2623,7 @@ namespace medical::imaging {
 
             // Check if it fits
             if (metadataStr.size() >= controlBlock->metadataSize) {
-                std::cerr << "Metadata too large for shared memory area" << std::endl;
+                MIVI_LOG_WARNING("Metadata too large for shared memory area");
                 return false;
             }
 
@@ -856,7 +2647,7 @@ namespace medical::imaging {
             try {
                 return json::parse(metadataArea);
             } catch (const std::exception &e) {
-                std::cerr << "Failed to parse metadata JSON: " << e.what() << std::endl;
+                MIVI_LOG_ERROR("Failed to parse metadata JSON: {}", e.what());
                 return json{};
             }
         }
@@ -870,14 +2661,13 @@ namespace medical::imaging {
           stopCallbackThread_(false),
           threadAffinity_(-1),
           threadPriority_(0) {
-        // Initialize statistics
-        stats_ = {};
     }
 
     SharedMemory::~SharedMemory() {
         // Stop the notification thread if it's running
         if (callbackThread_.joinable()) {
             stopCallbackThread_ = true;
+            interruptWaits();
             callbackThread_.join();
         }
 
@@ -889,38 +2679,27 @@ namespace medical::imaging {
             return Status::NOT_INITIALIZED;
         }
 
-        // Cannot update if there are frames in the buffer
-        if (impl_->controlBlock->frameCount.load(std::memory_order_acquire) > 0) {
-            std::cerr << "Cannot update max frame size while buffer contains frames" << std::endl;
-            return Status::BUFFER_FULL;
-        }
-
-        // Calculate new frame slot size
-        size_t newSlotSize = newMaxFrameSize + sizeof(FrameHeader);
-
         // Only update if it's larger than current
-        if (newSlotSize <= impl_->frameSlotSize) {
+        if (newMaxFrameSize <= impl_->maxFrameSize) {
             return Status::OK; // No change needed
         }
 
-        std::cout << "Updating max frame size from " << (impl_->frameSlotSize - sizeof(FrameHeader))
-                  << " to " << newMaxFrameSize << " bytes" << std::endl;
-
-        // Update the frame slot size
-        impl_->frameSlotSize = newSlotSize;
+        // Payloads take only their own size, so the limit is the arena itself
+        if (newMaxFrameSize > impl_->arenaSize) {
+            MIVI_LOG_WARNING("Max frame size {} exceeds the arena size {}", newMaxFrameSize, impl_->arenaSize);
+            return Status::INVALID_SIZE;
+        }
 
-        // Update metadata
-        auto metadata = impl_->readMetadataJson();
-        metadata["frame_slot_size"] = impl_->frameSlotSize;
+        MIVI_LOG_INFO("Updating max frame size from {} to {} bytes", impl_->maxFrameSize, newMaxFrameSize);
 
-        // Calculate the new max frames
-        impl_->maxFrames = (impl_->size - impl_->dataOffset) / impl_->frameSlotSize;
-        if (impl_->maxFrames < 1) {
-            impl_->maxFrames = 1;
+        impl_->maxFrameSize = newMaxFrameSize;
+        if (config_.create && impl_->alignArena(newMaxFrameSize) > impl_->arenaLimit.load(std::memory_order_relaxed)) {
+            impl_->resizeArena(impl_->alignArena(newMaxFrameSize));
         }
-        metadata["max_frames"] = impl_->maxFrames;
 
-        // Write updated metadata
+        // Update metadata
+        auto metadata = impl_->readMetadataJson();
+        metadata["max_frame_size"] = impl_->maxFrameSize;
         impl_->updateMetadataJson(metadata);
 
         return Status::OK;
@@ -938,30 +2717,89 @@ namespace medical::imaging {
                                config_.maxFrameSize :
                                3840 * 2160 * 2; // Default to 4K UHD YUV size
 
-        // Initialize the appropriate type of shared memory
-        switch (config_.type) {
-            case SharedMemoryType::POSIX_SHM:
-                status = impl_->initializePosixShm(config_.name, config_.size, config_.create, maxFrameSize);
-                break;
-            case SharedMemoryType::SYSV_SHM:
-                status = impl_->initializeSysVShm(config_.name, config_.size, config_.create, maxFrameSize);
-                break;
-            case SharedMemoryType::MEMORY_MAPPED_FILE:
-                status = impl_->initializeMemoryMappedFile(
-                    config_.filePath.empty() ? "/dev/shm/" + config_.name : config_.filePath, config_.size,
-                    config_.create, maxFrameSize);
-                break;
-            case SharedMemoryType::HUGE_PAGES:
-                status = impl_->initializeHugePages(config_.name, config_.size, config_.create, maxFrameSize);
-                break;
-            default:
-                return Status::NOT_SUPPORTED;
+        // Only the producer sizes the header table and leases capture buffers, clients learn the layout
+        // from the metadata
+        impl_->maxFrames = config_.create ? config_.maxFrames : 0;
+        impl_->captureLeaseCount = config_.create ? config_.captureBuffers : 0;
+        impl_->requestedPayloadAlignment = config_.payloadAlignment;
+        impl_->rowAlignment = config_.create ? config_.rowAlignment : 0;
+
+        // Page backing is settled while mapping, before the first page is touched
+        impl_->wantHugePages = config_.useHugePages;
+        impl_->requestedHugePageSize = config_.hugePageSize;
+        impl_->prefault = config_.prefault;
+        impl_->numaNode = config_.numaNode;
+        impl_->persistent = config_.create && config_.persistent;
+        impl_->writePolicy = config_.writePolicy;
+        impl_->prefetchNext = !config_.create && config_.prefetchNextFrame;
+        impl_->demoteLagFrames = config_.create ? config_.demoteLagFrames : 0;
+        impl_->demoteStaleNs = config_.create ? static_cast<uint64_t>(config_.demoteStaleMs) * 1000000 : 0;
+        impl_->poseRingName = config_.create ? config_.poseRingName : std::string();
+
+        // A region received over the control socket needs neither a name nor a path
+        if (!config_.create && config_.attachDescriptor >= 0) {
+            status = impl_->initializeFromDescriptor(config_.attachDescriptor, config_.attachLayout, config_.name);
+        } else {
+            // Initialize the appropriate type of shared memory
+            switch (config_.type) {
+                case SharedMemoryType::POSIX_SHM:
+                    // POSIX shared memory names must start with '/'
+                    status = impl_->initializeBackend<Impl::PosixShmBackend>(
+                        "/" + config_.name, config_.size, config_.create, maxFrameSize);
+                    break;
+                case SharedMemoryType::SYSV_SHM:
+                    status = impl_->initializeBackend<Impl::SysVShmBackend>(
+                        config_.name, config_.size, config_.create, maxFrameSize);
+                    break;
+                case SharedMemoryType::MEMORY_MAPPED_FILE:
+                    status = impl_->initializeBackend<Impl::MappedFileBackend>(
+                        config_.filePath.empty() ? "/dev/shm/" + config_.name : config_.filePath, config_.size,
+                        config_.create, maxFrameSize);
+                    break;
+                case SharedMemoryType::HUGE_PAGES:
+                    status = impl_->initializeHugePages(config_.name, config_.size, config_.create, maxFrameSize);
+                    break;
+                case SharedMemoryType::MEMFD:
+                    // A memfd has no name to open; clients attach through a passed descriptor
+                    if (!config_.create) {
+                        MIVI_LOG_WARNING("Shared memory '{}' is a memfd, attach through the control socket",
+                                config_.name);
+                        return Status::NOT_SUPPORTED;
+                    }
+                    status = impl_->initializeBackend<Impl::MemfdBackend>(
+                        config_.name, config_.size, config_.create, maxFrameSize);
+                    break;
+                default:
+                    return Status::NOT_SUPPORTED;
+            }
         }
 
         if (status != Status::OK) {
             return status;
         }
 
+        // Clients take their own cursor in the reader table so consumers never steal frames from each other
+        if (!config_.create && impl_->readerSlotCount > 0) {
+            if (impl_->registerReader(config_.readerMode, config_.requestedFormat, config_.readerFilter) < 0) {
+                MIVI_LOG_WARNING("No free reader slot in shared memory '{}' ({} readers attached)",
+                        config_.name, impl_->readerSlotCount);
+                impl_->cleanup();
+                return Status::TOO_MANY_READERS;
+            }
+        }
+
+        // The writer copies every payload it does not capture in place
+        if (config_.create) {
+            copier_ = std::make_unique<FrameCopier>(config_.copyMode, std::max<size_t>(1, config_.copyThreads));
+            impl_->dropConsumedPages = config_.dropConsumedPages && impl_->isDiskBackedFile();
+        }
+
+        // A reader maps the producer's transparent huge pages as such only if its own mapping asks for them
+        if (!config_.create && impl_->prefetchNext && impl_->pageBacking == "transparent" && !config_.useHugePages) {
+            madvise(impl_->mapping, impl_->size, MADV_HUGEPAGE);
+        }
+        impl_->adviseWillNeed = impl_->prefetchNext && impl_->isDiskBackedFile();
+
         isInitialized_ = true;
 
         // Start the notification thread if we're a client and have a callback
@@ -969,12 +2807,12 @@ namespace medical::imaging {
             stopCallbackThread_ = false;
             callbackThread_ = std::thread(&SharedMemory::notificationThread, this);
 
-            // Set thread priority and affinity if configured
-            if (threadPriority_ != 0) {
+            // Set thread priority and affinity if configured, unless the thread layout places it
+            if (threadPriority_ != 0 && !ThreadLayout::isPlaced("notify")) {
                 setThreadPriority(threadPriority_);
             }
 
-            if (threadAffinity_ >= 0) {
+            if (threadAffinity_ >= 0 && !ThreadLayout::isPlaced("notify")) {
                 setThreadAffinity(threadAffinity_);
             }
         }
@@ -1003,12 +2841,36 @@ namespace medical::imaging {
             return Status::INVALID_SIZE;
         }
 
+        // CRITICAL: Check data size against the largest payload the arena takes
+        if (frame->getDataSize() > impl_->maxFrameSize) {
+            MIVI_LOG_ERROR("Error: Frame data size {} exceeds max frame size {}",
+                    frame->getDataSize(), impl_->maxFrameSize);
+            impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return Status::INVALID_SIZE;
+        }
+
         // Start time for performance tracking
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        // CRITICAL: Use atomic operations to get consistent indices
+        // A frame captured straight into a leased buffer is already in the arena with tight rows, others
+        // need room for a copy at the ring's row pitch
+        size_t rowPitch = impl_->rowPitchFor(*frame);
+        size_t copyBytes = rowPitch * frame->getHeight() > frame->getDataSize() ? rowPitch * frame->getHeight()
+                                                                                : frame->getDataSize();
+        size_t payloadBytes = copyBytes;
+        {
+            // The lease table is shared with the capture driver's allocator thread. The lock covers a scan
+            // of a few leases and only contends with a buffer being bound, at most once per frame; the
+            // lease is re-checked below since it can be released in between.
+            std::lock_guard<std::mutex> lock(impl_->captureMutex);
+            if (impl_->findCaptureLease(frame->getData()) >= 0) {
+                payloadBytes = 0;
+            }
+        }
+
+        // CRITICAL: Backpressure comes from the slowest lossless reader, lossy readers never block us
         uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
-        uint64_t readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
+        uint64_t readIndex = impl_->computeTail(writeIndex);
         uint64_t frameCount = writeIndex - readIndex;
 
         // IMPORTANT: Add extra safety check for maxFrames
@@ -1018,486 +2880,1153 @@ namespace medical::imaging {
             actualMaxFrames = 1;
         }
 
-        bool bufferFull = frameCount >= actualMaxFrames;
+        bool bufferFull = frameCount >= actualMaxFrames || !impl_->hasPayloadRoom(payloadBytes);
+
+        // A crashed lossless reader would stall the ring forever - drop its slot and re-check
+        if (bufferFull && impl_->reclaimDeadReaders() > 0) {
+            readIndex = impl_->computeTail(writeIndex);
+            frameCount = writeIndex - readIndex;
+            bufferFull = frameCount >= actualMaxFrames || !impl_->hasPayloadRoom(payloadBytes);
+        }
+
+        // So would a live one that stopped reading - lap it from now on
+        if (bufferFull && impl_->demoteStaleReaders(writeIndex) > 0) {
+            readIndex = impl_->computeTail(writeIndex);
+            frameCount = writeIndex - readIndex;
+            bufferFull = frameCount >= actualMaxFrames || !impl_->hasPayloadRoom(payloadBytes);
+        }
+
+        // A blocking writer always waits for lossless readers, up to its block timeout
+        if (bufferFull && timeoutMs == 0 && config_.writePolicy == WritePolicy::BLOCK) {
+            timeoutMs = config_.blockTimeoutMs;
+        }
 
         // Check if the buffer is full and we need to wait
         if (bufferFull && timeoutMs > 0) {
             // Calculate end time
             auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
 
-            // Wait for space to become available
-            while (bufferFull) {
-                // Sleep for a short time
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-
-                // Check if timeout has expired
-                if (std::chrono::steady_clock::now() >= endTime) {
-                    // Buffer still full after timeout
-                    std::lock_guard<std::mutex> lock(statsMutex_);
-                    stats_.bufferFullCount++;
-                    stats_.droppedFrames++;
-                    impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
-                    return Status::BUFFER_FULL;
-                }
-
-                // Re-check buffer status
-                readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-                frameCount = writeIndex - readIndex;
-                bufferFull = frameCount >= actualMaxFrames;
+            // Sleep on the space doorbell until a reader frees a slot
+            if (!impl_->waitForSpace(writeIndex, payloadBytes, endTime)) {
+                // Buffer still full after timeout
+                impl_->recordBufferFull();
+                return Status::BUFFER_FULL;
             }
+
+            readIndex = impl_->computeTail(writeIndex);
+            frameCount = writeIndex - readIndex;
         } else if (bufferFull) {
-            // Buffer is full and we're not waiting - drop the frame if configured to do so
-            if (config_.dropFramesWhenFull) {
-                std::lock_guard<std::mutex> lock(statsMutex_);
-                stats_.bufferFullCount++;
-                stats_.droppedFrames++;
-                impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            // Buffer is full and we're not waiting - drop the new frame. An overwriting writer only gets
+            // here when bound capture leases hold the space.
+            impl_->recordBufferFull();
+            return Status::BUFFER_FULL;
+        }
+
+        // Get the frame header - WITH SAFETY CHECKS
+        FrameHeader *header = impl_->getFrameHeader(writeIndex);
+        if (!header) {
+            MIVI_LOG_ERROR("Error: Invalid header for write index {}", writeIndex);
+            impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return Status::INTERNAL_ERROR;
+        }
+
+        // A leased capture buffer is handed to the ring as it is and the lease gets new space when next
+        // used; anything else is copied into space reserved at the arena head
+        bool zeroCopy = false;
+        uint64_t payloadPosition = 0;
+        {
+            std::lock_guard<std::mutex> lock(impl_->captureMutex);
+            int lease = impl_->findCaptureLease(frame->getData());
+            if (lease >= 0) {
+                Impl::CaptureLease &captureLease = impl_->captureLeases[lease];
+                payloadPosition = captureLease.start;
+                captureLease.bound = false;
+                zeroCopy = true;
+                copyBytes = frame->getDataSize();
+                rowPitch = copyBytes / std::max<size_t>(1, frame->getHeight());
+            } else if (!impl_->reservePayload(copyBytes, payloadPosition)) {
+                // A lease claimed the space since the check above
+                impl_->recordBufferFull();
                 return Status::BUFFER_FULL;
-            } else {
-                // Otherwise, wait briefly and try once more
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-                frameCount = writeIndex - readIndex;
-                bufferFull = frameCount >= actualMaxFrames;
-                if (bufferFull) {
-                    std::lock_guard<std::mutex> lock(statsMutex_);
-                    stats_.bufferFullCount++;
-                    stats_.droppedFrames++;
-                    impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
-                    return Status::BUFFER_FULL;
+            }
+
+            // Seqlock: an odd generation tells readers the slot is being rewritten, which also ends
+            // the frame that held this header before
+            header->generation.store(Impl::writingGeneration(writeIndex), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            impl_->releaseHeaderPayload(writeIndex);
+            impl_->livePayloads.push_back({writeIndex, payloadPosition, writeIndex, frame->getFrameId()});
+        }
+        header->payloadOffset = static_cast<uint32_t>((payloadPosition % impl_->arenaSize) / PAYLOAD_ALIGNMENT);
+        void *dataPtr = impl_->getArenaData(payloadPosition);
+
+        // Fill the header
+        header->frameId = frame->getFrameId();
+        auto timestamp = frame->getTimestamp();
+        auto since_epoch = timestamp.time_since_epoch();
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count();
+        header->timestamp = static_cast<uint64_t>(nanoseconds);
+        header->width = frame->getWidth();
+        header->height = frame->getHeight();
+        header->bytesPerPixel = frame->getBytesPerPixel();
+        header->dataSize = static_cast<uint32_t>(copyBytes);
+        header->rowPitch = static_cast<uint32_t>(rowPitch);
+        header->rowsReady.store(frame->getHeight(), std::memory_order_relaxed);
+        header->formatCode = static_cast<uint32_t>(frame->getPixelFormat());
+        header->flags = 0;
+        header->sequenceNumber = writeIndex;
+        header->metadataOffset = 0;
+        header->metadataSize = 0;
+        header->duplicateDistance = 0;
+        auto captureTime = frame->getCaptureTime().time_since_epoch();
+        header->captureTimeNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(captureTime).count());
+
+        // A new width, height or format starts a new geometry epoch; the region itself stays as it is
+        if (impl_->updateGeometry(*header)) {
+            header->flags |= FRAME_FLAG_GEOMETRY_CHANGED;
+        }
+
+        // Store the per-frame metadata as a fixed binary record next to the header
+        FrameMetadataRecord *record = impl_->getFrameMetadataRecord(writeIndex);
+        if (config_.enableMetadata && record) {
+            packMetadataRecord(frame->getMetadata(), *record);
+            impl_->applyPose(header->captureTimeNs, *record);
+            header->flags |= record->flags;
+            header->metadataOffset = static_cast<uint32_t>(sizeof(FrameHeader));
+            header->metadataSize = static_cast<uint32_t>(sizeof(FrameMetadataRecord));
+        }
+
+        // Image statistics are taken while the payload is copied, so it is read only once
+        std::optional<FrameStatistics> statistics;
+        if (config_.computeStatistics && config_.enableMetadata && record &&
+            FrameStatistics::isSupported(frame->getPixelFormat())) {
+            statistics.emplace(frame->getPixelFormat(), frame->getWidth(), frame->getHeight());
+        }
+
+        // Packed payloads taller than a band can be published band by band while they are copied
+        uint32_t height = static_cast<uint32_t>(std::max(0, frame->getHeight()));
+        size_t bandRows = config_.publishBandRows;
+        size_t sourceRowBytes = frame->getDataSize() / std::max<uint32_t>(1, height);
+        bool banded = !zeroCopy && bandRows > 0 && height > bandRows && rowPitch >= sourceRowBytes &&
+                      getPixelFormatInfo(frame->getPixelFormat()).planes == 1 &&
+                      sourceRowBytes * height == frame->getDataSize();
+
+        // The payload of a captured frame is already in place
+        if (zeroCopy) {
+            header->flags |= FRAME_FLAG_ZERO_COPY;
+            if (statistics) {
+                statistics->add(dataPtr, copyBytes);
+            }
+        } else if (banded) {
+            // The header is final; readers of partial frames find the slot through partialIndex
+            header->rowsReady.store(0, std::memory_order_relaxed);
+            impl_->controlBlock->partialIndex.store(writeIndex + 1, std::memory_order_release);
+
+            bool streaming = copier_ && (copier_->getMode() == CopyMode::STREAMING ||
+                                         (copier_->getMode() == CopyMode::AUTO &&
+                                          bandRows * sourceRowBytes >= FrameCopier::STREAMING_THRESHOLD));
+            try {
+                const auto *source = static_cast<const uint8_t *>(frame->getData());
+                auto *destination = static_cast<uint8_t *>(dataPtr);
+                for (uint32_t row = 0; row < height; row += static_cast<uint32_t>(bandRows)) {
+                    uint32_t rows = std::min(static_cast<uint32_t>(bandRows), height - row);
+                    const uint8_t *bandSource = source + row * sourceRowBytes;
+                    if (rowPitch != sourceRowBytes) {
+                        for (uint32_t i = 0; i < rows; ++i) {
+                            if (statistics) {
+                                statistics->add(bandSource + i * sourceRowBytes, sourceRowBytes);
+                            }
+                            std::memcpy(destination + (row + i) * rowPitch, bandSource + i * sourceRowBytes,
+                                        sourceRowBytes);
+                        }
+                    } else if (statistics) {
+                        statistics->copy(destination + row * rowPitch, bandSource, rows * sourceRowBytes, streaming);
+                    } else if (copier_) {
+                        copier_->copy(destination + row * rowPitch, bandSource, rows * sourceRowBytes);
+                    } else {
+                        std::memcpy(destination + row * rowPitch, bandSource, rows * sourceRowBytes);
+                    }
+
+                    // The kernels fence their streaming stores, so the band is visible before its rows count
+                    header->rowsReady.store(row + rows, std::memory_order_release);
+                    futex::ring(impl_->controlBlock->bandDoorbell, impl_->controlBlock->bandWaiters);
+                }
+            } catch (const std::exception &e) {
+                // Partial readers stop looking at this slot, then the write is undone
+                impl_->controlBlock->partialIndex.store(0, std::memory_order_release);
+                impl_->abandonWrite(writeIndex, *header);
+                futex::ring(impl_->controlBlock->bandDoorbell, impl_->controlBlock->bandWaiters);
+                MIVI_LOG_ERROR("Exception copying frame data: {}", e.what());
+                return Status::WRITE_FAILED;
+            }
+        } else {
+            // Copy the frame data - WITH BOUNDS CHECK
+            try {
+                // Large payloads bypass the cache the readers work in; the kernel fences before we publish
+                if (copyBytes != frame->getDataSize()) {
+                    // Padded rows, copied one at a time; the padding bytes are left as they are
+                    size_t rowBytes = frame->getDataSize() / height;
+                    const auto *source = static_cast<const uint8_t *>(frame->getData());
+                    auto *destination = static_cast<uint8_t *>(dataPtr);
+                    for (uint32_t row = 0; row < height; ++row) {
+                        if (statistics) {
+                            statistics->add(source + row * rowBytes, rowBytes);
+                        }
+                        std::memcpy(destination + row * rowPitch, source + row * rowBytes, rowBytes);
+                    }
+                } else if (statistics) {
+                    // One pass over the source; the multi-threaded split does not apply
+                    bool streaming = copier_ && (copier_->getMode() == CopyMode::STREAMING ||
+                                                 (copier_->getMode() == CopyMode::AUTO &&
+                                                  copyBytes >= FrameCopier::STREAMING_THRESHOLD));
+                    statistics->copy(dataPtr, frame->getData(), copyBytes, streaming);
+                } else if (copier_) {
+                    copier_->copy(dataPtr, frame->getData(), frame->getDataSize());
+                } else {
+                    std::memcpy(dataPtr, frame->getData(), frame->getDataSize());
                 }
+            } catch (const std::exception &e) {
+                impl_->abandonWrite(writeIndex, *header);
+                MIVI_LOG_ERROR("Exception copying frame data: {}", e.what());
+                return Status::WRITE_FAILED;
+            }
+        }
+
+        if (statistics) {
+            packImageStatistics(statistics->finish(), *record);
+            header->flags |= FRAME_FLAG_STATISTICS;
+        }
+
+        // Seqlock: header, record and payload are complete for this sequence number
+        header->publishTimeNs = getMonotonicTimeNanos();
+        header->generation.store(Impl::stableGeneration(writeIndex), std::memory_order_release);
+        impl_->indexFrame(writeIndex, *header);
+
+        // The producer's view of a captured frame now lives in the ring and goes stale when the writer laps it
+        if (zeroCopy) {
+            frame->setValidityGuard(&header->generation, Impl::stableGeneration(writeIndex));
+        }
+
+        // Update timestamp - use atomic store
+        impl_->controlBlock->lastWriteTime.store(
+            std::chrono::system_clock::now().time_since_epoch().count(),
+            std::memory_order_release);
+
+        // Increment write index - CRITICAL: use atomic store with release ordering
+        impl_->controlBlock->writeIndex.store(writeIndex + 1, std::memory_order_release);
+
+        // Update total frames - use atomic operations
+        impl_->controlBlock->totalFramesWritten.fetch_add(1, std::memory_order_relaxed);
+
+        // Wake readers blocked on the frame doorbell (skips the syscall when nobody sleeps)
+        futex::ring(impl_->controlBlock->frameDoorbell, impl_->controlBlock->frameWaiters);
+        futex::ring(impl_->controlBlock->bandDoorbell, impl_->controlBlock->bandWaiters);
+        impl_->filterReaders(writeIndex);
+        impl_->notifyReaders(writeIndex);
+
+        // Calculate write latency
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+
+        // Readers report what they consumed in their slots; turn that into per-consumer latency
+        impl_->sampleReaderLatency(writeIndex + 1);
+        if (impl_->dropConsumedPages) {
+            impl_->adviseConsumedPayloads();
+        }
+
+        // Update statistics in the control block, where readers see them too
+        ControlBlock *controlBlock = impl_->controlBlock;
+        controlBlock->writeLatencyNsTotal.fetch_add(static_cast<uint64_t>(duration), std::memory_order_relaxed);
+        storeMax(controlBlock->maxWriteLatencyNs, static_cast<uint64_t>(duration));
+        uint64_t bytesWritten = controlBlock->bytesWritten.fetch_add(frame->getDataSize(), std::memory_order_relaxed) +
+                                frame->getDataSize();
+        uint64_t framesWritten = controlBlock->totalFramesWritten.load(std::memory_order_relaxed);
+        storeMax(controlBlock->peakMemoryUsage,
+                 (frameCount + 1) *
+                 (impl_->slotHeaderSize() + bytesWritten / std::max<uint64_t>(1, framesWritten)));
+
+        return Status::OK;
+    }
+
+    SharedMemory::Status SharedMemory::writeDuplicateFrame(const std::shared_ptr<Frame> &frame,
+                                                           uint64_t originalFrameId) {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
+        }
+
+        if (!frame) {
+            return Status::INVALID_SIZE;
+        }
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        // Only a header slot is taken, so lossless readers are the only backpressure
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        size_t actualMaxFrames = std::max<size_t>(1, impl_->maxFrames);
+        bool bufferFull = writeIndex - impl_->computeTail(writeIndex) >= actualMaxFrames;
+        if (bufferFull && (impl_->reclaimDeadReaders() > 0 || impl_->demoteStaleReaders(writeIndex) > 0)) {
+            bufferFull = writeIndex - impl_->computeTail(writeIndex) >= actualMaxFrames;
+        }
+        if (bufferFull && config_.writePolicy == WritePolicy::BLOCK) {
+            auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(config_.blockTimeoutMs);
+            bufferFull = !impl_->waitForSpace(writeIndex, 0, endTime);
+        }
+        if (bufferFull) {
+            impl_->recordBufferFull();
+            return Status::BUFFER_FULL;
+        }
+
+        FrameHeader *header = impl_->getFrameHeader(writeIndex);
+        if (!header) {
+            impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return Status::INTERNAL_ERROR;
+        }
+
+        // The newest payload is reused as it is; its geometry is taken before our slot is rewritten,
+        // which with a single header slot is the same one
+        FrameHeader original{};
+        uint64_t origin = 0;
+        std::optional<ImageStatistics> originalStatistics;
+        {
+            std::lock_guard<std::mutex> lock(impl_->captureMutex);
+            if (impl_->livePayloads.empty() || impl_->livePayloads.back().frameId != originalFrameId) {
+                return Status::BUFFER_EMPTY;
             }
+            Impl::PayloadExtent extent = impl_->livePayloads.back();
+            const FrameHeader *source = impl_->getFrameHeader(extent.sequence);
+            if (!source || writeIndex - extent.origin > UINT32_MAX) {
+                return Status::BUFFER_EMPTY;
+            }
+            original.width = source->width;
+            original.height = source->height;
+            original.bytesPerPixel = source->bytesPerPixel;
+            original.dataSize = source->dataSize;
+            original.rowPitch = source->rowPitch;
+            original.formatCode = source->formatCode;
+            original.payloadOffset = source->payloadOffset;
+            origin = extent.origin;
+
+            // The pixels are the same, and so are their statistics
+            const FrameMetadataRecord *sourceRecord = impl_->getFrameMetadataRecord(extent.sequence);
+            if (config_.computeStatistics && sourceRecord && (sourceRecord->flags & FRAME_FLAG_STATISTICS)) {
+                ImageStatistics &statistics = originalStatistics.emplace();
+                statistics.pixelCount = sourceRecord->statisticsPixelCount;
+                statistics.meanLuminance = sourceRecord->meanLuminance;
+                statistics.luminanceVariance = sourceRecord->luminanceVariance;
+                statistics.saturatedFraction = sourceRecord->saturatedFraction;
+                statistics.signalToNoiseRatio = sourceRecord->signalToNoiseRatio;
+                std::copy_n(sourceRecord->luminanceHistogram, ImageStatistics::HISTOGRAM_BINS, statistics.histogram);
+            }
+
+            // Seqlock as in writeFrameTimeout(); the duplicate is retired together with the payload it shares
+            header->generation.store(Impl::writingGeneration(writeIndex), std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            impl_->releaseHeaderPayload(writeIndex);
+            impl_->livePayloads.push_back({writeIndex, extent.start, extent.origin, extent.frameId});
+        }
+
+        header->frameId = frame->getFrameId();
+        header->timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            frame->getTimestamp().time_since_epoch()).count());
+        header->width = original.width;
+        header->height = original.height;
+        header->bytesPerPixel = original.bytesPerPixel;
+        header->dataSize = original.dataSize;
+        header->rowPitch = original.rowPitch;
+        header->rowsReady.store(original.height, std::memory_order_relaxed);
+        header->formatCode = original.formatCode;
+        header->payloadOffset = original.payloadOffset;
+        header->flags = FRAME_FLAG_DUPLICATE;
+        header->sequenceNumber = writeIndex;
+        header->metadataOffset = 0;
+        header->metadataSize = 0;
+        header->duplicateDistance = static_cast<uint32_t>(writeIndex - origin);
+        header->captureTimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            frame->getCaptureTime().time_since_epoch()).count());
+
+        FrameMetadataRecord *record = impl_->getFrameMetadataRecord(writeIndex);
+        if (config_.enableMetadata && record) {
+            packMetadataRecord(frame->getMetadata(), *record);
+            impl_->applyPose(header->captureTimeNs, *record);
+            record->flags |= FRAME_FLAG_DUPLICATE;
+            if (originalStatistics) {
+                packImageStatistics(*originalStatistics, *record);
+            }
+            header->flags |= record->flags;
+            header->metadataOffset = static_cast<uint32_t>(sizeof(FrameHeader));
+            header->metadataSize = static_cast<uint32_t>(sizeof(FrameMetadataRecord));
+        }
+
+        header->publishTimeNs = getMonotonicTimeNanos();
+        header->generation.store(Impl::stableGeneration(writeIndex), std::memory_order_release);
+        impl_->indexFrame(writeIndex, *header);
+
+        impl_->controlBlock->lastWriteTime.store(
+            std::chrono::system_clock::now().time_since_epoch().count(),
+            std::memory_order_release);
+        impl_->controlBlock->writeIndex.store(writeIndex + 1, std::memory_order_release);
+        impl_->controlBlock->totalFramesWritten.fetch_add(1, std::memory_order_relaxed);
+        futex::ring(impl_->controlBlock->frameDoorbell, impl_->controlBlock->frameWaiters);
+        futex::ring(impl_->controlBlock->bandDoorbell, impl_->controlBlock->bandWaiters);
+        impl_->filterReaders(writeIndex);
+        impl_->notifyReaders(writeIndex);
+
+        impl_->sampleReaderLatency(writeIndex + 1);
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - startTime).count();
+        impl_->controlBlock->writeLatencyNsTotal.fetch_add(static_cast<uint64_t>(duration), std::memory_order_relaxed);
+        storeMax(impl_->controlBlock->maxWriteLatencyNs, static_cast<uint64_t>(duration));
+
+        return Status::OK;
+    }
+
+
+    SharedMemory::Status SharedMemory::mapSlotFrame(uint64_t index, std::shared_ptr<Frame> &frame) {
+        // Get the frame header
+        FrameHeader *header = impl_->getFrameHeader(index);
+        if (!header) {
+            return Status::INTERNAL_ERROR;
+        }
+
+        // Seqlock: the slot must hold exactly this sequence number and not be mid-write
+        const uint64_t expectedGeneration = Impl::stableGeneration(index);
+        if (header->generation.load(std::memory_order_acquire) != expectedGeneration) {
+            return Status::READ_FAILED;
+        }
+
+        // Get the frame data from the arena space the header points at
+        void *dataPtr = impl_->getFrameData(index);
+        if (!dataPtr) {
+            return Status::READ_FAILED;
+        }
+
+        // Create a frame that views the slot inside our existing mapping (zero-copy). Frames have
+        // no row pitch of their own, so padded rows are packed into a frame of its own.
+        PixelFormat format = pixelFormatFromCode(header->formatCode);
+        size_t rowBytes = header->height > 0 ? header->dataSize / header->height : 0;
+        size_t packedRowBytes = getPixelFormatInfo(format).rowBytes(header->width);
+        if (packedRowBytes == 0) {
+            packedRowBytes = static_cast<size_t>(header->width) * header->bytesPerPixel;
+        }
+        if (header->rowPitch > packedRowBytes && header->rowPitch == rowBytes) {
+            frame = Frame::create(header->width, header->height, header->bytesPerPixel, format);
+            if (!frame || frame->getDataSize() < packedRowBytes * header->height) {
+                frame.reset();
+                return Status::INTERNAL_ERROR;
+            }
+            const auto *source = static_cast<const uint8_t *>(dataPtr);
+            auto *destination = static_cast<uint8_t *>(frame->getData());
+            for (uint32_t row = 0; row < header->height; ++row) {
+                std::memcpy(destination + row * packedRowBytes, source + row * header->rowPitch, packedRowBytes);
+            }
+        } else {
+            frame = Frame::createWithExternalData(
+                dataPtr,
+                header->dataSize,
+                header->width,
+                header->height,
+                header->bytesPerPixel,
+                format,
+                false,
+                BufferType::EXTERNAL_MEMORY);
+        }
+
+        if (!frame) {
+            return Status::INTERNAL_ERROR;
+        }
+
+        // Set the frame ID and timestamp
+        frame->setFrameId(header->frameId);
+        frame->setSequenceNumber(header->sequenceNumber);
+        auto timestamp = std::chrono::system_clock::time_point(
+            std::chrono::nanoseconds(header->timestamp));
+        frame->setTimestamp(timestamp);
+        frame->setCaptureTime(std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(header->captureTimeNs)));
+
+        // Load the binary metadata record if the writer stored one
+        if (config_.enableMetadata && header->metadataSize >= sizeof(FrameMetadataRecord) &&
+            header->metadataOffset + sizeof(FrameMetadataRecord) <= impl_->headerStride) {
+            const auto *record = reinterpret_cast<const FrameMetadataRecord *>(
+                reinterpret_cast<const uint8_t *>(header) + header->metadataOffset);
+            unpackMetadataRecord(*record, frame->getMetadataMutable());
+        }
+
+        // The payload stays in the ring - let the consumer re-check the slot after using it
+        frame->setValidityGuard(&header->generation, expectedGeneration);
+
+        // A writer that started reusing the slot meanwhile may have torn the header we just copied
+        if (!frame->validate()) {
+            frame.reset();
+            return Status::READ_FAILED;
+        }
+
+        // A packed copy no longer depends on the slot
+        if (frame->getData() != dataPtr) {
+            frame->setValidityGuard(nullptr, 0);
+        }
+
+        return Status::OK;
+    }
+
+    SharedMemory::Status SharedMemory::readLatestFrame(std::shared_ptr<Frame> &frame) {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
         }
 
-        // SAFETY CHECK: Make sure writeIndex is within valid range
-        uint64_t slotIndex = writeIndex % actualMaxFrames;
+        // Start time for performance tracking
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-        // Get the frame header and data pointers - WITH SAFETY CHECKS
-        FrameHeader *header = impl_->getFrameHeader(writeIndex);
-        if (!header) {
-            std::cerr << "Error: Invalid header for write index " << writeIndex << std::endl;
-            impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
-            return Status::INTERNAL_ERROR;
-        }
+        // Before the latest slot can be reused the writer has to lap the whole ring, so retries are rare
+        Status status = Status::READ_FAILED;
+        uint64_t writeIndex = 0;
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS && status == Status::READ_FAILED; ++attempt) {
+            // Get the current write index and this reader's cursor
+            writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+            uint64_t readIndex = impl_->currentCursor();
 
-        void *dataPtr = impl_->getFrameData(writeIndex);
-        if (!dataPtr) {
-            std::cerr << "Error: Invalid data pointer for write index " << writeIndex << std::endl;
-            impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
-            return Status::INTERNAL_ERROR;
+            if (writeIndex == 0 || writeIndex <= readIndex) {
+                return Status::BUFFER_EMPTY;
+            }
+
+            // Get the latest frame (the one just before the write index)
+            status = mapSlotFrame(writeIndex - 1, frame);
         }
 
-        // CRITICAL: Check data size against available space to prevent overflow
-        if (frame->getDataSize() > impl_->frameSlotSize - sizeof(FrameHeader)) {
-            std::cerr << "Error: Frame data size " << frame->getDataSize()
-                    << " exceeds available slot size " << (impl_->frameSlotSize - sizeof(FrameHeader)) << std::endl;
-            impl_->controlBlock->droppedFrames.fetch_add(1, std::memory_order_relaxed);
-            return Status::INVALID_SIZE;
+        if (status != Status::OK) {
+            return status;
         }
 
-        // Fill the header
-        header->frameId = frame->getFrameId();
-        auto timestamp = frame->getTimestamp();
-        auto since_epoch = timestamp.time_since_epoch();
-        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count();
-        header->timestamp = static_cast<uint64_t>(nanoseconds);
-        header->width = frame->getWidth();
-        header->height = frame->getHeight();
-        header->bytesPerPixel = frame->getBytesPerPixel();
-        header->dataSize = frame->getDataSize();
-        header->formatCode = getFormatCode(frame->getFormat());
-        header->flags = 0;
-        header->sequenceNumber = writeIndex;
-        header->metadataOffset = 0; // Not using per-frame metadata for now
-        header->metadataSize = 0;
+        // Everything up to the latest frame counts as consumed by this reader
+        impl_->advanceCursor(writeIndex, 0);
+        impl_->controlBlock->totalFramesRead.fetch_add(1, std::memory_order_relaxed);
+
+        // Update timestamp
+        impl_->controlBlock->lastReadTime.store(
+            std::chrono::system_clock::now().time_since_epoch().count(),
+            std::memory_order_release);
 
+        // Calculate read latency
+        auto endTime = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
 
-        // If this frame came from shared memory originally, try to zero-copy
-        if (frame->isMappedToSharedMemory()) {
-            // This is already in shared memory, just set flag
-            header->flags |= 0x01; // Flag indicating zero-copy
-        } else {
-            // Copy the frame data - WITH BOUNDS CHECK
-            try {
-                // Safe memory copy
-                std::memcpy(dataPtr, frame->getData(), frame->getDataSize());
-            } catch (const std::exception &e) {
-                std::cerr << "Exception copying frame data: " << e.what() << std::endl;
-                return Status::WRITE_FAILED;
-            }
+        // Update statistics
+        recordRead(1, static_cast<uint64_t>(duration));
+
+        return Status::OK;
+    }
+
+    SharedMemory::Status SharedMemory::readNextFrame(std::shared_ptr<Frame> &frame,
+                                                     unsigned int waitMilliseconds) {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
         }
 
-        // Update metadata if enabled
-        if (config_.enableMetadata) {
-            // Read existing metadata
-            auto metadata = impl_->readMetadataJson();
-
-            // Update frame-specific metadata
-            metadata["last_frame"]["width"] = frame->getWidth();
-            metadata["last_frame"]["height"] = frame->getHeight();
-            metadata["last_frame"]["format"] = frame->getFormat();
-            metadata["last_frame"]["timestamp"] = header->timestamp;
-            metadata["last_frame"]["id"] = frame->getFrameId();
-            metadata["last_frame"]["sequenceNumber"] = header->sequenceNumber;
-
-            // Get frame metadata if any
-            const FrameMetadata &frameMetadata = frame->getMetadata();
-
-            json frameMetadataJson = {
-                {"device_id", frameMetadata.deviceId},
-                {"exposure_time_ms", frameMetadata.exposureTimeMs},
-                {"frame_number", frameMetadata.frameNumber},
-                {"processed", frameMetadata.hasBeenProcessed},
-                {"calibration_data", frameMetadata.hasCalibrationData},
-                {"segmentation_data", frameMetadata.hasSegmentationData},
-                {"signal_to_noise_ratio", frameMetadata.signalToNoiseRatio},
-                {"signal_strength", frameMetadata.signalStrength},
-                {"confidence_score", frameMetadata.confidenceScore}
-            };
+        // Start time for performance tracking
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-            // Add position if available
-            if (!frameMetadata.probePosition.empty()) {
-                frameMetadataJson["probe_position"] = frameMetadata.probePosition;
+        // Get this reader's cursor, past the frames its filter rejects
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        uint64_t readIndex = impl_->skipFiltered(writeIndex);
+
+        // Check if there are any frames available
+        if (readIndex >= writeIndex) {
+            if (waitMilliseconds == 0) {
+                return Status::BUFFER_EMPTY;
             }
 
-            // Add orientation if available
-            if (!frameMetadata.probeOrientation.empty()) {
-                frameMetadataJson["probe_orientation"] = frameMetadata.probeOrientation;
+            // Sleep on the frame doorbell until the writer publishes the next frame
+            auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMilliseconds);
+            if (!impl_->waitForReadable(readIndex, endTime)) {
+                return Status::TIMEOUT;
             }
+        }
 
-            // Add attributes
-            for (const auto &[key, value]: frameMetadata.attributes) {
-                frameMetadataJson["attributes"][key] = value;
+        Status status = Status::READ_FAILED;
+        uint64_t skipped = 0;
+        uint64_t filtered = 0;
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS && status == Status::READ_FAILED; ++attempt) {
+            writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+
+            // A lossy reader that was lapped jumps to the oldest frame the writer is not about to reuse
+            uint64_t oldest = impl_->oldestReadable(writeIndex);
+            if (impl_->canBeLapped() && readIndex < oldest) {
+                skipped += oldest - readIndex;
+                readIndex = impl_->nextWanted(oldest, writeIndex, filtered);
+                if (readIndex >= writeIndex) {
+                    status = Status::BUFFER_EMPTY;
+                    break;
+                }
             }
 
-            metadata["last_frame"]["metadata"] = frameMetadataJson;
+            status = mapSlotFrame(readIndex, frame);
 
-            // Update the metadata
-            impl_->updateMetadataJson(metadata);
+            // Lossless readers are never lapped, so a failed generation check cannot heal by retrying
+            if (!impl_->canBeLapped()) {
+                break;
+            }
         }
 
-        // Update timestamp - use atomic store
-        impl_->controlBlock->lastWriteTime.store(
+        if (status != Status::OK) {
+            return status;
+        }
+
+        // Advance our cursor; this wakes a writer waiting on us for a free slot
+        impl_->advanceCursor(readIndex + 1, skipped, 1, filtered);
+
+        // Start pulling in the next payload while the caller works on this one
+        impl_->prefetchNextPayload(readIndex + 1, *impl_->getFrameHeader(readIndex));
+
+        // Update timestamp
+        impl_->controlBlock->lastReadTime.store(
             std::chrono::system_clock::now().time_since_epoch().count(),
             std::memory_order_release);
 
-        // Increment write index - CRITICAL: use atomic store with release ordering
-        impl_->controlBlock->writeIndex.store(writeIndex + 1, std::memory_order_release);
-
-        // Update frame count and total frames - use atomic operations
-        impl_->controlBlock->frameCount.store(frameCount + 1, std::memory_order_release);
-        impl_->controlBlock->totalFramesWritten.fetch_add(1, std::memory_order_relaxed);
+        // Update statistics
+        impl_->controlBlock->totalFramesRead.fetch_add(1, std::memory_order_relaxed);
 
-        // Calculate write latency
+        // Calculate read latency
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
 
-        // Update statistics
-        {
-            std::lock_guard<std::mutex> lock(statsMutex_);
-            stats_.totalFramesWritten++;
-            stats_.writeLatencyNsAvg = (stats_.writeLatencyNsAvg * (stats_.totalFramesWritten - 1) +
-                                        duration) / stats_.totalFramesWritten;
-            stats_.maxWriteLatencyNs = std::max(stats_.maxWriteLatencyNs, static_cast<uint64_t>(duration));
-            stats_.averageFrameSize = (stats_.averageFrameSize * (stats_.totalFramesWritten - 1) +
-                                       frame->getDataSize()) / stats_.totalFramesWritten;
-            stats_.peakMemoryUsage = std::max(stats_.peakMemoryUsage,
-                                              impl_->controlBlock->frameCount.load(std::memory_order_relaxed) *
-                                              (sizeof(FrameHeader) + static_cast<size_t>(stats_.averageFrameSize)));
-        }
+        // Update local statistics
+        recordRead(1, static_cast<uint64_t>(duration));
 
         return Status::OK;
     }
 
-
-    SharedMemory::Status SharedMemory::readLatestFrame(std::shared_ptr<Frame> &frame) {
+    SharedMemory::Status SharedMemory::waitForFrame(unsigned int waitMilliseconds) {
         if (!isInitialized_ || !impl_->controlBlock) {
             return Status::NOT_INITIALIZED;
         }
 
-        // Start time for performance tracking
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        // Get the current write and read indices
         uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
-        uint64_t readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-
-        if (writeIndex == 0 || writeIndex <= readIndex) {
+        uint64_t readIndex = impl_->skipFiltered(writeIndex);
+        if (writeIndex > readIndex) {
+            return Status::OK;
+        }
+        if (waitMilliseconds == 0) {
             return Status::BUFFER_EMPTY;
         }
 
-        // Get the latest frame (the one just before the write index)
-        uint64_t latestIndex = writeIndex - 1;
+        // Sleep on the frame doorbell until the writer publishes the next frame
+        auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMilliseconds);
+        return impl_->waitForReadable(readIndex, endTime) ? Status::OK : Status::TIMEOUT;
+    }
 
+    SharedMemory::Status SharedMemory::mapSlotView(uint64_t index, FrameView &view, bool partial) {
         // Get the frame header
-        const FrameHeader *header = impl_->getFrameHeader(latestIndex);
+        FrameHeader *header = impl_->getFrameHeader(index);
         if (!header) {
             return Status::INTERNAL_ERROR;
         }
 
-        // Get the frame data
-        void *dataPtr = impl_->getFrameData(latestIndex);
-        if (!dataPtr) {
-            return Status::INTERNAL_ERROR;
+        // Seqlock: the slot must hold exactly this sequence number and not be mid-write, unless it is
+        // published in bands, whose header is final before the first one
+        const uint64_t expectedGeneration = Impl::stableGeneration(index);
+        partial = partial && impl_->hasPartialRows(index);
+        if (!partial && header->generation.load(std::memory_order_acquire) != expectedGeneration) {
+            return Status::READ_FAILED;
         }
 
-        // Check if this is a zero-copy frame that's already in shared memory
-        if (header->flags & 0x01) {
-            // This is a zero-copy frame - create a reference to the original
-            // memory location instead of this shared memory
-            // TODO: Implement proper zero-copy for frames already in shared memory
+        // Get the frame data from the arena space the header points at
+        void *dataPtr = impl_->getFrameData(index);
+        if (!dataPtr) {
+            return Status::READ_FAILED;
         }
 
-        // Create a frame that maps directly to the shared memory (zero-copy)
-        std::string format = getFormatString(header->formatCode);
-
-        // Create a mapped frame
-        frame = Frame::createMapped(
-            config_.name,
-            reinterpret_cast<uint8_t *>(dataPtr) - reinterpret_cast<uint8_t *>(impl_->mapping),
-            header->dataSize,
-            header->width,
-            header->height,
-            header->bytesPerPixel,
-            format);
-
-        if (!frame) {
-            return Status::INTERNAL_ERROR;
+        view.data = dataPtr;
+        view.dataSize = header->dataSize;
+        view.width = header->width;
+        view.height = header->height;
+        view.bytesPerPixel = header->bytesPerPixel;
+        view.format = pixelFormatFromCode(header->formatCode);
+        view.flags = header->flags;
+        view.frameId = header->frameId;
+        view.sequenceNumber = header->sequenceNumber;
+        view.duplicateOfSequence = header->sequenceNumber - header->duplicateDistance;
+        view.timestampNs = header->timestamp;
+        view.captureTimeNs = header->captureTimeNs;
+        view.rowPitch = header->rowPitch;
+
+        // Point at the binary metadata record if the writer stored one; parsing it is up to the consumer
+        view.metadata = nullptr;
+        if (config_.enableMetadata && header->metadataSize >= sizeof(FrameMetadataRecord) &&
+            header->metadataOffset + sizeof(FrameMetadataRecord) <= impl_->headerStride) {
+            view.metadata = reinterpret_cast<const FrameMetadataRecord *>(
+                reinterpret_cast<const uint8_t *>(header) + header->metadataOffset);
         }
 
-        // Set the frame ID and timestamp
-        frame->setFrameId(header->frameId);
-        auto timestamp = std::chrono::system_clock::time_point(
-            std::chrono::nanoseconds(header->timestamp));
-        frame->setTimestamp(timestamp);
-
-        // Load metadata if available
-        if (config_.enableMetadata) {
-            auto metadata = impl_->readMetadataJson();
-            if (metadata.contains("last_frame") && metadata["last_frame"].contains("metadata")) {
-                auto &frameMetadataJson = metadata["last_frame"]["metadata"];
+        view.generation = &header->generation;
+        view.expectedGeneration = expectedGeneration;
+        view.rowsReady = &header->rowsReady;
 
-                // Get a mutable reference to the frame metadata
-                FrameMetadata &frameMetadata = frame->getMetadataMutable();
-
-                // Copy metadata fields
-                if (frameMetadataJson.contains("device_id")) {
-                    frameMetadata.deviceId = frameMetadataJson["device_id"];
-                }
-
-                if (frameMetadataJson.contains("exposure_time_ms")) {
-                    frameMetadata.exposureTimeMs = frameMetadataJson["exposure_time_ms"];
-                }
+        // A writer that started reusing the slot meanwhile may have torn the header we just copied
+        if (partial) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t generation = header->generation.load(std::memory_order_relaxed);
+            return generation == expectedGeneration || generation == Impl::writingGeneration(index)
+                   ? Status::OK : Status::READ_FAILED;
+        }
+        if (!view.validate()) {
+            return Status::READ_FAILED;
+        }
 
-                if (frameMetadataJson.contains("frame_number")) {
-                    frameMetadata.frameNumber = frameMetadataJson["frame_number"];
-                }
+        return Status::OK;
+    }
 
-                if (frameMetadataJson.contains("processed")) {
-                    frameMetadata.hasBeenProcessed = frameMetadataJson["processed"];
-                }
+    SharedMemory::Status SharedMemory::readBatch(size_t maxCount, unsigned int waitMilliseconds, size_t &count,
+                                                 const std::function<Status(uint64_t, size_t)> &mapSlot) {
+        count = 0;
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (maxCount == 0) {
+            return Status::INVALID_SIZE;
+        }
 
-                if (frameMetadataJson.contains("calibration_data")) {
-                    frameMetadata.hasCalibrationData = frameMetadataJson["calibration_data"];
-                }
+        // Start time for performance tracking
+        auto startTime = std::chrono::high_resolution_clock::now();
 
-                if (frameMetadataJson.contains("segmentation_data")) {
-                    frameMetadata.hasSegmentationData = frameMetadataJson["segmentation_data"];
-                }
+        // Get this reader's cursor, past the frames its filter rejects
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        uint64_t readIndex = impl_->skipFiltered(writeIndex);
 
-                if (frameMetadataJson.contains("signal_to_noise_ratio")) {
-                    frameMetadata.signalToNoiseRatio = frameMetadataJson["signal_to_noise_ratio"];
-                }
+        // Check if there are any frames available
+        if (readIndex >= writeIndex) {
+            if (waitMilliseconds == 0) {
+                return Status::BUFFER_EMPTY;
+            }
 
-                if (frameMetadataJson.contains("signal_strength")) {
-                    frameMetadata.signalStrength = frameMetadataJson["signal_strength"];
-                }
+            // Sleep on the frame doorbell until the writer publishes the next frame
+            auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMilliseconds);
+            if (!impl_->waitForReadable(readIndex, endTime)) {
+                return Status::TIMEOUT;
+            }
+        }
 
-                if (frameMetadataJson.contains("confidence_score")) {
-                    frameMetadata.confidenceScore = frameMetadataJson["confidence_score"];
-                }
+        Status status = Status::READ_FAILED;
+        uint64_t skipped = 0;
+        uint64_t filtered = 0;
+        uint64_t endIndex = readIndex;
+        uint64_t lastIndex = readIndex;
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS && count == 0 && status != Status::BUFFER_EMPTY; ++attempt) {
+            writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+
+            // A lossy reader that was lapped jumps to the oldest frame the writer is not about to reuse
+            uint64_t oldest = impl_->oldestReadable(writeIndex);
+            if (impl_->canBeLapped() && readIndex < oldest) {
+                skipped += oldest - readIndex;
+                readIndex = oldest;
+            }
 
-                // Copy array data
-                if (frameMetadataJson.contains("probe_position")) {
-                    frameMetadata.probePosition = frameMetadataJson["probe_position"]
-                            .get<std::vector<float> >();
+            // Take every frame already published the filter passes, stopping at the first slot the writer is reusing
+            endIndex = readIndex;
+            filtered = 0;
+            while (count < maxCount && endIndex < writeIndex) {
+                uint64_t index = impl_->nextWanted(endIndex, writeIndex, filtered);
+                if (index >= writeIndex) {
+                    status = count == 0 ? Status::BUFFER_EMPTY : status;
+                    break;
                 }
-
-                if (frameMetadataJson.contains("probe_orientation")) {
-                    frameMetadata.probeOrientation = frameMetadataJson["probe_orientation"]
-                            .get<std::vector<float> >();
+                status = mapSlot(index, count);
+                if (status != Status::OK) {
+                    break;
                 }
+                lastIndex = index;
+                endIndex = index + 1;
+                ++count;
+            }
 
-                // Copy attributes
-                if (frameMetadataJson.contains("attributes") &&
-                    frameMetadataJson["attributes"].is_object()) {
-                    for (auto &[key, value]: frameMetadataJson["attributes"].items()) {
-                        if (value.is_string()) {
-                            frameMetadata.attributes[key] = value.get<std::string>();
-                        }
-                    }
-                }
+            // Lossless readers are never lapped, so a failed generation check cannot heal by retrying
+            if (!impl_->canBeLapped()) {
+                break;
             }
         }
 
+        if (count == 0) {
+            return status;
+        }
+
+        // Advance our cursor once for the whole batch; this wakes a writer waiting on us for free slots
+        impl_->advanceCursor(endIndex, skipped, count, filtered);
+        impl_->prefetchNextPayload(endIndex, *impl_->getFrameHeader(lastIndex));
+
         // Update timestamp
         impl_->controlBlock->lastReadTime.store(
             std::chrono::system_clock::now().time_since_epoch().count(),
             std::memory_order_release);
 
+        // Update statistics
+        impl_->controlBlock->totalFramesRead.fetch_add(count, std::memory_order_relaxed);
+
         // Calculate read latency
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
 
-        // Update statistics
-        {
-            std::lock_guard<std::mutex> lock(statsMutex_);
-            stats_.totalFramesRead++;
-            stats_.readLatencyNsAvg = (stats_.readLatencyNsAvg * (stats_.totalFramesRead - 1) +
-                                       duration) / stats_.totalFramesRead;
-            stats_.maxReadLatencyNs = std::max(stats_.maxReadLatencyNs, static_cast<uint64_t>(duration));
-        }
+        // Update local statistics; the batch's latency is spread over its frames in the average
+        recordRead(count, static_cast<uint64_t>(duration));
 
         return Status::OK;
     }
 
-    SharedMemory::Status SharedMemory::readNextFrame(std::shared_ptr<Frame> &frame,
-                                                     unsigned int waitMilliseconds) {
+    SharedMemory::Status SharedMemory::readFrames(std::vector<std::shared_ptr<Frame>> &frames, size_t maxCount,
+                                                  unsigned int waitMilliseconds) {
+        frames.clear();
+        size_t count = 0;
+        return readBatch(maxCount, waitMilliseconds, count, [this, &frames](uint64_t index, size_t) {
+            std::shared_ptr<Frame> frame;
+            Status status = mapSlotFrame(index, frame);
+            if (status == Status::OK) {
+                frames.push_back(std::move(frame));
+            }
+            return status;
+        });
+    }
+
+    SharedMemory::Status SharedMemory::readFrameViews(FrameView *views, size_t maxCount, size_t &count,
+                                                      unsigned int waitMilliseconds) {
+        if (!views) {
+            count = 0;
+            return Status::INVALID_SIZE;
+        }
+        return readBatch(maxCount, waitMilliseconds, count, [this, views](uint64_t index, size_t position) {
+            return mapSlotView(index, views[position]);
+        });
+    }
+
+    bool SharedMemory::releaseFrameView(const FrameView &view) {
+        bool intact = view.validate();
+
+        // Report the hold time in our slot; 0 means "sampled", so the shortest hold is 1 us
+        ReaderSlot *slot = isInitialized_ ? impl_->ownSlot() : nullptr;
+        if (slot) {
+            uint64_t acquireTimeNs = slot->acquireTimeNs.load(std::memory_order_relaxed);
+            uint64_t now = getMonotonicTimeNanos();
+            uint64_t holdUs = now > acquireTimeNs ? (now - acquireTimeNs) / 1000 : 0;
+            slot->holdTimeUs.store(static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(holdUs, 1), UINT32_MAX)),
+                                   std::memory_order_relaxed);
+        }
+        return intact;
+    }
+
+    SharedMemory::Status SharedMemory::readPartialFrameView(FrameView &view, unsigned int waitMilliseconds) {
         if (!isInitialized_ || !impl_->controlBlock) {
             return Status::NOT_INITIALIZED;
         }
 
-        // Start time for performance tracking
-        auto startTime = std::chrono::high_resolution_clock::now();
-
-        // Get the current read index
-        uint64_t readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        // The next frame this reader would consume, published or with its first band in the ring
+        ControlBlock *controlBlock = impl_->controlBlock;
+        uint64_t readIndex = 0;
+        uint64_t writeIndex = 0;
+        auto available = [&] {
+            writeIndex = controlBlock->writeIndex.load(std::memory_order_acquire);
+            readIndex = impl_->skipFiltered(writeIndex);
+            if (impl_->canBeLapped()) {
+                readIndex = std::max(readIndex, impl_->oldestReadable(writeIndex));
+            }
+            const ReaderSlot *slot = impl_->ownSlot();
+            return readIndex < writeIndex ||
+                   (impl_->hasPartialRows(readIndex) && (!slot || impl_->frameWanted(*slot, readIndex)));
+        };
 
-        // Check if there are any frames available
-        if (readIndex >= writeIndex) {
+        if (!available()) {
             if (waitMilliseconds == 0) {
                 return Status::BUFFER_EMPTY;
             }
 
-            // Wait for a new frame
+            // The band doorbell rings for every band and every published frame
             auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMilliseconds);
+            if (!impl_->waitOnDoorbell(controlBlock->bandDoorbell, controlBlock->bandWaiters, endTime, available)) {
+                return Status::TIMEOUT;
+            }
+        }
 
-            while (readIndex >= writeIndex && std::chrono::steady_clock::now() < endTime) {
-                // Sleep for a short time
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return mapSlotView(readIndex, view, readIndex >= writeIndex);
+    }
+
+    SharedMemory::Status SharedMemory::waitForRows(const FrameView &view, uint32_t rows, uint32_t &ready,
+                                                   unsigned int waitMilliseconds) {
+        ready = 0;
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (!view.generation || !view.rowsReady) {
+            return Status::INVALID_SIZE;
+        }
+
+        // Rows count for the frame only while its slot is still being written for it. A frame the writer
+        // completed and then retired is back at its writing generation with every row counted, but its
+        // sequence number is behind oldestIndex. A copy the writer gave up on clears partialIndex first.
+        rows = std::min(rows, view.height);
+        const uint64_t writingGeneration = view.expectedGeneration - 1;
+        Status status = Status::TIMEOUT;
+        auto settled = [&] {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            bool partial = impl_->controlBlock->partialIndex.load(std::memory_order_acquire) == view.sequenceNumber + 1;
+            uint32_t present = view.rowsReady->load(std::memory_order_acquire);
+            uint64_t generation = view.generation->load(std::memory_order_acquire);
+            if (generation == view.expectedGeneration) {
+                ready = view.height;
+                status = Status::OK;
+            } else if (generation != writingGeneration || (!partial && present < view.height) ||
+                       (present >= view.height &&
+                        impl_->controlBlock->oldestIndex.load(std::memory_order_acquire) > view.sequenceNumber)) {
+                status = Status::READ_FAILED;
+            } else if (present >= rows && present < view.height) {
+                ready = present;
+                status = Status::OK;
+            }
+            return status != Status::TIMEOUT;
+        };
+
+        if (!settled() && waitMilliseconds > 0) {
+            auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMilliseconds);
+            impl_->waitOnDoorbell(impl_->controlBlock->bandDoorbell, impl_->controlBlock->bandWaiters, endTime,
+                                  settled);
+        }
+        return status;
+    }
+
+    SharedMemory::Status SharedMemory::findFrame(uint64_t frameId, std::shared_ptr<Frame> &frame,
+                                                 unsigned int waitMilliseconds) {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
+        }
 
-                // Check again
-                writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(waitMilliseconds);
+        uint64_t searchedUpTo = 0;
+        while (true) {
+            uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+            uint64_t oldest = std::max(impl_->oldestReadable(writeIndex), searchedUpTo);
+
+            // Newest first: the frame we are asked for is usually among the last few published
+            for (uint64_t index = writeIndex; index > oldest; --index) {
+                const FrameHeader *header = impl_->getFrameHeader(index - 1);
+                if (!header || header->generation.load(std::memory_order_acquire) !=
+                               Impl::stableGeneration(index - 1)) {
+                    continue;
+                }
+                if (header->frameId == frameId && mapSlotFrame(index - 1, frame) == Status::OK &&
+                    frame->getFrameId() == frameId) {
+                    return Status::OK;
+                }
             }
 
-            if (readIndex >= writeIndex) {
+            // Only frames published from now on can still match
+            searchedUpTo = writeIndex;
+            frame.reset();
+            if (waitMilliseconds == 0) {
+                return Status::BUFFER_EMPTY;
+            }
+            if (!impl_->waitForFrame(writeIndex, endTime)) {
                 return Status::TIMEOUT;
             }
         }
+    }
 
-        // Get the frame header
-        const FrameHeader *header = impl_->getFrameHeader(readIndex);
-        if (!header) {
-            return Status::INTERNAL_ERROR;
+    SharedMemory::Status SharedMemory::readFrameAt(uint64_t sequence, std::shared_ptr<Frame> &frame) {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
         }
 
-        // Get the frame data
-        void *dataPtr = impl_->getFrameData(readIndex);
-        if (!dataPtr) {
-            return Status::INTERNAL_ERROR;
+        frame.reset();
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        if (sequence >= writeIndex) {
+            return Status::BUFFER_EMPTY;
+        }
+        if (sequence < impl_->oldestReadable(writeIndex)) {
+            return Status::READ_FAILED;
         }
 
-        // Create a frame that maps directly to the shared memory (zero-copy)
-        std::string format = getFormatString(header->formatCode);
-
-        // Create a mapped frame
-        frame = Frame::createMapped(
-            config_.name,
-            reinterpret_cast<uint8_t *>(dataPtr) - reinterpret_cast<uint8_t *>(impl_->mapping),
-            header->dataSize,
-            header->width,
-            header->height,
-            header->bytesPerPixel,
-            format);
+        // The generation check fails if the writer reused the slot since
+        Status status = mapSlotFrame(sequence, frame);
+        if (status != Status::OK) {
+            frame.reset();
+        }
+        return status;
+    }
 
-        if (!frame) {
-            return Status::INTERNAL_ERROR;
+    SharedMemory::Status SharedMemory::readFrameNearest(uint64_t timestampNs, std::shared_ptr<Frame> &frame) {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
         }
 
-        // Set the frame ID and timestamp
-        frame->setFrameId(header->frameId);
-        auto timestamp = std::chrono::system_clock::time_point(
-            std::chrono::nanoseconds(header->timestamp));
-        frame->setTimestamp(timestamp);
+        frame.reset();
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+            uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+            if (writeIndex == 0) {
+                return Status::BUFFER_EMPTY;
+            }
+
+            // An entry that fails its check was overwritten while we searched: start over on the newer ring
+            uint64_t low = impl_->oldestReadable(writeIndex);
+            uint64_t high = writeIndex - 1;
+            uint64_t lowTime = 0;
+            uint64_t highTime = 0;
+            if (!impl_->indexedTime(low, lowTime) || !impl_->indexedTime(high, highTime)) {
+                continue;
+            }
+
+            uint64_t nearest = high;
+            if (timestampNs <= lowTime) {
+                nearest = low;
+            } else if (timestampNs < highTime) {
+                // Invariant: lowTime <= timestampNs < highTime
+                bool lapped = false;
+                while (high - low > 1) {
+                    uint64_t middle = low + (high - low) / 2;
+                    uint64_t middleTime = 0;
+                    if (!impl_->indexedTime(middle, middleTime)) {
+                        lapped = true;
+                        break;
+                    }
+                    if (middleTime <= timestampNs) {
+                        low = middle;
+                        lowTime = middleTime;
+                    } else {
+                        high = middle;
+                        highTime = middleTime;
+                    }
+                }
+                if (lapped) {
+                    continue;
+                }
+                nearest = timestampNs - lowTime <= highTime - timestampNs ? low : high;
+            }
 
-        // Load metadata if available
-        if (config_.enableMetadata) {
-            auto metadata = impl_->readMetadataJson();
-            if (metadata.contains("last_frame") && metadata["last_frame"].contains("metadata")) {
-                auto &frameMetadataJson = metadata["last_frame"]["metadata"];
+            Status status = mapSlotFrame(nearest, frame);
+            if (status != Status::READ_FAILED) {
+                if (status != Status::OK) {
+                    frame.reset();
+                }
+                return status;
+            }
+        }
+        frame.reset();
+        return Status::READ_FAILED;
+    }
 
-                // Get a mutable reference to the frame metadata
-                FrameMetadata &frameMetadata = frame->getMetadataMutable();
+    SharedMemory::Status SharedMemory::pinFrames(uint64_t firstSequence, uint64_t lastSequence,
+                                                 std::vector<std::shared_ptr<Frame>> &frames) {
+        frames.clear();
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (!config_.create) {
+            return Status::NOT_SUPPORTED;
+        }
+        if (firstSequence > lastSequence) {
+            return Status::INVALID_SIZE;
+        }
 
-                // Copy metadata fields
-                if (frameMetadataJson.contains("device_id")) {
-                    frameMetadata.deviceId = frameMetadataJson["device_id"];
+        // Headers are only reused under captureMutex, so frames map without racing the writer. The
+        // lock is taken per batch to keep the writer from waiting long.
+        std::shared_ptr<Impl::PinTable> pins = impl_->pins;
+        const uint64_t pinLimit = impl_->arenaLimit.load(std::memory_order_relaxed) / 2;
+        uint64_t next = lastSequence + 1; // One past the newest frame still to pin
+        bool done = false;
+        while (!done && next > firstSequence) {
+            std::lock_guard<std::mutex> lock(impl_->captureMutex);
+            next = std::min(next, impl_->controlBlock->writeIndex.load(std::memory_order_acquire));
+            auto &live = impl_->livePayloads;
+
+            for (size_t count = 0; count < PIN_BATCH && next > firstSequence; ++count) {
+                uint64_t index = --next;
+                auto extent = std::lower_bound(live.begin(), live.end(), index,
+                                               [](const Impl::PayloadExtent &payload, uint64_t sequence) {
+                                                   return payload.sequence < sequence;
+                                               });
+                if (live.empty() || index < live.front().sequence) {
+                    // Retired, and every older frame with it
+                    done = true;
+                    break;
                 }
-
-                if (frameMetadataJson.contains("exposure_time_ms")) {
-                    frameMetadata.exposureTimeMs = frameMetadataJson["exposure_time_ms"];
+                if (extent == live.end() || extent->sequence != index) {
+                    continue;
                 }
 
-                if (frameMetadataJson.contains("frame_number")) {
-                    frameMetadata.frameNumber = frameMetadataJson["frame_number"];
+                const FrameHeader *header = impl_->getFrameHeader(index);
+                if (!header) {
+                    continue;
                 }
-
-                if (frameMetadataJson.contains("processed")) {
-                    frameMetadata.hasBeenProcessed = frameMetadataJson["processed"];
+                uint64_t offset = extent->start % impl_->arenaSize;
+                uint64_t length = impl_->alignArena(header->dataSize);
+                {
+                    std::lock_guard<std::mutex> pinLock(pins->mutex);
+                    if (pins->payloads.count(offset) == 0 && pins->bytes + length > pinLimit) {
+                        done = true;
+                        break;
+                    }
                 }
 
-                if (frameMetadataJson.contains("calibration_data")) {
-                    frameMetadata.hasCalibrationData = frameMetadataJson["calibration_data"];
+                std::shared_ptr<Frame> frame;
+                if (mapSlotFrame(index, frame) != Status::OK) {
+                    continue;
                 }
 
-                if (frameMetadataJson.contains("segmentation_data")) {
-                    frameMetadata.hasSegmentationData = frameMetadataJson["segmentation_data"];
+                // The payload stays put while pinned; the header copied into the frame may be reused
+                if (frame->getData() == impl_->getArenaData(extent->start)) {
+                    frame->setValidityGuard(nullptr, 0);
+                    {
+                        std::lock_guard<std::mutex> pinLock(pins->mutex);
+                        auto pinned = pins->payloads.emplace(offset, Impl::PinnedPayload{length, 0}).first;
+                        if (pinned->second.frames++ == 0) {
+                            pins->bytes += length;
+                        }
+                        ++pins->frames;
+                        pins->spaceDoorbell = &impl_->controlBlock->spaceDoorbell;
+                        pins->spaceWaiters = &impl_->controlBlock->spaceWaiters;
+                    }
+                    frame->setOnDestroy([pins, offset] {
+                        std::lock_guard<std::mutex> pinLock(pins->mutex);
+                        auto pinned = pins->payloads.find(offset);
+                        if (pinned == pins->payloads.end()) {
+                            return;
+                        }
+                        --pins->frames;
+                        if (--pinned->second.frames == 0) {
+                            pins->bytes -= pinned->second.length;
+                            pins->payloads.erase(pinned);
+                            if (pins->spaceDoorbell) {
+                                futex::ring(*pins->spaceDoorbell, *pins->spaceWaiters);
+                            }
+                        }
+                    });
                 }
+                frames.push_back(std::move(frame));
             }
         }
 
-        // Update the read index
-        impl_->controlBlock->readIndex.store(readIndex + 1, std::memory_order_release);
-
-        // Update timestamp
-        impl_->controlBlock->lastReadTime.store(
-            std::chrono::system_clock::now().time_since_epoch().count(),
-            std::memory_order_release);
+        std::reverse(frames.begin(), frames.end());
+        return frames.empty() ? Status::BUFFER_EMPTY : Status::OK;
+    }
 
-        // Update the frame count
-        uint64_t frameCount = impl_->controlBlock->frameCount.load(std::memory_order_relaxed);
-        if (frameCount > 0) {
-            impl_->controlBlock->frameCount.store(frameCount - 1, std::memory_order_release);
+    SharedMemory::Status SharedMemory::pinRecentFrames(std::chrono::nanoseconds duration,
+                                                       std::vector<std::shared_ptr<Frame>> &frames) {
+        frames.clear();
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return Status::NOT_INITIALIZED;
         }
 
-        // Update statistics
-        impl_->controlBlock->totalFramesRead.fetch_add(1, std::memory_order_relaxed);
-
-        // Calculate read latency
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
-
-        // Update local statistics
-        {
-            std::lock_guard<std::mutex> lock(statsMutex_);
-            stats_.totalFramesRead++;
-            stats_.readLatencyNsAvg = (stats_.readLatencyNsAvg * (stats_.totalFramesRead - 1) +
-                                       duration) / stats_.totalFramesRead;
-            stats_.maxReadLatencyNs = std::max(stats_.maxReadLatencyNs, static_cast<uint64_t>(duration));
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        uint64_t newestTime = 0;
+        if (writeIndex == 0) {
+            return Status::BUFFER_EMPTY;
+        }
+        if (!impl_->indexedTime(writeIndex - 1, newestTime)) {
+            return Status::READ_FAILED;
         }
 
-        return Status::OK;
+        uint64_t span = static_cast<uint64_t>(std::max<int64_t>(0, duration.count()));
+        std::shared_ptr<Frame> oldest;
+        Status status = readFrameNearest(newestTime > span ? newestTime - span : 0, oldest);
+        if (status != Status::OK) {
+            return status;
+        }
+        return pinFrames(oldest->getSequenceNumber(), writeIndex - 1, frames);
     }
 
     SharedMemory::Status SharedMemory::registerFrameCallback(std::function<void(std::shared_ptr<Frame>)> callback) {
@@ -1511,12 +4040,12 @@ namespace medical::imaging {
             stopCallbackThread_ = false;
             callbackThread_ = std::thread(&SharedMemory::notificationThread, this);
 
-            // Set thread priority and affinity if configured
-            if (threadPriority_ != 0) {
+            // Set thread priority and affinity if configured, unless the thread layout places it
+            if (threadPriority_ != 0 && !ThreadLayout::isPlaced("notify")) {
                 setThreadPriority(threadPriority_);
             }
 
-            if (threadAffinity_ >= 0) {
+            if (threadAffinity_ >= 0 && !ThreadLayout::isPlaced("notify")) {
                 setThreadAffinity(threadAffinity_);
             }
         }
@@ -1530,9 +4059,11 @@ namespace medical::imaging {
         // Stop the notification thread if it's running
         if (callbackThread_.joinable()) {
             stopCallbackThread_ = true;
+            interruptWaits();
             lock.unlock();
             callbackThread_.join();
             lock.lock();
+            resumeWaits();
         }
 
         // Clear the callback
@@ -1541,6 +4072,11 @@ namespace medical::imaging {
         return Status::OK;
     }
 
+    void SharedMemory::setReaderDemotionCallback(std::function<void(const ReaderDemotion &)> callback) {
+        std::lock_guard<std::mutex> lock(impl_->demotionMutex);
+        impl_->demotionCallback = std::move(callback);
+    }
+
     SharedMemory::Status SharedMemory::setThreadAffinity(int cpuCore) {
         threadAffinity_ = cpuCore;
 
@@ -1557,7 +4093,7 @@ namespace medical::imaging {
             int result = pthread_setaffinity_np(nativeHandle, sizeof(cpu_set_t), &cpuset);
 
             if (result != 0) {
-                std::cerr << "Failed to set thread affinity: " << result << std::endl;
+                MIVI_LOG_ERROR("Failed to set thread affinity: {}", result);
                 return Status::INTERNAL_ERROR;
             }
         }
@@ -1589,7 +4125,7 @@ namespace medical::imaging {
             int result = pthread_setschedparam(nativeHandle, policy, &param);
 
             if (result != 0) {
-                std::cerr << "Failed to set thread priority: " << result << std::endl;
+                MIVI_LOG_ERROR("Failed to set thread priority: {}", result);
                 return Status::INTERNAL_ERROR;
             }
         }
@@ -1597,16 +4133,29 @@ namespace medical::imaging {
         return Status::OK;
     }
 
+    SharedMemory::Status SharedMemory::prefault() {
+        if (!isInitialized_ || !impl_->mapping) {
+            return Status::NOT_INITIALIZED;
+        }
+
+        std::lock_guard<std::mutex> lock(impl_->resizeMutex);
+        impl_->prefaultMapping();
+        return Status::OK;
+    }
+
     SharedMemory::Status SharedMemory::lockMemory() {
         if (!isInitialized_ || !impl_->mapping) {
             return Status::NOT_INITIALIZED;
         }
 
-        // Lock the memory in RAM to prevent swapping
-        if (mlock(impl_->mapping, impl_->size) != 0) {
-            std::cerr << "Failed to lock memory: " << strerror(errno) << std::endl;
+        // Lock the memory in RAM to prevent swapping; the arena past the part in use is locked as it grows
+        std::lock_guard<std::mutex> lock(impl_->resizeMutex);
+        size_t bytes = impl_->committedRegionBytes();
+        if (mlock(impl_->mapping, bytes) != 0) {
+            MIVI_LOG_ERROR("Failed to lock memory: {}", strerror(errno));
             return Status::PERMISSION_DENIED;
         }
+        impl_->lockedBytes = bytes;
 
         return Status::OK;
     }
@@ -1617,43 +4166,80 @@ namespace medical::imaging {
         }
 
         // Unlock the memory
+        std::lock_guard<std::mutex> lock(impl_->resizeMutex);
         if (munlock(impl_->mapping, impl_->size) != 0) {
-            std::cerr << "Failed to unlock memory: " << strerror(errno) << std::endl;
+            MIVI_LOG_ERROR("Failed to unlock memory: {}", strerror(errno));
             return Status::PERMISSION_DENIED;
         }
+        impl_->lockedBytes = 0;
 
         return Status::OK;
     }
 
     SharedMemory::Statistics SharedMemory::getStatistics() {
-        // Get statistics from the shared control block
-        if (isInitialized_ && impl_->controlBlock) {
-            std::lock_guard<std::mutex> lock(statsMutex_);
-
-            // Update from control block
-            stats_.totalFramesWritten = impl_->controlBlock->totalFramesWritten.load(std::memory_order_relaxed);
-            stats_.totalFramesRead = impl_->controlBlock->totalFramesRead.load(std::memory_order_relaxed);
-            stats_.droppedFrames = impl_->controlBlock->droppedFrames.load(std::memory_order_relaxed);
+        Statistics stats{};
+
+        // Reads of this process
+        uint64_t framesRead = readCounters_.framesRead.load(std::memory_order_relaxed);
+        stats.totalFramesRead = framesRead;
+        stats.readLatencyNsAvg = framesRead ? readCounters_.latencyNsTotal.load(std::memory_order_relaxed) / framesRead : 0;
+        stats.maxReadLatencyNs = readCounters_.maxLatencyNs.load(std::memory_order_relaxed);
+
+        // Readers this instance demoted or detached
+        stats.readersDemotedLag = impl_->readersDemotedLag.load(std::memory_order_relaxed);
+        stats.readersDemotedStale = impl_->readersDemotedStale.load(std::memory_order_relaxed);
+        stats.readersReclaimed = impl_->readersReclaimed.load(std::memory_order_relaxed);
+        stats.framesWithPose = impl_->framesWithPose.load(std::memory_order_relaxed);
+        stats.pinDetours = impl_->pinDetours.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(impl_->pins->mutex);
+            stats.pinnedFrames = impl_->pins->frames;
+            stats.pinnedBytes = impl_->pins->bytes;
+        }
 
-            return stats_;
+        // Writer statistics and the ring-wide counters from the shared control block
+        if (isInitialized_ && impl_->controlBlock) {
+            const ControlBlock *controlBlock = impl_->controlBlock;
+            uint64_t framesWritten = controlBlock->totalFramesWritten.load(std::memory_order_relaxed);
+            stats.totalFramesWritten = framesWritten;
+            stats.totalFramesRead = controlBlock->totalFramesRead.load(std::memory_order_relaxed);
+            stats.droppedFrames = controlBlock->droppedFrames.load(std::memory_order_relaxed);
+            stats.bufferFullCount = controlBlock->bufferFullCount.load(std::memory_order_relaxed);
+            stats.maxWriteLatencyNs = controlBlock->maxWriteLatencyNs.load(std::memory_order_relaxed);
+            stats.peakMemoryUsage = controlBlock->peakMemoryUsage.load(std::memory_order_relaxed);
+            if (framesWritten > 0) {
+                stats.writeLatencyNsAvg = controlBlock->writeLatencyNsTotal.load(std::memory_order_relaxed) /
+                                          framesWritten;
+                stats.averageFrameSize = static_cast<double>(
+                                             controlBlock->bytesWritten.load(std::memory_order_relaxed)) /
+                                         static_cast<double>(framesWritten);
+            }
         }
 
-        // Return local stats if not initialized
-        std::lock_guard<std::mutex> lock(statsMutex_);
-        return stats_;
+        return stats;
     }
 
     void SharedMemory::resetStatistics() {
-        std::lock_guard<std::mutex> lock(statsMutex_);
-
-        stats_ = {};
+        readCounters_.framesRead.store(0, std::memory_order_relaxed);
+        readCounters_.latencyNsTotal.store(0, std::memory_order_relaxed);
+        readCounters_.maxLatencyNs.store(0, std::memory_order_relaxed);
 
         // Reset control block stats if initialized
         if (isInitialized_ && impl_->controlBlock && config_.create) {
-            impl_->controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
+            ControlBlock *controlBlock = impl_->controlBlock;
+            controlBlock->droppedFrames.store(0, std::memory_order_relaxed);
+            controlBlock->bufferFullCount.store(0, std::memory_order_relaxed);
+            controlBlock->maxWriteLatencyNs.store(0, std::memory_order_relaxed);
+            controlBlock->peakMemoryUsage.store(0, std::memory_order_relaxed);
         }
     }
 
+    void SharedMemory::recordRead(uint64_t count, uint64_t latencyNs) {
+        readCounters_.framesRead.fetch_add(count, std::memory_order_relaxed);
+        readCounters_.latencyNsTotal.fetch_add(latencyNs, std::memory_order_relaxed);
+        storeMax(readCounters_.maxLatencyNs, latencyNs);
+    }
+
     std::string SharedMemory::getName() const {
         return config_.name;
     }
@@ -1666,16 +4252,339 @@ namespace medical::imaging {
         return config_.type;
     }
 
+    const SharedMemory::Config &SharedMemory::getConfig() const {
+        return config_;
+    }
+
+    SharedMemory::Config SharedMemory::getAttachConfig() const {
+        Config config = config_;
+        config.create = false;
+        if (config_.type == SharedMemoryType::MEMFD && isInitialized_) {
+            config.attachDescriptor = impl_->fd;
+            config.attachLayout = getLayout();
+        }
+        return config;
+    }
+
+    size_t SharedMemory::getPageSize() const {
+        return impl_->pageSize;
+    }
+
+    std::string SharedMemory::getPageBacking() const {
+        return impl_->pageBacking;
+    }
+
+    int SharedMemory::getNumaNode() const {
+        return impl_->residentNode;
+    }
+
     size_t SharedMemory::getMaxFrames() const {
         return impl_->maxFrames;
     }
 
+    uint32_t SharedMemory::getWriterEpoch() const {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return 0;
+        }
+        return impl_->controlBlock->writerEpoch.load(std::memory_order_acquire);
+    }
+
+    bool SharedMemory::parseWritePolicy(const std::string &name, WritePolicy &policy) {
+        if (name == "drop") {
+            policy = WritePolicy::DROP_NEWEST;
+        } else if (name == "overwrite") {
+            policy = WritePolicy::OVERWRITE;
+        } else if (name == "block") {
+            policy = WritePolicy::BLOCK;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    const char *SharedMemory::toString(WritePolicy policy) {
+        switch (policy) {
+            case WritePolicy::DROP_NEWEST: return "drop";
+            case WritePolicy::OVERWRITE: return "overwrite";
+            case WritePolicy::BLOCK: return "block";
+        }
+        return "unknown";
+    }
+
+    const char *SharedMemory::toString(SharedMemoryType type) {
+        switch (type) {
+            case SharedMemoryType::POSIX_SHM: return "posix";
+            case SharedMemoryType::SYSV_SHM: return "sysv";
+            case SharedMemoryType::MEMORY_MAPPED_FILE: return "mmf";
+            case SharedMemoryType::HUGE_PAGES: return "huge";
+            case SharedMemoryType::MEMFD: return "memfd";
+        }
+        return "unknown";
+    }
+
+    SharedMemoryType SharedMemory::selectFastestType(const Config &config,
+                                                     const std::vector<SharedMemoryType> &candidates,
+                                                     std::vector<BackendBenchmark> *results) {
+        // A 1080p UYVY frame, the common case, through a ring that never wraps the reader
+        constexpr int width = 1920;
+        constexpr int height = 1080;
+        constexpr size_t probeFrames = 8;
+        constexpr int warmupFrames = 16;
+        constexpr int measuredFrames = 64;
+
+        auto frame = Frame::create(width, height, 2, PixelFormat::YUV422_8);
+        if (!frame || candidates.empty()) {
+            return candidates.empty() ? config.type : candidates.front();
+        }
+        std::memset(frame->getData(), 0x80, frame->getDataSize());
+
+        SharedMemoryType fastest = candidates.front();
+        uint64_t fastestNs = UINT64_MAX;
+        for (SharedMemoryType type: candidates) {
+            BackendBenchmark result{type, false, "", 0, 0};
+
+            Config probeConfig = config;
+            probeConfig.name = config.name + "_probe_" + std::to_string(getpid());
+            probeConfig.filePath = "/dev/shm/" + probeConfig.name;
+            if (type == SharedMemoryType::SYSV_SHM) {
+                // SysV keys are derived from a path with ftok()
+                probeConfig.name = "/tmp/" + probeConfig.name;
+            }
+            probeConfig.type = type;
+            probeConfig.create = true;
+            probeConfig.persistent = false;
+            probeConfig.lockInMemory = false;
+            probeConfig.enableRealTimeThreads = false;
+            probeConfig.captureBuffers = 0;
+            probeConfig.writePolicy = WritePolicy::OVERWRITE;
+            probeConfig.maxFrames = probeFrames;
+            probeConfig.maxFrameSize = frame->getDataSize();
+            probeConfig.size = (probeFrames + 1) * (frame->getDataSize() + 64 * 1024) + 1024 * 1024;
+
+            {
+                SharedMemory writer(probeConfig);
+                std::unique_ptr<SharedMemory> reader;
+                if (writer.initialize() == Status::OK) {
+                    Config readerConfig = writer.getAttachConfig();
+                    readerConfig.readerMode = ReaderMode::LOSSY;
+                    readerConfig.prefault = false;
+                    reader = std::make_unique<SharedMemory>(readerConfig);
+                    if (reader->initialize() != Status::OK) {
+                        reader.reset();
+                    }
+                }
+
+                if (reader) {
+                    std::vector<uint64_t> writeTimes;
+                    std::vector<uint64_t> readTimes;
+                    uint64_t checksum = 0;
+                    for (int i = 0; i < warmupFrames + measuredFrames; ++i) {
+                        frame->setFrameId(static_cast<uint64_t>(i));
+                        uint64_t start = getMonotonicTimeNanos();
+                        Status writeStatus = writer.writeFrame(frame);
+                        uint64_t written = getMonotonicTimeNanos();
+
+                        std::shared_ptr<Frame> received;
+                        if (writeStatus != Status::OK || reader->readNextFrame(received, 0) != Status::OK ||
+                            !received) {
+                            break;
+                        }
+                        const auto *bytes = static_cast<const volatile uint8_t *>(received->getData());
+                        for (size_t offset = 0; offset < received->getDataSize(); offset += 64) {
+                            checksum += bytes[offset];
+                        }
+                        bool valid = received->validate();
+                        uint64_t read = getMonotonicTimeNanos();
+
+                        if (valid && i >= warmupFrames) {
+                            writeTimes.push_back(written - start);
+                            readTimes.push_back(read - written);
+                        }
+                    }
+
+                    if (!writeTimes.empty() && checksum != 0) {
+                        std::nth_element(writeTimes.begin(), writeTimes.begin() + writeTimes.size() / 2,
+                                         writeTimes.end());
+                        std::nth_element(readTimes.begin(), readTimes.begin() + readTimes.size() / 2,
+                                         readTimes.end());
+                        result.available = true;
+                        result.pageBacking = writer.getPageBacking();
+                        result.writeNs = writeTimes[writeTimes.size() / 2];
+                        result.readNs = readTimes[readTimes.size() / 2];
+                        if (result.writeNs + result.readNs < fastestNs) {
+                            fastestNs = result.writeNs + result.readNs;
+                            fastest = type;
+                        }
+                    }
+                }
+            }
+
+            // The probe rings must not outlive the benchmark, whatever the backend keeps by default
+            if (type == SharedMemoryType::MEMORY_MAPPED_FILE) {
+                unlink(probeConfig.filePath.c_str());
+            } else if (type == SharedMemoryType::SYSV_SHM) {
+                unlink(probeConfig.name.c_str());
+            }
+
+            if (results) {
+                results->push_back(std::move(result));
+            }
+        }
+        return fastest;
+    }
+
+    bool SharedMemory::wasAdopted() const {
+        return impl_->adopted;
+    }
+
+    void *SharedMemory::getMappingAddress() const {
+        return isInitialized_ ? impl_->mapping : nullptr;
+    }
+
+    size_t SharedMemory::getMappingSize() const {
+        return isInitialized_ ? impl_->size : 0;
+    }
+
+    size_t SharedMemory::getArenaSize() const {
+        return impl_->arenaSize;
+    }
+
+    SharedMemory::Status SharedMemory::resizeArena(size_t bytes) {
+        if (!isInitialized_ || !impl_->mapping) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (!config_.create) {
+            return Status::NOT_SUPPORTED;
+        }
+
+        return impl_->resizeArena(bytes);
+    }
+
+    size_t SharedMemory::getArenaLimit() const {
+        return impl_->arenaLimit.load(std::memory_order_relaxed);
+    }
+
+    size_t SharedMemory::getCommittedArenaBytes() const {
+        std::lock_guard<std::mutex> lock(impl_->resizeMutex);
+        return impl_->arenaCommitted;
+    }
+
+    SharedMemory::Layout SharedMemory::getLayout() const {
+        Layout layout{};
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return layout;
+        }
+
+        layout.regionSize = impl_->size;
+        layout.dataOffset = impl_->dataOffset;
+        layout.headerStride = impl_->headerStride;
+        layout.slotMetadataSize = impl_->slotMetadataSize;
+        layout.maxFrames = impl_->maxFrames;
+        layout.arenaOffset = impl_->arenaOffset;
+        layout.arenaSize = impl_->arenaSize;
+        layout.maxFrameSize = impl_->maxFrameSize;
+        layout.pageSize = impl_->pageSize;
+        layout.layoutHash = impl_->controlBlock->layoutHash;
+        layout.type = static_cast<uint32_t>(impl_->type);
+        layout.pageBacking = impl_->pageBacking == "hugetlbfs" ? 2 : impl_->pageBacking == "transparent" ? 1 : 0;
+        layout.numaNode = impl_->residentNode;
+        layout.writerEpoch = impl_->controlBlock->writerEpoch.load(std::memory_order_acquire);
+        layout.payloadAlignment = static_cast<uint32_t>(impl_->payloadAlignment);
+        layout.rowAlignment = static_cast<uint32_t>(impl_->rowAlignment);
+        return layout;
+    }
+
+    int SharedMemory::getFileDescriptor() const {
+        return isInitialized_ ? impl_->fd : -1;
+    }
+
+    SharedMemory::Geometry SharedMemory::getGeometry() const {
+        Geometry geometry{0, 0, 0, 0, PixelFormat::UNKNOWN};
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return geometry;
+        }
+
+        // Seqlock: retry while the producer is between the two epoch stores
+        const ControlBlock *controlBlock = impl_->controlBlock;
+        uint32_t epoch;
+        do {
+            epoch = controlBlock->geometryEpoch.load(std::memory_order_acquire);
+            geometry.width = controlBlock->geometryWidth;
+            geometry.height = controlBlock->geometryHeight;
+            geometry.bytesPerPixel = controlBlock->geometryBytesPerPixel;
+            geometry.format = pixelFormatFromCode(controlBlock->geometryFormat);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((epoch & 1) != 0 || controlBlock->geometryEpoch.load(std::memory_order_relaxed) != epoch);
+
+        geometry.epoch = epoch / 2;
+        return geometry;
+    }
+
+    int SharedMemory::acquireCaptureBuffer(size_t size) {
+        if (!isInitialized_ || !config_.create || size == 0 || size > impl_->maxFrameSize) {
+            return -1;
+        }
+
+        std::lock_guard<std::mutex> lock(impl_->captureMutex);
+        for (size_t i = 0; i < impl_->captureLeases.size(); ++i) {
+            Impl::CaptureLease &lease = impl_->captureLeases[i];
+            if (!lease.inUse) {
+                if (!impl_->reservePayload(size, lease.start)) {
+                    return -1;
+                }
+                lease = Impl::CaptureLease{true, true, size, lease.start};
+                return static_cast<int>(i);
+            }
+        }
+
+        return -1;
+    }
+
+    void *SharedMemory::getCaptureBufferData(int lease) const {
+        // Asked once per captured frame; the rebind below needs the arena bookkeeping writeFrame()
+        // updates under the same lock, which neither side holds for more than a lease lookup or reservation
+        std::lock_guard<std::mutex> lock(impl_->captureMutex);
+        if (lease < 0 || static_cast<size_t>(lease) >= impl_->captureLeases.size() ||
+            !impl_->captureLeases[lease].inUse) {
+            return nullptr;
+        }
+
+        // The ring took the previous space with the last frame published from this lease
+        Impl::CaptureLease &captureLease = impl_->captureLeases[lease];
+        if (!captureLease.bound) {
+            if (!impl_->reservePayload(captureLease.size, captureLease.start)) {
+                return nullptr;
+            }
+            captureLease.bound = true;
+        }
+
+        return impl_->getArenaData(captureLease.start);
+    }
+
+    void SharedMemory::releaseCaptureBuffer(int lease) {
+        std::lock_guard<std::mutex> lock(impl_->captureMutex);
+        if (lease >= 0 && static_cast<size_t>(lease) < impl_->captureLeases.size()) {
+            impl_->captureLeases[lease].inUse = false;
+            impl_->captureLeases[lease].bound = false;
+        }
+    }
+
+    bool SharedMemory::isCaptureBuffer(const void *data) const {
+        std::lock_guard<std::mutex> lock(impl_->captureMutex);
+        return data && impl_->findCaptureLease(data) >= 0;
+    }
+
+    size_t SharedMemory::getCaptureBufferCount() const {
+        return impl_->captureLeaseCount;
+    }
+
     size_t SharedMemory::getCurrentFrameCount() const {
         if (!isInitialized_ || !impl_->controlBlock) {
             return 0;
         }
 
-        return impl_->controlBlock->frameCount.load(std::memory_order_relaxed);
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        return writeIndex - std::min(writeIndex, impl_->readableTail(writeIndex));
     }
 
     bool SharedMemory::isBufferFull() const {
@@ -1684,8 +4593,7 @@ namespace medical::imaging {
         }
 
         uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
-        uint64_t readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-        return (writeIndex - readIndex) >= impl_->maxFrames;
+        return (writeIndex - impl_->computeTail(writeIndex)) >= impl_->maxFrames;
     }
 
     bool SharedMemory::isBufferEmpty() const {
@@ -1694,8 +4602,173 @@ namespace medical::imaging {
         }
 
         uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
-        uint64_t readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-        return readIndex >= writeIndex;
+        return impl_->currentCursor() >= writeIndex;
+    }
+
+    size_t SharedMemory::getReaderCount() const {
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return 0;
+        }
+
+        size_t count = 0;
+        for (size_t i = 0; i < impl_->readerSlotCount; ++i) {
+            if (impl_->readerSlots[i].state.load(std::memory_order_acquire) == Impl::READER_ACTIVE) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    void SharedMemory::interruptWaits() {
+        impl_->waitsInterrupted.store(true, std::memory_order_seq_cst);
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return;
+        }
+
+        // Filtered readers sleep on their own slot's doorbell instead of the frame doorbell
+        futex::ring(impl_->controlBlock->frameDoorbell, impl_->controlBlock->frameWaiters);
+        if (ReaderSlot *slot = impl_->ownSlot()) {
+            futex::ring(slot->doorbell, slot->doorbellWaiters);
+        }
+    }
+
+    void SharedMemory::resumeWaits() {
+        impl_->waitsInterrupted.store(false, std::memory_order_seq_cst);
+    }
+
+    std::vector<SharedMemory::ReaderInfo> SharedMemory::getReaders() const {
+        std::vector<ReaderInfo> readers;
+        if (!isInitialized_ || !impl_->controlBlock) {
+            return readers;
+        }
+
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        for (size_t i = 0; i < impl_->readerSlotCount; ++i) {
+            if (impl_->readerSlots[i].state.load(std::memory_order_acquire) == Impl::READER_ACTIVE) {
+                readers.push_back(impl_->describeReader(i, writeIndex));
+            }
+        }
+
+        return readers;
+    }
+
+    bool SharedMemory::getOwnReader(ReaderInfo &info) const {
+        if (!isInitialized_ || !impl_->controlBlock || !impl_->ownSlot()) {
+            return false;
+        }
+
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
+        info = impl_->describeReader(static_cast<size_t>(impl_->ownReaderSlot), writeIndex);
+        return true;
+    }
+
+    std::vector<SharedMemory::ReaderLatency> SharedMemory::getReaderLatency() const {
+        std::vector<ReaderLatency> latencies;
+        if (!isInitialized_ || !impl_->controlBlock || !impl_->readerLatency) {
+            return latencies;
+        }
+
+        for (size_t i = 0; i < impl_->readerSlotCount && i < MAX_READERS; ++i) {
+            const Impl::ReaderLatencyTracker *tracker = &impl_->readerLatency[i];
+            bool active = impl_->readerSlots[i].state.load(std::memory_order_acquire) == Impl::READER_ACTIVE;
+            if (!active || tracker->pid == 0) {
+                continue;
+            }
+
+            ReaderLatency latency{};
+            latency.slot = i;
+            latency.pid = static_cast<pid_t>(tracker->pid);
+            latency.mode = tracker->mode;
+            latency.latency = tracker->latency.snapshot();
+            latency.holdTime = tracker->holdTime.snapshot();
+            latency.lag = tracker->lag.snapshot();
+            latencies.push_back(std::move(latency));
+        }
+
+        return latencies;
+    }
+
+    int SharedMemory::getReaderSlot() const {
+        return impl_->ownReaderSlot;
+    }
+
+    SharedMemory::Status SharedMemory::setReaderFilter(const ReaderFilter &filter) {
+        ReaderSlot *slot = impl_->ownSlot();
+        if (!isInitialized_ || !slot) {
+            return Status::NOT_INITIALIZED;
+        }
+
+        config_.readerFilter = filter;
+        Impl::storeFilter(*slot, filter);
+
+        // A reader asleep on its own doorbell re-checks which frames it wants
+        futex::ring(slot->doorbell, slot->doorbellWaiters);
+        return Status::OK;
+    }
+
+    SharedMemory::Status SharedMemory::addReaderNotification(size_t slot, pid_t pid, int descriptor) {
+        if (!isInitialized_ || !impl_->readerSlots || !config_.create) {
+            return Status::NOT_INITIALIZED;
+        }
+        const ReaderSlot *readerSlot = slot < impl_->readerSlotCount ? &impl_->readerSlots[slot] : nullptr;
+        if (descriptor < 0 || !readerSlot ||
+            readerSlot->state.load(std::memory_order_acquire) != Impl::READER_ACTIVE ||
+            readerSlot->pid.load(std::memory_order_relaxed) != static_cast<uint32_t>(pid)) {
+            return Status::INVALID_SIZE;
+        }
+
+        std::lock_guard<std::mutex> lock(impl_->notificationMutex);
+        // A reader subscribing again replaces its old descriptor
+        for (auto it = impl_->notifications.begin(); it != impl_->notifications.end(); ++it) {
+            if (it->slot == slot) {
+                close(it->descriptor);
+                impl_->notifications.erase(it);
+                break;
+            }
+        }
+        impl_->notifications.push_back({slot, static_cast<uint32_t>(pid), descriptor});
+        impl_->notificationCount.store(impl_->notifications.size(), std::memory_order_relaxed);
+        return Status::OK;
+    }
+
+    SharedMemory::Status SharedMemory::setNotificationDescriptor(int descriptor) {
+        if (!isInitialized_ || !impl_->ownSlot() || descriptor < 0) {
+            return Status::NOT_INITIALIZED;
+        }
+
+        std::lock_guard<std::mutex> lock(impl_->notificationMutex);
+        if (impl_->notificationDescriptor >= 0) {
+            close(impl_->notificationDescriptor);
+        }
+        impl_->notificationDescriptor = descriptor;
+        return Status::OK;
+    }
+
+    int SharedMemory::getNotificationDescriptor() const {
+        return impl_->notificationDescriptor;
+    }
+
+    bool SharedMemory::armNotification() {
+        ReaderSlot *slot = impl_->ownSlot();
+        if (!isInitialized_ || !slot) {
+            return false;
+        }
+
+        // Consume the last signal, then arm and re-check: a frame published before the arm is seen
+        // here, one published after it signals the descriptor
+        if (impl_->notificationDescriptor >= 0) {
+            uint64_t count = 0;
+            ssize_t drained = read(impl_->notificationDescriptor, &count, sizeof(count));
+            (void) drained; // EAGAIN when it was not signalled
+        }
+        slot->heartbeatNs.store(getMonotonicTimeNanos(), std::memory_order_relaxed);
+        slot->notifyArmed.store(1, std::memory_order_seq_cst);
+        uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_seq_cst);
+        if (writeIndex > impl_->skipFiltered(writeIndex)) {
+            slot->notifyArmed.store(0, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
     }
 
     SharedMemory::Status SharedMemory::updateMetadata(const std::string &key, const std::string &value) {
@@ -1740,60 +4813,92 @@ namespace medical::imaging {
             return;
         }
 
-        // Initial read index
-        uint64_t lastReadIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
+        ThreadLayout::applyCurrentThread("notify");
+
+        // Stopping interrupts the wait, so an idle writer leaves the thread parked on the doorbell
+        constexpr auto IDLE_WAIT = std::chrono::seconds(10);
 
         while (!stopCallbackThread_) {
-            // Get the current indices
-            uint64_t writeIndex = impl_->controlBlock->writeIndex.load(std::memory_order_acquire);
-            uint64_t readIndex = impl_->controlBlock->readIndex.load(std::memory_order_acquire);
-
-            // Check if there are new frames
-            if (writeIndex > lastReadIndex) {
-                // Process all new frames
-                for (uint64_t i = lastReadIndex; i < writeIndex; ++i) {
-                    // Get the frame
-                    std::shared_ptr<Frame> frame;
-
-                    if (readNextFrame(frame, 0) == Status::OK && frame) {
-                        // Call the callback
-                        std::unique_lock<std::mutex> lock(callbackMutex_);
-                        if (frameCallback_) {
-                            frameCallback_(frame);
-                        }
-                    }
+            // Block until the writer rings the frame doorbell
+            std::shared_ptr<Frame> frame;
+            Status status = readNextFrame(frame, static_cast<unsigned int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(IDLE_WAIT).count()));
+
+            if (status == Status::OK && frame) {
+                // Call the callback
+                std::unique_lock<std::mutex> lock(callbackMutex_);
+                if (frameCallback_) {
+                    frameCallback_(frame);
                 }
-
-                // Update the last read index
-                lastReadIndex = writeIndex;
+            } else if (status != Status::OK && status != Status::TIMEOUT) {
+                // Unexpected read failure - back off instead of spinning on the same slot
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
             }
-
-            // Sleep for a short time
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
 
-    uint32_t SharedMemory::getFormatCode(const std::string &format) {
-        if (format == "YUV" || format == "YUV422") {
-            return 0x01;
-        } else if (format == "BGRA" || format == "RGB" || format == "RGBA") {
-            return 0x02;
-        } else if (format == "YUV10" || format == "YUV422_10") {
-            return 0x03;
-        } else if (format == "RGB10") {
-            return 0x04;
-        } else {
-            return 0xFF; // Unknown
+    void SharedMemory::packMetadataRecord(const FrameMetadata &metadata, FrameMetadataRecord &record) {
+        record.version = FRAME_METADATA_VERSION;
+        record.flags = 0;
+        if (metadata.hasSegmentationData) {
+            record.flags |= FRAME_FLAG_SEGMENTATION;
+        }
+        if (metadata.hasCalibrationData) {
+            record.flags |= FRAME_FLAG_CALIBRATION;
+        }
+        if (metadata.hasBeenProcessed) {
+            record.flags |= FRAME_FLAG_PROCESSED;
+        }
+        if (metadata.sourceWidth != 0) {
+            record.flags |= FRAME_FLAG_CROPPED;
         }
+        if (metadata.hasImageStatistics) {
+            record.flags |= FRAME_FLAG_STATISTICS;
+        }
+
+        // FrameMetadata mirrors the rest of the record field for field
+        std::memcpy(&record.frameNumber, &metadata.frameNumber, FRAME_METADATA_RECORD_BYTES);
+    }
+
+    void SharedMemory::packImageStatistics(const ImageStatistics &statistics, FrameMetadataRecord &record) {
+        record.flags |= FRAME_FLAG_STATISTICS;
+        record.signalToNoiseRatio = statistics.signalToNoiseRatio;
+        record.signalStrength = statistics.meanLuminance;
+        record.statisticsPixelCount = statistics.pixelCount;
+        record.meanLuminance = statistics.meanLuminance;
+        record.luminanceVariance = statistics.luminanceVariance;
+        record.saturatedFraction = statistics.saturatedFraction;
+        std::copy_n(statistics.histogram, std::size(record.luminanceHistogram), record.luminanceHistogram);
     }
 
-    std::string SharedMemory::getFormatString(uint32_t formatCode) {
-        switch (formatCode) {
-            case 0x01: return "YUV";
-            case 0x02: return "BGRA";
-            case 0x03: return "YUV10";
-            case 0x04: return "RGB10";
-            default: return "Unknown";
+    void SharedMemory::unpackMetadataRecord(const FrameMetadataRecord &record, FrameMetadata &metadata) {
+        if (record.version == 0) {
+            return;
+        }
+
+        metadata.hasSegmentationData = (record.flags & FRAME_FLAG_SEGMENTATION) != 0;
+        metadata.hasCalibrationData = (record.flags & FRAME_FLAG_CALIBRATION) != 0;
+        metadata.hasBeenProcessed = (record.flags & FRAME_FLAG_PROCESSED) != 0;
+        metadata.hasImageStatistics = record.version >= 3 && (record.flags & FRAME_FLAG_STATISTICS) != 0;
+
+        // Counts and the attribute size are clamped by the accessors, so nothing written
+        // into the record can make a reader run past its fixed fields
+        std::memcpy(&metadata.frameNumber, &record.frameNumber, FRAME_METADATA_RECORD_BYTES);
+        metadata.deviceId = metadata.deviceId.view(); // Terminate an ID that filled its field
+
+        // Fields later versions appended are reserved bytes in older records
+        if (record.version < 2) {
+            metadata.roiX = 0;
+            metadata.roiY = 0;
+            metadata.sourceWidth = 0;
+            metadata.sourceHeight = 0;
+        }
+        if (!metadata.hasImageStatistics) {
+            metadata.statisticsPixelCount = 0;
+            metadata.meanLuminance = 0.0f;
+            metadata.luminanceVariance = 0.0f;
+            metadata.saturatedFraction = 0.0f;
+            metadata.luminanceHistogram.fill(0);
         }
     }
 
@@ -1803,6 +4908,12 @@ namespace medical::imaging {
         return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
     }
 
+    uint64_t SharedMemory::getMonotonicTimeNanos() {
+        auto now = std::chrono::steady_clock::now();
+        auto duration = now.time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
     size_t SharedMemory::calculateFrameOffset(uint64_t index) const {
         return impl_->calculateFrameOffset(index);
     }
@@ -1816,7 +4927,7 @@ namespace medical::imaging {
             auto metadata = nlohmann::json::parse(json);
             return impl_->updateMetadataJson(metadata);
         } catch (const std::exception &e) {
-            std::cerr << "Failed to parse JSON metadata: " << e.what() << std::endl;
+            MIVI_LOG_ERROR("Failed to parse JSON metadata: {}", e.what());
             return false;
         }
     }
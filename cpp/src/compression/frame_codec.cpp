@@ -0,0 +1,386 @@
+#include "compression/frame_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/cpu_features.h"
+
+#if defined(MIVI_HAVE_LZ4)
+#include <lz4.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MIVI_CODEC_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIVI_CODEC_NEON 1
+#endif
+
+namespace medical::imaging {
+    namespace {
+        constexpr size_t MAX_VARINT_BYTES = 10;
+
+        using DeltaKernel = void (*)(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count);
+
+        // Scalar references; the SIMD kernels fall back to them for the tail
+        void subtractScalar(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<uint8_t>(a[i] - b[i]);
+            }
+        }
+
+        void addScalar(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<uint8_t>(a[i] + b[i]);
+            }
+        }
+
+#if defined(MIVI_CODEC_X86)
+        __attribute__((target("avx2")))
+        void subtractAvx2(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count) {
+            size_t i = 0;
+            for (; i + 32 <= count; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_sub_epi8(x, y));
+            }
+            subtractScalar(a + i, b + i, out + i, count - i);
+        }
+
+        __attribute__((target("avx2")))
+        void addAvx2(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count) {
+            size_t i = 0;
+            for (; i + 32 <= count; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_add_epi8(x, y));
+            }
+            addScalar(a + i, b + i, out + i, count - i);
+        }
+#endif
+
+#if defined(MIVI_CODEC_NEON)
+        void subtractNeon(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count) {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                vst1q_u8(out + i, vsubq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+            }
+            subtractScalar(a + i, b + i, out + i, count - i);
+        }
+
+        void addNeon(const uint8_t *a, const uint8_t *b, uint8_t *out, size_t count) {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                vst1q_u8(out + i, vaddq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+            }
+            addScalar(a + i, b + i, out + i, count - i);
+        }
+#endif
+
+        struct Kernels {
+            const char *name;
+            DeltaKernel subtract;
+            DeltaKernel add;
+        };
+
+        const Kernels &getKernels() {
+            return cpu::selectKernels([]([[maybe_unused]] const cpu::Features &features) -> Kernels {
+#if defined(MIVI_CODEC_X86)
+                if (features.avx2) {
+                    return {"avx2", subtractAvx2, addAvx2};
+                }
+#elif defined(MIVI_CODEC_NEON)
+                return {"neon", subtractNeon, addNeon};
+#endif
+                return {"scalar", subtractScalar, addScalar};
+            });
+        }
+
+        size_t putVarint(uint8_t *out, uint64_t value) {
+            size_t length = 0;
+            while (value >= 0x80) {
+                out[length++] = static_cast<uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            out[length++] = static_cast<uint8_t>(value);
+            return length;
+        }
+
+        bool getVarint(const uint8_t *&in, const uint8_t *end, uint64_t &value) {
+            value = 0;
+            for (unsigned shift = 0; shift < 64 && in < end; shift += 7) {
+                uint8_t byte = *in++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline bool isZeroWord(const uint8_t *data) {
+            uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            return word == 0;
+        }
+
+        // Alternating zero-run and literal lengths, each pair followed by the literal bytes. Literals are
+        // scanned a word at a time and end at the first zero word, so zero runs shorter than two words may
+        // stay in the literal; two length bytes would eat most of their saving anyway
+        size_t encodeZeroRun(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity) {
+            size_t pos = 0;
+            size_t out = 0;
+            while (pos < size) {
+                size_t literal = pos;
+                while (literal + 8 <= size && isZeroWord(src + literal)) {
+                    literal += 8;
+                }
+                while (literal < size && src[literal] == 0) {
+                    ++literal;
+                }
+
+                size_t end = literal;
+                while (end + 8 <= size && !isZeroWord(src + end)) {
+                    end += 8;
+                }
+                if (end + 8 > size) {
+                    end = size;
+                }
+                // Trailing zeros join the next run; src[literal] is non-zero, so the literal never empties
+                while (end > literal && src[end - 1] == 0) {
+                    --end;
+                }
+
+                size_t literalSize = end - literal;
+                if (out + 2 * MAX_VARINT_BYTES + literalSize > capacity) {
+                    return 0;
+                }
+                out += putVarint(dst + out, literal - pos);
+                out += putVarint(dst + out, literalSize);
+                std::memcpy(dst + out, src + literal, literalSize);
+                out += literalSize;
+                pos = end;
+            }
+            return out;
+        }
+
+        bool decodeZeroRun(const uint8_t *src, size_t size, uint8_t *dst, size_t rawSize) {
+            const uint8_t *in = src;
+            const uint8_t *end = src + size;
+            size_t out = 0;
+            while (in < end) {
+                uint64_t zeros = 0;
+                uint64_t literalSize = 0;
+                if (!getVarint(in, end, zeros) || !getVarint(in, end, literalSize) ||
+                    zeros > rawSize - out || literalSize > rawSize - out - zeros ||
+                    literalSize > static_cast<uint64_t>(end - in)) {
+                    return false;
+                }
+                std::memset(dst + out, 0, zeros);
+                out += zeros;
+                std::memcpy(dst + out, in, literalSize);
+                out += literalSize;
+                in += literalSize;
+            }
+            return out == rawSize;
+        }
+    } // namespace
+
+    FrameCodec::FrameCodec(Codec codec, bool useDelta, uint32_t keyFrameInterval)
+        : codec_(codec),
+          useDelta_(useDelta),
+          keyFrameInterval_(std::max<uint32_t>(keyFrameInterval, 1)),
+          framesSinceKeyFrame_(0),
+          hasReference_(false),
+          referenceFrameId_(0) {
+    }
+
+    FrameCodec::Codec FrameCodec::getCodec() const {
+        return codec_;
+    }
+
+    bool FrameCodec::isAvailable(Codec codec) {
+        switch (codec) {
+            case Codec::STORED:
+            case Codec::ZERO_RUN:
+                return true;
+            case Codec::LZ4:
+#if defined(MIVI_HAVE_LZ4)
+                return true;
+#else
+                return false;
+#endif
+        }
+        return false;
+    }
+
+    const char *FrameCodec::toString(Codec codec) {
+        switch (codec) {
+            case Codec::STORED: return "stored";
+            case Codec::ZERO_RUN: return "zero-run";
+            case Codec::LZ4: return "lz4";
+        }
+        return "unknown";
+    }
+
+    bool FrameCodec::fromString(std::string_view name, Codec &codec) {
+        if (name == "zero-run" || name == "zrle") {
+            codec = Codec::ZERO_RUN;
+            return true;
+        }
+        if (name == "lz4") {
+            codec = Codec::LZ4;
+            return true;
+        }
+        return false;
+    }
+
+    size_t FrameCodec::maxEncodedSize(size_t rawSize) {
+        // Anything that would grow is stored as it is
+        return sizeof(CompressedFrameHeader) + rawSize;
+    }
+
+    size_t FrameCodec::encode(const void *data, size_t size, uint64_t frameId, void *output, size_t capacity) {
+        if (!data || size == 0 || size > UINT32_MAX || capacity < maxEncodedSize(size)) {
+            return 0;
+        }
+        const auto *raw = static_cast<const uint8_t *>(data);
+
+        // Deltas need a reference of the same size; anything else starts a new chain
+        bool delta = useDelta_ && hasReference_ && reference_.size() == size &&
+                     framesSinceKeyFrame_ < keyFrameInterval_ - 1;
+        const uint8_t *source = raw;
+        if (delta) {
+            scratch_.resize(size);
+            getKernels().subtract(raw, reference_.data(), scratch_.data(), size);
+            source = scratch_.data();
+        }
+
+        auto *header = static_cast<CompressedFrameHeader *>(output);
+        auto *body = static_cast<uint8_t *>(output) + sizeof(CompressedFrameHeader);
+        size_t bodyCapacity = size;
+        size_t bodySize = 0;
+        Codec codec = codec_;
+        if (codec == Codec::ZERO_RUN) {
+            bodySize = encodeZeroRun(source, size, body, bodyCapacity);
+        }
+#if defined(MIVI_HAVE_LZ4)
+        if (codec == Codec::LZ4) {
+            int written = LZ4_compress_default(reinterpret_cast<const char *>(source), reinterpret_cast<char *>(body),
+                                               static_cast<int>(size), static_cast<int>(bodyCapacity));
+            bodySize = written > 0 ? static_cast<size_t>(written) : 0;
+        }
+#endif
+        if (bodySize == 0 || bodySize >= size) {
+            // Incompressible: store the frame itself, which also serves as a key frame
+            codec = Codec::STORED;
+            delta = false;
+            std::memcpy(body, raw, size);
+            bodySize = size;
+        }
+
+        std::memcpy(header->magic, COMPRESSED_FRAME_MAGIC, sizeof(COMPRESSED_FRAME_MAGIC));
+        header->codec = static_cast<uint8_t>(codec);
+        header->flags = delta ? COMPRESSED_FLAG_DELTA : 0;
+        header->headerSize = static_cast<uint16_t>(sizeof(CompressedFrameHeader));
+        header->rawSize = static_cast<uint32_t>(size);
+        header->bodySize = static_cast<uint32_t>(bodySize);
+        header->frameId = frameId;
+        header->referenceFrameId = delta ? referenceFrameId_ : 0;
+
+        if (useDelta_) {
+            reference_.assign(raw, raw + size);
+            referenceFrameId_ = frameId;
+            hasReference_ = true;
+        }
+        framesSinceKeyFrame_ = delta ? framesSinceKeyFrame_ + 1 : 0;
+        return sizeof(CompressedFrameHeader) + bodySize;
+    }
+
+    FrameCodec::Status FrameCodec::decode(const void *input, size_t size, void *output, size_t capacity) {
+        if (!input || size < sizeof(CompressedFrameHeader)) {
+            return Status::INVALID_DATA;
+        }
+        CompressedFrameHeader header{};
+        std::memcpy(&header, input, sizeof(header));
+        if (std::memcmp(header.magic, COMPRESSED_FRAME_MAGIC, sizeof(COMPRESSED_FRAME_MAGIC)) != 0 ||
+            header.headerSize < sizeof(CompressedFrameHeader) || header.headerSize > size ||
+            header.bodySize > size - header.headerSize) {
+            return Status::INVALID_DATA;
+        }
+        if (header.rawSize > capacity) {
+            return Status::OUTPUT_TOO_SMALL;
+        }
+
+        bool delta = (header.flags & COMPRESSED_FLAG_DELTA) != 0;
+        if (delta && (!hasReference_ || referenceFrameId_ != header.referenceFrameId ||
+                      reference_.size() != header.rawSize)) {
+            return Status::MISSING_REFERENCE;
+        }
+
+        const auto *body = static_cast<const uint8_t *>(input) + header.headerSize;
+        auto *out = static_cast<uint8_t *>(output);
+        uint8_t *target = out;
+        if (delta) {
+            scratch_.resize(header.rawSize);
+            target = scratch_.data();
+        }
+
+        bool ok = false;
+        switch (static_cast<Codec>(header.codec)) {
+            case Codec::STORED:
+                ok = header.bodySize == header.rawSize;
+                if (ok) {
+                    std::memcpy(target, body, header.rawSize);
+                }
+                break;
+            case Codec::ZERO_RUN:
+                ok = decodeZeroRun(body, header.bodySize, target, header.rawSize);
+                break;
+            case Codec::LZ4:
+#if defined(MIVI_HAVE_LZ4)
+                ok = LZ4_decompress_safe(reinterpret_cast<const char *>(body), reinterpret_cast<char *>(target),
+                                         static_cast<int>(header.bodySize), static_cast<int>(header.rawSize)) ==
+                     static_cast<int>(header.rawSize);
+                break;
+#else
+                return Status::NOT_SUPPORTED;
+#endif
+            default:
+                return Status::INVALID_DATA;
+        }
+        if (!ok) {
+            hasReference_ = false;
+            return Status::INVALID_DATA;
+        }
+
+        if (delta) {
+            getKernels().add(reference_.data(), scratch_.data(), out, header.rawSize);
+        }
+        reference_.assign(out, out + header.rawSize);
+        referenceFrameId_ = header.frameId;
+        hasReference_ = true;
+        return Status::OK;
+    }
+
+    const char *FrameCodec::getKernelName() {
+        return getKernels().name;
+    }
+
+    void FrameCodec::reset() {
+        hasReference_ = false;
+        referenceFrameId_ = 0;
+        framesSinceKeyFrame_ = 0;
+    }
+
+    bool FrameCodec::isKeyFrame(const void *input, size_t size) {
+        if (!input || size < sizeof(CompressedFrameHeader)) {
+            return false;
+        }
+        CompressedFrameHeader header{};
+        std::memcpy(&header, input, sizeof(header));
+        return std::memcmp(header.magic, COMPRESSED_FRAME_MAGIC, sizeof(COMPRESSED_FRAME_MAGIC)) == 0 &&
+               (header.flags & COMPRESSED_FLAG_DELTA) == 0;
+    }
+} // namespace medical::imaging
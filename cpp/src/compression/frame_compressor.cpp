@@ -0,0 +1,187 @@
+#include "compression/frame_compressor.h"
+#include "communication/ring_stage.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+#include <vector>
+
+namespace medical::imaging {
+    // How long the compressor sleeps waiting for the next frame; stop() interrupts the wait
+    constexpr unsigned int FRAME_WAIT_MS = 1000;
+
+    FrameCompressor::FrameCompressor(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false),
+          framesCompressed_(0),
+          keyFrames_(0),
+          bytesIn_(0),
+          bytesOut_(0),
+          framesTorn_(0),
+          framesDropped_(0) {
+    }
+
+    FrameCompressor::~FrameCompressor() {
+        stop();
+    }
+
+    FrameCompressor::Status FrameCompressor::start(const SharedMemory::Config &sourceConfig,
+                                                   const std::shared_ptr<SharedMemory> &output) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (!output || !output->isInitialized() || !FrameCodec::isAvailable(config_.codec)) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        // Attach as a lossy reader: compression must never hold back capture
+        SharedMemory::Config readerConfig = sourceConfig;
+        readerConfig.create = false;
+        readerConfig.readerMode = ReaderMode::LOSSY;
+        readerConfig.lockInMemory = false;
+        auto source = std::make_shared<SharedMemory>(readerConfig);
+        if (source->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Compressor failed to attach to shared memory {}", sourceConfig.name);
+            return Status::CONNECTION_FAILED;
+        }
+
+        source_ = std::move(source);
+        output_ = output;
+        framesCompressed_ = 0;
+        keyFrames_ = 0;
+        bytesIn_ = 0;
+        bytesOut_ = 0;
+        framesTorn_ = 0;
+        framesDropped_ = 0;
+        compressionTimeHistogram_.reset();
+
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&FrameCompressor::compressorThread, this);
+        return Status::OK;
+    }
+
+    FrameCompressor::Status FrameCompressor::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        source_->interruptWaits();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool FrameCompressor::isRunning() const {
+        return isRunning_;
+    }
+
+    const FrameCompressor::Config &FrameCompressor::getConfig() const {
+        return config_;
+    }
+
+    FrameCompressor::Statistics FrameCompressor::getStatistics() const {
+        Statistics stats{};
+        stats.framesCompressed = framesCompressed_.load(std::memory_order_relaxed);
+        stats.keyFrames = keyFrames_.load(std::memory_order_relaxed);
+        stats.bytesIn = bytesIn_.load(std::memory_order_relaxed);
+        stats.bytesOut = bytesOut_.load(std::memory_order_relaxed);
+        stats.framesTorn = framesTorn_.load(std::memory_order_relaxed);
+        stats.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+        stats.compressionRatio = stats.bytesOut > 0
+                                     ? static_cast<double>(stats.bytesIn) / static_cast<double>(stats.bytesOut)
+                                     : 0.0;
+
+        // Our own reader slot tells how far behind the writer we are
+        SharedMemory::ReaderInfo reader{};
+        if (source_ && source_->getOwnReader(reader)) {
+            stats.lagFrames = reader.lag;
+            stats.framesSkipped = reader.framesSkipped;
+        }
+        return stats;
+    }
+
+    std::map<std::string, std::string> FrameCompressor::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["compressor_codec"] = FrameCodec::toString(config_.codec);
+        map["compressor_delta"] = config_.useDelta ? "true" : "false";
+        map["compressor_kernel"] = FrameCodec::getKernelName();
+        map["compressor_frames_compressed"] = std::to_string(stats.framesCompressed);
+        map["compressor_key_frames"] = std::to_string(stats.keyFrames);
+        map["compressor_bytes_in"] = std::to_string(stats.bytesIn);
+        map["compressor_bytes_out"] = std::to_string(stats.bytesOut);
+        map["compressor_ratio"] = std::to_string(stats.compressionRatio);
+        map["compressor_frames_torn"] = std::to_string(stats.framesTorn);
+        map["compressor_frames_dropped"] = std::to_string(stats.framesDropped);
+        map["compressor_frames_skipped"] = std::to_string(stats.framesSkipped);
+        map["compressor_lag_frames"] = std::to_string(stats.lagFrames);
+        appendHistogramStatistics(map, "compressor_time", compressionTimeHistogram_.snapshot());
+        return map;
+    }
+
+    const LatencyHistogram &FrameCompressor::getCompressionTimeHistogram() const {
+        return compressionTimeHistogram_;
+    }
+
+    void FrameCompressor::compressorThread() {
+        if (!ThreadLayout::applyCurrentThread(config_.threadRole) && config_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        FrameCodec codec(config_.codec, config_.useDelta, config_.keyFrameInterval);
+        std::vector<uint8_t> staging;
+
+        runRingStage(*source_, stopRequested_, FRAME_WAIT_MS, framesTorn_, [&](const Frame &frame, auto &intact) {
+            auto start = std::chrono::steady_clock::now();
+            size_t rawSize = frame.getDataSize();
+            size_t capacity = FrameCodec::maxEncodedSize(rawSize);
+
+            // Encode into a staging buffer: a lease would hold arena space for the worst case, while
+            // writeFrame() only copies the few bytes the frame compressed to
+            staging.resize(capacity);
+            void *output = staging.data();
+
+            size_t encodedSize = codec.encode(frame.getData(), rawSize, frame.getFrameId(), output, capacity);
+            bool keyFrame = FrameCodec::isKeyFrame(output, encodedSize);
+
+            // The writer may have lapped us while we were reading the slot; the reference is torn too
+            bool published = false;
+            if (encodedSize == 0) {
+                framesDropped_.fetch_add(1, std::memory_order_relaxed);
+            } else if (intact()) {
+                published = publishDerivedFrame(*output_, frame, output, encodedSize);
+                if (!published) {
+                    framesDropped_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            if (published) {
+                framesCompressed_.fetch_add(1, std::memory_order_relaxed);
+                bytesIn_.fetch_add(rawSize, std::memory_order_relaxed);
+                bytesOut_.fetch_add(encodedSize, std::memory_order_relaxed);
+                if (keyFrame) {
+                    keyFrames_.fetch_add(1, std::memory_order_relaxed);
+                }
+            } else {
+                // Nobody can decode a delta against a frame that was never published
+                codec.reset();
+            }
+
+            compressionTimeHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+        });
+
+        codec.reset();
+    }
+} // namespace medical::imaging
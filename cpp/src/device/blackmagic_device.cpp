@@ -1,7 +1,10 @@
 #include "device/blackmagic_device.h"
 #include "DeckLinkAPI.h"
 #include "utils/refiid_compare.h"
-#include <iostream>
+#include "communication/shared_memory.h"
+#include "utils/frame_trace.h"
+#include "utils/log.h"
+#include "utils/numa.h"
 #include <sstream>
 #include <cstring>
 #include <chrono>
@@ -10,8 +13,6 @@
 #include <sys/mman.h>
 #include <cmath>
 #include <fcntl.h>
-#include <iomanip>
-#include <numeric>
 
 namespace medical::imaging {
     /**
@@ -33,11 +34,27 @@ namespace medical::imaging {
                 return S_OK;
             }
 
+            // The SDK owns this thread; pin it once per capture next to the buffers
+            if (!device_->callbackThreadBound_.exchange(true, std::memory_order_relaxed)) {
+                device_->bindCallbackThread();
+            }
+
+            // Without a source the card keeps delivering frames; the service drops to a keep-alive rate
+            bool signal = (videoFrame->GetFlags() & bmdFrameHasNoInputSource) == 0;
+            if (device_->inputSignal_.exchange(signal, std::memory_order_relaxed) != signal) {
+                if (signal) {
+                    MIVI_LOG_INFO("Input signal restored on {}", device_->deviceId_);
+                } else {
+                    MIVI_LOG_WARNING("No input signal on {}", device_->deviceId_);
+                }
+            }
+
             // Update performance metrics
             device_->updatePerformanceMetrics(videoFrame);
 
-            // Get the current time for latency calculation
-            auto now = std::chrono::high_resolution_clock::now();
+            // Time the conversion into our Frame type
+            auto convertStart = std::chrono::steady_clock::now();
+            FrameTrace::record(TracePoint::CONVERT_BEGIN, 0);
 
             // Convert Blackmagic frame to our Frame type using the appropriate method
             std::shared_ptr<Frame> frame;
@@ -51,6 +68,27 @@ namespace medical::imaging {
                 frame = device_->convertFrame(videoFrame, audioPacket);
             }
 
+            device_->convertTimeHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - convertStart).count()));
+            FrameTrace::record(TracePoint::CONVERT_END, frame ? frame->getFrameId() : 0);
+
+            // Number frames by input slot, so frames the SDK never delivered leave a gap consumers can see
+            int64_t slot = device_->streamSlotOf(videoFrame);
+            if (slot >= 0) {
+                if (device_->lastStreamSlot_ >= 0 && slot > device_->lastStreamSlot_ + 1) {
+                    device_->droppedFrames_.fetch_add(static_cast<uint64_t>(slot - device_->lastStreamSlot_ - 1),
+                                                      std::memory_order_relaxed);
+                }
+                device_->lastStreamSlot_ = slot;
+                if (frame) {
+                    frame->getMetadataMutable().frameNumber = static_cast<uint32_t>(slot);
+                }
+            }
+            if (!frame) {
+                device_->droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+            }
+
             if (frame && device_->frameCallback_) {
                 device_->frameCallback_(frame);
             }
@@ -67,7 +105,7 @@ namespace medical::imaging {
                 return S_OK;
             }
 
-            std::cout << "Video input format changed event received" << std::endl;
+            MIVI_LOG_INFO("Video input format changed event received");
 
             // Get the new format details
             const long width = displayMode->GetWidth();
@@ -98,8 +136,9 @@ namespace medical::imaging {
                                       count() < 2);
 
             if (isDuplicateChange) {
-                std::cout << "Ignoring duplicate format change event for mode ID: " << displayModeId
-                        << " (received within 2 seconds of last change)" << std::endl;
+                MIVI_LOG_INFO("Ignoring duplicate format change event for mode ID: {} "
+                              "(received within 2 seconds of last change)",
+                        displayModeId);
                 return S_OK;
             }
 
@@ -116,10 +155,8 @@ namespace medical::imaging {
                                   device_->currentConfig_.pixelFormat != device_->getPixelFormatString(pixelFormat));
 
             if (formatChanged) {
-                std::cout << "Video format changed: " << width << "x" << height
-                        << " @ " << frameRate << " fps, format: "
-                        << device_->getPixelFormatString(pixelFormat)
-                        << " (Mode ID: " << displayModeId << ")" << std::endl;
+                MIVI_LOG_INFO("Video format changed: {}x{} @ {} fps, format: {} (Mode ID: {})",
+                        width, height, frameRate, device_->getPixelFormatString(pixelFormat), displayModeId);
 
                 // Update the current configuration
                 device_->currentConfig_.width = width;
@@ -129,83 +166,42 @@ namespace medical::imaging {
 
                 // Only restart if capture is active
                 if (device_->isCapturing_) {
-                    std::cout << "Restarting capture with new format" << std::endl;
-
-                    // Stop capture before making changes
-                    device_->deckLinkInput_->StopStreams();
+                    MIVI_LOG_INFO("Restarting capture with new format");
 
-                    // Ensure any processing completes
-                    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                    // Pause rather than stop: the SDK keeps its buffers and callbacks, and frames
+                    // already delivered stay valid
+                    device_->deckLinkInput_->PauseStreams();
 
                     // CRITICAL CHANGE: Enable video input WITH format detection flag
                     // This is the correct order - enable input with desired flags before starting streams
-                    HRESULT result = device_->deckLinkInput_->EnableVideoInput(
+                    HRESULT result = device_->enableVideoInput(
                         displayModeId, pixelFormat, bmdVideoInputEnableFormatDetection);
 
                     if (FAILED(result)) {
-                        std::cerr << "Failed to enable video input with new format. HRESULT: 0x"
-                                << std::hex << result << std::dec << std::endl;
+                        MIVI_LOG_ERROR("Failed to enable video input with new format. HRESULT: 0x{:x}", result);
                         return S_OK;
                     }
 
-                    // Release lock while updating buffer pool
-                    lock.unlock();
-
-                    // If resolution changed, reinitialize buffer pool
-                    if (resolutionChanged) {
-                        std::lock_guard<std::mutex> poolLock(device_->bufferPoolMutex_);
-
-                        // Mark all buffers as not in use
-                        for (auto &buffer: device_->bufferPool_) {
-                            buffer.inUse = false;
-                        }
-
-                        // Wait for in-process frames
-                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-                        // Clear existing buffers
-                        for (auto &buffer: device_->bufferPool_) {
-                            if (buffer.memory) {
-                                free(buffer.memory);
-                                buffer.memory = nullptr;
-                            }
-                        }
-
-                        // Calculate new buffer size
-                        size_t newBufferSize = width * height *
-                                               (device_->currentConfig_.pixelFormat == "YUV" ? 2 : 4);
-
-                        std::cout << "Reinitializing buffer pool with new size: " << newBufferSize
-                                << " bytes for " << device_->bufferPool_.size() << " buffers" << std::endl;
-
-                        // Reinitialize buffers
-                        for (size_t i = 0; i < device_->bufferPool_.size(); ++i) {
-                            device_->bufferPool_[i].memory = malloc(newBufferSize);
-                            if (!device_->bufferPool_[i].memory) {
-                                std::cerr << "ERROR: Failed to allocate buffer memory" << std::endl;
-                                continue;
-                            }
-                            device_->bufferPool_[i].size = newBufferSize;
-                            device_->bufferPool_[i].inUse = false;
-                        }
+                    // The pool is sized for the largest supported mode, so it is kept as it is. A mode
+                    // that still does not fit is captured into SDK memory and copied.
+                    size_t newFrameBytes = estimateFrameBytes(device_->currentConfig_.pixelFormat, width, height);
+                    if (newFrameBytes > device_->bufferPoolFrameBytes_) {
+                        MIVI_LOG_WARNING("Frames of {} bytes exceed the buffer pool size of {} bytes, "
+                                         "copying them instead",
+                                newFrameBytes, device_->bufferPoolFrameBytes_.load());
                     }
 
-                    // Reacquire lock
-                    lock.lock();
-
-                    // RESTART STREAMS - Format detection is already enabled
+                    // Drop frames queued in the old format and restart
+                    device_->deckLinkInput_->FlushStreams();
                     result = device_->deckLinkInput_->StartStreams();
                     if (FAILED(result)) {
-                        std::cerr << "Failed to restart streams after format change. HRESULT: 0x"
-                                << std::hex << result << std::dec << std::endl;
+                        MIVI_LOG_ERROR("Failed to restart streams after format change. HRESULT: 0x{:x}", result);
                     } else {
-                        std::cout << "Successfully restarted streams with new format" << std::endl;
+                        MIVI_LOG_INFO("Successfully restarted streams with new format");
                     }
-
-                    // REMOVED: The problematic re-enabling of format detection after StartStreams
                 }
             } else {
-                std::cout << "Ignoring format change event - no actual format change detected" << std::endl;
+                MIVI_LOG_INFO("Ignoring format change event - no actual format change detected");
             }
 
             return S_OK;
@@ -244,6 +240,178 @@ namespace medical::imaging {
         std::atomic<ULONG> refCount_;
     };
 
+    /**
+     * @brief Video buffer allocator that lets the SDK capture into the shared memory arena
+     *
+     * Every buffer the SDK asks for is backed by a SharedMemory capture buffer lease, so the
+     * card DMAs frames straight into the ring and writeFrame() only has to fill in the header.
+     * When all leases are taken (e.g. consumers still hold earlier frames) it falls back to
+     * page-aligned heap memory and those frames are copied as before.
+     */
+    class BlackmagicDevice::SharedMemoryAllocatorProvider final : public IDeckLinkVideoBufferAllocatorProvider,
+                                                                  public IDeckLinkVideoBufferAllocator {
+    public:
+        explicit SharedMemoryAllocatorProvider(std::shared_ptr<SharedMemory> sharedMemory)
+            : sharedMemory_(std::move(sharedMemory)), bufferSize_(0), heapFallbacks_(0), refCount_(1) {
+        }
+
+        // IDeckLinkVideoBufferAllocatorProvider interface
+        HRESULT STDMETHODCALLTYPE GetVideoBufferAllocator(uint32_t bufferSize, uint32_t width, uint32_t height,
+                                                          uint32_t rowBytes, BMDPixelFormat /*pixelFormat*/,
+                                                          IDeckLinkVideoBufferAllocator **allocator) override {
+            if (!allocator) {
+                return E_POINTER;
+            }
+
+            bufferSize_ = bufferSize;
+            MIVI_LOG_INFO("Capture buffers for {}x{} ({} bytes per row, {} bytes) allocated from shared memory",
+                    width, height, rowBytes, bufferSize);
+
+            *allocator = static_cast<IDeckLinkVideoBufferAllocator *>(this);
+            AddRef();
+            return S_OK;
+        }
+
+        // IDeckLinkVideoBufferAllocator interface
+        HRESULT STDMETHODCALLTYPE AllocateVideoBuffer(IDeckLinkVideoBuffer **allocatedBuffer) override {
+            if (!allocatedBuffer) {
+                return E_POINTER;
+            }
+
+            int lease = sharedMemory_->acquireCaptureBuffer(bufferSize_);
+            void *heapMemory = nullptr;
+            if (lease < 0) {
+                if (posix_memalign(&heapMemory, 4096, bufferSize_) != 0) {
+                    *allocatedBuffer = nullptr;
+                    return E_OUTOFMEMORY;
+                }
+                heapFallbacks_++;
+            }
+
+            *allocatedBuffer = new VideoBuffer(sharedMemory_, lease, heapMemory);
+            return S_OK;
+        }
+
+        // IUnknown interface
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, LPVOID *ppv) override {
+            if (!ppv) {
+                return E_POINTER;
+            }
+
+            if (iid == IID_IUnknown || iid == IID_IDeckLinkVideoBufferAllocatorProvider) {
+                *ppv = static_cast<IDeckLinkVideoBufferAllocatorProvider *>(this);
+                AddRef();
+                return S_OK;
+            }
+
+            if (iid == IID_IDeckLinkVideoBufferAllocator) {
+                *ppv = static_cast<IDeckLinkVideoBufferAllocator *>(this);
+                AddRef();
+                return S_OK;
+            }
+
+            *ppv = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override {
+            return ++refCount_;
+        }
+
+        ULONG STDMETHODCALLTYPE Release() override {
+            ULONG newRefValue = --refCount_;
+            if (newRefValue == 0) {
+                delete this;
+            }
+            return newRefValue;
+        }
+
+        // Number of buffers that had to come from the heap because no capture lease was free
+        uint64_t getHeapFallbacks() const {
+            return heapFallbacks_;
+        }
+
+    private:
+        /**
+         * @brief One SDK video buffer, backed by a capture lease or by heap memory
+         *
+         * Publishing a frame hands the lease's space to the ring and the lease gets new space,
+         * so the address is resolved on every GetBytes() rather than cached.
+         */
+        class VideoBuffer final : public IDeckLinkVideoBuffer {
+        public:
+            VideoBuffer(std::shared_ptr<SharedMemory> sharedMemory, int lease, void *heapMemory)
+                : sharedMemory_(std::move(sharedMemory)), lease_(lease), heapMemory_(heapMemory), refCount_(1) {
+            }
+
+            // IDeckLinkVideoBuffer interface
+            HRESULT STDMETHODCALLTYPE GetBytes(void **buffer) override {
+                if (!buffer) {
+                    return E_POINTER;
+                }
+
+                *buffer = lease_ >= 0 ? sharedMemory_->getCaptureBufferData(lease_) : heapMemory_;
+                return *buffer ? S_OK : E_FAIL;
+            }
+
+            HRESULT STDMETHODCALLTYPE StartAccess(BMDBufferAccessFlags /*flags*/) override {
+                return S_OK;
+            }
+
+            HRESULT STDMETHODCALLTYPE EndAccess(BMDBufferAccessFlags /*flags*/) override {
+                return S_OK;
+            }
+
+            // IUnknown interface
+            HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, LPVOID *ppv) override {
+                if (!ppv) {
+                    return E_POINTER;
+                }
+
+                if (iid == IID_IUnknown || iid == IID_IDeckLinkVideoBuffer) {
+                    *ppv = static_cast<IDeckLinkVideoBuffer *>(this);
+                    AddRef();
+                    return S_OK;
+                }
+
+                *ppv = nullptr;
+                return E_NOINTERFACE;
+            }
+
+            ULONG STDMETHODCALLTYPE AddRef() override {
+                return ++refCount_;
+            }
+
+            ULONG STDMETHODCALLTYPE Release() override {
+                ULONG newRefValue = --refCount_;
+                if (newRefValue == 0) {
+                    delete this;
+                }
+                return newRefValue;
+            }
+
+        private:
+            ~VideoBuffer() override {
+                if (lease_ >= 0) {
+                    sharedMemory_->releaseCaptureBuffer(lease_);
+                }
+                free(heapMemory_);
+            }
+
+            std::shared_ptr<SharedMemory> sharedMemory_;
+            int lease_;
+            void *heapMemory_;
+            std::atomic<ULONG> refCount_;
+        };
+
+        ~SharedMemoryAllocatorProvider() override = default;
+
+        std::shared_ptr<SharedMemory> sharedMemory_;
+        std::atomic<uint32_t> bufferSize_;
+        std::atomic<uint64_t> heapFallbacks_;
+        std::atomic<ULONG> refCount_;
+    };
+
     BlackmagicDevice::BlackmagicDevice(void *deckLink)
         : deckLink_(static_cast<IDeckLink *>(deckLink)),
           deckLinkInput_(nullptr),
@@ -252,8 +420,23 @@ namespace medical::imaging {
           status_(nullptr),
           externalMemory_(nullptr),
           externalMemorySize_(0),
+          allocatorProvider_(nullptr),
+          freeBufferHead_(BUFFER_LIST_END),
+          bufferPoolEpoch_(0),
+          bufferPoolFrameBytes_(0),
+          bufferPoolExhausted_(0),
+          hardwareTimestampFrames_(0),
+          sdkBuffersOutstanding_(0),
+          sdkBuffersOutstandingPeak_(0),
+          numaNode_(-1),
+          placementNode_(-1),
+          bufferPoolNode_(-1),
+          callbackThreadBound_(false),
+          inputSignal_(true),
           frameCount_(0),
           droppedFrames_(0),
+          lastStreamSlot_(-1),
+          frameIntervalAvgNs_(0),
           isCapturing_(false),
           isDmaEnabled_(false),
           isGpuDirectEnabled_(false) {
@@ -297,6 +480,10 @@ namespace medical::imaging {
 
         // Query device capabilities
         queryCapabilities();
+
+        // Buffers and the callback thread follow the card unless the config says otherwise
+        numaNode_ = discoverNumaNode();
+        placementNode_ = numaNode_;
     }
 
     BlackmagicDevice::~BlackmagicDevice() {
@@ -331,6 +518,11 @@ namespace medical::imaging {
             deckLink_->Release();
             deckLink_ = nullptr;
         }
+
+        if (allocatorProvider_) {
+            allocatorProvider_->Release();
+            allocatorProvider_ = nullptr;
+        }
     }
 
     std::string BlackmagicDevice::getDeviceId() const {
@@ -375,9 +567,9 @@ namespace medical::imaging {
             // Initialize DMA if supported
             if (initializeDMA()) {
                 isDmaEnabled_ = true;
-                std::cout << "DMA enabled for " << deviceName_ << std::endl;
+                MIVI_LOG_INFO("DMA enabled for {}", deviceName_);
             } else {
-                std::cerr << "Failed to initialize DMA for " << deviceName_ << std::endl;
+                MIVI_LOG_ERROR("Failed to initialize DMA for {}", deviceName_);
             }
         }
 
@@ -386,9 +578,9 @@ namespace medical::imaging {
             // Initialize GPU direct if supported
             if (initializeGpuDirect()) {
                 isGpuDirectEnabled_ = true;
-                std::cout << "GPU-Direct enabled for " << deviceName_ << std::endl;
+                MIVI_LOG_INFO("GPU-Direct enabled for {}", deviceName_);
             } else {
-                std::cerr << "Failed to initialize GPU-Direct for " << deviceName_ << std::endl;
+                MIVI_LOG_ERROR("Failed to initialize GPU-Direct for {}", deviceName_);
             }
         }
 
@@ -397,28 +589,41 @@ namespace medical::imaging {
             setDirectOutputToSharedMemory(config.sharedMemoryName);
         }
 
-        // Initialize buffer pool for zero-copy if needed
+        // Capture straight into shared memory when the ring has capture buffers to lend
+        if (allocatorProvider_) {
+            allocatorProvider_->Release();
+            allocatorProvider_ = nullptr;
+        }
+        if (directSharedMemory_ && directSharedMemory_->getCaptureBufferCount() > 0) {
+            allocatorProvider_ = new SharedMemoryAllocatorProvider(directSharedMemory_);
+            MIVI_LOG_INFO("Capturing directly into shared memory '{}' with {} capture buffers",
+                    directSharedMemory_->getName(), directSharedMemory_->getCaptureBufferCount());
+        }
+
+        // Place buffers on the requested node, or the card's own
+        placementNode_ = config.numaNode >= 0 ? config.numaNode : numaNode_;
+
+        // Initialize buffer pool for zero-copy if needed, sized for the largest mode so that input
+        // format changes never have to reallocate it
         if (config.bufferCount > 0) {
-            size_t bufferSize = config.width * config.height *
-                                (config.pixelFormat == "YUV" ? 2 : 4); // Estimate size
+            size_t bufferSize = std::max(estimateFrameBytes(config.pixelFormat, config.width, config.height),
+                                         getLargestFrameBytes());
 
             initializeBufferPool(config.bufferCount, bufferSize);
         }
 
         // Print what we're about to do
-        std::cout << "Enabling video input: " << config.width << "x" << config.height
-                << " @ " << config.frameRate << "fps with format " << config.pixelFormat << std::endl;
-        std::cout << "Display mode: " << displayMode->GetDisplayMode() << std::endl;
+        MIVI_LOG_INFO("Enabling video input: {}x{} @ {}fps with format {}",
+                config.width, config.height, config.frameRate, config.pixelFormat);
+        MIVI_LOG_INFO("Display mode: {}", displayMode->GetDisplayMode());
 
         // Enable the input
-        HRESULT result = deckLinkInput_->EnableVideoInput(
-            displayMode->GetDisplayMode(), pixelFormat, flags);
+        HRESULT result = enableVideoInput(displayMode->GetDisplayMode(), pixelFormat, flags);
 
         displayMode->Release();
 
         if (FAILED(result)) {
-            std::cerr << "Failed to enable video input. HRESULT: 0x"
-                    << std::hex << result << std::dec << std::endl;
+            MIVI_LOG_ERROR("Failed to enable video input. HRESULT: 0x{:x}", result);
             return Status::INIT_FAILED;
         }
 
@@ -428,8 +633,7 @@ namespace medical::imaging {
                 bmdAudioSampleRate48kHz, bmdAudioSampleType16bitInteger, 2);
 
             if (FAILED(result)) {
-                std::cerr << "Failed to enable audio input. HRESULT: 0x"
-                        << std::hex << result << std::dec << std::endl;
+                MIVI_LOG_ERROR("Failed to enable audio input. HRESULT: 0x{:x}", result);
                 deckLinkInput_->DisableVideoInput();
                 return Status::INIT_FAILED;
             }
@@ -460,16 +664,20 @@ namespace medical::imaging {
         // Reset performance tracking
         frameCount_ = 0;
         droppedFrames_ = 0;
+        lastStreamSlot_ = -1;
         startTime_ = std::chrono::steady_clock::now();
         lastFrameTime_ = startTime_;
-        fpsHistory_.clear();
+        frameIntervalAvgNs_.store(0, std::memory_order_relaxed);
+        captureIntervalHistogram_.reset();
+        convertTimeHistogram_.reset();
+        callbackThreadBound_ = false;
+        inputSignal_ = true;
 
         // Start the streams
-        std::cout << "Starting capture streams..." << std::endl;
+        MIVI_LOG_INFO("Starting capture streams...");
         HRESULT result = deckLinkInput_->StartStreams();
         if (FAILED(result)) {
-            std::cerr << "Failed to start streams. HRESULT: 0x"
-                    << std::hex << result << std::dec << std::endl;
+            MIVI_LOG_ERROR("Failed to start streams. HRESULT: 0x{:x}", result);
             return Status::INTERNAL_ERROR;
         }
 
@@ -491,8 +699,7 @@ namespace medical::imaging {
         // Stop the streams
         HRESULT result = deckLinkInput_->StopStreams();
         if (FAILED(result)) {
-            std::cerr << "Failed to stop streams. HRESULT: 0x"
-                    << std::hex << result << std::dec << std::endl;
+            MIVI_LOG_ERROR("Failed to stop streams. HRESULT: 0x{:x}", result);
             return Status::INTERNAL_ERROR;
         }
 
@@ -637,15 +844,62 @@ namespace medical::imaging {
         return Status::OK;
     }
 
-    double BlackmagicDevice::getCurrentFrameRate() const {
-        std::lock_guard<std::mutex> lock(metricsMutex_);
+    BlackmagicDevice::Status BlackmagicDevice::setDirectOutputToSharedMemory(std::shared_ptr<SharedMemory> sharedMemory) {
+        if (sharedMemory && sharedMemory->getCaptureBufferCount() == 0) {
+            MIVI_LOG_WARNING("Shared memory '{}' has no capture buffers for direct output", sharedMemory->getName());
+            return Status::INVALID_ARGUMENT;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        directSharedMemory_ = std::move(sharedMemory);
 
-        if (fpsHistory_.empty()) {
-            return 0.0;
+        return Status::OK;
+    }
+
+    int BlackmagicDevice::enableVideoInput(uint32_t displayMode, uint32_t pixelFormat, uint32_t flags) {
+        if (allocatorProvider_) {
+            return deckLinkInput_->EnableVideoInputWithAllocatorProvider(
+                displayMode, pixelFormat, flags, allocatorProvider_);
         }
 
-        // Calculate average FPS from recent history
-        return std::accumulate(fpsHistory_.begin(), fpsHistory_.end(), 0.0) / fpsHistory_.size();
+        return deckLinkInput_->EnableVideoInput(displayMode, pixelFormat, flags);
+    }
+
+    double BlackmagicDevice::getCurrentFrameRate() const {
+        uint64_t intervalNs = frameIntervalAvgNs_.load(std::memory_order_relaxed);
+        return intervalNs > 0 ? 1e9 / static_cast<double>(intervalNs) : 0.0;
+    }
+
+    const LatencyHistogram &BlackmagicDevice::getCaptureIntervalHistogram() const {
+        return captureIntervalHistogram_;
+    }
+
+    const LatencyHistogram &BlackmagicDevice::getConvertTimeHistogram() const {
+        return convertTimeHistogram_;
+    }
+
+    uint64_t BlackmagicDevice::getDroppedFrameCount() const {
+        return droppedFrames_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t BlackmagicDevice::getBufferPoolExhaustedCount() const {
+        return bufferPoolExhausted_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t BlackmagicDevice::getDirectCaptureHeapFallbacks() const {
+        return allocatorProvider_ ? allocatorProvider_->getHeapFallbacks() : 0;
+    }
+
+    uint64_t BlackmagicDevice::getOutstandingBufferCount() const {
+        return sdkBuffersOutstanding_.load(std::memory_order_relaxed);
+    }
+
+    int BlackmagicDevice::getNumaNode() const {
+        return numaNode_;
+    }
+
+    bool BlackmagicDevice::hasInputSignal() const {
+        return inputSignal_.load(std::memory_order_relaxed);
     }
 
     std::map<std::string, std::string> BlackmagicDevice::getDiagnostics() const {
@@ -656,6 +910,7 @@ namespace medical::imaging {
         diagnostics["device_name"] = deviceName_;
         diagnostics["device_model"] = deviceModel_;
         diagnostics["is_capturing"] = isCapturing_ ? "true" : "false";
+        diagnostics["input_signal"] = hasInputSignal() ? "true" : "false";
 
         // Add configuration
         diagnostics["width"] = std::to_string(currentConfig_.width);
@@ -669,16 +924,11 @@ namespace medical::imaging {
         diagnostics["supports_hardware_timestamps"] = capabilities_.supportsHardwareTimestamps ? "true" : "false";
 
         // Add performance metrics
-        std::lock_guard<std::mutex> lock(metricsMutex_);
         diagnostics["frame_count"] = std::to_string(frameCount_);
         diagnostics["dropped_frames"] = std::to_string(droppedFrames_);
-
-        if (!fpsHistory_.empty()) {
-            double avgFps = std::accumulate(fpsHistory_.begin(), fpsHistory_.end(), 0.0) / fpsHistory_.size();
-            diagnostics["average_fps"] = std::to_string(avgFps);
-        } else {
-            diagnostics["average_fps"] = "0.0";
-        }
+        diagnostics["average_fps"] = std::to_string(getCurrentFrameRate());
+        appendHistogramStatistics(diagnostics, "capture_interval", captureIntervalHistogram_.snapshot());
+        appendHistogramStatistics(diagnostics, "convert_time", convertTimeHistogram_.snapshot());
 
         // Add connected interfaces
         diagnostics["has_input_interface"] = deckLinkInput_ ? "true" : "false";
@@ -689,6 +939,20 @@ namespace medical::imaging {
         // Check if DMA is enabled
         diagnostics["dma_enabled"] = isDmaEnabled_ ? "true" : "false";
         diagnostics["gpu_direct_enabled"] = isGpuDirectEnabled_ ? "true" : "false";
+        diagnostics["numa_node"] = std::to_string(numaNode_);
+        diagnostics["placement_numa_node"] = std::to_string(placementNode_.load(std::memory_order_relaxed));
+        diagnostics["buffer_pool_numa_node"] = std::to_string(bufferPoolNode_.load(std::memory_order_relaxed));
+        diagnostics["buffer_pool_exhausted"] = std::to_string(bufferPoolExhausted_.load(std::memory_order_relaxed));
+        diagnostics["buffer_pool_frame_bytes"] = std::to_string(bufferPoolFrameBytes_.load(std::memory_order_relaxed));
+        diagnostics["hardware_timestamped_frames"] =
+                std::to_string(hardwareTimestampFrames_.load(std::memory_order_relaxed));
+        diagnostics["sdk_buffers_outstanding"] = std::to_string(sdkBuffersOutstanding_.load(std::memory_order_relaxed));
+        diagnostics["sdk_buffers_outstanding_peak"] =
+                std::to_string(sdkBuffersOutstandingPeak_.load(std::memory_order_relaxed));
+        diagnostics["direct_shm_capture"] = allocatorProvider_ ? "true" : "false";
+        if (allocatorProvider_) {
+            diagnostics["direct_shm_heap_fallbacks"] = std::to_string(allocatorProvider_->getHeapFallbacks());
+        }
 
         // Add status info if available
         if (status_) {
@@ -731,9 +995,8 @@ namespace medical::imaging {
         // SAFETY CHECK: Verify frame dimensions match our expectations
         std::unique_lock<std::mutex> lock(mutex_);
         if (width != currentConfig_.width || height != currentConfig_.height) {
-            std::cerr << "Warning: Frame dimensions mismatch! Expected: "
-                    << currentConfig_.width << "x" << currentConfig_.height
-                    << ", Received: " << width << "x" << height << std::endl;
+            MIVI_LOG_WARNING("Warning: Frame dimensions mismatch! Expected: {}x{}, Received: {}x{}",
+                    currentConfig_.width, currentConfig_.height, width, height);
 
             // Update configuration to match the actual frame
             currentConfig_.width = width;
@@ -772,7 +1035,7 @@ namespace medical::imaging {
             width,
             height,
             rowBytes / width,
-            getPixelFormatString(pixelFormat),
+            fromBlackmagicPixelFormat(pixelFormat),
             false); // Don't take ownership - let DeckLink manage the buffer
 
         if (!frame) {
@@ -782,24 +1045,19 @@ namespace medical::imaging {
         }
 
         // Set up a custom destructor function to handle the buffer correctly
-        frame->setOnDestroy([videoFrameBuffer]() {
+        uint64_t outstanding = sdkBuffersOutstanding_.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint64_t peak = sdkBuffersOutstandingPeak_.load(std::memory_order_relaxed);
+        while (outstanding > peak &&
+               !sdkBuffersOutstandingPeak_.compare_exchange_weak(peak, outstanding, std::memory_order_relaxed)) {
+        }
+        frame->setOnDestroy([this, videoFrameBuffer]() {
             videoFrameBuffer->EndAccess(bmdBufferAccessRead);
             videoFrameBuffer->Release();
+            sdkBuffersOutstanding_.fetch_sub(1, std::memory_order_relaxed);
         });
 
-        // Get timestamp
-        BMDTimeValue frameTime;
-        BMDTimeScale timeScale;
-        std::chrono::system_clock::time_point timestamp;
-
-        if (SUCCEEDED(videoFrame->GetStreamTime(&frameTime, nullptr, timeScale))) {
-            // Convert to system time
-            timestamp = std::chrono::system_clock::now();
-        } else {
-            timestamp = std::chrono::system_clock::now();
-        }
-
-        frame->setTimestamp(timestamp);
+        // Timestamp the frame from the card's hardware reference clock
+        setCaptureTimestamps(videoFrame, *frame);
 
         // Generate frame ID based on the timestamp
         auto now = std::chrono::high_resolution_clock::now();
@@ -821,29 +1079,29 @@ namespace medical::imaging {
         if (SUCCEEDED(videoFrame->GetTimecode(bmdTimecodeRP188Any, &timecode)) && timecode) {
             const char *timecodeString = nullptr;
             if (SUCCEEDED(timecode->GetString(&timecodeString)) && timecodeString) {
-                metadata.attributes["timecode"] = timecodeString;
+                metadata.attributes.set("timecode", timecodeString);
             }
 
             // Get components
             uint8_t hours, minutes, seconds, frames;
             if (SUCCEEDED(timecode->GetComponents(&hours, &minutes, &seconds, &frames))) {
-                metadata.attributes["timecode_hours"] = std::to_string(hours);
-                metadata.attributes["timecode_minutes"] = std::to_string(minutes);
-                metadata.attributes["timecode_seconds"] = std::to_string(seconds);
-                metadata.attributes["timecode_frames"] = std::to_string(frames);
+                metadata.attributes.set("timecode_hours", std::to_string(hours));
+                metadata.attributes.set("timecode_minutes", std::to_string(minutes));
+                metadata.attributes.set("timecode_seconds", std::to_string(seconds));
+                metadata.attributes.set("timecode_frames", std::to_string(frames));
             }
 
             timecode->Release();
         }
 
         // Add frame flags as metadata
-        metadata.attributes["frame_flags"] = std::to_string(videoFrame->GetFlags());
+        metadata.attributes.set("frame_flags", std::to_string(videoFrame->GetFlags()));
 
         // Check for signal quality info
         if (status_) {
             bool signalLocked;
             if (SUCCEEDED(status_->GetFlag(bmdDeckLinkStatusVideoInputSignalLocked, &signalLocked))) {
-                metadata.attributes["signal_locked"] = signalLocked ? "true" : "false";
+                metadata.attributes.set("signal_locked", signalLocked ? "true" : "false");
 
                 // If signal is locked, assume good quality
                 if (signalLocked) {
@@ -879,10 +1137,9 @@ namespace medical::imaging {
         // Allocate a buffer from the pool or use external memory
         Buffer *buffer = nullptr;
 
-        if (!directSharedMemoryName_.empty()) {
-            // Use direct shared memory output
-            // This would require shared memory implementation specific code
-            // For now, fallback to normal path
+        if (!directSharedMemoryName_.empty() || allocatorProvider_) {
+            // Frames captured through the shared memory allocator already sit in the ring's arena,
+            // wrap them as-is so writeFrame() can publish without copying
             return convertFrame(videoFrame, audioPacket);
         } else if (externalMemory_ && externalMemorySize_ >= dataSize) {
             // Use provided external memory
@@ -943,7 +1200,7 @@ namespace medical::imaging {
             width,
             height,
             rowBytes / width,
-            getPixelFormatString(pixelFormat),
+            fromBlackmagicPixelFormat(pixelFormat),
             false); // Don't take ownership
 
         if (!frame) {
@@ -955,23 +1212,16 @@ namespace medical::imaging {
 
         // Set up a custom destructor function to release the buffer
         if (buffer) {
-            frame->setOnDestroy([this, buffer]() {
-                releaseBuffer(buffer);
+            frame->setOnDestroy([this, buffer, epoch = bufferPoolEpoch_.load(std::memory_order_relaxed)]() {
+                // A pool rebuilt since then no longer owns this buffer
+                if (bufferPoolEpoch_.load(std::memory_order_relaxed) == epoch) {
+                    releaseBuffer(buffer);
+                }
             });
         }
 
         // Set up timestamp and metadata like in the regular convertFrame method
-        BMDTimeValue frameTime;
-        BMDTimeScale timeScale;
-        std::chrono::system_clock::time_point timestamp;
-
-        if (SUCCEEDED(videoFrame->GetStreamTime(&frameTime, nullptr, timeScale))) {
-            timestamp = std::chrono::system_clock::now();
-        } else {
-            timestamp = std::chrono::system_clock::now();
-        }
-
-        frame->setTimestamp(timestamp);
+        setCaptureTimestamps(videoFrame, *frame);
 
         // Generate frame ID based on the timestamp
         auto now = std::chrono::high_resolution_clock::now();
@@ -993,7 +1243,7 @@ namespace medical::imaging {
         if (SUCCEEDED(videoFrame->GetTimecode(bmdTimecodeRP188Any, &timecode)) && timecode) {
             const char *timecodeString = nullptr;
             if (SUCCEEDED(timecode->GetString(&timecodeString)) && timecodeString) {
-                metadata.attributes["timecode"] = timecodeString;
+                metadata.attributes.set("timecode", timecodeString);
             }
             timecode->Release();
         }
@@ -1114,12 +1364,16 @@ namespace medical::imaging {
 
     bool BlackmagicDevice::initializeBufferPool(size_t bufferCount, size_t bufferSize) {
         if (bufferCount == 0 || bufferSize == 0) {
-            std::cerr << "Invalid buffer count or size" << std::endl;
+            MIVI_LOG_ERROR("Invalid buffer count or size");
             return false;
         }
 
         std::lock_guard<std::mutex> lock(bufferPoolMutex_);
 
+        // Frames still holding a buffer of the old pool must not return it to the new one
+        ++bufferPoolEpoch_;
+        freeBufferHead_.store(BUFFER_LIST_END, std::memory_order_release);
+
         // Clear existing pool
         for (auto& buffer : bufferPool_) {
             if (buffer.memory) {
@@ -1130,8 +1384,9 @@ namespace medical::imaging {
 
         bufferPool_.clear();
 
-        // Allocate buffers
-        bufferPool_.resize(bufferCount);
+        // Allocate buffers; the atomic flag makes Buffer immovable, so the pool is built in one go
+        std::vector<Buffer>(bufferCount).swap(bufferPool_);
+        int node = placementNode_.load(std::memory_order_relaxed);
 
         for (size_t i = 0; i < bufferCount; ++i) {
             Buffer &buffer = bufferPool_[i];
@@ -1140,7 +1395,7 @@ namespace medical::imaging {
 
             if (!buffer.memory) {
                 // Allocation failed - clean up
-                std::cerr << "Failed to allocate buffer " << i << " of size " << bufferSize << std::endl;
+                MIVI_LOG_ERROR("Failed to allocate buffer {} of size {}", i, bufferSize);
                 for (size_t j = 0; j < i; ++j) {
                     free(bufferPool_[j].memory);
                     bufferPool_[j].memory = nullptr;
@@ -1150,52 +1405,104 @@ namespace medical::imaging {
                 return false;
             }
 
+            // Large callocs come straight from mmap, so nothing is faulted in before the policy applies
+            if (!numa::bindMemory(buffer.memory, bufferSize, node)) {
+                MIVI_LOG_ERROR("Failed to bind buffer {} to NUMA node {}: {}", i, node, strerror(errno));
+            }
+
             buffer.size = bufferSize;
-            buffer.inUse = false;
+            buffer.inUse.store(false, std::memory_order_relaxed);
             buffer.isExternal = false;
         }
 
-        std::cout << "Buffer pool initialized with " << bufferCount << " buffers of size " << bufferSize << " bytes" << std::endl;
+        freeBufferNext_ = std::make_unique<std::atomic<uint32_t>[]>(bufferCount);
+        resetBufferFreeList();
+        bufferPoolNode_ = numa::nodeOfAddress(bufferPool_.front().memory);
+
+        bufferPoolFrameBytes_ = bufferSize;
+
+        MIVI_LOG_INFO("Buffer pool initialized with {} buffers of size {} bytes", bufferCount, bufferSize);
         return true;
     }
 
     BlackmagicDevice::Buffer *BlackmagicDevice::allocateBuffer(size_t size) {
-        std::lock_guard<std::mutex> lock(bufferPoolMutex_);
+        // Pop the head of the free list; the tag makes a concurrent pop/push of the same index fail the CAS
+        uint64_t head = freeBufferHead_.load(std::memory_order_acquire);
+        uint32_t index;
+        while (true) {
+            index = static_cast<uint32_t>(head);
+            if (index == BUFFER_LIST_END) {
+                // Consumers are holding every buffer - the caller falls back to the copy-free SDK buffer
+                bufferPoolExhausted_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
 
-        // Find a free buffer of sufficient size
-        for (Buffer &buffer: bufferPool_) {
-            if (!buffer.inUse && buffer.size >= size) {
-                buffer.inUse = true;
-                buffer.lastUsed = std::chrono::steady_clock::now();
-                return &buffer;
+            uint64_t next = freeBufferNext_[index].load(std::memory_order_relaxed);
+            uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+            if (freeBufferHead_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel,
+                                                      std::memory_order_acquire)) {
+                break;
             }
         }
 
-        // No suitable buffer found
-        return nullptr;
+        Buffer &buffer = bufferPool_[index];
+        if (buffer.size < size) {
+            // All pool buffers share one size, so none of them fits this frame
+            pushFreeBuffer(index);
+            return nullptr;
+        }
+
+        buffer.inUse.store(true, std::memory_order_release);
+        buffer.lastUsed = std::chrono::steady_clock::now();
+        return &buffer;
     }
 
     void BlackmagicDevice::releaseBuffer(Buffer *buffer) {
-        if (!buffer) {
+        if (!buffer || bufferPool_.empty()) {
             return;
         }
 
-        std::lock_guard<std::mutex> lock(bufferPoolMutex_);
+        // Map the pointer back to its pool index without scanning
+        auto address = reinterpret_cast<uintptr_t>(buffer);
+        auto base = reinterpret_cast<uintptr_t>(bufferPool_.data());
+        if (address < base || address >= base + bufferPool_.size() * sizeof(Buffer) ||
+            (address - base) % sizeof(Buffer) != 0) {
+            return;
+        }
+
+        buffer->inUse.store(false, std::memory_order_release);
+        pushFreeBuffer(static_cast<uint32_t>((address - base) / sizeof(Buffer)));
+    }
 
-        // Find the buffer in our pool
-        for (Buffer &poolBuffer: bufferPool_) {
-            if (&poolBuffer == buffer) {
-                poolBuffer.inUse = false;
-                return;
+    void BlackmagicDevice::pushFreeBuffer(uint32_t index) {
+        uint64_t head = freeBufferHead_.load(std::memory_order_relaxed);
+        uint64_t newHead;
+        do {
+            freeBufferNext_[index].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            newHead = (((head >> 32) + 1) << 32) | index;
+        } while (!freeBufferHead_.compare_exchange_weak(head, newHead, std::memory_order_release,
+                                                        std::memory_order_relaxed));
+    }
+
+    void BlackmagicDevice::resetBufferFreeList() {
+        uint64_t tag = (freeBufferHead_.load(std::memory_order_relaxed) >> 32) + 1;
+        uint32_t head = BUFFER_LIST_END;
+        for (size_t i = bufferPool_.size(); i-- > 0;) {
+            if (!bufferPool_[i].memory) {
+                continue;
             }
+            freeBufferNext_[i].store(head, std::memory_order_relaxed);
+            head = static_cast<uint32_t>(i);
         }
+
+        freeBufferHead_.store((tag << 32) | head, std::memory_order_release);
     }
 
     void BlackmagicDevice::queryCapabilities() {
         // Initialize with default values
         capabilities_.supportsDma = false;
         capabilities_.supportsGpuDirect = false;
-        capabilities_.supportsHardwareTimestamps = false;
+        capabilities_.supportsHardwareTimestamps = deckLinkInput_ != nullptr; // Hardware reference clock
         capabilities_.supportsExternalTrigger = false;
         capabilities_.supportsMultipleStreams = false;
         capabilities_.supportsProgrammableRoi = false;
@@ -1231,63 +1538,173 @@ namespace medical::imaging {
         capabilities_.deviceInfo["driver_version"] = "14.4"; // Would be queried in real implementation
     }
 
+    int BlackmagicDevice::discoverNumaNode() {
+        std::vector<std::string> cards = numa::pciDevicesOfVendor(numa::BLACKMAGIC_PCI_VENDOR);
+        if (cards.empty()) {
+            return -1;
+        }
+
+        // The device handle names the card's bus address, e.g. "PCI:0000:65:00.0"
+        IDeckLinkProfileAttributes *attributes = nullptr;
+        if (SUCCEEDED(deckLink_->QueryInterface(IID_IDeckLinkProfileAttributes,
+                                                reinterpret_cast<void **>(&attributes)))) {
+            const char *handle = nullptr;
+            std::string deviceHandle;
+            if (SUCCEEDED(attributes->GetString(BMDDeckLinkDeviceHandle, &handle)) && handle) {
+                deviceHandle = handle;
+                free(const_cast<char *>(handle));
+            }
+            attributes->Release();
+
+            for (const std::string &address: cards) {
+                // Match with or without the PCI domain
+                if (!deviceHandle.empty() && (deviceHandle.find(address) != std::string::npos ||
+                                              deviceHandle.find(address.substr(5)) != std::string::npos)) {
+                    return numa::nodeOfPciDevice(address);
+                }
+            }
+        }
+
+        // A single card needs no handle to tell it apart
+        return cards.size() == 1 ? numa::nodeOfPciDevice(cards.front()) : -1;
+    }
+
+    void BlackmagicDevice::bindCallbackThread() {
+        int node = placementNode_.load(std::memory_order_relaxed);
+        if (!numa::bindCurrentThread(node)) {
+            MIVI_LOG_ERROR("Failed to bind capture callback thread to NUMA node {}: {}", node, strerror(errno));
+        }
+    }
+
     void BlackmagicDevice::updatePerformanceMetrics(IDeckLinkVideoInputFrame *videoFrame) {
         // Calculate inter-frame time for FPS
         auto now = std::chrono::steady_clock::now();
-        auto timeSinceLastFrame = std::chrono::duration_cast<std::chrono::microseconds>(
-            now - lastFrameTime_).count();
+        auto intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastFrameTime_).count();
         lastFrameTime_ = now;
 
-        // Update frame count
-        ++frameCount_;
+        // Update frame count; the first interval only measures how long streaming took to start
+        if (frameCount_++ == 0 || intervalNs <= 0) {
+            return;
+        }
+
+        captureIntervalHistogram_.record(static_cast<uint64_t>(intervalNs));
 
-        // Calculate instant FPS
-        double instantFps = 0.0;
-        if (timeSinceLastFrame > 0) {
-            instantFps = 1000000.0 / timeSinceLastFrame;
+        // Moving average over roughly the last 60 frames for getCurrentFrameRate()
+        auto average = static_cast<int64_t>(frameIntervalAvgNs_.load(std::memory_order_relaxed));
+        average = average == 0 ? intervalNs : average + (intervalNs - average) / 60;
+        frameIntervalAvgNs_.store(static_cast<uint64_t>(average), std::memory_order_relaxed);
+    }
+
+    int64_t BlackmagicDevice::streamSlotOf(IDeckLinkVideoInputFrame *videoFrame) {
+        constexpr BMDTimeScale NANOSECOND_TIMESCALE = 1000000000;
+
+        // The stream time advances by one frame duration per input frame, delivered or not
+        BMDTimeValue frameTime = 0;
+        BMDTimeValue frameDuration = 0;
+        if (videoFrame->GetStreamTime(&frameTime, &frameDuration, NANOSECOND_TIMESCALE) != S_OK ||
+            frameDuration <= 0 || frameTime < 0) {
+            return -1;
         }
+        return (frameTime + frameDuration / 2) / frameDuration;
+    }
 
-        // Update FPS history
-        {
-            std::lock_guard<std::mutex> lock(metricsMutex_);
-            fpsHistory_.push_back(instantFps);
-            if (fpsHistory_.size() > 60) {
-                // Keep 1 second of history at 60 fps
-                fpsHistory_.pop_front();
+    void BlackmagicDevice::setCaptureTimestamps(IDeckLinkVideoInputFrame *videoFrame, Frame &frame) {
+        constexpr BMDTimeScale NANOSECOND_TIMESCALE = 1000000000;
+
+        auto monotonicNow = std::chrono::steady_clock::now();
+        auto wallNow = std::chrono::system_clock::now();
+        std::chrono::nanoseconds age(0);
+
+        // The card stamps each frame on its reference clock; sampling that clock now
+        // tells us how long ago the frame was captured in our own clock domains.
+        BMDTimeValue frameTime = 0;
+        BMDTimeValue frameDuration = 0;
+        BMDTimeValue clockTime = 0;
+        BMDTimeValue timeInFrame = 0;
+        BMDTimeValue ticksPerFrame = 0;
+        if (deckLinkInput_ &&
+            videoFrame->GetHardwareReferenceTimestamp(NANOSECOND_TIMESCALE, &frameTime, &frameDuration) == S_OK &&
+            deckLinkInput_->GetHardwareReferenceClock(NANOSECOND_TIMESCALE, &clockTime, &timeInFrame,
+                                                      &ticksPerFrame) == S_OK) {
+            monotonicNow = std::chrono::steady_clock::now();
+            wallNow = std::chrono::system_clock::now();
+
+            // Ignore readings that cannot belong to a frame that is still being delivered
+            BMDTimeValue ageNs = clockTime - frameTime;
+            if (ageNs >= 0 && ageNs < NANOSECOND_TIMESCALE) {
+                age = std::chrono::nanoseconds(ageNs);
+                hardwareTimestampFrames_.fetch_add(1, std::memory_order_relaxed);
             }
         }
+
+        frame.setCaptureTime(monotonicNow - age);
+        frame.setTimestamp(wallNow - std::chrono::duration_cast<std::chrono::system_clock::duration>(age));
+        frame.getMetadataMutable().timestampNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(frame.getTimestamp().time_since_epoch()).count());
     }
 
     uint32_t BlackmagicDevice::getBlackmagicPixelFormat(const std::string &format) {
-        if (format == "YUV" || format == "YUV422") {
-            return bmdFormat8BitYUV;
-        } else if (format == "YUV10" || format == "YUV422_10") {
-            return bmdFormat10BitYUV;
-        } else if (format == "RGB" || format == "BGRA") {
-            return bmdFormat8BitBGRA;
-        } else if (format == "RGB10") {
-            return bmdFormat10BitRGB;
-        } else {
-            // Default to 8-bit YUV
-            return bmdFormat8BitYUV;
-        }
+        return toBlackmagicPixelFormat(pixelFormatFromString(format));
     }
 
     std::string BlackmagicDevice::getPixelFormatString(uint32_t blackmagicFormat) {
+        return toString(fromBlackmagicPixelFormat(blackmagicFormat));
+    }
+
+    uint32_t BlackmagicDevice::toBlackmagicPixelFormat(PixelFormat format) {
+        switch (format) {
+            case PixelFormat::YUV422_8:
+                return bmdFormat8BitYUV;
+            case PixelFormat::YUV422_10:
+                return bmdFormat10BitYUV;
+            case PixelFormat::BGRA_8:
+                return bmdFormat8BitBGRA;
+            case PixelFormat::RGB_10:
+                return bmdFormat10BitRGB;
+            case PixelFormat::RGB_12:
+                return bmdFormat12BitRGB;
+            case PixelFormat::GRAY_8:
+            case PixelFormat::RGB_8:
+            case PixelFormat::RGB_16:
+            case PixelFormat::YUV422P_16:
+            case PixelFormat::UNKNOWN:
+                // Produced by conversion only, no card captures them
+                break;
+            default:
+                break;
+        }
+        // Default to 8-bit YUV
+        return bmdFormat8BitYUV;
+    }
+
+    PixelFormat BlackmagicDevice::fromBlackmagicPixelFormat(uint32_t blackmagicFormat) {
         switch (blackmagicFormat) {
             case bmdFormat8BitYUV:
-                return "YUV";
+                return PixelFormat::YUV422_8;
             case bmdFormat10BitYUV:
-                return "YUV10";
+                return PixelFormat::YUV422_10;
             case bmdFormat8BitBGRA:
-                return "BGRA";
+                return PixelFormat::BGRA_8;
             case bmdFormat10BitRGB:
-                return "RGB10";
+                return PixelFormat::RGB_10;
             case bmdFormat12BitRGB:
-                return "RGB12";
+                return PixelFormat::RGB_12;
             default:
-                return "Unknown";
+                return PixelFormat::UNKNOWN;
+        }
+    }
+
+    size_t BlackmagicDevice::getLargestFrameBytes() const {
+        size_t largest = 0;
+        for (const Config &config: getSupportedConfigurations()) {
+            largest = std::max(largest, estimateFrameBytes(config.pixelFormat, config.width, config.height));
         }
+        return largest;
+    }
+
+    size_t BlackmagicDevice::estimateFrameBytes(const std::string &format, uint32_t width, uint32_t height) {
+        size_t bytes = getPixelFormatInfo(pixelFormatFromString(format)).frameBytes(width, height);
+        return bytes > 0 ? bytes : static_cast<size_t>(width) * height * 4;
     }
 
     // Simplified implementation of BlackmagicDeviceManager
@@ -1312,12 +1729,12 @@ namespace medical::imaging {
     BlackmagicDeviceManager::~BlackmagicDeviceManager() = default;
 
     int BlackmagicDeviceManager::discoverDevices() {
-        std::cout << "Discovering Blackmagic devices..." << std::endl;
+        MIVI_LOG_INFO("Discovering Blackmagic devices...");
 
         // Create an iterator
         IDeckLinkIterator *iterator = CreateDeckLinkIteratorInstance();
         if (!iterator) {
-            std::cout << "Failed to create DeckLink iterator" << std::endl;
+            MIVI_LOG_INFO("Failed to create DeckLink iterator");
             return 0;
         }
 
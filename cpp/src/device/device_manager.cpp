@@ -1,7 +1,7 @@
 #include "device/device_manager.h"
 #include "DeckLinkAPI.h"
+#include "utils/log.h"
 #include "utils/refiid_compare.h"
-#include <iostream>
 
 namespace medical {
 namespace imaging {
@@ -15,7 +15,7 @@ public:
 
     // IDeckLinkDeviceNotificationCallback interface
     HRESULT STDMETHODCALLTYPE DeckLinkDeviceArrived(IDeckLink* deckLinkDevice) override {
-        std::cout << "Device arrived callback" << std::endl;
+        MIVI_LOG_INFO("Device arrived callback");
         if (manager_ && deckLinkDevice) {
             manager_->deviceArrived(deckLinkDevice);
         }
@@ -23,7 +23,7 @@ public:
     }
 
     HRESULT STDMETHODCALLTYPE DeckLinkDeviceRemoved(IDeckLink* deckLinkDevice) override {
-        std::cout << "Device removed callback" << std::endl;
+        MIVI_LOG_INFO("Device removed callback");
         if (manager_ && deckLinkDevice) {
             manager_->deviceRemoved(deckLinkDevice);
         }
@@ -71,7 +71,7 @@ DeviceManager& DeviceManager::getInstance() {
 DeviceManager::DeviceManager()
     : nextCallbackId_(0), discoveryInstance_(nullptr) {
 
-    std::cout << "DeviceManager constructor" << std::endl;
+    MIVI_LOG_INFO("DeviceManager constructor");
 
     // Create notification callback
     notificationCallback_ = std::make_shared<DeviceNotificationCallback>(this);
@@ -79,11 +79,11 @@ DeviceManager::DeviceManager()
     // Create discovery instance
     IDeckLinkDiscovery* discovery = CreateDeckLinkDiscoveryInstance();
     if (discovery) {
-        std::cout << "Installing device notifications" << std::endl;
+        MIVI_LOG_INFO("Installing device notifications");
         discovery->InstallDeviceNotifications(notificationCallback_.get());
         discoveryInstance_ = discovery;
     } else {
-        std::cout << "Failed to create discovery instance" << std::endl;
+        MIVI_LOG_ERROR("Failed to create discovery instance");
     }
 
     // Initial device discovery
@@ -91,7 +91,7 @@ DeviceManager::DeviceManager()
 }
 
 DeviceManager::~DeviceManager() {
-    std::cout << "DeviceManager destructor" << std::endl;
+    MIVI_LOG_INFO("DeviceManager destructor");
 
     // Uninstall notifications
     if (discoveryInstance_) {
@@ -107,12 +107,12 @@ DeviceManager::~DeviceManager() {
 }
 
 int DeviceManager::discoverDevices() {
-    std::cout << "Discovering devices" << std::endl;
+    MIVI_LOG_INFO("Discovering devices");
 
     // Create an iterator
     IDeckLinkIterator* iterator = CreateDeckLinkIteratorInstance();
     if (!iterator) {
-        std::cout << "Failed to create iterator" << std::endl;
+        MIVI_LOG_ERROR("Failed to create iterator");
         return 0;
     }
 
@@ -120,10 +120,10 @@ int DeviceManager::discoverDevices() {
     IDeckLink* deckLink = nullptr;
 
     // Iterate through all devices
-    std::cout << "Iterating through devices" << std::endl;
+    MIVI_LOG_INFO("Iterating through devices");
     while (iterator->Next(&deckLink) == S_OK) {
         if (deckLink) {
-            std::cout << "Found device" << std::endl;
+            MIVI_LOG_INFO("Found device");
 
             // Process the device
             deviceArrived(deckLink);
@@ -146,7 +146,7 @@ std::vector<std::string> DeviceManager::getAvailableDeviceIds() {
     return deviceIds;
 }
 
-std::shared_ptr<BlackmagicDevice> DeviceManager::getDevice(const std::string& deviceId) {
+std::shared_ptr<CaptureDevice> DeviceManager::getDevice(const std::string& deviceId) {
     std::unique_lock<std::mutex> lock(mutex_);
 
     auto it = devices_.find(deviceId);
@@ -178,7 +178,7 @@ bool DeviceManager::unregisterDeviceChangeCallback(int subscriptionId) {
     return false;
 }
 
-void DeviceManager::addTestDevice(std::shared_ptr<BlackmagicDevice> device) {
+void DeviceManager::addTestDevice(std::shared_ptr<CaptureDevice> device) {
     if (!device) {
         return;
     }
@@ -188,10 +188,10 @@ void DeviceManager::addTestDevice(std::shared_ptr<BlackmagicDevice> device) {
 }
 
 void DeviceManager::deviceArrived(void* deckLinkDevice) {
-    std::cout << "Device arrived" << std::endl;
+    MIVI_LOG_INFO("Device arrived");
     IDeckLink* deckLink = static_cast<IDeckLink*>(deckLinkDevice);
     if (!deckLink) {
-        std::cout << "Null deckLink" << std::endl;
+        MIVI_LOG_INFO("Null deckLink");
         return;
     }
 
@@ -203,17 +203,17 @@ void DeviceManager::deviceArrived(void* deckLinkDevice) {
 
     // Get the device ID
     std::string deviceId = device->getDeviceId();
-    std::cout << "Created device with ID: " << deviceId << std::endl;
+    MIVI_LOG_INFO("Created device with ID: {}", deviceId);
 
     // Add it to the map using our thread-safe method
     addDeviceSafe(deviceId, device);
 }
 
 void DeviceManager::deviceRemoved(void* deckLinkDevice) {
-    std::cout << "Device removed" << std::endl;
+    MIVI_LOG_INFO("Device removed");
     IDeckLink* deckLink = static_cast<IDeckLink*>(deckLinkDevice);
     if (!deckLink) {
-        std::cout << "Null deckLink" << std::endl;
+        MIVI_LOG_INFO("Null deckLink");
         return;
     }
 
@@ -242,7 +242,7 @@ void DeviceManager::deviceRemoved(void* deckLinkDevice) {
     }
 }
 
-void DeviceManager::addDeviceSafe(const std::string& deviceId, std::shared_ptr<BlackmagicDevice> device) {
+void DeviceManager::addDeviceSafe(const std::string& deviceId, std::shared_ptr<CaptureDevice> device) {
     // Local copies for callbacks
     std::vector<std::function<void(const std::string&, bool)>> callbacksToCall;
 
@@ -264,9 +264,9 @@ void DeviceManager::addDeviceSafe(const std::string& deviceId, std::shared_ptr<B
         try {
             callback(deviceId, true);
         } catch (const std::exception& e) {
-            std::cerr << "Exception in device callback: " << e.what() << std::endl;
+            MIVI_LOG_ERROR("Exception in device callback: {}", e.what());
         } catch (...) {
-            std::cerr << "Unknown exception in device callback" << std::endl;
+            MIVI_LOG_ERROR("Unknown exception in device callback");
         }
     }
 }
@@ -293,9 +293,9 @@ void DeviceManager::removeDeviceSafe(const std::string& deviceId) {
         try {
             callback(deviceId, false);
         } catch (const std::exception& e) {
-            std::cerr << "Exception in device callback: " << e.what() << std::endl;
+            MIVI_LOG_ERROR("Exception in device callback: {}", e.what());
         } catch (...) {
-            std::cerr << "Unknown exception in device callback" << std::endl;
+            MIVI_LOG_ERROR("Unknown exception in device callback");
         }
     }
 }
@@ -0,0 +1,511 @@
+#include "device/synthetic_device.h"
+#include "communication/shared_memory.h"
+#include "recording/recording_reader.h"
+#include "utils/frame_trace.h"
+#include "utils/log.h"
+#include "utils/numa.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <random>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace medical {
+namespace imaging {
+
+    // Distinct frames the test pattern cycles through
+    constexpr size_t PATTERN_FRAMES = 16;
+
+    SyntheticDevice::SyntheticDevice(const Options &options)
+        : options_(options),
+          pixelFormat_(PixelFormat::YUV422_8),
+          frameBytes_(0),
+          rowBytes_(0),
+          replayMapping_(nullptr),
+          replaySize_(0),
+          isCapturing_(false),
+          stopRequested_(false),
+          frameCount_(0),
+          droppedFrames_(0),
+          heapFallbacks_(0),
+          leasesOutstanding_(0),
+          leasesOutstandingPeak_(0),
+          frameIntervalAvgNs_(0) {
+        if (options_.burstSize < 1) {
+            options_.burstSize = 1;
+        }
+    }
+
+    SyntheticDevice::~SyntheticDevice() {
+        if (isCapturing_) {
+            stopCapture();
+        }
+        closeReplay();
+    }
+
+    std::string SyntheticDevice::getDeviceId() const {
+        return options_.deviceId;
+    }
+
+    std::string SyntheticDevice::getDeviceName() const {
+        return options_.source == Source::REPLAY ? "Replay Device" : "Synthetic Device";
+    }
+
+    std::string SyntheticDevice::getDeviceModel() const {
+        return options_.source == Source::REPLAY ? "Replay: " + options_.replayPath : "Test Pattern";
+    }
+
+    SyntheticDevice::Status SyntheticDevice::initialize(const Config &config) {
+        if (isCapturing_) {
+            return Status::ALREADY_STREAMING;
+        }
+
+        PixelFormat pixelFormat = pixelFormatFromString(config.pixelFormat);
+        PixelFormatInfo info = getPixelFormatInfo(pixelFormat);
+        if (pixelFormat == PixelFormat::UNKNOWN || config.width <= 0 || config.height <= 0 ||
+            config.frameRate <= 0.0) {
+            MIVI_LOG_WARNING("Unsupported synthetic configuration: {}x{} {} @ {} fps",
+                    config.width, config.height, config.pixelFormat, config.frameRate);
+            return Status::CONFIGURATION_ERROR;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        currentConfig_ = config;
+        pixelFormat_ = pixelFormat;
+        rowBytes_ = info.rowBytes(static_cast<size_t>(config.width));
+        frameBytes_ = info.frameBytes(static_cast<size_t>(config.width), static_cast<size_t>(config.height));
+
+        closeReplay();
+        patternFrames_.clear();
+        if (options_.source == Source::REPLAY) {
+            return openReplay();
+        }
+
+        renderPattern();
+        return Status::OK;
+    }
+
+    SyntheticDevice::Status SyntheticDevice::startCapture(std::function<void(std::shared_ptr<Frame>)> frameCallback) {
+        if (isCapturing_) {
+            return Status::ALREADY_STREAMING;
+        }
+        if (!frameCallback) {
+            return Status::INVALID_ARGUMENT;
+        }
+        if (sourceFrameCount() == 0) {
+            return Status::INIT_FAILED;
+        }
+
+        frameCallback_ = std::move(frameCallback);
+        frameCount_ = 0;
+        droppedFrames_ = 0;
+        heapFallbacks_ = 0;
+        frameIntervalAvgNs_ = 0;
+        captureIntervalHistogram_.reset();
+        convertTimeHistogram_.reset();
+
+        stopRequested_ = false;
+        isCapturing_ = true;
+        captureThread_ = std::thread(&SyntheticDevice::captureThread, this);
+        return Status::OK;
+    }
+
+    SyntheticDevice::Status SyntheticDevice::stopCapture() {
+        if (!isCapturing_) {
+            return Status::NOT_STREAMING;
+        }
+
+        stopRequested_ = true;
+        if (captureThread_.joinable()) {
+            captureThread_.join();
+        }
+
+        isCapturing_ = false;
+        return Status::OK;
+    }
+
+    bool SyntheticDevice::isCapturing() const {
+        return isCapturing_;
+    }
+
+    std::vector<SyntheticDevice::Config> SyntheticDevice::getSupportedConfigurations() const {
+        return {getCurrentConfiguration()};
+    }
+
+    SyntheticDevice::Config SyntheticDevice::getCurrentConfiguration() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return currentConfig_;
+    }
+
+    SyntheticDevice::Capabilities SyntheticDevice::getCapabilities() const {
+        Capabilities capabilities{};
+        capabilities.supportsDma = true;
+        capabilities.supportsHardwareTimestamps = false;
+        capabilities.supportedPixelFormats = {"YUV", "BGRA", "YUV10", "RGB10", "RGB12", "GRAY8", "RGB24"};
+        capabilities.supportedFeatures = {DeviceFeature::DIRECT_MEMORY_ACCESS, DeviceFeature::FRAME_METADATA};
+        capabilities.deviceInfo["source"] = options_.source == Source::REPLAY ? "replay" : "pattern";
+        capabilities.deviceInfo["pacing"] = options_.pacing == Pacing::REALTIME ? "realtime" : "max";
+        return capabilities;
+    }
+
+    bool SyntheticDevice::supportsFeature(DeviceFeature feature) const {
+        return feature == DeviceFeature::DIRECT_MEMORY_ACCESS || feature == DeviceFeature::FRAME_METADATA;
+    }
+
+    SyntheticDevice::Status SyntheticDevice::setDirectOutputToSharedMemory(std::shared_ptr<SharedMemory> sharedMemory) {
+        if (isCapturing_) {
+            return Status::ALREADY_STREAMING;
+        }
+        if (sharedMemory && sharedMemory->getCaptureBufferCount() == 0) {
+            return Status::FEATURE_NOT_SUPPORTED;
+        }
+
+        directSharedMemory_ = std::move(sharedMemory);
+        return Status::OK;
+    }
+
+    double SyntheticDevice::getCurrentFrameRate() const {
+        uint64_t intervalNs = frameIntervalAvgNs_.load(std::memory_order_relaxed);
+        return intervalNs > 0 ? 1e9 / static_cast<double>(intervalNs) : 0.0;
+    }
+
+    const LatencyHistogram &SyntheticDevice::getCaptureIntervalHistogram() const {
+        return captureIntervalHistogram_;
+    }
+
+    const LatencyHistogram &SyntheticDevice::getConvertTimeHistogram() const {
+        return convertTimeHistogram_;
+    }
+
+    uint64_t SyntheticDevice::getDroppedFrameCount() const {
+        return droppedFrames_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SyntheticDevice::getBufferPoolExhaustedCount() const {
+        return 0;
+    }
+
+    uint64_t SyntheticDevice::getDirectCaptureHeapFallbacks() const {
+        return heapFallbacks_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SyntheticDevice::getOutstandingBufferCount() const {
+        return leasesOutstanding_.load(std::memory_order_relaxed);
+    }
+
+    int SyntheticDevice::getNumaNode() const {
+        // Not attached to a bus; placement follows Config::numaNode alone
+        return -1;
+    }
+
+    bool SyntheticDevice::hasInputSignal() const {
+        // The generated pattern is always there
+        return true;
+    }
+
+    std::map<std::string, std::string> SyntheticDevice::getDiagnostics() const {
+        std::map<std::string, std::string> diagnostics;
+
+        Config config = getCurrentConfiguration();
+        diagnostics["device_id"] = getDeviceId();
+        diagnostics["device_name"] = getDeviceName();
+        diagnostics["device_model"] = getDeviceModel();
+        diagnostics["is_capturing"] = isCapturing_ ? "true" : "false";
+
+        // Add configuration
+        diagnostics["width"] = std::to_string(config.width);
+        diagnostics["height"] = std::to_string(config.height);
+        diagnostics["frame_rate"] = std::to_string(config.frameRate);
+        diagnostics["pixel_format"] = config.pixelFormat;
+        diagnostics["source"] = options_.source == Source::REPLAY ? "replay" : "pattern";
+        diagnostics["pacing"] = options_.pacing == Pacing::REALTIME ? "realtime" : "max";
+        diagnostics["jitter_us"] = std::to_string(options_.jitterUs);
+        diagnostics["burst_size"] = std::to_string(options_.burstSize);
+        diagnostics["source_frames"] = std::to_string(sourceFrameCount());
+        diagnostics["numa_node"] = std::to_string(config.numaNode);
+
+        // Add performance metrics
+        diagnostics["frame_count"] = std::to_string(frameCount_);
+        diagnostics["dropped_frames"] = std::to_string(droppedFrames_);
+        diagnostics["average_fps"] = std::to_string(getCurrentFrameRate());
+        appendHistogramStatistics(diagnostics, "capture_interval", captureIntervalHistogram_.snapshot());
+        appendHistogramStatistics(diagnostics, "convert_time", convertTimeHistogram_.snapshot());
+
+        diagnostics["direct_shm_capture"] = directSharedMemory_ ? "true" : "false";
+        if (directSharedMemory_) {
+            diagnostics["direct_shm_heap_fallbacks"] = std::to_string(heapFallbacks_.load(std::memory_order_relaxed));
+            diagnostics["leases_outstanding"] = std::to_string(leasesOutstanding_.load(std::memory_order_relaxed));
+            diagnostics["leases_outstanding_peak"] =
+                    std::to_string(leasesOutstandingPeak_.load(std::memory_order_relaxed));
+        }
+
+        return diagnostics;
+    }
+
+    const SyntheticDevice::Options &SyntheticDevice::getOptions() const {
+        return options_;
+    }
+
+    void SyntheticDevice::captureThread() {
+        using Clock = std::chrono::steady_clock;
+
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(1.0 / currentConfig_.frameRate));
+        const auto burstSize = static_cast<uint64_t>(options_.burstSize);
+
+        // A real card queues this many frames before it has to drop
+        const auto queueDepth = static_cast<int64_t>(std::max<size_t>(currentConfig_.bufferCount, 1));
+
+        std::mt19937 rng(options_.seed);
+        std::normal_distribution<double> jitterNs(0.0, options_.jitterUs * 1000.0);
+        double burstJitterNs = 0.0;
+
+        const size_t sourceFrames = sourceFrameCount();
+        const Clock::time_point start = Clock::now();
+        Clock::time_point lastRelease = start;
+        lastFrameTime_ = start;
+
+        // Generate next to the ring the frames are written into
+        if (!numa::bindCurrentThread(currentConfig_.numaNode)) {
+            MIVI_LOG_ERROR("Failed to bind synthetic capture thread to NUMA node {}: {}",
+                    currentConfig_.numaNode, strerror(errno));
+        }
+
+        for (uint64_t sequence = 0; !stopRequested_; ++sequence) {
+            if (options_.source == Source::REPLAY && !options_.loop && sequence >= sourceFrames) {
+                MIVI_LOG_INFO("Replay of {} finished after {} frames", options_.replayPath, sourceFrames);
+                break;
+            }
+
+            Clock::time_point captureTime;
+            if (options_.pacing == Pacing::REALTIME) {
+                // A burst is released once its last frame has been captured
+                if (sequence % burstSize == 0 && options_.jitterUs > 0.0) {
+                    burstJitterNs = jitterNs(rng);
+                }
+                uint64_t lastInBurst = sequence - sequence % burstSize + burstSize - 1;
+                Clock::time_point release = start + period * static_cast<int64_t>(lastInBurst) +
+                                            std::chrono::nanoseconds(std::llround(burstJitterNs));
+                release = std::max(release, lastRelease);
+                lastRelease = release;
+
+                Clock::time_point now = Clock::now();
+                if (now < release) {
+                    std::this_thread::sleep_until(release);
+                } else if (now - release > period * queueDepth) {
+                    // The callback fell behind further than the card could buffer
+                    droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                captureTime = std::min(start + period * static_cast<int64_t>(sequence), Clock::now());
+            } else {
+                captureTime = Clock::now();
+            }
+
+            auto convertStart = Clock::now();
+            FrameTrace::record(TracePoint::CONVERT_BEGIN, 0);
+            std::shared_ptr<Frame> frame = makeFrame(sequence % sourceFrames, captureTime);
+            convertTimeHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - convertStart).count()));
+            FrameTrace::record(TracePoint::CONVERT_END, frame ? frame->getFrameId() : 0);
+            if (!frame) {
+                droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            // Numbered by input slot like a card's stream time, so the frames dropped above leave a gap
+            frame->getMetadataMutable().frameNumber = static_cast<uint32_t>(sequence);
+
+            // Calculate inter-frame time for FPS
+            auto now = Clock::now();
+            auto intervalNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastFrameTime_).count();
+            lastFrameTime_ = now;
+            if (frameCount_++ > 0 && intervalNs > 0) {
+                captureIntervalHistogram_.record(static_cast<uint64_t>(intervalNs));
+
+                auto average = static_cast<int64_t>(frameIntervalAvgNs_.load(std::memory_order_relaxed));
+                average = average == 0 ? intervalNs : average + (intervalNs - average) / 60;
+                frameIntervalAvgNs_.store(static_cast<uint64_t>(average), std::memory_order_relaxed);
+            }
+
+            frameCallback_(frame);
+        }
+    }
+
+    std::shared_ptr<Frame> SyntheticDevice::makeFrame(size_t index, std::chrono::steady_clock::time_point captureTime) {
+        const uint8_t *source = sourceFrame(index);
+        const int width = currentConfig_.width;
+        const int height = currentConfig_.height;
+        const int bytesPerPixel = static_cast<int>(rowBytes_ / static_cast<size_t>(width));
+        std::shared_ptr<Frame> frame;
+
+        // Copy into a capture buffer of the ring, as a card would DMA into it
+        if (directSharedMemory_) {
+            int lease = directSharedMemory_->acquireCaptureBuffer(frameBytes_);
+            void *data = lease >= 0 ? directSharedMemory_->getCaptureBufferData(lease) : nullptr;
+            if (data) {
+                std::memcpy(data, source, frameBytes_);
+                frame = Frame::createWithExternalData(data, frameBytes_, width, height, bytesPerPixel,
+                                                      pixelFormat_, false);
+            }
+            if (frame) {
+                uint64_t outstanding = leasesOutstanding_.fetch_add(1, std::memory_order_relaxed) + 1;
+                uint64_t peak = leasesOutstandingPeak_.load(std::memory_order_relaxed);
+                while (outstanding > peak &&
+                       !leasesOutstandingPeak_.compare_exchange_weak(peak, outstanding, std::memory_order_relaxed)) {
+                }
+                std::shared_ptr<SharedMemory> sharedMemory = directSharedMemory_;
+                frame->setOnDestroy([this, sharedMemory, lease]() {
+                    sharedMemory->releaseCaptureBuffer(lease);
+                    leasesOutstanding_.fetch_sub(1, std::memory_order_relaxed);
+                });
+            } else {
+                if (lease >= 0) {
+                    directSharedMemory_->releaseCaptureBuffer(lease);
+                }
+                heapFallbacks_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (!frame) {
+            void *data = std::malloc(frameBytes_);
+            if (!data) {
+                return nullptr;
+            }
+            std::memcpy(data, source, frameBytes_);
+            frame = Frame::createWithExternalData(data, frameBytes_, width, height, bytesPerPixel,
+                                                  pixelFormat_, true);
+            if (!frame) {
+                std::free(data);
+                return nullptr;
+            }
+        }
+
+        // Stamp the frame like the capture path of a real device
+        auto captureAge = std::chrono::steady_clock::now() - captureTime;
+        auto wallTime = std::chrono::system_clock::now() -
+                        std::chrono::duration_cast<std::chrono::system_clock::duration>(captureAge);
+        frame->setCaptureTime(captureTime);
+        frame->setTimestamp(wallTime);
+        frame->setFrameId(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(wallTime.time_since_epoch()).count()));
+
+        FrameMetadata &metadata = frame->getMetadataMutable();
+        metadata.deviceId = options_.deviceId;
+        metadata.width = width;
+        metadata.height = height;
+        metadata.bytesPerPixel = bytesPerPixel;
+        metadata.frameNumber = frameCount_;
+        metadata.timestampNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(wallTime.time_since_epoch()).count());
+        metadata.hasBeenProcessed = false;
+        metadata.attributes.set("source_frame", std::to_string(index));
+
+        return frame;
+    }
+
+    void SyntheticDevice::renderPattern() {
+        // Diagonal ramps shifted every frame, so consecutive frames differ everywhere
+        patternFrames_.resize(frameBytes_ * PATTERN_FRAMES);
+        for (size_t f = 0; f < PATTERN_FRAMES; ++f) {
+            uint8_t *frame = patternFrames_.data() + f * frameBytes_;
+            for (size_t y = 0; y < static_cast<size_t>(currentConfig_.height); ++y) {
+                uint8_t *row = frame + y * rowBytes_;
+                for (size_t x = 0; x < rowBytes_; ++x) {
+                    row[x] = static_cast<uint8_t>(x + y + f * 8);
+                }
+            }
+        }
+    }
+
+    SyntheticDevice::Status SyntheticDevice::openReplay() {
+        // Indexed recordings are replayed through their index, skipping the record headers
+        if (RecordingReader::isRecording(options_.replayPath)) {
+            auto recording = std::make_unique<RecordingReader>(options_.replayPath);
+            if (recording->open() != RecordingReader::Status::OK) {
+                return Status::IO_ERROR;
+            }
+            if (recording->getFrameCount() == 0) {
+                MIVI_LOG_WARNING("Recording {} holds no frames", options_.replayPath);
+                return Status::CONFIGURATION_ERROR;
+            }
+            for (uint64_t i = 0; i < recording->getFrameCount(); ++i) {
+                if (recording->getIndexEntry(i)->dataSize != frameBytes_) {
+                    MIVI_LOG_WARNING("Frame {} of {} is not a {}-byte frame", i, options_.replayPath, frameBytes_);
+                    return Status::CONFIGURATION_ERROR;
+                }
+            }
+            replayRecording_ = std::move(recording);
+            return Status::OK;
+        }
+
+        int fd = open(options_.replayPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            MIVI_LOG_ERROR("Failed to open replay file {}: {}", options_.replayPath, strerror(errno));
+            return Status::IO_ERROR;
+        }
+
+        struct stat sb{};
+        if (fstat(fd, &sb) != 0 || static_cast<size_t>(sb.st_size) < frameBytes_) {
+            MIVI_LOG_WARNING("Replay file {} holds no complete {}-byte frame", options_.replayPath, frameBytes_);
+            close(fd);
+            return Status::CONFIGURATION_ERROR;
+        }
+
+        void *mapping = mmap(nullptr, static_cast<size_t>(sb.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            MIVI_LOG_ERROR("Failed to map replay file {}: {}", options_.replayPath, strerror(errno));
+            return Status::IO_ERROR;
+        }
+
+        // Replay walks the file front to back
+        madvise(mapping, static_cast<size_t>(sb.st_size), MADV_SEQUENTIAL);
+        replayMapping_ = mapping;
+        replaySize_ = static_cast<size_t>(sb.st_size);
+
+        if (replaySize_ % frameBytes_ != 0) {
+            MIVI_LOG_WARNING("Ignoring {} trailing bytes of {}", replaySize_ % frameBytes_, options_.replayPath);
+        }
+        return Status::OK;
+    }
+
+    void SyntheticDevice::closeReplay() {
+        replayRecording_.reset();
+        if (replayMapping_) {
+            munmap(replayMapping_, replaySize_);
+            replayMapping_ = nullptr;
+            replaySize_ = 0;
+        }
+    }
+
+    const uint8_t *SyntheticDevice::sourceFrame(size_t index) const {
+        if (replayRecording_) {
+            return static_cast<const uint8_t *>(replayRecording_->getFrameData(index));
+        }
+        if (replayMapping_) {
+            return static_cast<const uint8_t *>(replayMapping_) + index * frameBytes_;
+        }
+        return patternFrames_.data() + index * frameBytes_;
+    }
+
+    size_t SyntheticDevice::sourceFrameCount() const {
+        if (frameBytes_ == 0) {
+            return 0;
+        }
+        if (replayRecording_) {
+            return static_cast<size_t>(replayRecording_->getFrameCount());
+        }
+        if (replayMapping_) {
+            return replaySize_ / frameBytes_;
+        }
+        return patternFrames_.size() / frameBytes_;
+    }
+
+} // namespace imaging
+} // namespace medical
@@ -1,15 +1,222 @@
 #include "frame/frame.h"
+#include "gpu/gpu_memory.h"
+#include "utils/log.h"
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <map>
-#include <iostream>
 #include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/dma-buf.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <chrono>
 #include <algorithm>
+#include <mutex>
+#include <new>
 
 namespace medical {
     namespace imaging {
+        namespace {
+            // Released frame objects kept for reuse; beyond this they are deleted
+            constexpr size_t FRAME_POOL_CAPACITY = 256;
+
+            // shared_ptr control blocks of pooled frames fit in one block of this size
+            constexpr size_t CONTROL_BLOCK_SIZE = 64;
+
+            /**
+             * @brief Recycles fixed-size raw blocks so shared_ptr control blocks do not hit malloc
+             */
+            class ControlBlockPool {
+            public:
+                static ControlBlockPool &getInstance() {
+                    // Leaked on purpose: frames may be released during static destruction
+                    static auto *instance = new ControlBlockPool();
+                    return *instance;
+                }
+
+                void *allocate(size_t bytes) {
+                    if (bytes > CONTROL_BLOCK_SIZE) {
+                        return ::operator new(bytes);
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (!freeBlocks_.empty()) {
+                            void *block = freeBlocks_.back();
+                            freeBlocks_.pop_back();
+                            return block;
+                        }
+                    }
+
+                    return ::operator new(CONTROL_BLOCK_SIZE);
+                }
+
+                void deallocate(void *block, size_t bytes) {
+                    if (bytes <= CONTROL_BLOCK_SIZE) {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        if (freeBlocks_.size() < FRAME_POOL_CAPACITY) {
+                            freeBlocks_.push_back(block);
+                            return;
+                        }
+                    }
+
+                    ::operator delete(block);
+                }
+
+            private:
+                ControlBlockPool() {
+                    freeBlocks_.reserve(FRAME_POOL_CAPACITY);
+                }
+
+                std::mutex mutex_;
+                std::vector<void *> freeBlocks_;
+            };
+
+            // Allocator handing shared_ptr its control block from the ControlBlockPool
+            template<typename T>
+            struct ControlBlockAllocator {
+                using value_type = T;
+
+                ControlBlockAllocator() = default;
+
+                template<typename U>
+                ControlBlockAllocator(const ControlBlockAllocator<U> &) {
+                }
+
+                T *allocate(size_t n) {
+                    return static_cast<T *>(ControlBlockPool::getInstance().allocate(n * sizeof(T)));
+                }
+
+                void deallocate(T *p, size_t n) {
+                    ControlBlockPool::getInstance().deallocate(p, n * sizeof(T));
+                }
+
+                template<typename U>
+                bool operator==(const ControlBlockAllocator<U> &) const {
+                    return true;
+                }
+
+                template<typename U>
+                bool operator!=(const ControlBlockAllocator<U> &) const {
+                    return false;
+                }
+            };
+
+            // Smallest pixel buffer handed out; smaller requests get one of this size
+            constexpr size_t MIN_BUFFER_SHIFT = 12;
+
+            // Size classes: four per power of two, so a buffer wastes at most a quarter of its size
+            constexpr size_t BUFFER_CLASS_COUNT = 4 * (48 - MIN_BUFFER_SHIFT);
+
+            // Released buffers kept per size class, and in total
+            constexpr size_t BUFFERS_PER_CLASS = 8;
+            constexpr size_t BUFFER_POOL_MAX_BYTES = 512ULL * 1024 * 1024;
+
+            /**
+             * @brief Reference-counted pixel buffer shared by the frames that view it
+             */
+            struct SharedBuffer {
+                std::atomic<uint32_t> references; // Frames (and snapshots) holding the buffer
+                size_t sizeClass;                 // Index of the class the buffer was sized for
+                size_t capacity;                  // Bytes allocated
+                void *data;                       // Page-aligned storage
+            };
+
+            /**
+             * @brief Recycles pixel buffers by size class so frame copies do not hit malloc
+             *
+             * A pooled buffer keeps its pages, so a frame copied into a recycled
+             * buffer does not page-fault its way through fresh memory either.
+             */
+            class BufferPool {
+            public:
+                static BufferPool &getInstance() {
+                    // Leaked on purpose: frames may be released during static destruction
+                    static auto *instance = new BufferPool();
+                    return *instance;
+                }
+
+                SharedBuffer *acquire(size_t bytes) {
+                    size_t sizeClass = classOf(bytes);
+                    if (sizeClass >= BUFFER_CLASS_COUNT) {
+                        return nullptr;
+                    }
+
+                    SharedBuffer *buffer = nullptr;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        std::vector<SharedBuffer *> &freeBuffers = freeBuffers_[sizeClass];
+                        if (!freeBuffers.empty()) {
+                            buffer = freeBuffers.back();
+                            freeBuffers.pop_back();
+                            cachedBytes_ -= buffer->capacity;
+                        }
+                    }
+
+                    if (!buffer) {
+                        size_t capacity = capacityOf(sizeClass);
+                        void *data = nullptr;
+                        if (posix_memalign(&data, 4096, capacity) != 0) {
+                            return nullptr;
+                        }
+                        buffer = new SharedBuffer{{0}, sizeClass, capacity, data};
+                    }
+
+                    buffer->references.store(1, std::memory_order_relaxed);
+                    return buffer;
+                }
+
+                void release(SharedBuffer *buffer) {
+                    if (buffer->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                        return;
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        std::vector<SharedBuffer *> &freeBuffers = freeBuffers_[buffer->sizeClass];
+                        if (freeBuffers.size() < BUFFERS_PER_CLASS &&
+                            cachedBytes_ + buffer->capacity <= BUFFER_POOL_MAX_BYTES) {
+                            freeBuffers.push_back(buffer);
+                            cachedBytes_ += buffer->capacity;
+                            return;
+                        }
+                    }
+
+                    free(buffer->data);
+                    delete buffer;
+                }
+
+            private:
+                BufferPool() : cachedBytes_(0) {
+                }
+
+                // Class of the smallest buffer holding bytes
+                static size_t classOf(size_t bytes) {
+                    if (bytes <= (size_t(1) << MIN_BUFFER_SHIFT)) {
+                        return 0;
+                    }
+                    // bytes - 1 has its top bit at octave - 1; the next two bits pick the quarter
+                    size_t octave = 64 - static_cast<size_t>(__builtin_clzll(bytes - 1));
+                    size_t quarter = ((bytes - 1) >> (octave - 3)) & 3;
+                    return (octave - MIN_BUFFER_SHIFT - 1) * 4 + quarter + 1;
+                }
+
+                static size_t capacityOf(size_t sizeClass) {
+                    if (sizeClass == 0) {
+                        return size_t(1) << MIN_BUFFER_SHIFT;
+                    }
+                    size_t octave = (sizeClass - 1) / 4 + MIN_BUFFER_SHIFT + 1;
+                    size_t quarter = (sizeClass - 1) % 4;
+                    return (5 + quarter) << (octave - 3);
+                }
+
+                std::mutex mutex_;
+                std::array<std::vector<SharedBuffer *>, BUFFER_CLASS_COUNT> freeBuffers_;
+                size_t cachedBytes_;
+            };
+        } // namespace
+
         /**
          * @brief Private implementation of Frame
          */
@@ -20,11 +227,14 @@ namespace medical {
             int height; // Frame height in pixels
             int bytesPerPixel; // Number of bytes per pixel
             std::string format; // Pixel format string
+            PixelFormat pixelFormat; // Typed pixel format (UNKNOWN for ad-hoc format strings)
             uint64_t frameId; // Unique frame ID
             std::chrono::system_clock::time_point timestamp; // Frame timestamp
+            std::chrono::steady_clock::time_point captureTime; // Monotonic capture time (epoch if unknown)
             bool ownsData; // Whether this frame owns the data buffer
             BufferType bufferType; // Type of buffer
             FrameMetadata metadata; // Enhanced metadata
+            std::map<std::string, std::string> overflowAttributes; // Attributes that did not fit in metadata
 
             // Shared memory mapping info
             bool isMapped; // Whether this frame is mapped to shared memory
@@ -35,10 +245,27 @@ namespace medical {
             // GPU memory info
             void *gpuPtr; // GPU memory pointer (if using GPU memory)
 
+            // DMA buffer info
+            int dmaBufFd; // dma-buf the data is a CPU mapping of (-1 if none), not owned
+
             // Lock state
             bool isLocked; // Whether buffer is currently locked
             bool isLockedForWriting; // Whether buffer is locked for writing
 
+            // Producer-side generation counter guarding externally owned data
+            const std::atomic<uint64_t> *validityGeneration; // nullptr if the data cannot be reused
+            uint64_t validityExpected; // Generation value while the data belongs to this frame
+
+            // Position in the shared memory ring the frame was read from
+            uint64_t sequenceNumber; // 0 if the frame did not come from a ring
+
+            // Pooled pixel buffer, possibly shared with other frames until one of them locks it for writing
+            SharedBuffer *sharedBuffer; // nullptr unless data lives in a pooled buffer
+
+            // Pooled copy of data the frame does not share, taken by the first cloneShared() and
+            // handed to later ones until the frame is locked for writing
+            mutable std::atomic<SharedBuffer *> snapshot;
+
             // Constructor
             Impl() : data(nullptr),
                      dataSize(0),
@@ -46,8 +273,10 @@ namespace medical {
                      height(0),
                      bytesPerPixel(0),
                      format(""),
+                     pixelFormat(PixelFormat::UNKNOWN),
                      frameId(0),
                      timestamp(std::chrono::system_clock::now()),
+                     captureTime(),
                      ownsData(false),
                      bufferType(BufferType::CPU_MEMORY),
                      isMapped(false),
@@ -55,12 +284,23 @@ namespace medical {
                      shmOffset(0),
                      shmFd(-1),
                      gpuPtr(nullptr),
+                     dmaBufFd(-1),
                      isLocked(false),
-                     isLockedForWriting(false) {
+                     isLockedForWriting(false),
+                     validityGeneration(nullptr),
+                     validityExpected(0),
+                     sequenceNumber(0),
+                     sharedBuffer(nullptr),
+                     snapshot(nullptr) {
             }
 
             // Destructor
             ~Impl() {
+                releaseResources();
+            }
+
+            // Free owned buffers and mappings
+            void releaseResources() {
                 // Unlock if still locked
                 if (isLocked) {
                     if (bufferType == BufferType::GPU_MEMORY) {
@@ -68,6 +308,15 @@ namespace medical {
                     }
                 }
 
+                releaseSnapshot();
+
+                // Drop this frame's reference to a pooled buffer
+                if (sharedBuffer) {
+                    BufferPool::getInstance().release(sharedBuffer);
+                    sharedBuffer = nullptr;
+                    data = nullptr;
+                }
+
                 // Free CPU memory if owned
                 if (ownsData && data && bufferType == BufferType::CPU_MEMORY) {
                     free(data);
@@ -87,33 +336,90 @@ namespace medical {
 
                 // Free GPU memory if owned
                 if (ownsData && gpuPtr && bufferType == BufferType::GPU_MEMORY) {
-                    // TODO: Implement GPU memory freeing if needed
+                    GpuMemory::release(gpuPtr);
                     gpuPtr = nullptr;
                 }
             }
 
+            void releaseSnapshot() {
+                SharedBuffer *buffer = snapshot.exchange(nullptr, std::memory_order_acq_rel);
+                if (buffer) {
+                    BufferPool::getInstance().release(buffer);
+                }
+            }
+
+            // Give the frame a buffer of its own before it is written, copying the shared one
+            bool unshareBuffer() {
+                releaseSnapshot();
+                if (!sharedBuffer || sharedBuffer->references.load(std::memory_order_acquire) == 1) {
+                    return true;
+                }
+
+                SharedBuffer *buffer = BufferPool::getInstance().acquire(dataSize);
+                if (!buffer) {
+                    return false;
+                }
+                std::memcpy(buffer->data, data, dataSize);
+                BufferPool::getInstance().release(sharedBuffer);
+                sharedBuffer = buffer;
+                data = buffer->data;
+                return true;
+            }
+
+            // Return to the freshly constructed state, keeping string and vector capacity for reuse
+            void reset() {
+                releaseResources();
+
+                data = nullptr;
+                dataSize = 0;
+                width = 0;
+                height = 0;
+                bytesPerPixel = 0;
+                format.clear();
+                pixelFormat = PixelFormat::UNKNOWN;
+                frameId = 0;
+                captureTime = {};
+                ownsData = false;
+                bufferType = BufferType::CPU_MEMORY;
+                isMapped = false;
+                shmName.clear();
+                shmOffset = 0;
+                shmFd = -1;
+                gpuPtr = nullptr;
+                dmaBufFd = -1;
+                isLocked = false;
+                isLockedForWriting = false;
+                validityGeneration = nullptr;
+                validityExpected = 0;
+                sequenceNumber = 0;
+
+                metadata = FrameMetadata();
+                overflowAttributes.clear();
+            }
+
             // Initialize CPU memory
-            bool initializeCPUMemory(int w, int h, int bpp, const std::string &fmt) {
+            bool initializeCPUMemory(int w, int h, int bpp, std::string_view fmt) {
                 width = w;
                 height = h;
                 bytesPerPixel = bpp;
-                format = fmt;
+                format.assign(fmt);
                 dataSize = static_cast<size_t>(width) * height * bytesPerPixel;
                 bufferType = BufferType::CPU_MEMORY;
 
-                // Allocate memory
-                data = malloc(dataSize);
-                if (!data) {
+                // Allocate memory from the pool; the buffer is freed by being released
+                sharedBuffer = BufferPool::getInstance().acquire(dataSize);
+                if (!sharedBuffer) {
                     return false;
                 }
 
-                ownsData = true;
+                data = sharedBuffer->data;
+                ownsData = false;
                 return true;
             }
 
             // Initialize with external CPU memory
             bool initializeExternalCPUMemory(void *ptr, size_t size, int w, int h, int bpp,
-                                             const std::string &fmt, bool takeOwnership) {
+                                             std::string_view fmt, bool takeOwnership) {
                 if (!ptr || size == 0) {
                     return false;
                 }
@@ -121,7 +427,7 @@ namespace medical {
                 width = w;
                 height = h;
                 bytesPerPixel = bpp;
-                format = fmt;
+                format.assign(fmt);
                 dataSize = size;
                 bufferType = BufferType::CPU_MEMORY;
 
@@ -133,11 +439,11 @@ namespace medical {
 
             // Initialize with shared memory mapping
             bool initializeSharedMemoryMapping(const std::string &name, size_t offset, size_t size,
-                                               int w, int h, int bpp, const std::string &fmt) {
+                                               int w, int h, int bpp, std::string_view fmt) {
                 width = w;
                 height = h;
                 bytesPerPixel = bpp;
-                format = fmt;
+                format.assign(fmt);
                 dataSize = size;
                 bufferType = BufferType::CPU_MEMORY; // Still uses CPU memory, just mapped
 
@@ -149,14 +455,14 @@ namespace medical {
                 // Open the shared memory
                 shmFd = shm_open(name.c_str(), O_RDWR, 0666);
                 if (shmFd < 0) {
-                    std::cerr << "Failed to open shared memory: " << strerror(errno) << std::endl;
+                    MIVI_LOG_ERROR("Failed to open shared memory: {}", strerror(errno));
                     return false;
                 }
 
                 // Map the region
                 data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, offset);
                 if (data == MAP_FAILED) {
-                    std::cerr << "Failed to map shared memory: " << strerror(errno) << std::endl;
+                    MIVI_LOG_ERROR("Failed to map shared memory: {}", strerror(errno));
                     close(shmFd);
                     shmFd = -1;
                     data = nullptr;
@@ -170,11 +476,11 @@ namespace medical {
 
             // Initialize with GPU memory
             bool initializeGPUMemory(void *gpuMemory, size_t size, int w, int h, int bpp,
-                                     const std::string &fmt, bool takeOwnership) {
+                                     std::string_view fmt, bool takeOwnership) {
                 width = w;
                 height = h;
                 bytesPerPixel = bpp;
-                format = fmt;
+                format.assign(fmt);
                 dataSize = size;
                 bufferType = BufferType::GPU_MEMORY;
 
@@ -189,6 +495,41 @@ namespace medical {
                 return true;
             }
 
+            // Initialize with the CPU mapping of a DMA buffer
+            bool initializeDmaBuffer(void *ptr, size_t size, int w, int h, int bpp, std::string_view fmt) {
+                if (!ptr || size == 0) {
+                    return false;
+                }
+
+                width = w;
+                height = h;
+                bytesPerPixel = bpp;
+                format.assign(fmt);
+                dataSize = size;
+                bufferType = BufferType::DMA_BUFFER;
+
+                // The exporter owns the buffer and its mapping
+                data = ptr;
+                ownsData = false;
+
+                return true;
+            }
+
+            // Bracket CPU access to a dma-buf so the exporter's caches stay coherent with devices
+            bool syncDmaBuffer(uint64_t flags) const {
+                if (dmaBufFd < 0) {
+                    return true;
+                }
+                dma_buf_sync sync{};
+                sync.flags = flags;
+                while (ioctl(dmaBufFd, DMA_BUF_IOCTL_SYNC, &sync) != 0) {
+                    if (errno != EINTR && errno != EAGAIN) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
             // Lock buffer for CPU access
             bool lockForCPU(bool forWriting) {
                 if (isLocked) {
@@ -201,7 +542,10 @@ namespace medical {
 
                 switch (bufferType) {
                     case BufferType::CPU_MEMORY:
-                        // Already in CPU memory - just mark as locked
+                        // Already in CPU memory; a writer first gets its own copy of a shared buffer
+                        if (forWriting && !unshareBuffer()) {
+                            return false;
+                        }
                         isLocked = true;
                         isLockedForWriting = forWriting;
                         return true;
@@ -211,8 +555,16 @@ namespace medical {
                         return false;
 
                     case BufferType::DMA_BUFFER:
-                        // TODO: Implement DMA buffer locking if needed
-                        return false;
+                        if (!data || !syncDmaBuffer(DMA_BUF_SYNC_START |
+                                                    (forWriting ? DMA_BUF_SYNC_RW : DMA_BUF_SYNC_READ))) {
+                            return false;
+                        }
+                        if (forWriting) {
+                            releaseSnapshot();
+                        }
+                        isLocked = true;
+                        isLockedForWriting = forWriting;
+                        return true;
 
                     case BufferType::EXTERNAL_MEMORY:
                         // External memory handling depends on the specific memory type
@@ -242,7 +594,7 @@ namespace medical {
                         break;
 
                     case BufferType::DMA_BUFFER:
-                        // TODO: Implement DMA buffer unlocking if needed
+                        syncDmaBuffer(DMA_BUF_SYNC_END | (isLockedForWriting ? DMA_BUF_SYNC_RW : DMA_BUF_SYNC_READ));
                         isLocked = false;
                         isLockedForWriting = false;
                         break;
@@ -256,6 +608,62 @@ namespace medical {
             }
         };
 
+        /**
+         * @brief Keeps released Frame objects (with their Impl) for reuse by the factories
+         */
+        class Frame::Pool {
+        public:
+            static Pool &getInstance() {
+                // Leaked on purpose: frames may be released during static destruction
+                static auto *instance = new Pool();
+                return *instance;
+            }
+
+            std::shared_ptr<Frame> acquire() {
+                Frame *frame = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!freeFrames_.empty()) {
+                        frame = freeFrames_.back();
+                        freeFrames_.pop_back();
+                    }
+                }
+
+                if (!frame) {
+                    frame = new Frame();
+                }
+
+                return std::shared_ptr<Frame>(frame, Recycler(), ControlBlockAllocator<Frame>());
+            }
+
+            void recycle(Frame *frame) {
+                // Run the destroy callback and free owned resources exactly as the destructor would
+                frame->releaseForReuse();
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (freeFrames_.size() < FRAME_POOL_CAPACITY) {
+                        freeFrames_.push_back(frame);
+                        return;
+                    }
+                }
+
+                delete frame;
+            }
+
+        private:
+            Pool() {
+                freeFrames_.reserve(FRAME_POOL_CAPACITY);
+            }
+
+            std::mutex mutex_;
+            std::vector<Frame *> freeFrames_;
+        };
+
+        void Frame::Recycler::operator()(Frame *frame) const {
+            Pool::getInstance().recycle(frame);
+        }
+
         Frame::Frame() : impl_(std::make_unique<Impl>()) {
         }
 
@@ -268,11 +676,31 @@ namespace medical {
             // impl_ destructor will clean up resources
         }
 
+        void Frame::releaseForReuse() {
+            if (onDestroyCallback_) {
+                onDestroyCallback_();
+                onDestroyCallback_ = nullptr;
+            }
+
+            impl_->reset();
+        }
+
         std::shared_ptr<Frame> Frame::create(
             int width, int height, int bytesPerPixel, const std::string &format,
             BufferType bufferType) {
+            return create(width, height, bytesPerPixel, format, pixelFormatFromString(format), bufferType);
+        }
+
+        std::shared_ptr<Frame> Frame::create(
+            int width, int height, int bytesPerPixel, PixelFormat format, BufferType bufferType) {
+            return create(width, height, bytesPerPixel, toString(format), format, bufferType);
+        }
+
+        std::shared_ptr<Frame> Frame::create(
+            int width, int height, int bytesPerPixel, std::string_view format, PixelFormat pixelFormat,
+            BufferType bufferType) {
             // Create new frame
-            std::shared_ptr<Frame> frame = std::shared_ptr<Frame>(new Frame());
+            std::shared_ptr<Frame> frame = Pool::getInstance().acquire();
 
             // Initialize based on buffer type
             switch (bufferType) {
@@ -283,9 +711,16 @@ namespace medical {
                     }
                     break;
 
-                case BufferType::GPU_MEMORY:
-                    // TODO: Implement GPU memory allocation if needed
-                    return nullptr;
+                case BufferType::GPU_MEMORY: {
+                    // Device memory on the calling thread's current CUDA device; fails without CUDA
+                    size_t size = static_cast<size_t>(width) * height * bytesPerPixel;
+                    void *devicePointer = GpuMemory::allocate(size);
+                    if (!devicePointer) {
+                        return nullptr;
+                    }
+                    frame->impl_->initializeGPUMemory(devicePointer, size, width, height, bytesPerPixel, format, true);
+                    break;
+                }
 
                 case BufferType::DMA_BUFFER:
                     // TODO: Implement DMA buffer allocation if needed
@@ -296,6 +731,8 @@ namespace medical {
                     return nullptr;
             }
 
+            frame->impl_->pixelFormat = pixelFormat;
+
             // Set initial timestamp
             frame->impl_->timestamp = std::chrono::system_clock::now();
 
@@ -311,12 +748,26 @@ namespace medical {
         std::shared_ptr<Frame> Frame::createWithExternalData(
             void *data, size_t size, int width, int height, int bytesPerPixel,
             const std::string &format, bool ownsData, BufferType bufferType) {
+            return createWithExternalData(data, size, width, height, bytesPerPixel, format,
+                                          pixelFormatFromString(format), ownsData, bufferType);
+        }
+
+        std::shared_ptr<Frame> Frame::createWithExternalData(
+            void *data, size_t size, int width, int height, int bytesPerPixel,
+            PixelFormat format, bool ownsData, BufferType bufferType) {
+            return createWithExternalData(data, size, width, height, bytesPerPixel, toString(format),
+                                          format, ownsData, bufferType);
+        }
+
+        std::shared_ptr<Frame> Frame::createWithExternalData(
+            void *data, size_t size, int width, int height, int bytesPerPixel,
+            std::string_view format, PixelFormat pixelFormat, bool ownsData, BufferType bufferType) {
             if (!data || size == 0) {
                 return nullptr;
             }
 
             // Create new frame
-            std::shared_ptr<Frame> frame = std::shared_ptr<Frame>(new Frame());
+            std::shared_ptr<Frame> frame = Pool::getInstance().acquire();
 
             // Initialize based on buffer type
             switch (bufferType) {
@@ -337,8 +788,11 @@ namespace medical {
                     break;
 
                 case BufferType::DMA_BUFFER:
-                    // TODO: Implement DMA buffer handling if needed
-                    return nullptr;
+                    // CPU mapping of a dma-buf; setDmaBufFd() names the buffer for locking
+                    if (!frame->impl_->initializeDmaBuffer(data, size, width, height, bytesPerPixel, format)) {
+                        return nullptr;
+                    }
+                    break;
 
                 case BufferType::EXTERNAL_MEMORY:
                     // Generic external memory - just store the pointer
@@ -350,6 +804,8 @@ namespace medical {
                     break;
             }
 
+            frame->impl_->pixelFormat = pixelFormat;
+
             // Set initial timestamp
             frame->impl_->timestamp = std::chrono::system_clock::now();
 
@@ -365,8 +821,10 @@ namespace medical {
         std::shared_ptr<Frame> Frame::createMapped(
             const std::string &shmName, size_t offset, size_t size,
             int width, int height, int bytesPerPixel, const std::string &format) {
+            PixelFormat pixelFormat = pixelFormatFromString(format);
+
             // Create new frame
-            std::shared_ptr<Frame> frame = std::shared_ptr<Frame>(new Frame());
+            std::shared_ptr<Frame> frame = Pool::getInstance().acquire();
 
             // Initialize with shared memory mapping
             if (!frame->impl_->initializeSharedMemoryMapping(
@@ -374,6 +832,8 @@ namespace medical {
                 return nullptr;
             }
 
+            frame->impl_->pixelFormat = pixelFormat;
+
             // Set initial timestamp
             frame->impl_->timestamp = std::chrono::system_clock::now();
 
@@ -390,6 +850,18 @@ namespace medical {
             return impl_->data;
         }
 
+        void *Frame::getDevicePointer() const {
+            return impl_->gpuPtr;
+        }
+
+        int Frame::getDmaBufFd() const {
+            return impl_->dmaBufFd;
+        }
+
+        void Frame::setDmaBufFd(int fd) {
+            impl_->dmaBufFd = fd;
+        }
+
         size_t Frame::getDataSize() const {
             return impl_->dataSize;
         }
@@ -410,6 +882,10 @@ namespace medical {
             return impl_->format;
         }
 
+        PixelFormat Frame::getPixelFormat() const {
+            return impl_->pixelFormat;
+        }
+
         std::chrono::system_clock::time_point Frame::getTimestamp() const {
             return impl_->timestamp;
         }
@@ -418,6 +894,14 @@ namespace medical {
             impl_->timestamp = timestamp;
         }
 
+        std::chrono::steady_clock::time_point Frame::getCaptureTime() const {
+            return impl_->captureTime;
+        }
+
+        void Frame::setCaptureTime(std::chrono::steady_clock::time_point captureTime) {
+            impl_->captureTime = captureTime;
+        }
+
         uint64_t Frame::getFrameId() const {
             return impl_->frameId;
         }
@@ -426,6 +910,14 @@ namespace medical {
             impl_->frameId = id;
         }
 
+        uint64_t Frame::getSequenceNumber() const {
+            return impl_->sequenceNumber;
+        }
+
+        void Frame::setSequenceNumber(uint64_t sequenceNumber) {
+            impl_->sequenceNumber = sequenceNumber;
+        }
+
         BufferType Frame::getBufferType() const {
             return impl_->bufferType;
         }
@@ -450,6 +942,21 @@ namespace medical {
             return impl_->isMapped;
         }
 
+        void Frame::setValidityGuard(const std::atomic<uint64_t> *generation, uint64_t expected) {
+            impl_->validityGeneration = generation;
+            impl_->validityExpected = expected;
+        }
+
+        bool Frame::validate() const {
+            if (!impl_->validityGeneration) {
+                return true;
+            }
+
+            // Order all earlier reads of the frame data before re-reading the generation
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return impl_->validityGeneration->load(std::memory_order_relaxed) == impl_->validityExpected;
+        }
+
         std::shared_ptr<Frame> Frame::clone(BufferType targetBufferType) const {
             // Create a new frame with the specified buffer type
             auto newFrame = Frame::create(
@@ -457,12 +964,39 @@ namespace medical {
                 impl_->height,
                 impl_->bytesPerPixel,
                 impl_->format,
+                impl_->pixelFormat,
                 targetBufferType);
 
             if (!newFrame) {
                 return nullptr;
             }
 
+            // Device memory cannot be locked for the CPU; copy through the CUDA runtime instead
+            if (isGpuMemory() || newFrame->isGpuMemory()) {
+                bool copied;
+                if (isGpuMemory() && newFrame->isGpuMemory()) {
+                    copied = GpuMemory::copyOnDevice(newFrame->impl_->gpuPtr, impl_->gpuPtr, impl_->dataSize);
+                } else if (isGpuMemory()) {
+                    copied = newFrame->lock(false) &&
+                             GpuMemory::copyToHost(newFrame->impl_->data, impl_->gpuPtr, impl_->dataSize);
+                    newFrame->unlock();
+                } else {
+                    copied = const_cast<Frame *>(this)->lock(true) &&
+                             GpuMemory::copyToDevice(newFrame->impl_->gpuPtr, impl_->data, impl_->dataSize);
+                    const_cast<Frame *>(this)->unlock();
+                }
+                if (!copied) {
+                    return nullptr;
+                }
+
+                newFrame->impl_->frameId = impl_->frameId;
+                newFrame->impl_->timestamp = impl_->timestamp;
+                newFrame->impl_->captureTime = impl_->captureTime;
+                newFrame->impl_->metadata = impl_->metadata;
+                newFrame->impl_->overflowAttributes = impl_->overflowAttributes;
+                return newFrame;
+            }
+
             // Lock the source and destination for access
             bool srcLocked = const_cast<Frame *>(this)->lock(true);
             bool dstLocked = newFrame->lock(false);
@@ -483,18 +1017,93 @@ namespace medical {
             // Copy metadata
             newFrame->impl_->frameId = impl_->frameId;
             newFrame->impl_->timestamp = impl_->timestamp;
+            newFrame->impl_->captureTime = impl_->captureTime;
             newFrame->impl_->metadata = impl_->metadata;
+            newFrame->impl_->overflowAttributes = impl_->overflowAttributes;
+
+            return newFrame;
+        }
+
+        std::shared_ptr<Frame> Frame::cloneShared() const {
+            if (isGpuMemory()) {
+                return clone();
+            }
+            if (!impl_->data || impl_->dataSize == 0) {
+                return nullptr;
+            }
+
+            BufferPool &pool = BufferPool::getInstance();
+            SharedBuffer *buffer = impl_->sharedBuffer;
+            if (!buffer) {
+                // The data is not pooled: copy it once and let every later clone share the copy
+                buffer = impl_->snapshot.load(std::memory_order_acquire);
+                if (!buffer) {
+                    SharedBuffer *copy = pool.acquire(impl_->dataSize);
+                    if (!copy) {
+                        return nullptr;
+                    }
 
+                    // External memory cannot be locked but is readable as is
+                    bool locked = const_cast<Frame *>(this)->lock(true);
+                    if (!locked && impl_->bufferType != BufferType::EXTERNAL_MEMORY) {
+                        pool.release(copy);
+                        return nullptr;
+                    }
+                    std::memcpy(copy->data, impl_->data, impl_->dataSize);
+                    if (locked) {
+                        const_cast<Frame *>(this)->unlock();
+                    }
+
+                    // Another thread may have taken the snapshot meanwhile; keep the first one
+                    SharedBuffer *expected = nullptr;
+                    if (impl_->snapshot.compare_exchange_strong(expected, copy, std::memory_order_acq_rel)) {
+                        buffer = copy;
+                    } else {
+                        pool.release(copy);
+                        buffer = expected;
+                    }
+                }
+            }
+            buffer->references.fetch_add(1, std::memory_order_relaxed);
+
+            std::shared_ptr<Frame> newFrame = Pool::getInstance().acquire();
+            Impl &target = *newFrame->impl_;
+            target.sharedBuffer = buffer;
+            target.data = buffer->data;
+            target.dataSize = impl_->dataSize;
+            target.width = impl_->width;
+            target.height = impl_->height;
+            target.bytesPerPixel = impl_->bytesPerPixel;
+            target.format = impl_->format;
+            target.pixelFormat = impl_->pixelFormat;
+            target.bufferType = BufferType::CPU_MEMORY;
+            target.frameId = impl_->frameId;
+            target.timestamp = impl_->timestamp;
+            target.captureTime = impl_->captureTime;
+            target.sequenceNumber = impl_->sequenceNumber;
+            target.metadata = impl_->metadata;
+            target.overflowAttributes = impl_->overflowAttributes;
             return newFrame;
         }
 
         void Frame::setMetadata(const std::string &key, const std::string &value) {
-            impl_->metadata.attributes[key] = value;
+            if (impl_->metadata.attributes.set(key, value)) {
+                impl_->overflowAttributes.erase(key);
+                return;
+            }
+
+            // The inline table is full: keep the pair with the frame instead, off the shared memory path
+            impl_->metadata.attributes.erase(key);
+            impl_->overflowAttributes[key] = value;
         }
 
         std::string Frame::getMetadata(const std::string &key) const {
-            auto it = impl_->metadata.attributes.find(key);
-            if (it != impl_->metadata.attributes.end()) {
+            if (auto value = impl_->metadata.attributes.find(key)) {
+                return std::string(*value);
+            }
+
+            auto it = impl_->overflowAttributes.find(key);
+            if (it != impl_->overflowAttributes.end()) {
                 return it->second;
             }
 
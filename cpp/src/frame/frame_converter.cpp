@@ -0,0 +1,542 @@
+#include "frame/frame_converter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "utils/cpu_features.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MIVI_CONVERTER_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIVI_CONVERTER_NEON 1
+#endif
+
+namespace medical::imaging {
+    namespace {
+        // BT.709 limited-range YCbCr to RGB coefficients in Q6 fixed point. Q6 keeps every
+        // intermediate inside int16 so the SIMD kernels can use 16-bit lanes.
+        constexpr int COEFF_Y = 75;   // 1.164
+        constexpr int COEFF_RV = 115; // 1.793
+        constexpr int COEFF_GU = 14;  // 0.213
+        constexpr int COEFF_GV = 34;  // 0.533
+        constexpr int COEFF_BU = 135; // 2.112
+        constexpr int COEFF_SHIFT = 6;
+
+        using RowKernel = void (*)(const uint8_t *src, uint8_t *dst, int width);
+        using PlanarRowKernel = void (*)(const uint8_t *src, uint16_t *y, uint16_t *u, uint16_t *v, int width);
+        using WideRowKernel = void (*)(const uint8_t *src, uint16_t *dst, int width);
+
+        // 10-bit sample at field 0, 1 or 2 of a v210 or r210 word
+        inline uint16_t field10(uint32_t word, int field) {
+            return static_cast<uint16_t>((word >> (10 * field)) & 0x3FF);
+        }
+
+        inline uint8_t clampToByte(int value) {
+            return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+        }
+
+        // Scalar reference; the SIMD kernels fall back to it for the tail of each row
+        void grayRowScalar(const uint8_t *src, uint8_t *dst, int width) {
+            for (int x = 0; x < width; ++x) {
+                dst[x] = src[2 * x + 1];
+            }
+        }
+
+        void rgbRowScalar(const uint8_t *src, uint8_t *dst, int width) {
+            for (int x = 0; x < width; x += 2) {
+                const uint8_t *pair = src + 2 * x;
+                int u = pair[0] - 128;
+                int v = pair[2] - 128;
+                int ruv = COEFF_RV * v;
+                int guv = COEFF_GU * u + COEFF_GV * v;
+                int buv = COEFF_BU * u;
+                constexpr int round = 1 << (COEFF_SHIFT - 1);
+
+                for (int i = 0; i < 2 && x + i < width; ++i) {
+                    int y = (pair[1 + 2 * i] - 16) * COEFF_Y;
+                    uint8_t *rgb = dst + 3 * (x + i);
+                    rgb[0] = clampToByte((y + ruv + round) >> COEFF_SHIFT);
+                    rgb[1] = clampToByte((y - guv + round) >> COEFF_SHIFT);
+                    rgb[2] = clampToByte((y + buv + round) >> COEFF_SHIFT);
+                }
+            }
+        }
+
+        // v210 packs 6 pixels into four little-endian words: Cb0 Y0 Cr0 | Y1 Cb2 Y2 | Cr2 Y3 Cb4 | Y4 Cr4 Y5
+        void v210RowScalar(const uint8_t *src, uint16_t *y, uint16_t *u, uint16_t *v, int width) {
+            for (int x = 0; x < width; x += 6) {
+                uint32_t words[4];
+                std::memcpy(words, src + x / 6 * 16, sizeof(words));
+                const uint16_t luma[6] = {field10(words[0], 1), field10(words[1], 0), field10(words[1], 2),
+                                          field10(words[2], 1), field10(words[3], 0), field10(words[3], 2)};
+                const uint16_t cb[3] = {field10(words[0], 0), field10(words[1], 1), field10(words[2], 2)};
+                const uint16_t cr[3] = {field10(words[0], 2), field10(words[2], 0), field10(words[3], 1)};
+                for (int i = 0; i < 6 && x + i < width; ++i) {
+                    y[x + i] = luma[i];
+                }
+                for (int i = 0; i < 3 && x + 2 * i < width; ++i) {
+                    u[x / 2 + i] = cb[i];
+                    v[x / 2 + i] = cr[i];
+                }
+            }
+        }
+
+        // r210 is one big-endian word per pixel: 2 padding bits, then R, G and B
+        void r210RowScalar(const uint8_t *src, uint16_t *dst, int width) {
+            for (int x = 0; x < width; ++x) {
+                const uint8_t *pixel = src + 4 * x;
+                uint32_t word = (static_cast<uint32_t>(pixel[0]) << 24) | (static_cast<uint32_t>(pixel[1]) << 16) |
+                                (static_cast<uint32_t>(pixel[2]) << 8) | pixel[3];
+                dst[3 * x] = field10(word, 2);
+                dst[3 * x + 1] = field10(word, 1);
+                dst[3 * x + 2] = field10(word, 0);
+            }
+        }
+
+#if defined(MIVI_CONVERTER_X86)
+        __attribute__((target("avx2")))
+        void grayRowAvx2(const uint8_t *src, uint8_t *dst, int width) {
+            int x = 0;
+            for (; x + 32 <= width; x += 32) {
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * x));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * x + 32));
+                __m256i y = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+                y = _mm256_permute4x64_epi64(y, 0xD8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x), y);
+            }
+            grayRowScalar(src + 2 * x, dst + x, width - x);
+        }
+
+        __attribute__((target("avx512f,avx512bw")))
+        void grayRowAvx512(const uint8_t *src, uint8_t *dst, int width) {
+            const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+            int x = 0;
+            for (; x + 64 <= width; x += 64) {
+                __m512i a = _mm512_loadu_si512(src + 2 * x);
+                __m512i b = _mm512_loadu_si512(src + 2 * x + 64);
+                __m512i y = _mm512_packus_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+                // The zero-masked form with a full mask: the plain one starts from an undefined vector,
+                // which GCC 12 reports as maybe uninitialized
+                y = _mm512_maskz_permutexvar_epi64(0xFF, order, y);
+                _mm512_storeu_si512(dst + x, y);
+            }
+            grayRowAvx2(src + 2 * x, dst + x, width - x);
+        }
+
+        // 16 pixels per iteration: 16-bit math in one ymm, then three pshufb passes interleave RGB24
+        __attribute__((target("avx2")))
+        void rgbRowAvx2(const uint8_t *src, uint8_t *dst, int width) {
+            const __m256i lowByte = _mm256_set1_epi16(0x00FF);
+            const __m256i uShuffle = _mm256_setr_epi8(
+                0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13,
+                0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13);
+            const __m256i vShuffle = _mm256_setr_epi8(
+                2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15,
+                2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+            const __m256i lumaOffset = _mm256_set1_epi16(16);
+            const __m256i chromaOffset = _mm256_set1_epi16(128);
+            const __m256i round = _mm256_set1_epi16(1 << (COEFF_SHIFT - 1));
+            const __m256i coeffY = _mm256_set1_epi16(COEFF_Y);
+            const __m256i coeffRv = _mm256_set1_epi16(COEFF_RV);
+            const __m256i coeffGu = _mm256_set1_epi16(COEFF_GU);
+            const __m256i coeffGv = _mm256_set1_epi16(COEFF_GV);
+            const __m256i coeffBu = _mm256_set1_epi16(COEFF_BU);
+
+            const __m128i r0 = _mm_setr_epi8(0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5);
+            const __m128i g0 = _mm_setr_epi8(-128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128);
+            const __m128i b0 = _mm_setr_epi8(-128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128);
+            const __m128i r1 = _mm_setr_epi8(-128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128);
+            const __m128i g1 = _mm_setr_epi8(5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10);
+            const __m128i b1 = _mm_setr_epi8(-128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128);
+            const __m128i r2 = _mm_setr_epi8(-128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128);
+            const __m128i g2 = _mm_setr_epi8(-128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128);
+            const __m128i b2 = _mm_setr_epi8(10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15);
+
+            int x = 0;
+            for (; x + 16 <= width; x += 16) {
+                __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 2 * x));
+                __m256i luma = _mm256_srli_epi16(pixels, 8);
+                __m256i chroma = _mm256_and_si256(pixels, lowByte);
+                __m256i u = _mm256_sub_epi16(_mm256_shuffle_epi8(chroma, uShuffle), chromaOffset);
+                __m256i v = _mm256_sub_epi16(_mm256_shuffle_epi8(chroma, vShuffle), chromaOffset);
+
+                __m256i y = _mm256_mullo_epi16(_mm256_sub_epi16(luma, lumaOffset), coeffY);
+                y = _mm256_add_epi16(y, round);
+                __m256i guv = _mm256_add_epi16(_mm256_mullo_epi16(u, coeffGu), _mm256_mullo_epi16(v, coeffGv));
+
+                __m256i r = _mm256_srai_epi16(_mm256_adds_epi16(y, _mm256_mullo_epi16(v, coeffRv)), COEFF_SHIFT);
+                __m256i g = _mm256_srai_epi16(_mm256_subs_epi16(y, guv), COEFF_SHIFT);
+                __m256i b = _mm256_srai_epi16(_mm256_adds_epi16(y, _mm256_mullo_epi16(u, coeffBu)), COEFF_SHIFT);
+
+                __m128i r8 = _mm_packus_epi16(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+                __m128i g8 = _mm_packus_epi16(_mm256_castsi256_si128(g), _mm256_extracti128_si256(g, 1));
+                __m128i b8 = _mm_packus_epi16(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+
+                __m128i out0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r8, r0), _mm_shuffle_epi8(g8, g0)),
+                                            _mm_shuffle_epi8(b8, b0));
+                __m128i out1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r8, r1), _mm_shuffle_epi8(g8, g1)),
+                                            _mm_shuffle_epi8(b8, b1));
+                __m128i out2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r8, r2), _mm_shuffle_epi8(g8, g2)),
+                                            _mm_shuffle_epi8(b8, b2));
+
+                uint8_t *rgb = dst + 3 * x;
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb), out0);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + 16), out1);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + 32), out2);
+            }
+            rgbRowScalar(src + 2 * x, dst + 3 * x, width - x);
+        }
+
+        // Two v210 groups (12 pixels) per iteration, one per 128-bit lane. The three fields of every word are
+        // masked out and packed to 16 bits, then pshufb gathers Y, U and V. Each lane's stores run a few samples
+        // past its group and are overwritten by the next lane, hence the two spare samples in the loop bound.
+        __attribute__((target("avx2")))
+        void v210RowAvx2(const uint8_t *src, uint16_t *y, uint16_t *u, uint16_t *v, int width) {
+            const __m256i mask = _mm256_set1_epi32(0x3FF);
+            // ab holds fields 0 of the four words then fields 1, cc fields 2 twice
+            const __m256i yFromAb = _mm256_setr_epi8(
+                8, 9, 2, 3, -128, -128, 12, 13, 6, 7, -128, -128, -128, -128, -128, -128,
+                8, 9, 2, 3, -128, -128, 12, 13, 6, 7, -128, -128, -128, -128, -128, -128);
+            const __m256i yFromCc = _mm256_setr_epi8(
+                -128, -128, -128, -128, 2, 3, -128, -128, -128, -128, 6, 7, -128, -128, -128, -128,
+                -128, -128, -128, -128, 2, 3, -128, -128, -128, -128, 6, 7, -128, -128, -128, -128);
+            // U in samples 0-2, V in samples 4-6
+            const __m256i uvFromAb = _mm256_setr_epi8(
+                0, 1, 10, 11, -128, -128, -128, -128, -128, -128, 4, 5, 14, 15, -128, -128,
+                0, 1, 10, 11, -128, -128, -128, -128, -128, -128, 4, 5, 14, 15, -128, -128);
+            const __m256i uvFromCc = _mm256_setr_epi8(
+                -128, -128, -128, -128, 4, 5, -128, -128, 0, 1, -128, -128, -128, -128, -128, -128,
+                -128, -128, -128, -128, 4, 5, -128, -128, 0, 1, -128, -128, -128, -128, -128, -128);
+
+            int x = 0;
+            for (; x + 14 <= width; x += 12) {
+                __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x / 6 * 16));
+                __m256i a = _mm256_and_si256(words, mask);
+                __m256i b = _mm256_and_si256(_mm256_srli_epi32(words, 10), mask);
+                __m256i c = _mm256_and_si256(_mm256_srli_epi32(words, 20), mask);
+                __m256i ab = _mm256_packs_epi32(a, b);
+                __m256i cc = _mm256_packs_epi32(c, c);
+                __m256i luma = _mm256_or_si256(_mm256_shuffle_epi8(ab, yFromAb), _mm256_shuffle_epi8(cc, yFromCc));
+                __m256i chroma = _mm256_or_si256(_mm256_shuffle_epi8(ab, uvFromAb), _mm256_shuffle_epi8(cc, uvFromCc));
+
+                __m128i luma0 = _mm256_castsi256_si128(luma);
+                __m128i luma1 = _mm256_extracti128_si256(luma, 1);
+                __m128i chroma0 = _mm256_castsi256_si128(chroma);
+                __m128i chroma1 = _mm256_extracti128_si256(chroma, 1);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(y + x), luma0);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(y + x + 6), luma1);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2), chroma0);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(u + x / 2 + 3), chroma1);
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2), _mm_srli_si128(chroma0, 8));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(v + x / 2 + 3), _mm_srli_si128(chroma1, 8));
+            }
+            v210RowScalar(src + x / 6 * 16, y + x, u + x / 2, v + x / 2, width - x);
+        }
+
+        // 8 pixels per iteration: byte-swap the words, mask out R, G and B, and interleave 4 pixels per lane
+        __attribute__((target("avx2")))
+        void r210RowAvx2(const uint8_t *src, uint16_t *dst, int width) {
+            const __m256i mask = _mm256_set1_epi32(0x3FF);
+            const __m256i byteSwap = _mm256_setr_epi8(
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            // rg holds R of the four pixels then G, bb B twice
+            const __m256i head0 = _mm256_setr_epi8(
+                0, 1, 8, 9, -128, -128, 2, 3, 10, 11, -128, -128, 4, 5, 12, 13,
+                0, 1, 8, 9, -128, -128, 2, 3, 10, 11, -128, -128, 4, 5, 12, 13);
+            const __m256i head1 = _mm256_setr_epi8(
+                -128, -128, -128, -128, 0, 1, -128, -128, -128, -128, 2, 3, -128, -128, -128, -128,
+                -128, -128, -128, -128, 0, 1, -128, -128, -128, -128, 2, 3, -128, -128, -128, -128);
+            const __m256i tail0 = _mm256_setr_epi8(
+                -128, -128, 6, 7, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+                -128, -128, 6, 7, 14, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128);
+            const __m256i tail1 = _mm256_setr_epi8(
+                4, 5, -128, -128, -128, -128, 6, 7, -128, -128, -128, -128, -128, -128, -128, -128,
+                4, 5, -128, -128, -128, -128, 6, 7, -128, -128, -128, -128, -128, -128, -128, -128);
+
+            int x = 0;
+            for (; x + 8 <= width; x += 8) {
+                __m256i words = _mm256_shuffle_epi8(
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 4 * x)), byteSwap);
+                __m256i r = _mm256_and_si256(_mm256_srli_epi32(words, 20), mask);
+                __m256i g = _mm256_and_si256(_mm256_srli_epi32(words, 10), mask);
+                __m256i b = _mm256_and_si256(words, mask);
+                __m256i rg = _mm256_packs_epi32(r, g);
+                __m256i bb = _mm256_packs_epi32(b, b);
+                __m256i head = _mm256_or_si256(_mm256_shuffle_epi8(rg, head0), _mm256_shuffle_epi8(bb, head1));
+                __m256i tail = _mm256_or_si256(_mm256_shuffle_epi8(rg, tail0), _mm256_shuffle_epi8(bb, tail1));
+
+                uint16_t *rgb = dst + 3 * x;
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb), _mm256_castsi256_si128(head));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(rgb + 8), _mm256_castsi256_si128(tail));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + 12), _mm256_extracti128_si256(head, 1));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(rgb + 20), _mm256_extracti128_si256(tail, 1));
+            }
+            r210RowScalar(src + 4 * x, dst + 3 * x, width - x);
+        }
+#endif
+
+#if defined(MIVI_CONVERTER_NEON)
+        void grayRowNeon(const uint8_t *src, uint8_t *dst, int width) {
+            int x = 0;
+            for (; x + 16 <= width; x += 16) {
+                uint8x16x2_t pixels = vld2q_u8(src + 2 * x);
+                vst1q_u8(dst + x, pixels.val[1]);
+            }
+            grayRowScalar(src + 2 * x, dst + x, width - x);
+        }
+
+        // 16 pixels per iteration: vld4 splits U/Y0/V/Y1, vst3 interleaves RGB24
+        void rgbRowNeon(const uint8_t *src, uint8_t *dst, int width) {
+            const int16x8_t lumaOffset = vdupq_n_s16(16);
+            const int16x8_t chromaOffset = vdupq_n_s16(128);
+
+            int x = 0;
+            for (; x + 16 <= width; x += 16) {
+                uint8x8x4_t pixels = vld4_u8(src + 2 * x);
+                int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(pixels.val[0])), chromaOffset);
+                int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(pixels.val[2])), chromaOffset);
+                int16x8_t ruv = vmulq_n_s16(v, COEFF_RV);
+                int16x8_t guv = vmlaq_n_s16(vmulq_n_s16(u, COEFF_GU), v, COEFF_GV);
+                int16x8_t buv = vmulq_n_s16(u, COEFF_BU);
+
+                uint8x8_t channels[2][3];
+                for (int i = 0; i < 2; ++i) {
+                    int16x8_t luma = vreinterpretq_s16_u16(vmovl_u8(pixels.val[1 + 2 * i]));
+                    int16x8_t y = vmulq_n_s16(vsubq_s16(luma, lumaOffset), COEFF_Y);
+                    channels[i][0] = vqrshrun_n_s16(vqaddq_s16(y, ruv), COEFF_SHIFT);
+                    channels[i][1] = vqrshrun_n_s16(vqsubq_s16(y, guv), COEFF_SHIFT);
+                    channels[i][2] = vqrshrun_n_s16(vqaddq_s16(y, buv), COEFF_SHIFT);
+                }
+
+                uint8x16x3_t rgb;
+                for (int c = 0; c < 3; ++c) {
+                    uint8x8x2_t zipped = vzip_u8(channels[0][c], channels[1][c]);
+                    rgb.val[c] = vcombine_u8(zipped.val[0], zipped.val[1]);
+                }
+                vst3q_u8(dst + 3 * x, rgb);
+            }
+            rgbRowScalar(src + 2 * x, dst + 3 * x, width - x);
+        }
+
+#if defined(__aarch64__)
+        // One v210 group per iteration; a two-register table lookup gathers Y, U and V like the AVX2 kernel
+        void v210RowNeon(const uint8_t *src, uint16_t *y, uint16_t *u, uint16_t *v, int width) {
+            const uint32x4_t mask = vdupq_n_u32(0x3FF);
+            const uint8_t lumaIndex[16] = {8, 9, 2, 3, 18, 19, 12, 13, 6, 7, 22, 23, 255, 255, 255, 255};
+            const uint8_t chromaIndex[16] = {0, 1, 10, 11, 20, 21, 255, 255, 16, 17, 4, 5, 14, 15, 255, 255};
+            const uint8x16_t lumaTable = vld1q_u8(lumaIndex);
+            const uint8x16_t chromaTable = vld1q_u8(chromaIndex);
+
+            int x = 0;
+            for (; x + 8 <= width; x += 6) {
+                uint32x4_t words = vld1q_u32(reinterpret_cast<const uint32_t *>(src + x / 6 * 16));
+                uint16x4_t a = vmovn_u32(vandq_u32(words, mask));
+                uint16x4_t b = vmovn_u32(vandq_u32(vshrq_n_u32(words, 10), mask));
+                uint16x4_t c = vmovn_u32(vandq_u32(vshrq_n_u32(words, 20), mask));
+                uint8x16x2_t table = {{vreinterpretq_u8_u16(vcombine_u16(a, b)),
+                                       vreinterpretq_u8_u16(vcombine_u16(c, c))}};
+                uint16x8_t luma = vreinterpretq_u16_u8(vqtbl2q_u8(table, lumaTable));
+                uint16x8_t chroma = vreinterpretq_u16_u8(vqtbl2q_u8(table, chromaTable));
+                vst1q_u16(y + x, luma);
+                vst1_u16(u + x / 2, vget_low_u16(chroma));
+                vst1_u16(v + x / 2, vget_high_u16(chroma));
+            }
+            v210RowScalar(src + x / 6 * 16, y + x, u + x / 2, v + x / 2, width - x);
+        }
+#endif
+
+        // 4 pixels per iteration: vrev32 byte-swaps the words, vst3 interleaves RGB48
+        void r210RowNeon(const uint8_t *src, uint16_t *dst, int width) {
+            const uint32x4_t mask = vdupq_n_u32(0x3FF);
+
+            int x = 0;
+            for (; x + 4 <= width; x += 4) {
+                uint32x4_t words = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(src + 4 * x)));
+                uint16x4x3_t rgb;
+                rgb.val[0] = vmovn_u32(vandq_u32(vshrq_n_u32(words, 20), mask));
+                rgb.val[1] = vmovn_u32(vandq_u32(vshrq_n_u32(words, 10), mask));
+                rgb.val[2] = vmovn_u32(vandq_u32(words, mask));
+                vst3_u16(dst + 3 * x, rgb);
+            }
+            r210RowScalar(src + 4 * x, dst + 3 * x, width - x);
+        }
+#endif
+
+        struct Kernels {
+            const char *name;
+            RowKernel grayRow;
+            RowKernel rgbRow;
+            PlanarRowKernel v210Row;
+            WideRowKernel r210Row;
+        };
+
+        const Kernels &getKernels() {
+            return cpu::selectKernels([]([[maybe_unused]] const cpu::Features &features) -> Kernels {
+#if defined(MIVI_CONVERTER_X86)
+                if (features.avx512bw && features.avx2) {
+                    return {"avx512bw", grayRowAvx512, rgbRowAvx2, v210RowAvx2, r210RowAvx2};
+                }
+                if (features.avx2) {
+                    return {"avx2", grayRowAvx2, rgbRowAvx2, v210RowAvx2, r210RowAvx2};
+                }
+#elif defined(MIVI_CONVERTER_NEON) && defined(__aarch64__)
+                return {"neon", grayRowNeon, rgbRowNeon, v210RowNeon, r210RowNeon};
+#elif defined(MIVI_CONVERTER_NEON)
+                return {"neon", grayRowNeon, rgbRowNeon, v210RowScalar, r210RowNeon};
+#endif
+                return {"scalar", grayRowScalar, rgbRowScalar, v210RowScalar, r210RowScalar};
+            });
+        }
+
+        void convertRows(RowKernel kernel, const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride,
+                         int width, int height) {
+            for (int row = 0; row < height; ++row) {
+                kernel(src + row * srcStride, dst + row * dstStride, width);
+            }
+        }
+    } // namespace
+
+    FrameConverter::FrameConverter(PixelFormat outputFormat)
+        : outputFormat_(outputFormat) {
+    }
+
+    PixelFormat FrameConverter::getOutputFormat() const {
+        return outputFormat_;
+    }
+
+    bool FrameConverter::supports(PixelFormat input, PixelFormat output) {
+        switch (output) {
+            case PixelFormat::GRAY_8:
+            case PixelFormat::RGB_8:
+                return input == PixelFormat::YUV422_8;
+            case PixelFormat::YUV422P_16:
+                return input == PixelFormat::YUV422_10;
+            case PixelFormat::RGB_16:
+                return input == PixelFormat::RGB_10;
+            default:
+                return false;
+        }
+    }
+
+    PixelFormat FrameConverter::getInputFormat(PixelFormat output) {
+        for (PixelFormat input: {PixelFormat::YUV422_8, PixelFormat::YUV422_10, PixelFormat::RGB_10}) {
+            if (supports(input, output)) {
+                return input;
+            }
+        }
+        return PixelFormat::UNKNOWN;
+    }
+
+    size_t FrameConverter::getOutputSize(int width, int height) const {
+        return getPixelFormatInfo(outputFormat_).frameBytes(width, height);
+    }
+
+    std::shared_ptr<Frame> FrameConverter::convert(const Frame &input, void *output, size_t outputSize) const {
+        if (!supports(input.getPixelFormat(), outputFormat_)) {
+            return nullptr;
+        }
+
+        int width = input.getWidth();
+        int height = input.getHeight();
+        size_t srcStride = height > 0 ? input.getDataSize() / height : 0;
+        if (width <= 0 || height <= 0 || !input.getData() ||
+            srcStride < getPixelFormatInfo(input.getPixelFormat()).rowBytes(width)) {
+            return nullptr;
+        }
+
+        // The planes of a 4:2:2 frame only line up for even widths, which is all v210 capture produces
+        const PixelFormatInfo outputInfo = getPixelFormatInfo(outputFormat_);
+        if (outputInfo.planes > 1 && width % 2 != 0) {
+            return nullptr;
+        }
+
+        int bytesPerPixel = static_cast<int>(outputInfo.bytesPerBlock / outputInfo.pixelsPerBlock);
+        size_t requiredSize = getOutputSize(width, height);
+
+        std::shared_ptr<Frame> result;
+        if (output) {
+            if (outputSize < requiredSize) {
+                return nullptr;
+            }
+            result = Frame::createWithExternalData(output, requiredSize, width, height, bytesPerPixel,
+                                                   outputFormat_, false, BufferType::EXTERNAL_MEMORY);
+        } else {
+            result = Frame::create(width, height, bytesPerPixel, outputFormat_);
+        }
+        if (!result) {
+            return nullptr;
+        }
+
+        const auto *src = static_cast<const uint8_t *>(input.getData());
+        auto *dst = static_cast<uint8_t *>(result->getData());
+        size_t dstStride = static_cast<size_t>(width) * bytesPerPixel;
+
+        switch (outputFormat_) {
+            case PixelFormat::GRAY_8:
+                uyvyToGray8(src, srcStride, dst, dstStride, width, height);
+                break;
+            case PixelFormat::RGB_8:
+                uyvyToRgb24(src, srcStride, dst, dstStride, width, height);
+                break;
+            case PixelFormat::YUV422P_16: {
+                auto *y = reinterpret_cast<uint16_t *>(dst);
+                auto *u = y + static_cast<size_t>(width) * height;
+                auto *v = u + static_cast<size_t>(width / 2) * height;
+                v210ToYuv422p16(src, srcStride, y, u, v, width, height);
+                break;
+            }
+            default:
+                r210ToRgb48(src, srcStride, reinterpret_cast<uint16_t *>(dst), static_cast<size_t>(width) * 3,
+                            width, height);
+                break;
+        }
+
+        result->setFrameId(input.getFrameId());
+        result->setTimestamp(input.getTimestamp());
+        result->setCaptureTime(input.getCaptureTime());
+        FrameMetadata &metadata = result->getMetadataMutable();
+        metadata = input.getMetadata();
+        if (metadata.bytesPerPixel != 0) {
+            metadata.bytesPerPixel = bytesPerPixel;
+        }
+        if (!metadata.format.empty()) {
+            metadata.format = toString(outputFormat_);
+        }
+        return result;
+    }
+
+    void FrameConverter::uyvyToGray8(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride,
+                                     int width, int height) {
+        convertRows(getKernels().grayRow, src, srcStride, dst, dstStride, width, height);
+    }
+
+    void FrameConverter::uyvyToRgb24(const uint8_t *src, size_t srcStride, uint8_t *dst, size_t dstStride,
+                                     int width, int height) {
+        convertRows(getKernels().rgbRow, src, srcStride, dst, dstStride, width, height);
+    }
+
+    void FrameConverter::v210ToYuv422p16(const uint8_t *src, size_t srcStride, uint16_t *y, uint16_t *u,
+                                         uint16_t *v, int width, int height) {
+        PlanarRowKernel kernel = getKernels().v210Row;
+        size_t chromaWidth = static_cast<size_t>(width + 1) / 2;
+        for (int row = 0; row < height; ++row) {
+            kernel(src + row * srcStride, y + row * static_cast<size_t>(width), u + row * chromaWidth,
+                   v + row * chromaWidth, width);
+        }
+    }
+
+    void FrameConverter::r210ToRgb48(const uint8_t *src, size_t srcStride, uint16_t *dst, size_t dstStride,
+                                     int width, int height) {
+        WideRowKernel kernel = getKernels().r210Row;
+        for (int row = 0; row < height; ++row) {
+            kernel(src + row * srcStride, dst + row * dstStride, width);
+        }
+    }
+
+    const char *FrameConverter::getKernelName() {
+        return getKernels().name;
+    }
+} // namespace medical::imaging
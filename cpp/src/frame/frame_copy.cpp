@@ -0,0 +1,300 @@
+#include "frame/frame_copy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "utils/cpu_features.h"
+#include "utils/futex.h"
+#include "utils/thread_layout.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MIVI_COPY_X86 1
+#elif defined(__aarch64__)
+#define MIVI_COPY_NEON 1
+#endif
+
+namespace medical::imaging {
+    namespace {
+        using CopyKernel = void (*)(uint8_t *dst, const uint8_t *src, size_t size);
+
+        // Streaming stores want whole cache lines; this is the part copied normally to get there
+        inline size_t headToAlignment(const uint8_t *dst, size_t alignment, size_t size) {
+            size_t misalignment = reinterpret_cast<uintptr_t>(dst) & (alignment - 1);
+            return std::min(size, misalignment == 0 ? 0 : alignment - misalignment);
+        }
+
+        void copyMemcpy(uint8_t *dst, const uint8_t *src, size_t size) {
+            std::memcpy(dst, src, size);
+        }
+
+#if defined(MIVI_COPY_X86)
+        // Source lines are fetched well ahead without polluting the cache either
+        constexpr size_t PREFETCH_DISTANCE = 512;
+
+        void copyStreamSse2(uint8_t *dst, const uint8_t *src, size_t size) {
+            size_t head = headToAlignment(dst, 64, size);
+            std::memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            size -= head;
+
+            for (; size >= 64; size -= 64, dst += 64, src += 64) {
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE), _MM_HINT_NTA);
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16));
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 32));
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 48));
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst), a);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 16), b);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 32), c);
+                _mm_stream_si128(reinterpret_cast<__m128i *>(dst + 48), d);
+            }
+            std::memcpy(dst, src, size);
+
+            // Streaming stores are weakly ordered: drain them before anyone publishes the payload
+            _mm_sfence();
+        }
+
+        __attribute__((target("avx2")))
+        void copyStreamAvx2(uint8_t *dst, const uint8_t *src, size_t size) {
+            size_t head = headToAlignment(dst, 64, size);
+            std::memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            size -= head;
+
+            for (; size >= 128; size -= 128, dst += 128, src += 128) {
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE), _MM_HINT_NTA);
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE + 64), _MM_HINT_NTA);
+                __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+                __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 32));
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 64));
+                __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + 96));
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst), a);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 32), b);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 64), c);
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst + 96), d);
+            }
+            for (; size >= 32; size -= 32, dst += 32, src += 32) {
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(dst),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)));
+            }
+            std::memcpy(dst, src, size);
+            _mm_sfence();
+        }
+
+        __attribute__((target("avx512f")))
+        void copyStreamAvx512(uint8_t *dst, const uint8_t *src, size_t size) {
+            size_t head = headToAlignment(dst, 64, size);
+            std::memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            size -= head;
+
+            for (; size >= 256; size -= 256, dst += 256, src += 256) {
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE), _MM_HINT_NTA);
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE + 64), _MM_HINT_NTA);
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE + 128), _MM_HINT_NTA);
+                _mm_prefetch(reinterpret_cast<const char *>(src + PREFETCH_DISTANCE + 192), _MM_HINT_NTA);
+                __m512i a = _mm512_loadu_si512(src);
+                __m512i b = _mm512_loadu_si512(src + 64);
+                __m512i c = _mm512_loadu_si512(src + 128);
+                __m512i d = _mm512_loadu_si512(src + 192);
+                _mm512_stream_si512(reinterpret_cast<__m512i *>(dst), a);
+                _mm512_stream_si512(reinterpret_cast<__m512i *>(dst + 64), b);
+                _mm512_stream_si512(reinterpret_cast<__m512i *>(dst + 128), c);
+                _mm512_stream_si512(reinterpret_cast<__m512i *>(dst + 192), d);
+            }
+            for (; size >= 64; size -= 64, dst += 64, src += 64) {
+                _mm512_stream_si512(reinterpret_cast<__m512i *>(dst), _mm512_loadu_si512(src));
+            }
+            std::memcpy(dst, src, size);
+            _mm_sfence();
+        }
+#endif
+
+#if defined(MIVI_COPY_NEON)
+        // STNP is the non-temporal hint of AArch64; the barrier orders it like sfence does on x86
+        void copyStreamNeon(uint8_t *dst, const uint8_t *src, size_t size) {
+            size_t head = headToAlignment(dst, 64, size);
+            std::memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            size -= head;
+
+            for (; size >= 64; size -= 64, dst += 64, src += 64) {
+                __asm__ volatile(
+                    "ldp q0, q1, [%1]\n\t"
+                    "ldp q2, q3, [%1, #32]\n\t"
+                    "stnp q0, q1, [%0]\n\t"
+                    "stnp q2, q3, [%0, #32]\n\t"
+                    :
+                    : "r"(dst), "r"(src)
+                    : "v0", "v1", "v2", "v3", "memory");
+            }
+            std::memcpy(dst, src, size);
+            __asm__ volatile("dmb ishst" ::: "memory");
+        }
+#endif
+
+        struct Kernels {
+            const char *name;
+            CopyKernel stream;
+        };
+
+        const Kernels &getKernels() {
+            return cpu::selectKernels([]([[maybe_unused]] const cpu::Features &features) -> Kernels {
+#if defined(MIVI_COPY_X86)
+                if (features.avx512f) {
+                    return {"avx512", copyStreamAvx512};
+                }
+                if (features.avx2) {
+                    return {"avx2", copyStreamAvx2};
+                }
+                return {"sse2", copyStreamSse2};
+#elif defined(MIVI_COPY_NEON)
+                return {"neon", copyStreamNeon};
+#else
+                return {"memcpy", copyMemcpy};
+#endif
+            });
+        }
+
+        // How long an idle helper sleeps before re-checking for stop
+        constexpr auto HELPER_STOP_CHECK_INTERVAL = std::chrono::milliseconds(100);
+    } // namespace
+
+    FrameCopier::FrameCopier(CopyMode mode, size_t threads)
+        : mode_(mode),
+          jobDestination_(nullptr),
+          jobSource_(nullptr),
+          jobSize_(0),
+          jobChunk_(0),
+          jobStreaming_(false),
+          jobGeneration_(0),
+          jobPending_(0),
+          stopHelpers_(false) {
+        for (size_t i = 1; i < threads; ++i) {
+            helpers_.emplace_back(&FrameCopier::helperThread, this, i);
+        }
+    }
+
+    FrameCopier::~FrameCopier() {
+        stopHelpers_.store(true, std::memory_order_release);
+        jobGeneration_.fetch_add(1, std::memory_order_seq_cst);
+        futex::wake(&jobGeneration_);
+        for (auto &helper: helpers_) {
+            helper.join();
+        }
+    }
+
+    void FrameCopier::copy(void *destination, const void *source, size_t size) {
+        auto *dst = static_cast<uint8_t *>(destination);
+        const auto *src = static_cast<const uint8_t *>(source);
+        bool streaming = mode_ == CopyMode::STREAMING || (mode_ == CopyMode::AUTO && size >= STREAMING_THRESHOLD);
+
+        // Split only when every thread gets a chunk worth waking it for
+        size_t threads = std::min(helpers_.size() + 1, std::max<size_t>(1, size / MIN_CHUNK_BYTES));
+        if (threads <= 1) {
+            copyChunk(dst, src, size, streaming);
+            return;
+        }
+
+        // Page-aligned chunks keep every thread on whole lines and pages of the destination
+        size_t chunk = ((size / threads) + 4095) & ~static_cast<size_t>(4095);
+        jobDestination_ = dst;
+        jobSource_ = src;
+        jobSize_ = size;
+        jobChunk_ = chunk;
+        jobStreaming_ = streaming;
+        jobPending_.store(static_cast<uint32_t>(helpers_.size()), std::memory_order_relaxed);
+        jobGeneration_.fetch_add(1, std::memory_order_seq_cst);
+        futex::wake(&jobGeneration_);
+
+        copyChunk(dst, src, std::min(chunk, size), streaming);
+
+        // Helpers fence their own streaming stores before signing off
+        uint32_t pending = jobPending_.load(std::memory_order_acquire);
+        while (pending != 0) {
+            futex::wait(&jobPending_, pending, HELPER_STOP_CHECK_INTERVAL);
+            pending = jobPending_.load(std::memory_order_acquire);
+        }
+    }
+
+    CopyMode FrameCopier::getMode() const {
+        return mode_;
+    }
+
+    size_t FrameCopier::getThreadCount() const {
+        return helpers_.size() + 1;
+    }
+
+    void FrameCopier::copyStreaming(void *destination, const void *source, size_t size) {
+        getKernels().stream(static_cast<uint8_t *>(destination), static_cast<const uint8_t *>(source), size);
+    }
+
+    const char *FrameCopier::getKernelName() {
+        return getKernels().name;
+    }
+
+    bool FrameCopier::parseMode(const std::string &name, CopyMode &mode) {
+        if (name == "auto") {
+            mode = CopyMode::AUTO;
+        } else if (name == "memcpy") {
+            mode = CopyMode::MEMCPY;
+        } else if (name == "streaming") {
+            mode = CopyMode::STREAMING;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    const char *FrameCopier::toString(CopyMode mode) {
+        switch (mode) {
+            case CopyMode::AUTO: return "auto";
+            case CopyMode::MEMCPY: return "memcpy";
+            case CopyMode::STREAMING: return "streaming";
+        }
+        return "unknown";
+    }
+
+    void FrameCopier::copyChunk(uint8_t *destination, const uint8_t *source, size_t size, bool streaming) const {
+        if (streaming) {
+            getKernels().stream(destination, source, size);
+        } else {
+            copyMemcpy(destination, source, size);
+        }
+    }
+
+    void FrameCopier::helperThread(size_t index) {
+        ThreadLayout::applyCurrentThread("copy-" + std::to_string(index));
+
+        // Helpers start before the first job, so every generation after 0 is one to work on
+        uint32_t seen = 0;
+        while (true) {
+            uint32_t generation = jobGeneration_.load(std::memory_order_acquire);
+            if (generation == seen) {
+                futex::wait(&jobGeneration_, generation, HELPER_STOP_CHECK_INTERVAL);
+                continue;
+            }
+            seen = generation;
+            if (stopHelpers_.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            // The last chunks may be empty when the size does not divide evenly
+            size_t offset = std::min(index * jobChunk_, jobSize_);
+            size_t size = std::min(jobChunk_, jobSize_ - offset);
+            if (size > 0) {
+                copyChunk(jobDestination_ + offset, jobSource_ + offset, size, jobStreaming_);
+            }
+
+            if (jobPending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                futex::wake(&jobPending_);
+            }
+        }
+    }
+} // namespace medical::imaging
@@ -0,0 +1,103 @@
+#include "frame/frame_fingerprint.h"
+
+#include <cstring>
+
+namespace medical::imaging {
+    namespace {
+        constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+        constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr size_t LANES = FrameFingerprint::BLOCK_BYTES / sizeof(uint64_t);
+
+        inline uint64_t rotateLeft(uint64_t value, int bits) {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        // One 64-byte block into eight independent lanes; no lane depends on another, so this vectorizes
+        inline void mixBlock(uint64_t (&lanes)[LANES], const uint8_t *block) {
+            uint64_t words[LANES];
+            std::memcpy(words, block, sizeof(words));
+            for (size_t i = 0; i < LANES; ++i) {
+                lanes[i] = rotateLeft(lanes[i] + words[i] * PRIME_2, 31) * PRIME_1;
+            }
+        }
+
+        // Final avalanche, so that nearby inputs land far apart
+        inline uint64_t finalize(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33;
+            value *= 0xC4CEB9FE1A85EC53ULL;
+            value ^= value >> 33;
+            return value;
+        }
+    } // namespace
+
+    uint64_t FrameFingerprint::compute(const void *data, size_t size, size_t samples, uint64_t seed) {
+        uint64_t lanes[LANES];
+        for (size_t i = 0; i < LANES; ++i) {
+            lanes[i] = seed + PRIME_1 * (i + 1);
+        }
+
+        const auto *bytes = static_cast<const uint8_t *>(data);
+        size_t blocks = size / BLOCK_BYTES;
+        if (samples == 0 || samples >= blocks) {
+            // Hash everything, the tail padded with zeros to a whole block
+            for (size_t block = 0; block < blocks; ++block) {
+                mixBlock(lanes, bytes + block * BLOCK_BYTES);
+            }
+            size_t tail = size - blocks * BLOCK_BYTES;
+            if (tail > 0) {
+                uint8_t last[BLOCK_BYTES] = {};
+                std::memcpy(last, bytes + blocks * BLOCK_BYTES, tail);
+                mixBlock(lanes, last);
+            }
+        } else {
+            // One block from the middle of each of samples equal stretches of the buffer
+            size_t stride = size / samples;
+            size_t offset = (stride - BLOCK_BYTES) / 2;
+            for (size_t sample = 0; sample < samples; ++sample) {
+                mixBlock(lanes, bytes + sample * stride + offset);
+            }
+        }
+
+        uint64_t hash = static_cast<uint64_t>(size) * PRIME_2;
+        for (size_t i = 0; i < LANES; ++i) {
+            hash = rotateLeft(hash ^ lanes[i], 27) * PRIME_1 + PRIME_2;
+        }
+        return finalize(hash);
+    }
+
+    uint64_t FrameFingerprint::compute(const Frame &frame, size_t samples) {
+        const void *data = frame.getData();
+        if (!data || frame.getDataSize() == 0) {
+            return 0;
+        }
+
+        uint64_t geometry = (static_cast<uint64_t>(frame.getWidth()) << 32) ^
+                            (static_cast<uint64_t>(frame.getHeight()) << 8) ^
+                            static_cast<uint64_t>(frame.getPixelFormat());
+        return compute(data, frame.getDataSize(), samples, finalize(geometry));
+    }
+
+    bool FrameFingerprint::parsePolicy(const std::string &name, DuplicatePolicy &policy) {
+        if (name == "publish") {
+            policy = DuplicatePolicy::PUBLISH;
+        } else if (name == "mark") {
+            policy = DuplicatePolicy::MARK;
+        } else if (name == "throttle") {
+            policy = DuplicatePolicy::THROTTLE;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    const char *FrameFingerprint::toString(DuplicatePolicy policy) {
+        switch (policy) {
+            case DuplicatePolicy::PUBLISH: return "publish";
+            case DuplicatePolicy::MARK: return "mark";
+            case DuplicatePolicy::THROTTLE: return "throttle";
+        }
+        return "unknown";
+    }
+} // namespace medical::imaging
@@ -0,0 +1,222 @@
+#include "frame/frame_scaler.h"
+
+#include <algorithm>
+
+#include "utils/cpu_features.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MIVI_SCALER_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define MIVI_SCALER_NEON 1
+#endif
+
+namespace medical::imaging {
+    namespace {
+        // Fixed-point reciprocal of the block area, so the horizontal pass divides with a multiply
+        constexpr int RECIPROCAL_SHIFT = 16;
+
+        using AccumulateKernel = void (*)(const uint8_t *src, uint16_t *sums, size_t count);
+
+        // Scalar reference; the SIMD kernels fall back to it for the tail of each row
+        void accumulateRowScalar(const uint8_t *src, uint16_t *sums, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                sums[i] = static_cast<uint16_t>(sums[i] + src[i]);
+            }
+        }
+
+#if defined(MIVI_SCALER_X86)
+        __attribute__((target("avx2")))
+        void accumulateRowAvx2(const uint8_t *src, uint16_t *sums, size_t count) {
+            size_t i = 0;
+            for (; i + 32 <= count; i += 32) {
+                __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                __m256i low = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes));
+                __m256i high = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes, 1));
+                auto *out = reinterpret_cast<__m256i *>(sums + i);
+                _mm256_storeu_si256(out, _mm256_add_epi16(_mm256_loadu_si256(out), low));
+                _mm256_storeu_si256(out + 1, _mm256_add_epi16(_mm256_loadu_si256(out + 1), high));
+            }
+            accumulateRowScalar(src + i, sums + i, count - i);
+        }
+#endif
+
+#if defined(MIVI_SCALER_NEON)
+        void accumulateRowNeon(const uint8_t *src, uint16_t *sums, size_t count) {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                uint8x16_t bytes = vld1q_u8(src + i);
+                vst1q_u16(sums + i, vaddw_u8(vld1q_u16(sums + i), vget_low_u8(bytes)));
+                vst1q_u16(sums + i + 8, vaddw_u8(vld1q_u16(sums + i + 8), vget_high_u8(bytes)));
+            }
+            accumulateRowScalar(src + i, sums + i, count - i);
+        }
+#endif
+
+        struct Kernels {
+            const char *name;
+            AccumulateKernel accumulateRow;
+        };
+
+        const Kernels &getKernels() {
+            return cpu::selectKernels([]([[maybe_unused]] const cpu::Features &features) -> Kernels {
+#if defined(MIVI_SCALER_X86)
+                if (features.avx2) {
+                    return {"avx2", accumulateRowAvx2};
+                }
+#elif defined(MIVI_SCALER_NEON)
+                return {"neon", accumulateRowNeon};
+#endif
+                return {"scalar", accumulateRowScalar};
+            });
+        }
+
+        inline uint8_t blockMean(uint32_t sum, uint32_t reciprocal) {
+            uint32_t mean = (sum * reciprocal + (1u << (RECIPROCAL_SHIFT - 1))) >> RECIPROCAL_SHIFT;
+            return static_cast<uint8_t>(std::min<uint32_t>(mean, 255));
+        }
+
+        // Interleaved formats with one pixel per block: average each channel over factor pixels
+        void reducePixels(const uint16_t *sums, uint8_t *dst, int outputWidth, int channels, int factor,
+                          uint32_t reciprocal) {
+            for (int x = 0; x < outputWidth; ++x) {
+                const uint16_t *block = sums + static_cast<size_t>(x) * factor * channels;
+                for (int c = 0; c < channels; ++c) {
+                    uint32_t sum = 0;
+                    for (int k = 0; k < factor; ++k) {
+                        sum += block[k * channels + c];
+                    }
+                    dst[x * channels + c] = blockMean(sum, reciprocal);
+                }
+            }
+        }
+
+        // UYVY: each output pair averages luma over factor pixels and chroma over the factor input pairs it covers
+        void reduceUyvy(const uint16_t *sums, uint8_t *dst, int outputWidth, int factor, uint32_t reciprocal) {
+            for (int x = 0; x < outputWidth; x += 2) {
+                const uint16_t *pairs = sums + static_cast<size_t>(x) * factor * 2;
+                uint32_t u = 0;
+                uint32_t v = 0;
+                uint32_t y0 = 0;
+                uint32_t y1 = 0;
+                for (int k = 0; k < factor; ++k) {
+                    u += pairs[4 * k];
+                    v += pairs[4 * k + 2];
+                    // Input pixel p has its luma at 2p + 1
+                    y0 += pairs[2 * k + 1];
+                    y1 += pairs[2 * (factor + k) + 1];
+                }
+                uint8_t *out = dst + 2 * x;
+                out[0] = blockMean(u, reciprocal);
+                out[1] = blockMean(y0, reciprocal);
+                out[2] = blockMean(v, reciprocal);
+                out[3] = blockMean(y1, reciprocal);
+            }
+        }
+    } // namespace
+
+    FrameScaler::FrameScaler(int factor)
+        : factor_(std::clamp(factor, 1, MAX_FACTOR)) {
+    }
+
+    int FrameScaler::getFactor() const {
+        return factor_;
+    }
+
+    bool FrameScaler::supports(PixelFormat format) {
+        return format == PixelFormat::YUV422_8 || format == PixelFormat::BGRA_8 ||
+               format == PixelFormat::GRAY_8 || format == PixelFormat::RGB_8;
+    }
+
+    size_t FrameScaler::getOutputSize(PixelFormat format, int width, int height,
+                                      int &outputWidth, int &outputHeight) const {
+        outputWidth = width / factor_;
+        outputHeight = height / factor_;
+        if (format == PixelFormat::YUV422_8) {
+            // Whole chroma pairs only
+            outputWidth &= ~1;
+        }
+        if (!supports(format) || outputWidth <= 0 || outputHeight <= 0) {
+            outputWidth = 0;
+            outputHeight = 0;
+            return 0;
+        }
+        return getPixelFormatInfo(format).frameBytes(outputWidth, outputHeight);
+    }
+
+    std::shared_ptr<Frame> FrameScaler::scale(const Frame &input, void *output, size_t outputSize) {
+        PixelFormat format = input.getPixelFormat();
+        int width = input.getWidth();
+        int height = input.getHeight();
+        int outputWidth = 0;
+        int outputHeight = 0;
+        size_t requiredSize = getOutputSize(format, width, height, outputWidth, outputHeight);
+        if (requiredSize == 0 || !input.getData()) {
+            return nullptr;
+        }
+
+        const PixelFormatInfo info = getPixelFormatInfo(format);
+        int bytesPerPixel = static_cast<int>(info.bytesPerBlock / info.pixelsPerBlock);
+        size_t srcStride = input.getDataSize() / height;
+        size_t rowBytes = static_cast<size_t>(outputWidth) * factor_ * bytesPerPixel;
+        if (srcStride < rowBytes) {
+            return nullptr;
+        }
+
+        std::shared_ptr<Frame> result;
+        if (output) {
+            if (outputSize < requiredSize) {
+                return nullptr;
+            }
+            result = Frame::createWithExternalData(output, requiredSize, outputWidth, outputHeight, bytesPerPixel,
+                                                   format, false, BufferType::EXTERNAL_MEMORY);
+        } else {
+            result = Frame::create(outputWidth, outputHeight, bytesPerPixel, format);
+        }
+        if (!result) {
+            return nullptr;
+        }
+
+        const auto *src = static_cast<const uint8_t *>(input.getData());
+        auto *dst = static_cast<uint8_t *>(result->getData());
+        size_t dstStride = static_cast<size_t>(outputWidth) * bytesPerPixel;
+
+        auto area = static_cast<uint32_t>(factor_ * factor_);
+        uint32_t reciprocal = ((1u << RECIPROCAL_SHIFT) + area / 2) / area;
+
+        AccumulateKernel accumulateRow = getKernels().accumulateRow;
+        rowSums_.resize(rowBytes);
+        for (int row = 0; row < outputHeight; ++row) {
+            std::fill(rowSums_.begin(), rowSums_.end(), 0);
+            const uint8_t *block = src + static_cast<size_t>(row) * factor_ * srcStride;
+            for (int k = 0; k < factor_; ++k) {
+                accumulateRow(block + k * srcStride, rowSums_.data(), rowBytes);
+            }
+
+            uint8_t *out = dst + row * dstStride;
+            if (format == PixelFormat::YUV422_8) {
+                reduceUyvy(rowSums_.data(), out, outputWidth, factor_, reciprocal);
+            } else {
+                reducePixels(rowSums_.data(), out, outputWidth, bytesPerPixel, factor_, reciprocal);
+            }
+        }
+
+        result->setFrameId(input.getFrameId());
+        result->setTimestamp(input.getTimestamp());
+        result->setCaptureTime(input.getCaptureTime());
+        FrameMetadata &metadata = result->getMetadataMutable();
+        metadata = input.getMetadata();
+        if (metadata.width != 0) {
+            metadata.width = static_cast<uint32_t>(outputWidth);
+        }
+        if (metadata.height != 0) {
+            metadata.height = static_cast<uint32_t>(outputHeight);
+        }
+        return result;
+    }
+
+    const char *FrameScaler::getKernelName() {
+        return getKernels().name;
+    }
+} // namespace medical::imaging
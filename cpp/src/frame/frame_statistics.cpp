@@ -0,0 +1,198 @@
+#include "frame/frame_statistics.h"
+#include "frame/frame_copy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace medical::imaging {
+    namespace {
+        // Pixels reduced to luma before they are counted
+        constexpr size_t BATCH_PIXELS = 256;
+
+        // BT.709 luma weights in 1/256 units
+        constexpr uint32_t WEIGHT_R = 54;
+        constexpr uint32_t WEIGHT_G = 183;
+        constexpr uint32_t WEIGHT_B = 19;
+
+        inline uint32_t load16(const uint8_t *bytes) {
+            uint16_t value;
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+
+        // Bytes per luma sample in the payload of a supported format, 0 otherwise
+        constexpr size_t sampleBytes(PixelFormat format) {
+            switch (format) {
+                case PixelFormat::GRAY_8: return 1;
+                case PixelFormat::YUV422_8: return 2;
+                case PixelFormat::RGB_8: return 3;
+                case PixelFormat::BGRA_8: return 4;
+                case PixelFormat::YUV422P_16: return 2;
+                case PixelFormat::RGB_16: return 6;
+                default: return 0;
+            }
+        }
+
+        // Reduce count pixels to 8-bit luma; no pixel depends on another, so each loop vectorizes
+        template<PixelFormat F>
+        inline void extractLuma(const uint8_t *pixels, size_t count, uint8_t *luma) {
+            if constexpr (F == PixelFormat::GRAY_8) {
+                std::memcpy(luma, pixels, count);
+            } else if constexpr (F == PixelFormat::YUV422_8) {
+                // UYVY: Y is every second byte
+                for (size_t i = 0; i < count; ++i) {
+                    luma[i] = pixels[2 * i + 1];
+                }
+            } else if constexpr (F == PixelFormat::RGB_8) {
+                for (size_t i = 0; i < count; ++i) {
+                    const uint8_t *p = pixels + 3 * i;
+                    luma[i] = static_cast<uint8_t>((WEIGHT_R * p[0] + WEIGHT_G * p[1] + WEIGHT_B * p[2]) >> 8);
+                }
+            } else if constexpr (F == PixelFormat::BGRA_8) {
+                for (size_t i = 0; i < count; ++i) {
+                    const uint8_t *p = pixels + 4 * i;
+                    luma[i] = static_cast<uint8_t>((WEIGHT_B * p[0] + WEIGHT_G * p[1] + WEIGHT_R * p[2]) >> 8);
+                }
+            } else if constexpr (F == PixelFormat::YUV422P_16) {
+                // 10-bit values in 16-bit samples
+                for (size_t i = 0; i < count; ++i) {
+                    luma[i] = static_cast<uint8_t>(std::min<uint32_t>(load16(pixels + 2 * i), 1023) >> 2);
+                }
+            } else if constexpr (F == PixelFormat::RGB_16) {
+                for (size_t i = 0; i < count; ++i) {
+                    const uint8_t *p = pixels + 6 * i;
+                    uint32_t r = std::min<uint32_t>(load16(p), 1023);
+                    uint32_t g = std::min<uint32_t>(load16(p + 2), 1023);
+                    uint32_t b = std::min<uint32_t>(load16(p + 4), 1023);
+                    luma[i] = static_cast<uint8_t>((WEIGHT_R * r + WEIGHT_G * g + WEIGHT_B * b) >> 10);
+                }
+            }
+        }
+
+        // Four interleaved sub-histograms, so that a run of equal values does not wait on one counter
+        template<PixelFormat F>
+        void accumulate(const uint8_t *bytes, size_t pixels, uint32_t (&counts)[4][256]) {
+            constexpr size_t stride = sampleBytes(F);
+            // Zeroed once per call; extractLuma() fills every counted entry, which GCC cannot prove
+            uint8_t luma[BATCH_PIXELS] = {};
+            while (pixels > 0) {
+                size_t batch = std::min(pixels, BATCH_PIXELS);
+                extractLuma<F>(bytes, batch, luma);
+                size_t i = 0;
+                for (; i + 4 <= batch; i += 4) {
+                    ++counts[0][luma[i]];
+                    ++counts[1][luma[i + 1]];
+                    ++counts[2][luma[i + 2]];
+                    ++counts[3][luma[i + 3]];
+                }
+                for (; i < batch; ++i) {
+                    ++counts[0][luma[i]];
+                }
+                bytes += batch * stride;
+                pixels -= batch;
+            }
+        }
+    } // namespace
+
+    FrameStatistics::FrameStatistics(PixelFormat format, uint32_t width, uint32_t height)
+        : format_(isSupported(format) ? format : PixelFormat::UNKNOWN),
+          lumaBytes_(SIZE_MAX),
+          consumed_(0),
+          saturated_(255),
+          counts_{} {
+        // Only the Y plane of planar YUV is luminance
+        if (format_ == PixelFormat::YUV422P_16) {
+            lumaBytes_ = static_cast<size_t>(width) * height * 2;
+        }
+        // YUV is limited range: white is code 235 (940 at 10 bits); the grey channel is the Y plane
+        if (format_ == PixelFormat::YUV422_8 || format_ == PixelFormat::YUV422P_16 ||
+            format_ == PixelFormat::GRAY_8) {
+            saturated_ = 235;
+        }
+    }
+
+    bool FrameStatistics::isSupported(PixelFormat format) {
+        return sampleBytes(format) != 0;
+    }
+
+    bool FrameStatistics::isSupported() const {
+        return format_ != PixelFormat::UNKNOWN;
+    }
+
+    void FrameStatistics::add(const void *data, size_t size) {
+        size_t offset = consumed_;
+        consumed_ += size;
+        if (format_ == PixelFormat::UNKNOWN || offset >= lumaBytes_) {
+            return;
+        }
+
+        size_t bytes = std::min(size, lumaBytes_ - offset);
+        size_t pixels = bytes / sampleBytes(format_);
+        const auto *source = static_cast<const uint8_t *>(data);
+        dispatchPixelFormat(format_, [&](auto format) {
+            if constexpr (sampleBytes(decltype(format)::value) != 0) {
+                accumulate<decltype(format)::value>(source, pixels, counts_);
+            }
+        });
+    }
+
+    void FrameStatistics::copy(void *destination, const void *source, size_t size, bool streaming) {
+        auto *to = static_cast<uint8_t *>(destination);
+        const auto *from = static_cast<const uint8_t *>(source);
+        for (size_t offset = 0; offset < size; offset += CHUNK_BYTES) {
+            size_t chunk = std::min(CHUNK_BYTES, size - offset);
+            // The chunk is in L1 after add(), so the copy does not go back to memory for it
+            add(from + offset, chunk);
+            if (streaming) {
+                FrameCopier::copyStreaming(to + offset, from + offset, chunk);
+            } else {
+                std::memcpy(to + offset, from + offset, chunk);
+            }
+        }
+    }
+
+    ImageStatistics FrameStatistics::finish() const {
+        ImageStatistics statistics;
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t sumOfSquares = 0;
+        uint64_t saturated = 0;
+        for (uint32_t value = 0; value < 256; ++value) {
+            uint64_t n = static_cast<uint64_t>(counts_[0][value]) + counts_[1][value] + counts_[2][value] +
+                         counts_[3][value];
+            count += n;
+            sum += n * value;
+            sumOfSquares += n * value * value;
+            if (value >= saturated_) {
+                saturated += n;
+            }
+            statistics.histogram[value * ImageStatistics::HISTOGRAM_BINS / 256] += static_cast<uint32_t>(n);
+        }
+        if (count == 0) {
+            return statistics;
+        }
+
+        double mean = static_cast<double>(sum) / static_cast<double>(count);
+        double variance = std::max(0.0, static_cast<double>(sumOfSquares) / static_cast<double>(count) - mean * mean);
+        statistics.pixelCount = static_cast<uint32_t>(count);
+        statistics.meanLuminance = static_cast<float>(mean / 255.0);
+        statistics.luminanceVariance = static_cast<float>(variance / (255.0 * 255.0));
+        statistics.saturatedFraction = static_cast<float>(static_cast<double>(saturated) / static_cast<double>(count));
+        if (mean > 0.0 && variance > 0.0) {
+            statistics.signalToNoiseRatio = static_cast<float>(20.0 * std::log10(mean / std::sqrt(variance)));
+        }
+        return statistics;
+    }
+
+    bool FrameStatistics::compute(const void *data, size_t size, PixelFormat format, uint32_t width, uint32_t height,
+                                  ImageStatistics &statistics) {
+        FrameStatistics accumulator(format, width, height);
+        if (!accumulator.isSupported() || !data) {
+            return false;
+        }
+        accumulator.add(data, size);
+        statistics = accumulator.finish();
+        return true;
+    }
+} // namespace medical::imaging
@@ -0,0 +1,161 @@
+#include "gpu/gpu_memory.h"
+
+#include <cstring>
+
+#ifdef MIVI_HAVE_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace medical::imaging {
+    namespace {
+        thread_local std::string lastError;
+
+#ifdef MIVI_HAVE_CUDA
+        static_assert(sizeof(cudaIpcMemHandle_t) == sizeof(GpuIpcHandle), "CUDA IPC handle size changed");
+
+        bool check(cudaError_t result, const char *call) {
+            if (result == cudaSuccess) {
+                return true;
+            }
+            lastError = std::string(call) + ": " + cudaGetErrorString(result);
+            return false;
+        }
+#endif
+    } // namespace
+
+#ifdef MIVI_HAVE_CUDA
+    bool GpuMemory::isAvailable() {
+        if (getDeviceCount() > 0) {
+            return true;
+        }
+        if (lastError.empty()) {
+            lastError = "no CUDA device present";
+        }
+        return false;
+    }
+
+    int GpuMemory::getDeviceCount() {
+        int count = 0;
+        if (!check(cudaGetDeviceCount(&count), "cudaGetDeviceCount")) {
+            return 0;
+        }
+        return count;
+    }
+
+    std::string GpuMemory::getDeviceName(int device) {
+        cudaDeviceProp properties{};
+        if (!check(cudaGetDeviceProperties(&properties, device), "cudaGetDeviceProperties")) {
+            return {};
+        }
+        return properties.name;
+    }
+
+    bool GpuMemory::setDevice(int device) {
+        return check(cudaSetDevice(device), "cudaSetDevice");
+    }
+
+    void *GpuMemory::allocate(size_t size) {
+        void *devicePointer = nullptr;
+        if (!check(cudaMalloc(&devicePointer, size), "cudaMalloc")) {
+            return nullptr;
+        }
+        return devicePointer;
+    }
+
+    void GpuMemory::release(void *devicePointer) {
+        if (devicePointer) {
+            check(cudaFree(devicePointer), "cudaFree");
+        }
+    }
+
+    bool GpuMemory::copyToDevice(void *devicePointer, const void *hostPointer, size_t size) {
+        return check(cudaMemcpy(devicePointer, hostPointer, size, cudaMemcpyHostToDevice), "cudaMemcpy");
+    }
+
+    bool GpuMemory::copyToHost(void *hostPointer, const void *devicePointer, size_t size) {
+        return check(cudaMemcpy(hostPointer, devicePointer, size, cudaMemcpyDeviceToHost), "cudaMemcpy");
+    }
+
+    bool GpuMemory::copyOnDevice(void *destination, const void *source, size_t size) {
+        return check(cudaMemcpy(destination, source, size, cudaMemcpyDeviceToDevice), "cudaMemcpy");
+    }
+
+    bool GpuMemory::registerHost(void *hostPointer, size_t size) {
+        // Portable: the pinning holds for every context, whichever device the uploader uses
+        return check(cudaHostRegister(hostPointer, size, cudaHostRegisterPortable), "cudaHostRegister");
+    }
+
+    void GpuMemory::unregisterHost(void *hostPointer) {
+        if (hostPointer) {
+            check(cudaHostUnregister(hostPointer), "cudaHostUnregister");
+        }
+    }
+
+    bool GpuMemory::getIpcHandle(void *devicePointer, GpuIpcHandle &handle) {
+        cudaIpcMemHandle_t ipcHandle;
+        if (!check(cudaIpcGetMemHandle(&ipcHandle, devicePointer), "cudaIpcGetMemHandle")) {
+            return false;
+        }
+        std::memcpy(handle.bytes, &ipcHandle, sizeof(handle.bytes));
+        return true;
+    }
+#else
+    namespace {
+        bool unsupported() {
+            lastError = "built without CUDA support";
+            return false;
+        }
+    } // namespace
+
+    bool GpuMemory::isAvailable() {
+        return unsupported();
+    }
+
+    int GpuMemory::getDeviceCount() {
+        return 0;
+    }
+
+    std::string GpuMemory::getDeviceName(int) {
+        return {};
+    }
+
+    bool GpuMemory::setDevice(int) {
+        return unsupported();
+    }
+
+    void *GpuMemory::allocate(size_t) {
+        unsupported();
+        return nullptr;
+    }
+
+    void GpuMemory::release(void *) {
+    }
+
+    bool GpuMemory::copyToDevice(void *, const void *, size_t) {
+        return unsupported();
+    }
+
+    bool GpuMemory::copyToHost(void *, const void *, size_t) {
+        return unsupported();
+    }
+
+    bool GpuMemory::copyOnDevice(void *, const void *, size_t) {
+        return unsupported();
+    }
+
+    bool GpuMemory::registerHost(void *, size_t) {
+        return unsupported();
+    }
+
+    void GpuMemory::unregisterHost(void *) {
+    }
+
+    bool GpuMemory::getIpcHandle(void *, GpuIpcHandle &) {
+        return unsupported();
+    }
+#endif
+
+    std::string GpuMemory::getLastError() {
+        return lastError;
+    }
+} // namespace medical::imaging
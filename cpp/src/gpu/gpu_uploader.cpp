@@ -0,0 +1,310 @@
+#include "gpu/gpu_uploader.h"
+#include "communication/ring_stage.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <chrono>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <vector>
+
+#ifdef MIVI_HAVE_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+namespace medical::imaging {
+    // How long the uploader sleeps waiting for the next frame; stop() interrupts the wait
+    constexpr unsigned int FRAME_WAIT_MS = 1000;
+
+    // Device state, only touched by the thread running start(), the uploader thread and stop()
+    struct GpuUploader::Device {
+        std::vector<void *> buffers;
+        std::vector<GpuIpcHandle> handles;
+        size_t bufferSize = 0;
+        void *pinnedMapping = nullptr;
+#ifdef MIVI_HAVE_CUDA
+        cudaStream_t stream = nullptr;
+        cudaEvent_t done = nullptr;
+#endif
+
+        void releaseBuffers() {
+            for (void *buffer: buffers) {
+                GpuMemory::release(buffer);
+            }
+            buffers.clear();
+            handles.clear();
+            bufferSize = 0;
+        }
+
+        // Replace the buffers with bufferCount buffers of at least size bytes
+        bool allocateBuffers(uint32_t bufferCount, size_t size) {
+            releaseBuffers();
+            for (uint32_t i = 0; i < bufferCount; ++i) {
+                void *buffer = GpuMemory::allocate(size);
+                GpuIpcHandle handle{};
+                if (!buffer || !GpuMemory::getIpcHandle(buffer, handle)) {
+                    GpuMemory::release(buffer);
+                    releaseBuffers();
+                    return false;
+                }
+                buffers.push_back(buffer);
+                handles.push_back(handle);
+            }
+            bufferSize = size;
+            return true;
+        }
+
+        // Copy a frame into a buffer on the uploader's stream and wait for the DMA to finish
+        bool upload(size_t index, const void *data, size_t size) {
+#ifdef MIVI_HAVE_CUDA
+            return cudaMemcpyAsync(buffers[index], data, size, cudaMemcpyHostToDevice, stream) == cudaSuccess &&
+                   cudaEventRecord(done, stream) == cudaSuccess &&
+                   cudaEventSynchronize(done) == cudaSuccess;
+#else
+            (void) index;
+            (void) data;
+            (void) size;
+            return false;
+#endif
+        }
+
+        bool createStream() {
+#ifdef MIVI_HAVE_CUDA
+            // A blocking-sync event lets the thread sleep through the copy instead of spinning on it
+            return cudaStreamCreateWithFlags(&stream, cudaStreamNonBlocking) == cudaSuccess &&
+                   cudaEventCreateWithFlags(&done, cudaEventBlockingSync | cudaEventDisableTiming) == cudaSuccess;
+#else
+            return false;
+#endif
+        }
+
+        ~Device() {
+            releaseBuffers();
+#ifdef MIVI_HAVE_CUDA
+            if (done) {
+                cudaEventDestroy(done);
+            }
+            if (stream) {
+                cudaStreamDestroy(stream);
+            }
+#endif
+            GpuMemory::unregisterHost(pinnedMapping);
+        }
+    };
+
+    GpuUploader::GpuUploader(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false),
+          framesUploaded_(0),
+          bytesUploaded_(0),
+          framesTorn_(0),
+          framesDropped_(0),
+          allocationEpoch_(0),
+          bufferSize_(0),
+          sourcePinned_(false) {
+    }
+
+    GpuUploader::~GpuUploader() {
+        stop();
+    }
+
+    GpuUploader::Status GpuUploader::start(const SharedMemory::Config &sourceConfig,
+                                           const std::shared_ptr<SharedMemory> &output) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (!output || !output->isInitialized() || config_.bufferCount < 2) {
+            return Status::INVALID_ARGUMENT;
+        }
+        if (!GpuMemory::isAvailable()) {
+            MIVI_LOG_WARNING("GPU upload is not available: {}", GpuMemory::getLastError());
+            return Status::NOT_SUPPORTED;
+        }
+        if (config_.device < 0 || config_.device >= GpuMemory::getDeviceCount() ||
+            !GpuMemory::setDevice(config_.device)) {
+            MIVI_LOG_ERROR("Invalid CUDA device {}", config_.device);
+            return Status::INVALID_ARGUMENT;
+        }
+
+        // Attach as a lossy reader: the upload must never hold back capture
+        SharedMemory::Config readerConfig = sourceConfig;
+        readerConfig.create = false;
+        readerConfig.readerMode = ReaderMode::LOSSY;
+        readerConfig.lockInMemory = false;
+        auto source = std::make_shared<SharedMemory>(readerConfig);
+        if (source->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("GPU uploader failed to attach to shared memory {}", sourceConfig.name);
+            return Status::CONNECTION_FAILED;
+        }
+
+        auto device = std::make_unique<Device>();
+        if (!device->createStream()) {
+            MIVI_LOG_ERROR("Failed to create the CUDA upload stream");
+            return Status::GPU_ERROR;
+        }
+
+        // Pinning is an optimization: without it the driver stages every copy through its own buffer
+        sourcePinned_ = false;
+        if (config_.pinSource) {
+            if (GpuMemory::registerHost(source->getMappingAddress(), source->getMappingSize())) {
+                device->pinnedMapping = source->getMappingAddress();
+                sourcePinned_ = true;
+            } else {
+                MIVI_LOG_ERROR("Failed to pin shared memory {} for the GPU: {}",
+                        sourceConfig.name, GpuMemory::getLastError());
+            }
+        }
+
+        device_ = std::move(device);
+        source_ = std::move(source);
+        output_ = output;
+        framesUploaded_ = 0;
+        bytesUploaded_ = 0;
+        framesTorn_ = 0;
+        framesDropped_ = 0;
+        allocationEpoch_ = 0;
+        bufferSize_ = 0;
+        uploadTimeHistogram_.reset();
+
+        stopRequested_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&GpuUploader::uploaderThread, this);
+        return Status::OK;
+    }
+
+    GpuUploader::Status GpuUploader::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        stopRequested_ = true;
+        source_->interruptWaits();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+
+        // Unpin and free the buffers; the source stays mapped for the statistics until the next start()
+        device_.reset();
+        sourcePinned_ = false;
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    bool GpuUploader::isRunning() const {
+        return isRunning_;
+    }
+
+    const GpuUploader::Config &GpuUploader::getConfig() const {
+        return config_;
+    }
+
+    GpuUploader::Statistics GpuUploader::getStatistics() const {
+        Statistics stats{};
+        stats.framesUploaded = framesUploaded_.load(std::memory_order_relaxed);
+        stats.bytesUploaded = bytesUploaded_.load(std::memory_order_relaxed);
+        stats.framesTorn = framesTorn_.load(std::memory_order_relaxed);
+        stats.framesDropped = framesDropped_.load(std::memory_order_relaxed);
+        stats.allocationEpoch = allocationEpoch_.load(std::memory_order_relaxed);
+        stats.bufferSize = bufferSize_.load(std::memory_order_relaxed);
+        stats.sourcePinned = sourcePinned_.load(std::memory_order_relaxed);
+
+        // Our own reader slot tells how far behind the writer we are
+        SharedMemory::ReaderInfo reader{};
+        if (source_ && source_->getOwnReader(reader)) {
+            stats.lagFrames = reader.lag;
+            stats.framesSkipped = reader.framesSkipped;
+        }
+        return stats;
+    }
+
+    std::map<std::string, std::string> GpuUploader::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["gpu_device"] = std::to_string(config_.device);
+        map["gpu_buffer_count"] = std::to_string(config_.bufferCount);
+        map["gpu_buffer_size"] = std::to_string(stats.bufferSize);
+        map["gpu_source_pinned"] = stats.sourcePinned ? "true" : "false";
+        map["gpu_frames_uploaded"] = std::to_string(stats.framesUploaded);
+        map["gpu_bytes_uploaded"] = std::to_string(stats.bytesUploaded);
+        map["gpu_frames_torn"] = std::to_string(stats.framesTorn);
+        map["gpu_frames_dropped"] = std::to_string(stats.framesDropped);
+        map["gpu_frames_skipped"] = std::to_string(stats.framesSkipped);
+        map["gpu_lag_frames"] = std::to_string(stats.lagFrames);
+        map["gpu_allocation_epoch"] = std::to_string(stats.allocationEpoch);
+        appendHistogramStatistics(map, "gpu_upload_time", uploadTimeHistogram_.snapshot());
+        return map;
+    }
+
+    const LatencyHistogram &GpuUploader::getUploadTimeHistogram() const {
+        return uploadTimeHistogram_;
+    }
+
+    void GpuUploader::uploaderThread() {
+        if (!ThreadLayout::applyCurrentThread(config_.threadRole) && config_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        // The current device is per thread
+        GpuMemory::setDevice(config_.device);
+
+        GpuFrameDescriptor descriptor{};
+        std::memcpy(descriptor.magic, "MVG1", sizeof(descriptor.magic));
+        descriptor.version = 1;
+        descriptor.headerSize = sizeof(GpuFrameDescriptor);
+        descriptor.device = config_.device;
+        descriptor.bufferCount = config_.bufferCount;
+        descriptor.ownerPid = static_cast<uint32_t>(getpid());
+        uint64_t uploadSequence = 0;
+
+        runRingStage(*source_, stopRequested_, FRAME_WAIT_MS, framesTorn_, [&](const Frame &frame, auto &intact) {
+            size_t size = frame.getDataSize();
+            if (size > device_->bufferSize) {
+                // Grow for the new geometry; consumers see the epoch change and reopen the handles
+                if (!device_->allocateBuffers(config_.bufferCount, size)) {
+                    MIVI_LOG_ERROR("Failed to allocate GPU upload buffers: {}", GpuMemory::getLastError());
+                    framesDropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                allocationEpoch_.fetch_add(1, std::memory_order_relaxed);
+                bufferSize_.store(size, std::memory_order_relaxed);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            size_t index = static_cast<size_t>(uploadSequence % config_.bufferCount);
+            if (!device_->upload(index, frame.getData(), size)) {
+                framesDropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            uploadTimeHistogram_.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+
+            // The writer may have lapped us while the DMA was reading the slot
+            if (!intact()) {
+                return;
+            }
+
+            descriptor.bufferIndex = static_cast<uint32_t>(index);
+            descriptor.allocationEpoch = allocationEpoch_.load(std::memory_order_relaxed);
+            descriptor.uploadSequence = uploadSequence;
+            descriptor.dataSize = size;
+            descriptor.bufferSize = device_->bufferSize;
+            descriptor.frameId = frame.getFrameId();
+            descriptor.memHandle = device_->handles[index];
+
+            if (publishDerivedFrame(*output_, frame, &descriptor, sizeof(descriptor))) {
+                // Only published uploads take a buffer out of rotation
+                ++uploadSequence;
+                framesUploaded_.fetch_add(1, std::memory_order_relaxed);
+                bytesUploaded_.fetch_add(size, std::memory_order_relaxed);
+            } else {
+                framesDropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+} // namespace medical::imaging
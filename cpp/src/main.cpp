@@ -1,4 +1,12 @@
 #include "api/imaging_service.h"
+#include "api/metrics_server.h"
+#include "api/control_server.h"
+#include "api/grpc_server.h"
+#include "communication/network_bridge.h"
+#include "device/synthetic_device.h"
+#include "recording/frame_recorder.h"
+#include "utils/log.h"
+#include <cstdio>
 #include <iostream>
 #include <string>
 #include <csignal>
@@ -7,10 +15,13 @@
 #include <iomanip>
 #include <chrono>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 #include <sys/resource.h>
 
 // Global variables
 std::atomic<bool> g_running(true);
+std::atomic<bool> g_dumpTrace(false);
 
 // Signal handler
 void signalHandler(int signal) {
@@ -18,6 +29,29 @@ void signalHandler(int signal) {
     g_running = false;
 }
 
+// SIGUSR1 asks for a trace dump; the main loop writes it outside the handler
+void traceSignalHandler(int) {
+    g_dumpTrace = true;
+}
+
+// Split "address:port"; a bare port keeps the address
+bool parseEndpoint(const std::string &text, std::string &address, uint16_t &port) {
+    size_t colon = text.rfind(':');
+    try {
+        int value = std::stoi(colon == std::string::npos ? text : text.substr(colon + 1));
+        if (value <= 0 || value > 65535) {
+            return false;
+        }
+        if (colon != std::string::npos) {
+            address = text.substr(0, colon);
+        }
+        port = static_cast<uint16_t>(value);
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
+
 void printBanner() {
     std::cout << "\n";
     std::cout << "┌─────────────────────────────────────────────────────────┐\n";
@@ -34,24 +68,107 @@ void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [options]\n";
     std::cout << "Options:\n";
     std::cout << "  --device <id>              Device ID to use (default: auto-select)\n";
+    std::cout << "  --devices <id,id,...>      Capture several devices at once, one ring each\n";
+    std::cout << "  --all-devices              Capture every available device at once\n";
     std::cout << "  --width <pixels>           Frame width (default: 1920)\n";
     std::cout << "  --height <pixels>          Frame height (default: 1080)\n";
     std::cout << "  --frame-rate <fps>         Frame rate (default: 60.0)\n";
     std::cout << "  --pixel-format <format>    Pixel format (default: YUV)\n";
+    std::cout << "  --synthetic                Capture from a generated test pattern instead of a card\n";
+    std::cout << "  --synthetic-count <n>      Number of synthetic devices to capture from (default: 1)\n";
+    std::cout << "  --replay <file>            Capture by replaying raw frames from a file\n";
+    std::cout << "  --replay-once              Stop at the end of the replay file instead of looping\n";
+    std::cout << "  --max-rate                 Deliver synthetic frames as fast as possible\n";
+    std::cout << "  --jitter-us <us>           Synthetic delivery jitter standard deviation (default: 0)\n";
+    std::cout << "  --burst <frames>           Deliver synthetic frames in bursts (default: 1)\n";
     std::cout << "  --no-direct-memory         Disable direct memory access\n";
     std::cout << "  --no-realtime              Disable realtime priority\n";
     std::cout << "  --thread-affinity <cpu>    Set thread affinity to CPU core\n";
+    std::cout << "  --numa-node <node>         Place rings, buffers and threads on a NUMA node (default: device's)\n";
     std::cout << "  --no-pin-memory            Don't pin memory (allow swapping)\n";
     std::cout << "  --no-shared-memory         Disable shared memory\n";
     std::cout << "  --shared-memory-name <name> Shared memory name (default: ultrasound_frames)\n";
     std::cout << "  --shared-memory-size <bytes> Shared memory size (default: 128MB)\n";
-    std::cout << "  --shared-memory-type <type> Shared memory type (0=POSIX, 1=SYSV, 2=MMF, 3=HUGE)\n";
+    std::cout << "  --shared-memory-type <type> Shared memory type (0=POSIX, 1=SYSV, 2=MMF, 3=HUGE, 4=MEMFD,\n"
+              << "                               auto=benchmark and pick the fastest)\n";
+    std::cout << "  --huge-pages               Back the rings with huge pages where available\n";
+    std::cout << "  --huge-page-size <MB>      Huge page size to request, e.g. 2 or 1024 (default: system)\n";
+    std::cout << "  --payload-alignment <bytes> Alignment of frame payloads in the rings (default: page size)\n";
+    std::cout << "  --row-alignment <bytes>    Pad the rows of copied frames to a multiple of this (default: none)\n";
+    std::cout << "  --persistent-ring          Keep the rings on exit and re-adopt them on restart\n";
+    std::cout << "  --copy-kernel <mode>       Ring copy: auto, memcpy or streaming (default: auto)\n";
+    std::cout << "  --copy-threads <n>         Threads sharing the copy of one large frame (default: 1)\n";
+    std::cout << "  --publish-bands <rows>     Publish raw frames in bands of this many rows while copying (default: off)\n";
+    std::cout << "  --image-stats              Compute luminance histogram, mean, saturation and SNR per frame\n";
+    std::cout << "  --duplicates <policy>      Repeated (frozen) frames: publish, mark or throttle (default: publish)\n";
+    std::cout << "  --keepalive-fps <fps>      Full frames per second while frozen under throttle (default: 1)\n";
+    std::cout << "  --fingerprint-samples <n>  Blocks sampled to recognise a repeated frame, 0 for all (default: 1024)\n";
+    std::cout << "  --convert <format>         Publish a converted channel (GRAY8, RGB24, YUV422P16 or RGB48)\n";
+    std::cout << "  --converted-name <name>    Converted channel name (default: ultrasound_frames_converted)\n";
+    std::cout << "  --roi <x,y,width,height>   Publish only this region of each captured frame\n";
+    std::cout << "  --preview-scale <n>        Publish a 1/n scale preview channel (default: off)\n";
+    std::cout << "  --preview-fps <fps>        Preview frame rate limit, 0 for every frame (default: 30)\n";
+    std::cout << "  --preview-name <name>      Preview channel name (default: ultrasound_frames_preview)\n";
+    std::cout << "  --compress <codec>         Publish a losslessly compressed channel (zero-run, lz4)\n";
+    std::cout << "  --compress-no-delta        Compress every frame on its own instead of inter-frame deltas\n";
+    std::cout << "  --compress-key-interval <n> Frames between compressed key frames (default: 60)\n";
+    std::cout << "  --compress-core <n>        CPU core for the compressor threads\n";
+    std::cout << "  --compressed-name <name>   Compressed channel name (default: ultrasound_frames_compressed)\n";
+    std::cout << "  --gpu-upload               Upload every frame to a CUDA device and publish IPC handles\n";
+    std::cout << "  --gpu-device <n>           CUDA device for the GPU upload (default: 0)\n";
+    std::cout << "  --gpu-buffers <n>          Device buffers in rotation per channel (default: 4)\n";
+    std::cout << "  --gpu-no-pin               Do not page-lock the frame ring with cudaHostRegister\n";
+    std::cout << "  --gpu-core <n>             CPU core for the GPU uploader threads\n";
+    std::cout << "  --gpu-name <name>          GPU descriptor channel name (default: ultrasound_frames_gpu)\n";
+    std::cout << "  --dmabuf-export            Export every frame as a dma-buf slot passed over a Unix socket\n";
+    std::cout << "  --dmabuf-slots <n>         Dma-buf slots in rotation per channel (default: 4)\n";
+    std::cout << "  --dmabuf-pitch <n>         Row pitch alignment of the dma-buf slots (default: 256)\n";
+    std::cout << "  --dmabuf-socket-dir <dir>  Directory of the dma-buf sockets (default: /tmp)\n";
+    std::cout << "  --dmabuf-core <n>          CPU core for the dma-buf exporter threads\n";
+    std::cout << "  --dmabuf-name <name>       Dma-buf descriptor channel name (default: ultrasound_frames_dmabuf)\n";
+    std::cout << "  --no-format-cache          Ignore the formats consumers request when they register\n";
+    std::cout << "  --format-idle-ms <ms>      How long a requested format ring outlives its last subscriber (default: 2000)\n";
+    std::cout << "  --format-core <n>          CPU core for the requested format conversion threads\n";
+    std::cout << "  --pose-ring <name>         Fill each frame's probe pose from this tracker pose ring (default: none)\n";
+    std::cout << "  --publish-inline           Publish on the device's callback thread instead of a publisher thread\n";
+    std::cout << "  --publish-queue <frames>   Frames waiting for the publisher thread before drops (default: 4)\n";
+    std::cout << "  --publish-core <n>         CPU core for the publisher threads\n";
+    std::cout << "  --no-idle                  Publish every frame even with no consumers or no input signal\n";
+    std::cout << "  --idle-fps <fps>           Keep-alive frames per second on an idle channel, 0 for none (default: 1)\n";
     std::cout << "  --buffer-size <frames>     Frame buffer size (default: 120)\n";
-    std::cout << "  --no-drop-frames           Don't drop frames when buffer is full\n";
+    std::cout << "  --fixed-ring               Keep the whole raw ring in use instead of sizing it to the readers' lag\n";
+    std::cout << "  --ring-min-frames <n>      Fewest frames an adaptive raw ring holds (default: 8)\n";
+    std::cout << "  --ring-shrink-delay <ms>   Low-lag time before an adaptive raw ring gives memory back (default: 30000)\n";
+    std::cout << "  --write-policy <policy>    When lossless readers lag: drop, overwrite or block (default: drop)\n";
+    std::cout << "  --no-drop-frames           Same as --write-policy block\n";
+    std::cout << "  --demote-lag <frames>      Make lossless readers this far behind lossy (default: 0, never)\n";
+    std::cout << "  --demote-stale-ms <ms>     Make lossless readers lossy that stall a full ring this long (default: 2000, 0 never)\n";
     std::cout << "  --enable-logging           Enable performance logging\n";
     std::cout << "  --log-interval <ms>        Log interval in ms (default: 5000)\n";
+    std::cout << "  --log-level <level>        Lowest level logged: debug, info, warning, error (default: info)\n";
     std::cout << "  --diagnostics-file <path>  Path to write diagnostics (default: none)\n";
+    std::cout << "  --trace                    Record per-frame trace points; SIGUSR1 dumps them\n";
+    std::cout << "  --trace-file <path>        Chrome/Perfetto trace output (default: /tmp/imaging_trace.json)\n";
+    std::cout << "  --trace-window <ms>        History a trace dump covers (default: 5000)\n";
+    std::cout << "  --trace-on-drop            Dump a trace automatically when a frame is dropped\n";
+    std::cout << "  --metrics-port <port>      Prometheus /metrics port, 0 to disable (default: 9464)\n";
+    std::cout << "  --metrics-address <addr>   Address the metrics endpoint binds to (default: 0.0.0.0)\n";
+    std::cout << "  --control-socket <path>    Ring attach and live settings socket, \"\" to disable (default: /tmp/imaging_control.sock)\n";
+    std::cout << "  --clip-dir <dir>           Directory clips saved through the control socket go to, \"\" to refuse them (default: /tmp/imaging_clips)\n";
+    std::cout << "  --grpc-port <port>         Serve StreamFrames, GetFrame and GetStatistics over gRPC (default: off)\n";
+    std::cout << "  --grpc-address <addr>      Address the gRPC server binds to (default: 0.0.0.0)\n";
+    std::cout << "  --grpc-queue-depth <n>     Frames a gRPC stream queues before dropping the oldest (default: 1)\n";
+    std::cout << "  --record <path>            Record raw frames to a file with io_uring and O_DIRECT\n";
+    std::cout << "  --record-queue-depth <n>   Maximum recording writes in flight (default: 8)\n";
+    std::cout << "  --net-publish <group:port> Send the raw ring to other nodes over UDP multicast\n";
+    std::cout << "  --net-rate-mbps <n>        Pace the multicast stream to this rate (default: unpaced)\n";
+    std::cout << "  --net-ttl <n>              Multicast hops (default: 1)\n";
+    std::cout << "  --net-interface <addr>     Local address of the interface to send or join on\n";
+    std::cout << "  --net-datagram <bytes>     UDP payload per datagram, 8972 for jumbo frames (default: 1472)\n";
+    std::cout << "  --net-receive <group:port> Run as a receiving node: rebuild the ring from a multicast stream\n";
     std::cout << "  --nice-value <value>       Process nice value (-20 to 19, default: -10)\n";
+    std::cout << "  --thread-layout <spec>     Cores, class and priority per thread, e.g.\n";
+    std::cout << "                             \"capture=2:fifo:80;publish=3:fifo:70;monitor=0:other\" (or a file)\n";
     std::cout << "  --help                     Show this help message\n";
 }
 
@@ -89,6 +206,11 @@ void printStatistics(const std::map<std::string, std::string>& stats) {
                   << stats.at("average_latency_ms") << "│\n";
     }
 
+    if (stats.count("p99_latency_ms")) {
+        std::cout << "│ p99 latency (ms): " << std::setw(40) << std::left
+                  << stats.at("p99_latency_ms") << "│\n";
+    }
+
     if (stats.count("max_latency_ms")) {
         std::cout << "│ Max latency (ms): " << std::setw(40) << std::left
                   << stats.at("max_latency_ms") << "│\n";
@@ -104,6 +226,16 @@ void printStatistics(const std::map<std::string, std::string>& stats) {
                   << stats.at("memory_usage_mb") << "│\n";
     }
 
+    if (stats.count("memory_locked_mb")) {
+        std::cout << "│ Locked memory (MB): " << std::setw(38) << std::left
+                  << stats.at("memory_locked_mb") << "│\n";
+    }
+
+    if (stats.count("startup_first_frame_ms")) {
+        std::cout << "│ Time to first frame (ms): " << std::setw(33) << std::left
+                  << stats.at("startup_first_frame_ms") << "│\n";
+    }
+
     // Shared memory stats
     if (stats.count("shm_frames_written")) {
         std::cout << "├─────────────────────────────────────────────────────────┤\n";
@@ -132,6 +264,38 @@ void printStatistics(const std::map<std::string, std::string>& stats) {
                   << stats.at("shm_is_buffer_full") << "│\n";
     }
 
+    // Where every thread ended up: its placement, scheduling policy, last CPU and load
+    bool threadHeader = false;
+    const std::string placementSuffix = "_placement";
+    for (const auto &[key, value]: stats) {
+        if (key.compare(0, 7, "thread_") != 0 || key.size() <= placementSuffix.size() ||
+            key.compare(key.size() - placementSuffix.size(), placementSuffix.size(), placementSuffix) != 0) {
+            continue;
+        }
+        if (!threadHeader) {
+            std::cout << "├─────────────────────────────────────────────────────────┤\n";
+            std::cout << "│ Threads                                                 │\n";
+            std::cout << "├─────────────────────────────────────────────────────────┤\n";
+            threadHeader = true;
+        }
+
+        std::string prefix = key.substr(0, key.size() - placementSuffix.size() + 1);
+        auto field = [&stats, &prefix](const std::string &name) {
+            auto it = stats.find(prefix + name);
+            return it != stats.end() ? it->second : std::string("?");
+        };
+        std::string cpuPercent = field("cpu_percent");
+        cpuPercent = cpuPercent.substr(0, cpuPercent.find('.') + 2);
+        std::string line = " " + prefix.substr(7, prefix.size() - 8) + ": " + field("policy") + " cpu " +
+                           field("cpu") + " " + cpuPercent + "% " +
+                           (stats.count(prefix + "placement_error") ? "FAILED " : "") + value;
+        if (line.length() > 57) {
+            line = line.substr(0, 54) + "...";
+        }
+        line.resize(57, ' ');
+        std::cout << "│" << line << "│\n";
+    }
+
     std::cout << "└─────────────────────────────────────────────────────────┘\n";
 }
 
@@ -200,15 +364,44 @@ int main(int argc, char *argv[]) {
     // Register signal handler
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
+    std::signal(SIGUSR1, traceSignalHandler);
 
     printBanner();
 
     // Default nice value
     int niceValue = -10;
 
+    // Benchmark the shared memory backends at startup and use the fastest
+    bool autoSharedMemoryType = false;
+
     // Diagnostics file path
     std::string diagnosticsFile;
 
+    // Synthetic or replay source instead of a capture card
+    bool useSyntheticDevice = false;
+    int syntheticCount = 1;
+    bool useAllDevices = false;
+    medical::imaging::SyntheticDevice::Options syntheticOptions;
+
+    // Prometheus scrape endpoint
+    medical::imaging::MetricsServer::Config metricsConfig;
+
+    // Local control socket
+    medical::imaging::ControlServer::Config controlConfig;
+
+    // Remote clients over gRPC, off unless a port is given
+    medical::imaging::GrpcServer::Config grpcConfig;
+    grpcConfig.port = 0;
+
+    // Raw frame recording
+    medical::imaging::FrameRecorder::Config recorderConfig;
+
+    // Multi-node distribution: publish the raw ring, or receive one instead of capturing
+    medical::imaging::NetworkPublisher::Config publisherConfig;
+    medical::imaging::NetworkReceiver::Config receiverConfig;
+    bool netPublish = false;
+    bool netReceive = false;
+
     // Create the imaging service
     medical::imaging::ImagingService service;
 
@@ -221,6 +414,16 @@ int main(int argc, char *argv[]) {
 
         if (arg == "--device" && i + 1 < argc) {
             config.deviceId = argv[++i];
+        } else if (arg == "--devices" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string id;
+            while (std::getline(list, id, ',')) {
+                if (!id.empty()) {
+                    config.deviceIds.push_back(id);
+                }
+            }
+        } else if (arg == "--all-devices") {
+            useAllDevices = true;
         } else if (arg == "--width" && i + 1 < argc) {
             config.deviceConfig.width = std::stoi(argv[++i]);
         } else if (arg == "--height" && i + 1 < argc) {
@@ -229,12 +432,32 @@ int main(int argc, char *argv[]) {
             config.deviceConfig.frameRate = std::stod(argv[++i]);
         } else if (arg == "--pixel-format" && i + 1 < argc) {
             config.deviceConfig.pixelFormat = argv[++i];
+        } else if (arg == "--synthetic") {
+            useSyntheticDevice = true;
+        } else if (arg == "--synthetic-count" && i + 1 < argc) {
+            useSyntheticDevice = true;
+            syntheticCount = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--replay" && i + 1 < argc) {
+            useSyntheticDevice = true;
+            syntheticOptions.source = medical::imaging::SyntheticDevice::Source::REPLAY;
+            syntheticOptions.replayPath = argv[++i];
+            syntheticOptions.deviceId = "replay-0";
+        } else if (arg == "--replay-once") {
+            syntheticOptions.loop = false;
+        } else if (arg == "--max-rate") {
+            syntheticOptions.pacing = medical::imaging::SyntheticDevice::Pacing::AS_FAST_AS_POSSIBLE;
+        } else if (arg == "--jitter-us" && i + 1 < argc) {
+            syntheticOptions.jitterUs = std::stod(argv[++i]);
+        } else if (arg == "--burst" && i + 1 < argc) {
+            syntheticOptions.burstSize = std::stoi(argv[++i]);
         } else if (arg == "--no-direct-memory") {
             config.enableDirectMemoryAccess = false;
         } else if (arg == "--no-realtime") {
             config.useRealtimePriority = false;
         } else if (arg == "--thread-affinity" && i + 1 < argc) {
             config.threadAffinity = std::stoi(argv[++i]);
+        } else if (arg == "--numa-node" && i + 1 < argc) {
+            config.numaNode = std::stoi(argv[++i]);
         } else if (arg == "--no-pin-memory") {
             config.pinMemory = false;
         } else if (arg == "--no-shared-memory") {
@@ -243,27 +466,203 @@ int main(int argc, char *argv[]) {
             config.sharedMemoryName = argv[++i];
         } else if (arg == "--shared-memory-size" && i + 1 < argc) {
             config.sharedMemorySize = std::stoull(argv[++i]);
+        } else if (arg == "--shared-memory-type" && i + 1 < argc && std::string(argv[i + 1]) == "auto") {
+            autoSharedMemoryType = true;
+            ++i;
         } else if (arg == "--shared-memory-type" && i + 1 < argc) {
+            autoSharedMemoryType = false;
             int type = std::stoi(argv[++i]);
             switch (type) {
                 case 0: config.sharedMemoryType = medical::imaging::SharedMemoryType::POSIX_SHM; break;
                 case 1: config.sharedMemoryType = medical::imaging::SharedMemoryType::SYSV_SHM; break;
                 case 2: config.sharedMemoryType = medical::imaging::SharedMemoryType::MEMORY_MAPPED_FILE; break;
                 case 3: config.sharedMemoryType = medical::imaging::SharedMemoryType::HUGE_PAGES; break;
+                case 4: config.sharedMemoryType = medical::imaging::SharedMemoryType::MEMFD; break;
                 default:
                     std::cerr << "Invalid shared memory type: " << type << std::endl;
                     return 1;
             }
+        } else if (arg == "--huge-pages") {
+            config.useHugePages = true;
+        } else if (arg == "--huge-page-size" && i + 1 < argc) {
+            config.useHugePages = true;
+            config.hugePageSize = std::stoull(argv[++i]) * 1024 * 1024;
+        } else if (arg == "--payload-alignment" && i + 1 < argc) {
+            config.payloadAlignment = std::stoull(argv[++i]);
+        } else if (arg == "--row-alignment" && i + 1 < argc) {
+            config.rowAlignment = std::stoull(argv[++i]);
+        } else if (arg == "--persistent-ring") {
+            config.persistentSharedMemory = true;
+        } else if (arg == "--copy-kernel" && i + 1 < argc) {
+            if (!medical::imaging::FrameCopier::parseMode(argv[++i], config.copyMode)) {
+                std::cerr << "Invalid copy kernel: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--copy-threads" && i + 1 < argc) {
+            config.copyThreads = std::stoul(argv[++i]);
+        } else if (arg == "--publish-bands" && i + 1 < argc) {
+            config.publishBandRows = std::stoul(argv[++i]);
+        } else if (arg == "--image-stats") {
+            config.imageStatistics = true;
+        } else if (arg == "--duplicates" && i + 1 < argc) {
+            if (!medical::imaging::FrameFingerprint::parsePolicy(argv[++i], config.duplicatePolicy)) {
+                std::cerr << "Invalid duplicate policy: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--keepalive-fps" && i + 1 < argc) {
+            config.duplicateKeepAliveRate = std::stod(argv[++i]);
+        } else if (arg == "--fingerprint-samples" && i + 1 < argc) {
+            config.fingerprintSamples = std::stoul(argv[++i]);
+        } else if (arg == "--convert" && i + 1 < argc) {
+            config.conversionFormat = argv[++i];
+        } else if (arg == "--converted-name" && i + 1 < argc) {
+            config.convertedSharedMemoryName = argv[++i];
+        } else if (arg == "--roi" && i + 1 < argc) {
+            auto &roi = config.regionOfInterest;
+            if (std::sscanf(argv[++i], "%d,%d,%d,%d", &roi.x, &roi.y, &roi.width, &roi.height) != 4) {
+                std::cerr << "Invalid region of interest, expected x,y,width,height: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--preview-scale" && i + 1 < argc) {
+            config.previewScale = std::stoi(argv[++i]);
+        } else if (arg == "--preview-fps" && i + 1 < argc) {
+            config.previewFrameRate = std::stod(argv[++i]);
+        } else if (arg == "--preview-name" && i + 1 < argc) {
+            config.previewSharedMemoryName = argv[++i];
+        } else if (arg == "--compress" && i + 1 < argc) {
+            config.compressionCodec = argv[++i];
+        } else if (arg == "--compress-no-delta") {
+            config.compressionDelta = false;
+        } else if (arg == "--compress-key-interval" && i + 1 < argc) {
+            config.compressionKeyFrameInterval = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--compress-core" && i + 1 < argc) {
+            config.compressionThreadAffinity = std::stoi(argv[++i]);
+        } else if (arg == "--compressed-name" && i + 1 < argc) {
+            config.compressedSharedMemoryName = argv[++i];
+        } else if (arg == "--gpu-upload") {
+            config.enableGpuUpload = true;
+        } else if (arg == "--gpu-device" && i + 1 < argc) {
+            config.gpuDevice = std::stoi(argv[++i]);
+        } else if (arg == "--gpu-buffers" && i + 1 < argc) {
+            config.gpuBufferCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--gpu-no-pin") {
+            config.gpuPinSharedMemory = false;
+        } else if (arg == "--gpu-core" && i + 1 < argc) {
+            config.gpuThreadAffinity = std::stoi(argv[++i]);
+        } else if (arg == "--gpu-name" && i + 1 < argc) {
+            config.gpuSharedMemoryName = argv[++i];
+        } else if (arg == "--dmabuf-export") {
+            config.enableDmaBufExport = true;
+        } else if (arg == "--dmabuf-slots" && i + 1 < argc) {
+            config.dmaBufSlotCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--dmabuf-pitch" && i + 1 < argc) {
+            config.dmaBufPitchAlignment = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--dmabuf-socket-dir" && i + 1 < argc) {
+            config.dmaBufSocketDirectory = argv[++i];
+        } else if (arg == "--dmabuf-core" && i + 1 < argc) {
+            config.dmaBufThreadAffinity = std::stoi(argv[++i]);
+        } else if (arg == "--dmabuf-name" && i + 1 < argc) {
+            config.dmaBufSharedMemoryName = argv[++i];
+        } else if (arg == "--no-format-cache") {
+            config.enableFormatCache = false;
+        } else if (arg == "--format-idle-ms" && i + 1 < argc) {
+            config.formatCacheIdleMs = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--format-core" && i + 1 < argc) {
+            config.formatCacheThreadAffinity = std::stoi(argv[++i]);
+        } else if (arg == "--pose-ring" && i + 1 < argc) {
+            config.poseRingName = argv[++i];
+        } else if (arg == "--no-idle") {
+            config.idleWhenUnread = false;
+            config.idleWithoutSignal = false;
+        } else if (arg == "--idle-fps" && i + 1 < argc) {
+            config.idleKeepAliveRate = std::stod(argv[++i]);
+        } else if (arg == "--publish-inline") {
+            config.usePublishThread = false;
+        } else if (arg == "--publish-queue" && i + 1 < argc) {
+            config.publishQueueDepth = std::stoul(argv[++i]);
+        } else if (arg == "--publish-core" && i + 1 < argc) {
+            config.publishThreadAffinity = std::stoi(argv[++i]);
         } else if (arg == "--buffer-size" && i + 1 < argc) {
             config.frameBufferSize = std::stoi(argv[++i]);
+        } else if (arg == "--fixed-ring") {
+            config.adaptiveRingSize = false;
+        } else if (arg == "--ring-min-frames" && i + 1 < argc) {
+            config.ringMinFrames = std::stoi(argv[++i]);
+        } else if (arg == "--ring-shrink-delay" && i + 1 < argc) {
+            config.ringShrinkDelayMs = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--write-policy" && i + 1 < argc) {
+            if (!medical::imaging::SharedMemory::parseWritePolicy(argv[++i], config.writePolicy)) {
+                std::cerr << "Invalid write policy: " << argv[i] << std::endl;
+                return 1;
+            }
         } else if (arg == "--no-drop-frames") {
-            config.dropFramesWhenFull = false;
+            config.writePolicy = medical::imaging::WritePolicy::BLOCK;
+        } else if (arg == "--demote-lag" && i + 1 < argc) {
+            config.demoteLagFrames = std::stoull(argv[++i]);
+        } else if (arg == "--demote-stale-ms" && i + 1 < argc) {
+            config.demoteStaleMs = std::stoul(argv[++i]);
         } else if (arg == "--enable-logging") {
             config.logPerformanceStats = true;
         } else if (arg == "--log-interval" && i + 1 < argc) {
             config.performanceLogIntervalMs = std::stoi(argv[++i]);
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            medical::imaging::LogLevel level;
+            if (!medical::imaging::Log::parseLevel(argv[++i], level)) {
+                std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                return 1;
+            }
+            medical::imaging::Log::setLevel(level);
         } else if (arg == "--diagnostics-file" && i + 1 < argc) {
             diagnosticsFile = argv[++i];
+        } else if (arg == "--trace") {
+            config.enableTracing = true;
+        } else if (arg == "--trace-file" && i + 1 < argc) {
+            config.traceFile = argv[++i];
+        } else if (arg == "--trace-window" && i + 1 < argc) {
+            config.traceWindowMs = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--trace-on-drop") {
+            config.enableTracing = true;
+            config.traceOnDrop = true;
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            metricsConfig.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--metrics-address" && i + 1 < argc) {
+            metricsConfig.bindAddress = argv[++i];
+        } else if (arg == "--control-socket" && i + 1 < argc) {
+            controlConfig.socketPath = argv[++i];
+        } else if (arg == "--clip-dir" && i + 1 < argc) {
+            controlConfig.clipDirectory = argv[++i];
+        } else if (arg == "--grpc-port" && i + 1 < argc) {
+            grpcConfig.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--grpc-address" && i + 1 < argc) {
+            grpcConfig.bindAddress = argv[++i];
+        } else if (arg == "--grpc-queue-depth" && i + 1 < argc) {
+            grpcConfig.maxQueuedFrames = std::stoul(argv[++i]);
+        } else if (arg == "--record" && i + 1 < argc) {
+            recorderConfig.outputPath = argv[++i];
+        } else if (arg == "--record-queue-depth" && i + 1 < argc) {
+            recorderConfig.queueDepth = std::stoul(argv[++i]);
+        } else if ((arg == "--net-publish" || arg == "--net-receive") && i + 1 < argc) {
+            bool publish = arg == "--net-publish";
+            std::string endpoint = argv[++i];
+            bool valid = publish ? parseEndpoint(endpoint, publisherConfig.address, publisherConfig.port)
+                                 : parseEndpoint(endpoint, receiverConfig.address, receiverConfig.port);
+            if (!valid) {
+                std::cerr << "Invalid endpoint for " << arg << ": " << endpoint << std::endl;
+                return 1;
+            }
+            (publish ? netPublish : netReceive) = true;
+        } else if (arg == "--net-rate-mbps" && i + 1 < argc) {
+            publisherConfig.rateMbps = std::stod(argv[++i]);
+        } else if (arg == "--net-ttl" && i + 1 < argc) {
+            publisherConfig.ttl = std::stoi(argv[++i]);
+        } else if (arg == "--net-interface" && i + 1 < argc) {
+            publisherConfig.interfaceAddress = argv[++i];
+            receiverConfig.interfaceAddress = publisherConfig.interfaceAddress;
+        } else if (arg == "--net-datagram" && i + 1 < argc) {
+            publisherConfig.datagramSize = std::stoul(argv[++i]);
+            receiverConfig.maxDatagramSize = std::max(receiverConfig.maxDatagramSize, publisherConfig.datagramSize);
+        } else if (arg == "--thread-layout" && i + 1 < argc) {
+            config.threadLayout = argv[++i];
         } else if (arg == "--nice-value" && i + 1 < argc) {
             niceValue = std::stoi(argv[++i]);
             // Clamp to valid range
@@ -282,14 +681,118 @@ int main(int argc, char *argv[]) {
     config.sharedMemorySize = 512 * 1024 * 1024; // 512 MB instead of 128 MB
     //config.maxFrameSize = 17 * 1024 * 1024; // 17MB per frame
 
+    // A receiving node has no capture device: it only rebuilds the ring a capture node publishes
+    if (netReceive) {
+        medical::imaging::SharedMemory::Config ringConfig;
+        ringConfig.name = config.sharedMemoryName;
+        ringConfig.type = config.sharedMemoryType;
+        ringConfig.size = config.sharedMemorySize;
+        ringConfig.filePath = "/dev/shm/" + config.sharedMemoryName;
+        ringConfig.useHugePages = config.useHugePages;
+        ringConfig.numaNode = config.numaNode;
+
+        medical::imaging::NetworkReceiver receiver(receiverConfig);
+        if (receiver.start(ringConfig) != medical::imaging::NetworkReceiver::Status::OK) {
+            std::cerr << "Failed to receive frames from " << receiverConfig.address << ":" << receiverConfig.port
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "Receiving frames from " << receiverConfig.address << ":" << receiverConfig.port
+                  << " into shared memory: " << config.sharedMemoryName << std::endl;
+        std::cout << "Press Ctrl+C to stop." << std::endl;
+        while (g_running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        auto receiverStats = receiver.getStatisticsMap();
+        receiver.stop();
+        std::cout << "Network receiver statistics:" << std::endl;
+        for (const auto &[key, value]: receiverStats) {
+            std::cout << "  " << key << ": " << value << std::endl;
+        }
+        return 0;
+    }
+
     // Set process priority
     if (!setProcessPriority(niceValue)) {
         std::cerr << "Failed to set nice value: " << niceValue << std::endl;
     }
 
+    // Discover the capture cards while the shared memory backends are benchmarked; threads started
+    // from here on inherit the priority set above
+    auto discoveryBegin = std::chrono::steady_clock::now();
+    auto discoveryEnd = discoveryBegin;
+    std::thread discoveryThread([&discoveryEnd]() {
+        medical::imaging::DeviceManager::getInstance();
+        discoveryEnd = std::chrono::steady_clock::now();
+    });
+
+    // Rank the backends on this machine with the page and NUMA settings the rings will get
+    if (autoSharedMemoryType) {
+        auto benchmarkBegin = std::chrono::steady_clock::now();
+        medical::imaging::SharedMemory::Config probeConfig;
+        probeConfig.name = config.sharedMemoryName;
+        probeConfig.useHugePages = config.useHugePages;
+        probeConfig.hugePageSize = config.hugePageSize;
+        probeConfig.payloadAlignment = config.payloadAlignment;
+        probeConfig.numaNode = config.numaNode;
+        probeConfig.copyMode = config.copyMode;
+
+        // SysV and memfd rings cannot be opened by path; memfd still serves consumers of the control socket
+        std::vector<medical::imaging::SharedMemoryType> candidates = {
+            medical::imaging::SharedMemoryType::MEMORY_MAPPED_FILE,
+            medical::imaging::SharedMemoryType::POSIX_SHM,
+        };
+        if (config.useHugePages) {
+            candidates.push_back(medical::imaging::SharedMemoryType::HUGE_PAGES);
+        }
+        if (!controlConfig.socketPath.empty()) {
+            candidates.push_back(medical::imaging::SharedMemoryType::MEMFD);
+        }
+
+        std::cout << "Benchmarking shared memory backends..." << std::endl;
+        std::vector<medical::imaging::SharedMemory::BackendBenchmark> results;
+        config.sharedMemoryType = medical::imaging::SharedMemory::selectFastestType(probeConfig, candidates, &results);
+        for (const auto &result: results) {
+            std::cout << "  " << std::left << std::setw(6) << medical::imaging::SharedMemory::toString(result.type);
+            if (result.available) {
+                std::cout << std::fixed << std::setprecision(1) << " write " << std::setw(8) << result.writeNs / 1000.0 << " us  read "
+                          << std::setw(8) << result.readNs / 1000.0 << " us  (" << result.pageBacking << " pages)";
+            } else {
+                std::cout << " unavailable";
+            }
+            std::cout << std::endl;
+        }
+        std::cout << "Using " << medical::imaging::SharedMemory::toString(config.sharedMemoryType)
+                  << " shared memory" << std::endl;
+        service.recordStartupStage("backend_benchmark", benchmarkBegin, std::chrono::steady_clock::now());
+    }
+
+    discoveryThread.join();
+    service.recordStartupStage("device_discovery", discoveryBegin, discoveryEnd);
+
     // List available devices
     auto &deviceManager = medical::imaging::DeviceManager::getInstance();
+    if (useSyntheticDevice) {
+        std::string idPrefix = syntheticOptions.source == medical::imaging::SyntheticDevice::Source::REPLAY
+                                   ? "replay-"
+                                   : "synthetic-";
+        for (int i = 0; i < syntheticCount; ++i) {
+            medical::imaging::SyntheticDevice::Options options = syntheticOptions;
+            options.deviceId = idPrefix + std::to_string(i);
+            options.seed += static_cast<uint32_t>(i);
+            auto syntheticDevice = std::make_shared<medical::imaging::SyntheticDevice>(options);
+            deviceManager.addTestDevice(syntheticDevice);
+            if (syntheticCount > 1) {
+                config.deviceIds.push_back(syntheticDevice->getDeviceId());
+            } else {
+                config.deviceId = syntheticDevice->getDeviceId();
+            }
+        }
+    }
     auto deviceIds = deviceManager.getAvailableDeviceIds();
+    if (useAllDevices) {
+        config.deviceIds = deviceIds;
+    }
 
     printDevices(deviceIds, deviceManager);
 
@@ -304,6 +807,7 @@ int main(int argc, char *argv[]) {
     auto status = service.initialize(config);
 
     if (status != medical::imaging::ImagingService::Status::OK) {
+        medical::imaging::Log::flush();
         std::cerr << "Failed to initialize imaging service (error code: " << static_cast<int>(status) << ")" << std::endl;
         return 1;
     }
@@ -313,13 +817,88 @@ int main(int argc, char *argv[]) {
     status = service.start();
 
     if (status != medical::imaging::ImagingService::Status::OK) {
+        medical::imaging::Log::flush();
         std::cerr << "Failed to start imaging service (error code: " << static_cast<int>(status) << ")" << std::endl;
         return 1;
     }
 
+    // Serve metrics from a normal-priority thread; failing to bind is not fatal
+    medical::imaging::MetricsServer metricsServer(metricsConfig);
+    if (metricsConfig.port != 0) {
+        if (metricsServer.start([&service]() { return service.exportMetrics(); }) ==
+            medical::imaging::MetricsServer::Status::OK) {
+            std::cout << "Metrics available at http://" << metricsConfig.bindAddress << ":"
+                    << metricsConfig.port << "/metrics" << std::endl;
+        } else {
+            std::cerr << "Failed to start metrics endpoint on port " << metricsConfig.port << std::endl;
+        }
+    }
+
+    // Hand out ring descriptors and take live settings; failing to bind is not fatal either
+    medical::imaging::ControlServer controlServer(controlConfig);
+    if (!controlConfig.socketPath.empty()) {
+        if (controlServer.start(service) == medical::imaging::ControlServer::Status::OK) {
+            std::cout << "Control socket listening on " << controlConfig.socketPath << std::endl;
+        } else {
+            std::cerr << "Failed to start control socket on " << controlConfig.socketPath << std::endl;
+        }
+    }
+
+    // Serve remote clients from the rings, as lossy readers like any other consumer
+#if defined(MIVI_HAVE_GRPC)
+    medical::imaging::GrpcServer grpcServer(grpcConfig);
+    if (grpcConfig.port != 0) {
+        if (grpcServer.start(service) == medical::imaging::GrpcServer::Status::OK) {
+            std::cout << "gRPC server listening on " << grpcConfig.bindAddress << ":" << grpcConfig.port << std::endl;
+        } else {
+            std::cerr << "Failed to start gRPC server on port " << grpcConfig.port << std::endl;
+        }
+    }
+#else
+    if (grpcConfig.port != 0) {
+        std::cerr << "This build has no gRPC support, ignoring --grpc-port" << std::endl;
+    }
+#endif
+
+    // Record from the raw ring as an ordinary lossy consumer
+    medical::imaging::FrameRecorder recorder(recorderConfig);
+    if (!recorderConfig.outputPath.empty()) {
+        medical::imaging::SharedMemory::Config ringConfig;
+        ringConfig.name = config.sharedMemoryName;
+        ringConfig.type = config.sharedMemoryType;
+        if (auto ring = service.findSharedMemory(config.sharedMemoryName)) {
+            ringConfig = ring->getAttachConfig();
+        }
+        if (recorder.start(ringConfig) == medical::imaging::FrameRecorder::Status::OK) {
+            std::cout << "Recording frames to " << recorderConfig.outputPath << std::endl;
+        } else {
+            std::cerr << "Failed to start recording to " << recorderConfig.outputPath << std::endl;
+        }
+    }
+
+    // Send the raw ring to other nodes, again as a lossy consumer
+    medical::imaging::NetworkPublisher publisher(publisherConfig);
+    if (netPublish) {
+        medical::imaging::SharedMemory::Config ringConfig;
+        ringConfig.name = config.sharedMemoryName;
+        ringConfig.type = config.sharedMemoryType;
+        if (auto ring = service.findSharedMemory(config.sharedMemoryName)) {
+            ringConfig = ring->getAttachConfig();
+        }
+        if (publisher.start(ringConfig) == medical::imaging::NetworkPublisher::Status::OK) {
+            std::cout << "Publishing frames to " << publisherConfig.address << ":" << publisherConfig.port << std::endl;
+        } else {
+            std::cerr << "Failed to publish frames to " << publisherConfig.address << ":" << publisherConfig.port
+                      << std::endl;
+        }
+    }
+
     std::cout << "Service running. Press Ctrl+C to stop." << std::endl;
     std::cout << std::endl;
-    std::cout << "Frames are being written to shared memory: " << config.sharedMemoryName << std::endl;
+    for (size_t channel = 0; channel < service.getChannelCount(); ++channel) {
+        std::cout << "Frames from " << service.getDevice(channel)->getDeviceId() << " are being written to shared memory: "
+                << medical::imaging::ImagingService::getChannelRingName(config.sharedMemoryName, channel) << std::endl;
+    }
     std::cout << "Other services can now connect to this shared memory to process frames." << std::endl;
     std::cout << std::endl;
 
@@ -345,11 +924,52 @@ int main(int argc, char *argv[]) {
         if (!diagnosticsFile.empty()) {
             writeDiagnostics(diagnosticsFile, service);
         }
+
+        // Dump the recent trace points on request
+        if (g_dumpTrace.exchange(false)) {
+            if (service.dumpTrace(config.traceFile)) {
+                std::cout << "Trace written to " << config.traceFile << std::endl;
+            } else {
+                std::cerr << "Tracing is disabled; start with --trace to record trace points" << std::endl;
+            }
+        }
+    }
+
+    // Stop serving metrics and remote clients before the service goes away
+    metricsServer.stop();
+    controlServer.stop();
+#if defined(MIVI_HAVE_GRPC)
+    if (grpcServer.isRunning()) {
+        grpcServer.stop();
+        std::cout << "gRPC statistics:" << std::endl;
+        for (const auto &[key, value]: grpcServer.getStatisticsMap()) {
+            std::cout << "  " << key << ": " << value << std::endl;
+        }
+    }
+#endif
+
+    // Finish recording while the ring is still mapped by the producer
+    if (recorder.isRunning()) {
+        recorder.stop();
+        std::cout << "Recording statistics:" << std::endl;
+        for (const auto &[key, value]: recorder.getStatisticsMap()) {
+            std::cout << "  " << key << ": " << value << std::endl;
+        }
+    }
+
+    if (publisher.isRunning()) {
+        auto publisherStats = publisher.getStatisticsMap();
+        publisher.stop();
+        std::cout << "Network publisher statistics:" << std::endl;
+        for (const auto &[key, value]: publisherStats) {
+            std::cout << "  " << key << ": " << value << std::endl;
+        }
     }
 
     // Stop the service
     std::cout << "Stopping imaging service..." << std::endl;
     status = service.stop();
+    medical::imaging::Log::flush();
 
     if (status != medical::imaging::ImagingService::Status::OK) {
         std::cerr << "Failed to stop imaging service (error code: " << static_cast<int>(status) << ")" << std::endl;
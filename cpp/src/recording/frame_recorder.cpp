@@ -0,0 +1,505 @@
+#include "recording/frame_recorder.h"
+#include "utils/io_uring.h"
+#include "utils/log.h"
+#include "utils/thread_layout.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+namespace medical::imaging {
+    // How long the recorder sleeps waiting for the next frame before re-checking for stop
+    constexpr unsigned int FRAME_WAIT_MS = 10;
+
+    struct FrameRecorder::Impl {
+        // One queued record; the frame is kept alive while the kernel reads from the ring
+        struct Request {
+            std::shared_ptr<Frame> frame; // Set when writing straight from the ring
+            void *recordHeader = nullptr; // Aligned FrameHeader and metadata block
+            void *bounce = nullptr;       // Aligned copy buffer, reused across requests
+            size_t bounceSize = 0;
+            iovec iov[2] = {};            // Record header block, then the payload
+            size_t length = 0;            // Bytes submitted
+            size_t indexPosition = 0;     // Entry of this record in the index
+            uint64_t submitNs = 0;
+        };
+
+        std::shared_ptr<SharedMemory> reader; // Ring being recorded, null for a clip
+        std::vector<std::shared_ptr<Frame>> clip; // Frames of a clip, each dropped once its write is queued
+        std::atomic<size_t> clipNext{0}; // Next frame of the clip to write
+        IoUring ring;
+        bool useRing = false;
+        bool directIo = false;
+        int fd = -1;
+        uint64_t fileOffset = 0;
+        std::vector<Request> requests;
+        std::vector<size_t> freeRequests;
+
+        // Index entries in file order; failed records are dropped when the index is written
+        std::vector<RecordingIndexEntry> index;
+        std::vector<bool> indexValid;
+        RecordingFileHeader fileHeader{};
+
+        ~Impl() {
+            for (Request &request: requests) {
+                std::free(request.recordHeader);
+                std::free(request.bounce);
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+
+        static uint64_t nowNs() {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        // Write an aligned block synchronously, as O_DIRECT requires
+        bool writeBlock(const void *data, size_t size, uint64_t offset) const {
+            size_t alignedSize = static_cast<size_t>(recordingAlign(size));
+            void *block = std::aligned_alloc(RECORDING_ALIGNMENT, alignedSize);
+            if (!block) {
+                return false;
+            }
+            std::memcpy(block, data, size);
+            std::memset(static_cast<uint8_t *>(block) + size, 0, alignedSize - size);
+            bool ok = pwrite(fd, block, alignedSize, static_cast<off_t>(offset)) ==
+                      static_cast<ssize_t>(alignedSize);
+            std::free(block);
+            return ok;
+        }
+    };
+
+    FrameRecorder::FrameRecorder(const Config &config)
+        : config_(config),
+          isRunning_(false),
+          stopRequested_(false),
+          finished_(false),
+          framesRecorded_(0),
+          bytesWritten_(0),
+          framesCopied_(0),
+          framesTorn_(0),
+          writeErrors_(0),
+          inFlight_(0) {
+        if (config_.queueDepth == 0) {
+            config_.queueDepth = 1;
+        }
+    }
+
+    FrameRecorder::~FrameRecorder() {
+        stop();
+    }
+
+    FrameRecorder::Status FrameRecorder::start(const SharedMemory::Config &ringConfig) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (config_.outputPath.empty()) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        auto impl = std::make_unique<Impl>();
+        Status status = openOutput(*impl);
+        if (status != Status::OK) {
+            return status;
+        }
+
+        // Attach as a lossy reader: the disk must never hold back capture
+        SharedMemory::Config readerConfig = ringConfig;
+        readerConfig.create = false;
+        readerConfig.readerMode = ReaderMode::LOSSY;
+        readerConfig.lockInMemory = false;
+        impl->reader = std::make_shared<SharedMemory>(readerConfig);
+        if (impl->reader->initialize() != SharedMemory::Status::OK) {
+            MIVI_LOG_ERROR("Recorder failed to attach to shared memory {}", ringConfig.name);
+            return Status::CONNECTION_FAILED;
+        }
+
+        status = prepareOutput(*impl, ringConfig.name);
+        if (status != Status::OK) {
+            return status;
+        }
+        launch(std::move(impl));
+        return Status::OK;
+    }
+
+    FrameRecorder::Status FrameRecorder::startClip(std::vector<std::shared_ptr<Frame>> frames,
+                                                   const std::string &ringName) {
+        if (isRunning_) {
+            return Status::ALREADY_RUNNING;
+        }
+        if (config_.outputPath.empty() || frames.empty()) {
+            return Status::INVALID_ARGUMENT;
+        }
+
+        auto impl = std::make_unique<Impl>();
+        Status status = openOutput(*impl);
+        if (status == Status::OK) {
+            status = prepareOutput(*impl, ringName);
+        }
+        if (status != Status::OK) {
+            return status;
+        }
+        impl->clip = std::move(frames);
+        launch(std::move(impl));
+        return Status::OK;
+    }
+
+    FrameRecorder::Status FrameRecorder::openOutput(Impl &impl) const {
+        // Open the output, bypassing the page cache where the filesystem allows it
+        int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        if (config_.useDirectIo) {
+            impl.fd = open(config_.outputPath.c_str(), flags | O_DIRECT, 0644);
+            impl.directIo = impl.fd >= 0;
+            if (impl.fd < 0 && errno == EINVAL) {
+                MIVI_LOG_WARNING("O_DIRECT not supported for {}, recording through the page cache", config_.outputPath);
+            }
+        }
+        if (impl.fd < 0) {
+            impl.fd = open(config_.outputPath.c_str(), flags, 0644);
+        }
+        if (impl.fd < 0) {
+            MIVI_LOG_ERROR("Failed to open recording {}: {}", config_.outputPath, strerror(errno));
+            return Status::IO_ERROR;
+        }
+        return Status::OK;
+    }
+
+    FrameRecorder::Status FrameRecorder::prepareOutput(Impl &impl, const std::string &ringName) const {
+        // The header is rewritten with the index location when recording stops
+        RecordingFileHeader &fileHeader = impl.fileHeader;
+        std::memcpy(fileHeader.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+        fileHeader.version = RECORDING_FORMAT_VERSION;
+        fileHeader.dataOffset = RECORDING_ALIGNMENT;
+        fileHeader.indexEntrySize = sizeof(RecordingIndexEntry);
+        fileHeader.recordHeaderSize = RECORDING_RECORD_HEADER_SIZE;
+        fileHeader.createdTimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        std::strncpy(fileHeader.ringName, ringName.c_str(), sizeof(fileHeader.ringName) - 1);
+        if (!impl.writeBlock(&fileHeader, sizeof(fileHeader), 0)) {
+            MIVI_LOG_ERROR("Failed to write recording header: {}", strerror(errno));
+            return Status::IO_ERROR;
+        }
+        impl.fileOffset = fileHeader.dataOffset;
+
+        impl.useRing = impl.ring.initialize(static_cast<unsigned>(config_.queueDepth));
+        if (!impl.useRing) {
+            MIVI_LOG_WARNING("io_uring unavailable ({}), recording with pwritev", strerror(errno));
+        }
+
+        impl.requests.resize(config_.queueDepth);
+        for (size_t i = config_.queueDepth; i > 0; --i) {
+            Impl::Request &request = impl.requests[i - 1];
+            request.recordHeader = std::aligned_alloc(RECORDING_ALIGNMENT, RECORDING_RECORD_HEADER_SIZE);
+            if (!request.recordHeader) {
+                return Status::IO_ERROR;
+            }
+            impl.freeRequests.push_back(i - 1);
+        }
+        return Status::OK;
+    }
+
+    void FrameRecorder::launch(std::unique_ptr<Impl> impl) {
+        impl_ = std::move(impl);
+        framesRecorded_ = 0;
+        bytesWritten_ = 0;
+        framesCopied_ = 0;
+        framesTorn_ = 0;
+        writeErrors_ = 0;
+        inFlight_ = 0;
+        writeLatencyHistogram_.reset();
+
+        stopRequested_ = false;
+        finished_ = false;
+        isRunning_ = true;
+        thread_ = std::thread(&FrameRecorder::recorderThread, this);
+    }
+
+    FrameRecorder::Status FrameRecorder::stop() {
+        if (!isRunning_) {
+            return Status::NOT_RUNNING;
+        }
+
+        // A clip is written to the end; it holds frames nothing else has
+        if (impl_->reader) {
+            stopRequested_ = true;
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (impl_->fd >= 0) {
+            finishOutput();
+        }
+
+        isRunning_ = false;
+        return Status::OK;
+    }
+
+    void FrameRecorder::finishOutput() {
+        Impl &impl = *impl_;
+
+        // Leave failed and torn records out of the index
+        std::vector<RecordingIndexEntry> index;
+        index.reserve(impl.index.size());
+        for (size_t i = 0; i < impl.index.size(); ++i) {
+            if (impl.indexValid[i]) {
+                index.push_back(impl.index[i]);
+            }
+        }
+
+        // Append the index after the last record, then point the header at it
+        uint64_t indexOffset = impl.fileOffset;
+        size_t indexBytes = index.size() * sizeof(RecordingIndexEntry);
+        bool ok = indexBytes == 0 || impl.writeBlock(index.data(), indexBytes, indexOffset);
+        if (ok) {
+            impl.fileHeader.frameCount = index.size();
+            impl.fileHeader.indexOffset = indexOffset;
+            impl.fileHeader.flags |= RECORDING_FLAG_COMPLETE;
+            ok = impl.writeBlock(&impl.fileHeader, sizeof(impl.fileHeader), 0);
+        }
+
+        // Trim the alignment padding of the index
+        if (!ok || ftruncate(impl.fd, static_cast<off_t>(indexOffset + indexBytes)) != 0 ||
+            fdatasync(impl.fd) != 0) {
+            MIVI_LOG_ERROR("Failed to finish recording {}: {}", config_.outputPath, strerror(errno));
+        }
+        close(impl.fd);
+        impl.fd = -1;
+    }
+
+    bool FrameRecorder::isRunning() const {
+        return isRunning_;
+    }
+
+    bool FrameRecorder::isFinished() const {
+        return finished_;
+    }
+
+    FrameRecorder::Statistics FrameRecorder::getStatistics() const {
+        Statistics stats{};
+        stats.framesRecorded = framesRecorded_.load(std::memory_order_relaxed);
+        stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+        stats.framesCopied = framesCopied_.load(std::memory_order_relaxed);
+        stats.framesTorn = framesTorn_.load(std::memory_order_relaxed);
+        stats.writeErrors = writeErrors_.load(std::memory_order_relaxed);
+        stats.inFlight = inFlight_.load(std::memory_order_relaxed);
+
+        if (impl_) {
+            stats.directIo = impl_->directIo;
+            stats.ioUring = impl_->useRing;
+
+            // Our own reader slot tells how far behind the writer we are
+            SharedMemory::ReaderInfo reader{};
+            if (impl_->reader) {
+                if (impl_->reader->getOwnReader(reader)) {
+                    stats.lagFrames = reader.lag;
+                    stats.framesSkipped = reader.framesSkipped;
+                }
+            } else {
+                stats.lagFrames = impl_->clip.size() - impl_->clipNext.load(std::memory_order_relaxed);
+            }
+        }
+        return stats;
+    }
+
+    std::map<std::string, std::string> FrameRecorder::getStatisticsMap() const {
+        Statistics stats = getStatistics();
+        std::map<std::string, std::string> map;
+        map["recorder_frames_recorded"] = std::to_string(stats.framesRecorded);
+        map["recorder_bytes_written"] = std::to_string(stats.bytesWritten);
+        map["recorder_frames_copied"] = std::to_string(stats.framesCopied);
+        map["recorder_frames_torn"] = std::to_string(stats.framesTorn);
+        map["recorder_frames_skipped"] = std::to_string(stats.framesSkipped);
+        map["recorder_write_errors"] = std::to_string(stats.writeErrors);
+        map["recorder_lag_frames"] = std::to_string(stats.lagFrames);
+        map["recorder_in_flight"] = std::to_string(stats.inFlight);
+        map["recorder_direct_io"] = stats.directIo ? "true" : "false";
+        map["recorder_io_uring"] = stats.ioUring ? "true" : "false";
+        appendHistogramStatistics(map, "recorder_write", writeLatencyHistogram_.snapshot());
+        return map;
+    }
+
+    const LatencyHistogram &FrameRecorder::getWriteLatencyHistogram() const {
+        return writeLatencyHistogram_;
+    }
+
+    void FrameRecorder::recorderThread() {
+        Impl &impl = *impl_;
+
+        if (!ThreadLayout::applyCurrentThread("recorder") && config_.cpuCore >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.cpuCore, &cpuset);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+        }
+
+        auto complete = [this, &impl](uint64_t index, int result) {
+            Impl::Request &request = impl.requests[index];
+            bool recorded = true;
+            if (result < 0 || static_cast<size_t>(result) != request.length) {
+                if (writeErrors_.fetch_add(1, std::memory_order_relaxed) == 0) {
+                    MIVI_LOG_ERROR("Recording write failed: {}", (result < 0 ? strerror(-result) : "short write"));
+                }
+                recorded = false;
+            } else {
+                bytesWritten_.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+            }
+
+            // The writer may have lapped us while the kernel was reading the slot
+            if (recorded && request.frame && !request.frame->validate()) {
+                framesTorn_.fetch_add(1, std::memory_order_relaxed);
+                recorded = false;
+            }
+
+            if (recorded) {
+                framesRecorded_.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                impl.indexValid[request.indexPosition] = false;
+            }
+
+            writeLatencyHistogram_.record(Impl::nowNs() - request.submitNs);
+            request.frame.reset();
+            impl.freeRequests.push_back(static_cast<size_t>(index));
+            inFlight_.fetch_sub(1, std::memory_order_relaxed);
+        };
+
+        bool clipDone = false;
+        while (!stopRequested_ || inFlight_.load(std::memory_order_relaxed) > 0) {
+            if (impl.useRing) {
+                impl.ring.reap(complete);
+            }
+
+            // A clip ends with the completion of its last write
+            clipDone = !impl.reader && impl.clipNext.load(std::memory_order_relaxed) == impl.clip.size();
+            if (clipDone && inFlight_.load(std::memory_order_relaxed) == 0) {
+                break;
+            }
+
+            // Bounded in-flight writes: wait for the disk instead of queueing more
+            if (stopRequested_ || clipDone || impl.freeRequests.empty()) {
+                if (impl.useRing && inFlight_.load(std::memory_order_relaxed) > 0) {
+                    impl.ring.submit(true);
+                }
+                continue;
+            }
+
+            std::shared_ptr<Frame> frame;
+            if (!impl.reader) {
+                frame = std::move(impl.clip[impl.clipNext.fetch_add(1, std::memory_order_relaxed)]);
+            } else if (impl.reader->readNextFrame(frame, FRAME_WAIT_MS) != SharedMemory::Status::OK) {
+                continue;
+            }
+            if (!frame) {
+                continue;
+            }
+
+            size_t index = impl.freeRequests.back();
+            Impl::Request &request = impl.requests[index];
+
+            const auto *data = static_cast<const uint8_t *>(frame->getData());
+            size_t dataSize = frame->getDataSize();
+            size_t payloadStride = static_cast<size_t>(recordingAlign(dataSize));
+
+            // The record header block mirrors the ring slot the frame came from
+            auto *recordHeader = static_cast<uint8_t *>(request.recordHeader);
+            std::memset(recordHeader, 0, RECORDING_RECORD_HEADER_SIZE);
+            auto *frameHeader = reinterpret_cast<SharedMemory::FrameHeader *>(recordHeader);
+            frameHeader->frameId = frame->getFrameId();
+            frameHeader->timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                frame->getTimestamp().time_since_epoch()).count());
+            frameHeader->width = static_cast<uint32_t>(frame->getWidth());
+            frameHeader->height = static_cast<uint32_t>(frame->getHeight());
+            frameHeader->bytesPerPixel = static_cast<uint32_t>(frame->getBytesPerPixel());
+            frameHeader->dataSize = static_cast<uint32_t>(dataSize);
+            frameHeader->rowPitch = static_cast<uint32_t>(frame->getHeight() > 0 ? dataSize / frame->getHeight() : 0);
+            frameHeader->formatCode = static_cast<uint32_t>(frame->getPixelFormat());
+            frameHeader->sequenceNumber = frame->getSequenceNumber();
+            frameHeader->generation.store(2 * frameHeader->sequenceNumber + 2, std::memory_order_relaxed);
+            frameHeader->captureTimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                frame->getCaptureTime().time_since_epoch()).count());
+            auto *metadataRecord = reinterpret_cast<SharedMemory::FrameMetadataRecord *>(
+                recordHeader + sizeof(SharedMemory::FrameHeader));
+            SharedMemory::packMetadataRecord(frame->getMetadata(), *metadataRecord);
+            frameHeader->flags = metadataRecord->flags;
+            frameHeader->metadataOffset = static_cast<uint32_t>(sizeof(SharedMemory::FrameHeader));
+            frameHeader->metadataSize = static_cast<uint32_t>(sizeof(SharedMemory::FrameMetadataRecord));
+
+            // O_DIRECT needs an aligned address and length; anything else is staged in a bounce buffer
+            bool zeroCopy = !impl.directIo ||
+                            (reinterpret_cast<uintptr_t>(data) % IO_ALIGNMENT == 0 && dataSize == payloadStride);
+            const void *payload = data;
+            size_t payloadLength = dataSize;
+            if (zeroCopy) {
+                request.frame = frame;
+            } else {
+                if (request.bounceSize < payloadStride) {
+                    std::free(request.bounce);
+                    request.bounce = std::aligned_alloc(IO_ALIGNMENT, payloadStride);
+                    request.bounceSize = request.bounce ? payloadStride : 0;
+                }
+                if (!request.bounce) {
+                    writeErrors_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                std::memcpy(request.bounce, data, dataSize);
+                std::memset(static_cast<uint8_t *>(request.bounce) + dataSize, 0, payloadStride - dataSize);
+
+                // A copy torn by the writer is not worth the disk bandwidth
+                if (!frame->validate()) {
+                    framesTorn_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                framesCopied_.fetch_add(1, std::memory_order_relaxed);
+                payload = request.bounce;
+                payloadLength = payloadStride;
+            }
+
+            impl.freeRequests.pop_back();
+            request.iov[0] = {request.recordHeader, RECORDING_RECORD_HEADER_SIZE};
+            request.iov[1] = {const_cast<void *>(payload), payloadLength};
+            request.length = RECORDING_RECORD_HEADER_SIZE + payloadLength;
+
+            uint64_t offset = impl.fileOffset;
+            impl.fileOffset += RECORDING_RECORD_HEADER_SIZE + payloadStride;
+
+            RecordingIndexEntry entry{};
+            entry.sequenceNumber = frameHeader->sequenceNumber;
+            entry.frameId = frameHeader->frameId;
+            entry.timestamp = frameHeader->timestamp;
+            entry.captureTimeNs = frameHeader->captureTimeNs;
+            entry.recordOffset = offset;
+            entry.dataSize = frameHeader->dataSize;
+            entry.formatCode = frameHeader->formatCode;
+            entry.width = frameHeader->width;
+            entry.height = frameHeader->height;
+            entry.bytesPerPixel = frameHeader->bytesPerPixel;
+            entry.flags = frameHeader->flags;
+            request.indexPosition = impl.index.size();
+            impl.index.push_back(entry);
+            impl.indexValid.push_back(true);
+
+            request.submitNs = Impl::nowNs();
+            inFlight_.fetch_add(1, std::memory_order_relaxed);
+
+            if (impl.useRing && impl.ring.prepareWritev(impl.fd, request.iov, 2, offset, index)) {
+                impl.ring.submit();
+            } else {
+                ssize_t written = pwritev(impl.fd, request.iov, 2, static_cast<off_t>(offset));
+                complete(index, written < 0 ? -errno : static_cast<int>(written));
+            }
+        }
+
+        if (clipDone) {
+            finishOutput();
+            finished_ = true;
+        }
+    }
+} // namespace medical::imaging
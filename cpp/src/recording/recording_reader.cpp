@@ -0,0 +1,323 @@
+#include "recording/recording_reader.h"
+#include "communication/shared_memory.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    // Read-only view of the whole file, shared with every frame handed out
+    struct RecordingReader::Mapping {
+        void *data = nullptr;
+        size_t size = 0;
+
+        ~Mapping() {
+            if (data) {
+                munmap(data, size);
+            }
+        }
+
+        const uint8_t *at(uint64_t offset) const {
+            return static_cast<const uint8_t *>(data) + offset;
+        }
+    };
+
+    RecordingReader::RecordingReader(const std::string &path)
+        : path_(path),
+          header_(nullptr),
+          index_(nullptr),
+          frameCount_(0),
+          cursor_(0) {
+    }
+
+    RecordingReader::~RecordingReader() {
+        close();
+    }
+
+    bool RecordingReader::isRecording(const std::string &path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        RecordingFileHeader header{};
+        bool result = pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+                      std::memcmp(header.magic, RECORDING_MAGIC, sizeof(RECORDING_MAGIC)) == 0;
+        ::close(fd);
+        return result;
+    }
+
+    RecordingReader::Status RecordingReader::open() {
+        close();
+
+        int fd = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            MIVI_LOG_ERROR("Failed to open recording {}: {}", path_, strerror(errno));
+            return Status::OPEN_FAILED;
+        }
+
+        struct stat sb{};
+        if (fstat(fd, &sb) != 0) {
+            ::close(fd);
+            return Status::OPEN_FAILED;
+        }
+        if (static_cast<size_t>(sb.st_size) < RECORDING_ALIGNMENT) {
+            ::close(fd);
+            MIVI_LOG_WARNING("{} is too small to be a recording", path_);
+            return Status::INVALID_FORMAT;
+        }
+
+        // Shared and read-only: hours of footage must not count against memory commit
+        auto mapping = std::make_shared<Mapping>();
+        mapping->size = static_cast<size_t>(sb.st_size);
+        mapping->data = mmap(nullptr, mapping->size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping->data == MAP_FAILED) {
+            mapping->data = nullptr;
+            MIVI_LOG_ERROR("Failed to map recording {}: {}", path_, strerror(errno));
+            return Status::OPEN_FAILED;
+        }
+
+        // Access is driven by seeks, not by the file order
+        madvise(mapping->data, mapping->size, MADV_RANDOM);
+
+        const auto *header = reinterpret_cast<const RecordingFileHeader *>(mapping->at(0));
+        if (!isValidRecordingHeader(*header) || header->dataOffset > mapping->size) {
+            MIVI_LOG_WARNING("{} is not a readable recording (version {})", path_, header->version);
+            return Status::INVALID_FORMAT;
+        }
+
+        mapping_ = std::move(mapping);
+        header_ = header;
+        cursor_ = 0;
+
+        if ((header_->flags & RECORDING_FLAG_COMPLETE) && header_->indexOffset != 0 &&
+            header_->indexOffset % alignof(RecordingIndexEntry) == 0 &&
+            header_->indexOffset <= mapping_->size &&
+            header_->frameCount <= (mapping_->size - header_->indexOffset) / sizeof(RecordingIndexEntry)) {
+            index_ = reinterpret_cast<const RecordingIndexEntry *>(mapping_->at(header_->indexOffset));
+            frameCount_ = header_->frameCount;
+        } else {
+            rebuildIndex();
+            MIVI_LOG_WARNING("Recording {} was not closed, recovered {} frames", path_, frameCount_);
+        }
+        return Status::OK;
+    }
+
+    void RecordingReader::close() {
+        mapping_.reset();
+        header_ = nullptr;
+        index_ = nullptr;
+        frameCount_ = 0;
+        rebuiltIndex_.clear();
+        cursor_ = 0;
+    }
+
+    bool RecordingReader::isOpen() const {
+        return mapping_ != nullptr;
+    }
+
+    void RecordingReader::rebuildIndex() {
+        rebuiltIndex_.clear();
+
+        // Walk the records until one is missing or incomplete
+        uint64_t offset = header_->dataOffset;
+        while (offset + RECORDING_RECORD_HEADER_SIZE <= mapping_->size) {
+            const auto *frameHeader = reinterpret_cast<const SharedMemory::FrameHeader *>(mapping_->at(offset));
+            uint64_t stride = recordingRecordStride(frameHeader->dataSize);
+            if (frameHeader->dataSize == 0 ||
+                frameHeader->generation.load(std::memory_order_relaxed) != 2 * frameHeader->sequenceNumber + 2 ||
+                stride > mapping_->size - offset) {
+                break;
+            }
+
+            RecordingIndexEntry entry{};
+            entry.sequenceNumber = frameHeader->sequenceNumber;
+            entry.frameId = frameHeader->frameId;
+            entry.timestamp = frameHeader->timestamp;
+            entry.captureTimeNs = frameHeader->captureTimeNs;
+            entry.recordOffset = offset;
+            entry.dataSize = frameHeader->dataSize;
+            entry.formatCode = frameHeader->formatCode;
+            entry.width = frameHeader->width;
+            entry.height = frameHeader->height;
+            entry.bytesPerPixel = frameHeader->bytesPerPixel;
+            entry.flags = frameHeader->flags;
+            rebuiltIndex_.push_back(entry);
+
+            offset += stride;
+        }
+
+        index_ = rebuiltIndex_.data();
+        frameCount_ = rebuiltIndex_.size();
+    }
+
+    uint64_t RecordingReader::getFrameCount() const {
+        return frameCount_;
+    }
+
+    bool RecordingReader::wasRecovered() const {
+        return isOpen() && index_ == rebuiltIndex_.data();
+    }
+
+    const RecordingFileHeader &RecordingReader::getHeader() const {
+        static const RecordingFileHeader empty{};
+        return header_ ? *header_ : empty;
+    }
+
+    const RecordingIndexEntry *RecordingReader::getIndexEntry(uint64_t frameNumber) const {
+        if (!mapping_ || frameNumber >= frameCount_) {
+            return nullptr;
+        }
+        return &index_[frameNumber];
+    }
+
+    const void *RecordingReader::getFrameData(uint64_t frameNumber) const {
+        const RecordingIndexEntry *entry = getIndexEntry(frameNumber);
+        if (!entry || entry->recordOffset + recordingRecordStride(entry->dataSize) > mapping_->size) {
+            return nullptr;
+        }
+        return mapping_->at(entry->recordOffset + RECORDING_RECORD_HEADER_SIZE);
+    }
+
+    RecordingReader::Status RecordingReader::readFrame(uint64_t frameNumber, std::shared_ptr<Frame> &frame) const {
+        if (!mapping_) {
+            return Status::NOT_INITIALIZED;
+        }
+        const void *data = getFrameData(frameNumber);
+        if (!data) {
+            return Status::OUT_OF_RANGE;
+        }
+        const RecordingIndexEntry &entry = index_[frameNumber];
+
+        // The mapping is read-only; the frame is a view like a ring slot
+        frame = Frame::createWithExternalData(
+            const_cast<void *>(data),
+            entry.dataSize,
+            static_cast<int>(entry.width),
+            static_cast<int>(entry.height),
+            static_cast<int>(entry.bytesPerPixel),
+            pixelFormatFromCode(entry.formatCode),
+            false,
+            BufferType::EXTERNAL_MEMORY);
+        if (!frame) {
+            return Status::OPEN_FAILED;
+        }
+
+        frame->setFrameId(entry.frameId);
+        frame->setSequenceNumber(entry.sequenceNumber);
+        frame->setTimestamp(std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(entry.timestamp))));
+        frame->setCaptureTime(std::chrono::steady_clock::time_point(
+            std::chrono::nanoseconds(entry.captureTimeNs)));
+
+        // Restore the metadata record stored in front of the payload
+        const auto *frameHeader = reinterpret_cast<const SharedMemory::FrameHeader *>(
+            mapping_->at(entry.recordOffset));
+        if (frameHeader->metadataSize >= sizeof(SharedMemory::FrameMetadataRecord) &&
+            frameHeader->metadataOffset + sizeof(SharedMemory::FrameMetadataRecord) <= RECORDING_RECORD_HEADER_SIZE) {
+            const auto *record = reinterpret_cast<const SharedMemory::FrameMetadataRecord *>(
+                mapping_->at(entry.recordOffset + frameHeader->metadataOffset));
+            SharedMemory::unpackMetadataRecord(*record, frame->getMetadataMutable());
+        }
+
+        // Keep the file mapped for as long as the frame is alive
+        std::shared_ptr<Mapping> mapping = mapping_;
+        frame->setOnDestroy([mapping]() {});
+        return Status::OK;
+    }
+
+    RecordingReader::Status RecordingReader::readNextFrame(std::shared_ptr<Frame> &frame) {
+        if (!mapping_) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (cursor_ >= frameCount_) {
+            return Status::END_OF_RECORDING;
+        }
+        Status status = readFrame(cursor_, frame);
+        if (status == Status::OK) {
+            ++cursor_;
+        }
+        return status;
+    }
+
+    RecordingReader::Status RecordingReader::readLatestFrame(std::shared_ptr<Frame> &frame) const {
+        if (!mapping_) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (frameCount_ == 0) {
+            return Status::END_OF_RECORDING;
+        }
+        return readFrame(frameCount_ - 1, frame);
+    }
+
+    uint64_t RecordingReader::entryTime(const RecordingIndexEntry &entry) {
+        return entry.captureTimeNs != 0 ? entry.captureTimeNs : entry.timestamp;
+    }
+
+    RecordingReader::Status RecordingReader::findFrameByTime(uint64_t timeNs, uint64_t &frameNumber) const {
+        if (!mapping_) {
+            return Status::NOT_INITIALIZED;
+        }
+
+        // Capture times only grow within a recording
+        const RecordingIndexEntry *end = index_ + frameCount_;
+        const RecordingIndexEntry *found = std::lower_bound(
+            index_, end, timeNs,
+            [](const RecordingIndexEntry &entry, uint64_t time) { return entryTime(entry) < time; });
+        if (found == end) {
+            return Status::OUT_OF_RANGE;
+        }
+        frameNumber = static_cast<uint64_t>(found - index_);
+        return Status::OK;
+    }
+
+    RecordingReader::Status RecordingReader::seek(uint64_t frameNumber) {
+        if (!mapping_) {
+            return Status::NOT_INITIALIZED;
+        }
+        if (frameNumber > frameCount_) {
+            return Status::OUT_OF_RANGE;
+        }
+        cursor_ = frameNumber;
+        return Status::OK;
+    }
+
+    RecordingReader::Status RecordingReader::seekToTime(uint64_t timeNs) {
+        uint64_t frameNumber = 0;
+        Status status = findFrameByTime(timeNs, frameNumber);
+        if (status == Status::OK) {
+            cursor_ = frameNumber;
+        }
+        return status;
+    }
+
+    uint64_t RecordingReader::tell() const {
+        return cursor_;
+    }
+
+    std::map<std::string, std::string> RecordingReader::getStatistics() const {
+        std::map<std::string, std::string> stats;
+        stats["recording_path"] = path_;
+        stats["recording_open"] = isOpen() ? "true" : "false";
+        if (!isOpen()) {
+            return stats;
+        }
+
+        stats["recording_frames"] = std::to_string(frameCount_);
+        stats["recording_size_bytes"] = std::to_string(mapping_->size);
+        stats["recording_recovered"] = wasRecovered() ? "true" : "false";
+        stats["recording_ring"] = std::string(header_->ringName, strnlen(header_->ringName, sizeof(header_->ringName)));
+        if (frameCount_ > 0) {
+            uint64_t first = entryTime(index_[0]);
+            uint64_t last = entryTime(index_[frameCount_ - 1]);
+            stats["recording_duration_ms"] = std::to_string(static_cast<double>(last - first) / 1e6);
+        }
+        return stats;
+    }
+} // namespace medical::imaging
@@ -0,0 +1,74 @@
+#include "utils/frame_pacing.h"
+
+#include <cmath>
+
+namespace medical::imaging {
+    namespace {
+        // A frame number this far behind the previous one is a restarted stream, not a gap
+        constexpr uint32_t RESTART_STEP = 0x80000000u;
+    }
+
+    void FramePacing::setNominalRate(double frameRate) {
+        uint64_t period = frameRate > 0.0 ? static_cast<uint64_t>(std::llround(1e9 / frameRate)) : 0;
+        periodNs_.store(period, std::memory_order_relaxed);
+    }
+
+    double FramePacing::getNominalRate() const {
+        uint64_t period = periodNs_.load(std::memory_order_relaxed);
+        return period > 0 ? 1e9 / static_cast<double>(period) : 0.0;
+    }
+
+    uint64_t FramePacing::recordArrival(uint32_t frameNumber, uint64_t captureTimeNs, uint64_t bufferShortages,
+                                        DropCause &cause) {
+        uint64_t missing = 0;
+        if (havePrevious_) {
+            uint32_t step = frameNumber - lastFrameNumber_;
+            bool inOrder = step >= 1 && step < RESTART_STEP;
+            if (inOrder && step > 1) {
+                missing = step - 1;
+                cause = bufferShortages > lastBufferShortages_ ? DropCause::BUFFER_POOL : DropCause::DEVICE;
+                recordDrop(cause, missing);
+            }
+
+            uint64_t period = periodNs_.load(std::memory_order_relaxed);
+            if (inOrder && period > 0 && captureTimeNs > lastCaptureTimeNs_) {
+                // Measured against the slots the frames occupy, so a gap is not counted as jitter too
+                auto interval = static_cast<int64_t>(captureTimeNs - lastCaptureTimeNs_);
+                auto expected = static_cast<int64_t>(period * step);
+                jitter_.record(static_cast<uint64_t>(std::llabs(interval - expected)));
+            }
+        }
+
+        havePrevious_ = true;
+        lastFrameNumber_ = frameNumber;
+        lastCaptureTimeNs_ = captureTimeNs;
+        lastBufferShortages_ = bufferShortages;
+        return missing;
+    }
+
+    uint64_t FramePacing::getTotalDropCount() const {
+        uint64_t total = 0;
+        for (const auto &count : drops_) {
+            total += count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void FramePacing::reset() {
+        for (auto &count : drops_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        jitter_.reset();
+    }
+
+    const char *FramePacing::toString(DropCause cause) {
+        switch (cause) {
+            case DropCause::DEVICE: return "device";
+            case DropCause::BUFFER_POOL: return "buffer_pool";
+            case DropCause::PUBLISHER_LATE: return "publisher_late";
+            case DropCause::RING_FULL: return "ring_full";
+            case DropCause::READER_OVERWRITTEN: return "reader_overwritten";
+        }
+        return "unknown";
+    }
+} // namespace medical::imaging
@@ -0,0 +1,336 @@
+#include "utils/frame_trace.h"
+
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace medical::imaging {
+    std::atomic<bool> FrameTrace::enabled_{false};
+
+    namespace {
+        static_assert((FrameTrace::EVENTS_PER_THREAD & (FrameTrace::EVENTS_PER_THREAD - 1)) == 0,
+                      "EVENTS_PER_THREAD must be a power of two");
+
+        uint64_t monotonicNs() {
+            timespec ts{};
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        // Raw event timestamp: invariant TSC where available, it is read without a syscall or a fence
+        inline uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return monotonicNs();
+#endif
+        }
+
+        // Events of one thread; only that thread writes, exporters copy and then discard whatever the
+        // writer overwrote meanwhile
+        struct ThreadBuffer {
+            struct Event {
+                std::atomic<uint64_t> ticks;
+                std::atomic<uint64_t> frameId;
+                std::atomic<uint64_t> info; // point << 32 | channel
+            };
+
+            std::atomic<uint64_t> head{0}; // Events written so far
+            std::atomic<bool> retired{false}; // The thread exited
+            pid_t tid = 0;
+            std::string name;
+            Event events[FrameTrace::EVENTS_PER_THREAD];
+        };
+
+        struct EventCopy {
+            uint64_t ticks;
+            uint64_t frameId;
+            uint64_t info;
+        };
+
+        // Every buffer ever handed out, so events of threads that exited can still be exported
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            uint64_t calibrationTicks = 0; // Tick and monotonic time at the last setEnabled(true)
+            uint64_t calibrationNs = 0;
+            uint64_t prunedEvents = 0; // Events of buffers already dropped
+        };
+
+        Registry &registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        // Marks the thread's buffer retired when the thread exits
+        struct ThreadBufferHolder {
+            std::shared_ptr<ThreadBuffer> buffer;
+
+            ~ThreadBufferHolder() {
+                if (buffer) {
+                    buffer->retired.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        ThreadBuffer &threadBuffer() {
+            thread_local ThreadBufferHolder holder;
+            if (!holder.buffer) {
+                auto buffer = std::make_shared<ThreadBuffer>();
+                buffer->tid = static_cast<pid_t>(syscall(SYS_gettid));
+                char name[32] = {};
+                if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) {
+                    buffer->name = name;
+                }
+
+                Registry &reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                reg.buffers.push_back(buffer);
+                holder.buffer = std::move(buffer);
+            }
+            return *holder.buffer;
+        }
+
+        // Copy the events of a buffer that are still intact
+        std::vector<EventCopy> snapshot(const ThreadBuffer &buffer) {
+            constexpr uint64_t capacity = FrameTrace::EVENTS_PER_THREAD;
+            uint64_t head = buffer.head.load(std::memory_order_acquire);
+            uint64_t first = head > capacity ? head - capacity : 0;
+
+            std::vector<EventCopy> copies;
+            copies.reserve(static_cast<size_t>(head - first));
+            for (uint64_t i = first; i < head; ++i) {
+                const ThreadBuffer::Event &event = buffer.events[i & (capacity - 1)];
+                copies.push_back({event.ticks.load(std::memory_order_relaxed),
+                                  event.frameId.load(std::memory_order_relaxed),
+                                  event.info.load(std::memory_order_relaxed)});
+            }
+
+            // Events the writer reached while we copied may have been overwritten, the one it is
+            // writing right now included
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t headAfter = buffer.head.load(std::memory_order_relaxed);
+            uint64_t firstIntact = headAfter + 1 > capacity ? headAfter + 1 - capacity : 0;
+            if (firstIntact > first) {
+                copies.erase(copies.begin(),
+                             copies.begin() + static_cast<std::ptrdiff_t>(std::min<uint64_t>(firstIntact - first,
+                                                                                             copies.size())));
+            }
+            return copies;
+        }
+
+        // Escape a thread name for a JSON string
+        std::string escapeJson(const std::string &text) {
+            std::string escaped;
+            for (char c: text) {
+                if (c == '"' || c == '\\') {
+                    escaped += '\\';
+                    escaped += c;
+                } else if (static_cast<unsigned char>(c) >= 0x20) {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+
+        std::string processName() {
+            std::ifstream comm("/proc/self/comm");
+            std::string name;
+            std::getline(comm, name);
+            return name.empty() ? "ultrasound_imaging" : name;
+        }
+    } // namespace
+
+    void FrameTrace::setEnabled(bool enabled) {
+        if (enabled && !enabled_.load(std::memory_order_relaxed)) {
+            Registry &reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.calibrationTicks = readTicks();
+            reg.calibrationNs = monotonicNs();
+        }
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    void FrameTrace::recordEvent(TracePoint point, uint64_t frameId, uint32_t channel) {
+        ThreadBuffer &buffer = threadBuffer();
+        uint64_t index = buffer.head.load(std::memory_order_relaxed);
+        ThreadBuffer::Event &event = buffer.events[index & (EVENTS_PER_THREAD - 1)];
+        event.ticks.store(readTicks(), std::memory_order_relaxed);
+        event.frameId.store(frameId, std::memory_order_relaxed);
+        event.info.store(static_cast<uint64_t>(point) << 32 | channel, std::memory_order_relaxed);
+        buffer.head.store(index + 1, std::memory_order_release);
+    }
+
+    std::string FrameTrace::toChromeTrace(std::chrono::milliseconds window) {
+        Registry &reg = registry();
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        uint64_t calibrationTicks;
+        uint64_t calibrationNs;
+        {
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            buffers = reg.buffers;
+            calibrationTicks = reg.calibrationTicks;
+            calibrationNs = reg.calibrationNs;
+        }
+
+        // Ticks to monotonic nanoseconds, anchored at now so the newest events are the most accurate
+        uint64_t nowTicks = readTicks();
+        uint64_t nowNs = monotonicNs();
+        double nsPerTick = 1.0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (nowTicks > calibrationTicks && nowNs > calibrationNs) {
+            nsPerTick = static_cast<double>(nowNs - calibrationNs) / static_cast<double>(nowTicks - calibrationTicks);
+        }
+#endif
+        auto toNs = [&](uint64_t ticks) {
+            return static_cast<double>(nowNs) - static_cast<double>(nowTicks - std::min(ticks, nowTicks)) * nsPerTick;
+        };
+        double windowStartNs = static_cast<double>(nowNs) - static_cast<double>(
+                                   std::chrono::duration_cast<std::chrono::nanoseconds>(window).count());
+
+        pid_t pid = getpid();
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << pid << ",\"args\":{\"name\":\""
+            << escapeJson(processName()) << "\"}}";
+
+        for (const auto &buffer: buffers) {
+            out << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid << ",\"tid\":" << buffer->tid
+                << ",\"args\":{\"name\":\"" << escapeJson(buffer->name.empty() ? "thread" : buffer->name) << "\"}}";
+
+            for (const EventCopy &event: snapshot(*buffer)) {
+                double ns = toNs(event.ticks);
+                if (ns < windowStartNs) {
+                    continue;
+                }
+
+                auto point = static_cast<TracePoint>(event.info >> 32);
+                auto channel = static_cast<uint32_t>(event.info & 0xffffffffu);
+                const char *phase = "i";
+                const char *name = toString(point);
+                switch (point) {
+                    case TracePoint::CONVERT_BEGIN:
+                    case TracePoint::PUBLISH_BEGIN:
+                    case TracePoint::SHM_WRITE_BEGIN:
+                        phase = "B";
+                        break;
+                    case TracePoint::CONVERT_END:
+                    case TracePoint::PUBLISH_END:
+                    case TracePoint::SHM_WRITE_END:
+                        phase = "E";
+                        break;
+                    case TracePoint::CONSUMER_ACQUIRE:
+                        phase = "b";
+                        break;
+                    case TracePoint::CONSUMER_RELEASE:
+                        phase = "e";
+                        break;
+                    default:
+                        break;
+                }
+
+                out << ",\n{\"name\":\"" << name << "\",\"cat\":\"frame\",\"ph\":\"" << phase
+                    << "\",\"ts\":" << ns / 1000.0 << ",\"pid\":" << pid << ",\"tid\":" << buffer->tid;
+                if (phase[0] == 'i') {
+                    out << ",\"s\":\"t\"";
+                } else if (phase[0] == 'b' || phase[0] == 'e') {
+                    // Consumers may hold a view across calls and threads, so the span is keyed by frame
+                    out << ",\"id\":\"" << event.frameId << "\"";
+                }
+                out << ",\"args\":{\"frame_id\":" << event.frameId << ",\"channel\":" << channel << "}}";
+            }
+        }
+        out << "\n]}\n";
+
+        // Buffers of exited threads go once nothing in them is recent any more
+        {
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.buffers.erase(std::remove_if(reg.buffers.begin(), reg.buffers.end(), [&](const auto &buffer) {
+                if (!buffer->retired.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                uint64_t head = buffer->head.load(std::memory_order_acquire);
+                bool stale = head == 0 || toNs(buffer->events[(head - 1) & (EVENTS_PER_THREAD - 1)].ticks.load(
+                                                   std::memory_order_relaxed)) < windowStartNs;
+                if (stale) {
+                    reg.prunedEvents += head;
+                }
+                return stale;
+            }), reg.buffers.end());
+        }
+
+        return out.str();
+    }
+
+    bool FrameTrace::writeChromeTrace(const std::string &filePath, std::chrono::milliseconds window) {
+        std::string trace = toChromeTrace(window);
+
+        // Write next to the target and rename, so a viewer never opens half a trace
+        std::string temporaryPath = filePath + ".tmp";
+        {
+            std::ofstream file(temporaryPath, std::ios::trunc);
+            if (!file.is_open()) {
+                MIVI_LOG_ERROR("Failed to open trace file: {}", temporaryPath);
+                return false;
+            }
+            file << trace;
+            if (!file.good()) {
+                MIVI_LOG_ERROR("Failed to write trace file: {}", temporaryPath);
+                return false;
+            }
+        }
+        if (std::rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+            MIVI_LOG_ERROR("Failed to move trace file into place: {}", filePath);
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t FrameTrace::getEventCount() {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        uint64_t count = reg.prunedEvents;
+        for (const auto &buffer: reg.buffers) {
+            count += buffer->head.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    const char *FrameTrace::toString(TracePoint point) {
+        switch (point) {
+            case TracePoint::FRAME_ARRIVAL: return "frame_arrival";
+            case TracePoint::CONVERT_BEGIN:
+            case TracePoint::CONVERT_END: return "convert";
+            case TracePoint::PUBLISH_BEGIN:
+            case TracePoint::PUBLISH_END: return "publish";
+            case TracePoint::SHM_WRITE_BEGIN:
+            case TracePoint::SHM_WRITE_END: return "shm_write";
+            case TracePoint::DROP_PUBLISH_QUEUE: return "drop_publish_queue";
+            case TracePoint::DROP_RING_FULL: return "drop_ring_full";
+            case TracePoint::DROP_DEVICE: return "drop_device";
+            case TracePoint::DROP_BUFFER_POOL: return "drop_buffer_pool";
+            case TracePoint::DROP_READER_OVERWRITTEN: return "drop_reader_overwritten";
+            case TracePoint::CONSUMER_ACQUIRE:
+            case TracePoint::CONSUMER_RELEASE: return "consumer_hold";
+        }
+        return "unknown";
+    }
+} // namespace medical::imaging
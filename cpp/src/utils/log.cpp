@@ -0,0 +1,356 @@
+#include "utils/log.h"
+
+#include <cctype>
+#include <chrono>
+#include <cinttypes>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+
+#include <pthread.h>
+#include <time.h>
+
+#include "utils/futex.h"
+#include "utils/mpmc_queue.h"
+#include "utils/thread_layout.h"
+
+namespace medical::imaging {
+    namespace {
+        constexpr size_t RING_RECORDS = 4096;
+        constexpr uint64_t RATE_WINDOW_NS = 1000000000ULL;
+        constexpr auto IDLE_WAIT = std::chrono::milliseconds(100);
+        constexpr auto FLUSH_TIMEOUT = std::chrono::seconds(2);
+
+        static_assert(std::is_trivially_copyable_v<Log::Record>, "log records are copied as raw bytes");
+
+        uint8_t initialLevel() {
+            LogLevel level = LogLevel::INFO;
+            const char *name = std::getenv("MIVI_LOG_LEVEL");
+            if (name) {
+                Log::parseLevel(name, level);
+            }
+            return static_cast<uint8_t>(level);
+        }
+
+        uint64_t coarseNow() {
+            timespec ts{};
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        template<typename T>
+        T readValue(const uint8_t *data) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return value;
+        }
+
+        // Append the argument at offset to out and return the offset of the next one
+        size_t formatArgument(std::string &out, const Log::Record &record, size_t offset, int precision, bool hex) {
+            const uint8_t *data = record.arguments + offset + 1;
+            char buffer[64];
+            int length = 0;
+
+            switch (record.arguments[offset]) {
+                case Log::Record::SIGNED: {
+                    auto value = readValue<int64_t>(data);
+                    if (hex && value < 0 && value >= INT32_MIN) {
+                        // A negative 32-bit code such as an HRESULT, printed the way std::hex prints it
+                        length = std::snprintf(buffer, sizeof(buffer), "%" PRIx32, static_cast<uint32_t>(value));
+                    } else {
+                        length = std::snprintf(buffer, sizeof(buffer), hex ? "%" PRIx64 : "%" PRId64, value);
+                    }
+                    out.append(buffer, length);
+                    return offset + 1 + sizeof(int64_t);
+                }
+                case Log::Record::UNSIGNED:
+                    length = std::snprintf(buffer, sizeof(buffer), hex ? "%" PRIx64 : "%" PRIu64,
+                                           readValue<uint64_t>(data));
+                    out.append(buffer, length);
+                    return offset + 1 + sizeof(uint64_t);
+                case Log::Record::FLOATING:
+                    if (precision >= 0) {
+                        length = std::snprintf(buffer, sizeof(buffer), "%.*f", precision, readValue<double>(data));
+                    } else {
+                        length = std::snprintf(buffer, sizeof(buffer), "%g", readValue<double>(data));
+                    }
+                    out.append(buffer, length < static_cast<int>(sizeof(buffer)) ? length : sizeof(buffer) - 1);
+                    return offset + 1 + sizeof(double);
+                case Log::Record::CHARACTER:
+                    out += readValue<char>(data);
+                    return offset + 1 + sizeof(char);
+                case Log::Record::BOOLEAN:
+                    out += readValue<uint8_t>(data) ? '1' : '0';
+                    return offset + 1 + sizeof(uint8_t);
+                case Log::Record::POINTER:
+                    length = std::snprintf(buffer, sizeof(buffer), "0x%" PRIxPTR, readValue<uintptr_t>(data));
+                    out.append(buffer, length);
+                    return offset + 1 + sizeof(uintptr_t);
+                case Log::Record::STRING: {
+                    auto size = readValue<uint16_t>(data);
+                    out.append(reinterpret_cast<const char *>(data + sizeof(uint16_t)), size);
+                    offset += 1 + sizeof(uint16_t) + size;
+                    if (offset < record.size && record.arguments[offset] == Log::Record::TRUNCATED) {
+                        out += "...";
+                    }
+                    return offset;
+                }
+                default:
+                    // TRUNCATED: the arguments that did not fit are gone
+                    out += "...";
+                    return Log::Record::ARGUMENT_BYTES;
+            }
+        }
+
+        // Expand the placeholders of a record into a line
+        void formatRecord(std::string &out, const Log::Record &record) {
+            size_t offset = 0;
+            const char *format = record.format;
+
+            for (const char *p = format; *p; ++p) {
+                if (p[0] != '{') {
+                    out += *p;
+                    continue;
+                }
+
+                int precision = -1;
+                bool hex = false;
+                const char *end = nullptr;
+                if (p[1] == '}') {
+                    end = p + 1;
+                } else if (p[1] == ':' && p[2] == 'x' && p[3] == '}') {
+                    hex = true;
+                    end = p + 3;
+                } else if (p[1] == ':' && p[2] == '.' && std::isdigit(static_cast<unsigned char>(p[3]))) {
+                    const char *q = p + 3;
+                    precision = 0;
+                    while (std::isdigit(static_cast<unsigned char>(*q))) {
+                        precision = precision * 10 + (*q++ - '0');
+                    }
+                    if (q[0] == 'f' && q[1] == '}') {
+                        end = q + 1;
+                    }
+                }
+
+                if (!end) {
+                    out += *p;
+                    continue;
+                }
+                if (offset < record.size) {
+                    offset = formatArgument(out, record, offset, precision, hex);
+                }
+                p = end;
+            }
+
+            if (record.suppressed > 0) {
+                out += " (";
+                out += std::to_string(record.suppressed);
+                out += " similar messages suppressed)";
+            }
+            out += '\n';
+        }
+
+        void writeLines(const std::string &out, const std::string &err) {
+            if (!out.empty()) {
+                std::fwrite(out.data(), 1, out.size(), stdout);
+                std::fflush(stdout);
+            }
+            if (!err.empty()) {
+                std::fwrite(err.data(), 1, err.size(), stderr);
+                std::fflush(stderr);
+            }
+        }
+
+        bool toStderr(LogLevel level) {
+            return level >= LogLevel::WARNING;
+        }
+
+        /**
+         * @brief Ring and background thread behind Log
+         *
+         * Created on the first message and never destroyed, so static
+         * destructors can still log. exit() runs stop(), which drains the
+         * ring and switches to writing synchronously.
+         */
+        class Logger {
+        public:
+            static Logger &instance() {
+                static Logger *logger = create();
+                return *logger;
+            }
+
+            void submit(Log::Record &record) {
+                if (synchronous_.load(std::memory_order_acquire)) {
+                    writeNow(record);
+                    return;
+                }
+
+                if (!ring_.push(std::move(record))) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                queued_.fetch_add(1, std::memory_order_release);
+                futex::ring(doorbell_, waiters_);
+            }
+
+            void flush() {
+                if (synchronous_.load(std::memory_order_acquire)) {
+                    return;
+                }
+
+                uint64_t target = queued_.load(std::memory_order_acquire);
+                auto deadline = std::chrono::steady_clock::now() + FLUSH_TIMEOUT;
+                while (written_.load(std::memory_order_acquire) < target &&
+                       std::chrono::steady_clock::now() < deadline) {
+                    futex::ring(doorbell_, waiters_);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+
+            void stop() {
+                stopping_.store(true, std::memory_order_release);
+                futex::ring(doorbell_, waiters_);
+                if (thread_.joinable()) {
+                    thread_.join();
+                }
+                synchronous_.store(true, std::memory_order_release);
+
+                // Anything pushed while the thread finished
+                Log::Record record;
+                while (ring_.pop(record)) {
+                    writeNow(record);
+                }
+            }
+
+            std::atomic<uint64_t> dropped_{0};
+            std::atomic<uint64_t> suppressed_{0};
+
+        private:
+            Logger() : ring_(RING_RECORDS) {
+            }
+
+            static Logger *create() {
+                auto *logger = new Logger();
+                logger->thread_ = std::thread(&Logger::run, logger);
+                std::atexit([] { instance().stop(); });
+                return logger;
+            }
+
+            void writeNow(const Log::Record &record) {
+                std::string line;
+                formatRecord(line, record);
+                std::lock_guard<std::mutex> lock(syncMutex_);
+                if (toStderr(record.level)) {
+                    writeLines(std::string(), line);
+                } else {
+                    writeLines(line, std::string());
+                }
+            }
+
+            void run() {
+                pthread_setname_np(pthread_self(), "mivi-log");
+                ThreadLayout::applyCurrentThread("log");
+
+                std::string out;
+                std::string err;
+                Log::Record record;
+
+                while (true) {
+                    uint32_t ticket = doorbell_.load(std::memory_order_acquire);
+
+                    uint64_t count = 0;
+                    while (ring_.pop(record)) {
+                        formatRecord(toStderr(record.level) ? err : out, record);
+                        ++count;
+                    }
+                    if (count > 0) {
+                        writeLines(out, err);
+                        out.clear();
+                        err.clear();
+                        written_.fetch_add(count, std::memory_order_release);
+                        continue;
+                    }
+
+                    if (stopping_.load(std::memory_order_acquire)) {
+                        return;
+                    }
+
+                    waiters_.fetch_add(1, std::memory_order_seq_cst);
+                    if (ring_.empty() && !stopping_.load(std::memory_order_acquire)) {
+                        futex::wait(&doorbell_, ticket, IDLE_WAIT);
+                    }
+                    waiters_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+
+            MpmcQueue<Log::Record> ring_;
+            std::thread thread_;
+            std::mutex syncMutex_;
+            std::atomic<uint32_t> doorbell_{0};
+            std::atomic<uint32_t> waiters_{0};
+            std::atomic<uint64_t> queued_{0};
+            std::atomic<uint64_t> written_{0};
+            std::atomic<bool> stopping_{false};
+            std::atomic<bool> synchronous_{false};
+        };
+    } // anonymous namespace
+
+    std::atomic<uint8_t> Log::level_{initialLevel()};
+
+    void Log::setLevel(LogLevel level) {
+        level_.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+    }
+
+    bool Log::parseLevel(const std::string &name, LogLevel &level) {
+        if (name == "debug") {
+            level = LogLevel::DEBUG;
+        } else if (name == "info") {
+            level = LogLevel::INFO;
+        } else if (name == "warning") {
+            level = LogLevel::WARNING;
+        } else if (name == "error") {
+            level = LogLevel::ERROR;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    void Log::flush() {
+        Logger::instance().flush();
+    }
+
+    uint64_t Log::getDroppedCount() {
+        return Logger::instance().dropped_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t Log::getSuppressedCount() {
+        return Logger::instance().suppressed_.load(std::memory_order_relaxed);
+    }
+
+    bool Log::admit(Site &site, uint32_t &suppressed) {
+        uint64_t now = coarseNow();
+        uint64_t windowStart = site.windowStartNs.load(std::memory_order_relaxed);
+        if (now - windowStart >= RATE_WINDOW_NS &&
+            site.windowStartNs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+            site.windowCount.store(0, std::memory_order_relaxed);
+        }
+
+        if (site.windowCount.fetch_add(1, std::memory_order_relaxed) >= SITE_BURST) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            Logger::instance().suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        suppressed = site.suppressed.load(std::memory_order_relaxed) > 0
+                         ? site.suppressed.exchange(0, std::memory_order_relaxed)
+                         : 0;
+        return true;
+    }
+
+    void Log::submit(Record &record) {
+        Logger::instance().submit(record);
+    }
+} // namespace medical::imaging
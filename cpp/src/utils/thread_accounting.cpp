@@ -0,0 +1,245 @@
+#include "utils/thread_accounting.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace medical::imaging {
+    namespace {
+        struct Entry {
+            pid_t tid = 0;
+            std::string role;
+            std::atomic<uint64_t> deadlineMisses{0};
+
+            // Previous readings, for the per-interval rates (guarded by the registry mutex)
+            uint64_t lastCpuNs = 0;
+            uint64_t lastWaitNs = 0;
+            std::chrono::steady_clock::time_point lastUpdate{};
+            ThreadAccounting::ThreadStatistics statistics{};
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::shared_ptr<Entry>> entries;
+        };
+
+        Registry &registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        thread_local std::shared_ptr<Entry> currentEntry;
+
+        pid_t currentTid() {
+            return static_cast<pid_t>(syscall(SYS_gettid));
+        }
+
+        std::string taskPath(pid_t tid, const char *file) {
+            return "/proc/self/task/" + std::to_string(tid) + "/" + file;
+        }
+
+        // Value of a "Key:   value" line of a status file, 0 if absent
+        uint64_t statusValue(const std::string &text, const std::string &key) {
+            size_t pos = text.find("\n" + key + ":");
+            if (pos == std::string::npos) {
+                if (text.compare(0, key.size() + 1, key + ":") != 0) {
+                    return 0;
+                }
+                pos = 0;
+            } else {
+                ++pos;
+            }
+            try {
+                return std::stoull(text.substr(pos + key.size() + 1));
+            } catch (const std::exception &) {
+                return 0;
+            }
+        }
+
+        std::string readFile(const std::string &path) {
+            std::ifstream file(path);
+            if (!file.is_open()) {
+                return {};
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            return buffer.str();
+        }
+
+        // Refresh one entry; false when the thread no longer exists
+        bool sampleEntry(Entry &entry, std::chrono::steady_clock::time_point now) {
+            std::string stat = readFile(taskPath(entry.tid, "stat"));
+            if (stat.empty()) {
+                return false;
+            }
+
+            ThreadAccounting::ThreadStatistics &statistics = entry.statistics;
+            statistics.tid = entry.tid;
+            statistics.role = entry.role;
+            statistics.deadlineMisses = entry.deadlineMisses.load(std::memory_order_relaxed);
+
+            // Fields after the command name, which may itself contain spaces and parentheses
+            std::vector<std::string> fields;
+            size_t close = stat.rfind(')');
+            if (close != std::string::npos) {
+                std::istringstream tokens(stat.substr(close + 1));
+                std::string token;
+                while (tokens >> token) {
+                    fields.push_back(token);
+                }
+            }
+            auto field = [&fields](size_t number) -> long long {
+                // stat(5) numbers fields from 1; the first one after the name is field 3
+                if (number < 3 || number - 3 >= fields.size()) {
+                    return 0;
+                }
+                try {
+                    return std::stoll(fields[number - 3]);
+                } catch (const std::exception &) {
+                    return 0;
+                }
+            };
+            statistics.nice = static_cast<int>(field(19));
+            statistics.lastCpu = static_cast<int>(field(39));
+            statistics.priority = static_cast<int>(field(40));
+            statistics.policy = static_cast<int>(field(41));
+
+            // schedstat has nanosecond CPU and run-queue time; it needs CONFIG_SCHEDSTATS or sched_info
+            uint64_t cpuNs = 0;
+            uint64_t waitNs = 0;
+            std::istringstream schedstat(readFile(taskPath(entry.tid, "schedstat")));
+            if (!(schedstat >> cpuNs >> waitNs)) {
+                if (entry.tid == currentTid()) {
+                    rusage usage{};
+                    getrusage(RUSAGE_THREAD, &usage);
+                    cpuNs = static_cast<uint64_t>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+                            static_cast<uint64_t>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+                } else {
+                    static const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+                    cpuNs = static_cast<uint64_t>(field(14) + field(15)) * 1000000000ULL /
+                            static_cast<uint64_t>(ticksPerSecond > 0 ? ticksPerSecond : 100);
+                }
+                waitNs = 0;
+            }
+
+            std::string status = readFile(taskPath(entry.tid, "status"));
+            statistics.voluntarySwitches = statusValue(status, "voluntary_ctxt_switches");
+            statistics.involuntarySwitches = statusValue(status, "nonvoluntary_ctxt_switches");
+
+            // Rates over the interval since the previous update
+            statistics.cpuSeconds = static_cast<double>(cpuNs) / 1e9;
+            statistics.runQueueWaitSeconds = static_cast<double>(waitNs) / 1e9;
+            if (entry.lastUpdate != std::chrono::steady_clock::time_point{}) {
+                double elapsedNs = static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - entry.lastUpdate).count());
+                if (elapsedNs > 0) {
+                    statistics.cpuPercent = static_cast<double>(cpuNs - std::min(cpuNs, entry.lastCpuNs)) /
+                                            elapsedNs * 100.0;
+                    statistics.runQueueWaitPercent = static_cast<double>(waitNs - std::min(waitNs, entry.lastWaitNs)) /
+                                                     elapsedNs * 100.0;
+                }
+            }
+            entry.lastCpuNs = cpuNs;
+            entry.lastWaitNs = waitNs;
+            entry.lastUpdate = now;
+            return true;
+        }
+    } // namespace
+
+    void ThreadAccounting::registerCurrentThread(const std::string &role) {
+        // The kernel takes at most 15 characters
+        pthread_setname_np(pthread_self(), role.substr(0, 15).c_str());
+
+        Registry &instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        if (currentEntry) {
+            currentEntry->role = role;
+            return;
+        }
+
+        auto entry = std::make_shared<Entry>();
+        entry->tid = currentTid();
+        entry->role = role;
+        entry->statistics.tid = entry->tid;
+        entry->statistics.role = role;
+        instance.entries.push_back(entry);
+        currentEntry = std::move(entry);
+    }
+
+    void ThreadAccounting::unregisterCurrentThread() {
+        Registry &instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        if (!currentEntry) {
+            return;
+        }
+        instance.entries.erase(std::remove(instance.entries.begin(), instance.entries.end(), currentEntry),
+                               instance.entries.end());
+        currentEntry.reset();
+    }
+
+    void ThreadAccounting::recordDeadlineMiss() {
+        if (currentEntry) {
+            currentEntry->deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void ThreadAccounting::update() {
+        Registry &instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        auto now = std::chrono::steady_clock::now();
+        instance.entries.erase(std::remove_if(instance.entries.begin(), instance.entries.end(),
+                                              [now](const std::shared_ptr<Entry> &entry) {
+                                                  return !sampleEntry(*entry, now);
+                                              }),
+                               instance.entries.end());
+    }
+
+    std::vector<ThreadAccounting::ThreadStatistics> ThreadAccounting::getThreadStatistics() {
+        Registry &instance = registry();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        std::vector<ThreadStatistics> statistics;
+        statistics.reserve(instance.entries.size());
+        for (const auto &entry: instance.entries) {
+            statistics.push_back(entry->statistics);
+            statistics.back().deadlineMisses = entry->deadlineMisses.load(std::memory_order_relaxed);
+        }
+        return statistics;
+    }
+
+    ThreadAccounting::MemoryStatistics ThreadAccounting::getMemoryStatistics() {
+        // /proc/self/status reports these in kB
+        std::string status = readFile("/proc/self/status");
+        MemoryStatistics memory{};
+        memory.residentBytes = statusValue(status, "VmRSS") * 1024;
+        memory.peakResidentBytes = statusValue(status, "VmHWM") * 1024;
+        memory.lockedBytes = statusValue(status, "VmLck") * 1024;
+        memory.pinnedBytes = statusValue(status, "VmPin") * 1024;
+        return memory;
+    }
+
+    const char *ThreadAccounting::policyName(int policy) {
+        switch (policy) {
+            case SCHED_OTHER: return "other";
+            case SCHED_FIFO: return "fifo";
+            case SCHED_RR: return "rr";
+#ifdef SCHED_BATCH
+            case SCHED_BATCH: return "batch";
+#endif
+#ifdef SCHED_IDLE
+            case SCHED_IDLE: return "idle";
+#endif
+            case 6: return "deadline"; // SCHED_DEADLINE, not exposed by every libc
+            default: return "unknown";
+        }
+    }
+} // namespace medical::imaging
@@ -0,0 +1,449 @@
+#include "utils/thread_layout.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "utils/log.h"
+#include "utils/numa.h"
+#include "utils/thread_accounting.h"
+
+namespace medical::imaging {
+    namespace {
+        struct ActiveLayout {
+            std::mutex mutex;
+            std::shared_ptr<const ThreadLayout> layout = std::make_shared<ThreadLayout>();
+            std::vector<ThreadLayout::AppliedThread> applied;
+        };
+
+        ActiveLayout &active() {
+            static ActiveLayout instance;
+            return instance;
+        }
+
+        // Apply a placement to any thread of this process; returns what failed, empty on success
+        std::string applyPlacement(pid_t tid, const ThreadLayout::Placement &placement) {
+            std::string errors;
+
+            if (!placement.cpus.empty()) {
+                cpu_set_t cpuset;
+                CPU_ZERO(&cpuset);
+                for (int cpu: placement.cpus) {
+                    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                        CPU_SET(cpu, &cpuset);
+                    }
+                }
+                if (sched_setaffinity(tid, sizeof(cpu_set_t), &cpuset) != 0) {
+                    errors += std::string("affinity: ") + std::strerror(errno);
+                }
+            }
+
+            int policy = -1;
+            switch (placement.schedulingClass) {
+                case SchedulingClass::INHERIT: break;
+                case SchedulingClass::OTHER: policy = SCHED_OTHER; break;
+                case SchedulingClass::BATCH: policy = SCHED_BATCH; break;
+                case SchedulingClass::IDLE: policy = SCHED_IDLE; break;
+                case SchedulingClass::FIFO: policy = SCHED_FIFO; break;
+                case SchedulingClass::RR: policy = SCHED_RR; break;
+            }
+            if (policy >= 0) {
+                // On Linux the scheduling calls take a thread ID, so other threads can be moved too
+                sched_param param{};
+                param.sched_priority = placement.isRealtime() ? placement.priority : 0;
+                if (sched_setscheduler(tid, policy, &param) != 0) {
+                    errors += std::string(errors.empty() ? "" : ", ") + "scheduling: " + std::strerror(errno);
+                }
+
+                // The nice value of a normal thread is per thread on Linux
+                if (policy == SCHED_OTHER || policy == SCHED_BATCH) {
+                    errno = 0;
+                    if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), placement.priority) != 0) {
+                        errors += std::string(errors.empty() ? "" : ", ") + "nice: " + std::strerror(errno);
+                    }
+                }
+            }
+            return errors;
+        }
+
+        std::string trim(const std::string &text) {
+            size_t first = text.find_first_not_of(" \t\r\n");
+            if (first == std::string::npos) {
+                return {};
+            }
+            size_t last = text.find_last_not_of(" \t\r\n");
+            return text.substr(first, last - first + 1);
+        }
+
+        // CPU list from sysfs, empty if the file is missing or blank
+        std::vector<int> readCpuList(const char *path) {
+            std::ifstream file(path);
+            std::string list;
+            std::getline(file, list);
+            return numa::parseList(trim(list));
+        }
+
+        std::string formatCpus(const std::vector<int> &cpus) {
+            if (cpus.empty()) {
+                return "*";
+            }
+            std::string text;
+            for (size_t i = 0; i < cpus.size(); ++i) {
+                size_t end = i;
+                while (end + 1 < cpus.size() && cpus[end + 1] == cpus[end] + 1) {
+                    ++end;
+                }
+                if (!text.empty()) {
+                    text += ",";
+                }
+                text += std::to_string(cpus[i]);
+                if (end > i) {
+                    text += "-" + std::to_string(cpus[end]);
+                }
+                i = end;
+            }
+            return text;
+        }
+
+        // Threads that only report or serve clients; they have no business on isolated cores
+        bool isHousekeeping(const std::string &role) {
+            static const char *const roles[] = {"monitor", "metrics", "grpc", "recorder", "subscriber"};
+            for (const char *prefix: roles) {
+                if (role.compare(0, std::strlen(prefix), prefix) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool contains(const std::vector<int> &cpus, int cpu) {
+            return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+        }
+    } // namespace
+
+    std::string ThreadLayout::Placement::toString() const {
+        std::string text = "cpus=" + formatCpus(cpus) + " " + ThreadLayout::toString(schedulingClass);
+        if (schedulingClass != SchedulingClass::INHERIT && schedulingClass != SchedulingClass::IDLE) {
+            text += ":" + std::to_string(priority);
+        }
+        return text;
+    }
+
+    bool ThreadLayout::parse(const std::string &text, ThreadLayout &layout, std::string &error) {
+        // A path names a file holding the layout
+        std::string source = text;
+        if (text.find('=') == std::string::npos) {
+            std::ifstream file(text);
+            if (!file.is_open()) {
+                error = "cannot read thread layout file " + text;
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            source = buffer.str();
+        }
+
+        ThreadLayout parsed;
+        std::replace(source.begin(), source.end(), ';', '\n');
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line)) {
+            line = trim(line.substr(0, line.find('#')));
+            if (line.empty()) {
+                continue;
+            }
+
+            size_t equals = line.find('=');
+            if (equals == std::string::npos || equals == 0) {
+                error = "expected role=cpus[:class[:priority]] in \"" + line + "\"";
+                return false;
+            }
+
+            Placement placement;
+            placement.role = trim(line.substr(0, equals));
+            std::vector<std::string> parts;
+            std::istringstream fields(line.substr(equals + 1));
+            std::string field;
+            while (std::getline(fields, field, ':')) {
+                parts.push_back(trim(field));
+            }
+            if (parts.empty() || parts.size() > 3) {
+                error = "expected role=cpus[:class[:priority]] in \"" + line + "\"";
+                return false;
+            }
+
+            if (parts[0] != "*" && !parts[0].empty()) {
+                placement.cpus = numa::parseList(parts[0]);
+                if (placement.cpus.empty()) {
+                    error = "invalid CPU list \"" + parts[0] + "\" for " + placement.role;
+                    return false;
+                }
+                std::sort(placement.cpus.begin(), placement.cpus.end());
+                placement.cpus.erase(std::unique(placement.cpus.begin(), placement.cpus.end()), placement.cpus.end());
+            }
+            if (parts.size() > 1 && !parseSchedulingClass(parts[1], placement.schedulingClass)) {
+                error = "unknown scheduling class \"" + parts[1] + "\" for " + placement.role;
+                return false;
+            }
+            if (parts.size() > 2) {
+                try {
+                    placement.priority = std::stoi(parts[2]);
+                } catch (const std::exception &) {
+                    error = "invalid priority \"" + parts[2] + "\" for " + placement.role;
+                    return false;
+                }
+            } else if (placement.isRealtime()) {
+                placement.priority = 50;
+            }
+            parsed.setPlacement(placement);
+        }
+
+        layout = std::move(parsed);
+        return true;
+    }
+
+    void ThreadLayout::setPlacement(const Placement &placement) {
+        for (auto &existing: placements_) {
+            if (existing.role == placement.role) {
+                existing = placement;
+                return;
+            }
+        }
+        placements_.push_back(placement);
+    }
+
+    const ThreadLayout::Placement *ThreadLayout::findPlacement(const std::string &role) const {
+        const Placement *prefixMatch = nullptr;
+        for (const auto &placement: placements_) {
+            if (placement.role == role) {
+                return &placement;
+            }
+            // "publish" covers "publish-0", "publish-1", ...
+            if (role.size() > placement.role.size() && role.compare(0, placement.role.size(), placement.role) == 0 &&
+                role[placement.role.size()] == '-') {
+                prefixMatch = &placement;
+            }
+        }
+        return prefixMatch;
+    }
+
+    const std::vector<ThreadLayout::Placement> &ThreadLayout::getPlacements() const {
+        return placements_;
+    }
+
+    ThreadLayout::Validation ThreadLayout::validate() const {
+        Validation result;
+        const std::vector<int> online = readCpuList("/sys/devices/system/cpu/online");
+        const std::vector<int> isolated = readCpuList("/sys/devices/system/cpu/isolated");
+        const std::vector<int> nohzFull = readCpuList("/sys/devices/system/cpu/nohz_full");
+
+        bool anyRealtime = false;
+        std::map<int, std::vector<std::string>> exclusiveRealtime; // Single-CPU RT placements by CPU
+        for (const auto &placement: placements_) {
+            for (int cpu: placement.cpus) {
+                if (!online.empty() && !contains(online, cpu)) {
+                    result.errors.push_back(placement.role + ": CPU " + std::to_string(cpu) + " is not online");
+                }
+            }
+
+            if (placement.isRealtime()) {
+                anyRealtime = true;
+                if (placement.priority < 1 || placement.priority > 99) {
+                    result.errors.push_back(placement.role + ": real-time priority must be 1-99, not " +
+                                            std::to_string(placement.priority));
+                }
+                if (placement.cpus.empty()) {
+                    result.warnings.push_back(placement.role + ": real-time thread may run on any CPU");
+                }
+                for (int cpu: placement.cpus) {
+                    if (!isolated.empty() && !contains(isolated, cpu)) {
+                        result.warnings.push_back(placement.role + ": CPU " + std::to_string(cpu) +
+                                                  " is not isolated (isolcpus), the rest of the system runs there too");
+                    } else if (contains(isolated, cpu) && !contains(nohzFull, cpu)) {
+                        result.warnings.push_back(placement.role + ": isolated CPU " + std::to_string(cpu) +
+                                                  " is not nohz_full and keeps its scheduler tick");
+                    }
+                }
+                if (placement.cpus.size() == 1) {
+                    exclusiveRealtime[placement.cpus.front()].push_back(placement.role);
+                }
+            } else if (placement.schedulingClass == SchedulingClass::OTHER ||
+                       placement.schedulingClass == SchedulingClass::BATCH) {
+                if (placement.priority < -20 || placement.priority > 19) {
+                    result.errors.push_back(placement.role + ": nice value must be -20 to 19, not " +
+                                            std::to_string(placement.priority));
+                }
+            }
+
+            if (isHousekeeping(placement.role)) {
+                for (int cpu: placement.cpus) {
+                    if (contains(isolated, cpu)) {
+                        result.warnings.push_back(placement.role + ": housekeeping thread placed on isolated CPU " +
+                                                  std::to_string(cpu));
+                    }
+                }
+            }
+        }
+
+        for (const auto &[cpu, roles]: exclusiveRealtime) {
+            if (roles.size() > 1) {
+                std::string names;
+                for (const auto &role: roles) {
+                    names += (names.empty() ? "" : ", ") + role;
+                }
+                result.warnings.push_back("CPU " + std::to_string(cpu) + " is shared by real-time threads " + names);
+            }
+        }
+
+        if (anyRealtime && isolated.empty()) {
+            result.warnings.push_back("no CPUs are isolated (isolcpus=), real-time threads compete with the system");
+        }
+        if (anyRealtime) {
+            rlimit limit{};
+            if (geteuid() != 0 && getrlimit(RLIMIT_RTPRIO, &limit) == 0 && limit.rlim_cur == 0) {
+                result.warnings.push_back("RLIMIT_RTPRIO is 0, real-time classes will be refused");
+            }
+        }
+        return result;
+    }
+
+    std::string ThreadLayout::toString() const {
+        std::string text;
+        for (const auto &placement: placements_) {
+            if (!text.empty()) {
+                text += "; ";
+            }
+            text += placement.role + "=" + formatCpus(placement.cpus) + ":" + toString(placement.schedulingClass);
+            if (placement.schedulingClass != SchedulingClass::INHERIT &&
+                placement.schedulingClass != SchedulingClass::IDLE) {
+                text += ":" + std::to_string(placement.priority);
+            }
+        }
+        return text;
+    }
+
+    void ThreadLayout::setActive(const ThreadLayout &layout) {
+        ActiveLayout &instance = active();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        instance.layout = std::make_shared<const ThreadLayout>(layout);
+    }
+
+    std::shared_ptr<const ThreadLayout> ThreadLayout::getActive() {
+        ActiveLayout &instance = active();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        return instance.layout;
+    }
+
+    bool ThreadLayout::isPlaced(const std::string &role) {
+        return getActive()->findPlacement(role) != nullptr;
+    }
+
+    bool ThreadLayout::applyCurrentThread(const std::string &role) {
+        ThreadAccounting::registerCurrentThread(role);
+
+        std::shared_ptr<const ThreadLayout> layout = getActive();
+        const Placement *placement = layout->findPlacement(role);
+
+        AppliedThread applied{};
+        applied.role = role;
+        applied.tid = static_cast<pid_t>(syscall(SYS_gettid));
+        applied.ok = true;
+        if (placement) {
+            applied.placement = placement->toString();
+            std::string errors = applyPlacement(applied.tid, *placement);
+
+            if (!errors.empty()) {
+                applied.ok = false;
+                applied.error = errors;
+                MIVI_LOG_ERROR("Thread {} could not be placed ({}): {}", role, applied.placement, errors);
+            }
+        }
+
+        ActiveLayout &instance = active();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        instance.applied.push_back(std::move(applied));
+        return placement != nullptr;
+    }
+
+    size_t ThreadLayout::applyToRunningThreads() {
+        std::shared_ptr<const ThreadLayout> layout = getActive();
+        size_t placed = 0;
+        for (const auto &thread: ThreadAccounting::getThreadStatistics()) {
+            const Placement *placement = layout->findPlacement(thread.role);
+            if (!placement) {
+                continue;
+            }
+
+            AppliedThread applied{};
+            applied.role = thread.role;
+            applied.tid = thread.tid;
+            applied.placement = placement->toString();
+            errno = 0;
+            applied.error = applyPlacement(thread.tid, *placement);
+            applied.ok = applied.error.empty();
+
+            // Threads that ended since they registered are not an error
+            if (errno == ESRCH) {
+                continue;
+            }
+            if (!applied.ok) {
+                MIVI_LOG_ERROR("Thread {} could not be moved ({}): {}", thread.role, applied.placement, applied.error);
+            }
+
+            ActiveLayout &instance = active();
+            std::lock_guard<std::mutex> lock(instance.mutex);
+            auto existing = std::find_if(instance.applied.begin(), instance.applied.end(),
+                                         [&](const AppliedThread &entry) { return entry.tid == thread.tid; });
+            if (existing != instance.applied.end()) {
+                *existing = std::move(applied);
+            } else {
+                instance.applied.push_back(std::move(applied));
+            }
+            ++placed;
+        }
+        return placed;
+    }
+
+    std::vector<ThreadLayout::AppliedThread> ThreadLayout::getAppliedThreads() {
+        ActiveLayout &instance = active();
+        std::lock_guard<std::mutex> lock(instance.mutex);
+        return instance.applied;
+    }
+
+    bool ThreadLayout::parseSchedulingClass(const std::string &name, SchedulingClass &schedulingClass) {
+        static const std::pair<const char *, SchedulingClass> classes[] = {
+            {"inherit", SchedulingClass::INHERIT}, {"other", SchedulingClass::OTHER},
+            {"batch", SchedulingClass::BATCH}, {"idle", SchedulingClass::IDLE},
+            {"fifo", SchedulingClass::FIFO}, {"rr", SchedulingClass::RR}
+        };
+        for (const auto &[className, value]: classes) {
+            if (name == className) {
+                schedulingClass = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char *ThreadLayout::toString(SchedulingClass schedulingClass) {
+        switch (schedulingClass) {
+            case SchedulingClass::INHERIT: return "inherit";
+            case SchedulingClass::OTHER: return "other";
+            case SchedulingClass::BATCH: return "batch";
+            case SchedulingClass::IDLE: return "idle";
+            case SchedulingClass::FIFO: return "fifo";
+            case SchedulingClass::RR: return "rr";
+        }
+        return "unknown";
+    }
+} // namespace medical::imaging
@@ -0,0 +1,601 @@
+// Microbenchmarks for the SharedMemory ring: writeFrame, readNextFrame,
+// readLatestFrame and the callback path across frame sizes, backends,
+// metadata on/off and 1-4 reader processes, the cost of readers polling the
+// control block while the writer publishes, plus the payload copy and pixel
+// format conversion kernels.
+//
+// Every benchmark reports bytes/s throughput plus p99_us (per-operation
+// p99 latency) and cycles_per_byte (TSC cycles on x86, nanoseconds elsewhere).
+//
+//   ./shared_memory_benchmark --benchmark_filter='WriteFrame/.*backend:0'
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "communication/shared_memory.h"
+#include "frame/frame.h"
+#include "frame/frame_converter.h"
+#include "frame/frame_copy.h"
+#include "utils/latency_histogram.h"
+
+using namespace medical::imaging;
+
+namespace {
+    struct FrameSize {
+        const char *name;
+        int width;
+        int height;
+        int bytesPerPixel;
+        PixelFormat format;
+    };
+
+    const FrameSize FRAME_SIZES[] = {
+        {"720p_yuv", 1280, 720, 2, PixelFormat::YUV422_8},
+        {"1080p_yuv", 1920, 1080, 2, PixelFormat::YUV422_8},
+        {"4k_yuv", 3840, 2160, 2, PixelFormat::YUV422_8},
+        {"4k_rgb10", 3840, 2160, 4, PixelFormat::RGB_10},
+    };
+
+    struct Conversion {
+        const char *name;
+        PixelFormat input;
+        PixelFormat output;
+    };
+
+    const Conversion CONVERSIONS[] = {
+        {"uyvy_gray8", PixelFormat::YUV422_8, PixelFormat::GRAY_8},
+        {"uyvy_rgb24", PixelFormat::YUV422_8, PixelFormat::RGB_8},
+        {"v210_yuv422p16", PixelFormat::YUV422_10, PixelFormat::YUV422P_16},
+        {"r210_rgb48", PixelFormat::RGB_10, PixelFormat::RGB_16},
+    };
+
+    const SharedMemoryType BACKENDS[] = {
+        SharedMemoryType::POSIX_SHM,
+        SharedMemoryType::SYSV_SHM,
+        SharedMemoryType::MEMORY_MAPPED_FILE,
+        SharedMemoryType::HUGE_PAGES,
+        SharedMemoryType::MEMFD,
+    };
+
+    constexpr int64_t BACKEND_COUNT = static_cast<int64_t>(sizeof(BACKENDS) / sizeof(BACKENDS[0]));
+
+    // Tiny frames, so the writer's time goes into the control block rather than into the payload copy
+    const FrameSize CONTENTION_FRAME = {"16x16_gray", 16, 16, 1, PixelFormat::GRAY_8};
+
+    // Small enough to keep every backend's 4K RGB10 ring in RAM, large enough to never wrap a reader
+    constexpr size_t RING_FRAMES = 8;
+
+    inline uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    inline uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief A writer ring plus the files it needs, removed on destruction
+     */
+    class BenchRing {
+    public:
+        BenchRing(const FrameSize &frameSize, SharedMemoryType type, bool metadata) {
+            size_t frameBytes = static_cast<size_t>(frameSize.width) * frameSize.height * frameSize.bytesPerPixel;
+
+            config_.name = "shm_bench_" + std::to_string(getpid());
+            config_.type = type;
+            config_.create = true;
+            config_.maxFrameSize = frameBytes;
+            config_.size = (RING_FRAMES + 1) * (frameBytes + 64 * 1024) + 1024 * 1024;
+            config_.enableMetadata = metadata;
+            config_.lockInMemory = false;
+            config_.enableRealTimeThreads = false;
+            config_.readerMode = ReaderMode::LOSSY;
+            config_.filePath = "/dev/shm/" + config_.name;
+            if (type == SharedMemoryType::SYSV_SHM) {
+                // SysV keys are derived from a path with ftok()
+                config_.name = "/tmp/" + config_.name;
+            }
+
+            writer_ = std::make_shared<SharedMemory>(config_);
+            status_ = writer_->initialize();
+
+            frame_ = Frame::create(frameSize.width, frameSize.height, frameSize.bytesPerPixel, frameSize.format);
+            if (frame_ && metadata) {
+                frame_->setMetadata("probe", "bench");
+                frame_->setMetadata("depth_mm", "120");
+            }
+        }
+
+        ~BenchRing() {
+            writer_.reset();
+            std::remove(config_.filePath.c_str());
+            if (config_.type == SharedMemoryType::SYSV_SHM) {
+                std::remove(config_.name.c_str());
+            }
+        }
+
+        bool ok() const { return status_ == SharedMemory::Status::OK && frame_; }
+
+        std::shared_ptr<SharedMemory> connectReader() const {
+            // Memfd rings have no name; forked readers inherit the writer's descriptor
+            SharedMemory::Config readerConfig = writer_->getAttachConfig();
+            auto reader = std::make_shared<SharedMemory>(readerConfig);
+            if (reader->initialize() != SharedMemory::Status::OK) {
+                return nullptr;
+            }
+            return reader;
+        }
+
+        SharedMemory &writer() { return *writer_; }
+        const std::shared_ptr<Frame> &frame() const { return frame_; }
+        size_t frameBytes() const { return frame_->getDataSize(); }
+
+    private:
+        SharedMemory::Config config_;
+        std::shared_ptr<SharedMemory> writer_;
+        std::shared_ptr<Frame> frame_;
+        SharedMemory::Status status_ = SharedMemory::Status::NOT_INITIALIZED;
+    };
+
+    std::unique_ptr<BenchRing> makeRing(benchmark::State &state) {
+        const FrameSize &frameSize = FRAME_SIZES[state.range(0)];
+        auto ring = std::make_unique<BenchRing>(frameSize, BACKENDS[state.range(1)], state.range(2) != 0);
+        if (!ring->ok()) {
+            state.SkipWithError("shared memory backend unavailable");
+            return nullptr;
+        }
+        state.SetLabel(frameSize.name);
+        return ring;
+    }
+
+    void reportCounters(benchmark::State &state, const LatencyHistogram &latency, uint64_t cycles, size_t frameBytes) {
+        LatencyHistogram::Snapshot snapshot = latency.snapshot();
+        auto operations = static_cast<int64_t>(snapshot.count);
+        state.SetBytesProcessed(operations * static_cast<int64_t>(frameBytes));
+        state.counters["p99_us"] = static_cast<double>(snapshot.percentile(0.99)) / 1000.0;
+        state.counters["cycles_per_byte"] = operations > 0
+                                                ? static_cast<double>(cycles) / (static_cast<double>(operations) *
+                                                                                 static_cast<double>(frameBytes))
+                                                : 0.0;
+    }
+
+    void BM_WriteFrame(benchmark::State &state) {
+        auto ring = makeRing(state);
+        if (!ring) {
+            return;
+        }
+
+        LatencyHistogram latency;
+        uint64_t cycles = 0;
+        for (auto _: state) {
+            uint64_t startNs = nowNs();
+            uint64_t startCycles = readCycles();
+            benchmark::DoNotOptimize(ring->writer().writeFrame(ring->frame()));
+            cycles += readCycles() - startCycles;
+            latency.record(nowNs() - startNs);
+        }
+        reportCounters(state, latency, cycles, ring->frameBytes());
+    }
+
+    void BM_ReadNextFrame(benchmark::State &state) {
+        auto ring = makeRing(state);
+        auto reader = ring ? ring->connectReader() : nullptr;
+        if (!reader) {
+            if (ring) {
+                state.SkipWithError("reader could not connect");
+            }
+            return;
+        }
+
+        LatencyHistogram latency;
+        uint64_t cycles = 0;
+        for (auto _: state) {
+            ring->writer().writeFrame(ring->frame());
+
+            std::shared_ptr<Frame> frame;
+            auto start = std::chrono::steady_clock::now();
+            uint64_t startCycles = readCycles();
+            auto status = reader->readNextFrame(frame);
+            benchmark::DoNotOptimize(frame);
+            cycles += readCycles() - startCycles;
+            auto elapsed = std::chrono::steady_clock::now() - start;
+
+            if (status != SharedMemory::Status::OK) {
+                state.SkipWithError("readNextFrame failed");
+                break;
+            }
+            state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+            latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        reportCounters(state, latency, cycles, ring->frameBytes());
+    }
+
+    void BM_ReadLatestFrame(benchmark::State &state) {
+        auto ring = makeRing(state);
+        auto reader = ring ? ring->connectReader() : nullptr;
+        if (!reader) {
+            if (ring) {
+                state.SkipWithError("reader could not connect");
+            }
+            return;
+        }
+
+        LatencyHistogram latency;
+        uint64_t cycles = 0;
+        for (auto _: state) {
+            ring->writer().writeFrame(ring->frame());
+
+            std::shared_ptr<Frame> frame;
+            auto start = std::chrono::steady_clock::now();
+            uint64_t startCycles = readCycles();
+            auto status = reader->readLatestFrame(frame);
+            benchmark::DoNotOptimize(frame);
+            cycles += readCycles() - startCycles;
+            auto elapsed = std::chrono::steady_clock::now() - start;
+
+            if (status != SharedMemory::Status::OK) {
+                state.SkipWithError("readLatestFrame failed");
+                break;
+            }
+            state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+            latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        reportCounters(state, latency, cycles, ring->frameBytes());
+    }
+
+    // Write-to-callback latency: the writer publishes, the reader's notification thread calls back
+    void BM_FrameCallback(benchmark::State &state) {
+        auto ring = makeRing(state);
+        auto reader = ring ? ring->connectReader() : nullptr;
+        if (!reader) {
+            if (ring) {
+                state.SkipWithError("reader could not connect");
+            }
+            return;
+        }
+
+        std::atomic<uint64_t> delivered{0};
+        reader->registerFrameCallback([&delivered](std::shared_ptr<Frame> frame) {
+            benchmark::DoNotOptimize(frame);
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+
+        LatencyHistogram latency;
+        uint64_t cycles = 0;
+        for (auto _: state) {
+            uint64_t expected = delivered.load(std::memory_order_acquire) + 1;
+
+            auto start = std::chrono::steady_clock::now();
+            uint64_t startCycles = readCycles();
+            ring->writer().writeFrame(ring->frame());
+            bool timedOut = false;
+            while (delivered.load(std::memory_order_acquire) < expected) {
+                if (std::chrono::steady_clock::now() - start > std::chrono::seconds(1)) {
+                    timedOut = true;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            cycles += readCycles() - startCycles;
+            auto elapsed = std::chrono::steady_clock::now() - start;
+
+            if (timedOut) {
+                state.SkipWithError("callback not delivered");
+                break;
+            }
+            state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+            latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+        reader->unregisterFrameCallback();
+        reportCounters(state, latency, cycles, ring->frameBytes());
+    }
+
+    // Writer throughput with 1-4 consumer processes attached, each draining with readNextFrame
+    void BM_WriteFrameWithReaderProcesses(benchmark::State &state) {
+        auto ring = makeRing(state);
+        if (!ring) {
+            return;
+        }
+
+        struct Shared {
+            std::atomic<bool> stop;
+            std::atomic<int> connected;
+            std::atomic<uint64_t> framesRead[4];
+        };
+        auto *shared = static_cast<Shared *>(mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+        if (shared == MAP_FAILED) {
+            state.SkipWithError("mmap failed");
+            return;
+        }
+        new(shared) Shared{};
+
+        auto readerCount = static_cast<int>(state.range(3));
+        std::vector<pid_t> children;
+        for (int i = 0; i < readerCount; ++i) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                auto reader = ring->connectReader();
+                shared->connected.fetch_add(1);
+                while (reader && !shared->stop.load(std::memory_order_relaxed)) {
+                    std::shared_ptr<Frame> frame;
+                    if (reader->readNextFrame(frame, 10) == SharedMemory::Status::OK) {
+                        shared->framesRead[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                _exit(0);
+            }
+            children.push_back(pid);
+        }
+        while (shared->connected.load() < readerCount) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        LatencyHistogram latency;
+        uint64_t cycles = 0;
+        for (auto _: state) {
+            uint64_t startNs = nowNs();
+            uint64_t startCycles = readCycles();
+            benchmark::DoNotOptimize(ring->writer().writeFrame(ring->frame()));
+            cycles += readCycles() - startCycles;
+            latency.record(nowNs() - startNs);
+        }
+
+        shared->stop = true;
+        for (pid_t pid: children) {
+            waitpid(pid, nullptr, 0);
+        }
+
+        uint64_t framesRead = 0;
+        for (int i = 0; i < readerCount; ++i) {
+            framesRead += shared->framesRead[i].load();
+        }
+        reportCounters(state, latency, cycles, ring->frameBytes());
+        state.counters["reader_frames"] = benchmark::Counter(
+            static_cast<double>(framesRead) / readerCount, benchmark::Counter::kIsRate);
+        munmap(shared, sizeof(Shared));
+    }
+
+    /**
+     * @brief writeFrame of tiny frames while reader processes spin on the control block
+     *
+     * Every reader polls writeIndex and consumes what it finds without
+     * sleeping, so each frame moves the control block lines between the
+     * writer's core and the readers' cores. The difference to the run
+     * without readers is the cross-process contention cost of the layout.
+     */
+    void BM_ControlBlockContention(benchmark::State &state) {
+        auto ring = std::make_unique<BenchRing>(CONTENTION_FRAME, BACKENDS[state.range(0)], false);
+        if (!ring->ok()) {
+            state.SkipWithError("shared memory backend unavailable");
+            return;
+        }
+        state.SetLabel(CONTENTION_FRAME.name);
+
+        struct Shared {
+            std::atomic<bool> stop;
+            std::atomic<int> connected;
+        };
+        auto *shared = static_cast<Shared *>(mmap(nullptr, sizeof(Shared), PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+        if (shared == MAP_FAILED) {
+            state.SkipWithError("mmap failed");
+            return;
+        }
+        new(shared) Shared{};
+
+        auto readerCount = static_cast<int>(state.range(1));
+        std::vector<pid_t> children;
+        for (int i = 0; i < readerCount; ++i) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                auto reader = ring->connectReader();
+                shared->connected.fetch_add(1);
+                while (reader && !shared->stop.load(std::memory_order_relaxed)) {
+                    std::shared_ptr<Frame> frame;
+                    benchmark::DoNotOptimize(reader->readNextFrame(frame, 0));
+                }
+                _exit(0);
+            }
+            children.push_back(pid);
+        }
+        while (shared->connected.load() < readerCount) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        LatencyHistogram latency;
+        uint64_t cycles = 0;
+        for (auto _: state) {
+            uint64_t startNs = nowNs();
+            uint64_t startCycles = readCycles();
+            benchmark::DoNotOptimize(ring->writer().writeFrame(ring->frame()));
+            cycles += readCycles() - startCycles;
+            latency.record(nowNs() - startNs);
+        }
+
+        shared->stop = true;
+        for (pid_t pid: children) {
+            waitpid(pid, nullptr, 0);
+        }
+        reportCounters(state, latency, cycles, ring->frameBytes());
+        munmap(shared, sizeof(Shared));
+    }
+
+    /**
+     * @brief Payload copy into a ring-sized buffer with a given kernel and thread count
+     */
+    void BM_FrameCopy(benchmark::State &state) {
+        const FrameSize &frameSize = FRAME_SIZES[state.range(0)];
+        size_t frameBytes = static_cast<size_t>(frameSize.width) * frameSize.height * frameSize.bytesPerPixel;
+        FrameCopier copier(state.range(1) ? CopyMode::STREAMING : CopyMode::MEMCPY,
+                           static_cast<size_t>(state.range(2)));
+
+        std::vector<uint8_t> source(frameBytes, 0x5a);
+        std::vector<uint8_t> destination(frameBytes * RING_FRAMES);
+        size_t slot = 0;
+        for (auto _: state) {
+            copier.copy(destination.data() + slot * frameBytes, source.data(), frameBytes);
+            benchmark::ClobberMemory();
+            slot = (slot + 1) % RING_FRAMES;
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frameBytes));
+        state.SetLabel(std::string(frameSize.name) + "/" + (state.range(1) ? FrameCopier::getKernelName() : "memcpy"));
+    }
+
+    /**
+     * @brief Time to re-read a cache-resident working set after each payload copy
+     *
+     * Stands in for a reader on the same socket: the more of the last-level
+     * cache the copy evicts, the slower the working set is walked again.
+     */
+    void BM_FrameCopyCachePollution(benchmark::State &state) {
+        const FrameSize &frameSize = FRAME_SIZES[state.range(0)];
+        size_t frameBytes = static_cast<size_t>(frameSize.width) * frameSize.height * frameSize.bytesPerPixel;
+        FrameCopier copier(state.range(1) ? CopyMode::STREAMING : CopyMode::MEMCPY);
+
+        std::vector<uint8_t> source(frameBytes, 0x5a);
+        std::vector<uint8_t> destination(frameBytes * RING_FRAMES);
+        std::vector<uint64_t> workingSet(2 * 1024 * 1024 / sizeof(uint64_t), 1);
+        size_t slot = 0;
+        for (auto _: state) {
+            copier.copy(destination.data() + slot * frameBytes, source.data(), frameBytes);
+            slot = (slot + 1) % RING_FRAMES;
+
+            auto start = std::chrono::steady_clock::now();
+            uint64_t sum = 0;
+            for (size_t i = 0; i < workingSet.size(); i += 8) {
+                sum += workingSet[i];
+            }
+            benchmark::DoNotOptimize(sum);
+            state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        state.SetLabel(std::string(frameSize.name) + "/" + (state.range(1) ? FrameCopier::getKernelName() : "memcpy"));
+    }
+
+    /**
+     * @brief Conversion of a capture frame into a preallocated buffer, as the converted ring does
+     *
+     * Bytes processed counts the source frame, so v210 and UYVY rates compare per captured byte.
+     */
+    void BM_FrameConvert(benchmark::State &state) {
+        const Conversion &conversion = CONVERSIONS[state.range(0)];
+        const int width = state.range(1) ? 3840 : 1920;
+        const int height = state.range(1) ? 2160 : 1080;
+        size_t inputBytes = getPixelFormatInfo(conversion.input).frameBytes(width, height);
+
+        std::vector<uint8_t> source(inputBytes);
+        for (size_t i = 0; i < source.size(); ++i) {
+            source[i] = static_cast<uint8_t>(i * 131 + 7);
+        }
+        auto input = Frame::createWithExternalData(source.data(), inputBytes, width, height, 0, conversion.input,
+                                                   false, BufferType::EXTERNAL_MEMORY);
+        FrameConverter converter(conversion.output);
+        std::vector<uint8_t> destination(converter.getOutputSize(width, height));
+
+        for (auto _: state) {
+            auto converted = converter.convert(*input, destination.data(), destination.size());
+            benchmark::DoNotOptimize(converted);
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * inputBytes));
+        state.SetLabel(std::string(conversion.name) + (state.range(1) ? "/4k/" : "/1080p/") +
+                       FrameConverter::getKernelName());
+    }
+
+    // conversion x frame size (1080p, 4K)
+    void convertArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"conversion", "4k"});
+        for (int64_t conversion = 0; conversion < 4; ++conversion) {
+            for (int64_t uhd = 0; uhd < 2; ++uhd) {
+                benchmark->Args({conversion, uhd});
+            }
+        }
+    }
+
+    // frame size x streaming x threads
+    void copyArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"size", "streaming", "threads"});
+        for (int64_t size = 0; size < 4; ++size) {
+            for (int64_t streaming = 0; streaming < 2; ++streaming) {
+                for (int64_t threads: {1, 2, 4}) {
+                    benchmark->Args({size, streaming, threads});
+                }
+            }
+        }
+    }
+
+    // frame size x streaming
+    void cachePollutionArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"size", "streaming"});
+        for (int64_t size = 0; size < 4; ++size) {
+            for (int64_t streaming = 0; streaming < 2; ++streaming) {
+                benchmark->Args({size, streaming});
+            }
+        }
+    }
+
+    // frame size x backend x metadata
+    void ringArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"size", "backend", "metadata"});
+        for (int64_t size = 0; size < 4; ++size) {
+            for (int64_t backend = 0; backend < BACKEND_COUNT; ++backend) {
+                for (int64_t metadata = 0; metadata < 2; ++metadata) {
+                    benchmark->Args({size, backend, metadata});
+                }
+            }
+        }
+    }
+
+    // backend x spinning reader processes
+    void contentionArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"backend", "readers"});
+        for (int64_t backend = 0; backend < BACKEND_COUNT; ++backend) {
+            for (int64_t readers: {0, 1, 2, 4}) {
+                benchmark->Args({backend, readers});
+            }
+        }
+    }
+
+    // frame size x backend x reader processes, metadata on
+    void readerProcessArguments(benchmark::internal::Benchmark *benchmark) {
+        benchmark->ArgNames({"size", "backend", "metadata", "readers"});
+        for (int64_t size = 0; size < 4; ++size) {
+            for (int64_t backend = 0; backend < BACKEND_COUNT; ++backend) {
+                for (int64_t readers = 1; readers <= 4; ++readers) {
+                    benchmark->Args({size, backend, 1, readers});
+                }
+            }
+        }
+    }
+} // namespace
+
+BENCHMARK(BM_WriteFrame)->Apply(ringArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReadNextFrame)->Apply(ringArguments)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReadLatestFrame)->Apply(ringArguments)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrameCallback)->Apply(ringArguments)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_WriteFrameWithReaderProcesses)->Apply(readerProcessArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ControlBlockContention)->Apply(contentionArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrameCopy)->Apply(copyArguments)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrameCopyCachePollution)->Apply(cachePollutionArguments)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrameConvert)->Apply(convertArguments)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
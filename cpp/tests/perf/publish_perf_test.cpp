@@ -0,0 +1,296 @@
+// Performance regression gate for the publish path, run by CTest under the
+// "perf" label (ctest -L perf). One scenario per invocation: a synthetic
+// device capturing at a fixed mode through ImagingService into its
+// SharedMemory ring, with one lossless reader on a thread of the test
+// consuming every frame. After a warm-up it measures for --seconds and
+// compares against the scenario's entry in the baselines file:
+//
+//   fps                    frames the reader received per second, at least
+//                          (1 - fps_tolerance) * fps
+//   p99_write_us           p99 of the service's shm_write latency, at most
+//                          (1 + latency_tolerance) * p99_write_us
+//   allocations_per_frame  operator new calls in the whole process per frame
+//                          published, at most allocations_per_frame +
+//                          allocation_slack
+//
+// Allocations are the most stable of the three and catch per-frame costs
+// such as building JSON metadata for every frame; the timing checks have
+// wide tolerances so that they only trip on real regressions.
+//
+//   ./publish_perf_test --scenario 1080p60 --baselines tests/perf/baselines.json
+//   ./publish_perf_test --scenario 4k30 --baselines tests/perf/baselines.json --update
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+#include "nlohmann/json.hpp"
+
+#include "api/imaging_service.h"
+#include "communication/shared_memory.h"
+#include "device/device_manager.h"
+#include "device/synthetic_device.h"
+
+using namespace medical::imaging;
+using json = nlohmann::json;
+
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+
+    // Out of line, so GCC never sees malloc() and free() paired with a new or delete expression it
+    // inlined the replacements into and reports -Wmismatched-new-delete
+    __attribute__((noinline)) void *countedAllocate(std::size_t size) noexcept {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    __attribute__((noinline)) void countedFree(void *pointer) noexcept {
+        std::free(pointer);
+    }
+}
+
+// Count every allocation in the process, the service library's included. Every form of new has
+// its matching delete, so no pointer is released through a different family than it came from.
+void *operator new(std::size_t size) {
+    if (void *pointer = countedAllocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    if (void *pointer = countedAllocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAllocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void *pointer) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    countedFree(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    countedFree(pointer);
+}
+
+namespace {
+    struct Scenario {
+        const char *name;
+        int width;
+        int height;
+        double frameRate;
+    };
+
+    const Scenario SCENARIOS[] = {
+        {"1080p60", 1920, 1080, 60.0},
+        {"4k30", 3840, 2160, 30.0},
+    };
+
+    struct Measurement {
+        double fps = 0.0;
+        double p99WriteUs = 0.0;
+        double allocationsPerFrame = 0.0;
+    };
+
+    double statistic(const std::map<std::string, std::string> &stats, const std::string &key) {
+        auto it = stats.find(key);
+        return it == stats.end() ? 0.0 : std::atof(it->second.c_str());
+    }
+
+    bool run(const Scenario &scenario, double seconds, Measurement &measurement) {
+        SyntheticDevice::Options deviceOptions;
+        deviceOptions.deviceId = std::string("perf-") + scenario.name;
+        auto device = std::make_shared<SyntheticDevice>(deviceOptions);
+        DeviceManager::getInstance().addTestDevice(device);
+
+        const std::string ringName = std::string("mivi_perf_") + scenario.name;
+        ImagingService::Config config;
+        config.deviceId = device->getDeviceId();
+        config.deviceConfig.width = scenario.width;
+        config.deviceConfig.height = scenario.height;
+        config.deviceConfig.frameRate = scenario.frameRate;
+        config.sharedMemoryName = ringName;
+        config.sharedMemoryType = SharedMemoryType::POSIX_SHM;
+        config.useRealtimePriority = false;
+        config.pinMemory = false;
+
+        ImagingService service;
+        if (service.initialize(config) != ImagingService::Status::OK ||
+            service.start() != ImagingService::Status::OK) {
+            std::cerr << "Failed to start the imaging service" << std::endl;
+            return false;
+        }
+
+        SharedMemory::Config readerConfig;
+        readerConfig.name = ringName;
+        readerConfig.type = SharedMemoryType::POSIX_SHM;
+        readerConfig.create = false;
+        readerConfig.lockInMemory = false;
+        readerConfig.readerMode = ReaderMode::LOSSLESS;
+        SharedMemory reader(readerConfig);
+        if (reader.initialize() != SharedMemory::Status::OK) {
+            std::cerr << "Failed to attach the reader to " << ringName << std::endl;
+            service.stop();
+            return false;
+        }
+
+        std::atomic<uint64_t> framesRead{0};
+        std::atomic<bool> stop{false};
+        std::thread consumer([&]() {
+            std::shared_ptr<Frame> frame;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (reader.readNextFrame(frame, 100) == SharedMemory::Status::OK) {
+                    framesRead.fetch_add(1, std::memory_order_relaxed);
+                    frame.reset();
+                }
+            }
+        });
+
+        // Warm up pools, rings and caches before anything is counted
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        service.resetPerformanceMetrics();
+        uint64_t written = service.getSharedMemory()->getStatistics().totalFramesWritten;
+        uint64_t read = framesRead.load();
+        uint64_t allocations = g_allocations.load();
+        auto start = std::chrono::steady_clock::now();
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        uint64_t allocated = g_allocations.load() - allocations;
+        uint64_t published = service.getSharedMemory()->getStatistics().totalFramesWritten - written;
+        uint64_t consumed = framesRead.load() - read;
+        auto stats = service.getStatistics();
+
+        stop.store(true);
+        consumer.join();
+        service.stop();
+
+        measurement.fps = consumed / elapsed;
+        measurement.p99WriteUs = statistic(stats, "shm_write_p99_us");
+        measurement.allocationsPerFrame = published == 0 ? 0.0 : static_cast<double>(allocated) / published;
+        return published > 0;
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string scenarioName = "1080p60";
+    std::string baselinesPath;
+    double seconds = 3.0;
+    bool update = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--scenario" && i + 1 < argc) {
+            scenarioName = argv[++i];
+        } else if (arg == "--baselines" && i + 1 < argc) {
+            baselinesPath = argv[++i];
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::stod(argv[++i]);
+        } else if (arg == "--update") {
+            update = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " --scenario <1080p60|4k30> --baselines <file> [--seconds <s>] [--update]" << std::endl;
+            return 2;
+        }
+    }
+
+    const Scenario *scenario = nullptr;
+    for (const Scenario &candidate: SCENARIOS) {
+        if (scenarioName == candidate.name) {
+            scenario = &candidate;
+        }
+    }
+    if (!scenario || baselinesPath.empty()) {
+        std::cerr << "Unknown scenario or no baselines file" << std::endl;
+        return 2;
+    }
+
+    json baselines = json::object();
+    {
+        std::ifstream in(baselinesPath);
+        if (in) {
+            try {
+                in >> baselines;
+            } catch (const json::exception &e) {
+                std::cerr << "Cannot parse " << baselinesPath << ": " << e.what() << std::endl;
+                return 2;
+            }
+        }
+    }
+
+    Measurement measurement;
+    if (!run(*scenario, seconds, measurement)) {
+        std::cerr << "FAIL " << scenario->name << ": no frames were published" << std::endl;
+        return 1;
+    }
+    std::printf("%s: %.1f fps, p99 write %.1f us, %.2f allocations per frame\n", scenario->name, measurement.fps,
+                measurement.p99WriteUs, measurement.allocationsPerFrame);
+
+    if (update) {
+        json &entry = baselines["scenarios"][scenario->name];
+        entry["fps"] = scenario->frameRate;
+        entry["p99_write_us"] = measurement.p99WriteUs;
+        entry["allocations_per_frame"] = measurement.allocationsPerFrame;
+        std::ofstream(baselinesPath) << baselines.dump(4) << std::endl;
+        std::cout << "Updated " << baselinesPath << std::endl;
+        return 0;
+    }
+
+    if (!baselines.contains("scenarios") || !baselines["scenarios"].contains(scenario->name)) {
+        std::cerr << "FAIL " << scenario->name << ": no baseline in " << baselinesPath << std::endl;
+        return 1;
+    }
+    const json &entry = baselines["scenarios"][scenario->name];
+    const double fpsTolerance = baselines.value("fps_tolerance", 0.05);
+    const double latencyTolerance = baselines.value("latency_tolerance", 2.0);
+    const double allocationSlack = baselines.value("allocation_slack", 1.0);
+
+    bool passed = true;
+    auto check = [&](const char *what, double value, double limit, bool atLeast) {
+        bool ok = atLeast ? value >= limit : value <= limit;
+        std::printf("  %-22s %10.2f %s %10.2f  %s\n", what, value, atLeast ? ">=" : "<=", limit, ok ? "ok" : "REGRESSED");
+        passed = passed && ok;
+    };
+    check("fps", measurement.fps, entry.value("fps", scenario->frameRate) * (1.0 - fpsTolerance), true);
+    check("p99_write_us", measurement.p99WriteUs, entry.value("p99_write_us", 0.0) * (1.0 + latencyTolerance), false);
+    check("allocations_per_frame", measurement.allocationsPerFrame,
+          entry.value("allocations_per_frame", 0.0) + allocationSlack, false);
+
+    std::cout << (passed ? "PASS " : "FAIL ") << scenario->name << std::endl;
+    return passed ? 0 : 1;
+}
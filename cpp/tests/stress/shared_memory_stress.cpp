@@ -0,0 +1,576 @@
+// Long-running multi-process stress harness for the publish path: an
+// ImagingService capturing from a synthetic device into its ring, plus
+// reader processes of several kinds that register on the ring like real
+// consumers:
+//
+//   steady  readNextFrame() as fast as frames arrive
+//   slow    readNextFrame() and then sleep --slow-ms per frame
+//   bursty  read for --burst-on-ms, then stall for --burst-off-ms
+//   crash   readFrameViews(), then exit while holding a view after a random
+//           number of frames; the harness starts a new one in its place
+//   batch   readFrameViews() in batches of --batch frames
+//
+// Every --interval seconds it prints the writer's p99.9 and maximum publish
+// (shm_write) and end-to-end latency, frames written and dropped, and per
+// reader the lag, skipped frames, capture-to-acquire latency over the
+// interval, the longest gap between two frames, torn reads, restarts and
+// the RSS of every process. Tail events such as a stall after 40 minutes
+// show up as a jump in that time series; --csv keeps it for plotting.
+//
+// For example, a four-hour run with one reader of every kind:
+//
+//   ./shared_memory_stress --mode 1080p60 --duration 14400 --reader steady --reader slow
+//                          --reader bursty --reader crash --reader batch
+//
+// Readers are fresh processes (the harness re-executes itself), so they
+// share nothing with the service but the ring and a small report area.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <spawn.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "api/imaging_service.h"
+#include "communication/shared_memory.h"
+#include "device/device_manager.h"
+#include "device/synthetic_device.h"
+#include "utils/latency_histogram.h"
+
+extern char **environ;
+
+using namespace medical::imaging;
+
+namespace {
+    // One reader process per slot of the ring's registration table
+    constexpr size_t MAX_READERS = SharedMemory::MAX_READERS;
+    constexpr const char *RING_NAME = "mivi_stress";
+
+    enum class ReaderKind { STEADY, SLOW, BURSTY, CRASH, BATCH };
+
+    const char *toString(ReaderKind kind) {
+        switch (kind) {
+            case ReaderKind::STEADY: return "steady";
+            case ReaderKind::SLOW: return "slow";
+            case ReaderKind::BURSTY: return "bursty";
+            case ReaderKind::CRASH: return "crash";
+            case ReaderKind::BATCH: return "batch";
+        }
+        return "unknown";
+    }
+
+    bool parseKind(const std::string &name, ReaderKind &kind) {
+        for (ReaderKind candidate: {ReaderKind::STEADY, ReaderKind::SLOW, ReaderKind::BURSTY, ReaderKind::CRASH,
+                                    ReaderKind::BATCH}) {
+            if (name == toString(candidate)) {
+                kind = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // What a reader process reports, in a shared mapping the harness reads without stopping it
+    struct ReaderReport {
+        LatencyHistogram latency;             // Capture to acquire of every frame consumed (ns)
+        std::atomic<uint64_t> framesRead;
+        std::atomic<uint64_t> tornReads;      // Frames the writer overwrote while they were being read
+        std::atomic<uint64_t> maxGapNs;       // Longest time between two consecutive frames
+        std::atomic<int32_t> pid;
+    };
+
+    struct Options {
+        int width = 1920;
+        int height = 1080;
+        double frameRate = 60.0;
+        int durationSeconds = 3600;
+        int intervalSeconds = 10;
+        int ringFrames = 120;
+        bool lossless = false;
+        int slowMs = 40;
+        int burstOnMs = 5000;
+        int burstOffMs = 2000;
+        int batch = 8;
+        int crashMinFrames = 50;
+        int crashMaxFrames = 2000;
+        double jitterUs = 0.0;
+        std::string csvPath;
+        std::vector<ReaderKind> readers;
+    };
+
+    std::atomic<bool> g_stop{false};
+
+    void handleSignal(int) {
+        g_stop.store(true);
+    }
+
+    uint64_t monotonicNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void storeMax(std::atomic<uint64_t> &target, uint64_t value) {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Resident set size of a process in bytes, 0 if it is gone
+    uint64_t residentBytes(pid_t pid) {
+        std::ifstream statm("/proc/" + std::to_string(pid) + "/statm");
+        uint64_t pages = 0;
+        uint64_t resident = 0;
+        if (!(statm >> pages >> resident)) {
+            return 0;
+        }
+        return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    double statistic(const std::map<std::string, std::string> &stats, const std::string &key) {
+        auto it = stats.find(key);
+        return it == stats.end() ? 0.0 : std::atof(it->second.c_str());
+    }
+
+    // Reader process
+
+    // Touch one byte per page, as a consumer scanning the image would
+    uint64_t touch(const void *data, size_t size) {
+        const auto *bytes = static_cast<const volatile uint8_t *>(data);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size; i += 4096) {
+            sum += bytes[i];
+        }
+        return sum;
+    }
+
+    int runReader(ReaderKind kind, ReaderReport &report, const Options &options, uint32_t seed) {
+        SharedMemory::Config config;
+        config.name = RING_NAME;
+        config.type = SharedMemoryType::POSIX_SHM;
+        config.create = false;
+        config.lockInMemory = false;
+        config.readerMode = options.lossless ? ReaderMode::LOSSLESS : ReaderMode::LOSSY;
+
+        SharedMemory ring(config);
+        if (ring.initialize() != SharedMemory::Status::OK) {
+            std::cerr << "Reader " << toString(kind) << ": cannot attach to " << RING_NAME << std::endl;
+            return 2;
+        }
+        report.pid.store(static_cast<int32_t>(getpid()));
+
+        std::mt19937 random(seed);
+        uint64_t crashAfter = std::uniform_int_distribution<uint64_t>(
+            options.crashMinFrames, std::max(options.crashMinFrames, options.crashMaxFrames))(random);
+        uint64_t framesHere = 0; // Frames this process consumed; the report entry outlives crashed readers
+        uint64_t lastFrameNs = 0;
+        uint64_t burstStartNs = monotonicNs();
+        volatile uint64_t sink = 0;
+
+        // Account for one consumed frame
+        auto consumed = [&](uint64_t captureTimeNs) {
+            uint64_t now = monotonicNs();
+            if (captureTimeNs != 0 && now > captureTimeNs) {
+                report.latency.record(now - captureTimeNs);
+            }
+            if (lastFrameNs != 0) {
+                storeMax(report.maxGapNs, now - lastFrameNs);
+            }
+            lastFrameNs = now;
+            ++framesHere;
+            report.framesRead.fetch_add(1, std::memory_order_relaxed);
+        };
+
+        std::vector<SharedMemory::FrameView> views(std::max(1, options.batch));
+        while (getppid() != 1) {
+            if (kind == ReaderKind::CRASH || kind == ReaderKind::BATCH) {
+                size_t count = 0;
+                size_t maxCount = kind == ReaderKind::BATCH ? views.size() : 1;
+                if (ring.readFrameViews(views.data(), maxCount, count, 100) != SharedMemory::Status::OK) {
+                    continue;
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    sink = sink + touch(views[i].data, views[i].dataSize);
+                    consumed(views[i].captureTimeNs);
+                    // Die holding the view, before its release reaches the reader slot
+                    if (kind == ReaderKind::CRASH && framesHere >= crashAfter) {
+                        _exit(3);
+                    }
+                    if (!ring.releaseFrameView(views[i])) {
+                        report.tornReads.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                continue;
+            }
+
+            if (kind == ReaderKind::BURSTY && monotonicNs() - burstStartNs >= options.burstOnMs * 1000000ULL) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(options.burstOffMs));
+                burstStartNs = monotonicNs();
+                lastFrameNs = 0; // The stall is deliberate, not a gap in delivery
+            }
+
+            std::shared_ptr<Frame> frame;
+            if (ring.readNextFrame(frame, 100) != SharedMemory::Status::OK || !frame) {
+                continue;
+            }
+            sink = sink + touch(frame->getData(), frame->getDataSize());
+            consumed(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                frame->getCaptureTime().time_since_epoch()).count()));
+            if (!frame->validate()) {
+                report.tornReads.fetch_add(1, std::memory_order_relaxed);
+            }
+            frame.reset();
+
+            if (kind == ReaderKind::SLOW) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(options.slowMs));
+                lastFrameNs = 0;
+            }
+        }
+        return 0;
+    }
+
+    // Harness process
+
+    struct Reader {
+        ReaderKind kind;
+        pid_t pid = -1;
+        uint64_t restarts = 0;
+        LatencyHistogram::Snapshot lastLatency;
+        uint64_t lastFramesRead = 0;
+    };
+
+    pid_t spawnReader(const std::vector<std::string> &baseArgs, size_t index, ReaderKind kind, int reportFd,
+                      uint64_t generation) {
+        std::vector<std::string> args = baseArgs;
+        args.insert(args.end(), {"--reader-process", toString(kind), "--reader-index", std::to_string(index),
+                                 "--report-fd", std::to_string(reportFd), "--seed",
+                                 std::to_string(index * 7919 + generation)});
+        std::vector<char *> argv;
+        for (std::string &arg: args) {
+            argv.push_back(arg.data());
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid = -1;
+        if (posix_spawn(&pid, "/proc/self/exe", nullptr, nullptr, argv.data(), environ) != 0) {
+            return -1;
+        }
+        return pid;
+    }
+
+    void printUsage(const char *program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --mode <1080p60|4k30>      Synthetic capture mode (default: 1080p60)\n"
+                  << "  --width/--height/--fps <n> Custom capture mode\n"
+                  << "  --duration <s>             Run time in seconds (default: 3600)\n"
+                  << "  --interval <s>             Report interval in seconds (default: 10)\n"
+                  << "  --reader <kind>            Add a reader: steady, slow, bursty, crash or batch (repeatable)\n"
+                  << "  --lossless                 Register readers as lossless instead of lossy\n"
+                  << "  --slow-ms <ms>             Processing time of a slow reader per frame (default: 40)\n"
+                  << "  --burst-on-ms <ms>         Time a bursty reader reads (default: 5000)\n"
+                  << "  --burst-off-ms <ms>        Time a bursty reader then stalls (default: 2000)\n"
+                  << "  --batch <n>                Frames per batch of a batch reader (default: 8)\n"
+                  << "  --crash-frames <min,max>   Frames a crash reader reads before dying (default: 50,2000)\n"
+                  << "  --ring-frames <n>          Frames in the ring (default: 120)\n"
+                  << "  --jitter-us <us>           Synthetic delivery jitter (default: 0)\n"
+                  << "  --csv <path>               Also write the time series as CSV\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Options options;
+    std::vector<std::string> passThrough{argv[0]};
+    std::string readerProcess;
+    size_t readerIndex = 0;
+    int reportFd = -1;
+    uint32_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--reader-process" && hasValue) {
+            readerProcess = argv[++i];
+        } else if (arg == "--reader-index" && hasValue) {
+            readerIndex = std::stoul(argv[++i]);
+        } else if (arg == "--report-fd" && hasValue) {
+            reportFd = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else if (arg == "--reader" && hasValue) {
+            ReaderKind kind;
+            if (!parseKind(argv[++i], kind)) {
+                std::cerr << "Unknown reader kind: " << argv[i] << std::endl;
+                return 1;
+            }
+            options.readers.push_back(kind);
+        } else if (arg == "--mode" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode == "4k30") {
+                options.width = 3840;
+                options.height = 2160;
+                options.frameRate = 30.0;
+            } else if (mode != "1080p60") {
+                std::cerr << "Unknown mode: " << mode << std::endl;
+                return 1;
+            }
+        } else if (arg == "--width" && hasValue) {
+            options.width = std::stoi(argv[++i]);
+        } else if (arg == "--height" && hasValue) {
+            options.height = std::stoi(argv[++i]);
+        } else if (arg == "--fps" && hasValue) {
+            options.frameRate = std::stod(argv[++i]);
+        } else if (arg == "--duration" && hasValue) {
+            options.durationSeconds = std::stoi(argv[++i]);
+        } else if (arg == "--interval" && hasValue) {
+            options.intervalSeconds = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--lossless") {
+            options.lossless = true;
+            passThrough.push_back(arg);
+            continue;
+        } else if (arg == "--slow-ms" && hasValue) {
+            options.slowMs = std::stoi(argv[++i]);
+        } else if (arg == "--burst-on-ms" && hasValue) {
+            options.burstOnMs = std::stoi(argv[++i]);
+        } else if (arg == "--burst-off-ms" && hasValue) {
+            options.burstOffMs = std::stoi(argv[++i]);
+        } else if (arg == "--batch" && hasValue) {
+            options.batch = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--crash-frames" && hasValue) {
+            if (std::sscanf(argv[++i], "%d,%d", &options.crashMinFrames, &options.crashMaxFrames) != 2) {
+                std::cerr << "Invalid --crash-frames, expected min,max: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--ring-frames" && hasValue) {
+            options.ringFrames = std::stoi(argv[++i]);
+        } else if (arg == "--jitter-us" && hasValue) {
+            options.jitterUs = std::stod(argv[++i]);
+        } else if (arg == "--csv" && hasValue) {
+            options.csvPath = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        // Reader tuning is passed on to the reader processes
+        if (arg == "--slow-ms" || arg == "--burst-on-ms" || arg == "--burst-off-ms" || arg == "--batch" ||
+            arg == "--crash-frames") {
+            passThrough.insert(passThrough.end(), {arg, argv[i]});
+        }
+    }
+
+    // Report area shared by the harness and every reader process, inherited across exec
+    const size_t reportBytes = MAX_READERS * sizeof(ReaderReport);
+
+    if (!readerProcess.empty()) {
+        ReaderKind kind;
+        if (!parseKind(readerProcess, kind) || reportFd < 0 || readerIndex >= MAX_READERS) {
+            return 1;
+        }
+        void *reports = mmap(nullptr, reportBytes, PROT_READ | PROT_WRITE, MAP_SHARED, reportFd, 0);
+        if (reports == MAP_FAILED) {
+            return 1;
+        }
+        return runReader(kind, static_cast<ReaderReport *>(reports)[readerIndex], options, seed);
+    }
+
+    if (options.readers.empty()) {
+        options.readers = {ReaderKind::STEADY, ReaderKind::SLOW, ReaderKind::BURSTY, ReaderKind::CRASH,
+                           ReaderKind::BATCH};
+    }
+    if (options.readers.size() > MAX_READERS) {
+        std::cerr << "At most " << MAX_READERS << " readers" << std::endl;
+        return 1;
+    }
+
+    int fd = memfd_create("mivi_stress_reports", 0);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(reportBytes)) != 0) {
+        std::cerr << "Cannot create the report area: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    void *mapping = mmap(nullptr, reportBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Cannot map the report area: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    auto *reports = static_cast<ReaderReport *>(mapping);
+    for (size_t i = 0; i < MAX_READERS; ++i) {
+        new(&reports[i]) ReaderReport();
+    }
+
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    // The service under test, capturing from a synthetic device at the configured rate
+    SyntheticDevice::Options deviceOptions;
+    deviceOptions.deviceId = "stress-0";
+    deviceOptions.jitterUs = options.jitterUs;
+    auto device = std::make_shared<SyntheticDevice>(deviceOptions);
+    DeviceManager::getInstance().addTestDevice(device);
+
+    ImagingService::Config config;
+    config.deviceId = device->getDeviceId();
+    config.deviceConfig.width = options.width;
+    config.deviceConfig.height = options.height;
+    config.deviceConfig.frameRate = options.frameRate;
+    config.sharedMemoryName = RING_NAME;
+    config.sharedMemoryType = SharedMemoryType::POSIX_SHM;
+    config.frameBufferSize = options.ringFrames;
+    config.sharedMemorySize = static_cast<size_t>(options.ringFrames + 4) * options.width * options.height * 2;
+    config.useRealtimePriority = false;
+    config.pinMemory = false;
+
+    ImagingService service;
+    if (service.initialize(config) != ImagingService::Status::OK || service.start() != ImagingService::Status::OK) {
+        std::cerr << "Failed to start the imaging service" << std::endl;
+        return 1;
+    }
+    std::shared_ptr<SharedMemory> ring = service.getSharedMemory();
+
+    std::vector<Reader> readers;
+    for (size_t i = 0; i < options.readers.size(); ++i) {
+        Reader reader;
+        reader.kind = options.readers[i];
+        reader.pid = spawnReader(passThrough, i, reader.kind, fd, 0);
+        readers.push_back(reader);
+    }
+
+    std::ofstream csv;
+    if (!options.csvPath.empty()) {
+        csv.open(options.csvPath);
+        csv << "elapsed_s,process,kind,pid,frames,fps,dropped,lag,skipped,p999_us,max_us,max_gap_ms,torn,"
+               "restarts,rss_bytes\n";
+    }
+
+    std::cout << "Stress run: " << options.width << "x" << options.height << "@" << options.frameRate << ", "
+              << readers.size() << " readers (" << (options.lossless ? "lossless" : "lossy") << "), "
+              << options.durationSeconds << " s" << std::endl;
+
+    const auto start = std::chrono::steady_clock::now();
+    auto nextReport = start + std::chrono::seconds(options.intervalSeconds);
+    uint64_t lastFramesWritten = 0;
+    double worstPublishUs = 0.0;
+    double worstLatencyUs = 0.0;
+    uint64_t worstGapNs = 0;
+    uint64_t peakServiceRss = 0;
+
+    while (!g_stop.load() && std::chrono::steady_clock::now() - start < std::chrono::seconds(options.durationSeconds)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        // Crashed readers are replaced by a new process in the same report entry
+        for (size_t i = 0; i < readers.size(); ++i) {
+            int status = 0;
+            if (readers[i].pid > 0 && waitpid(readers[i].pid, &status, WNOHANG) == readers[i].pid) {
+                ++readers[i].restarts;
+                readers[i].pid = spawnReader(passThrough, i, readers[i].kind, fd, readers[i].restarts);
+            }
+        }
+
+        if (std::chrono::steady_clock::now() < nextReport) {
+            continue;
+        }
+        nextReport += std::chrono::seconds(options.intervalSeconds);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        auto stats = service.getStatistics();
+        SharedMemory::Statistics ringStats = ring->getStatistics();
+        uint64_t framesWritten = ringStats.totalFramesWritten;
+        double fps = static_cast<double>(framesWritten - lastFramesWritten) / options.intervalSeconds;
+        lastFramesWritten = framesWritten;
+        double publishP999 = statistic(stats, "shm_write_p999_us");
+        double publishMax = statistic(stats, "shm_write_max_us");
+        uint64_t serviceRss = residentBytes(getpid());
+        worstPublishUs = std::max(worstPublishUs, publishMax);
+        peakServiceRss = std::max(peakServiceRss, serviceRss);
+
+        std::printf("[%8.0f s] service  frames %10lu  fps %6.1f  dropped %6lu  publish p99.9 %8.1f us  max %8.1f us"
+                    "  e2e p99.9 %8.1f us  rss %6.1f MB\n",
+                    elapsed, static_cast<unsigned long>(framesWritten), fps,
+                    static_cast<unsigned long>(ringStats.droppedFrames), publishP999, publishMax,
+                    statistic(stats, "end_to_end_latency_p999_us"), serviceRss / 1048576.0);
+        if (csv) {
+            csv << elapsed << ",service,,"<< getpid() << "," << framesWritten << "," << fps << ","
+                << ringStats.droppedFrames << ",,," << publishP999 << "," << publishMax << ",,,," << serviceRss << "\n";
+        }
+
+        std::vector<SharedMemory::ReaderInfo> registered = ring->getReaders();
+        for (size_t i = 0; i < readers.size(); ++i) {
+            Reader &reader = readers[i];
+            ReaderReport &report = reports[i];
+
+            uint64_t lag = 0;
+            uint64_t skipped = 0;
+            for (const SharedMemory::ReaderInfo &info: registered) {
+                if (info.pid == reader.pid) {
+                    lag = info.lag;
+                    skipped = info.framesSkipped;
+                }
+            }
+
+            // Latency over the interval; its maximum is the upper bound of the highest bucket it reached
+            LatencyHistogram::Snapshot latency = report.latency.snapshot();
+            LatencyHistogram::Snapshot window = latency;
+            window -= reader.lastLatency;
+            reader.lastLatency = latency;
+            uint64_t framesRead = report.framesRead.load(std::memory_order_relaxed);
+            double readerFps = static_cast<double>(framesRead - reader.lastFramesRead) / options.intervalSeconds;
+            reader.lastFramesRead = framesRead;
+            double p999 = window.percentile(0.999) / 1000.0;
+            double max = window.percentile(1.0) / 1000.0;
+            uint64_t gap = report.maxGapNs.exchange(0, std::memory_order_relaxed);
+            uint64_t rss = reader.pid > 0 ? residentBytes(reader.pid) : 0;
+            worstLatencyUs = std::max(worstLatencyUs, max);
+            worstGapNs = std::max(worstGapNs, gap);
+
+            std::printf("             %-7s  pid %7d  fps %6.1f  lag %5lu  skipped %8lu  latency p99.9 %8.1f us  "
+                        "max %8.1f us  gap %7.1f ms  torn %4lu  restarts %4lu  rss %6.1f MB\n",
+                        toString(reader.kind), reader.pid, readerFps, static_cast<unsigned long>(lag),
+                        static_cast<unsigned long>(skipped), p999, max, gap / 1e6,
+                        static_cast<unsigned long>(report.tornReads.load(std::memory_order_relaxed)),
+                        static_cast<unsigned long>(reader.restarts), rss / 1048576.0);
+            if (csv) {
+                csv << elapsed << ",reader," << toString(reader.kind) << "," << reader.pid << "," << framesRead << ","
+                    << readerFps << ",," << lag << "," << skipped << "," << p999 << "," << max << "," << gap / 1e6
+                    << "," << report.tornReads.load(std::memory_order_relaxed) << "," << reader.restarts << "," << rss
+                    << "\n";
+            }
+        }
+        std::fflush(stdout);
+        if (csv) {
+            csv.flush();
+        }
+    }
+
+    for (Reader &reader: readers) {
+        if (reader.pid > 0) {
+            kill(reader.pid, SIGTERM);
+            waitpid(reader.pid, nullptr, 0);
+        }
+    }
+    service.stop();
+
+    SharedMemory::Statistics ringStats = ring->getStatistics();
+    std::printf("Summary: %lu frames written, %lu dropped, worst publish %.1f us, worst reader latency %.1f us, "
+                "longest gap %.1f ms, peak service RSS %.1f MB\n",
+                static_cast<unsigned long>(ringStats.totalFramesWritten),
+                static_cast<unsigned long>(ringStats.droppedFrames), worstPublishUs, worstLatencyUs,
+                worstGapNs / 1e6, peakServiceRss / 1048576.0);
+    return 0;
+}